@@ -0,0 +1,30 @@
+// Differential accuracy report for the math variants.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude bench/accuracy_report.cpp -o accuracy_report
+//        (add -DRENDERFX_MATH_STRICT -DRENDERFX_FP_CONTRACT_OFF -ffp-contract=off for the strict build,
+//        which reports the scalar code as "strict")
+// Usage: accuracy_report [samples] [seed]
+
+#include <cstdlib>
+#include <iostream>
+#include "bench/AccuracyHarness.h"
+
+int main(int argc, char** argv) {
+    std::size_t samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    std::uint32_t seed = argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1;
+
+    std::cout << "float\n";
+    AccuracyHarnessf single(samples, seed);
+    single.addScalarVariants();
+    single.addFixedVariants<Fixed16>("fixed16");
+    single.addFixedVariants<Fixed32>("fixed32");
+    printAccuracyReport(std::cout, single.run());
+
+    std::cout << "\ndouble\n";
+    AccuracyHarnessd twice(samples, seed);
+    twice.addScalarVariants();
+    twice.addFixedVariants<Fixed16>("fixed16");
+    twice.addFixedVariants<Fixed32>("fixed32");
+    printAccuracyReport(std::cout, twice.run());
+    return 0;
+}
@@ -0,0 +1,57 @@
+// End-to-end frame macro-benchmark.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude bench/frame_benchmark.cpp -pthread -o frame_benchmark
+// Usage: frame_benchmark [--objects N] [--depth D] [--motion F] [--distribution uniform|clustered|grid]
+//                        [--views V] [--lods L] [--threads T] [--frames N] [--warmup N] [--seed S]
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "bench/FrameBenchmark.h"
+
+int main(int argc, char** argv) {
+    SceneConfig config;
+    unsigned maxThreads = 0;
+    std::size_t frames = 200;
+    std::size_t warmup = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << "\n";
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (option == "--objects") config.objectCount = std::strtoull(value, nullptr, 10);
+        else if (option == "--depth") config.hierarchyDepth = std::atoi(value);
+        else if (option == "--motion") config.motionFraction = std::strtof(value, nullptr);
+        else if (option == "--views") config.viewCount = std::strtoull(value, nullptr, 10);
+        else if (option == "--lods") config.lodLevels = std::atoi(value);
+        else if (option == "--threads") maxThreads = static_cast<unsigned>(std::atoi(value));
+        else if (option == "--frames") frames = std::strtoull(value, nullptr, 10);
+        else if (option == "--warmup") warmup = std::strtoull(value, nullptr, 10);
+        else if (option == "--seed") config.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (option == "--distribution") {
+            if (std::strcmp(value, "uniform") == 0) config.distribution = SpatialDistribution::Uniform;
+            else if (std::strcmp(value, "clustered") == 0) config.distribution = SpatialDistribution::Clustered;
+            else if (std::strcmp(value, "grid") == 0) config.distribution = SpatialDistribution::Grid;
+            else {
+                std::cerr << "Unknown distribution " << value << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option " << option << "\n";
+            return 1;
+        }
+    }
+
+    try {
+        FrameBenchmarkf benchmark(config);
+        printFrameBenchmarkReports(std::cout, benchmark.runScaling(maxThreads, warmup, frames));
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+// Cost of the strict float mode.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude bench/strict_math_benchmark.cpp -o strict_math_benchmark
+//        (add -DRENDERFX_MATH_STRICT -DRENDERFX_FP_CONTRACT_OFF -ffp-contract=off for the strict build
+//        and compare the operation timings of the two)
+// Usage: strict_math_benchmark [samples] [seed]
+
+#include <cstdlib>
+#include <iostream>
+#include "bench/StrictMathBenchmark.h"
+
+int main(int argc, char** argv) {
+    std::size_t samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 18;
+    std::uint32_t seed = argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1;
+
+    printStrictMathBenchmark(std::cout, runStrictMathBenchmark(samples, seed));
+    return 0;
+}
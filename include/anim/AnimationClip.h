@@ -0,0 +1,259 @@
+#ifndef ANIMATIONCLIP_H
+#define ANIMATIONCLIP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../core/BinaryFile.h"
+#include "../core/MappedFile.h"
+#include "../scene/TransformSoA.h"
+
+/**
+ * @brief How closely a compressed clip follows its source frames.
+ *
+ * Keys are removed while interpolating the remaining ones stays within the
+ * tolerances. The result can be off by at most the larger of a tolerance
+ * and the quantization step of its track: 1/65535 of the track's range for
+ * translations and scales, about 3e-5 radians for rotations.
+ */
+struct AnimationClipSettings {
+    float translationTolerance = 1e-4f; ///< Largest translation error, in scene units.
+    float rotationTolerance = 1e-4f;    ///< Largest rotation error, in radians.
+    float scaleTolerance = 1e-4f;       ///< Largest error of any scale component.
+};
+
+/**
+ * @brief Header at the start of a .rfxclip file.
+ *
+ * All offsets are in bytes from the start of the file and aligned to 64
+ * bytes. A clip has three tracks per joint, translation, rotation and scale,
+ * numbered joint * 3 + channel. Values are stored in the byte order of the
+ * machine that wrote the file.
+ */
+struct AnimationClipHeader {
+    char magic[8];              ///< "RFXCLIP" followed by a zero byte.
+    std::uint32_t version;      ///< Format version.
+    std::uint32_t byteOrder;    ///< 0x01020304 as written by the producer.
+    std::uint32_t jointCount;   ///< Number of joints.
+    std::uint32_t frameCount;   ///< Number of source frames.
+    float sampleRate;           ///< Source frames per second.
+    std::uint32_t keyCount;     ///< Number of AnimationClipKey records.
+    std::uint64_t fileSize;     ///< Size of the whole file.
+    std::uint64_t checksum;     ///< Checksum of everything after the header.
+    std::uint64_t rangesOffset; ///< Offset of the AnimationClipRange array, one per track.
+    std::uint64_t keysOffset;   ///< Offset of the AnimationClipKey array.
+};
+
+/**
+ * @brief The quantization range of a translation or scale track.
+ */
+struct AnimationClipRange {
+    float minimum[3]; ///< Smallest value of every component.
+    float extent[3];  ///< Largest minus smallest value of every component.
+};
+
+/**
+ * @brief One quantized key of a track.
+ *
+ * Translation and scale keys store x, y and z as fractions of the track's
+ * range. Rotation keys store the three smallest quaternion components,
+ * mapped from [-1/sqrt(2), 1/sqrt(2)], and the index of the largest one,
+ * which is positive, in value[3].
+ */
+struct AnimationClipKey {
+    std::uint16_t track;    ///< Track the key belongs to.
+    std::uint16_t frame;    ///< Source frame of the key.
+    std::uint16_t value[4]; ///< The quantized value.
+};
+
+class AnimationClip;
+
+/**
+ * @brief The playback state of one instance of a clip.
+ *
+ * A cursor holds the two keys around the current time of every track,
+ * already decoded, so sampling is a lerp per track without any search.
+ * Moving forward consumes the key stream from where the cursor stopped;
+ * moving backward rewinds to the start of the clip.
+ *
+ * @tparam T Type of the sampled transforms.
+ */
+template<typename T>
+class AnimationClipCursor {
+public:
+    static_assert(std::is_floating_point<T>::value, "AnimationClipCursor requires a floating-point type");
+
+    AnimationClipCursor() = default;
+
+    /**
+     * @brief Detaches the cursor; the next sample starts from the beginning of the clip.
+     */
+    void reset() noexcept { keys = nullptr; }
+
+    /**
+     * @brief Gets the number of keys decoded since the cursor was last rewound.
+     *
+     * @return The position in the key stream.
+     */
+    std::size_t position() const noexcept { return keys != nullptr ? next : 0; }
+
+private:
+    friend class AnimationClip;
+
+    const AnimationClipKey* keys = nullptr;
+    std::size_t next = 0;
+    std::size_t joints = 0;
+    T frame = 0;
+    std::vector<std::uint16_t> rightFrames;
+    std::vector<T> streams;
+};
+
+/**
+ * @brief A compressed skeletal animation clip that is used in place through a memory mapping.
+ *
+ * Clips are built from the local joint transforms of every source frame.
+ * Each track keeps only the keys needed to stay within the tolerances of
+ * AnimationClipSettings, and every key is quantized to 16 bits per
+ * component, so a key takes 12 bytes instead of 40 for a raw transform.
+ *
+ * The keys of all tracks form one stream ordered by the frame at which the
+ * sampler first needs them: the first key of every track, then each
+ * following key at the frame of the key before it. Playing a clip forward
+ * reads the stream sequentially, which suits memory mappings and streaming
+ * from disk, and an AnimationClipCursor decodes each key exactly once.
+ *
+ * Files are written with the producer's byte order and rejected elsewhere.
+ */
+class AnimationClip {
+public:
+    static constexpr std::uint32_t version = 1; ///< The current format version.
+
+    AnimationClip() = default;
+
+    /**
+     * @brief Compresses a clip into memory.
+     *
+     * @param frames The local joint transforms of every frame, frame by frame:
+     *        joint j of frame f is at f * jointCount + j.
+     * @param jointCount The number of joints.
+     * @param sampleRate The number of frames per second.
+     * @param settings The error tolerances.
+     * @return The clip; it owns its image.
+     * @throws std::invalid_argument If the frames do not fit the joint count, there are more than
+     *         65536 frames or 21845 joints, or sampleRate is not positive.
+     */
+    template<typename T>
+    static AnimationClip build(const TransformSoA<T>& frames, std::size_t jointCount, float sampleRate,
+                               const AnimationClipSettings& settings = AnimationClipSettings());
+
+    /**
+     * @brief Compresses a clip into the bytes of a clip file.
+     *
+     * @param frames The local joint transforms of every frame; see build().
+     * @param jointCount The number of joints.
+     * @param sampleRate The number of frames per second.
+     * @param settings The error tolerances.
+     * @return The clip image, as write() stores it.
+     * @throws std::invalid_argument See build().
+     */
+    template<typename T>
+    static std::vector<unsigned char> serialize(const TransformSoA<T>& frames, std::size_t jointCount, float sampleRate,
+                                                const AnimationClipSettings& settings = AnimationClipSettings());
+
+    /**
+     * @brief Compresses a clip into a file.
+     *
+     * The file is written next to the target and renamed into place, so a
+     * concurrent reader never sees a partial clip.
+     *
+     * @param path Path of the clip file.
+     * @param frames The local joint transforms of every frame; see build().
+     * @param jointCount The number of joints.
+     * @param sampleRate The number of frames per second.
+     * @param settings The error tolerances.
+     * @throws std::invalid_argument See build().
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    template<typename T>
+    static void write(const std::string& path, const TransformSoA<T>& frames, std::size_t jointCount, float sampleRate,
+                      const AnimationClipSettings& settings = AnimationClipSettings());
+
+    /**
+     * @brief Uses a clip image that is already in memory.
+     *
+     * @param data The image; must stay valid and unchanged while the clip is used, and be aligned to 8 bytes.
+     * @param size Size of the image in bytes.
+     * @param verifyChecksum Whether to verify the checksum.
+     * @return The clip.
+     * @throws std::runtime_error If the image is misaligned or not a valid clip.
+     */
+    static AnimationClip view(const void* data, std::size_t size, bool verifyChecksum = true);
+
+    /**
+     * @brief Maps a clip file.
+     *
+     * @param path Path of the clip file.
+     * @param verifyChecksum Whether to verify the checksum, which reads the whole file.
+     * @return The clip.
+     * @throws std::runtime_error If the file cannot be mapped or is not a valid clip.
+     */
+    static AnimationClip open(const std::string& path, bool verifyChecksum = true);
+
+    bool isOpen() const noexcept { return info != nullptr; }
+    const AnimationClipHeader& header() const noexcept { return *info; }
+
+    std::size_t jointCount() const noexcept { return info != nullptr ? info->jointCount : 0; }
+    std::size_t frameCount() const noexcept { return info != nullptr ? info->frameCount : 0; }
+    std::size_t keyCount() const noexcept { return info != nullptr ? info->keyCount : 0; }
+    float sampleRate() const noexcept { return info != nullptr ? info->sampleRate : 0.0f; }
+
+    /**
+     * @brief Gets the length of the clip.
+     *
+     * @return The time of the last frame in seconds.
+     */
+    float duration() const noexcept;
+
+    const AnimationClipRange* ranges() const noexcept;
+    const AnimationClipKey* keys() const noexcept;
+
+    /**
+     * @brief Samples the clip into a pose.
+     *
+     * Times outside [0, duration()] are clamped; wrap looping clips before
+     * sampling. The cursor is rewound when it belongs to another clip or
+     * time is earlier than its last sample.
+     *
+     * @param cursor The playback state of this instance.
+     * @param time The time in seconds.
+     * @param out Receives jointCount() local joint transforms.
+     * @param offset Index of the first joint in out.
+     * @throws std::invalid_argument If out is too short.
+     * @throws std::runtime_error If the clip is not open or a key names a track that does not exist.
+     */
+    template<typename T>
+    void sample(AnimationClipCursor<T>& cursor, float time, TransformSoA<T>& out, std::size_t offset = 0) const;
+
+private:
+    std::vector<unsigned char> image;
+    MappedFile file;
+    const unsigned char* bytes = nullptr;
+    const AnimationClipHeader* info = nullptr;
+
+    static const char* validate(const unsigned char* data, std::size_t size, bool verifyChecksum);
+
+    template<typename T>
+    void rewind(AnimationClipCursor<T>& cursor) const;
+
+    template<typename T>
+    void consume(AnimationClipCursor<T>& cursor, const AnimationClipKey& key) const;
+};
+
+// Commonly used types
+using AnimationClipCursorf = AnimationClipCursor<float>;
+
+#include "AnimationClip.inl"
+
+#endif // ANIMATIONCLIP_H
@@ -0,0 +1,463 @@
+#ifndef ANIMATIONCLIP_INL
+#define ANIMATIONCLIP_INL
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "../math/FloatLanes.h"
+
+static_assert(sizeof(AnimationClipHeader) == 64, "AnimationClipHeader must not contain padding");
+static_assert(sizeof(AnimationClipRange) == 24, "AnimationClipRange must not contain padding");
+static_assert(sizeof(AnimationClipKey) == 12, "AnimationClipKey must not contain padding");
+static_assert(alignof(AnimationClipHeader) >= alignof(AnimationClipRange) && alignof(AnimationClipHeader) >= alignof(AnimationClipKey),
+              "Aligning the image to the header must align every record");
+
+namespace detail {
+
+constexpr char animationClipMagic[8] = { 'R', 'F', 'X', 'C', 'L', 'I', 'P', '\0' };
+constexpr std::size_t clipChannels = 3;        // Translation, rotation and scale tracks per joint.
+constexpr std::size_t clipRotationChannel = 1;
+constexpr std::size_t clipMaxJoints = 21845;   // Track numbers must fit 16 bits.
+constexpr std::size_t clipMaxFrames = 65536;   // Frame numbers must fit 16 bits.
+
+// Per channel the cursor keeps, joint by joint: the left key's four
+// components, the right key minus the left key, the left key's frame and
+// one over the distance between the keys in frames.
+constexpr std::size_t clipCursorStreams = 10;
+
+inline std::uint16_t quantizeClipUnit(double fraction) noexcept {
+    return static_cast<std::uint16_t>(std::lround(std::min(1.0, std::max(0.0, fraction)) * 65535.0));
+}
+
+inline void encodeClipKey(std::size_t channel, const std::array<double, 4>& value, const AnimationClipRange& range,
+                          AnimationClipKey& key) noexcept {
+    if (channel == clipRotationChannel) {
+        int largest = 0;
+        for (int c = 1; c < 4; ++c) {
+            if (std::fabs(value[c]) > std::fabs(value[largest])) largest = c;
+        }
+        // q and -q are the same rotation; store the one with a positive largest component.
+        double sign = value[largest] < 0 ? -1.0 : 1.0;
+        const double toUnit = 0.5 * std::sqrt(2.0);
+        for (int c = 0, k = 0; c < 4; ++c) {
+            if (c != largest) key.value[k++] = quantizeClipUnit(sign * value[c] * toUnit + 0.5);
+        }
+        key.value[3] = static_cast<std::uint16_t>(largest);
+        return;
+    }
+    for (std::size_t c = 0; c < 3; ++c) {
+        double extent = range.extent[c];
+        key.value[c] = extent > 0 ? quantizeClipUnit((value[c] - range.minimum[c]) / extent) : 0;
+    }
+    key.value[3] = 0;
+}
+
+template<typename T>
+inline void decodeClipKey(std::size_t channel, const AnimationClipKey& key, const AnimationClipRange& range,
+                          T (&value)[4]) noexcept {
+    if (channel == clipRotationChannel) {
+        const T step = T(2) / T(65535);
+        const T fromUnit = static_cast<T>(1.0 / std::sqrt(2.0));
+        int largest = key.value[3] & 3;
+        T sum = 0;
+        for (int c = 0, k = 0; c < 4; ++c) {
+            if (c == largest) continue;
+            value[c] = (static_cast<T>(key.value[k++]) * step - T(1)) * fromUnit;
+            sum += value[c] * value[c];
+        }
+        value[largest] = std::sqrt(std::max(T(0), T(1) - sum));
+        return;
+    }
+    for (std::size_t c = 0; c < 3; ++c) {
+        value[c] = static_cast<T>(range.minimum[c]) +
+                   static_cast<T>(key.value[c]) * (static_cast<T>(range.extent[c]) / T(65535));
+    }
+    value[3] = 0;
+}
+
+// Interpolates two decoded keys the way the sampler does: lerp, or nlerp
+// along the shorter arc for rotations.
+inline void interpolateClipValue(std::size_t channel, const std::array<double, 4>& a, const std::array<double, 4>& b,
+                                 double t, std::array<double, 4>& out) noexcept {
+    double sign = 1.0;
+    if (channel == clipRotationChannel && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0) sign = -1.0;
+    for (std::size_t c = 0; c < 4; ++c) out[c] = a[c] + (sign * b[c] - a[c]) * t;
+    if (channel == clipRotationChannel) {
+        double length = std::sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2] + out[3] * out[3]);
+        for (double& component : out) component /= length;
+    }
+}
+
+// Distance between a reconstructed and a source value in the units of the channel's tolerance.
+inline double clipValueError(std::size_t channel, const std::array<double, 4>& a, const std::array<double, 4>& b) noexcept {
+    if (channel == clipRotationChannel) {
+        double dot = std::fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+        return 2.0 * std::acos(std::min(1.0, dot));
+    }
+    if (channel == 0) {
+        double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    return std::max({ std::fabs(a[0] - b[0]), std::fabs(a[1] - b[1]), std::fabs(a[2] - b[2]) });
+}
+
+// Picks the key frames of one track greedily: from every key, the next key
+// is the farthest frame such that interpolating the two decoded keys
+// reproduces every frame between them within the tolerance.
+inline void reduceClipTrack(std::size_t channel, const std::vector<std::array<double, 4>>& source,
+                            const std::vector<std::array<double, 4>>& decoded, double tolerance,
+                            std::vector<std::uint16_t>& keyFrames) {
+    keyFrames.clear();
+    keyFrames.push_back(0);
+    const std::size_t last = source.size() - 1;
+    auto fits = [&](std::size_t from, std::size_t to) {
+        for (std::size_t f = from + 1; f < to; ++f) {
+            std::array<double, 4> value;
+            interpolateClipValue(channel, decoded[from], decoded[to], double(f - from) / double(to - from), value);
+            if (clipValueError(channel, value, source[f]) > tolerance) return false;
+        }
+        return true;
+    };
+    // The next key is the farthest frame that still fits: the span doubles
+    // while it fits, then is bisected between the last span that fit and the
+    // first that did not. Each run costs O(n log n) rather than O(n^2).
+    for (std::size_t from = 0; from < last;) {
+        std::size_t good = from + 1;
+        std::size_t bad = last + 1;
+        for (std::size_t step = 1; good < last; step *= 2) {
+            std::size_t probe = std::min(good + step, last);
+            if (!fits(from, probe)) {
+                bad = probe;
+                break;
+            }
+            good = probe;
+        }
+        while (bad - good > 1) {
+            std::size_t probe = good + (bad - good) / 2;
+            if (fits(from, probe)) {
+                good = probe;
+            } else {
+                bad = probe;
+            }
+        }
+        keyFrames.push_back(static_cast<std::uint16_t>(good));
+        from = good;
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+std::vector<unsigned char> AnimationClip::serialize(const TransformSoA<T>& frames, std::size_t jointCount, float sampleRate,
+                                                    const AnimationClipSettings& settings) {
+    if (!(sampleRate > 0.0f) || !std::isfinite(sampleRate)) {
+        throw std::invalid_argument("Animation clip sample rate must be positive");
+    }
+    if (jointCount == 0 || frames.size() == 0 || frames.size() % jointCount != 0) {
+        throw std::invalid_argument("Animation clip frames do not match the joint count");
+    }
+    const std::size_t frameCount = frames.size() / jointCount;
+    if (frameCount > detail::clipMaxFrames || jointCount > detail::clipMaxJoints) {
+        throw std::invalid_argument("Animation clip has too many frames or joints");
+    }
+    const std::size_t trackCount = detail::clipChannels * jointCount;
+    const double tolerances[detail::clipChannels] = { settings.translationTolerance, settings.rotationTolerance,
+                                                     settings.scaleTolerance };
+
+    // The first key of every track comes first, in track order; every later
+    // key is needed once the sampler reaches the frame of the key before it.
+    struct PendingKey {
+        std::uint16_t needed;
+        AnimationClipKey key;
+    };
+    std::vector<AnimationClipRange> ranges(trackCount, AnimationClipRange{});
+    std::vector<AnimationClipKey> stream(trackCount);
+    std::vector<PendingKey> pending;
+    std::vector<std::array<double, 4>> source(frameCount);
+    std::vector<std::array<double, 4>> decoded(frameCount);
+    std::vector<AnimationClipKey> encoded(frameCount);
+    std::vector<std::uint16_t> keyFrames;
+
+    for (std::size_t track = 0; track < trackCount; ++track) {
+        const std::size_t joint = track / detail::clipChannels;
+        const std::size_t channel = track % detail::clipChannels;
+        const VectorArray<T, 3>* vectors = channel == 0 ? &frames.positions : &frames.scales;
+        for (std::size_t f = 0; f < frameCount; ++f) {
+            std::size_t i = f * jointCount + joint;
+            if (channel == detail::clipRotationChannel) {
+                double length = 0;
+                for (std::size_t c = 0; c < 4; ++c) {
+                    source[f][c] = static_cast<double>(frames.rotations.component(c)[i]);
+                    length += source[f][c] * source[f][c];
+                }
+                length = std::sqrt(length);
+                for (std::size_t c = 0; c < 4; ++c) source[f][c] = length > 0 ? source[f][c] / length : (c == 3 ? 1.0 : 0.0);
+            } else {
+                for (std::size_t c = 0; c < 3; ++c) source[f][c] = static_cast<double>(vectors->component(c)[i]);
+                source[f][3] = 0;
+            }
+        }
+
+        AnimationClipRange& range = ranges[track];
+        if (channel != detail::clipRotationChannel) {
+            for (std::size_t c = 0; c < 3; ++c) {
+                double low = source[0][c], high = source[0][c];
+                for (std::size_t f = 1; f < frameCount; ++f) {
+                    low = std::min(low, source[f][c]);
+                    high = std::max(high, source[f][c]);
+                }
+                range.minimum[c] = static_cast<float>(low);
+                range.extent[c] = static_cast<float>(high - low);
+            }
+        }
+
+        for (std::size_t f = 0; f < frameCount; ++f) {
+            encoded[f].track = static_cast<std::uint16_t>(track);
+            encoded[f].frame = static_cast<std::uint16_t>(f);
+            detail::encodeClipKey(channel, source[f], range, encoded[f]);
+            double value[4];
+            detail::decodeClipKey(channel, encoded[f], range, value);
+            std::copy(value, value + 4, decoded[f].begin());
+        }
+
+        detail::reduceClipTrack(channel, source, decoded, tolerances[channel], keyFrames);
+        stream[track] = encoded[keyFrames[0]];
+        for (std::size_t k = 1; k < keyFrames.size(); ++k) pending.push_back({ keyFrames[k - 1], encoded[keyFrames[k]] });
+    }
+
+    std::sort(pending.begin(), pending.end(), [](const PendingKey& a, const PendingKey& b) {
+        return a.needed != b.needed ? a.needed < b.needed : a.key.track < b.key.track;
+    });
+    for (const PendingKey& key : pending) stream.push_back(key.key);
+    if (stream.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Animation clip has too many keys");
+    }
+
+    // Lay out the sections.
+    AnimationClipHeader header = {};
+    std::memcpy(header.magic, detail::animationClipMagic, sizeof(header.magic));
+    header.version = version;
+    header.byteOrder = detail::fileByteOrder;
+    header.jointCount = static_cast<std::uint32_t>(jointCount);
+    header.frameCount = static_cast<std::uint32_t>(frameCount);
+    header.sampleRate = sampleRate;
+    header.keyCount = static_cast<std::uint32_t>(stream.size());
+    header.rangesOffset = detail::alignFileOffset(sizeof(AnimationClipHeader));
+    header.keysOffset = detail::alignFileOffset(header.rangesOffset + ranges.size() * sizeof(AnimationClipRange));
+    header.fileSize = detail::alignFileOffset(header.keysOffset + stream.size() * sizeof(AnimationClipKey));
+
+    std::vector<unsigned char> bytes(static_cast<std::size_t>(header.fileSize));
+    std::memcpy(bytes.data() + header.rangesOffset, ranges.data(), ranges.size() * sizeof(AnimationClipRange));
+    std::memcpy(bytes.data() + header.keysOffset, stream.data(), stream.size() * sizeof(AnimationClipKey));
+    std::size_t headerSize = static_cast<std::size_t>(header.rangesOffset);
+    header.checksum = detail::checksum64(bytes.data() + headerSize, bytes.size() - headerSize);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+}
+
+template<typename T>
+AnimationClip AnimationClip::build(const TransformSoA<T>& frames, std::size_t jointCount, float sampleRate,
+                                   const AnimationClipSettings& settings) {
+    AnimationClip clip;
+    clip.image = serialize(frames, jointCount, sampleRate, settings);
+    clip.bytes = clip.image.data();
+    clip.info = reinterpret_cast<const AnimationClipHeader*>(clip.bytes);
+    return clip;
+}
+
+template<typename T>
+void AnimationClip::write(const std::string& path, const TransformSoA<T>& frames, std::size_t jointCount, float sampleRate,
+                          const AnimationClipSettings& settings) {
+    std::vector<unsigned char> bytes = serialize(frames, jointCount, sampleRate, settings);
+
+    if (!detail::writeFileAtomically(path, bytes.data(), bytes.size())) {
+        throw std::runtime_error("Cannot write animation clip " + path);
+    }
+}
+
+inline const char* AnimationClip::validate(const unsigned char* data, std::size_t size, bool verifyChecksum) {
+    // The header and records are used in place, so the image must be aligned
+    // like the header; every section is aligned within the image.
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(AnimationClipHeader) != 0) return "misaligned image";
+    if (size < sizeof(AnimationClipHeader)) return "file is too small";
+    AnimationClipHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, detail::animationClipMagic, sizeof(header.magic)) != 0) return "not an animation clip";
+    if (header.version != version) return "unsupported version";
+    if (header.byteOrder != detail::fileByteOrder) return "different byte order";
+    if (header.fileSize != size) return "truncated file";
+    if (header.jointCount == 0 || header.jointCount > detail::clipMaxJoints || header.frameCount == 0 ||
+        header.frameCount > detail::clipMaxFrames || !(header.sampleRate > 0.0f) || !std::isfinite(header.sampleRate)) {
+        return "invalid clip";
+    }
+
+    // Every section must lie inside the file, and every track needs a first key.
+    std::uint64_t tracks = detail::clipChannels * std::uint64_t(header.jointCount);
+    auto inside = [&](std::uint64_t offset, std::uint64_t size) {
+        return offset % detail::fileAlignment == 0 && offset <= header.fileSize && size <= header.fileSize - offset;
+    };
+    bool valid = header.keyCount >= tracks && inside(header.rangesOffset, tracks * sizeof(AnimationClipRange)) &&
+                 inside(header.keysOffset, header.keyCount * std::uint64_t(sizeof(AnimationClipKey)));
+    if (!valid) return "invalid layout";
+
+    if (verifyChecksum) {
+        std::size_t headerSize = static_cast<std::size_t>(detail::alignFileOffset(sizeof(AnimationClipHeader)));
+        if (size < headerSize) return "invalid layout";
+        if (detail::checksum64(data + headerSize, size - headerSize) != header.checksum) return "checksum mismatch";
+    }
+    return nullptr;
+}
+
+inline AnimationClip AnimationClip::open(const std::string& path, bool verifyChecksum) {
+    AnimationClip clip;
+    if (!clip.file.open(path)) throw std::runtime_error("Cannot map animation clip " + path);
+    if (const char* problem = validate(clip.file.data(), clip.file.size(), verifyChecksum)) {
+        throw std::runtime_error("Invalid animation clip " + path + ": " + problem);
+    }
+    clip.bytes = clip.file.data();
+    clip.info = reinterpret_cast<const AnimationClipHeader*>(clip.bytes);
+    return clip;
+}
+
+inline AnimationClip AnimationClip::view(const void* data, std::size_t size, bool verifyChecksum) {
+    AnimationClip clip;
+    const unsigned char* image = static_cast<const unsigned char*>(data);
+    if (const char* problem = validate(image, size, verifyChecksum)) {
+        throw std::runtime_error(std::string("Invalid animation clip image: ") + problem);
+    }
+    clip.bytes = image;
+    clip.info = reinterpret_cast<const AnimationClipHeader*>(clip.bytes);
+    return clip;
+}
+
+inline float AnimationClip::duration() const noexcept {
+    return info != nullptr ? static_cast<float>(info->frameCount - 1) / info->sampleRate : 0.0f;
+}
+
+inline const AnimationClipRange* AnimationClip::ranges() const noexcept {
+    return info != nullptr ? reinterpret_cast<const AnimationClipRange*>(bytes + info->rangesOffset) : nullptr;
+}
+
+inline const AnimationClipKey* AnimationClip::keys() const noexcept {
+    return info != nullptr ? reinterpret_cast<const AnimationClipKey*>(bytes + info->keysOffset) : nullptr;
+}
+
+template<typename T>
+void AnimationClip::rewind(AnimationClipCursor<T>& cursor) const {
+    const std::size_t joints = jointCount();
+    const std::size_t tracks = detail::clipChannels * joints;
+    const AnimationClipKey* stream = keys();
+    cursor.keys = stream;
+    cursor.joints = joints;
+    cursor.frame = 0;
+    cursor.rightFrames.assign(tracks, 0);
+    cursor.streams.assign(detail::clipChannels * detail::clipCursorStreams * joints, T(0));
+
+    // The first key of every track holds until the second one is consumed.
+    for (std::size_t track = 0; track < tracks; ++track) {
+        const AnimationClipKey& key = stream[track];
+        if (key.track != track) {
+            cursor.keys = nullptr;
+            throw std::runtime_error("Animation clip key stream is damaged");
+        }
+        std::size_t channel = track % detail::clipChannels;
+        std::size_t joint = track / detail::clipChannels;
+        T* s = cursor.streams.data() + channel * detail::clipCursorStreams * joints;
+        T value[4];
+        detail::decodeClipKey(channel, key, ranges()[track], value);
+        for (std::size_t c = 0; c < 4; ++c) s[c * joints + joint] = value[c];
+        s[8 * joints + joint] = static_cast<T>(key.frame);
+        cursor.rightFrames[track] = key.frame;
+    }
+    cursor.next = tracks;
+}
+
+template<typename T>
+void AnimationClip::consume(AnimationClipCursor<T>& cursor, const AnimationClipKey& key) const {
+    const std::size_t joints = cursor.joints;
+    const std::size_t channel = key.track % detail::clipChannels;
+    const std::size_t joint = key.track / detail::clipChannels;
+    T* s = cursor.streams.data() + channel * detail::clipCursorStreams * joints + joint;
+
+    // The old right key becomes the left key.
+    T value[4];
+    T left[4];
+    detail::decodeClipKey(channel, key, ranges()[key.track], value);
+    for (std::size_t c = 0; c < 4; ++c) left[c] = s[c * joints] + s[(4 + c) * joints];
+    if (channel == detail::clipRotationChannel &&
+        left[0] * value[0] + left[1] * value[1] + left[2] * value[2] + left[3] * value[3] < 0) {
+        for (T& component : value) component = -component;
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+        s[c * joints] = left[c];
+        s[(4 + c) * joints] = value[c] - left[c];
+    }
+    T leftFrame = static_cast<T>(cursor.rightFrames[key.track]);
+    T span = static_cast<T>(key.frame) - leftFrame;
+    s[8 * joints] = leftFrame;
+    s[9 * joints] = span > 0 ? T(1) / span : T(0);
+    cursor.rightFrames[key.track] = key.frame;
+}
+
+template<typename T>
+void AnimationClip::sample(AnimationClipCursor<T>& cursor, float time, TransformSoA<T>& out, std::size_t offset) const {
+    if (info == nullptr) throw std::runtime_error("Animation clip is not open");
+    const std::size_t joints = jointCount();
+    if (offset > out.size() || out.size() - offset < joints) {
+        throw std::invalid_argument("Animation clip output pose is too short");
+    }
+
+    T frame = static_cast<T>(time) * static_cast<T>(info->sampleRate);
+    if (!(frame > T(0))) frame = 0;
+    frame = std::min(frame, static_cast<T>(info->frameCount - 1));
+    if (cursor.keys != keys() || cursor.joints != joints || frame < cursor.frame) rewind(cursor);
+    cursor.frame = frame;
+
+    // Consume every key that is needed by now; the stream is ordered so the
+    // first key that is not needed yet ends the walk.
+    const AnimationClipKey* stream = keys();
+    const std::size_t count = keyCount();
+    const std::size_t tracks = detail::clipChannels * joints;
+    while (cursor.next < count) {
+        const AnimationClipKey& key = stream[cursor.next];
+        if (key.track >= tracks) throw std::runtime_error("Animation clip key names a missing track");
+        if (static_cast<T>(cursor.rightFrames[key.track]) > frame) break;
+        consume(cursor, key);
+        ++cursor.next;
+    }
+
+    VectorArray<T, 3>* vectors[detail::clipChannels] = { &out.positions, nullptr, &out.scales };
+    for (std::size_t channel = 0; channel < detail::clipChannels; ++channel) {
+        const T* s = cursor.streams.data() + channel * detail::clipCursorStreams * joints;
+        const bool rotation = channel == detail::clipRotationChannel;
+        T* target[4];
+        for (std::size_t c = 0; c < 4; ++c) {
+            target[c] = rotation ? out.rotations.component(c) + offset : c < 3 ? vectors[channel]->component(c) + offset : nullptr;
+        }
+        detail::forEachLane<T>(0, joints, [&](auto lanes, std::size_t j) {
+            using L = decltype(lanes);
+            using V = decltype(L::set(T(0)));
+            V alpha = L::mul(L::sub(L::set(frame), L::load(s + 8 * joints + j)), L::load(s + 9 * joints + j));
+            alpha = L::min(L::max(alpha, L::set(T(0))), L::set(T(1)));
+            V value[4];
+            const std::size_t components = rotation ? 4 : 3;
+            for (std::size_t c = 0; c < components; ++c) {
+                value[c] = L::add(L::load(s + c * joints + j), L::mul(L::load(s + (4 + c) * joints + j), alpha));
+            }
+            if (rotation) {
+                V length = L::add(L::add(L::mul(value[0], value[0]), L::mul(value[1], value[1])),
+                                  L::add(L::mul(value[2], value[2]), L::mul(value[3], value[3])));
+                V scale = L::rsqrt(length);
+                for (std::size_t c = 0; c < 4; ++c) value[c] = L::mul(value[c], scale);
+            }
+            for (std::size_t c = 0; c < components; ++c) L::store(target[c] + j, value[c]);
+        });
+    }
+}
+
+#endif // ANIMATIONCLIP_INL
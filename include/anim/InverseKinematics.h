@@ -0,0 +1,175 @@
+#ifndef INVERSEKINEMATICS_H
+#define INVERSEKINEMATICS_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../math/VectorArray.h"
+
+/**
+ * @brief The limbs of a two-bone IK batch, one element per limb.
+ *
+ * All positions are in the same space, usually model space.
+ *
+ * @tparam T Type of the coordinates.
+ */
+template<typename T>
+struct TwoBoneIkBatch {
+    VectorArray<T, 3> root;   ///< Upper joint, e.g. hip or shoulder.
+    VectorArray<T, 3> mid;    ///< Middle joint, e.g. knee or elbow.
+    VectorArray<T, 3> end;    ///< End joint, e.g. ankle or wrist.
+    VectorArray<T, 3> target; ///< Where the end joint should go.
+    VectorArray<T, 3> pole;   ///< A point the middle joint bends toward, e.g. in front of the knee.
+
+    /**
+     * @brief Resizes every array.
+     *
+     * @param count The number of limbs.
+     */
+    void resize(std::size_t count);
+
+    std::size_t size() const noexcept { return root.size(); }
+};
+
+/**
+ * @brief Analytic two-bone IK for many limbs, e.g. foot placement for a crowd.
+ *
+ * The middle joint is placed with the law of cosines in the plane of the
+ * root, the target and the pole, so the solution takes square roots and
+ * divisions but no trigonometry. Targets out of reach leave the limb
+ * stretched toward them; targets too close fold it as far as the bone
+ * lengths allow. Limbs are solved over SIMD lanes (see FloatLanes.h).
+ *
+ * @tparam T Type of the coordinates.
+ */
+template<typename T>
+class TwoBoneIk {
+public:
+    static_assert(std::is_floating_point<T>::value, "TwoBoneIk requires a floating-point type");
+
+    /**
+     * @brief Solves every limb of a batch.
+     *
+     * The results are rotations in the space of the positions, applied on
+     * the left of the joints' current rotations in that space:
+     * newRoot = rootRotation * root, newMid = midRotation * mid.
+     *
+     * @param limbs The limbs.
+     * @param rootRotations Receives the rotation of every root joint as (x, y, z, w); resized to match.
+     * @param midRotations Receives the rotation of every middle joint as (x, y, z, w); resized to match.
+     * @param pool Threads to spread the limbs over; the calling thread does all the work if null.
+     * @throws std::invalid_argument If the arrays of limbs have different sizes.
+     */
+    static void solve(const TwoBoneIkBatch<T>& limbs, VectorArray<T, 4>& rootRotations, VectorArray<T, 4>& midRotations,
+                      ThreadPool* pool = nullptr);
+};
+
+/**
+ * @brief The iterative algorithm of an IkChainSolver.
+ */
+enum class IkChainMethod {
+    Fabrik, ///< Forward and backward reaching: moves joints along the bones; converges in few iterations.
+    Ccd     ///< Cyclic coordinate descent: rotates the chain at one joint at a time, from the end to the root.
+};
+
+/**
+ * @brief Iteration limits of an IkChainSolver.
+ *
+ * @tparam T Type of the coordinates.
+ */
+template<typename T>
+struct IkChainSettings {
+    IkChainMethod method = IkChainMethod::Fabrik;
+    std::size_t maxIterations = 10; ///< Iterations before giving up on a chain.
+    T tolerance = T(1e-3);          ///< Distance from the target at which a chain has converged.
+};
+
+/**
+ * @brief Solves many joint chains of the same shape, e.g. spines, tails or look-at chains.
+ *
+ * Chains are stored joint by joint: joint j of chain c is element
+ * j * chainCount + c of the positions, so the same joint of consecutive
+ * chains forms SIMD lanes (see FloatLanes.h). Bone lengths come from the
+ * input positions and the root joint stays in place.
+ *
+ * Lanes iterate until every chain in them is within tolerance of its
+ * target, or as close as it can get to an unreachable one. A chain lying
+ * straight along the line to its target is first kinked slightly at joint
+ * 1, since steps along that line could never bend it. A cone limit on
+ * a joint bounds the angle between its bone and its parent's bone; limits
+ * are shared by all chains.
+ *
+ * @tparam T Type of the coordinates.
+ */
+template<typename T>
+class IkChainSolver {
+public:
+    static_assert(std::is_floating_point<T>::value, "IkChainSolver requires a floating-point type");
+
+    /**
+     * @brief Creates a solver for chains of a given length.
+     *
+     * @param jointCount Joints per chain, including the root and the end effector.
+     * @param settings The algorithm and its limits.
+     * @throws std::invalid_argument If jointCount is less than 2.
+     */
+    explicit IkChainSolver(std::size_t jointCount, const IkChainSettings<T>& settings = IkChainSettings<T>());
+
+    std::size_t jointCount() const noexcept { return joints; }
+    const IkChainSettings<T>& settings() const noexcept { return chainSettings; }
+
+    /**
+     * @brief Limits how far a joint bends.
+     *
+     * @param joint The joint, from 1 to jointCount() - 2; its bone leads to joint + 1.
+     * @param maxAngle The largest angle between the joint's bone and its parent's bone, in radians.
+     * @throws std::out_of_range If joint has no parent bone or no bone of its own.
+     */
+    void setConeLimit(std::size_t joint, T maxAngle);
+
+    /**
+     * @brief Moves the joints of many chains toward their targets.
+     *
+     * @param positions The joint positions of every chain, see the class description; updated in place.
+     * @param targets The target of every chain's end effector.
+     * @param pool Threads to spread the chains over; the calling thread does all the work if null.
+     * @return The most iterations any lanes needed.
+     * @throws std::invalid_argument If positions does not hold jointCount() joints per target.
+     */
+    std::size_t solve(VectorArray<T, 3>& positions, const VectorArray<T, 3>& targets, ThreadPool* pool = nullptr) const;
+
+    /**
+     * @brief Computes the rotations that turn the bones of solved chains.
+     *
+     * Each rotation is the shortest arc from a bone's old direction to its
+     * new one, applied on the left like TwoBoneIk's results; the end
+     * effector gets the rotation of its parent's bone.
+     *
+     * @param before The joint positions before solve().
+     * @param after The joint positions after solve().
+     * @param out Receives one rotation per joint as (x, y, z, w); resized to match.
+     * @throws std::invalid_argument If the arrays have different sizes or do not hold whole chains.
+     */
+    void boneRotations(const VectorArray<T, 3>& before, const VectorArray<T, 3>& after, VectorArray<T, 4>& out) const;
+
+private:
+    std::size_t joints;
+    IkChainSettings<T> chainSettings;
+    std::vector<T> coneCosines; // Per joint; -1 where unlimited.
+    std::vector<T> coneSines;
+
+    template<typename L>
+    std::size_t solveLanes(VectorArray<T, 3>& positions, const VectorArray<T, 3>& targets, std::size_t chain,
+                           T* lengths) const;
+};
+
+// Commonly used types
+using TwoBoneIkBatchf = TwoBoneIkBatch<float>;
+using TwoBoneIkf = TwoBoneIk<float>;
+using IkChainSettingsf = IkChainSettings<float>;
+using IkChainSolverf = IkChainSolver<float>;
+
+#include "InverseKinematics.inl"
+
+#endif // INVERSEKINEMATICS_H
@@ -0,0 +1,479 @@
+#ifndef INVERSEKINEMATICS_INL
+#define INVERSEKINEMATICS_INL
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include "../math/FloatLanes.h"
+#include "PoseBlend.h"
+
+namespace detail {
+
+template<typename L, typename T, typename V>
+inline void loadVectorLanes(const VectorArray<T, 3>& array, std::size_t i, V out[3]) noexcept {
+    for (std::size_t c = 0; c < 3; ++c) out[c] = L::load(array.component(c) + i);
+}
+
+template<typename L, typename T, typename V>
+inline void storeVectorLanes(VectorArray<T, 3>& array, std::size_t i, const V v[3]) noexcept {
+    for (std::size_t c = 0; c < 3; ++c) L::store(array.component(c) + i, v[c]);
+}
+
+template<typename L, typename V>
+inline V dotVectorLanes(const V a[3], const V b[3]) noexcept {
+    return L::add(L::add(L::mul(a[0], b[0]), L::mul(a[1], b[1])), L::mul(a[2], b[2]));
+}
+
+template<typename L, typename V>
+inline void crossVectorLanes(const V a[3], const V b[3], V out[3]) noexcept {
+    V x = L::sub(L::mul(a[1], b[2]), L::mul(a[2], b[1]));
+    V y = L::sub(L::mul(a[2], b[0]), L::mul(a[0], b[2]));
+    V z = L::sub(L::mul(a[0], b[1]), L::mul(a[1], b[0]));
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+// Scales vector lanes to unit length; zero-length ones stay zero.
+template<typename L, typename V, typename T>
+inline void normalizeVectorLanes(V v[3], T tiny) noexcept {
+    V lengthSquared = dotVectorLanes<L>(v, v);
+    auto valid = L::greater(lengthSquared, L::set(tiny));
+    V inverseLength = L::select(valid, L::rsqrt(L::max(lengthSquared, L::set(tiny))), L::set(T(0)));
+    for (int c = 0; c < 3; ++c) v[c] = L::mul(v[c], inverseLength);
+}
+
+// Scales vector lanes to unit length; zero-length ones take the unit
+// vector fallback instead.
+template<typename L, typename V, typename T>
+inline void normalizeVectorLanes(V v[3], const V fallback[3], T tiny) noexcept {
+    V lengthSquared = dotVectorLanes<L>(v, v);
+    auto valid = L::greater(lengthSquared, L::set(tiny));
+    V inverseLength = L::rsqrt(L::max(lengthSquared, L::set(tiny)));
+    for (int c = 0; c < 3; ++c) v[c] = L::select(valid, L::mul(v[c], inverseLength), fallback[c]);
+}
+
+// A unit vector perpendicular to unit vector u: u crossed with whichever of
+// the x and y axes is further from parallel to it.
+template<typename L, typename V, typename T>
+inline void perpendicularVectorLanes(const V u[3], V out[3], T tiny) noexcept {
+    auto nearX = L::greater(L::abs(u[0]), L::set(T(0.5)));
+    out[0] = L::select(nearX, L::sub(L::set(T(0)), u[2]), L::set(T(0)));
+    out[1] = L::select(nearX, L::set(T(0)), u[2]);
+    out[2] = L::select(nearX, u[0], L::sub(L::set(T(0)), u[1]));
+    normalizeVectorLanes<L>(out, tiny);
+}
+
+// The shortest-arc rotation from unit vector u to unit vector v, without
+// trigonometry: (u x v, 1 + u . v), normalized. Opposite vectors, where that
+// vanishes, get a half turn about an axis perpendicular to u; a zero vector
+// gives the identity.
+template<typename L, typename V, typename T>
+inline void shortestArcLanes(const V u[3], const V v[3], V q[4], T tiny) noexcept {
+    crossVectorLanes<L>(u, v, q);
+    q[3] = L::add(L::set(T(1)), dotVectorLanes<L>(u, v));
+    auto opposite = L::greater(L::set(tiny), dotQuaternionLanes<L>(q, q));
+    if (L::any(opposite)) {
+        V axis[3];
+        perpendicularVectorLanes<L>(u, axis, tiny);
+        for (int c = 0; c < 3; ++c) q[c] = L::select(opposite, axis[c], q[c]);
+        q[3] = L::select(opposite, L::set(T(0)), q[3]);
+    }
+    normalizeQuaternionLanes<L>(q, tiny);
+}
+
+// Rotates vector lanes by unit quaternion lanes (x, y, z, w).
+template<typename L, typename V, typename T>
+inline void rotateVectorLanes(const V q[4], const V v[3], V out[3], T two) noexcept {
+    V t[3];
+    V u[3];
+    crossVectorLanes<L>(q, v, t);
+    for (int c = 0; c < 3; ++c) t[c] = L::mul(t[c], L::set(two));
+    crossVectorLanes<L>(q, t, u);
+    for (int c = 0; c < 3; ++c) out[c] = L::add(L::add(v[c], L::mul(q[3], t[c])), u[c]);
+}
+
+// Turns unit direction d toward unit direction parent until the angle
+// between them is at most the cone's; returns where d was changed.
+template<typename L, typename V, typename T>
+inline auto coneLimitLanes(const V parent[3], V d[3], T cosine, T sine, T tiny) noexcept {
+    V cosAngle = dotVectorLanes<L>(parent, d);
+    auto violated = L::greater(L::set(cosine), cosAngle);
+    if (!L::any(violated)) return violated;
+    V clamped[3], across[3];
+    for (int c = 0; c < 3; ++c) clamped[c] = L::sub(d[c], L::mul(parent[c], cosAngle));
+    perpendicularVectorLanes<L>(parent, across, tiny);
+    normalizeVectorLanes<L>(clamped, across, tiny);
+    for (int c = 0; c < 3; ++c) clamped[c] = L::add(L::mul(parent[c], L::set(cosine)), L::mul(clamped[c], L::set(sine)));
+    for (int c = 0; c < 3; ++c) d[c] = L::select(violated, clamped[c], d[c]);
+    return violated;
+}
+
+} // namespace detail
+
+template<typename T>
+void TwoBoneIkBatch<T>::resize(std::size_t count) {
+    root.resize(count);
+    mid.resize(count);
+    end.resize(count);
+    target.resize(count);
+    pole.resize(count);
+}
+
+template<typename T>
+void TwoBoneIk<T>::solve(const TwoBoneIkBatch<T>& limbs, VectorArray<T, 4>& rootRotations, VectorArray<T, 4>& midRotations,
+                         ThreadPool* pool) {
+    const std::size_t count = limbs.size();
+    if (limbs.mid.size() != count || limbs.end.size() != count || limbs.target.size() != count ||
+        limbs.pole.size() != count) {
+        throw std::invalid_argument("TwoBoneIk limb arrays have different sizes");
+    }
+    rootRotations.resize(count);
+    midRotations.resize(count);
+
+    auto run = [&](std::size_t first, std::size_t last) {
+        detail::forEachLane<T>(first, last, [&](auto lanes, std::size_t i) {
+            using L = decltype(lanes);
+            using V = decltype(L::set(T(0)));
+            const T tiny = T(1e-12);
+            V root[3], mid[3], end[3], target[3], pole[3];
+            detail::loadVectorLanes<L>(limbs.root, i, root);
+            detail::loadVectorLanes<L>(limbs.mid, i, mid);
+            detail::loadVectorLanes<L>(limbs.end, i, end);
+            detail::loadVectorLanes<L>(limbs.target, i, target);
+            detail::loadVectorLanes<L>(limbs.pole, i, pole);
+
+            V upper[3], lower[3], direction[3], toPole[3], toEnd[3];
+            for (int c = 0; c < 3; ++c) {
+                upper[c] = L::sub(mid[c], root[c]);
+                lower[c] = L::sub(end[c], mid[c]);
+                direction[c] = L::sub(target[c], root[c]);
+                toPole[c] = L::sub(pole[c], root[c]);
+                toEnd[c] = L::sub(end[c], root[c]);
+            }
+            V upperSquared = detail::dotVectorLanes<L>(upper, upper);
+            V lowerSquared = detail::dotVectorLanes<L>(lower, lower);
+            V upperLength = L::sqrt(upperSquared);
+            V lowerLength = L::sqrt(lowerSquared);
+
+            // Reach toward the target, or along the limb if the target is at the root.
+            V distanceSquared = detail::dotVectorLanes<L>(direction, direction);
+            auto atRoot = L::greater(L::set(tiny), distanceSquared);
+            for (int c = 0; c < 3; ++c) direction[c] = L::select(atRoot, toEnd[c], direction[c]);
+            detail::normalizeVectorLanes<L>(direction, tiny);
+            V reach = L::min(L::sqrt(distanceSquared), L::add(upperLength, lowerLength));
+            reach = L::max(L::max(reach, L::abs(L::sub(upperLength, lowerLength))), L::set(tiny));
+
+            // Law of cosines: the middle joint lies x along the reach and h off it.
+            V along = L::div(L::add(L::sub(upperSquared, lowerSquared), L::mul(reach, reach)), L::mul(L::set(T(2)), reach));
+            V height = L::sqrt(L::max(L::sub(upperSquared, L::mul(along, along)), L::set(T(0))));
+
+            // Bend toward the pole, or keep the current bend plane if the pole is on the reach line.
+            V bend[3], current[3];
+            V poleAlong = detail::dotVectorLanes<L>(direction, toPole);
+            V upperAlong = detail::dotVectorLanes<L>(direction, upper);
+            for (int c = 0; c < 3; ++c) {
+                bend[c] = L::sub(toPole[c], L::mul(direction[c], poleAlong));
+                current[c] = L::sub(upper[c], L::mul(direction[c], upperAlong));
+            }
+            auto poleOnLine = L::greater(L::mul(L::set(T(1e-8)), detail::dotVectorLanes<L>(toPole, toPole)),
+                                         detail::dotVectorLanes<L>(bend, bend));
+            for (int c = 0; c < 3; ++c) bend[c] = L::select(poleOnLine, current[c], bend[c]);
+            detail::normalizeVectorLanes<L>(bend, tiny);
+
+            V newUpper[3], newLower[3];
+            for (int c = 0; c < 3; ++c) {
+                newUpper[c] = L::add(L::mul(direction[c], along), L::mul(bend[c], height));
+                newLower[c] = L::sub(L::mul(direction[c], reach), newUpper[c]);
+            }
+
+            // The root turns the upper bone onto its new direction; the middle
+            // joint then turns the carried-along lower bone onto its own.
+            V rootRotation[4], arc[4], midRotation[4], rotatedLower[3];
+            detail::normalizeVectorLanes<L>(upper, tiny);
+            detail::normalizeVectorLanes<L>(newUpper, tiny);
+            detail::shortestArcLanes<L>(upper, newUpper, rootRotation, tiny);
+            detail::rotateVectorLanes<L>(rootRotation, lower, rotatedLower, T(2));
+            detail::normalizeVectorLanes<L>(rotatedLower, tiny);
+            detail::normalizeVectorLanes<L>(newLower, tiny);
+            detail::shortestArcLanes<L>(rotatedLower, newLower, arc, tiny);
+            detail::multiplyQuaternionLanes<L>(arc, rootRotation, midRotation);
+            for (std::size_t c = 0; c < 4; ++c) {
+                L::store(rootRotations.component(c) + i, rootRotation[c]);
+                L::store(midRotations.component(c) + i, midRotation[c]);
+            }
+        });
+    };
+    if (pool) {
+        pool->parallelFor(0, count, 256, run);
+    } else {
+        run(0, count);
+    }
+    RENDERFX_CHECK_FINITE_BATCH("TwoBoneIk::solve", midRotations.component(3), midRotations.component(3) + count);
+}
+
+template<typename T>
+IkChainSolver<T>::IkChainSolver(std::size_t jointCount, const IkChainSettings<T>& settings)
+    : joints(jointCount), chainSettings(settings), coneCosines(jointCount, T(-1)), coneSines(jointCount, T(0)) {
+    if (jointCount < 2) throw std::invalid_argument("IkChainSolver requires at least two joints");
+}
+
+template<typename T>
+void IkChainSolver<T>::setConeLimit(std::size_t joint, T maxAngle) {
+    if (joint == 0 || joint + 1 >= joints) throw std::out_of_range("IkChainSolver cone limit needs a joint with a parent and a child");
+    T angle = std::min(std::max(maxAngle, T(0)), T(M_PI));
+    coneCosines[joint] = std::cos(angle);
+    coneSines[joint] = std::sin(angle);
+}
+
+template<typename T>
+std::size_t IkChainSolver<T>::solve(VectorArray<T, 3>& positions, const VectorArray<T, 3>& targets, ThreadPool* pool) const {
+    const std::size_t chains = targets.size();
+    if (positions.size() != joints * chains) {
+        throw std::invalid_argument("IkChainSolver positions must hold jointCount joints per target");
+    }
+
+    std::atomic<std::size_t> most(0);
+    auto run = [&](std::size_t first, std::size_t last) {
+        std::vector<T> lengths((joints - 1) * detail::maxLaneWidth<T>);
+        std::size_t iterations = 0;
+        detail::forEachLane<T>(first, last, [&](auto lanes, std::size_t chain) {
+            using L = decltype(lanes);
+            iterations = std::max(iterations, solveLanes<L>(positions, targets, chain, lengths.data()));
+        });
+        std::size_t seen = most.load();
+        while (iterations > seen && !most.compare_exchange_weak(seen, iterations)) {}
+    };
+    if (pool) {
+        pool->parallelFor(0, chains, 64, run);
+    } else {
+        run(0, chains);
+    }
+    RENDERFX_CHECK_FINITE_BATCH("IkChainSolver::solve", positions.component(0), positions.component(0) + positions.size());
+    return most.load();
+}
+
+template<typename T>
+template<typename L>
+std::size_t IkChainSolver<T>::solveLanes(VectorArray<T, 3>& positions, const VectorArray<T, 3>& targets,
+                                         std::size_t chain, T* lengths) const {
+    static_assert(L::width <= detail::maxLaneWidth<T>, "lengths holds maxLaneWidth lanes per bone");
+    using V = decltype(L::set(T(0)));
+    const T tiny = T(1e-12);
+    const std::size_t chains = targets.size();
+    const std::size_t last = joints - 1;
+    auto load = [&](std::size_t joint, V v[3]) { detail::loadVectorLanes<L>(positions, joint * chains + chain, v); };
+    auto store = [&](std::size_t joint, const V v[3]) { detail::storeVectorLanes<L>(positions, joint * chains + chain, v); };
+    auto boneLength = [&](std::size_t bone) { return L::load(lengths + bone * L::width); };
+
+    V root[3], target[3];
+    load(0, root);
+    detail::loadVectorLanes<L>(targets, chain, target);
+
+    // Bone lengths, and how far each target lies out of reach.
+    V reach = L::set(T(0));
+    V previous[3];
+    for (int c = 0; c < 3; ++c) previous[c] = root[c];
+    for (std::size_t bone = 0; bone < last; ++bone) {
+        V next[3], d[3];
+        load(bone + 1, next);
+        for (int c = 0; c < 3; ++c) {
+            d[c] = L::sub(next[c], previous[c]);
+            previous[c] = next[c];
+        }
+        V length = L::sqrt(detail::dotVectorLanes<L>(d, d));
+        L::store(lengths + bone * L::width, length);
+        reach = L::add(reach, length);
+    }
+    V toTarget[3];
+    for (int c = 0; c < 3; ++c) toTarget[c] = L::sub(target[c], root[c]);
+    V gap = L::max(L::sub(L::sqrt(detail::dotVectorLanes<L>(toTarget, toTarget)), reach), L::set(T(0)));
+    V allowed = L::add(gap, L::set(chainSettings.tolerance));
+    auto unconverged = [&]() {
+        V end[3], error[3];
+        load(last, end);
+        for (int c = 0; c < 3; ++c) error[c] = L::sub(end[c], target[c]);
+        return L::greater(L::sqrt(detail::dotVectorLanes<L>(error, error)), allowed);
+    };
+
+    // A chain lying straight along the line to its target never leaves it:
+    // every step is parallel or opposite to the line. Such chains get a
+    // small rigid kink at joint 1 to bend from.
+    if (last > 1 && L::any(unconverged())) {
+        V line[3], across[3];
+        for (int c = 0; c < 3; ++c) line[c] = toTarget[c];
+        detail::normalizeVectorLanes<L>(line, tiny);
+        V straightness = L::set(T(0));
+        for (std::size_t joint = 1; joint <= last; ++joint) {
+            V p[3];
+            load(joint, p);
+            for (int c = 0; c < 3; ++c) p[c] = L::sub(p[c], root[c]);
+            V along = detail::dotVectorLanes<L>(line, p);
+            for (int c = 0; c < 3; ++c) p[c] = L::sub(p[c], L::mul(line[c], along));
+            straightness = L::max(straightness, detail::dotVectorLanes<L>(p, p));
+        }
+        // Lanes that have converged or whose target is at the root never count as straight.
+        V limit = L::mul(L::set(T(1e-10)), L::mul(reach, reach));
+        limit = L::select(L::greater(detail::dotVectorLanes<L>(line, line), L::set(T(0.5))), limit, L::set(T(-1)));
+        limit = L::select(unconverged(), limit, L::set(T(-1)));
+        auto straight = L::greater(limit, straightness);
+        if (L::any(straight)) {
+            // A turn of 0.1 radians: sin and cos of 0.05.
+            V kink[4];
+            detail::perpendicularVectorLanes<L>(line, across, tiny);
+            for (int c = 0; c < 3; ++c) kink[c] = L::select(straight, L::mul(across[c], L::set(T(0.0499792))), L::set(T(0)));
+            kink[3] = L::select(straight, L::set(T(0.9987503)), L::set(T(1)));
+            V pivot[3];
+            load(1, pivot);
+            for (std::size_t joint = 2; joint <= last; ++joint) {
+                V p[3], offset[3];
+                load(joint, p);
+                for (int c = 0; c < 3; ++c) offset[c] = L::sub(p[c], pivot[c]);
+                detail::rotateVectorLanes<L>(kink, offset, offset, T(2));
+                for (int c = 0; c < 3; ++c) p[c] = L::add(pivot[c], offset[c]);
+                store(joint, p);
+            }
+        }
+    }
+
+    for (std::size_t iteration = 0; iteration < chainSettings.maxIterations; ++iteration) {
+        if (!L::any(unconverged())) return iteration;
+
+        if (chainSettings.method == IkChainMethod::Fabrik) {
+            // Forward: pin the end effector to the target and pull each joint
+            // after it, within the cone of the joint it hangs from. A joint
+            // that lands on the one after it keeps the direction of the bone
+            // before, so no bone collapses. Both directions point rootward,
+            // so the angle between them is the angle at joint + 1.
+            V next[3], previous[3];
+            load(last, next);
+            load(last - 1, previous);
+            for (int c = 0; c < 3; ++c) {
+                previous[c] = L::sub(previous[c], next[c]);
+                next[c] = target[c];
+            }
+            detail::normalizeVectorLanes<L>(previous, tiny);
+            store(last, next);
+            for (std::size_t joint = last; joint-- > 0;) {
+                V p[3], d[3];
+                load(joint, p);
+                for (int c = 0; c < 3; ++c) d[c] = L::sub(p[c], next[c]);
+                detail::normalizeVectorLanes<L>(d, previous, tiny);
+                if (joint + 1 < last && coneCosines[joint + 1] > T(-1)) {
+                    detail::coneLimitLanes<L>(previous, d, coneCosines[joint + 1], coneSines[joint + 1], tiny);
+                }
+                V length = boneLength(joint);
+                for (int c = 0; c < 3; ++c) {
+                    next[c] = L::add(next[c], L::mul(d[c], length));
+                    previous[c] = d[c];
+                }
+                store(joint, next);
+            }
+
+            // Backward: pin the root and push each joint out, within its cone,
+            // with the same fallback; the first bone falls back to its
+            // direction from the forward pass.
+            V prev[3], parent[3];
+            for (int c = 0; c < 3; ++c) {
+                prev[c] = root[c];
+                parent[c] = L::sub(L::set(T(0)), previous[c]);
+            }
+            store(0, prev);
+            for (std::size_t bone = 0; bone < last; ++bone) {
+                V p[3], d[3];
+                load(bone + 1, p);
+                for (int c = 0; c < 3; ++c) d[c] = L::sub(p[c], prev[c]);
+                detail::normalizeVectorLanes<L>(d, parent, tiny);
+                if (bone > 0 && coneCosines[bone] > T(-1)) {
+                    detail::coneLimitLanes<L>(parent, d, coneCosines[bone], coneSines[bone], tiny);
+                }
+                V length = boneLength(bone);
+                for (int c = 0; c < 3; ++c) {
+                    prev[c] = L::add(prev[c], L::mul(d[c], length));
+                    parent[c] = d[c];
+                }
+                store(bone + 1, prev);
+            }
+        } else {
+            // From the last bone to the root, turn the rest of the chain so the
+            // end effector points at the target.
+            for (std::size_t joint = last; joint-- > 0;) {
+                V pivot[3], end[3], toEnd[3], toGoal[3], rotation[4];
+                load(joint, pivot);
+                load(last, end);
+                for (int c = 0; c < 3; ++c) {
+                    toEnd[c] = L::sub(end[c], pivot[c]);
+                    toGoal[c] = L::sub(target[c], pivot[c]);
+                }
+                detail::normalizeVectorLanes<L>(toEnd, tiny);
+                detail::normalizeVectorLanes<L>(toGoal, tiny);
+                detail::shortestArcLanes<L>(toEnd, toGoal, rotation, tiny);
+
+                if (joint > 0 && coneCosines[joint] > T(-1)) {
+                    V grandparent[3], child[3], parent[3], bone[3], turned[3], limited[4];
+                    load(joint - 1, grandparent);
+                    load(joint + 1, child);
+                    for (int c = 0; c < 3; ++c) {
+                        parent[c] = L::sub(pivot[c], grandparent[c]);
+                        bone[c] = L::sub(child[c], pivot[c]);
+                    }
+                    detail::normalizeVectorLanes<L>(parent, tiny);
+                    detail::normalizeVectorLanes<L>(bone, tiny);
+                    detail::rotateVectorLanes<L>(rotation, bone, turned, T(2));
+                    auto violated = detail::coneLimitLanes<L>(parent, turned, coneCosines[joint], coneSines[joint], tiny);
+                    if (L::any(violated)) {
+                        detail::shortestArcLanes<L>(bone, turned, limited, tiny);
+                        for (int c = 0; c < 4; ++c) rotation[c] = L::select(violated, limited[c], rotation[c]);
+                    }
+                }
+
+                for (std::size_t child = joint + 1; child <= last; ++child) {
+                    V p[3], offset[3];
+                    load(child, p);
+                    for (int c = 0; c < 3; ++c) offset[c] = L::sub(p[c], pivot[c]);
+                    detail::rotateVectorLanes<L>(rotation, offset, offset, T(2));
+                    for (int c = 0; c < 3; ++c) p[c] = L::add(pivot[c], offset[c]);
+                    store(child, p);
+                }
+            }
+        }
+    }
+    return chainSettings.maxIterations;
+}
+
+template<typename T>
+void IkChainSolver<T>::boneRotations(const VectorArray<T, 3>& before, const VectorArray<T, 3>& after,
+                                     VectorArray<T, 4>& out) const {
+    if (before.size() != after.size() || before.size() % joints != 0) {
+        throw std::invalid_argument("IkChainSolver bone rotations need whole chains before and after");
+    }
+    const std::size_t chains = before.size() / joints;
+    out.resize(before.size());
+    for (std::size_t joint = 0; joint + 1 < joints; ++joint) {
+        detail::forEachLane<T>(0, chains, [&](auto lanes, std::size_t chain) {
+            using L = decltype(lanes);
+            using V = decltype(L::set(T(0)));
+            const T tiny = T(1e-12);
+            std::size_t i = joint * chains + chain;
+            V from[3], fromNext[3], to[3], toNext[3], rotation[4];
+            detail::loadVectorLanes<L>(before, i, from);
+            detail::loadVectorLanes<L>(before, i + chains, fromNext);
+            detail::loadVectorLanes<L>(after, i, to);
+            detail::loadVectorLanes<L>(after, i + chains, toNext);
+            for (int c = 0; c < 3; ++c) {
+                from[c] = L::sub(fromNext[c], from[c]);
+                to[c] = L::sub(toNext[c], to[c]);
+            }
+            detail::normalizeVectorLanes<L>(from, tiny);
+            detail::normalizeVectorLanes<L>(to, tiny);
+            detail::shortestArcLanes<L>(from, to, rotation, tiny);
+            for (std::size_t c = 0; c < 4; ++c) {
+                L::store(out.component(c) + i, rotation[c]);
+                if (joint + 2 == joints) L::store(out.component(c) + i + chains, rotation[c]);
+            }
+        });
+    }
+}
+
+#endif // INVERSEKINEMATICS_INL
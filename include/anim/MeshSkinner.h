@@ -0,0 +1,156 @@
+#ifndef MESHSKINNER_H
+#define MESHSKINNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../math/MatrixMxN.h"
+#include "../math/Quaternion.h"
+#include "../math/Vector3.h"
+#include "../math/VectorArray.h"
+#include "../render/GpuBufferWriter.h"
+
+/**
+ * @brief How MeshSkinner blends the joint transforms of a vertex.
+ */
+enum class SkinningMethod {
+    Linear,        ///< Linear blend skinning: the weighted sum of the skinning matrices.
+    DualQuaternion ///< Dual quaternion skinning: keeps volume at twisting joints; ignores scale and shear.
+};
+
+/**
+ * @brief The joint influences of a vertex stream.
+ *
+ * Influences are stored vertex by vertex: the joints and weights of vertex
+ * i are at [i * influences, (i + 1) * influences). Weights should sum to
+ * one; unused slots have weight zero and any valid joint.
+ *
+ * Every joint index must be less than the joint count of the skinner.
+ * skin() only checks this under RENDERFX_MATH_SANITIZE; check weights from
+ * untrusted sources once with MeshSkinner::validate().
+ */
+struct SkinWeights {
+    const std::uint16_t* joints = nullptr; ///< Palette index of every influence.
+    const float* weights = nullptr;        ///< Weight of every influence.
+    std::size_t influences = 4;            ///< Influences per vertex, 1 to 8.
+};
+
+/**
+ * @brief A rigid joint transform as a unit dual quaternion, each part as (x, y, z, w).
+ */
+struct alignas(16) SkinningDualQuaternion {
+    GpuVec4 real; ///< The rotation.
+    GpuVec4 dual; ///< Half the translation times the rotation.
+};
+
+/**
+ * @brief Skins vertex positions and normals on the CPU, e.g. for hitboxes or a software renderer.
+ *
+ * Takes the palette written by Skeleton::buildPalette(). Linear blend
+ * skinning sums the three rows of the influencing matrices with SSE,
+ * transposes the sum and transforms the vertex by its columns. Normals
+ * are transformed by the cofactor matrix of the blended 3x3 part, which is
+ * its inverse transpose up to scale, and renormalized; they stay
+ * perpendicular to the surface under non-uniform scale. Vertices are
+ * independent, so ranges of them are spread over a ThreadPool.
+ *
+ * Joint indices are checked against the palette size only when
+ * RENDERFX_MATH_SANITIZE is defined; see validate().
+ */
+class MeshSkinner {
+public:
+    /**
+     * @brief Creates a skinner for a palette.
+     *
+     * See setPalette().
+     *
+     * @param palette The skinning matrices.
+     * @param jointCount The number of matrices.
+     * @param method How joint transforms are blended.
+     * @throws std::invalid_argument If palette is null and jointCount is not zero.
+     */
+    MeshSkinner(const GpuAffine3x4* palette, std::size_t jointCount, SkinningMethod method = SkinningMethod::Linear);
+
+    /**
+     * @brief Sets the palette to skin with; call after each rebuild of the palette.
+     *
+     * The palette is referenced, not copied, for Linear. For DualQuaternion
+     * it is converted here into a buffer that is reused from call to call,
+     * so one skinner can be kept across frames.
+     *
+     * @param palette The skinning matrices.
+     * @param jointCount The number of matrices.
+     * @throws std::invalid_argument If palette is null and jointCount is not zero.
+     */
+    void setPalette(const GpuAffine3x4* palette, std::size_t jointCount);
+
+    /**
+     * @brief Checks the influences of a vertex stream against the palette.
+     *
+     * @param weights The influences.
+     * @param count The number of vertices.
+     * @throws std::invalid_argument If a pointer is null or weights.influences is out of range.
+     * @throws std::out_of_range If a joint index is not less than jointCount().
+     */
+    void validate(const SkinWeights& weights, std::size_t count) const;
+
+    SkinningMethod method() const noexcept { return blendMethod; }
+    std::size_t jointCount() const noexcept { return joints; }
+
+    /**
+     * @brief Skins vertices stored as arrays of Vector3.
+     *
+     * @param weights The influences of the vertices.
+     * @param positions The bind-pose positions.
+     * @param normals The bind-pose normals, or null.
+     * @param count The number of vertices.
+     * @param outPositions Receives the skinned positions; may be positions.
+     * @param outNormals Receives the skinned unit normals; ignored if normals is null, may be normals.
+     * @param pool Threads to spread the vertices over; the calling thread does all the work if null.
+     * @throws std::invalid_argument If a required pointer is null or weights.influences is out of range.
+     * @throws std::out_of_range If a joint index is not in the palette; checked under RENDERFX_MATH_SANITIZE only.
+     */
+    void skin(const SkinWeights& weights, const Vector3<float>* positions, const Vector3<float>* normals,
+              std::size_t count, Vector3<float>* outPositions, Vector3<float>* outNormals, ThreadPool* pool = nullptr) const;
+
+    /**
+     * @brief Skins vertices stored as component streams.
+     *
+     * @param weights The influences of the vertices.
+     * @param positions The bind-pose positions.
+     * @param normals The bind-pose normals, or null.
+     * @param outPositions Receives the skinned positions; resized to match. May be positions.
+     * @param outNormals Receives the skinned unit normals, or null; resized to match. May be normals.
+     * @param pool Threads to spread the vertices over; the calling thread does all the work if null.
+     * @throws std::invalid_argument If a required pointer is null or weights.influences is out of range.
+     * @throws std::out_of_range If a joint index is not in the palette; checked under RENDERFX_MATH_SANITIZE only.
+     */
+    void skin(const SkinWeights& weights, const VectorArray<float, 3>& positions, const VectorArray<float, 3>* normals,
+              VectorArray<float, 3>& outPositions, VectorArray<float, 3>* outNormals, ThreadPool* pool = nullptr) const;
+
+    /**
+     * @brief Converts skinning matrices to dual quaternions.
+     *
+     * Scale is removed from each matrix by normalizing its columns.
+     *
+     * @param palette The skinning matrices.
+     * @param count The number of matrices.
+     * @param out Receives count dual quaternions.
+     */
+    static void toDualQuaternions(const GpuAffine3x4* palette, std::size_t count, SkinningDualQuaternion* out);
+
+private:
+    const GpuAffine3x4* matrices;
+    std::size_t joints;
+    SkinningMethod blendMethod;
+    std::vector<SkinningDualQuaternion> dualQuaternions;
+
+    template<typename Vertices>
+    void run(const SkinWeights& weights, const Vertices& vertices, std::size_t count, ThreadPool* pool) const;
+};
+
+#include "MeshSkinner.inl"
+
+#endif // MESHSKINNER_H
@@ -0,0 +1,299 @@
+#ifndef MESHSKINNER_INL
+#define MESHSKINNER_INL
+
+#include <cmath>
+#include <stdexcept>
+#include "../math/FloatLanes.h"
+
+namespace detail {
+
+// Vertices as arrays of Vector3; outputs may alias inputs.
+struct AosSkinVertices {
+    const Vector3<float>* positions;
+    const Vector3<float>* normals;
+    Vector3<float>* outPositions;
+    Vector3<float>* outNormals;
+
+    void position(std::size_t i, float v[3]) const noexcept { v[0] = positions[i].x; v[1] = positions[i].y; v[2] = positions[i].z; }
+    void normal(std::size_t i, float v[3]) const noexcept { v[0] = normals[i].x; v[1] = normals[i].y; v[2] = normals[i].z; }
+    void setPosition(std::size_t i, const float v[3]) const noexcept { outPositions[i] = Vector3<float>(v[0], v[1], v[2]); }
+    void setNormal(std::size_t i, const float v[3]) const noexcept { outNormals[i] = Vector3<float>(v[0], v[1], v[2]); }
+    bool hasNormals() const noexcept { return normals != nullptr; }
+};
+
+// Vertices as component streams; outputs may alias inputs.
+struct SoaSkinVertices {
+    const float* positions[3];
+    const float* normals[3];
+    float* outPositions[3];
+    float* outNormals[3];
+
+    void position(std::size_t i, float v[3]) const noexcept { for (int c = 0; c < 3; ++c) v[c] = positions[c][i]; }
+    void normal(std::size_t i, float v[3]) const noexcept { for (int c = 0; c < 3; ++c) v[c] = normals[c][i]; }
+    void setPosition(std::size_t i, const float v[3]) const noexcept { for (int c = 0; c < 3; ++c) outPositions[c][i] = v[c]; }
+    void setNormal(std::size_t i, const float v[3]) const noexcept { for (int c = 0; c < 3; ++c) outNormals[c][i] = v[c]; }
+    bool hasNormals() const noexcept { return normals[0] != nullptr; }
+};
+
+inline void normalizeSkinnedNormal(float n[3]) noexcept {
+    float lengthSquared = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+    float inverseLength = lengthSquared > 0 ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+    for (int c = 0; c < 3; ++c) n[c] *= inverseLength;
+}
+
+// n' = n.x (c1 x c2) + n.y (c2 x c0) + n.z (c0 x c1): the normal times the
+// cofactor matrix of the columns c, i.e. det(M) M^-T n. Flipped when the
+// determinant is negative, so mirroring joints keep normals facing out.
+inline void transformSkinnedNormal(const float c0[3], const float c1[3], const float c2[3], const float n[3],
+                                   float out[3]) noexcept {
+    float x12[3] = { c1[1] * c2[2] - c1[2] * c2[1], c1[2] * c2[0] - c1[0] * c2[2], c1[0] * c2[1] - c1[1] * c2[0] };
+    float x20[3] = { c2[1] * c0[2] - c2[2] * c0[1], c2[2] * c0[0] - c2[0] * c0[2], c2[0] * c0[1] - c2[1] * c0[0] };
+    float x01[3] = { c0[1] * c1[2] - c0[2] * c1[1], c0[2] * c1[0] - c0[0] * c1[2], c0[0] * c1[1] - c0[1] * c1[0] };
+    float sign = c0[0] * x12[0] + c0[1] * x12[1] + c0[2] * x12[2] < 0 ? -1.0f : 1.0f;
+    for (int r = 0; r < 3; ++r) out[r] = sign * (n[0] * x12[r] + n[1] * x20[r] + n[2] * x01[r]);
+    normalizeSkinnedNormal(out);
+}
+
+#if RENDERFX_FLOAT_LANES >= 1
+inline __m128 crossColumns(__m128 a, __m128 b) noexcept {
+    __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 aZxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+    __m128 bZxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+    return _mm_sub_ps(_mm_mul_ps(aYzx, bZxy), _mm_mul_ps(aZxy, bYzx));
+}
+#endif
+
+template<std::size_t Influences, typename Vertices>
+void skinLinear(const GpuAffine3x4* palette, const SkinWeights& weights, const Vertices& vertices,
+                std::size_t first, std::size_t last) noexcept {
+    const bool normals = vertices.hasNormals();
+    for (std::size_t i = first; i < last; ++i) {
+        const std::uint16_t* joint = weights.joints + i * Influences;
+        const float* weight = weights.weights + i * Influences;
+        float p[3], n[3] = {};
+        vertices.position(i, p);
+        if (normals) vertices.normal(i, n);
+#if RENDERFX_FLOAT_LANES >= 1
+        // Sum of the weighted rows, transposed into the columns of the matrix.
+        __m128 rows[3];
+        for (int r = 0; r < 3; ++r) {
+            rows[r] = _mm_mul_ps(_mm_set1_ps(weight[0]), _mm_load_ps(&palette[joint[0]].rows[r].x));
+        }
+        for (std::size_t k = 1; k < Influences; ++k) {
+            __m128 w = _mm_set1_ps(weight[k]);
+            for (int r = 0; r < 3; ++r) {
+                rows[r] = _mm_add_ps(rows[r], _mm_mul_ps(w, _mm_load_ps(&palette[joint[k]].rows[r].x)));
+            }
+        }
+        __m128 c0 = rows[0], c1 = rows[1], c2 = rows[2], c3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        __m128 linear = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0]), c0), _mm_mul_ps(_mm_set1_ps(p[1]), c1)),
+                                   _mm_mul_ps(_mm_set1_ps(p[2]), c2));
+        float out[4];
+        _mm_storeu_ps(out, _mm_add_ps(linear, c3));
+        vertices.setPosition(i, out);
+        if (normals) {
+            // See transformSkinnedNormal(); the columns have zero w.
+            __m128 x12 = crossColumns(c1, c2);
+            __m128 normal = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), x12),
+                                                  _mm_mul_ps(_mm_set1_ps(n[1]), crossColumns(c2, c0))),
+                                       _mm_mul_ps(_mm_set1_ps(n[2]), crossColumns(c0, c1)));
+            float det[4];
+            _mm_storeu_ps(det, _mm_mul_ps(c0, x12));
+            if (det[0] + det[1] + det[2] < 0) normal = _mm_sub_ps(_mm_setzero_ps(), normal);
+            _mm_storeu_ps(out, normal);
+            normalizeSkinnedNormal(out);
+            vertices.setNormal(i, out);
+        }
+#else
+        float m[3][4] = {};
+        for (std::size_t k = 0; k < Influences; ++k) {
+            const GpuVec4* rows = palette[joint[k]].rows;
+            for (int r = 0; r < 3; ++r) {
+                m[r][0] += weight[k] * rows[r].x;
+                m[r][1] += weight[k] * rows[r].y;
+                m[r][2] += weight[k] * rows[r].z;
+                m[r][3] += weight[k] * rows[r].w;
+            }
+        }
+        float out[3];
+        for (int r = 0; r < 3; ++r) out[r] = m[r][0] * p[0] + m[r][1] * p[1] + m[r][2] * p[2] + m[r][3];
+        vertices.setPosition(i, out);
+        if (normals) {
+            float columns[3][3];
+            for (int c = 0; c < 3; ++c) {
+                for (int r = 0; r < 3; ++r) columns[c][r] = m[r][c];
+            }
+            transformSkinnedNormal(columns[0], columns[1], columns[2], n, out);
+            vertices.setNormal(i, out);
+        }
+#endif
+    }
+}
+
+// v + 2 w (q x v) + 2 q x (q x v) for a unit quaternion (q, w).
+inline void rotateByQuaternion(const float q[4], const float v[3], float out[3]) noexcept {
+    float t[3] = { 2 * (q[1] * v[2] - q[2] * v[1]), 2 * (q[2] * v[0] - q[0] * v[2]), 2 * (q[0] * v[1] - q[1] * v[0]) };
+    out[0] = v[0] + q[3] * t[0] + (q[1] * t[2] - q[2] * t[1]);
+    out[1] = v[1] + q[3] * t[1] + (q[2] * t[0] - q[0] * t[2]);
+    out[2] = v[2] + q[3] * t[2] + (q[0] * t[1] - q[1] * t[0]);
+}
+
+template<std::size_t Influences, typename Vertices>
+void skinDualQuaternion(const SkinningDualQuaternion* palette, const SkinWeights& weights, const Vertices& vertices,
+                        std::size_t first, std::size_t last) noexcept {
+    const bool normals = vertices.hasNormals();
+    for (std::size_t i = first; i < last; ++i) {
+        const std::uint16_t* joint = weights.joints + i * Influences;
+        const float* weight = weights.weights + i * Influences;
+        const SkinningDualQuaternion& pivot = palette[joint[0]];
+        float real[4] = {}, dual[4] = {};
+        for (std::size_t k = 0; k < Influences; ++k) {
+            const SkinningDualQuaternion& dq = palette[joint[k]];
+            // Blend along the shorter arc from the first influence.
+            float dot = pivot.real.x * dq.real.x + pivot.real.y * dq.real.y + pivot.real.z * dq.real.z + pivot.real.w * dq.real.w;
+            float w = dot < 0 ? -weight[k] : weight[k];
+            real[0] += w * dq.real.x; real[1] += w * dq.real.y; real[2] += w * dq.real.z; real[3] += w * dq.real.w;
+            dual[0] += w * dq.dual.x; dual[1] += w * dq.dual.y; dual[2] += w * dq.dual.z; dual[3] += w * dq.dual.w;
+        }
+        float lengthSquared = real[0] * real[0] + real[1] * real[1] + real[2] * real[2] + real[3] * real[3];
+        float inverseLength = lengthSquared > 0 ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            real[c] *= inverseLength;
+            dual[c] *= inverseLength;
+        }
+        // Translation 2 (w_r d - w_d r + r x d) of the normalized dual quaternion.
+        float translation[3] = {
+            2 * (real[3] * dual[0] - dual[3] * real[0] + real[1] * dual[2] - real[2] * dual[1]),
+            2 * (real[3] * dual[1] - dual[3] * real[1] + real[2] * dual[0] - real[0] * dual[2]),
+            2 * (real[3] * dual[2] - dual[3] * real[2] + real[0] * dual[1] - real[1] * dual[0])
+        };
+        float v[3], out[3];
+        vertices.position(i, v);
+        rotateByQuaternion(real, v, out);
+        for (int c = 0; c < 3; ++c) out[c] += translation[c];
+        vertices.setPosition(i, out);
+        if (normals) {
+            vertices.normal(i, v);
+            rotateByQuaternion(real, v, out);
+            vertices.setNormal(i, out);
+        }
+    }
+}
+
+template<typename Kernel>
+inline void dispatchInfluences(std::size_t influences, Kernel&& kernel) {
+    switch (influences) {
+        case 1: kernel(std::integral_constant<std::size_t, 1>()); break;
+        case 2: kernel(std::integral_constant<std::size_t, 2>()); break;
+        case 3: kernel(std::integral_constant<std::size_t, 3>()); break;
+        case 4: kernel(std::integral_constant<std::size_t, 4>()); break;
+        case 5: kernel(std::integral_constant<std::size_t, 5>()); break;
+        case 6: kernel(std::integral_constant<std::size_t, 6>()); break;
+        case 7: kernel(std::integral_constant<std::size_t, 7>()); break;
+        default: kernel(std::integral_constant<std::size_t, 8>()); break;
+    }
+}
+
+} // namespace detail
+
+inline MeshSkinner::MeshSkinner(const GpuAffine3x4* palette, std::size_t jointCount, SkinningMethod method)
+    : matrices(nullptr), joints(0), blendMethod(method) {
+    setPalette(palette, jointCount);
+}
+
+inline void MeshSkinner::setPalette(const GpuAffine3x4* palette, std::size_t jointCount) {
+    if (!palette && jointCount != 0) throw std::invalid_argument("MeshSkinner needs a palette");
+    matrices = palette;
+    joints = jointCount;
+    if (blendMethod == SkinningMethod::DualQuaternion) {
+        dualQuaternions.resize(jointCount);
+        toDualQuaternions(palette, jointCount, dualQuaternions.data());
+    }
+}
+
+inline void MeshSkinner::validate(const SkinWeights& weights, std::size_t count) const {
+    if (count == 0) return;
+    if (!weights.joints || !weights.weights) throw std::invalid_argument("MeshSkinner weights are missing");
+    if (weights.influences < 1 || weights.influences > 8) {
+        throw std::invalid_argument("MeshSkinner supports 1 to 8 influences per vertex");
+    }
+    for (std::size_t i = 0; i < count * weights.influences; ++i) {
+        if (weights.joints[i] >= joints) throw std::out_of_range("MeshSkinner joint index out of range");
+    }
+}
+
+inline void MeshSkinner::toDualQuaternions(const GpuAffine3x4* palette, std::size_t count, SkinningDualQuaternion* out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const GpuVec4* rows = palette[i].rows;
+        Matrix3x3<float> rotation;
+        for (int c = 0; c < 3; ++c) {
+            float column[3] = { (&rows[0].x)[c], (&rows[1].x)[c], (&rows[2].x)[c] };
+            float length = std::sqrt(column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+            float inverse = length > 0 ? 1.0f / length : 0.0f;
+            for (int r = 0; r < 3; ++r) rotation.data[r][c] = column[r] * inverse;
+        }
+        Quaternion<float> q = rotation.toQuaternion();
+        // dual = 0.5 * (t, 0) * q
+        float tx = rows[0].w, ty = rows[1].w, tz = rows[2].w;
+        out[i].real = GpuVec4{ q.x, q.y, q.z, q.w };
+        out[i].dual = GpuVec4{ 0.5f * (tx * q.w + ty * q.z - tz * q.y), 0.5f * (-tx * q.z + ty * q.w + tz * q.x),
+                               0.5f * (tx * q.y - ty * q.x + tz * q.w), -0.5f * (tx * q.x + ty * q.y + tz * q.z) };
+    }
+}
+
+template<typename Vertices>
+void MeshSkinner::run(const SkinWeights& weights, const Vertices& vertices, std::size_t count, ThreadPool* pool) const {
+    if (count == 0) return;
+#if defined(RENDERFX_MATH_SANITIZE)
+    validate(weights, count);
+#else
+    if (!weights.joints || !weights.weights) throw std::invalid_argument("MeshSkinner weights are missing");
+    if (weights.influences < 1 || weights.influences > 8) {
+        throw std::invalid_argument("MeshSkinner supports 1 to 8 influences per vertex");
+    }
+#endif
+    auto range = [&](std::size_t first, std::size_t last) {
+        detail::dispatchInfluences(weights.influences, [&](auto influences) {
+            if (blendMethod == SkinningMethod::DualQuaternion) {
+                detail::skinDualQuaternion<decltype(influences)::value>(dualQuaternions.data(), weights, vertices, first, last);
+            } else {
+                detail::skinLinear<decltype(influences)::value>(matrices, weights, vertices, first, last);
+            }
+        });
+    };
+    if (pool) {
+        pool->parallelFor(0, count, 4096, range);
+    } else {
+        range(0, count);
+    }
+}
+
+inline void MeshSkinner::skin(const SkinWeights& weights, const Vector3<float>* positions, const Vector3<float>* normals,
+                              std::size_t count, Vector3<float>* outPositions, Vector3<float>* outNormals,
+                              ThreadPool* pool) const {
+    if (count != 0 && (!positions || !outPositions || (normals && !outNormals))) {
+        throw std::invalid_argument("MeshSkinner vertex streams are missing");
+    }
+    run(weights, detail::AosSkinVertices{ positions, normals, outPositions, outNormals }, count, pool);
+}
+
+inline void MeshSkinner::skin(const SkinWeights& weights, const VectorArray<float, 3>& positions,
+                              const VectorArray<float, 3>* normals, VectorArray<float, 3>& outPositions,
+                              VectorArray<float, 3>* outNormals, ThreadPool* pool) const {
+    if (normals && !outNormals) throw std::invalid_argument("MeshSkinner normal output is missing");
+    if (normals && normals->size() != positions.size()) throw std::invalid_argument("MeshSkinner normal count differs");
+    outPositions.resize(positions.size());
+    if (normals) outNormals->resize(positions.size());
+    detail::SoaSkinVertices vertices = {};
+    for (std::size_t c = 0; c < 3; ++c) {
+        vertices.positions[c] = positions.component(c);
+        vertices.outPositions[c] = outPositions.component(c);
+        vertices.normals[c] = normals ? normals->component(c) : nullptr;
+        vertices.outNormals[c] = normals ? outNormals->component(c) : nullptr;
+    }
+    run(weights, vertices, positions.size(), pool);
+}
+
+#endif // MESHSKINNER_INL
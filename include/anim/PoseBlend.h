@@ -0,0 +1,134 @@
+#ifndef POSEBLEND_H
+#define POSEBLEND_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../scene/TransformSoA.h"
+
+/**
+ * @brief How a PoseLayer contributes to the blended pose.
+ */
+enum class PoseLayerMode {
+    Weighted, ///< Averaged with the other weighted layers by normalized weight; together they form the base pose.
+    Override, ///< Blended over the result so far by its weight, like Transform::interpolate().
+    Additive  ///< A difference pose from makeAdditive(), scaled by its weight and applied on top.
+};
+
+/**
+ * @brief One pose taking part in a blend.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+struct PoseLayer {
+    const TransformSoA<T>* pose = nullptr;      ///< Local joint transforms, e.g. a sampled clip shared by many characters.
+    std::size_t offset = 0;                     ///< Index of the first joint in pose.
+    T weight = 1;                               ///< Weight of the layer.
+    const T* mask = nullptr;                    ///< Per-joint factors on weight, one per joint, or null for all ones.
+    PoseLayerMode mode = PoseLayerMode::Weighted;
+};
+
+/**
+ * @brief The layers and destination of one character.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+struct PoseBlendJob {
+    const PoseLayer<T>* layers = nullptr; ///< The layers, see PoseBlender::blend().
+    std::size_t layerCount = 0;           ///< Number of layers.
+    TransformSoA<T>* output = nullptr;    ///< Receives the local joint transforms.
+    std::size_t offset = 0;               ///< Index of the first joint in output.
+};
+
+/**
+ * @brief Blends skeletal poses stored as SoA joint arrays.
+ *
+ * A pose is a run of jointCount consecutive transforms in a TransformSoA,
+ * so one array can hold the poses of a whole crowd. Blending runs over the
+ * joints of a layer at a time with SIMD lanes (see FloatLanes.h); rotations
+ * are combined with nlerp, never slerp, which is accurate enough for the
+ * small angles between poses of related animations.
+ *
+ * Weighted layers are combined first into the base pose: a weighted average
+ * whose weights, after the per-joint masks, are normalized per joint; joints
+ * with no weight at all get the identity. Override and Additive layers are
+ * then applied in list order.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+class PoseBlender {
+public:
+    static_assert(std::is_floating_point<T>::value, "PoseBlender requires a floating-point type");
+
+    /**
+     * @brief Creates a blender for skeletons with a given number of joints.
+     *
+     * @param jointCount The number of joints per pose.
+     * @throws std::invalid_argument If jointCount is zero.
+     */
+    explicit PoseBlender(std::size_t jointCount);
+
+    std::size_t jointCount() const noexcept { return joints; }
+
+    /**
+     * @brief Blends the layers of one character.
+     *
+     * @param layers The layers.
+     * @param layerCount The number of layers.
+     * @param output Receives the local joint transforms; may be the pose of a layer only if it is the first.
+     * @param offset Index of the first joint in output.
+     * @throws std::invalid_argument If a layer pose is missing or the poses are too short.
+     */
+    void blend(const PoseLayer<T>* layers, std::size_t layerCount, TransformSoA<T>& output, std::size_t offset = 0);
+
+    /**
+     * @brief Blends many characters, spread over a ThreadPool.
+     *
+     * The results do not depend on the number of threads.
+     *
+     * @param jobs One job per character; their outputs must not overlap.
+     * @param jobCount The number of jobs.
+     * @param pool Threads to spread the characters over; the calling thread does all the work if null.
+     * @throws std::invalid_argument If any job is invalid; nothing is blended then.
+     */
+    void blend(const PoseBlendJob<T>* jobs, std::size_t jobCount, ThreadPool* pool = nullptr) const;
+
+    /**
+     * @brief Computes the difference pose of an additive layer.
+     *
+     * The result adds the translation, rotates by the rotation (in the
+     * joint's local frame) and multiplies by the scale that turns reference
+     * into pose, so an Additive layer of weight 1 applied to reference gives
+     * pose again.
+     *
+     * @param pose The poses to convert.
+     * @param reference The reference poses, usually the first frame or the bind pose.
+     * @param out Receives the differences; must hold at least last elements and may alias pose.
+     * @param first The first joint.
+     * @param last One past the last joint; at most the size of pose and reference.
+     */
+    static void makeAdditive(const TransformSoA<T>& pose, const TransformSoA<T>& reference, TransformSoA<T>& out,
+                             std::size_t first, std::size_t last);
+
+private:
+    std::size_t joints;
+    std::vector<T> weightSums;
+
+    void validate(const PoseLayer<T>* layers, std::size_t layerCount, const TransformSoA<T>* output,
+                  std::size_t offset) const;
+    void blendCharacter(const PoseLayer<T>* layers, std::size_t layerCount, TransformSoA<T>& output,
+                        std::size_t offset, T* sums) const;
+};
+
+// Commonly used types
+using PoseLayerf = PoseLayer<float>;
+using PoseBlendJobf = PoseBlendJob<float>;
+using PoseBlenderf = PoseBlender<float>;
+
+#include "PoseBlend.inl"
+
+#endif // POSEBLEND_H
@@ -0,0 +1,249 @@
+#ifndef POSEBLEND_INL
+#define POSEBLEND_INL
+
+#include <stdexcept>
+#include "../math/FloatLanes.h"
+
+namespace detail {
+
+// Pointers to the component streams of a run of joints.
+template<typename T, typename Pose>
+struct PoseStreams {
+    T* p[3];
+    T* r[4];
+    T* s[3];
+
+    PoseStreams(Pose& pose, std::size_t offset) noexcept {
+        for (std::size_t c = 0; c < 3; ++c) {
+            p[c] = pose.positions.component(c) + offset;
+            s[c] = pose.scales.component(c) + offset;
+        }
+        for (std::size_t c = 0; c < 4; ++c) r[c] = pose.rotations.component(c) + offset;
+    }
+};
+
+template<typename T>
+using ConstPoseStreams = PoseStreams<const T, const TransformSoA<T>>;
+
+template<typename T>
+using MutablePoseStreams = PoseStreams<T, TransformSoA<T>>;
+
+// Hamilton product of quaternions in (x, y, z, w) lanes.
+template<typename L, typename V>
+inline void multiplyQuaternionLanes(const V a[4], const V b[4], V out[4]) noexcept {
+    V x = L::add(L::add(L::mul(a[3], b[0]), L::mul(a[0], b[3])), L::sub(L::mul(a[1], b[2]), L::mul(a[2], b[1])));
+    V y = L::add(L::sub(L::mul(a[3], b[1]), L::mul(a[0], b[2])), L::add(L::mul(a[1], b[3]), L::mul(a[2], b[0])));
+    V z = L::add(L::add(L::mul(a[3], b[2]), L::mul(a[0], b[1])), L::sub(L::mul(a[2], b[3]), L::mul(a[1], b[0])));
+    V w = L::sub(L::sub(L::mul(a[3], b[3]), L::mul(a[0], b[0])), L::add(L::mul(a[1], b[1]), L::mul(a[2], b[2])));
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+    out[3] = w;
+}
+
+template<typename L, typename V>
+inline V dotQuaternionLanes(const V a[4], const V b[4]) noexcept {
+    return L::add(L::add(L::mul(a[0], b[0]), L::mul(a[1], b[1])), L::add(L::mul(a[2], b[2]), L::mul(a[3], b[3])));
+}
+
+// Normalizes quaternion lanes; zero-length ones become the identity.
+template<typename L, typename V, typename T>
+inline void normalizeQuaternionLanes(V q[4], T tiny) noexcept {
+    V lengthSquared = dotQuaternionLanes<L>(q, q);
+    auto valid = L::greater(lengthSquared, L::set(tiny));
+    V inverseLength = L::rsqrt(L::max(lengthSquared, L::set(tiny)));
+    for (int c = 0; c < 3; ++c) q[c] = L::select(valid, L::mul(q[c], inverseLength), L::set(T(0)));
+    q[3] = L::select(valid, L::mul(q[3], inverseLength), L::set(T(1)));
+}
+
+template<typename L, typename T>
+inline auto layerWeightLanes(const PoseLayer<T>& layer, std::size_t j) noexcept {
+    auto weight = L::set(layer.weight);
+    return layer.mask ? L::mul(weight, L::load(layer.mask + j)) : weight;
+}
+
+} // namespace detail
+
+template<typename T>
+PoseBlender<T>::PoseBlender(std::size_t jointCount) : joints(jointCount) {
+    if (jointCount == 0) throw std::invalid_argument("PoseBlender requires at least one joint");
+    weightSums.resize(jointCount);
+}
+
+template<typename T>
+void PoseBlender<T>::validate(const PoseLayer<T>* layers, std::size_t layerCount, const TransformSoA<T>* output,
+                              std::size_t offset) const {
+    if (layerCount != 0 && !layers) throw std::invalid_argument("PoseBlender layers are missing");
+    if (!output || offset > output->size() || output->size() - offset < joints) {
+        throw std::invalid_argument("PoseBlender output is too short for the skeleton");
+    }
+    for (std::size_t i = 0; i < layerCount; ++i) {
+        const PoseLayer<T>& layer = layers[i];
+        if (!layer.pose || layer.offset > layer.pose->size() || layer.pose->size() - layer.offset < joints) {
+            throw std::invalid_argument("PoseBlender layer pose is missing or too short for the skeleton");
+        }
+    }
+}
+
+template<typename T>
+void PoseBlender<T>::blend(const PoseLayer<T>* layers, std::size_t layerCount, TransformSoA<T>& output,
+                           std::size_t offset) {
+    validate(layers, layerCount, &output, offset);
+    blendCharacter(layers, layerCount, output, offset, weightSums.data());
+}
+
+template<typename T>
+void PoseBlender<T>::blend(const PoseBlendJob<T>* jobs, std::size_t jobCount, ThreadPool* pool) const {
+    if (jobCount != 0 && !jobs) throw std::invalid_argument("PoseBlender jobs are missing");
+    for (std::size_t i = 0; i < jobCount; ++i) validate(jobs[i].layers, jobs[i].layerCount, jobs[i].output, jobs[i].offset);
+
+    auto run = [&](std::size_t first, std::size_t last) {
+        std::vector<T> sums(joints);
+        for (std::size_t i = first; i < last; ++i) {
+            blendCharacter(jobs[i].layers, jobs[i].layerCount, *jobs[i].output, jobs[i].offset, sums.data());
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, jobCount, 16, run);
+    } else {
+        run(0, jobCount);
+    }
+}
+
+template<typename T>
+void PoseBlender<T>::blendCharacter(const PoseLayer<T>* layers, std::size_t layerCount, TransformSoA<T>& output,
+                                    std::size_t offset, T* sums) const {
+    const T tiny = T(1e-12);
+    detail::MutablePoseStreams<T> out(output, offset);
+
+    // The base pose: a weighted sum, with each rotation flipped to the
+    // hemisphere of the sum so far, then divided by the total weight.
+    bool any = false;
+    for (std::size_t l = 0; l < layerCount; ++l) {
+        const PoseLayer<T>& layer = layers[l];
+        if (layer.mode != PoseLayerMode::Weighted) continue;
+        detail::ConstPoseStreams<T> in(*layer.pose, layer.offset);
+        const bool first = !any;
+        any = true;
+        detail::forEachLane<T>(0, joints, [&](auto lanes, std::size_t j) {
+            using L = decltype(lanes);
+            auto w = detail::layerWeightLanes<L>(layer, j);
+            if (first) {
+                L::store(sums + j, w);
+                for (int c = 0; c < 3; ++c) {
+                    L::store(out.p[c] + j, L::mul(L::load(in.p[c] + j), w));
+                    L::store(out.s[c] + j, L::mul(L::load(in.s[c] + j), w));
+                }
+                for (int c = 0; c < 4; ++c) L::store(out.r[c] + j, L::mul(L::load(in.r[c] + j), w));
+                return;
+            }
+            L::store(sums + j, L::add(L::load(sums + j), w));
+            for (int c = 0; c < 3; ++c) {
+                L::store(out.p[c] + j, L::add(L::load(out.p[c] + j), L::mul(L::load(in.p[c] + j), w)));
+                L::store(out.s[c] + j, L::add(L::load(out.s[c] + j), L::mul(L::load(in.s[c] + j), w)));
+            }
+            decltype(w) a[4], b[4];
+            for (int c = 0; c < 4; ++c) {
+                a[c] = L::load(out.r[c] + j);
+                b[c] = L::load(in.r[c] + j);
+            }
+            auto signedWeight = L::signOf(detail::dotQuaternionLanes<L>(a, b), w);
+            for (int c = 0; c < 4; ++c) L::store(out.r[c] + j, L::add(a[c], L::mul(b[c], signedWeight)));
+        });
+    }
+
+    detail::forEachLane<T>(0, joints, [&](auto lanes, std::size_t j) {
+        using L = decltype(lanes);
+        using V = decltype(L::set(T(0)));
+        if (!any) {
+            for (int c = 0; c < 3; ++c) {
+                L::store(out.p[c] + j, L::set(T(0)));
+                L::store(out.s[c] + j, L::set(T(1)));
+            }
+            for (int c = 0; c < 4; ++c) L::store(out.r[c] + j, L::set(T(c == 3 ? 1 : 0)));
+            return;
+        }
+        V sum = L::load(sums + j);
+        auto weighted = L::greater(sum, L::set(tiny));
+        V inverseSum = L::div(L::set(T(1)), L::max(sum, L::set(tiny)));
+        for (int c = 0; c < 3; ++c) {
+            L::store(out.p[c] + j, L::select(weighted, L::mul(L::load(out.p[c] + j), inverseSum), L::set(T(0))));
+            L::store(out.s[c] + j, L::select(weighted, L::mul(L::load(out.s[c] + j), inverseSum), L::set(T(1))));
+        }
+        V q[4];
+        for (int c = 0; c < 4; ++c) q[c] = L::load(out.r[c] + j);
+        detail::normalizeQuaternionLanes<L>(q, tiny);
+        for (int c = 0; c < 4; ++c) L::store(out.r[c] + j, q[c]);
+    });
+
+    for (std::size_t l = 0; l < layerCount; ++l) {
+        const PoseLayer<T>& layer = layers[l];
+        if (layer.mode == PoseLayerMode::Weighted) continue;
+        detail::ConstPoseStreams<T> in(*layer.pose, layer.offset);
+        const bool additive = layer.mode == PoseLayerMode::Additive;
+        detail::forEachLane<T>(0, joints, [&](auto lanes, std::size_t j) {
+            using L = decltype(lanes);
+            using V = decltype(L::set(T(0)));
+            V w = detail::layerWeightLanes<L>(layer, j);
+            V a[4], b[4], q[4];
+            for (int c = 0; c < 4; ++c) {
+                a[c] = L::load(out.r[c] + j);
+                b[c] = L::load(in.r[c] + j);
+            }
+            if (additive) {
+                V one = L::set(T(1));
+                for (int c = 0; c < 3; ++c) {
+                    L::store(out.p[c] + j, L::add(L::load(out.p[c] + j), L::mul(L::load(in.p[c] + j), w)));
+                    V scale = L::add(one, L::mul(L::sub(L::load(in.s[c] + j), one), w));
+                    L::store(out.s[c] + j, L::mul(L::load(out.s[c] + j), scale));
+                }
+                // Scales the difference rotation by nlerp from the identity,
+                // taking the shorter arc, and applies it in the joint frame.
+                for (int c = 0; c < 3; ++c) b[c] = L::mul(L::signOf(b[3], b[c]), w);
+                b[3] = L::add(one, L::mul(L::sub(L::abs(b[3]), one), w));
+                detail::multiplyQuaternionLanes<L>(a, b, q);
+            } else {
+                for (int c = 0; c < 3; ++c) {
+                    V p = L::load(out.p[c] + j);
+                    V s = L::load(out.s[c] + j);
+                    L::store(out.p[c] + j, L::add(p, L::mul(L::sub(L::load(in.p[c] + j), p), w)));
+                    L::store(out.s[c] + j, L::add(s, L::mul(L::sub(L::load(in.s[c] + j), s), w)));
+                }
+                V wa = L::sub(L::set(T(1)), w);
+                V wb = L::signOf(detail::dotQuaternionLanes<L>(a, b), w);
+                for (int c = 0; c < 4; ++c) q[c] = L::add(L::mul(a[c], wa), L::mul(b[c], wb));
+            }
+            detail::normalizeQuaternionLanes<L>(q, tiny);
+            for (int c = 0; c < 4; ++c) L::store(out.r[c] + j, q[c]);
+        });
+    }
+    RENDERFX_CHECK_FINITE_BATCH("PoseBlender::blend", out.r[3], out.r[3] + joints);
+}
+
+template<typename T>
+void PoseBlender<T>::makeAdditive(const TransformSoA<T>& pose, const TransformSoA<T>& reference, TransformSoA<T>& out,
+                                  std::size_t first, std::size_t last) {
+    detail::ConstPoseStreams<T> a(reference, 0);
+    detail::ConstPoseStreams<T> b(pose, 0);
+    detail::MutablePoseStreams<T> result(out, 0);
+    detail::forEachLane<T>(first, last, [&](auto lanes, std::size_t i) {
+        using L = decltype(lanes);
+        using V = decltype(L::set(T(0)));
+        for (int c = 0; c < 3; ++c) {
+            L::store(result.p[c] + i, L::sub(L::load(b.p[c] + i), L::load(a.p[c] + i)));
+            L::store(result.s[c] + i, L::div(L::load(b.s[c] + i), L::load(a.s[c] + i)));
+        }
+        // conjugate(reference) * pose
+        V inverse[4], q[4], delta[4];
+        for (int c = 0; c < 4; ++c) {
+            V value = L::load(a.r[c] + i);
+            inverse[c] = c == 3 ? value : L::sub(L::set(T(0)), value);
+            q[c] = L::load(b.r[c] + i);
+        }
+        detail::multiplyQuaternionLanes<L>(inverse, q, delta);
+        for (int c = 0; c < 4; ++c) L::store(result.r[c] + i, delta[c]);
+    });
+    RENDERFX_CHECK_FINITE_BATCH("PoseBlender::makeAdditive", result.r[3] + first, result.r[3] + last);
+}
+
+#endif // POSEBLEND_INL
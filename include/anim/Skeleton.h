@@ -0,0 +1,121 @@
+#ifndef SKELETON_H
+#define SKELETON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../math/MatrixMxN.h"
+#include "../render/GpuBufferWriter.h"
+#include "../scene/TransformSoA.h"
+
+/**
+ * @brief One character's input and outputs for Skeleton::buildPalettes().
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+struct SkinningPaletteJob {
+    const TransformSoA<T>* locals = nullptr; ///< Local joint transforms, e.g. the output of PoseBlender.
+    std::size_t offset = 0;                  ///< Index of the first joint in locals.
+    GpuAffine3x4* palette = nullptr;         ///< Receives one skinning matrix per joint.
+    Matrix3x4<T>* model = nullptr;           ///< Receives the model-space joint transforms, or null if not needed.
+};
+
+/**
+ * @brief A joint hierarchy with its bind pose, turning local poses into skinning palettes.
+ *
+ * Joints are depth ordered: every parent comes before its children, so
+ * the model-space transforms are built in a single pass over the joints.
+ * Joint transforms are composed as affine 3x4 matrices, which supports
+ * non-uniform scale under rotated parents and costs less than a 4x4
+ * product. With float and SSE2 every matrix row is one register.
+ *
+ * The skinning matrix of a joint is its model-space transform times its
+ * inverse bind matrix; it is written as a GpuAffine3x4 (see
+ * GpuBufferWriter.h), so palettes go straight into mapped buffer memory.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+class Skeleton {
+public:
+    static_assert(std::is_floating_point<T>::value, "Skeleton requires a floating-point type");
+
+    static constexpr std::int32_t noParent = -1; ///< Parent of a root joint.
+
+    /**
+     * @brief Creates a skeleton.
+     *
+     * @param parents The parent of every joint, or noParent for roots.
+     * @param inverseBindMatrices The inverse of every joint's model-space bind transform.
+     * @throws std::invalid_argument If the arrays are empty, differ in size, or a parent does not come before its joint.
+     */
+    Skeleton(std::vector<std::int32_t> parents, std::vector<Matrix3x4<T>> inverseBindMatrices);
+
+    /**
+     * @brief Creates a skeleton whose inverse bind matrices come from a bind pose.
+     *
+     * @param parents The parent of every joint, or noParent for roots.
+     * @param bindPose The local joint transforms of the bind pose; its scales must not be zero.
+     * @throws std::invalid_argument If the parents are invalid or bindPose has another size.
+     */
+    static Skeleton fromBindPose(std::vector<std::int32_t> parents, const TransformSoA<T>& bindPose);
+
+    std::size_t jointCount() const noexcept { return parentIndices.size(); }
+    const std::vector<std::int32_t>& parents() const noexcept { return parentIndices; }
+    const std::vector<Matrix3x4<T>>& inverseBindMatrices() const noexcept { return inverseBinds; }
+
+    /**
+     * @brief Computes the model-space transforms of a pose.
+     *
+     * @param locals The local joint transforms.
+     * @param offset Index of the first joint in locals.
+     * @param model Receives jointCount() transforms.
+     * @throws std::invalid_argument If locals is too short.
+     */
+    void localToModel(const TransformSoA<T>& locals, std::size_t offset, Matrix3x4<T>* model) const;
+
+    /**
+     * @brief Computes the model-space transforms and the skinning palette of a pose.
+     *
+     * @param locals The local joint transforms.
+     * @param offset Index of the first joint in locals.
+     * @param model Receives jointCount() model-space transforms; also needed as scratch.
+     * @param palette Receives jointCount() skinning matrices.
+     * @param streaming Whether to write the palette with non-temporal stores, for mapped
+     *        memory that the CPU does not read back; ignored where unavailable.
+     * @throws std::invalid_argument If locals is too short.
+     */
+    void buildPalette(const TransformSoA<T>& locals, std::size_t offset, Matrix3x4<T>* model, GpuAffine3x4* palette,
+                      bool streaming = false) const;
+
+    /**
+     * @brief Builds the palettes of many characters, spread over a ThreadPool.
+     *
+     * @param jobs One job per character; palettes and model outputs must not overlap.
+     * @param jobCount The number of jobs.
+     * @param pool Threads to spread the characters over; the calling thread does all the work if null.
+     * @param streaming See buildPalette().
+     * @throws std::invalid_argument If any job is invalid; nothing is built then.
+     */
+    void buildPalettes(const SkinningPaletteJob<T>* jobs, std::size_t jobCount, ThreadPool* pool = nullptr,
+                       bool streaming = false) const;
+
+private:
+    std::vector<std::int32_t> parentIndices;
+    std::vector<Matrix3x4<T>> inverseBinds;
+
+    void validate(const TransformSoA<T>* locals, std::size_t offset) const;
+    void compose(const TransformSoA<T>& locals, std::size_t offset, Matrix3x4<T>* model, GpuAffine3x4* palette,
+                 bool streaming) const;
+};
+
+// Commonly used types
+using SkinningPaletteJobf = SkinningPaletteJob<float>;
+using Skeletonf = Skeleton<float>;
+
+#include "Skeleton.inl"
+
+#endif // SKELETON_H
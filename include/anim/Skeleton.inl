@@ -0,0 +1,228 @@
+#ifndef SKELETON_INL
+#define SKELETON_INL
+
+#include <stdexcept>
+#include <utility>
+#include "../math/FloatLanes.h"
+
+namespace detail {
+
+// Stores the affine matrices of the lanes starting at i, given as columns
+// 0 to 2 of the linear part and the translation, one vector per element.
+template<typename T>
+inline void storeAffineLanes(ScalarLanes, const T (&m)[3][4], Matrix3x4<T>* out) noexcept {
+    for (std::size_t r = 0; r < 3; ++r)
+        for (std::size_t c = 0; c < 4; ++c) out->data[r][c] = m[r][c];
+}
+
+#if RENDERFX_FLOAT_LANES >= 1
+inline void storeAffineLanes(Sse2Lanes, const __m128 (&m)[3][4], Matrix3x4<float>* out) noexcept {
+    for (std::size_t r = 0; r < 3; ++r) {
+        __m128 c0 = m[r][0], c1 = m[r][1], c2 = m[r][2], c3 = m[r][3];
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(out[0].data[r].data(), c0);
+        _mm_storeu_ps(out[1].data[r].data(), c1);
+        _mm_storeu_ps(out[2].data[r].data(), c2);
+        _mm_storeu_ps(out[3].data[r].data(), c3);
+    }
+}
+#endif
+
+#if RENDERFX_FLOAT_LANES >= 2
+inline void storeAffineLanes(AvxLanes, const __m256 (&m)[3][4], Matrix3x4<float>* out) noexcept {
+    __m128 low[3][4], high[3][4];
+    for (std::size_t r = 0; r < 3; ++r) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            low[r][c] = _mm256_castps256_ps128(m[r][c]);
+            high[r][c] = _mm256_extractf128_ps(m[r][c], 1);
+        }
+    }
+    storeAffineLanes(Sse2Lanes(), low, out);
+    storeAffineLanes(Sse2Lanes(), high, out + 4);
+}
+#endif
+
+// Converts local joint transforms to affine matrices translation * rotation * scale.
+template<typename T>
+inline void localAffineMatrices(const TransformSoA<T>& locals, std::size_t offset, std::size_t count,
+                                Matrix3x4<T>* out) noexcept {
+    forEachLane<T>(0, count, [&](auto lanes, std::size_t j) {
+        using L = decltype(lanes);
+        using V = decltype(L::set(T(0)));
+        std::size_t i = offset + j;
+        V x = L::load(locals.rotations.component(0) + i), y = L::load(locals.rotations.component(1) + i);
+        V z = L::load(locals.rotations.component(2) + i), w = L::load(locals.rotations.component(3) + i);
+        V two = L::set(T(2)), one = L::set(T(1));
+        V x2 = L::mul(x, two), y2 = L::mul(y, two), z2 = L::mul(z, two);
+        V xx = L::mul(x, x2), yy = L::mul(y, y2), zz = L::mul(z, z2);
+        V xy = L::mul(x, y2), xz = L::mul(x, z2), yz = L::mul(y, z2);
+        V wx = L::mul(w, x2), wy = L::mul(w, y2), wz = L::mul(w, z2);
+        V sx = L::load(locals.scales.component(0) + i);
+        V sy = L::load(locals.scales.component(1) + i);
+        V sz = L::load(locals.scales.component(2) + i);
+        V m[3][4] = {
+            { L::mul(L::sub(one, L::add(yy, zz)), sx), L::mul(L::sub(xy, wz), sy), L::mul(L::add(xz, wy), sz),
+              L::load(locals.positions.component(0) + i) },
+            { L::mul(L::add(xy, wz), sx), L::mul(L::sub(one, L::add(xx, zz)), sy), L::mul(L::sub(yz, wx), sz),
+              L::load(locals.positions.component(1) + i) },
+            { L::mul(L::sub(xz, wy), sx), L::mul(L::add(yz, wx), sy), L::mul(L::sub(one, L::add(xx, yy)), sz),
+              L::load(locals.positions.component(2) + i) }
+        };
+        storeAffineLanes(lanes, m, out + j);
+    });
+}
+
+#if RENDERFX_FLOAT_LANES >= 1
+// Row of a * b for affine 3x4 matrices: a's row times b's rows, plus a's translation.
+inline __m128 affineRow(__m128 a, const __m128 b[3]) noexcept {
+    const __m128 translation = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+    __m128 row = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b[0]);
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b[1]));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b[2]));
+    return _mm_add_ps(row, _mm_and_ps(a, translation));
+}
+#endif
+
+} // namespace detail
+
+template<typename T>
+Skeleton<T>::Skeleton(std::vector<std::int32_t> parents, std::vector<Matrix3x4<T>> inverseBindMatrices)
+    : parentIndices(std::move(parents)), inverseBinds(std::move(inverseBindMatrices)) {
+    if (parentIndices.empty()) throw std::invalid_argument("Skeleton requires at least one joint");
+    if (parentIndices.size() != inverseBinds.size()) {
+        throw std::invalid_argument("Skeleton needs one inverse bind matrix per joint");
+    }
+    for (std::size_t i = 0; i < parentIndices.size(); ++i) {
+        std::int32_t parent = parentIndices[i];
+        if (parent != noParent && (parent < 0 || static_cast<std::size_t>(parent) >= i)) {
+            throw std::invalid_argument("Skeleton joints must come after their parents");
+        }
+    }
+}
+
+template<typename T>
+Skeleton<T> Skeleton<T>::fromBindPose(std::vector<std::int32_t> parents, const TransformSoA<T>& bindPose) {
+    if (bindPose.size() != parents.size()) throw std::invalid_argument("Skeleton bind pose needs one transform per joint");
+    Skeleton skeleton(std::move(parents), std::vector<Matrix3x4<T>>(bindPose.size()));
+    std::vector<Matrix3x4<T>> model(bindPose.size());
+    skeleton.localToModel(bindPose, 0, model.data());
+    for (std::size_t i = 0; i < model.size(); ++i) {
+        Matrix3x3<T> linear;
+        for (std::size_t r = 0; r < 3; ++r)
+            for (std::size_t c = 0; c < 3; ++c) linear.data[r][c] = model[i].data[r][c];
+        Matrix3x3<T> inverse = linear.inverse();
+        Vector3<T> translation(model[i].data[0][3], model[i].data[1][3], model[i].data[2][3]);
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 3; ++c) skeleton.inverseBinds[i].data[r][c] = inverse.data[r][c];
+            skeleton.inverseBinds[i].data[r][3] = -(inverse.data[r][0] * translation.x + inverse.data[r][1] * translation.y +
+                                                    inverse.data[r][2] * translation.z);
+        }
+    }
+    return skeleton;
+}
+
+template<typename T>
+void Skeleton<T>::validate(const TransformSoA<T>* locals, std::size_t offset) const {
+    if (!locals || offset > locals->size() || locals->size() - offset < jointCount()) {
+        throw std::invalid_argument("Skeleton pose is missing or too short for the skeleton");
+    }
+}
+
+template<typename T>
+void Skeleton<T>::localToModel(const TransformSoA<T>& locals, std::size_t offset, Matrix3x4<T>* model) const {
+    validate(&locals, offset);
+    compose(locals, offset, model, nullptr, false);
+}
+
+template<typename T>
+void Skeleton<T>::buildPalette(const TransformSoA<T>& locals, std::size_t offset, Matrix3x4<T>* model,
+                               GpuAffine3x4* palette, bool streaming) const {
+    validate(&locals, offset);
+    compose(locals, offset, model, palette, streaming);
+}
+
+template<typename T>
+void Skeleton<T>::buildPalettes(const SkinningPaletteJob<T>* jobs, std::size_t jobCount, ThreadPool* pool,
+                                bool streaming) const {
+    if (jobCount != 0 && !jobs) throw std::invalid_argument("Skeleton palette jobs are missing");
+    for (std::size_t i = 0; i < jobCount; ++i) {
+        validate(jobs[i].locals, jobs[i].offset);
+        if (!jobs[i].palette) throw std::invalid_argument("Skeleton palette job has no palette");
+    }
+
+    auto run = [&](std::size_t first, std::size_t last) {
+        std::vector<Matrix3x4<T>> scratch;
+        for (std::size_t i = first; i < last; ++i) {
+            Matrix3x4<T>* model = jobs[i].model;
+            if (!model) {
+                scratch.resize(jointCount());
+                model = scratch.data();
+            }
+            compose(*jobs[i].locals, jobs[i].offset, model, jobs[i].palette, streaming);
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, jobCount, 16, run);
+    } else {
+        run(0, jobCount);
+    }
+}
+
+template<typename T>
+void Skeleton<T>::compose(const TransformSoA<T>& locals, std::size_t offset, Matrix3x4<T>* model,
+                          GpuAffine3x4* palette, bool streaming) const {
+    static_assert(sizeof(Matrix3x4<T>) == 12 * sizeof(T), "Matrix3x4 must be tightly packed");
+    const std::size_t count = jointCount();
+    streaming = streaming && RENDERFX_HAS_STREAMING_STORES && palette &&
+                (reinterpret_cast<std::uintptr_t>(palette) & 15) == 0;
+    detail::localAffineMatrices(locals, offset, count, model);
+
+#if RENDERFX_FLOAT_LANES >= 1
+    if constexpr (std::is_same<T, float>::value) {
+        for (std::size_t j = 0; j < count; ++j) {
+            // model[j] holds the local transform; its parent is final already.
+            __m128 current[3];
+            for (int r = 0; r < 3; ++r) current[r] = _mm_loadu_ps(model[j].data[r].data());
+            std::int32_t parent = parentIndices[j];
+            if (parent != noParent) {
+                __m128 local[3] = { current[0], current[1], current[2] };
+                for (int r = 0; r < 3; ++r) current[r] = detail::affineRow(_mm_loadu_ps(model[parent].data[r].data()), local);
+            }
+            for (int r = 0; r < 3; ++r) _mm_storeu_ps(model[j].data[r].data(), current[r]);
+            if (!palette) continue;
+
+            __m128 inverseBind[3];
+            for (int r = 0; r < 3; ++r) inverseBind[r] = _mm_loadu_ps(inverseBinds[j].data[r].data());
+            for (int r = 0; r < 3; ++r) {
+                __m128 row = detail::affineRow(current[r], inverseBind);
+                float* destination = &palette[j].rows[r].x;
+#if RENDERFX_HAS_STREAMING_STORES
+                if (streaming) {
+                    _mm_stream_ps(destination, row);
+                    continue;
+                }
+#endif
+                _mm_storeu_ps(destination, row);
+            }
+        }
+        detail::finishStreaming(streaming);
+        RENDERFX_CHECK_FINITE_BATCH("Skeleton::localToModel", &model[0].data[0][0], &model[0].data[0][0] + 12 * count);
+        return;
+    }
+#endif
+
+    for (std::size_t j = 0; j < count; ++j) {
+        std::int32_t parent = parentIndices[j];
+        if (parent != noParent) model[j] = model[parent].multiplyAffine(model[j]);
+        if (!palette) continue;
+
+        GpuAffine3x4 skinning = GpuAffine3x4::from(model[j].multiplyAffine(inverseBinds[j]));
+        for (std::size_t r = 0; r < 3; ++r) {
+            detail::storeVec4(reinterpret_cast<unsigned char*>(&palette[j].rows[r]), skinning.rows[r], streaming);
+        }
+    }
+    detail::finishStreaming(streaming);
+    RENDERFX_CHECK_FINITE_BATCH("Skeleton::localToModel", &model[0].data[0][0], &model[0].data[0][0] + 12 * count);
+}
+
+#endif // SKELETON_INL
@@ -0,0 +1,152 @@
+#ifndef ACCURACYHARNESS_H
+#define ACCURACYHARNESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../math/Fixed.h"
+#include "../math/Geometry.h"
+
+/**
+ * @brief Computes the error of a value in units in the last place of T.
+ *
+ * The ULP size is taken at the magnitude of `scale`, so components of a
+ * vector are measured against the precision of its largest component
+ * rather than exploding for components that are close to zero.
+ *
+ * @tparam T The floating-point type whose ULP is used.
+ * @param value The value under test.
+ * @param reference The high-precision reference value.
+ * @param scale The magnitude at which the ULP is measured.
+ * @return The error in ULPs, or infinity if the value is not finite.
+ */
+template<typename T>
+long double ulpError(long double value, long double reference, long double scale);
+
+/**
+ * @brief Error statistics of one variant of one operation.
+ */
+struct AccuracyResult {
+    std::string operation;          ///< The operation, e.g. "Quaternion::slerp".
+    std::string variant;            ///< The variant name, e.g. "scalar".
+    std::size_t samples = 0;        ///< Inputs the reference was defined for.
+    std::size_t exceptions = 0;     ///< Inputs for which the variant threw but the reference did not.
+    std::size_t nonFinite = 0;      ///< Inputs for which the variant produced NaN or infinity.
+    long double maxUlp = 0;         ///< Largest error in ULPs.
+    long double meanUlp = 0;        ///< Mean error in ULPs.
+    long double maxAngular = 0;     ///< Largest angular error in radians, for directions and rotations.
+    long double meanAngular = 0;    ///< Mean angular error in radians.
+    std::string worstInput;         ///< Description of the input that produced maxUlp.
+};
+
+/**
+ * @brief Differential accuracy harness for alternative math code paths.
+ *
+ * Every registered variant is run on the same randomized and edge-case
+ * inputs (denormals, zero-length and antiparallel vectors, antiparallel
+ * and nearly identical quaternions, near-singular matrices) and compared
+ * against a `long double` reference. Slerp is referenced in closed form,
+ * as a rotation by a fraction of the axis and angle between the inputs,
+ * and the inverse by Gauss-Jordan elimination, so neither shares its
+ * algorithm with the code under test. Fast paths can be enabled in
+ * production once their reported error is acceptable.
+ *
+ * @tparam T The scalar type of the variants under test.
+ */
+template<typename T>
+class AccuracyHarness {
+public:
+    using VectorUnary = std::function<Vector3<T>(const Vector3<T>&)>;
+    using VectorSlerp = std::function<Vector3<T>(const Vector3<T>&, const Vector3<T>&, T)>;
+    using QuaternionUnary = std::function<Quaternion<T>(const Quaternion<T>&)>;
+    using QuaternionSlerp = std::function<Quaternion<T>(const Quaternion<T>&, const Quaternion<T>&, T)>;
+    using QuaternionToMatrix = std::function<Matrix4x4<T>(const Quaternion<T>&)>;
+    using MatrixUnary = std::function<Matrix4x4<T>(const Matrix4x4<T>&)>;
+    using MatrixBinary = std::function<Matrix4x4<T>(const Matrix4x4<T>&, const Matrix4x4<T>&)>;
+
+    /**
+     * @brief Creates a harness and generates its inputs.
+     *
+     * @param randomSamples Number of random inputs per operation, in addition to the edge cases.
+     * @param seed The random seed.
+     */
+    explicit AccuracyHarness(std::size_t randomSamples = 10000, std::uint32_t seed = 1);
+
+    /// @name Variant Registration
+    /// @{
+    void addVectorNormalize(const std::string& name, VectorUnary fn);
+    void addVectorSlerp(const std::string& name, VectorSlerp fn);
+    void addQuaternionNormalize(const std::string& name, QuaternionUnary fn);
+    void addQuaternionSlerp(const std::string& name, QuaternionSlerp fn);
+    void addRotationMatrix(const std::string& name, QuaternionToMatrix fn);
+    void addMatrixMultiply(const std::string& name, MatrixBinary fn);
+    void addMatrixInverse(const std::string& name, MatrixUnary fn);
+    /// @}
+
+    /**
+     * @brief Registers the existing scalar implementations.
+     *
+     * They are named "scalar", or "strict" in a RENDERFX_MATH_STRICT build,
+     * where the slerps call math::strict; compare the reports of the two
+     * builds for the cost of strict mode in accuracy.
+     */
+    void addScalarVariants();
+
+    /**
+     * @brief Registers the scalar implementations instantiated with a fixed-point type.
+     *
+     * Inputs are converted to F, which rounds and saturates them, and the
+     * results are converted back to T.
+     *
+     * @tparam F The fixed-point type, e.g. Fixed16 or Fixed32.
+     * @param name The variant name, e.g. "fixed32".
+     */
+    template<typename F>
+    void addFixedVariants(const std::string& name);
+
+    /**
+     * @brief Runs every registered variant against the reference.
+     *
+     * @return One result per variant, grouped by operation.
+     */
+    std::vector<AccuracyResult> run() const;
+
+private:
+    struct Variant {
+        std::string name;
+        VectorUnary vectorNormalize;
+        VectorSlerp vectorSlerp;
+        QuaternionUnary quaternionNormalize;
+        QuaternionSlerp quaternionSlerp;
+        QuaternionToMatrix rotationMatrix;
+        MatrixBinary matrixMultiply;
+        MatrixUnary matrixInverse;
+    };
+
+    std::vector<Vector3<T>> vectors;
+    std::vector<Vector3<T>> slerpTargets;
+    std::vector<Quaternion<T>> quaternions;
+    std::vector<Quaternion<T>> quaternionTargets;
+    std::vector<T> factors;
+    std::vector<Matrix4x4<T>> matrices;
+    std::vector<Variant> variants;
+};
+
+/**
+ * @brief Prints accuracy results as a table.
+ *
+ * @param os The output stream.
+ * @param results The results to print.
+ */
+void printAccuracyReport(std::ostream& os, const std::vector<AccuracyResult>& results);
+
+// Commonly used types
+using AccuracyHarnessf = AccuracyHarness<float>;
+using AccuracyHarnessd = AccuracyHarness<double>;
+
+#include "AccuracyHarness.inl"
+
+#endif // ACCURACYHARNESS_H
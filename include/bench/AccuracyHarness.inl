@@ -0,0 +1,603 @@
+#ifndef ACCURACYHARNESS_INL
+#define ACCURACYHARNESS_INL
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+
+template<typename T>
+long double ulpError(long double value, long double reference, long double scale) {
+    if (!std::isfinite(value)) return std::numeric_limits<long double>::infinity();
+    T magnitude = static_cast<T>(std::abs(scale));
+    T ulp = std::numeric_limits<T>::denorm_min();
+    if (std::isfinite(magnitude) && magnitude >= std::numeric_limits<T>::min()) {
+        ulp = std::nextafter(magnitude, std::numeric_limits<T>::infinity()) - magnitude;
+    }
+    return std::abs(value - reference) / static_cast<long double>(ulp);
+}
+
+namespace detail {
+
+template<typename T>
+Vector3<long double> widen(const Vector3<T>& v) {
+    return Vector3<long double>(v.x, v.y, v.z);
+}
+
+template<typename T>
+Quaternion<long double> widen(const Quaternion<T>& q) {
+    return Quaternion<long double>(q.w, q.x, q.y, q.z);
+}
+
+template<typename T>
+Matrix4x4<long double> widen(const Matrix4x4<T>& m) {
+    Matrix4x4<long double> result;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            result(i, j) = m(i, j);
+    return result;
+}
+
+template<typename U, typename T>
+Vector3<U> castScalars(const Vector3<T>& v) {
+    return Vector3<U>(static_cast<U>(v.x), static_cast<U>(v.y), static_cast<U>(v.z));
+}
+
+template<typename U, typename T>
+Quaternion<U> castScalars(const Quaternion<T>& q) {
+    return Quaternion<U>(static_cast<U>(q.w), static_cast<U>(q.x), static_cast<U>(q.y), static_cast<U>(q.z));
+}
+
+template<typename U, typename T>
+Matrix4x4<U> castScalars(const Matrix4x4<T>& m) {
+    Matrix4x4<U> result;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            result(i, j) = static_cast<U>(m(i, j));
+    return result;
+}
+
+template<typename T>
+bool isFinite(const Vector3<T>& v) {
+    return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+}
+
+template<typename T>
+bool isFinite(const Quaternion<T>& q) {
+    return std::isfinite(q.w) && std::isfinite(q.x) && std::isfinite(q.y) && std::isfinite(q.z);
+}
+
+template<typename T>
+bool isFinite(const Matrix4x4<T>& m) {
+    for (const auto& row : m.data)
+        for (T value : row)
+            if (!std::isfinite(value)) return false;
+    return true;
+}
+
+template<typename T>
+std::string describe(const T& value) {
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<long double>::max_digits10) << value;
+    return os.str();
+}
+
+template<typename T>
+std::string describe(const Quaternion<T>& q) {
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<T>::max_digits10)
+       << "Quaternion(" << q.w << ", " << q.x << ", " << q.y << ", " << q.z << ")";
+    return os.str();
+}
+
+template<typename T>
+std::string describe(const Matrix4x4<T>& m) {
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<T>::max_digits10) << "Matrix4x4(";
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            os << m(i, j) << (i == 3 && j == 3 ? ")" : ", ");
+    return os.str();
+}
+
+template<typename T>
+std::string describe(const Vector3<T>& v) {
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<T>::max_digits10) << v;
+    return os.str();
+}
+
+// Gauss-Jordan elimination with partial pivoting, independent of Matrix4x4::inverse().
+inline bool referenceInverse(const Matrix4x4<long double>& m, Matrix4x4<long double>& inverse) {
+    Matrix4x4<long double> a = m;
+    inverse.setIdentity();
+    for (int col = 0; col < 4; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < 4; ++row)
+            if (std::abs(a(row, col)) > std::abs(a(pivot, col))) pivot = row;
+        if (a(pivot, col) == 0) return false;
+        std::swap(a.data[col], a.data[pivot]);
+        std::swap(inverse.data[col], inverse.data[pivot]);
+        long double scale = 1 / a(col, col);
+        for (int j = 0; j < 4; ++j) {
+            a(col, j) *= scale;
+            inverse(col, j) *= scale;
+        }
+        for (int row = 0; row < 4; ++row) {
+            if (row == col) continue;
+            long double factor = a(row, col);
+            for (int j = 0; j < 4; ++j) {
+                a(row, j) -= factor * a(col, j);
+                inverse(row, j) -= factor * inverse(col, j);
+            }
+        }
+    }
+    return true;
+}
+
+// Angle between two directions, accurate for small angles.
+inline long double angleBetween(const Vector3<long double>& a, const Vector3<long double>& b) {
+    return std::atan2(a.cross(b).length(), a.dot(b));
+}
+
+// Angle of the rotation taking one unit quaternion to another, accurate for small angles.
+inline long double angleBetween(const Quaternion<long double>& a, const Quaternion<long double>& b) {
+    long double sign = (a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z) < 0 ? -1 : 1;
+    long double dw = a.w - sign * b.w, dx = a.x - sign * b.x, dy = a.y - sign * b.y, dz = a.z - sign * b.z;
+    long double chord = std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz);
+    return 4 * std::asin(std::min<long double>(1, chord / 2));
+}
+
+// Vector3::slerp in closed form: rotates a about a x b by the fraction t
+// of the angle between a and b (Rodrigues' formula). Undefined for
+// antiparallel directions, which have no rotation axis.
+inline bool referenceSlerp(const Vector3<long double>& a, const Vector3<long double>& b, long double t, Vector3<long double>& result) {
+    Vector3<long double> cross = a.cross(b);
+    long double sine = cross.length();
+    long double cosine = a.dot(b);
+    if (sine == 0) {
+        result = a;
+        return cosine > 0;
+    }
+    Vector3<long double> axis = cross / sine;
+    long double angle = t * std::atan2(sine, cosine);
+    result = a * std::cos(angle) + axis.cross(a) * std::sin(angle) + axis * (axis.dot(a) * (1 - std::cos(angle)));
+    return true;
+}
+
+// Quaternion::slerp in closed form: composes a with the fraction t of the
+// rotation from a to b, taken as an axis and angle. The arc follows the
+// sign of b as given; negate b for the other one.
+inline Quaternion<long double> referenceSlerp(const Quaternion<long double>& a, const Quaternion<long double>& b, long double t) {
+    // The rotation from a to b, conjugate(a) * b.
+    long double w = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    long double x = a.w * b.x - a.x * b.w - a.y * b.z + a.z * b.y;
+    long double y = a.w * b.y - a.y * b.w - a.z * b.x + a.x * b.z;
+    long double z = a.w * b.z - a.z * b.w - a.x * b.y + a.y * b.x;
+    long double sine = std::sqrt(x * x + y * y + z * z);
+    if (sine == 0) return a;
+    long double halfAngle = t * std::atan2(sine, w);
+    long double s = std::sin(halfAngle) / sine;
+    return a * Quaternion<long double>(std::cos(halfAngle), x * s, y * s, z * s);
+}
+
+template<typename T>
+long double maxUlpError(const Vector3<T>& value, const Vector3<long double>& reference) {
+    long double scale = std::max({ std::abs(reference.x), std::abs(reference.y), std::abs(reference.z) });
+    return std::max({ ulpError<T>(value.x, reference.x, scale),
+                      ulpError<T>(value.y, reference.y, scale),
+                      ulpError<T>(value.z, reference.z, scale) });
+}
+
+template<typename T>
+long double maxUlpError(const Quaternion<T>& value, const Quaternion<long double>& reference) {
+    // q and -q are the same rotation; measure against the closer one.
+    long double sign = (value.w * reference.w + value.x * reference.x + value.y * reference.y + value.z * reference.z) < 0 ? -1 : 1;
+    long double scale = std::max({ std::abs(reference.w), std::abs(reference.x), std::abs(reference.y), std::abs(reference.z) });
+    return std::max({ ulpError<T>(value.w, sign * reference.w, scale),
+                      ulpError<T>(value.x, sign * reference.x, scale),
+                      ulpError<T>(value.y, sign * reference.y, scale),
+                      ulpError<T>(value.z, sign * reference.z, scale) });
+}
+
+template<typename T>
+long double maxUlpError(const Matrix4x4<T>& value, const Matrix4x4<long double>& reference) {
+    long double scale = 0;
+    for (const auto& row : reference.data)
+        for (long double element : row)
+            scale = std::max(scale, std::abs(element));
+    long double error = 0;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            error = std::max(error, ulpError<T>(value(i, j), reference(i, j), scale));
+    return error;
+}
+
+class ErrorAccumulator {
+public:
+    ErrorAccumulator(const std::string& operation, const std::string& variant) {
+        result.operation = operation;
+        result.variant = variant;
+    }
+
+    template<typename Describe>
+    void add(long double ulp, long double angular, Describe&& describeInput) {
+        ++result.samples;
+        ulpSum += ulp;
+        angularSum += angular;
+        if (ulp > result.maxUlp || result.worstInput.empty()) {
+            result.maxUlp = std::max(result.maxUlp, ulp);
+            result.worstInput = describeInput();
+        }
+        result.maxAngular = std::max(result.maxAngular, angular);
+    }
+
+    void addException() { ++result.exceptions; }
+    void addNonFinite() { ++result.nonFinite; }
+
+    AccuracyResult finish() {
+        if (result.samples > 0) {
+            result.meanUlp = ulpSum / result.samples;
+            result.meanAngular = angularSum / result.samples;
+        }
+        return result;
+    }
+
+private:
+    AccuracyResult result;
+    long double ulpSum = 0;
+    long double angularSum = 0;
+};
+
+// Runs one variant over all inputs. `reference` and `variant` take the input
+// index; the reference returns false when it is undefined for that input.
+template<typename Reference, typename Variant, typename Measure, typename Describe>
+AccuracyResult runVariant(const std::string& operation, const std::string& name, std::size_t count,
+                          Reference&& reference, Variant&& variant, Measure&& measure, Describe&& describeInput) {
+    ErrorAccumulator accumulator(operation, name);
+    for (std::size_t i = 0; i < count; ++i) {
+        decltype(reference(i)) expected;
+        try {
+            expected = reference(i);
+        } catch (const std::exception&) {
+            continue;
+        }
+        if (!expected.first) continue;
+
+        decltype(variant(i)) actual;
+        try {
+            actual = variant(i);
+        } catch (const std::exception&) {
+            accumulator.addException();
+            continue;
+        }
+        if (!isFinite(actual)) {
+            accumulator.addNonFinite();
+            continue;
+        }
+        auto error = measure(actual, expected.second);
+        accumulator.add(error.first, error.second, [&] { return describeInput(i); });
+    }
+    return accumulator.finish();
+}
+
+} // namespace detail
+
+template<typename T>
+AccuracyHarness<T>::AccuracyHarness(std::size_t randomSamples, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<T> unit(T(-1), T(1));
+    std::uniform_real_distribution<T> exponent(T(-3), T(3));
+    std::uniform_real_distribution<T> factor(T(0), T(1));
+    const T denormal = std::numeric_limits<T>::denorm_min();
+    const T tiny = std::numeric_limits<T>::min();
+    const T pi = T(3.14159265358979323846);
+
+    auto randomDirection = [&] {
+        for (;;) {
+            Vector3<T> v(unit(rng), unit(rng), unit(rng));
+            T lengthSquared = v.lengthSquared();
+            if (lengthSquared > T(1e-4) && lengthSquared <= T(1)) return v / std::sqrt(lengthSquared);
+        }
+    };
+    auto randomRotation = [&] {
+        return Quaternion<T>::fromAxisAngle(randomDirection(), unit(rng) * pi);
+    };
+
+    // Vectors: denormal, zero, overflowing and mixed-magnitude edge cases first.
+    vectors = {
+        Vector3<T>(1, 0, 0), Vector3<T>(-0.0, 0, 1), Vector3<T>(denormal, 0, 0), Vector3<T>(tiny, tiny, tiny),
+        Vector3<T>(T(1e-20), T(1e-20), T(1e-20)), Vector3<T>(T(1e-4), T(1e-4), T(1e-4)),
+        Vector3<T>(1, denormal, -denormal), Vector3<T>(T(1e19), T(1e19), T(1e19)),
+        Vector3<T>(std::numeric_limits<T>::max() / 4, 0, 0), Vector3<T>(T(1e8), 1, T(1e-8))
+    };
+    for (std::size_t i = 0; i < randomSamples; ++i) {
+        vectors.push_back(randomDirection() * std::pow(T(10), exponent(rng)));
+    }
+
+    // Vector slerp pairs: parallel, antiparallel, nearly parallel and orthogonal directions.
+    Vector3<T> axis = Vector3<T>(1, 2, 3).normalized();
+    Vector3<T> orthogonal = axis.cross(Vector3<T>::up()).normalized();
+    std::vector<std::pair<Vector3<T>, Vector3<T>>> directionPairs = {
+        { axis, axis }, { axis, axis * T(-1) }, { axis, (axis + orthogonal * T(1e-4)).normalized() },
+        { axis, (axis * T(-1) + orthogonal * T(1e-4)).normalized() }, { axis, orthogonal }
+    };
+    for (std::size_t i = 0; i < randomSamples; ++i) {
+        directionPairs.emplace_back(randomDirection(), randomDirection());
+    }
+    for (std::size_t i = 0; i < directionPairs.size(); ++i) {
+        slerpTargets.push_back(directionPairs[i].first);
+        slerpTargets.push_back(directionPairs[i].second);
+    }
+
+    // Quaternion pairs: identical, antiparallel (same rotation), 180 degrees apart,
+    // and straddling the nlerp threshold of Quaternion::slerp.
+    Quaternion<T> q = randomRotation();
+    auto rotated = [&](const Quaternion<T>& from, T angle) {
+        return Quaternion<T>::fromAxisAngle(orthogonal, angle) * from;
+    };
+    std::vector<std::pair<Quaternion<T>, Quaternion<T>>> rotationPairs = {
+        { q, q }, { q, Quaternion<T>(-q.w, -q.x, -q.y, -q.z) }, { q, rotated(q, pi) },
+        { q, rotated(q, T(0.0632)) }, { q, rotated(q, T(0.0633)) }, { q, rotated(q, T(1e-5)) },
+        { Quaternion<T>(), Quaternion<T>(0, 1, 0, 0) }
+    };
+    for (std::size_t i = 0; i < randomSamples; ++i) {
+        rotationPairs.emplace_back(randomRotation(), randomRotation());
+    }
+    for (const auto& pair : rotationPairs) {
+        quaternionTargets.push_back(pair.first);
+        quaternionTargets.push_back(pair.second);
+    }
+    quaternions = {
+        Quaternion<T>(), Quaternion<T>(0, 1, 0, 0), Quaternion<T>(T(1e-20), 0, 0, 0),
+        Quaternion<T>(tiny, tiny, tiny, tiny), Quaternion<T>(T(1e18), T(1e18), 0, 0), Quaternion<T>(1, denormal, 0, 0)
+    };
+    for (std::size_t i = 0; i < randomSamples; ++i) {
+        Quaternion<T> r = randomRotation();
+        T magnitude = std::pow(T(10), exponent(rng));
+        quaternions.emplace_back(r.w * magnitude, r.x * magnitude, r.y * magnitude, r.z * magnitude);
+    }
+
+    factors = { T(0), T(1), T(0.5) };
+    std::size_t pairCount = std::max(directionPairs.size(), rotationPairs.size());
+    while (factors.size() < pairCount) factors.push_back(factor(rng));
+
+    // Matrices: affine transforms plus near-singular and projective edge cases.
+    auto randomAffine = [&] {
+        Vector3<T> scale(std::pow(T(10), exponent(rng) / 3), std::pow(T(10), exponent(rng) / 3), std::pow(T(10), exponent(rng) / 3));
+        Vector3<T> translation = randomDirection() * std::pow(T(10), exponent(rng));
+        return Transform<T>(translation, randomRotation(), scale).toMatrix();
+    };
+    matrices = {
+        Matrix4x4<T>::identity(),
+        Matrix4x4<T>::perspective(pi / 3, T(16) / T(9), T(0.1), T(1000)),
+        Transform<T>(Vector3<T>(T(1e4), 0, T(-1e4)), randomRotation(), Vector3<T>(1, 1, T(1e-4))).toMatrix(),
+        Transform<T>(Vector3<T>(1, 2, 3), randomRotation(), Vector3<T>(1, T(1e-7), 1)).toMatrix(),
+        Matrix4x4<T>::scaling(Vector3<T>(T(1e-3), T(1e3), 1))
+    };
+    for (std::size_t i = 0; i < randomSamples; ++i) {
+        matrices.push_back(randomAffine());
+    }
+}
+
+template<typename T>
+void AccuracyHarness<T>::addVectorNormalize(const std::string& name, VectorUnary fn) {
+    Variant variant;
+    variant.name = name;
+    variant.vectorNormalize = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addVectorSlerp(const std::string& name, VectorSlerp fn) {
+    Variant variant;
+    variant.name = name;
+    variant.vectorSlerp = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addQuaternionNormalize(const std::string& name, QuaternionUnary fn) {
+    Variant variant;
+    variant.name = name;
+    variant.quaternionNormalize = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addQuaternionSlerp(const std::string& name, QuaternionSlerp fn) {
+    Variant variant;
+    variant.name = name;
+    variant.quaternionSlerp = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addRotationMatrix(const std::string& name, QuaternionToMatrix fn) {
+    Variant variant;
+    variant.name = name;
+    variant.rotationMatrix = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addMatrixMultiply(const std::string& name, MatrixBinary fn) {
+    Variant variant;
+    variant.name = name;
+    variant.matrixMultiply = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addMatrixInverse(const std::string& name, MatrixUnary fn) {
+    Variant variant;
+    variant.name = name;
+    variant.matrixInverse = std::move(fn);
+    variants.push_back(std::move(variant));
+}
+
+template<typename T>
+void AccuracyHarness<T>::addScalarVariants() {
+    const std::string name = math::strictMode ? "strict" : "scalar";
+    addVectorNormalize(name, [](const Vector3<T>& v) { return v.normalized(); });
+    addVectorSlerp(name, [](const Vector3<T>& a, const Vector3<T>& b, T t) { return Vector3<T>::slerp(a, b, t); });
+    addQuaternionNormalize(name, [](const Quaternion<T>& q) { return q.normalized(); });
+    addQuaternionSlerp(name, [](const Quaternion<T>& a, const Quaternion<T>& b, T t) { return Quaternion<T>::slerp(a, b, t); });
+    addRotationMatrix(name, [](const Quaternion<T>& q) { return q.toRotationMatrix(); });
+    addMatrixMultiply(name, [](const Matrix4x4<T>& a, const Matrix4x4<T>& b) { return a * b; });
+    addMatrixInverse(name, [](const Matrix4x4<T>& m) { return m.inverse(); });
+}
+
+template<typename T>
+template<typename F>
+void AccuracyHarness<T>::addFixedVariants(const std::string& name) {
+    using detail::castScalars;
+    addVectorNormalize(name, [](const Vector3<T>& v) { return castScalars<T>(castScalars<F>(v).normalized()); });
+    addVectorSlerp(name, [](const Vector3<T>& a, const Vector3<T>& b, T t) {
+        return castScalars<T>(Vector3<F>::slerp(castScalars<F>(a), castScalars<F>(b), F(t)));
+    });
+    addQuaternionNormalize(name, [](const Quaternion<T>& q) { return castScalars<T>(castScalars<F>(q).normalized()); });
+    addQuaternionSlerp(name, [](const Quaternion<T>& a, const Quaternion<T>& b, T t) {
+        return castScalars<T>(Quaternion<F>::slerp(castScalars<F>(a), castScalars<F>(b), F(t)));
+    });
+    addRotationMatrix(name, [](const Quaternion<T>& q) { return castScalars<T>(castScalars<F>(q).toRotationMatrix()); });
+    addMatrixMultiply(name, [](const Matrix4x4<T>& a, const Matrix4x4<T>& b) {
+        return castScalars<T>(castScalars<F>(a) * castScalars<F>(b));
+    });
+    addMatrixInverse(name, [](const Matrix4x4<T>& m) { return castScalars<T>(castScalars<F>(m).inverse()); });
+}
+
+template<typename T>
+std::vector<AccuracyResult> AccuracyHarness<T>::run() const {
+    using LongVector = Vector3<long double>;
+    using LongQuaternion = Quaternion<long double>;
+    using LongMatrix = Matrix4x4<long double>;
+    const std::size_t directionCount = slerpTargets.size() / 2;
+    const std::size_t rotationCount = quaternionTargets.size() / 2;
+
+    auto vectorError = [](const Vector3<T>& actual, const LongVector& expected) {
+        return std::make_pair(detail::maxUlpError(actual, expected), detail::angleBetween(detail::widen(actual), expected));
+    };
+    auto quaternionError = [](const Quaternion<T>& actual, const LongQuaternion& expected) {
+        LongQuaternion wide = detail::widen(actual);
+        long double magnitude = wide.magnitude();
+        long double angle = magnitude > 0
+            ? detail::angleBetween(LongQuaternion(wide.w / magnitude, wide.x / magnitude, wide.y / magnitude, wide.z / magnitude), expected)
+            : std::numeric_limits<long double>::infinity();
+        return std::make_pair(detail::maxUlpError(actual, expected), angle);
+    };
+    auto matrixError = [](const Matrix4x4<T>& actual, const LongMatrix& expected) {
+        return std::make_pair(detail::maxUlpError(actual, expected), 0.0L);
+    };
+
+    std::vector<AccuracyResult> results;
+    for (const auto& variant : variants) {
+        if (variant.vectorNormalize) {
+            results.push_back(detail::runVariant("Vector3::normalized", variant.name, vectors.size(),
+                [&](std::size_t i) { return std::make_pair(true, detail::widen(vectors[i]).normalized()); },
+                [&](std::size_t i) { return variant.vectorNormalize(vectors[i]); },
+                vectorError,
+                [&](std::size_t i) { return detail::describe(vectors[i]); }));
+        }
+        if (variant.vectorSlerp) {
+            results.push_back(detail::runVariant("Vector3::slerp", variant.name, directionCount,
+                [&](std::size_t i) {
+                    LongVector expected;
+                    bool defined = detail::referenceSlerp(detail::widen(slerpTargets[2 * i]), detail::widen(slerpTargets[2 * i + 1]), factors[i], expected);
+                    return std::make_pair(defined, expected);
+                },
+                [&](std::size_t i) { return variant.vectorSlerp(slerpTargets[2 * i], slerpTargets[2 * i + 1], factors[i]); },
+                vectorError,
+                [&](std::size_t i) {
+                    return detail::describe(slerpTargets[2 * i]) + " -> " + detail::describe(slerpTargets[2 * i + 1]) + " t=" + detail::describe(factors[i]);
+                }));
+        }
+        if (variant.quaternionNormalize) {
+            results.push_back(detail::runVariant("Quaternion::normalized", variant.name, quaternions.size(),
+                [&](std::size_t i) { return std::make_pair(true, detail::widen(quaternions[i]).normalized()); },
+                [&](std::size_t i) { return variant.quaternionNormalize(quaternions[i]); },
+                quaternionError,
+                [&](std::size_t i) { return detail::describe(quaternions[i]); }));
+        }
+        if (variant.quaternionSlerp) {
+            // Rotations close to 180 degrees apart have two equally short arcs,
+            // and rounding decides which one slerp takes; either one is correct.
+            results.push_back(detail::runVariant("Quaternion::slerp", variant.name, rotationCount,
+                [&](std::size_t i) {
+                    LongQuaternion a = detail::widen(quaternionTargets[2 * i]);
+                    LongQuaternion b = detail::widen(quaternionTargets[2 * i + 1]);
+                    long double dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+                    LongQuaternion near = dot < 0 ? LongQuaternion(-b.w, -b.x, -b.y, -b.z) : b;
+                    LongQuaternion far(-near.w, -near.x, -near.y, -near.z);
+                    LongQuaternion shorter = detail::referenceSlerp(a, near, factors[i]);
+                    bool halfTurn = std::abs(dot) < 1e-3L;
+                    return std::make_pair(true, std::make_pair(shorter, halfTurn ? detail::referenceSlerp(a, far, factors[i]) : shorter));
+                },
+                [&](std::size_t i) { return variant.quaternionSlerp(quaternionTargets[2 * i], quaternionTargets[2 * i + 1], factors[i]); },
+                [&](const Quaternion<T>& actual, const std::pair<LongQuaternion, LongQuaternion>& expected) {
+                    auto first = quaternionError(actual, expected.first);
+                    auto second = quaternionError(actual, expected.second);
+                    return second.second < first.second ? second : first;
+                },
+                [&](std::size_t i) {
+                    return detail::describe(quaternionTargets[2 * i]) + " -> " + detail::describe(quaternionTargets[2 * i + 1]) + " t=" + detail::describe(factors[i]);
+                }));
+        }
+        if (variant.rotationMatrix) {
+            results.push_back(detail::runVariant("Quaternion::toRotationMatrix", variant.name, rotationCount,
+                [&](std::size_t i) { return std::make_pair(true, detail::widen(quaternionTargets[2 * i]).toRotationMatrix()); },
+                [&](std::size_t i) { return variant.rotationMatrix(quaternionTargets[2 * i]); },
+                matrixError,
+                [&](std::size_t i) { return detail::describe(quaternionTargets[2 * i]); }));
+        }
+        if (variant.matrixMultiply) {
+            results.push_back(detail::runVariant("Matrix4x4::operator*", variant.name, matrices.size(),
+                [&](std::size_t i) {
+                    return std::make_pair(true, detail::widen(matrices[i]) * detail::widen(matrices[(i + 1) % matrices.size()]));
+                },
+                [&](std::size_t i) { return variant.matrixMultiply(matrices[i], matrices[(i + 1) % matrices.size()]); },
+                matrixError,
+                [&](std::size_t i) { return detail::describe(matrices[i]) + " * " + detail::describe(matrices[(i + 1) % matrices.size()]); }));
+        }
+        if (variant.matrixInverse) {
+            results.push_back(detail::runVariant("Matrix4x4::inverse", variant.name, matrices.size(),
+                [&](std::size_t i) {
+                    LongMatrix inverse;
+                    bool defined = detail::referenceInverse(detail::widen(matrices[i]), inverse);
+                    return std::make_pair(defined, inverse);
+                },
+                [&](std::size_t i) { return variant.matrixInverse(matrices[i]); },
+                matrixError,
+                [&](std::size_t i) { return detail::describe(matrices[i]); }));
+        }
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const AccuracyResult& a, const AccuracyResult& b) {
+        return a.operation < b.operation;
+    });
+    return results;
+}
+
+inline void printAccuracyReport(std::ostream& os, const std::vector<AccuracyResult>& results) {
+    auto flags = os.flags();
+    os << std::left << std::setw(30) << "operation" << std::setw(14) << "variant" << std::right
+       << std::setw(9) << "samples" << std::setw(7) << "throw" << std::setw(7) << "nan"
+       << std::setw(13) << "max ulp" << std::setw(11) << "mean ulp"
+       << std::setw(13) << "max rad" << std::setw(13) << "mean rad" << "\n";
+    for (const auto& result : results) {
+        os << std::left << std::setw(30) << result.operation << std::setw(14) << result.variant << std::right
+           << std::setw(9) << result.samples << std::setw(7) << result.exceptions << std::setw(7) << result.nonFinite
+           << std::setprecision(4) << std::setw(13) << static_cast<double>(result.maxUlp)
+           << std::setw(11) << static_cast<double>(result.meanUlp)
+           << std::setw(13) << static_cast<double>(result.maxAngular)
+           << std::setw(13) << static_cast<double>(result.meanAngular) << "\n";
+        if (result.maxUlp > 0) {
+            os << "    worst: " << result.worstInput << "\n";
+        }
+    }
+    os.flags(flags);
+}
+
+#endif // ACCURACYHARNESS_INL
@@ -0,0 +1,205 @@
+#ifndef FRAMEBENCHMARK_H
+#define FRAMEBENCHMARK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../math/Geometry.h"
+
+/**
+ * @brief How the root objects of a synthetic scene are placed in the world.
+ */
+enum class SpatialDistribution {
+    Uniform,   ///< Uniformly inside the world cube.
+    Clustered, ///< Normally distributed around a set of cluster centers.
+    Grid       ///< On a regular grid filling the world cube.
+};
+
+/**
+ * @brief Parameters used to generate a synthetic scene.
+ */
+struct SceneConfig {
+    std::size_t objectCount = 100000;  ///< Total number of objects.
+    int hierarchyDepth = 4;            ///< Number of hierarchy levels; 1 produces a flat scene.
+    float motionFraction = 0.1f;       ///< Fraction of objects whose local transform changes every frame.
+    SpatialDistribution distribution = SpatialDistribution::Uniform; ///< Placement of root objects.
+    float worldExtent = 1000.0f;       ///< Half size of the cube the roots are placed in.
+    std::size_t clusterCount = 32;     ///< Number of clusters for SpatialDistribution::Clustered.
+    std::size_t viewCount = 3;         ///< Number of views culled every frame (at most 8).
+    int lodLevels = 4;                 ///< Number of LOD levels selected by view distance.
+    std::uint32_t seed = 1;            ///< Random seed; equal seeds produce equal scenes.
+};
+
+/**
+ * @brief Wall-clock time of each pipeline stage for one frame, in milliseconds.
+ */
+struct FrameTimings {
+    double hierarchy = 0; ///< Local animation and world matrix propagation.
+    double bounds = 0;    ///< Local to world bounding box transformation.
+    double culling = 0;   ///< Frustum culling against every view.
+    double lod = 0;       ///< LOD selection for visible objects.
+    double sort = 0;      ///< Draw list construction and sorting.
+    double total = 0;     ///< Whole frame.
+};
+
+/**
+ * @brief Summary statistics over a set of timing samples, in milliseconds.
+ */
+struct TimingStats {
+    double mean = 0;
+    double min = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+
+    /**
+     * @brief Computes the statistics of a set of samples.
+     *
+     * @param samples The samples; they are sorted in place.
+     * @return The statistics, or all zeroes for an empty set.
+     */
+    static TimingStats fromSamples(std::vector<double>& samples);
+};
+
+/**
+ * @brief Result of running the frame benchmark with a fixed thread count.
+ */
+struct FrameBenchmarkReport {
+    unsigned threadCount = 1;    ///< Threads used for every stage.
+    std::size_t frameCount = 0;  ///< Number of measured frames.
+    TimingStats hierarchy;       ///< Hierarchy stage statistics.
+    TimingStats bounds;          ///< Bounds stage statistics.
+    TimingStats culling;         ///< Culling stage statistics.
+    TimingStats lod;             ///< LOD stage statistics.
+    TimingStats sort;            ///< Sort stage statistics.
+    TimingStats total;           ///< Whole frame statistics.
+    double averageDrawCount = 0; ///< Average number of draw items per frame, summed over all views.
+};
+
+/**
+ * @brief A generated scene together with the per-frame working data of the pipeline.
+ *
+ * Objects are stored depth-ordered: every parent precedes its children and
+ * the objects of hierarchy level L occupy [levelOffsets[L], levelOffsets[L + 1]).
+ *
+ * @tparam T Type of the scalar values.
+ */
+template<typename T>
+class SyntheticScene {
+public:
+    std::vector<std::int32_t> parents;           ///< Parent index per object, -1 for roots.
+    std::vector<std::size_t> levelOffsets;       ///< First object of every hierarchy level, plus the end.
+    std::vector<Transform<T>> localTransforms;   ///< Transform relative to the parent.
+    std::vector<AABB<T>> localBounds;            ///< Bounds in object space.
+    std::vector<std::uint32_t> movingObjects;    ///< Indices of the animated objects.
+    std::vector<Vector3<T>> velocities;          ///< Velocity per animated object.
+    std::vector<Matrix4x4<T>> worldMatrices;     ///< Object to world matrices.
+    std::vector<AABB<T>> worldBounds;            ///< Bounds in world space.
+    std::vector<std::uint8_t> visibility;        ///< One bit per view that sees the object.
+    std::vector<std::uint8_t> lods;              ///< LOD per view and object, indexed view * size() + object.
+    std::vector<Vector3<T>> viewPositions;       ///< Eye position per view.
+    std::vector<Frustum<T>> frustums;            ///< Culling frustum per view.
+    std::vector<std::vector<std::uint64_t>> drawLists; ///< Sorted draw keys per view.
+
+    /**
+     * @brief Generates a scene.
+     *
+     * @param config The generation parameters.
+     * @return The generated scene with identity world data.
+     */
+    static SyntheticScene generate(const SceneConfig& config);
+
+    /**
+     * @brief Gets the number of objects.
+     *
+     * @return The object count.
+     */
+    std::size_t size() const noexcept;
+};
+
+/**
+ * @brief End-to-end CPU frame benchmark over a synthetic scene.
+ *
+ * Every simulated frame animates the moving objects, propagates world
+ * matrices through the hierarchy with Transform::toMatrix(), transforms the
+ * bounds, culls them against every view frustum, selects LODs and builds
+ * sorted draw lists. All stages run on the same ThreadPool so cache effects
+ * between stages are part of the measurement.
+ *
+ * @tparam T Type of the scalar values.
+ */
+template<typename T>
+class FrameBenchmark {
+public:
+    /**
+     * @brief Creates the benchmark and generates its scene.
+     *
+     * @param config The scene parameters.
+     */
+    explicit FrameBenchmark(const SceneConfig& config);
+
+    /**
+     * @brief Simulates one frame.
+     *
+     * @param pool The pool that runs the stages.
+     * @param deltaTime The simulated frame time in seconds.
+     * @return The time spent in every stage.
+     */
+    FrameTimings runFrame(ThreadPool& pool, T deltaTime);
+
+    /**
+     * @brief Regenerates the scene and measures a series of frames.
+     *
+     * @param threadCount The number of threads used by every stage.
+     * @param warmupFrames Frames simulated before measuring.
+     * @param measuredFrames Frames included in the report.
+     * @return The timing report.
+     */
+    FrameBenchmarkReport run(unsigned threadCount, std::size_t warmupFrames, std::size_t measuredFrames);
+
+    /**
+     * @brief Runs the benchmark with 1, 2, 4, ... threads up to maxThreads.
+     *
+     * @param maxThreads The largest thread count; it is always included. Zero selects the hardware concurrency.
+     * @param warmupFrames Frames simulated before measuring each run.
+     * @param measuredFrames Frames included in each report.
+     * @return One report per thread count, in ascending order.
+     */
+    std::vector<FrameBenchmarkReport> runScaling(unsigned maxThreads, std::size_t warmupFrames, std::size_t measuredFrames);
+
+    /**
+     * @brief Gets the scene as left by the last simulated frame.
+     *
+     * @return The scene.
+     */
+    const SyntheticScene<T>& scene() const noexcept;
+
+private:
+    void updateHierarchy(ThreadPool& pool, T deltaTime);
+    void updateBounds(ThreadPool& pool);
+    void cull(ThreadPool& pool);
+    void selectLods(ThreadPool& pool);
+    void sortDrawLists(ThreadPool& pool);
+
+    SceneConfig config;
+    SyntheticScene<T> sceneData;
+    std::vector<T> lodDistancesSquared;
+};
+
+/**
+ * @brief Prints a table of per-stage statistics and thread scaling.
+ *
+ * @param os The output stream.
+ * @param reports The reports to print, typically from FrameBenchmark::runScaling().
+ */
+void printFrameBenchmarkReports(std::ostream& os, const std::vector<FrameBenchmarkReport>& reports);
+
+// Commonly used types
+using FrameBenchmarkf = FrameBenchmark<float>;
+
+#include "FrameBenchmark.inl"
+
+#endif // FRAMEBENCHMARK_H
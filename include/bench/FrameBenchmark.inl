@@ -0,0 +1,365 @@
+#ifndef FRAMEBENCHMARK_INL
+#define FRAMEBENCHMARK_INL
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+
+inline TimingStats TimingStats::fromSamples(std::vector<double>& samples) {
+    TimingStats stats;
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p * samples.size()));
+        return samples[std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    stats.mean = sum / samples.size();
+    stats.min = samples.front();
+    stats.p50 = percentile(0.50);
+    stats.p90 = percentile(0.90);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+template<typename T>
+SyntheticScene<T> SyntheticScene<T>::generate(const SceneConfig& config) {
+    if (config.hierarchyDepth < 1) throw std::invalid_argument("Hierarchy depth must be at least 1");
+    if (config.viewCount < 1 || config.viewCount > 8) throw std::invalid_argument("View count must be between 1 and 8");
+    if (config.lodLevels < 1) throw std::invalid_argument("LOD level count must be at least 1");
+
+    SyntheticScene scene;
+    const std::size_t count = config.objectCount;
+    const std::size_t depth = static_cast<std::size_t>(config.hierarchyDepth);
+    const T extent = static_cast<T>(config.worldExtent);
+    std::mt19937 rng(config.seed);
+    std::uniform_real_distribution<T> unit(T(-1), T(1));
+    std::uniform_real_distribution<T> size(T(0.5), T(5));
+
+    // Split the objects evenly across the levels, the remainder goes to the roots.
+    scene.levelOffsets.resize(depth + 1);
+    std::size_t perLevel = count / depth;
+    scene.levelOffsets[0] = 0;
+    scene.levelOffsets[1] = count - perLevel * (depth - 1);
+    for (std::size_t level = 2; level <= depth; ++level) {
+        scene.levelOffsets[level] = scene.levelOffsets[level - 1] + perLevel;
+    }
+
+    std::vector<Vector3<T>> clusterCenters(std::max<std::size_t>(config.clusterCount, 1));
+    for (auto& center : clusterCenters) {
+        center = Vector3<T>(unit(rng), unit(rng), unit(rng)) * (extent * T(0.8));
+    }
+    std::normal_distribution<T> spread(T(0), extent * T(0.05));
+    std::size_t rootCount = scene.levelOffsets[1];
+    std::size_t gridSide = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(rootCount)))));
+
+    scene.parents.resize(count);
+    scene.localTransforms.resize(count);
+    scene.localBounds.resize(count);
+    for (std::size_t level = 0; level < depth; ++level) {
+        for (std::size_t i = scene.levelOffsets[level]; i < scene.levelOffsets[level + 1]; ++i) {
+            Vector3<T> position;
+            if (level == 0) {
+                scene.parents[i] = -1;
+                switch (config.distribution) {
+                case SpatialDistribution::Uniform:
+                    position = Vector3<T>(unit(rng), unit(rng), unit(rng)) * extent;
+                    break;
+                case SpatialDistribution::Clustered: {
+                    const auto& center = clusterCenters[rng() % clusterCenters.size()];
+                    position = center + Vector3<T>(spread(rng), spread(rng), spread(rng));
+                    break;
+                }
+                case SpatialDistribution::Grid: {
+                    T step = T(2) * extent / static_cast<T>(gridSide);
+                    position = Vector3<T>(
+                        static_cast<T>(i % gridSide),
+                        static_cast<T>((i / gridSide) % gridSide),
+                        static_cast<T>(i / (gridSide * gridSide))) * step - Vector3<T>::one() * (extent - step * T(0.5));
+                    break;
+                }
+                }
+            } else {
+                std::size_t parentBegin = scene.levelOffsets[level - 1];
+                std::size_t parentCount = scene.levelOffsets[level] - parentBegin;
+                scene.parents[i] = static_cast<std::int32_t>(parentBegin + rng() % parentCount);
+                position = Vector3<T>(unit(rng), unit(rng), unit(rng)) * T(10);
+            }
+
+            Vector3<T> axis(unit(rng), unit(rng), unit(rng));
+            if (axis.lengthSquared() < T(1e-4)) axis = Vector3<T>::up();
+            Quaternion<T> rotation = Quaternion<T>::fromAxisAngle(axis.normalized(), unit(rng) * T(3.14159265));
+            scene.localTransforms[i] = Transform<T>(position, rotation, Vector3<T>::one());
+
+            Vector3<T> halfSize(size(rng), size(rng), size(rng));
+            scene.localBounds[i] = AABB<T>(Vector3<T>::zero() - halfSize, halfSize);
+        }
+    }
+
+    std::bernoulli_distribution moves(std::clamp(config.motionFraction, 0.0f, 1.0f));
+    for (std::size_t i = 0; i < count; ++i) {
+        if (moves(rng)) {
+            scene.movingObjects.push_back(static_cast<std::uint32_t>(i));
+            scene.velocities.push_back(Vector3<T>(unit(rng), unit(rng), unit(rng)) * T(5));
+        }
+    }
+
+    const T pi = T(3.14159265358979);
+    Matrix4x4<T> projection = Matrix4x4<T>::perspective(pi / 3, T(16) / T(9), T(0.1), extent * T(2));
+    for (std::size_t view = 0; view < config.viewCount; ++view) {
+        T angle = T(2) * pi * static_cast<T>(view) / static_cast<T>(config.viewCount);
+        Vector3<T> eye(std::cos(angle) * extent * T(0.5), extent * T(0.1), std::sin(angle) * extent * T(0.5));
+        scene.viewPositions.push_back(eye);
+        scene.frustums.emplace_back(projection * Matrix4x4<T>::lookAt(eye, Vector3<T>::zero(), Vector3<T>::up()));
+    }
+
+    scene.worldMatrices.resize(count);
+    scene.worldBounds.resize(count);
+    scene.visibility.resize(count);
+    scene.lods.resize(count * config.viewCount);
+    scene.drawLists.resize(config.viewCount);
+    return scene;
+}
+
+template<typename T>
+std::size_t SyntheticScene<T>::size() const noexcept {
+    return parents.size();
+}
+
+template<typename T>
+FrameBenchmark<T>::FrameBenchmark(const SceneConfig& config)
+    : config(config), sceneData(SyntheticScene<T>::generate(config)) {
+    // LOD switch distances grow geometrically across the world.
+    T distance = static_cast<T>(config.worldExtent) / T(16);
+    for (int level = 1; level < config.lodLevels; ++level) {
+        lodDistancesSquared.push_back(distance * distance);
+        distance *= T(2);
+    }
+}
+
+template<typename T>
+FrameTimings FrameBenchmark<T>::runFrame(ThreadPool& pool, T deltaTime) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+
+    FrameTimings timings;
+    auto start = Clock::now();
+    updateHierarchy(pool, deltaTime);
+    auto afterHierarchy = Clock::now();
+    updateBounds(pool);
+    auto afterBounds = Clock::now();
+    cull(pool);
+    auto afterCulling = Clock::now();
+    selectLods(pool);
+    auto afterLod = Clock::now();
+    sortDrawLists(pool);
+    auto end = Clock::now();
+
+    timings.hierarchy = elapsed(start, afterHierarchy);
+    timings.bounds = elapsed(afterHierarchy, afterBounds);
+    timings.culling = elapsed(afterBounds, afterCulling);
+    timings.lod = elapsed(afterCulling, afterLod);
+    timings.sort = elapsed(afterLod, end);
+    timings.total = elapsed(start, end);
+    return timings;
+}
+
+template<typename T>
+void FrameBenchmark<T>::updateHierarchy(ThreadPool& pool, T deltaTime) {
+    auto& scene = sceneData;
+    const T extent = static_cast<T>(config.worldExtent);
+    const Quaternion<T> spin = Quaternion<T>::fromAxisAngle(Vector3<T>::up(), deltaTime);
+
+    pool.parallelFor(0, scene.movingObjects.size(), 1024, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t m = begin; m < end; ++m) {
+            auto& local = scene.localTransforms[scene.movingObjects[m]];
+            auto& velocity = scene.velocities[m];
+            local.position += velocity * deltaTime;
+            for (int axis = 0; axis < 3; ++axis) {
+                if (std::abs(local.position[axis]) > extent) velocity[axis] = -velocity[axis];
+            }
+            // Renormalized every frame so rounding does not accumulate into scale.
+            local.rotation = (local.rotation * spin).normalized();
+        }
+    });
+
+    // Levels are processed in order so every parent is final before its children read it.
+    for (std::size_t level = 0; level + 1 < scene.levelOffsets.size(); ++level) {
+        pool.parallelFor(scene.levelOffsets[level], scene.levelOffsets[level + 1], 1024, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                Matrix4x4<T> local = scene.localTransforms[i].toMatrix();
+                std::int32_t parent = scene.parents[i];
+                scene.worldMatrices[i] = parent < 0 ? local : scene.worldMatrices[parent] * local;
+            }
+            RENDERFX_CHECK_FINITE_BATCH("FrameBenchmark::updateHierarchy",
+                                        scene.worldMatrices.begin() + begin, scene.worldMatrices.begin() + end);
+        });
+    }
+}
+
+template<typename T>
+void FrameBenchmark<T>::updateBounds(ThreadPool& pool) {
+    auto& scene = sceneData;
+    pool.parallelFor(0, scene.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            scene.worldBounds[i] = scene.localBounds[i].transformed(scene.worldMatrices[i]);
+        }
+        RENDERFX_CHECK_FINITE_BATCH("FrameBenchmark::updateBounds",
+                                    scene.worldBounds.begin() + begin, scene.worldBounds.begin() + end);
+    });
+}
+
+template<typename T>
+void FrameBenchmark<T>::cull(ThreadPool& pool) {
+    auto& scene = sceneData;
+    const std::size_t viewCount = scene.frustums.size();
+    pool.parallelFor(0, scene.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::uint8_t mask = 0;
+            for (std::size_t view = 0; view < viewCount; ++view) {
+                if (scene.frustums[view].intersects(scene.worldBounds[i])) mask |= std::uint8_t(1u << view);
+            }
+            scene.visibility[i] = mask;
+        }
+    });
+}
+
+template<typename T>
+void FrameBenchmark<T>::selectLods(ThreadPool& pool) {
+    auto& scene = sceneData;
+    const std::size_t count = scene.size();
+    const std::size_t viewCount = scene.viewPositions.size();
+    pool.parallelFor(0, count, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::uint8_t mask = scene.visibility[i];
+            if (mask == 0) continue;
+            Vector3<T> center = (scene.worldBounds[i].min + scene.worldBounds[i].max) * T(0.5);
+            for (std::size_t view = 0; view < viewCount; ++view) {
+                if (!(mask & (1u << view))) continue;
+                T distanceSquared = (center - scene.viewPositions[view]).lengthSquared();
+                std::uint8_t lod = 0;
+                while (lod < lodDistancesSquared.size() && distanceSquared > lodDistancesSquared[lod]) ++lod;
+                scene.lods[view * count + i] = lod;
+            }
+        }
+    });
+}
+
+template<typename T>
+void FrameBenchmark<T>::sortDrawLists(ThreadPool& pool) {
+    auto& scene = sceneData;
+    const std::size_t count = scene.size();
+    const T depthScale = T(0xFFFFFF) / (static_cast<T>(config.worldExtent) * T(4));
+
+    // Keys order by LOD first, then front to back; the low bits hold the object index.
+    pool.parallelFor(0, scene.drawLists.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t view = begin; view < end; ++view) {
+            auto& list = scene.drawLists[view];
+            list.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!(scene.visibility[i] & (1u << view))) continue;
+                Vector3<T> center = (scene.worldBounds[i].min + scene.worldBounds[i].max) * T(0.5);
+                T depth = std::min((center - scene.viewPositions[view]).length() * depthScale, T(0xFFFFFF));
+                std::uint64_t key = (std::uint64_t(scene.lods[view * count + i]) << 56) |
+                    (std::uint64_t(depth) << 32) | std::uint64_t(i);
+                list.push_back(key);
+            }
+            std::sort(list.begin(), list.end());
+        }
+    });
+}
+
+template<typename T>
+FrameBenchmarkReport FrameBenchmark<T>::run(unsigned threadCount, std::size_t warmupFrames, std::size_t measuredFrames) {
+    sceneData = SyntheticScene<T>::generate(config);
+    ThreadPool pool(threadCount);
+    const T deltaTime = T(1) / T(60);
+
+    for (std::size_t frame = 0; frame < warmupFrames; ++frame) {
+        runFrame(pool, deltaTime);
+    }
+
+    std::vector<double> hierarchy, bounds, culling, lod, sort, total;
+    double drawCount = 0;
+    for (std::size_t frame = 0; frame < measuredFrames; ++frame) {
+        FrameTimings timings = runFrame(pool, deltaTime);
+        hierarchy.push_back(timings.hierarchy);
+        bounds.push_back(timings.bounds);
+        culling.push_back(timings.culling);
+        lod.push_back(timings.lod);
+        sort.push_back(timings.sort);
+        total.push_back(timings.total);
+        for (const auto& list : sceneData.drawLists) drawCount += static_cast<double>(list.size());
+    }
+
+    FrameBenchmarkReport report;
+    report.threadCount = pool.threadCount();
+    report.frameCount = measuredFrames;
+    report.hierarchy = TimingStats::fromSamples(hierarchy);
+    report.bounds = TimingStats::fromSamples(bounds);
+    report.culling = TimingStats::fromSamples(culling);
+    report.lod = TimingStats::fromSamples(lod);
+    report.sort = TimingStats::fromSamples(sort);
+    report.total = TimingStats::fromSamples(total);
+    report.averageDrawCount = measuredFrames > 0 ? drawCount / measuredFrames : 0;
+    return report;
+}
+
+template<typename T>
+std::vector<FrameBenchmarkReport> FrameBenchmark<T>::runScaling(unsigned maxThreads, std::size_t warmupFrames, std::size_t measuredFrames) {
+    if (maxThreads == 0) maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<FrameBenchmarkReport> reports;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        reports.push_back(run(threads, warmupFrames, measuredFrames));
+    }
+    reports.push_back(run(maxThreads, warmupFrames, measuredFrames));
+    return reports;
+}
+
+template<typename T>
+const SyntheticScene<T>& FrameBenchmark<T>::scene() const noexcept {
+    return sceneData;
+}
+
+inline void printFrameBenchmarkReports(std::ostream& os, const std::vector<FrameBenchmarkReport>& reports) {
+    if (reports.empty()) return;
+    const double baseline = reports.front().total.mean;
+    auto flags = os.flags();
+    os << std::fixed << std::setprecision(3);
+
+    for (const auto& report : reports) {
+        os << "threads " << report.threadCount << ", " << report.frameCount << " frames, "
+           << std::setprecision(0) << report.averageDrawCount << " draws/frame" << std::setprecision(3) << "\n";
+        os << "  stage        mean      p50      p90      p99      max   (ms)\n";
+        auto row = [&os](const char* name, const TimingStats& stats) {
+            os << "  " << std::left << std::setw(9) << name << std::right
+               << std::setw(9) << stats.mean << std::setw(9) << stats.p50 << std::setw(9) << stats.p90
+               << std::setw(9) << stats.p99 << std::setw(9) << stats.max << "\n";
+        };
+        row("hierarchy", report.hierarchy);
+        row("bounds", report.bounds);
+        row("culling", report.culling);
+        row("lod", report.lod);
+        row("sort", report.sort);
+        row("total", report.total);
+    }
+
+    os << "scaling (mean total)\n";
+    for (const auto& report : reports) {
+        double speedup = report.total.mean > 0 ? baseline / report.total.mean : 0;
+        os << "  " << std::setw(3) << report.threadCount << " threads: " << std::setw(9) << report.total.mean
+           << " ms  x" << std::setprecision(2) << speedup << std::setprecision(3) << "\n";
+    }
+    os.flags(flags);
+}
+
+#endif // FRAMEBENCHMARK_INL
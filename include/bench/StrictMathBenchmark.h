@@ -0,0 +1,66 @@
+#ifndef STRICTMATHBENCHMARK_H
+#define STRICTMATHBENCHMARK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../math/Geometry.h"
+
+/**
+ * @brief Cost and error of one reproducible function against the C library.
+ */
+struct StrictFunctionTiming {
+    std::string function;     ///< The function, e.g. "sin".
+    double libraryNs = 0;     ///< Nanoseconds per call of the std:: function.
+    double strictNs = 0;      ///< Nanoseconds per call of the math::strict function.
+    double maxUlp = 0;        ///< Largest difference between the two, in double ULPs.
+    std::size_t differing = 0; ///< Inputs for which the results are not bit-identical.
+};
+
+/**
+ * @brief Cost of one math operation that uses the transcendental functions.
+ */
+struct StrictOperationTiming {
+    std::string operation; ///< The operation, e.g. "Quaternion::slerp".
+    double nsPerCall = 0;  ///< Nanoseconds per call in the mode this was compiled with.
+};
+
+/**
+ * @brief Result of runStrictMathBenchmark().
+ */
+struct StrictMathBenchmarkReport {
+    bool strictMode = false;                        ///< Whether RENDERFX_MATH_STRICT was defined.
+    std::size_t samples = 0;                        ///< Inputs per measurement.
+    std::vector<StrictFunctionTiming> functions;    ///< std:: against math::strict, double precision.
+    std::vector<StrictOperationTiming> operations;  ///< Float math operations through math::.
+};
+
+/**
+ * @brief Measures the cost of the strict float mode.
+ *
+ * The functions of math::strict are compared with the C library in the
+ * same build. The operations that depend on them (Quaternion::slerp,
+ * Quaternion::fromEulerAngles, Matrix4x4::rotationX/Y/Z,
+ * Matrix4x4::perspective and Vector3::slerp) use whichever implementation
+ * the build selected, so their cost in both modes is compared by running
+ * the benchmark from a build with and one without RENDERFX_MATH_STRICT.
+ *
+ * @param samples Number of random inputs; every measurement uses the same ones.
+ * @param seed The random seed.
+ * @return The timings.
+ */
+StrictMathBenchmarkReport runStrictMathBenchmark(std::size_t samples = 1 << 18, std::uint32_t seed = 1);
+
+/**
+ * @brief Prints a strict math benchmark report as a table.
+ *
+ * @param os The output stream.
+ * @param report The report to print.
+ */
+void printStrictMathBenchmark(std::ostream& os, const StrictMathBenchmarkReport& report);
+
+#include "StrictMathBenchmark.inl"
+
+#endif // STRICTMATHBENCHMARK_H
@@ -0,0 +1,140 @@
+#ifndef STRICTMATHBENCHMARK_INL
+#define STRICTMATHBENCHMARK_INL
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+namespace detail {
+
+/**
+ * @brief Maps a double to an integer that is ordered like the double, for ULP distances.
+ */
+inline std::int64_t orderedBits(double x) {
+    std::int64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits : bits;
+}
+
+/**
+ * @brief Runs fn(i) for every sample and returns the fastest of three passes in nanoseconds per call.
+ */
+template<typename Fn>
+double timePerCall(std::size_t samples, Fn fn) {
+    using Clock = std::chrono::steady_clock;
+    double best = 0;
+    for (int pass = 0; pass < 3; ++pass) {
+        double sum = 0;
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < samples; ++i) sum += static_cast<double>(fn(i));
+        auto end = Clock::now();
+        // Keep the results alive without timing a store per call.
+        volatile double sink = sum;
+        (void)sink;
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(samples);
+        best = pass == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+} // namespace detail
+
+inline StrictMathBenchmarkReport runStrictMathBenchmark(std::size_t samples, std::uint32_t seed) {
+    StrictMathBenchmarkReport report;
+    report.strictMode = math::strictMode;
+    report.samples = samples = std::max<std::size_t>(samples, 1);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> angle(-8.0, 8.0);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::vector<double> angles(samples), units(samples), ys(samples), xs(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        angles[i] = angle(rng);
+        units[i] = unit(rng);
+        ys[i] = unit(rng) * 100.0;
+        xs[i] = unit(rng) * 100.0;
+    }
+
+    auto compare = [&](const char* name, auto library, auto strict) {
+        StrictFunctionTiming timing;
+        timing.function = name;
+        timing.libraryNs = detail::timePerCall(samples, library);
+        timing.strictNs = detail::timePerCall(samples, strict);
+        for (std::size_t i = 0; i < samples; ++i) {
+            double a = library(i);
+            double b = strict(i);
+            std::int64_t distance = detail::orderedBits(a) - detail::orderedBits(b);
+            if (distance != 0) ++timing.differing;
+            timing.maxUlp = std::max(timing.maxUlp, std::fabs(static_cast<double>(distance)));
+        }
+        report.functions.push_back(timing);
+    };
+    compare("sin", [&](std::size_t i) { return std::sin(angles[i]); },
+            [&](std::size_t i) { return math::strict::sin(angles[i]); });
+    compare("cos", [&](std::size_t i) { return std::cos(angles[i]); },
+            [&](std::size_t i) { return math::strict::cos(angles[i]); });
+    compare("tan", [&](std::size_t i) { return std::tan(angles[i]); },
+            [&](std::size_t i) { return math::strict::tan(angles[i]); });
+    compare("asin", [&](std::size_t i) { return std::asin(units[i]); },
+            [&](std::size_t i) { return math::strict::asin(units[i]); });
+    compare("acos", [&](std::size_t i) { return std::acos(units[i]); },
+            [&](std::size_t i) { return math::strict::acos(units[i]); });
+    compare("atan2", [&](std::size_t i) { return std::atan2(ys[i], xs[i]); },
+            [&](std::size_t i) { return math::strict::atan2(ys[i], xs[i]); });
+
+    // Operation inputs, in float like the rest of the renderer.
+    std::vector<Quaternionf> from(samples), to(samples);
+    std::vector<Vector3f> directions(samples), targets(samples);
+    std::vector<float> factors(samples), floatAngles(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        Vector3f axis(static_cast<float>(unit(rng)), static_cast<float>(unit(rng)), static_cast<float>(unit(rng)));
+        if (axis.lengthSquared() < 1e-4f) axis = Vector3f::up();
+        from[i] = Quaternionf::fromAxisAngle(axis.normalized(), static_cast<float>(angle(rng)));
+        to[i] = Quaternionf::fromAxisAngle(axis.normalized(), static_cast<float>(angle(rng)));
+        directions[i] = Vector3f(static_cast<float>(unit(rng)), static_cast<float>(unit(rng)), 1.0f);
+        targets[i] = Vector3f(1.0f, static_cast<float>(unit(rng)), static_cast<float>(unit(rng)));
+        factors[i] = static_cast<float>(unit(rng) * 0.5 + 0.5);
+        floatAngles[i] = static_cast<float>(angles[i]);
+    }
+
+    auto measure = [&](const char* name, auto fn) {
+        report.operations.push_back({ name, detail::timePerCall(samples, fn) });
+    };
+    measure("Quaternion::slerp", [&](std::size_t i) { return Quaternionf::slerp(from[i], to[i], factors[i]).w; });
+    measure("Quaternion::fromEulerAngles", [&](std::size_t i) {
+        return Quaternionf::fromEulerAngles(floatAngles[i], factors[i], floatAngles[samples - 1 - i]).w;
+    });
+    measure("Matrix4x4::rotationX", [&](std::size_t i) { return Matrix4f::rotationX(floatAngles[i])(1, 1); });
+    measure("Matrix4x4::rotationY", [&](std::size_t i) { return Matrix4f::rotationY(floatAngles[i])(0, 0); });
+    measure("Matrix4x4::rotationZ", [&](std::size_t i) { return Matrix4f::rotationZ(floatAngles[i])(0, 0); });
+    measure("Matrix4x4::perspective", [&](std::size_t i) {
+        return Matrix4f::perspective(0.5f + factors[i], 16.0f / 9.0f, 0.1f, 1000.0f)(1, 1);
+    });
+    measure("Vector3::slerp", [&](std::size_t i) { return Vector3f::slerp(directions[i], targets[i], factors[i]).x; });
+    return report;
+}
+
+inline void printStrictMathBenchmark(std::ostream& os, const StrictMathBenchmarkReport& report) {
+    auto flags = os.flags();
+    os << std::fixed << std::setprecision(2);
+    os << "strict mode " << (report.strictMode ? "on" : "off") << ", " << report.samples << " samples\n";
+    os << "  function    std ns  strict ns   ratio   max ulp  differing\n";
+    for (const auto& timing : report.functions) {
+        double ratio = timing.libraryNs > 0 ? timing.strictNs / timing.libraryNs : 0;
+        os << "  " << std::left << std::setw(8) << timing.function << std::right
+           << std::setw(10) << timing.libraryNs << std::setw(11) << timing.strictNs
+           << std::setw(8) << ratio << std::setw(10) << std::setprecision(0) << timing.maxUlp
+           << std::setw(11) << timing.differing << std::setprecision(2) << "\n";
+    }
+    os << "  operation (float)                ns/call\n";
+    for (const auto& timing : report.operations) {
+        os << "  " << std::left << std::setw(30) << timing.operation << std::right << std::setw(9) << timing.nsPerCall << "\n";
+    }
+    os.flags(flags);
+}
+
+#endif // STRICTMATHBENCHMARK_INL
@@ -0,0 +1,94 @@
+#ifndef BINARYFILE_H
+#define BINARYFILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+
+/**
+ * @file BinaryFile.h
+ * @brief Helpers shared by the binary file formats.
+ *
+ * The formats store values in the byte order of the producer, record
+ * fileByteOrder in their header to detect foreign files, align sections
+ * to fileAlignment bytes so they can be used in place from a mapping, and
+ * protect their contents with checksum64().
+ */
+
+namespace detail {
+
+constexpr std::uint32_t fileByteOrder = 0x01020304u;
+constexpr std::size_t fileAlignment = 64;
+
+constexpr std::uint64_t alignFileOffset(std::uint64_t offset) noexcept {
+    return (offset + fileAlignment - 1) & ~std::uint64_t(fileAlignment - 1);
+}
+
+constexpr std::uint64_t rotateLeft(std::uint64_t value, int bits) noexcept {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// A 64-bit checksum that reads four independent words per step; it detects
+// truncated or corrupted files, it is not a cryptographic hash.
+inline std::uint64_t checksum64(const unsigned char* data, std::size_t size) noexcept {
+    constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    std::uint64_t lanes[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i + lane * 8, 8);
+            lanes[lane] = rotateLeft(lanes[lane] + word * prime2, 31) * prime1;
+        }
+    }
+    std::uint64_t hash = static_cast<std::uint64_t>(size) * prime1;
+    for (std::uint64_t lane : lanes) hash = rotateLeft(hash ^ lane, 27) * prime1 + prime2;
+    for (; i < size; ++i) hash = rotateLeft(hash ^ (data[i] * prime1), 11) * prime2;
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+// A name beside path that no other writer, in this process or another, picks.
+inline std::string temporaryFilePath(const std::string& path) {
+    static std::atomic<std::uint64_t> counter(0);
+    static const std::uint64_t processSalt = (std::uint64_t(std::random_device()()) << 32) ^ std::random_device()();
+    std::uint64_t unique = processSalt ^ (counter.fetch_add(1) * 0x9E3779B97F4A7C15ull);
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp", static_cast<unsigned long long>(unique));
+    return path + suffix;
+}
+
+// Writes beside the target under a unique name and renames, so readers never
+// map a partial file and concurrent writers never share a temporary file.
+inline bool writeFileAtomically(const std::string& path, const void* data, std::size_t size) {
+    std::string temporary;
+    std::FILE* out = nullptr;
+    // "x" fails if the file exists, so a leftover or colliding name is never reused.
+    for (int attempt = 0; attempt < 4 && out == nullptr; ++attempt) {
+        temporary = temporaryFilePath(path);
+        out = std::fopen(temporary.c_str(), "wbx");
+    }
+    if (out == nullptr) return false;
+    bool failed = std::fwrite(data, 1, size, out) != size;
+    failed = std::fclose(out) != 0 || failed;
+    std::error_code error;
+    if (!failed) std::filesystem::rename(temporary, path, error);
+    if (failed || error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+#endif // BINARYFILE_H
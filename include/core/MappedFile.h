@@ -0,0 +1,63 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * The mapping stays at the same address for the lifetime of the object,
+ * including across moves, so pointers into data() remain valid until the
+ * file is closed.
+ */
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+
+    /**
+     * @brief Maps a file.
+     *
+     * @param path Path of the file.
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps a file, replacing the current mapping.
+     *
+     * @param path Path of the file.
+     * @return False if the file cannot be opened or mapped; the object is then closed.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void close() noexcept;
+
+    /**
+     * @brief Hints that the whole mapping will be read soon.
+     */
+    void prefetch() const noexcept;
+
+    bool isOpen() const noexcept { return opened; }
+    const unsigned char* data() const noexcept { return mappedData; }
+    std::size_t size() const noexcept { return mappedSize; }
+
+private:
+    const unsigned char* mappedData = nullptr;
+    std::size_t mappedSize = 0;
+    bool opened = false;
+};
+
+#include "MappedFile.inl"
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,118 @@
+#ifndef MAPPEDFILE_INL
+#define MAPPEDFILE_INL
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+inline MappedFile::MappedFile(const std::string& path) {
+    if (!open(path)) throw std::runtime_error("Cannot map file " + path);
+}
+
+inline MappedFile::~MappedFile() {
+    close();
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mappedData(std::exchange(other.mappedData, nullptr)),
+      mappedSize(std::exchange(other.mappedSize, 0)),
+      opened(std::exchange(other.opened, false)) {}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mappedData = std::exchange(other.mappedData, nullptr);
+        mappedSize = std::exchange(other.mappedSize, 0);
+        opened = std::exchange(other.opened, false);
+    }
+    return *this;
+}
+
+inline bool MappedFile::open(const std::string& path) {
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart > 0) {
+        // The view keeps the mapping alive, so both handles can be closed.
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (view == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+        mappedData = static_cast<const unsigned char*>(view);
+        mappedSize = static_cast<std::size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        ::close(file);
+        return false;
+    }
+    if (status.st_size > 0) {
+        // The mapping stays valid after the descriptor is closed.
+        void* view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) {
+            ::close(file);
+            return false;
+        }
+        mappedData = static_cast<const unsigned char*>(view);
+        mappedSize = static_cast<std::size_t>(status.st_size);
+    }
+    ::close(file);
+#endif
+    opened = true;
+    return true;
+}
+
+inline void MappedFile::close() noexcept {
+    if (mappedData != nullptr) {
+#if defined(_WIN32)
+        UnmapViewOfFile(mappedData);
+#else
+        munmap(const_cast<unsigned char*>(mappedData), mappedSize);
+#endif
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
+
+inline void MappedFile::prefetch() const noexcept {
+    if (mappedData == nullptr) return;
+#if defined(_WIN32)
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<unsigned char*>(mappedData);
+    range.NumberOfBytes = mappedSize;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise(const_cast<unsigned char*>(mappedData), mappedSize, MADV_WILLNEED);
+#endif
+}
+
+#endif // MAPPEDFILE_INL
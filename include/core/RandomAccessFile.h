@@ -0,0 +1,65 @@
+#ifndef RANDOMACCESSFILE_H
+#define RANDOMACCESSFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief A read-only file that is read at explicit offsets.
+ *
+ * readAt() does not use a shared file position, so any number of threads
+ * may read from one object concurrently (pread on POSIX systems).
+ */
+class RandomAccessFile {
+public:
+    RandomAccessFile() noexcept = default;
+
+    /**
+     * @brief Opens a file.
+     *
+     * @param path Path of the file.
+     * @throws std::runtime_error If the file cannot be opened.
+     */
+    explicit RandomAccessFile(const std::string& path);
+
+    ~RandomAccessFile();
+
+    RandomAccessFile(RandomAccessFile&& other) noexcept;
+    RandomAccessFile& operator=(RandomAccessFile&& other) noexcept;
+    RandomAccessFile(const RandomAccessFile&) = delete;
+    RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+
+    /**
+     * @brief Opens a file, closing the current one.
+     *
+     * @param path Path of the file.
+     * @return False if the file cannot be opened.
+     */
+    bool open(const std::string& path);
+
+    void close() noexcept;
+
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Reads a range of the file.
+     *
+     * @param buffer Receives the bytes.
+     * @param size Number of bytes to read.
+     * @param offset Offset of the first byte in the file.
+     * @return False if fewer than size bytes could be read.
+     */
+    bool readAt(void* buffer, std::size_t size, std::uint64_t offset) const noexcept;
+
+private:
+#if defined(_WIN32)
+    void* handle = nullptr;
+#else
+    int descriptor = -1;
+#endif
+};
+
+#include "RandomAccessFile.inl"
+
+#endif // RANDOMACCESSFILE_H
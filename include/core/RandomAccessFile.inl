@@ -0,0 +1,120 @@
+#ifndef RANDOMACCESSFILE_INL
+#define RANDOMACCESSFILE_INL
+
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+inline RandomAccessFile::RandomAccessFile(const std::string& path) {
+    if (!open(path)) throw std::runtime_error("Cannot open file " + path);
+}
+
+inline RandomAccessFile::~RandomAccessFile() {
+    close();
+}
+
+#if defined(_WIN32)
+
+inline RandomAccessFile::RandomAccessFile(RandomAccessFile&& other) noexcept
+    : handle(std::exchange(other.handle, nullptr)) {}
+
+inline RandomAccessFile& RandomAccessFile::operator=(RandomAccessFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+inline bool RandomAccessFile::open(const std::string& path) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    handle = file;
+    return true;
+}
+
+inline void RandomAccessFile::close() noexcept {
+    if (handle != nullptr) CloseHandle(static_cast<HANDLE>(handle));
+    handle = nullptr;
+}
+
+inline bool RandomAccessFile::isOpen() const noexcept {
+    return handle != nullptr;
+}
+
+inline bool RandomAccessFile::readAt(void* buffer, std::size_t size, std::uint64_t offset) const noexcept {
+    unsigned char* out = static_cast<unsigned char*>(buffer);
+    while (size > 0) {
+        // An OVERLAPPED offset makes the read independent of the file pointer.
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD request = static_cast<DWORD>(size < 0x40000000u ? size : 0x40000000u);
+        DWORD read = 0;
+        if (!ReadFile(static_cast<HANDLE>(handle), out, request, &read, &overlapped) || read == 0) return false;
+        out += read;
+        size -= read;
+        offset += read;
+    }
+    return true;
+}
+
+#else
+
+inline RandomAccessFile::RandomAccessFile(RandomAccessFile&& other) noexcept
+    : descriptor(std::exchange(other.descriptor, -1)) {}
+
+inline RandomAccessFile& RandomAccessFile::operator=(RandomAccessFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        descriptor = std::exchange(other.descriptor, -1);
+    }
+    return *this;
+}
+
+inline bool RandomAccessFile::open(const std::string& path) {
+    close();
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    return descriptor >= 0;
+}
+
+inline void RandomAccessFile::close() noexcept {
+    if (descriptor >= 0) ::close(descriptor);
+    descriptor = -1;
+}
+
+inline bool RandomAccessFile::isOpen() const noexcept {
+    return descriptor >= 0;
+}
+
+inline bool RandomAccessFile::readAt(void* buffer, std::size_t size, std::uint64_t offset) const noexcept {
+    unsigned char* out = static_cast<unsigned char*>(buffer);
+    while (size > 0) {
+        ssize_t read = pread(descriptor, out, size, static_cast<off_t>(offset));
+        if (read < 0 && errno == EINTR) continue;
+        if (read <= 0) return false;
+        out += read;
+        size -= static_cast<std::size_t>(read);
+        offset += static_cast<std::uint64_t>(read);
+    }
+    return true;
+}
+
+#endif
+
+#endif // RANDOMACCESSFILE_INL
@@ -0,0 +1,84 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A fixed-size pool of worker threads.
+ *
+ * The pool owns `threadCount() - 1` workers; the thread that calls
+ * parallelFor() takes part in the work as well, so a pool created with a
+ * single thread runs everything inline without any synchronization.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Creates a pool that runs work on the given number of threads.
+     *
+     * @param threadCount The total number of threads, including the caller. Zero selects the hardware concurrency.
+     */
+    explicit ThreadPool(unsigned threadCount = 0);
+
+    /**
+     * @brief Joins all worker threads. Pending tasks are finished first.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the number of threads that take part in parallelFor().
+     *
+     * @return The worker count plus the calling thread.
+     */
+    unsigned threadCount() const noexcept;
+
+    /**
+     * @brief Splits [begin, end) into chunks and processes them on all threads.
+     *
+     * The call blocks until every chunk is done. Chunks are handed out in
+     * ascending order, but their completion order is unspecified.
+     *
+     * @param begin The first index.
+     * @param end One past the last index.
+     * @param grain The number of indices per chunk (at least one).
+     * @param fn Callable invoked as fn(chunkBegin, chunkEnd).
+     */
+    template<typename Fn>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn);
+
+    /**
+     * @brief Queues a task for asynchronous execution on a worker.
+     *
+     * With a single-threaded pool the task runs immediately on the caller.
+     *
+     * @param fn The task to run.
+     * @return A future holding the task's result.
+     */
+    template<typename Fn>
+    std::future<std::invoke_result_t<Fn>> submit(Fn&& fn);
+
+private:
+    void workerLoop();
+    void enqueue(std::function<void()> job);
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    bool stopping = false;
+};
+
+#include "ThreadPool.inl"
+
+#endif // THREADPOOL_H
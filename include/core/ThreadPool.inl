@@ -0,0 +1,123 @@
+#ifndef THREADPOOL_INL
+#define THREADPOOL_INL
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+inline ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+inline unsigned ThreadPool::threadCount() const noexcept {
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+inline void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+inline void ThreadPool::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+template<typename Fn>
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn) {
+    if (end <= begin) return;
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunkCount = (end - begin + grain - 1) / grain;
+
+    if (workers.empty() || chunkCount == 1) {
+        for (std::size_t first = begin; first < end; first += grain) {
+            fn(first, std::min(first + grain, end));
+        }
+        return;
+    }
+
+    // Helpers may be picked up by a worker after the loop has finished, so the
+    // shared state outlives this call. The callable itself is only touched
+    // while unclaimed chunks remain, i.e. while the caller is still waiting.
+    struct State {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> finished{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    auto* body = &fn;
+
+    auto drain = [state, body, begin, end, grain, chunkCount] {
+        for (;;) {
+            std::size_t chunk = state->next.fetch_add(1);
+            if (chunk >= chunkCount) return;
+            std::size_t first = begin + chunk * grain;
+            try {
+                (*body)(first, std::min(first + grain, end));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            if (state->finished.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    std::size_t helpers = std::min<std::size_t>(workers.size(), chunkCount - 1);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        enqueue(drain);
+    }
+    drain();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&] { return state->finished.load() == chunkCount; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+template<typename Fn>
+std::future<std::invoke_result_t<Fn>> ThreadPool::submit(Fn&& fn) {
+    using Result = std::invoke_result_t<Fn>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+    std::future<Result> result = task->get_future();
+    if (workers.empty()) {
+        (*task)();
+    } else {
+        enqueue([task] { (*task)(); });
+    }
+    return result;
+}
+
+#endif // THREADPOOL_INL
@@ -0,0 +1,304 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include "MathFunctions.h"
+
+/**
+ * @file Fixed.h
+ * @brief Fixed-point scalars with bit-exact results on every platform.
+ *
+ * Fixed16 (Q16.16) and Fixed32 (Q32.32) are drop-in scalar types for the
+ * math templates, e.g. Vector3<Fixed16> or Quaternion<Fixed32>, for
+ * simulations that must produce identical results on all compilers and
+ * CPUs, such as lockstep networking. All operations are integer only:
+ *
+ * - +, - and * wrap around on overflow; * rounds to nearest, ties up.
+ * - / rounds to nearest and saturates on overflow and division by zero.
+ * - sqrt() and inverseSqrt() use a digit-by-digit integer square root.
+ * - sin(), cos(), atan2() and the functions derived from them use CORDIC
+ *   with a fixed table, after reducing the angle with a 61-bit pi/2.
+ *
+ * Conversions from floating-point values round to nearest and are exact
+ * for constants; convert run-time floats only at the boundary of the
+ * simulation. The fixed-point functions are found by argument-dependent
+ * lookup, which the functions in namespace math forward to.
+ */
+
+namespace detail {
+
+/**
+ * @brief A 128-bit unsigned integer for compilers without a built-in one.
+ *
+ * Provides the operators the fixed-point algorithms use; results are the
+ * same as with unsigned __int128.
+ */
+struct UInt128 {
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+
+    constexpr UInt128() noexcept = default;
+    constexpr UInt128(std::uint64_t value) noexcept : high(0), low(value) {}
+    constexpr UInt128(std::uint64_t high, std::uint64_t low) noexcept : high(high), low(low) {}
+
+    explicit constexpr operator std::uint64_t() const noexcept { return low; }
+};
+
+#if defined(__SIZEOF_INT128__)
+// __extension__ keeps -Wpedantic quiet about the non-standard type.
+__extension__ typedef unsigned __int128 FixedUInt128;
+#else
+using FixedUInt128 = UInt128;
+#endif
+
+/**
+ * @brief The unsigned type that holds products of two fixed-point values.
+ */
+template<typename Storage>
+struct FixedWide;
+
+template<>
+struct FixedWide<std::int32_t> {
+    using type = std::uint64_t;
+};
+
+template<>
+struct FixedWide<std::int64_t> {
+    using type = FixedUInt128;
+};
+
+} // namespace detail
+
+/**
+ * @brief A signed binary fixed-point number.
+ *
+ * @tparam Storage The signed integer that holds the raw value: std::int32_t or std::int64_t.
+ * @tparam FractionBits Number of fraction bits.
+ */
+template<typename Storage, int FractionBits>
+class Fixed {
+public:
+    static_assert(std::is_same<Storage, std::int32_t>::value || std::is_same<Storage, std::int64_t>::value,
+                  "Fixed requires std::int32_t or std::int64_t storage");
+    static_assert(FractionBits > 0 && FractionBits < int(sizeof(Storage) * 8) - 1, "Invalid number of fraction bits");
+
+    using storage_type = Storage;
+    static constexpr int fractionBits = FractionBits;
+
+    /**
+     * @brief Creates zero.
+     */
+    constexpr Fixed() noexcept : value(0) {}
+
+    /**
+     * @brief Converts an integer or floating-point value.
+     *
+     * Integers wrap around if they do not fit; floating-point values round
+     * to nearest with halves away from zero, saturate, and NaN becomes zero.
+     *
+     * @param number The value.
+     */
+    template<typename U, typename = std::enable_if_t<std::is_arithmetic<U>::value>>
+    constexpr Fixed(U number) noexcept;
+
+    /**
+     * @brief Creates a value from its raw representation.
+     *
+     * @param raw The value times 2^FractionBits.
+     * @return The value.
+     */
+    static constexpr Fixed fromRaw(Storage raw) noexcept;
+
+    /**
+     * @brief Gets the raw representation.
+     *
+     * @return The value times 2^FractionBits.
+     */
+    constexpr Storage raw() const noexcept { return value; }
+
+    /**
+     * @brief Converts to an integer (truncating toward negative infinity) or floating-point value.
+     *
+     * @return The converted value.
+     */
+    template<typename U, typename = std::enable_if_t<std::is_arithmetic<U>::value>>
+    explicit constexpr operator U() const noexcept;
+
+    /**
+     * @brief Fixed-point values are always finite; used by MathDebug.h.
+     *
+     * @return True.
+     */
+    constexpr bool isFinite() const noexcept { return true; }
+
+    constexpr Fixed operator-() const noexcept;
+    constexpr Fixed operator+() const noexcept { return *this; }
+    constexpr Fixed& operator+=(Fixed other) noexcept;
+    constexpr Fixed& operator-=(Fixed other) noexcept;
+    constexpr Fixed& operator*=(Fixed other) noexcept;
+    constexpr Fixed& operator/=(Fixed other) noexcept;
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) noexcept { return a += b; }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) noexcept { return a -= b; }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) noexcept { return a *= b; }
+    friend constexpr Fixed operator/(Fixed a, Fixed b) noexcept { return a /= b; }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) noexcept { return a.value == b.value; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) noexcept { return a.value != b.value; }
+    friend constexpr bool operator<(Fixed a, Fixed b) noexcept { return a.value < b.value; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) noexcept { return a.value <= b.value; }
+    friend constexpr bool operator>(Fixed a, Fixed b) noexcept { return a.value > b.value; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) noexcept { return a.value >= b.value; }
+
+    /// @name Deterministic functions, found by argument-dependent lookup
+    /// @{
+
+    /**
+     * @brief Computes the square root, rounded to nearest.
+     *
+     * @param x The value; negative values give zero.
+     * @return The square root.
+     */
+    friend Fixed sqrt(Fixed x) noexcept { return x.squareRoot(); }
+
+    /**
+     * @brief Computes one over the square root.
+     *
+     * @param x The value; non-positive values give the largest value.
+     * @return The inverse square root.
+     */
+    friend Fixed inverseSqrt(Fixed x) noexcept { return x.inverseSquareRoot(); }
+
+    friend Fixed sin(Fixed x) noexcept { Fixed s, c; x.sineCosine(s, c); return s; }
+    friend Fixed cos(Fixed x) noexcept { Fixed s, c; x.sineCosine(s, c); return c; }
+    friend Fixed tan(Fixed x) noexcept { Fixed s, c; x.sineCosine(s, c); return s / c; }
+
+    /**
+     * @brief Computes the sine and the cosine with one reduction.
+     *
+     * @param x The angle in radians.
+     * @param s Receives the sine.
+     * @param c Receives the cosine.
+     */
+    friend void sincos(Fixed x, Fixed& s, Fixed& c) noexcept { x.sineCosine(s, c); }
+
+    /**
+     * @brief Computes the angle of a vector.
+     *
+     * @param y The y component.
+     * @param x The x component.
+     * @return The angle in [-pi, pi]; zero for the zero vector.
+     */
+    friend Fixed atan2(Fixed y, Fixed x) noexcept { return angleOf(y, x); }
+
+    /// Arguments outside [-1, 1] are clamped.
+    friend Fixed asin(Fixed x) noexcept { return angleOf(clampUnit(x), cosineOf(x)); }
+
+    /// Arguments outside [-1, 1] are clamped.
+    friend Fixed acos(Fixed x) noexcept { return angleOf(cosineOf(x), clampUnit(x)); }
+
+    /// @}
+
+    friend std::ostream& operator<<(std::ostream& os, Fixed x) { return os << static_cast<double>(x); }
+
+private:
+    Storage value;
+
+    Fixed squareRoot() const noexcept;
+    Fixed inverseSquareRoot() const noexcept;
+    void sineCosine(Fixed& s, Fixed& c) const noexcept;
+    static Fixed angleOf(Fixed y, Fixed x) noexcept;
+    static Fixed cosineOf(Fixed sine) noexcept;
+    static constexpr Fixed clampUnit(Fixed x) noexcept { return x < Fixed(-1) ? Fixed(-1) : (x > Fixed(1) ? Fixed(1) : x); }
+};
+
+/// @name Batch kernels
+/// Each element is bit-identical to the scalar operators; Q16.16 uses SSE4.1 or AVX2 when available.
+/// @{
+
+/**
+ * @brief Multiplies arrays element by element: out[i] = a[i] * b[i].
+ *
+ * @param a The first factors.
+ * @param b The second factors.
+ * @param out Receives count products; may alias a or b.
+ * @param count Number of elements.
+ */
+template<typename Storage, int FractionBits>
+void fixedMultiply(const Fixed<Storage, FractionBits>* a, const Fixed<Storage, FractionBits>* b,
+                   Fixed<Storage, FractionBits>* out, std::size_t count) noexcept;
+
+/**
+ * @brief Computes out[i] = a[i] * b[i] + c[i].
+ *
+ * @param a The first factors.
+ * @param b The second factors.
+ * @param c The addends.
+ * @param out Receives count results; may alias the inputs.
+ * @param count Number of elements.
+ */
+template<typename Storage, int FractionBits>
+void fixedMultiplyAdd(const Fixed<Storage, FractionBits>* a, const Fixed<Storage, FractionBits>* b,
+                      const Fixed<Storage, FractionBits>* c, Fixed<Storage, FractionBits>* out, std::size_t count) noexcept;
+
+/**
+ * @brief Computes dot products of structure-of-arrays vectors, as Vector3::dot() does.
+ *
+ * @param ax The x components of the first vectors.
+ * @param ay The y components of the first vectors.
+ * @param az The z components of the first vectors.
+ * @param bx The x components of the second vectors.
+ * @param by The y components of the second vectors.
+ * @param bz The z components of the second vectors.
+ * @param out Receives count dot products.
+ * @param count Number of elements.
+ */
+template<typename Storage, int FractionBits>
+void fixedDot3(const Fixed<Storage, FractionBits>* ax, const Fixed<Storage, FractionBits>* ay, const Fixed<Storage, FractionBits>* az,
+               const Fixed<Storage, FractionBits>* bx, const Fixed<Storage, FractionBits>* by, const Fixed<Storage, FractionBits>* bz,
+               Fixed<Storage, FractionBits>* out, std::size_t count) noexcept;
+
+/// @}
+
+namespace std {
+
+/**
+ * @brief Limits of the fixed-point types; epsilon() is the smallest step.
+ */
+template<typename Storage, int FractionBits>
+class numeric_limits<Fixed<Storage, FractionBits>> {
+public:
+    using type = Fixed<Storage, FractionBits>;
+
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = true;
+    static constexpr bool has_infinity = false;
+    static constexpr bool has_quiet_NaN = false;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = true;
+    static constexpr int digits = std::numeric_limits<Storage>::digits;
+    static constexpr int radix = 2;
+
+    static constexpr type min() noexcept { return type::fromRaw(1); }
+    static constexpr type lowest() noexcept { return type::fromRaw(std::numeric_limits<Storage>::min()); }
+    static constexpr type max() noexcept { return type::fromRaw(std::numeric_limits<Storage>::max()); }
+    static constexpr type epsilon() noexcept { return type::fromRaw(1); }
+    static constexpr type round_error() noexcept { return type::fromRaw(Storage(1) << (FractionBits - 1)); }
+};
+
+} // namespace std
+
+// Commonly used types
+using Fixed16 = Fixed<std::int32_t, 16>; ///< Q16.16: range +-32768, step 1.5e-5.
+using Fixed32 = Fixed<std::int64_t, 32>; ///< Q32.32: range +-2.1e9, step 2.3e-10.
+
+#include "Fixed.inl"
+
+#endif // FIXED_H
@@ -0,0 +1,521 @@
+#ifndef FIXED_INL
+#define FIXED_INL
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RENDERFX_FIXED_SIMD 2
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define RENDERFX_FIXED_SIMD 1
+#else
+#define RENDERFX_FIXED_SIMD 0
+#endif
+
+static_assert(sizeof(Fixed16) == sizeof(std::int32_t) && sizeof(Fixed32) == sizeof(std::int64_t),
+              "Fixed must have the layout of its storage");
+
+namespace detail {
+
+constexpr bool operator==(const UInt128& a, const UInt128& b) noexcept { return a.high == b.high && a.low == b.low; }
+constexpr bool operator!=(const UInt128& a, const UInt128& b) noexcept { return !(a == b); }
+constexpr bool operator<(const UInt128& a, const UInt128& b) noexcept { return a.high != b.high ? a.high < b.high : a.low < b.low; }
+constexpr bool operator>(const UInt128& a, const UInt128& b) noexcept { return b < a; }
+constexpr bool operator<=(const UInt128& a, const UInt128& b) noexcept { return !(b < a); }
+constexpr bool operator>=(const UInt128& a, const UInt128& b) noexcept { return !(a < b); }
+
+constexpr UInt128 operator~(const UInt128& a) noexcept { return UInt128(~a.high, ~a.low); }
+constexpr UInt128 operator|(const UInt128& a, const UInt128& b) noexcept { return UInt128(a.high | b.high, a.low | b.low); }
+
+constexpr UInt128 operator+(const UInt128& a, const UInt128& b) noexcept {
+    std::uint64_t low = a.low + b.low;
+    return UInt128(a.high + b.high + (low < a.low ? 1 : 0), low);
+}
+
+constexpr UInt128 operator-(const UInt128& a, const UInt128& b) noexcept {
+    return UInt128(a.high - b.high - (a.low < b.low ? 1 : 0), a.low - b.low);
+}
+
+constexpr UInt128 operator<<(const UInt128& a, int n) noexcept {
+    if (n == 0) return a;
+    if (n >= 64) return UInt128(a.low << (n - 64), 0);
+    return UInt128((a.high << n) | (a.low >> (64 - n)), a.low << n);
+}
+
+constexpr UInt128 operator>>(const UInt128& a, int n) noexcept {
+    if (n == 0) return a;
+    if (n >= 64) return UInt128(0, a.high >> (n - 64));
+    return UInt128(a.high >> n, (a.low >> n) | (a.high << (64 - n)));
+}
+
+constexpr UInt128 operator*(const UInt128& a, const UInt128& b) noexcept {
+    // Low 128 bits of the product, from 32-bit partial products of the low words.
+    std::uint64_t a0 = a.low & 0xFFFFFFFF, a1 = a.low >> 32;
+    std::uint64_t b0 = b.low & 0xFFFFFFFF, b1 = b.low >> 32;
+    std::uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    std::uint64_t middle = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+    std::uint64_t low = (middle << 32) | (p00 & 0xFFFFFFFF);
+    std::uint64_t high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+    return UInt128(high + a.high * b.low + a.low * b.high, low);
+}
+
+constexpr UInt128 operator/(const UInt128& a, const UInt128& b) noexcept {
+    // Restoring long division, one bit at a time.
+    UInt128 quotient;
+    UInt128 remainder;
+    for (int bit = 127; bit >= 0; --bit) {
+        remainder = (remainder << 1) | UInt128((bit >= 64 ? a.high >> (bit - 64) : a.low >> bit) & 1);
+        if (remainder >= b) {
+            remainder = remainder - b;
+            if (bit >= 64) quotient.high |= std::uint64_t(1) << (bit - 64);
+            else quotient.low |= std::uint64_t(1) << bit;
+        }
+    }
+    return quotient;
+}
+
+// Shifts right rounding toward negative infinity without relying on the
+// implementation-defined shift of negative values.
+constexpr std::int64_t shiftRightFloor(std::int64_t value, int n) noexcept {
+    return value >= 0 ? value >> n : ~(~value >> n);
+}
+
+// Sign-extends a raw value to the wide type, so products wrap like signed ones.
+template<typename Wide, typename Storage>
+constexpr Wide toFixedWide(Storage value) noexcept {
+    Wide wide = Wide(static_cast<std::uint64_t>(static_cast<std::int64_t>(value)));
+    return value < 0 ? (wide | ~Wide(~std::uint64_t(0))) : wide;
+}
+
+template<typename Storage>
+constexpr std::uint64_t fixedMagnitude(Storage value) noexcept {
+    std::uint64_t bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+    return value < 0 ? std::uint64_t(0) - bits : bits;
+}
+
+// Integer square root, rounded to nearest.
+template<typename Wide>
+constexpr Wide roundedSqrt(Wide n) noexcept {
+    Wide result = 0;
+    Wide bit = Wide(1) << int(sizeof(Wide) * 8 - 2);
+    while (bit > n) bit = bit >> 2;
+    while (bit != Wide(0)) {
+        if (n >= result + bit) {
+            n = n - (result + bit);
+            result = (result >> 1) + bit;
+        } else {
+            result = result >> 1;
+        }
+        bit = bit >> 2;
+    }
+    return n > result ? result + Wide(1) : result;
+}
+
+// CORDIC works in Q2.61. The constants are rounded from exact values, so
+// every platform uses the same bits.
+constexpr int cordicFractionBits = 61;
+constexpr std::int64_t cordicGain = 1400229935014726477ll;   // prod 1 / sqrt(1 + 4^-i)
+constexpr std::int64_t cordicHalfPi = 3622009729038561421ll;
+constexpr std::int64_t cordicPi = 7244019458077122842ll;
+constexpr std::int64_t cordicAngles[cordicFractionBits] = {  // atan(2^-i)
+    1811004864519280711ll, 1069098597953152948ll, 564882337777596249ll,
+    286743094836456889ll, 143927976672616092ll, 72034151524184357ll,
+    36025865417378411ll, 18014032019027246ll, 9007153442175927ll,
+    4503593900760542ll, 2251799097857775ll, 1125899817364151ll,
+    562949942236502ll, 281474975312555ll, 140737488180565ll,
+    70368744155819ll, 35184372086101ll, 17592186044075ll,
+    8796093022165ll, 4398046511099ll, 2199023255551ll,
+    1099511627776ll, 549755813888ll, 274877906944ll,
+    137438953472ll, 68719476736ll, 34359738368ll,
+    17179869184ll, 8589934592ll, 4294967296ll,
+    2147483648ll, 1073741824ll, 536870912ll,
+    268435456ll, 134217728ll, 67108864ll,
+    33554432ll, 16777216ll, 8388608ll,
+    4194304ll, 2097152ll, 1048576ll,
+    524288ll, 262144ll, 131072ll,
+    65536ll, 32768ll, 16384ll,
+    8192ll, 4096ll, 2048ll,
+    1024ll, 512ll, 256ll,
+    128ll, 64ll, 32ll,
+    16ll, 8ll, 4ll,
+    2ll,
+};
+
+// Enough iterations for the result to be exact to the last fraction bit.
+constexpr int cordicIterations(int fractionBits) noexcept {
+    return fractionBits + 4 < cordicFractionBits ? fractionBits + 4 : cordicFractionBits;
+}
+
+constexpr std::int64_t roundFromCordic(std::int64_t value, int fractionBits) noexcept {
+    int shift = cordicFractionBits - fractionBits;
+    return shift == 0 ? value : shiftRightFloor(value + (std::int64_t(1) << (shift - 1)), shift);
+}
+
+// Rotates (gain, 0) by an angle in [-pi/4, pi/4].
+// Rounds half away from zero. Adding 0.5 and truncating is wrong for
+// values just below one half and can overflow the integer cast.
+constexpr double roundHalfAway(double x) noexcept {
+    constexpr double exact = 4503599627370496.0; // 2^52: every larger double is an integer
+    if (!(x > -exact && x < exact)) return x;
+    double truncated = static_cast<double>(static_cast<std::int64_t>(x));
+    double fraction = x - truncated;
+    if (fraction >= 0.5) return truncated + 1;
+    if (fraction <= -0.5) return truncated - 1;
+    return truncated;
+}
+
+inline void cordicRotate(std::int64_t angle, int iterations, std::int64_t& s, std::int64_t& c) noexcept {
+    std::int64_t x = cordicGain;
+    std::int64_t y = 0;
+    for (int i = 0; i < iterations; ++i) {
+        std::int64_t dx = shiftRightFloor(y, i);
+        std::int64_t dy = shiftRightFloor(x, i);
+        if (angle >= 0) {
+            x -= dx;
+            y += dy;
+            angle -= cordicAngles[i];
+        } else {
+            x += dx;
+            y -= dy;
+            angle += cordicAngles[i];
+        }
+    }
+    s = y;
+    c = x;
+}
+
+} // namespace detail
+
+template<typename Storage, int FractionBits>
+template<typename U, typename>
+constexpr Fixed<Storage, FractionBits>::Fixed(U number) noexcept : value(0) {
+    using Unsigned = std::make_unsigned_t<Storage>;
+    if constexpr (std::is_integral<U>::value) {
+        value = static_cast<Storage>(static_cast<Unsigned>(number) << FractionBits);
+    } else {
+        // Scaling by a power of two is exact; only the final rounding loses
+        // bits. The rounded value is clamped before the cast, which is
+        // undefined outside the range of Storage. The limit is 2^(bits - 1),
+        // as the maximum itself is not representable as a double.
+        constexpr double limit = double(Unsigned(1) << (sizeof(Storage) * 8 - 1));
+        double scaled = static_cast<double>(number) * double(Unsigned(1) << FractionBits);
+        if (scaled != scaled) {
+            value = 0;
+            return;
+        }
+        double rounded = detail::roundHalfAway(scaled);
+        if (rounded >= limit) {
+            value = std::numeric_limits<Storage>::max();
+        } else if (rounded <= -limit) {
+            value = std::numeric_limits<Storage>::min();
+        } else {
+            value = static_cast<Storage>(rounded);
+        }
+    }
+}
+
+template<typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits> Fixed<Storage, FractionBits>::fromRaw(Storage raw) noexcept {
+    Fixed result;
+    result.value = raw;
+    return result;
+}
+
+template<typename Storage, int FractionBits>
+template<typename U, typename>
+constexpr Fixed<Storage, FractionBits>::operator U() const noexcept {
+    if constexpr (std::is_integral<U>::value) {
+        return static_cast<U>(detail::shiftRightFloor(value, FractionBits));
+    } else {
+        return static_cast<U>(static_cast<double>(value) * (1.0 / double(std::uint64_t(1) << FractionBits)));
+    }
+}
+
+template<typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits> Fixed<Storage, FractionBits>::operator-() const noexcept {
+    using Unsigned = std::make_unsigned_t<Storage>;
+    return fromRaw(static_cast<Storage>(Unsigned(0) - static_cast<Unsigned>(value)));
+}
+
+template<typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits>& Fixed<Storage, FractionBits>::operator+=(Fixed other) noexcept {
+    using Unsigned = std::make_unsigned_t<Storage>;
+    value = static_cast<Storage>(static_cast<Unsigned>(value) + static_cast<Unsigned>(other.value));
+    return *this;
+}
+
+template<typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits>& Fixed<Storage, FractionBits>::operator-=(Fixed other) noexcept {
+    using Unsigned = std::make_unsigned_t<Storage>;
+    value = static_cast<Storage>(static_cast<Unsigned>(value) - static_cast<Unsigned>(other.value));
+    return *this;
+}
+
+template<typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits>& Fixed<Storage, FractionBits>::operator*=(Fixed other) noexcept {
+    using Wide = typename detail::FixedWide<Storage>::type;
+    using Unsigned = std::make_unsigned_t<Storage>;
+    Wide product = detail::toFixedWide<Wide>(value) * detail::toFixedWide<Wide>(other.value) + (Wide(1) << (FractionBits - 1));
+    value = static_cast<Storage>(static_cast<Unsigned>(static_cast<std::uint64_t>(product >> FractionBits)));
+    return *this;
+}
+
+template<typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits>& Fixed<Storage, FractionBits>::operator/=(Fixed other) noexcept {
+    using Wide = typename detail::FixedWide<Storage>::type;
+    using Unsigned = std::make_unsigned_t<Storage>;
+    if (other.value == 0) {
+        value = value > 0 ? std::numeric_limits<Storage>::max() : (value < 0 ? std::numeric_limits<Storage>::min() : 0);
+        return *this;
+    }
+    bool negative = (value < 0) != (other.value < 0);
+    Wide dividend = Wide(detail::fixedMagnitude(value));
+    Wide divisor = Wide(detail::fixedMagnitude(other.value));
+    Wide quotient = ((dividend << FractionBits) + (divisor >> 1)) / divisor;
+    Wide limit = Wide(static_cast<std::uint64_t>(std::numeric_limits<Storage>::max()) + (negative ? 1 : 0));
+    if (quotient > limit) quotient = limit;
+    Unsigned bits = static_cast<Unsigned>(static_cast<std::uint64_t>(quotient));
+    value = static_cast<Storage>(negative ? Unsigned(0) - bits : bits);
+    return *this;
+}
+
+template<typename Storage, int FractionBits>
+Fixed<Storage, FractionBits> Fixed<Storage, FractionBits>::squareRoot() const noexcept {
+    using Wide = typename detail::FixedWide<Storage>::type;
+    if (value <= 0) return Fixed();
+    Wide root = detail::roundedSqrt(Wide(static_cast<std::uint64_t>(value)) << FractionBits);
+    return fromRaw(static_cast<Storage>(static_cast<std::uint64_t>(root)));
+}
+
+template<typename Storage, int FractionBits>
+Fixed<Storage, FractionBits> Fixed<Storage, FractionBits>::inverseSquareRoot() const noexcept {
+    using Wide = typename detail::FixedWide<Storage>::type;
+    if (value <= 0) return std::numeric_limits<Fixed>::max();
+    if constexpr (3 * FractionBits < int(sizeof(Wide) * 8)) {
+        // 1 / sqrt(v / 2^F) * 2^F = sqrt(2^3F / v).
+        Wide root = detail::roundedSqrt((Wide(1) << (3 * FractionBits)) / Wide(static_cast<std::uint64_t>(value)));
+        if (root > Wide(static_cast<std::uint64_t>(std::numeric_limits<Storage>::max()))) return std::numeric_limits<Fixed>::max();
+        return fromRaw(static_cast<Storage>(static_cast<std::uint64_t>(root)));
+    } else {
+        return Fixed(1) / squareRoot();
+    }
+}
+
+template<typename Storage, int FractionBits>
+void Fixed<Storage, FractionBits>::sineCosine(Fixed& s, Fixed& c) const noexcept {
+    using Wide = detail::FixedUInt128;
+    static_assert(FractionBits <= detail::cordicFractionBits, "Too many fraction bits for CORDIC");
+
+    // Reduce |x| to r in [-pi/4, pi/4] with |x| = r + quadrant * pi/2, in Q.61.
+    Wide angle = Wide(detail::fixedMagnitude(value)) << (detail::cordicFractionBits - FractionBits);
+    Wide halfPi = Wide(static_cast<std::uint64_t>(detail::cordicHalfPi));
+    Wide quadrant = (angle + (halfPi >> 1)) / halfPi;
+    Wide multiple = quadrant * halfPi;
+    std::int64_t reduced = multiple > angle ? -static_cast<std::int64_t>(static_cast<std::uint64_t>(multiple - angle))
+                                            : static_cast<std::int64_t>(static_cast<std::uint64_t>(angle - multiple));
+
+    std::int64_t rs = 0, rc = 0;
+    detail::cordicRotate(reduced, detail::cordicIterations(FractionBits), rs, rc);
+    std::int64_t sine = 0, cosine = 0;
+    switch (static_cast<std::uint64_t>(quadrant) & 3) {
+    case 0: sine = rs; cosine = rc; break;
+    case 1: sine = rc; cosine = -rs; break;
+    case 2: sine = -rs; cosine = -rc; break;
+    default: sine = -rc; cosine = rs; break;
+    }
+    if (value < 0) sine = -sine;
+    s = fromRaw(static_cast<Storage>(detail::roundFromCordic(sine, FractionBits)));
+    c = fromRaw(static_cast<Storage>(detail::roundFromCordic(cosine, FractionBits)));
+}
+
+template<typename Storage, int FractionBits>
+Fixed<Storage, FractionBits> Fixed<Storage, FractionBits>::angleOf(Fixed y, Fixed x) noexcept {
+    static_assert(FractionBits <= detail::cordicFractionBits, "Too many fraction bits for CORDIC");
+    if (y.value == 0 && x.value == 0) return Fixed();
+
+    // Scale both by the same power of two so the larger is below 2^60.
+    std::uint64_t largest = std::max(detail::fixedMagnitude(y.value), detail::fixedMagnitude(x.value));
+    int bits = 0;
+    while (bits < 64 && (largest >> bits) != 0) ++bits;
+    int shift = 60 - bits;
+    auto scale = [shift](Storage raw) {
+        std::int64_t v = raw;
+        return shift >= 0 ? static_cast<std::int64_t>(static_cast<std::uint64_t>(v) << shift) : detail::shiftRightFloor(v, -shift);
+    };
+    std::int64_t vy = scale(y.value);
+    std::int64_t vx = scale(x.value);
+
+    // Vectoring converges for x >= 0; rotate the left half plane by pi first.
+    std::int64_t angle = 0;
+    if (vx < 0) {
+        vx = -vx;
+        vy = -vy;
+        angle = y.value >= 0 ? detail::cordicPi : -detail::cordicPi;
+    }
+    int iterations = detail::cordicIterations(FractionBits);
+    for (int i = 0; i < iterations; ++i) {
+        std::int64_t dx = detail::shiftRightFloor(vy, i);
+        std::int64_t dy = detail::shiftRightFloor(vx, i);
+        if (vy > 0) {
+            vx += dx;
+            vy -= dy;
+            angle += detail::cordicAngles[i];
+        } else {
+            vx -= dx;
+            vy += dy;
+            angle -= detail::cordicAngles[i];
+        }
+    }
+    return fromRaw(static_cast<Storage>(detail::roundFromCordic(angle, FractionBits)));
+}
+
+template<typename Storage, int FractionBits>
+Fixed<Storage, FractionBits> Fixed<Storage, FractionBits>::cosineOf(Fixed sine) noexcept {
+    // sqrt(1 - s^2) from the exact product (1 - s)(1 + s), rounded once.
+    using Wide = detail::FixedUInt128;
+    std::uint64_t one = std::uint64_t(1) << FractionBits;
+    std::uint64_t s = std::min(detail::fixedMagnitude(sine.value), one);
+    Wide root = detail::roundedSqrt(Wide(one - s) * Wide(one + s));
+    return fromRaw(static_cast<Storage>(static_cast<std::uint64_t>(root)));
+}
+
+namespace detail {
+
+#if RENDERFX_FIXED_SIMD >= 1
+// Four Q.F products of 32-bit lanes, rounded like Fixed::operator*=.
+template<int FractionBits>
+inline __m128i fixedMultiply4(__m128i a, __m128i b) noexcept {
+    const __m128i half = _mm_set1_epi64x(std::int64_t(1) << (FractionBits - 1));
+    __m128i even = _mm_add_epi64(_mm_mul_epi32(a, b), half);
+    __m128i odd = _mm_add_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), half);
+    even = _mm_srli_epi64(even, FractionBits);
+    odd = _mm_slli_epi64(_mm_srli_epi64(odd, FractionBits), 32);
+    return _mm_blend_epi16(even, odd, 0xCC);
+}
+#endif
+
+#if RENDERFX_FIXED_SIMD >= 2
+template<int FractionBits>
+inline __m256i fixedMultiply8(__m256i a, __m256i b) noexcept {
+    const __m256i half = _mm256_set1_epi64x(std::int64_t(1) << (FractionBits - 1));
+    __m256i even = _mm256_add_epi64(_mm256_mul_epi32(a, b), half);
+    __m256i odd = _mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), half);
+    even = _mm256_srli_epi64(even, FractionBits);
+    odd = _mm256_slli_epi64(_mm256_srli_epi64(odd, FractionBits), 32);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+#endif
+
+// Runs a kernel over 32-bit lanes with the widest available vectors and
+// finishes the tail with the scalar operators.
+template<typename Storage, int FractionBits, typename Vector4, typename Vector8, typename Scalar>
+inline std::size_t fixedBatch(std::size_t count, Vector4&& vector4, Vector8&& vector8, Scalar&& scalar) noexcept {
+    std::size_t i = 0;
+    if constexpr (std::is_same<Storage, std::int32_t>::value) {
+#if RENDERFX_FIXED_SIMD >= 2
+        for (; i + 8 <= count; i += 8) vector8(i);
+#endif
+#if RENDERFX_FIXED_SIMD >= 1
+        for (; i + 4 <= count; i += 4) vector4(i);
+#endif
+    }
+    (void)vector4;
+    (void)vector8;
+    for (; i < count; ++i) scalar(i);
+    return count;
+}
+
+} // namespace detail
+
+#if RENDERFX_FIXED_SIMD >= 1
+#define RENDERFX_FIXED_LOAD4(p, i) _mm_loadu_si128(reinterpret_cast<const __m128i*>((p) + (i)))
+#define RENDERFX_FIXED_STORE4(p, i, v) _mm_storeu_si128(reinterpret_cast<__m128i*>((p) + (i)), (v))
+#endif
+#if RENDERFX_FIXED_SIMD >= 2
+#define RENDERFX_FIXED_LOAD8(p, i) _mm256_loadu_si256(reinterpret_cast<const __m256i*>((p) + (i)))
+#define RENDERFX_FIXED_STORE8(p, i, v) _mm256_storeu_si256(reinterpret_cast<__m256i*>((p) + (i)), (v))
+#endif
+
+template<typename Storage, int FractionBits>
+void fixedMultiply(const Fixed<Storage, FractionBits>* a, const Fixed<Storage, FractionBits>* b,
+                   Fixed<Storage, FractionBits>* out, std::size_t count) noexcept {
+    detail::fixedBatch<Storage, FractionBits>(count,
+        [&](std::size_t i) {
+#if RENDERFX_FIXED_SIMD >= 1
+            RENDERFX_FIXED_STORE4(out, i, detail::fixedMultiply4<FractionBits>(RENDERFX_FIXED_LOAD4(a, i), RENDERFX_FIXED_LOAD4(b, i)));
+#else
+            (void)i;
+#endif
+        },
+        [&](std::size_t i) {
+#if RENDERFX_FIXED_SIMD >= 2
+            RENDERFX_FIXED_STORE8(out, i, detail::fixedMultiply8<FractionBits>(RENDERFX_FIXED_LOAD8(a, i), RENDERFX_FIXED_LOAD8(b, i)));
+#else
+            (void)i;
+#endif
+        },
+        [&](std::size_t i) { out[i] = a[i] * b[i]; });
+}
+
+template<typename Storage, int FractionBits>
+void fixedMultiplyAdd(const Fixed<Storage, FractionBits>* a, const Fixed<Storage, FractionBits>* b,
+                      const Fixed<Storage, FractionBits>* c, Fixed<Storage, FractionBits>* out, std::size_t count) noexcept {
+    detail::fixedBatch<Storage, FractionBits>(count,
+        [&](std::size_t i) {
+#if RENDERFX_FIXED_SIMD >= 1
+            __m128i product = detail::fixedMultiply4<FractionBits>(RENDERFX_FIXED_LOAD4(a, i), RENDERFX_FIXED_LOAD4(b, i));
+            RENDERFX_FIXED_STORE4(out, i, _mm_add_epi32(product, RENDERFX_FIXED_LOAD4(c, i)));
+#else
+            (void)i;
+#endif
+        },
+        [&](std::size_t i) {
+#if RENDERFX_FIXED_SIMD >= 2
+            __m256i product = detail::fixedMultiply8<FractionBits>(RENDERFX_FIXED_LOAD8(a, i), RENDERFX_FIXED_LOAD8(b, i));
+            RENDERFX_FIXED_STORE8(out, i, _mm256_add_epi32(product, RENDERFX_FIXED_LOAD8(c, i)));
+#else
+            (void)i;
+#endif
+        },
+        [&](std::size_t i) { out[i] = a[i] * b[i] + c[i]; });
+}
+
+template<typename Storage, int FractionBits>
+void fixedDot3(const Fixed<Storage, FractionBits>* ax, const Fixed<Storage, FractionBits>* ay, const Fixed<Storage, FractionBits>* az,
+               const Fixed<Storage, FractionBits>* bx, const Fixed<Storage, FractionBits>* by, const Fixed<Storage, FractionBits>* bz,
+               Fixed<Storage, FractionBits>* out, std::size_t count) noexcept {
+    detail::fixedBatch<Storage, FractionBits>(count,
+        [&](std::size_t i) {
+#if RENDERFX_FIXED_SIMD >= 1
+            __m128i sum = detail::fixedMultiply4<FractionBits>(RENDERFX_FIXED_LOAD4(ax, i), RENDERFX_FIXED_LOAD4(bx, i));
+            sum = _mm_add_epi32(sum, detail::fixedMultiply4<FractionBits>(RENDERFX_FIXED_LOAD4(ay, i), RENDERFX_FIXED_LOAD4(by, i)));
+            sum = _mm_add_epi32(sum, detail::fixedMultiply4<FractionBits>(RENDERFX_FIXED_LOAD4(az, i), RENDERFX_FIXED_LOAD4(bz, i)));
+            RENDERFX_FIXED_STORE4(out, i, sum);
+#else
+            (void)i;
+#endif
+        },
+        [&](std::size_t i) {
+#if RENDERFX_FIXED_SIMD >= 2
+            __m256i sum = detail::fixedMultiply8<FractionBits>(RENDERFX_FIXED_LOAD8(ax, i), RENDERFX_FIXED_LOAD8(bx, i));
+            sum = _mm256_add_epi32(sum, detail::fixedMultiply8<FractionBits>(RENDERFX_FIXED_LOAD8(ay, i), RENDERFX_FIXED_LOAD8(by, i)));
+            sum = _mm256_add_epi32(sum, detail::fixedMultiply8<FractionBits>(RENDERFX_FIXED_LOAD8(az, i), RENDERFX_FIXED_LOAD8(bz, i)));
+            RENDERFX_FIXED_STORE8(out, i, sum);
+#else
+            (void)i;
+#endif
+        },
+        [&](std::size_t i) { out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i]; });
+}
+
+#if RENDERFX_FIXED_SIMD >= 1
+#undef RENDERFX_FIXED_LOAD4
+#undef RENDERFX_FIXED_STORE4
+#endif
+#if RENDERFX_FIXED_SIMD >= 2
+#undef RENDERFX_FIXED_LOAD8
+#undef RENDERFX_FIXED_STORE8
+#endif
+
+#endif // FIXED_INL
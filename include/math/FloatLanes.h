@@ -0,0 +1,158 @@
+#ifndef FLOATLANES_H
+#define FLOATLANES_H
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @file FloatLanes.h
+ * @brief Lane types for writing a batch kernel once over scalars and SIMD vectors.
+ *
+ * A kernel is a generic lambda taking a lane type and an index; forEachLane()
+ * runs it with AVX (8 floats), then SSE2 (4 floats), then scalars for the
+ * tail. Kernels over double, or on targets without SSE2, only see scalars.
+ * Every lane type has the same static operations, so the kernel body is
+ * written once:
+ *
+ * @code
+ * detail::forEachLane<float>(0, count, [&](auto lanes, std::size_t i) {
+ *     using L = decltype(lanes);
+ *     L::store(out + i, L::add(L::load(a + i), L::load(b + i)));
+ * });
+ * @endcode
+ *
+ * RENDERFX_FLOAT_LANES is 2 with AVX2, 1 with SSE2 and 0 otherwise.
+ */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RENDERFX_FLOAT_LANES 2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RENDERFX_FLOAT_LANES 1
+#else
+#define RENDERFX_FLOAT_LANES 0
+#endif
+
+namespace detail {
+
+/**
+ * @brief One element at a time; comparisons yield bool.
+ */
+struct ScalarLanes {
+    static constexpr std::size_t width = 1;
+
+    template<typename T> static T load(const T* p) noexcept { return *p; }
+    template<typename T> static void store(T* p, T v) noexcept { *p = v; }
+    template<typename T> static T set(T v) noexcept { return v; }
+    template<typename T> static T add(T a, T b) noexcept { return a + b; }
+    template<typename T> static T sub(T a, T b) noexcept { return a - b; }
+    template<typename T> static T mul(T a, T b) noexcept { return a * b; }
+    template<typename T> static T div(T a, T b) noexcept { return a / b; }
+    template<typename T> static T min(T a, T b) noexcept { return b < a ? b : a; }
+    template<typename T> static T max(T a, T b) noexcept { return a < b ? b : a; }
+    template<typename T> static T abs(T v) noexcept { return std::fabs(v); }
+    template<typename T> static T sqrt(T v) noexcept { return std::sqrt(v); }
+    /// 1 / sqrt(v), correctly rounded rather than estimated.
+    template<typename T> static T rsqrt(T v) noexcept { return T(1) / std::sqrt(v); }
+    /// v with its sign flipped where the sign bit of sign is set, -0 included, like the SIMD lanes.
+    template<typename T> static T signOf(T sign, T v) noexcept { return std::signbit(sign) ? -v : v; }
+    template<typename T> static bool greater(T a, T b) noexcept { return a > b; }
+    template<typename T> static T select(bool condition, T a, T b) noexcept { return condition ? a : b; }
+    /// Whether any lane of a comparison result is set.
+    static bool any(bool condition) noexcept { return condition; }
+};
+
+#if RENDERFX_FLOAT_LANES >= 1
+/**
+ * @brief Four floats in an SSE2 register; comparisons yield all-ones lanes.
+ */
+struct Sse2Lanes {
+    static constexpr std::size_t width = 4;
+
+    static __m128 load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float* p, __m128 v) noexcept { _mm_storeu_ps(p, v); }
+    static __m128 set(float v) noexcept { return _mm_set1_ps(v); }
+    static __m128 add(__m128 a, __m128 b) noexcept { return _mm_add_ps(a, b); }
+    static __m128 sub(__m128 a, __m128 b) noexcept { return _mm_sub_ps(a, b); }
+    static __m128 mul(__m128 a, __m128 b) noexcept { return _mm_mul_ps(a, b); }
+    static __m128 div(__m128 a, __m128 b) noexcept { return _mm_div_ps(a, b); }
+    static __m128 min(__m128 a, __m128 b) noexcept { return _mm_min_ps(a, b); }
+    static __m128 max(__m128 a, __m128 b) noexcept { return _mm_max_ps(a, b); }
+    static __m128 abs(__m128 v) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+    static __m128 sqrt(__m128 v) noexcept { return _mm_sqrt_ps(v); }
+    static __m128 rsqrt(__m128 v) noexcept { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v)); }
+    static __m128 signOf(__m128 sign, __m128 v) noexcept { return _mm_xor_ps(v, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+    static __m128 greater(__m128 a, __m128 b) noexcept { return _mm_cmpgt_ps(a, b); }
+    static __m128 select(__m128 condition, __m128 a, __m128 b) noexcept {
+        return _mm_or_ps(_mm_and_ps(condition, a), _mm_andnot_ps(condition, b));
+    }
+    static bool any(__m128 condition) noexcept { return _mm_movemask_ps(condition) != 0; }
+};
+#endif
+
+#if RENDERFX_FLOAT_LANES >= 2
+/**
+ * @brief Eight floats in an AVX register; comparisons yield all-ones lanes.
+ */
+struct AvxLanes {
+    static constexpr std::size_t width = 8;
+
+    static __m256 load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float* p, __m256 v) noexcept { _mm256_storeu_ps(p, v); }
+    static __m256 set(float v) noexcept { return _mm256_set1_ps(v); }
+    static __m256 add(__m256 a, __m256 b) noexcept { return _mm256_add_ps(a, b); }
+    static __m256 sub(__m256 a, __m256 b) noexcept { return _mm256_sub_ps(a, b); }
+    static __m256 mul(__m256 a, __m256 b) noexcept { return _mm256_mul_ps(a, b); }
+    static __m256 div(__m256 a, __m256 b) noexcept { return _mm256_div_ps(a, b); }
+    static __m256 min(__m256 a, __m256 b) noexcept { return _mm256_min_ps(a, b); }
+    static __m256 max(__m256 a, __m256 b) noexcept { return _mm256_max_ps(a, b); }
+    static __m256 abs(__m256 v) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+    static __m256 sqrt(__m256 v) noexcept { return _mm256_sqrt_ps(v); }
+    static __m256 rsqrt(__m256 v) noexcept { return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(v)); }
+    static __m256 signOf(__m256 sign, __m256 v) noexcept { return _mm256_xor_ps(v, _mm256_and_ps(sign, _mm256_set1_ps(-0.0f))); }
+    static __m256 greater(__m256 a, __m256 b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static __m256 select(__m256 condition, __m256 a, __m256 b) noexcept { return _mm256_blendv_ps(b, a, condition); }
+    static bool any(__m256 condition) noexcept { return _mm256_movemask_ps(condition) != 0; }
+};
+#endif
+
+/**
+ * @brief Width of the widest lanes forEachLane() uses for T, for sizing per-lane scratch buffers.
+ */
+template<typename T>
+constexpr std::size_t maxLaneWidth = !std::is_same<T, float>::value ? ScalarLanes::width
+#if RENDERFX_FLOAT_LANES >= 2
+                                                                     : AvxLanes::width;
+#elif RENDERFX_FLOAT_LANES >= 1
+                                                                     : Sse2Lanes::width;
+#else
+                                                                     : ScalarLanes::width;
+#endif
+
+/**
+ * @brief Runs a kernel over [first, last) with the widest lanes available for T.
+ *
+ * @tparam T The element type; only float uses SIMD lanes.
+ * @param first The first index.
+ * @param last One past the last index.
+ * @param fn Called as fn(Lanes(), i) for every run of Lanes::width elements starting at i.
+ */
+template<typename T, typename Fn>
+inline void forEachLane(std::size_t first, std::size_t last, Fn&& fn) {
+    std::size_t i = first;
+    if constexpr (std::is_same<T, float>::value) {
+#if RENDERFX_FLOAT_LANES >= 2
+        for (; i + AvxLanes::width <= last; i += AvxLanes::width) fn(AvxLanes(), i);
+#endif
+#if RENDERFX_FLOAT_LANES >= 1
+        for (; i + Sse2Lanes::width <= last; i += Sse2Lanes::width) fn(Sse2Lanes(), i);
+#endif
+    }
+    for (; i < last; ++i) fn(ScalarLanes(), i);
+}
+
+} // namespace detail
+
+#endif // FLOATLANES_H
@@ -6,6 +6,8 @@
 #include "Matrix4x4.h"
 #include "Quaternion.h"
 
+RENDERFX_STRICT_FP_BEGIN
+
 /**
  * @brief A template class representing a ray in 3D space.
  * 
@@ -80,6 +82,21 @@ public:
      * @return True if the point is inside the AABB, false otherwise.
      */
     constexpr bool contains(const Vector3<T>& point) const noexcept;
+
+    /**
+     * @brief Computes the AABB enclosing this box after an affine transformation.
+     * 
+     * @param matrix The affine transformation matrix.
+     * @return The transformed AABB.
+     */
+    constexpr AABB transformed(const Matrix4x4<T>& matrix) const noexcept;
+
+    /**
+     * @brief Checks if both corners are finite.
+     * 
+     * @return False if any component is NaN or infinite.
+     */
+    constexpr bool isFinite() const noexcept;
 };
 
 /**
@@ -251,7 +268,7 @@ public:
      * 
      * @return The transformation matrix.
      */
-    Matrix4x4<T> toMatrix() const noexcept;
+    constexpr Matrix4x4<T> toMatrix() const noexcept;
 
     /**
      * @brief Transforms a point by this transform.
@@ -259,7 +276,7 @@ public:
      * @param point The point to transform.
      * @return The transformed point.
      */
-    Vector3<T> transformPoint(const Vector3<T>& point) const noexcept;
+    constexpr Vector3<T> transformPoint(const Vector3<T>& point) const noexcept;
 
     /**
      * @brief Transforms a direction by this transform.
@@ -267,7 +284,7 @@ public:
      * @param direction The direction to transform.
      * @return The transformed direction.
      */
-    Vector3<T> transformDirection(const Vector3<T>& direction) const noexcept;
+    constexpr Vector3<T> transformDirection(const Vector3<T>& direction) const noexcept;
 
     /**
      * @brief Interpolates between this transform and another transform.
@@ -289,4 +306,6 @@ using Transformf = Transform<float>;
 
 #include "Geometry.inl"
 
+RENDERFX_STRICT_FP_END
+
 #endif // GEOMETRY_H
@@ -28,7 +28,7 @@ bool AABB<T>::intersects(const Ray<T>& ray, T& tMin, T& tMax) const noexcept {
     tMax = std::numeric_limits<T>::infinity();
 
     for (int i = 0; i < 3; ++i) {
-        if (std::abs(ray.direction[i]) < std::numeric_limits<T>::epsilon()) {
+        if (math::abs(ray.direction[i]) < std::numeric_limits<T>::epsilon()) {
             if (ray.origin[i] < min[i] || ray.origin[i] > max[i]) {
                 return false;
             }
@@ -56,6 +56,29 @@ constexpr bool AABB<T>::contains(const Vector3<T>& point) const noexcept {
         point.z >= min.z && point.z <= max.z;
 }
 
+template<typename T>
+constexpr AABB<T> AABB<T>::transformed(const Matrix4x4<T>& matrix) const noexcept {
+    // Transform the center and accumulate the extents through the absolute
+    // rotation/scale part instead of transforming all eight corners.
+    Vector3<T> center = (min + max) * T(0.5);
+    Vector3<T> extent = (max - min) * T(0.5);
+    Vector3<T> newCenter;
+    Vector3<T> newExtent;
+    for (int i = 0; i < 3; ++i) {
+        newCenter[i] = matrix(i, 0) * center.x + matrix(i, 1) * center.y + matrix(i, 2) * center.z + matrix(i, 3);
+        newExtent[i] = math::abs(matrix(i, 0)) * extent.x + math::abs(matrix(i, 1)) * extent.y + math::abs(matrix(i, 2)) * extent.z;
+    }
+    AABB result(newCenter - newExtent, newCenter + newExtent);
+    RENDERFX_VERIFY_FINITE("AABB::transformed", result.min, min, max, matrix);
+    RENDERFX_VERIFY_FINITE("AABB::transformed", result.max, min, max, matrix);
+    return result;
+}
+
+template<typename T>
+constexpr bool AABB<T>::isFinite() const noexcept {
+    return min.isFinite() && max.isFinite();
+}
+
 template<typename T>
 constexpr Plane<T>::Plane() noexcept : normal(Vector3<T>::up()), distance(T(0)) {}
 
@@ -75,7 +98,7 @@ constexpr T Plane<T>::distanceToPoint(const Vector3<T>& point) const noexcept {
 template<typename T>
 bool Plane<T>::intersects(const Ray<T>& ray, T& t) const noexcept {
     T denom = normal.dot(ray.direction);
-    if (std::abs(denom) < std::numeric_limits<T>::epsilon()) {
+    if (math::abs(denom) < std::numeric_limits<T>::epsilon()) {
         return false;  // Ray is parallel to the plane
     }
     t = -(normal.dot(ray.origin) + distance) / denom;
@@ -104,7 +127,7 @@ bool Sphere<T>::intersects(const Ray<T>& ray, T& t) const noexcept {
     T discriminant = b * b - c;
     if (discriminant < T(0)) return false;
 
-    t = -b - std::sqrt(discriminant);
+    t = -b - math::sqrt(discriminant);
     if (t < T(0)) t = T(0);
     return true;
 }
@@ -116,20 +139,20 @@ Frustum<T>::Frustum(const Matrix4x4<T>& viewProjection) {
 
 template<typename T>
 void Frustum<T>::updatePlanes(const Matrix4x4<T>& viewProjection) noexcept {
-    for (int i = 0; i < 3; ++i) {
-        planes[0].normal[i] = viewProjection(i, 2) + viewProjection(i, 3);
-        planes[1].normal[i] = -viewProjection(i, 2) + viewProjection(i, 3);
-        planes[2].normal[i] = viewProjection(i, 0) + viewProjection(i, 3);
-        planes[3].normal[i] = -viewProjection(i, 0) + viewProjection(i, 3);
-        planes[4].normal[i] = viewProjection(i, 1) + viewProjection(i, 3);
-        planes[5].normal[i] = -viewProjection(i, 1) + viewProjection(i, 3);
-    }
-
+    // Clip-space planes w + c >= 0 and w - c >= 0 for c = z (near, far),
+    // x (left, right) and y (bottom, top), taken from the rows of the matrix.
+    constexpr int rows[6] = { 2, 2, 0, 0, 1, 1 };
     for (int i = 0; i < 6; ++i) {
-        planes[i].distance = viewProjection(3, 3) - viewProjection(3, i / 2);
+        T sign = i % 2 == 0 ? T(1) : T(-1);
+        for (int c = 0; c < 3; ++c) {
+            planes[i].normal[c] = viewProjection(3, c) + sign * viewProjection(rows[i], c);
+        }
+        planes[i].distance = viewProjection(3, 3) + sign * viewProjection(rows[i], 3);
         T length = planes[i].normal.length();
         planes[i].normal /= length;
         planes[i].distance /= length;
+        RENDERFX_VERIFY_FINITE("Frustum::updatePlanes", planes[i].normal, viewProjection);
+        RENDERFX_VERIFY_FINITE("Frustum::updatePlanes", planes[i].distance, viewProjection);
     }
 }
 
@@ -167,19 +190,19 @@ constexpr Transform<T>::Transform(const Vector3<T>& position, const Quaternion<T
     : position(position), rotation(rotation), scale(scale) {}
 
 template<typename T>
-Matrix4x4<T> Transform<T>::toMatrix() const noexcept {
+constexpr Matrix4x4<T> Transform<T>::toMatrix() const noexcept {
     return Matrix4x4<T>::translation(position) *
         rotation.toRotationMatrix() *
         Matrix4x4<T>::scaling(scale);
 }
 
 template<typename T>
-Vector3<T> Transform<T>::transformPoint(const Vector3<T>& point) const noexcept {
+constexpr Vector3<T> Transform<T>::transformPoint(const Vector3<T>& point) const noexcept {
     return rotation * (point * scale) + position;
 }
 
 template<typename T>
-Vector3<T> Transform<T>::transformDirection(const Vector3<T>& direction) const noexcept {
+constexpr Vector3<T> Transform<T>::transformDirection(const Vector3<T>& direction) const noexcept {
     return rotation * direction;
 }
 
@@ -0,0 +1,265 @@
+#ifndef MATHDEBUG_H
+#define MATHDEBUG_H
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @file MathDebug.h
+ * @brief Opt-in tracking of non-finite values in the math types.
+ *
+ * Define RENDERFX_MATH_SANITIZE to check the results of constructors and
+ * arithmetic operations for NaN and infinity. The first operation on the
+ * current thread that produces a non-finite result is kept as the origin,
+ * together with its source location and operands, in NonFiniteLog::current().
+ * Batch kernels report their non-finite element counts to the same log.
+ * Without the define every check expands to the bare expression and this
+ * header only provides isFiniteValue().
+ */
+
+namespace detail {
+
+/**
+ * @brief Checks a scalar or math type for NaN and infinity.
+ *
+ * Works in constant expressions: infinity minus itself is NaN, and NaN
+ * never compares equal to anything.
+ *
+ * @param value The scalar, or a math type with an isFinite() member.
+ * @return True if all components are finite.
+ */
+template<typename T>
+constexpr bool isFiniteValue(const T& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return value - value == value - value;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return true;
+    } else {
+        return value.isFinite();
+    }
+}
+
+} // namespace detail
+
+#if defined(RENDERFX_MATH_SANITIZE)
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Where a non-finite value was first produced.
+ */
+struct NonFiniteOrigin {
+    const char* operation = nullptr; ///< The operation, e.g. "Vector3::slerp".
+    const char* file = nullptr;      ///< Source file of the check.
+    int line = 0;                    ///< Source line of the check.
+    std::string operands;            ///< The operands, formatted with operator<<.
+    bool construction = false;       ///< True if the value entered through a constructor.
+    bool operandsFinite = false;     ///< True if the operation created the value from finite operands.
+};
+
+/**
+ * @brief Non-finite count of one call of a batch kernel.
+ */
+struct NonFiniteBatchReport {
+    const char* kernel = nullptr;  ///< The batch kernel.
+    std::size_t elements = 0;      ///< Elements processed by the batch.
+    std::size_t nonFinite = 0;     ///< Elements with at least one non-finite component.
+};
+
+/**
+ * @brief Thread-local record of non-finite values seen by the math types.
+ */
+class NonFiniteLog {
+public:
+    /**
+     * @brief Gets the log of the calling thread.
+     *
+     * @return The thread-local log.
+     */
+    static NonFiniteLog& current() {
+        thread_local NonFiniteLog log;
+        return log;
+    }
+
+    /**
+     * @brief Checks if a non-finite value has been produced since the last clear().
+     *
+     * @return True if an origin has been recorded.
+     */
+    bool hasOrigin() const noexcept { return recorded; }
+
+    /**
+     * @brief Gets the first origin recorded since the last clear().
+     *
+     * @return The origin; only meaningful if hasOrigin() is true.
+     */
+    const NonFiniteOrigin& origin() const noexcept { return first; }
+
+    /**
+     * @brief Gets the number of checks that saw a non-finite result, including propagation.
+     *
+     * @return The event count.
+     */
+    std::size_t eventCount() const noexcept { return events; }
+
+    /**
+     * @brief Gets the reports of batch kernels that produced non-finite elements.
+     *
+     * @return The batch reports in call order.
+     */
+    const std::vector<NonFiniteBatchReport>& batchReports() const noexcept { return batches; }
+
+    /**
+     * @brief Forgets the origin, the event count and the batch reports.
+     */
+    void clear() {
+        first = NonFiniteOrigin();
+        recorded = false;
+        events = 0;
+        lastConstruction = 0;
+        batches.clear();
+    }
+
+    /**
+     * @brief Records a non-finite result.
+     *
+     * The first result becomes the origin. A constructor origin is replaced
+     * by the operation that constructed the value, when that operation is
+     * the very next check to fire. If non-finite values reach an operation
+     * without passing any check (e.g. written to the members directly), the
+     * origin has operandsFinite set to false.
+     *
+     * @param operation The operation that produced the value.
+     * @param file Source file of the check.
+     * @param line Source line of the check.
+     * @param operandsFinite True if all operands were finite.
+     * @param construction True if the check guards a constructor.
+     * @param formatOperands Callable returning the operands as a string.
+     */
+    template<typename Format>
+    void record(const char* operation, const char* file, int line, bool operandsFinite, bool construction, Format&& formatOperands) {
+        ++events;
+        bool refinesConstruction = recorded && first.construction && !construction && lastConstruction == events - 1;
+        if (recorded && !refinesConstruction) return;
+
+        first.operation = operation;
+        first.file = file;
+        first.line = line;
+        first.construction = construction;
+        first.operandsFinite = operandsFinite;
+        try {
+            first.operands = formatOperands();
+        } catch (...) {
+            first.operands.clear();
+        }
+        recorded = true;
+        if (construction) lastConstruction = events;
+    }
+
+    /**
+     * @brief Records the result of one batch kernel call.
+     *
+     * @param kernel The batch kernel.
+     * @param elements Elements processed.
+     * @param nonFinite Elements that were not finite.
+     */
+    void recordBatch(const char* kernel, std::size_t elements, std::size_t nonFinite) {
+        if (nonFinite == 0) return;
+        batches.push_back({ kernel, elements, nonFinite });
+    }
+
+    /**
+     * @brief Prints the origin and the batch reports to stderr.
+     */
+    void print() const {
+        if (recorded) {
+            std::fprintf(stderr, "non-finite origin: %s (%s:%d) operands: %s\n",
+                         first.operation, first.file, first.line, first.operands.c_str());
+        }
+        for (const auto& batch : batches) {
+            std::fprintf(stderr, "non-finite batch: %s %zu of %zu\n", batch.kernel, batch.nonFinite, batch.elements);
+        }
+    }
+
+private:
+    NonFiniteOrigin first;
+    bool recorded = false;
+    std::size_t events = 0;
+    std::size_t lastConstruction = 0;
+    std::vector<NonFiniteBatchReport> batches;
+};
+
+namespace detail {
+
+template<typename... Operands>
+std::string formatOperands(const Operands&... operands) {
+    std::ostringstream os;
+    os.precision(9);
+    const char* separator = "";
+    ((os << separator << operands, separator = ", "), ...);
+    return os.str();
+}
+
+template<typename Value, typename... Operands>
+constexpr void verifyFinite(const char* operation, const char* file, int line, bool construction,
+                            const Value& value, const Operands&... operands) {
+    if (!isFiniteValue(value)) {
+        bool operandsFinite = (isFiniteValue(operands) && ...);
+        NonFiniteLog::current().record(operation, file, line, operandsFinite, construction,
+                                       [&] { return formatOperands(operands...); });
+    }
+}
+
+// Returns rvalues by value, as a reference to a temporary would dangle
+// once the full expression ends; lvalues, such as *this in compound
+// assignments, are returned by reference.
+template<typename Value, typename... Operands>
+constexpr Value checkFinite(const char* operation, const char* file, int line, bool construction,
+                            Value&& value, const Operands&... operands) {
+    verifyFinite(operation, file, line, construction, value, operands...);
+    return std::forward<Value>(value);
+}
+
+template<typename Iterator>
+std::size_t checkFiniteBatch(const char* kernel, Iterator first, Iterator last) {
+    std::size_t elements = 0;
+    std::size_t nonFinite = 0;
+    for (; first != last; ++first, ++elements) {
+        if (!isFiniteValue(*first)) ++nonFinite;
+    }
+    NonFiniteLog::current().recordBatch(kernel, elements, nonFinite);
+    return nonFinite;
+}
+
+} // namespace detail
+
+/// Checks the result of an operation and returns it.
+#define RENDERFX_CHECK_FINITE(operation, expression, ...) \
+    ::detail::checkFinite(operation, __FILE__, __LINE__, false, expression, __VA_ARGS__)
+
+/// Checks an intermediate value; used as a statement.
+#define RENDERFX_VERIFY_FINITE(operation, value, ...) \
+    ::detail::verifyFinite(operation, __FILE__, __LINE__, false, value, __VA_ARGS__)
+
+/// Checks a freshly constructed value; used as a statement in constructor bodies.
+#define RENDERFX_CHECK_FINITE_CONSTRUCTION(operation, value) \
+    ::detail::verifyFinite(operation, __FILE__, __LINE__, true, value, value)
+
+/// Counts the non-finite elements of [first, last) produced by a batch kernel.
+#define RENDERFX_CHECK_FINITE_BATCH(kernel, first, last) \
+    ((void)::detail::checkFiniteBatch(kernel, first, last))
+
+#else
+
+#define RENDERFX_CHECK_FINITE(operation, expression, ...) (expression)
+#define RENDERFX_VERIFY_FINITE(operation, value, ...) ((void)0)
+#define RENDERFX_CHECK_FINITE_CONSTRUCTION(operation, value) ((void)0)
+#define RENDERFX_CHECK_FINITE_BATCH(kernel, first, last) ((void)0)
+
+#endif // RENDERFX_MATH_SANITIZE
+
+#endif // MATHDEBUG_H
@@ -0,0 +1,346 @@
+#ifndef MATHFUNCTIONS_H
+#define MATHFUNCTIONS_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include "StrictMath.h"
+
+/**
+ * @file MathFunctions.h
+ * @brief Scalar functions usable in constant expressions.
+ *
+ * The functions in namespace math call the standard library at run time and
+ * switch to the portable polynomial implementations in math::portable when
+ * evaluated at compile time, so fixed matrices, rotations and lookup tables
+ * can be computed by the compiler. The portable implementations work in
+ * long double and are accurate to about one ULP of float and double.
+ *
+ * Class types, such as the fixed-point types of Fixed.h, are forwarded to
+ * the overloads found for them by argument-dependent lookup.
+ *
+ * With RENDERFX_MATH_STRICT defined, sin(), cos(), tan(), asin(), acos()
+ * and atan2() of floating-point types always use the reproducible
+ * implementations of StrictMath.h, computed in double and rounded to the
+ * argument type, so results do not depend on the C library.
+ */
+
+template<typename E>
+class VectorExpression;
+
+namespace math {
+
+/**
+ * @brief True if the functions below use math::strict at run time.
+ */
+#if defined(RENDERFX_MATH_STRICT)
+constexpr bool strictMode = true;
+#else
+constexpr bool strictMode = false;
+#endif
+
+/**
+ * @brief Portable implementations that do not depend on the C math library.
+ */
+namespace portable {
+
+/**
+ * @brief Computes the square root.
+ *
+ * @param x The value.
+ * @return The square root, NaN for negative values.
+ */
+template<typename T>
+constexpr T sqrt(T x) {
+    if (x != x || x < T(0)) return std::numeric_limits<T>::quiet_NaN();
+    if (x == T(0) || x == std::numeric_limits<T>::infinity()) return x;
+
+    // Scale into [1, 4) by powers of four so the result scales by exact powers of two.
+    long double a = x;
+    long double scale = 1;
+    constexpr long double big = 18446744073709551616.0L; // 2^64
+    while (a >= big) { a /= big; scale *= 4294967296.0L; }
+    while (a < 1 / big) { a *= big; scale /= 4294967296.0L; }
+    while (a >= 4) { a /= 4; scale *= 2; }
+    while (a < 1) { a *= 4; scale /= 2; }
+
+    // Newton's method decreases monotonically from above; stop once it no longer does.
+    long double root = 2;
+    for (int i = 0; i < 64; ++i) {
+        long double next = (root + a / root) / 2;
+        if (next >= root) break;
+        root = next;
+    }
+    return static_cast<T>(root * scale);
+}
+
+namespace detail {
+
+// pi/2 split into parts of 33 significant bits, so that quadrant * part is
+// exact even where long double is the same as double.
+constexpr long double halfPi1 = 1.57079632673412561417e+00L;
+constexpr long double halfPi2 = 6.07710050630396597660e-11L;
+constexpr long double halfPi3 = 2.02226624879595063154e-21L;
+
+// Largest |x| reduceQuarterPi() accepts: below 2^20 quadrants, where the
+// products with the parts above stay exact.
+constexpr long double maxReducible = 1.0e6L;
+
+// False for NaN, infinities and |x| above maxReducible.
+constexpr bool isReducible(long double x) { return x >= -maxReducible && x <= maxReducible; }
+
+// Reduces x to r in [-pi/4, pi/4] with x = r + quadrant * pi/2.
+constexpr long double reduceQuarterPi(long double x, long long& quadrant) {
+    long double k = x / (halfPi1 + halfPi2);
+    quadrant = static_cast<long long>(k < 0 ? k - 0.5L : k + 0.5L);
+    long double q = static_cast<long double>(quadrant);
+    return ((x - q * halfPi1) - q * halfPi2) - q * halfPi3;
+}
+
+// Taylor series, exact to long double precision on [-pi/4, pi/4].
+constexpr long double sinKernel(long double r) {
+    long double r2 = r * r;
+    long double sum = 0;
+    for (int n = 21; n >= 3; n -= 2) {
+        sum = (sum + 1) * -r2 / (n * (n - 1));
+    }
+    return r * (1 + sum);
+}
+
+constexpr long double cosKernel(long double r) {
+    long double r2 = r * r;
+    long double sum = 0;
+    for (int n = 22; n >= 2; n -= 2) {
+        sum = (sum + 1) * -r2 / (n * (n - 1));
+    }
+    return 1 + sum;
+}
+
+} // namespace detail
+
+/**
+ * @brief Computes the sine.
+ *
+ * @param x The angle in radians.
+ * @return The sine of x, or NaN for non-finite x or |x| above 1e6.
+ */
+template<typename T>
+constexpr T sin(T x) {
+    if (!detail::isReducible(x)) return std::numeric_limits<T>::quiet_NaN();
+    long long quadrant = 0;
+    long double r = detail::reduceQuarterPi(x, quadrant);
+    switch (quadrant & 3) {
+    case 0: return static_cast<T>(detail::sinKernel(r));
+    case 1: return static_cast<T>(detail::cosKernel(r));
+    case 2: return static_cast<T>(-detail::sinKernel(r));
+    default: return static_cast<T>(-detail::cosKernel(r));
+    }
+}
+
+/**
+ * @brief Computes the cosine.
+ *
+ * @param x The angle in radians.
+ * @return The cosine of x, or NaN for non-finite x or |x| above 1e6.
+ */
+template<typename T>
+constexpr T cos(T x) {
+    if (!detail::isReducible(x)) return std::numeric_limits<T>::quiet_NaN();
+    long long quadrant = 0;
+    long double r = detail::reduceQuarterPi(x, quadrant);
+    switch (quadrant & 3) {
+    case 0: return static_cast<T>(detail::cosKernel(r));
+    case 1: return static_cast<T>(-detail::sinKernel(r));
+    case 2: return static_cast<T>(-detail::cosKernel(r));
+    default: return static_cast<T>(detail::sinKernel(r));
+    }
+}
+
+/**
+ * @brief Computes the tangent.
+ *
+ * @param x The angle in radians.
+ * @return The tangent of x, or NaN for non-finite x or |x| above 1e6.
+ */
+template<typename T>
+constexpr T tan(T x) {
+    if (!detail::isReducible(x)) return std::numeric_limits<T>::quiet_NaN();
+    long long quadrant = 0;
+    long double r = detail::reduceQuarterPi(x, quadrant);
+    long double s = detail::sinKernel(r);
+    long double c = detail::cosKernel(r);
+    return static_cast<T>((quadrant & 1) ? -c / s : s / c);
+}
+
+} // namespace portable
+
+/**
+ * @brief Computes the absolute value; constant-evaluable.
+ *
+ * Class types such as Fixed use their own comparison and negation;
+ * vector expressions use the overload in VectorExpression.h.
+ *
+ * @param x The value.
+ * @return The absolute value of x; +0 for -0.
+ */
+template<typename T, typename = std::enable_if_t<!std::is_base_of_v<VectorExpression<T>, T>>>
+constexpr T abs(T x) {
+    if constexpr (std::is_class_v<T>) {
+        return x < T(0) ? -x : x;
+    } else if constexpr (std::is_unsigned_v<T>) {
+        return x;
+    } else {
+        if (RENDERFX_IS_CONSTANT_EVALUATED()) return x == T(0) ? T(0) : (x < T(0) ? -x : x);
+        return static_cast<T>(std::abs(x));
+    }
+}
+
+/**
+ * @brief Computes the square root; constant-evaluable.
+ *
+ * Integral arguments are converted to double, like std::sqrt.
+ *
+ * @param x The value.
+ * @return The square root of x.
+ */
+template<typename T>
+constexpr auto sqrt(T x) {
+    if constexpr (std::is_integral_v<T>) {
+        return math::sqrt(static_cast<double>(x));
+    } else if constexpr (std::is_class_v<T>) {
+        return sqrt(x);
+    } else {
+        if (RENDERFX_IS_CONSTANT_EVALUATED()) return portable::sqrt(x);
+        return std::sqrt(x);
+    }
+}
+
+/**
+ * @brief Computes the sine; constant-evaluable.
+ *
+ * In constant expressions portable::sin() is used, which gives NaN for
+ * |x| above 1e6 where std::sin() still reduces the argument; strict mode
+ * gives NaN above 1e8 on both paths.
+ *
+ * @param x The angle in radians.
+ * @return The sine of x.
+ */
+template<typename T>
+constexpr T sin(T x) {
+    if constexpr (std::is_class_v<T>) {
+        return sin(x);
+    } else {
+        if constexpr (strictMode) return static_cast<T>(strict::sin(static_cast<double>(x)));
+        if (RENDERFX_IS_CONSTANT_EVALUATED()) return portable::sin(x);
+        return std::sin(x);
+    }
+}
+
+/**
+ * @brief Computes the cosine; constant-evaluable.
+ *
+ * In constant expressions portable::cos() is used, which gives NaN for
+ * |x| above 1e6 where std::cos() still reduces the argument; strict mode
+ * gives NaN above 1e8 on both paths.
+ *
+ * @param x The angle in radians.
+ * @return The cosine of x.
+ */
+template<typename T>
+constexpr T cos(T x) {
+    if constexpr (std::is_class_v<T>) {
+        return cos(x);
+    } else {
+        if constexpr (strictMode) return static_cast<T>(strict::cos(static_cast<double>(x)));
+        if (RENDERFX_IS_CONSTANT_EVALUATED()) return portable::cos(x);
+        return std::cos(x);
+    }
+}
+
+/**
+ * @brief Computes the tangent; constant-evaluable.
+ *
+ * In constant expressions portable::tan() is used, which gives NaN for
+ * |x| above 1e6 where std::tan() still reduces the argument; strict mode
+ * gives NaN above 1e8 on both paths.
+ *
+ * @param x The angle in radians.
+ * @return The tangent of x.
+ */
+template<typename T>
+constexpr T tan(T x) {
+    if constexpr (std::is_class_v<T>) {
+        return tan(x);
+    } else {
+        if constexpr (strictMode) return static_cast<T>(strict::tan(static_cast<double>(x)));
+        if (RENDERFX_IS_CONSTANT_EVALUATED()) return portable::tan(x);
+        return std::tan(x);
+    }
+}
+
+/**
+ * @brief Computes the arc sine; constant-evaluable.
+ *
+ * In constant expressions and in strict mode the result is computed by
+ * strict::asin() in double, so a long double argument gets a result of
+ * double precision there and std::asin() precision at run time.
+ *
+ * @param x The value.
+ * @return The arc sine of x in radians.
+ */
+template<typename T>
+constexpr T asin(T x) {
+    if constexpr (std::is_class_v<T>) {
+        return asin(x);
+    } else {
+        if (strictMode || RENDERFX_IS_CONSTANT_EVALUATED()) return static_cast<T>(strict::asin(static_cast<double>(x)));
+        return std::asin(x);
+    }
+}
+
+/**
+ * @brief Computes the arc cosine; constant-evaluable.
+ *
+ * In constant expressions and in strict mode the result is computed by
+ * strict::acos() in double, so a long double argument gets a result of
+ * double precision there and std::acos() precision at run time.
+ *
+ * @param x The value.
+ * @return The arc cosine of x in radians.
+ */
+template<typename T>
+constexpr T acos(T x) {
+    if constexpr (std::is_class_v<T>) {
+        return acos(x);
+    } else {
+        if (strictMode || RENDERFX_IS_CONSTANT_EVALUATED()) return static_cast<T>(strict::acos(static_cast<double>(x)));
+        return std::acos(x);
+    }
+}
+
+/**
+ * @brief Computes the angle of a vector; constant-evaluable.
+ *
+ * In constant expressions and in strict mode the result is computed by
+ * strict::atan2() in double, so long double arguments get a result of
+ * double precision there and std::atan2() precision at run time.
+ *
+ * @param y The y component.
+ * @param x The x component.
+ * @return The angle in radians.
+ */
+template<typename T>
+constexpr T atan2(T y, T x) {
+    if constexpr (std::is_class_v<T>) {
+        return atan2(y, x);
+    } else {
+        if (strictMode || RENDERFX_IS_CONSTANT_EVALUATED()) {
+            return static_cast<T>(strict::atan2(static_cast<double>(y), static_cast<double>(x)));
+        }
+        return std::atan2(y, x);
+    }
+}
+
+} // namespace math
+
+#endif // MATHFUNCTIONS_H
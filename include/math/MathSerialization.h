@@ -0,0 +1,212 @@
+#ifndef MATHSERIALIZATION_H
+#define MATHSERIALIZATION_H
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "Geometry.h"
+#include "MatrixMxN.h"
+#include "Rect.h"
+#include "Vector2.h"
+#include "VectorN.h"
+
+/**
+ * @file MathSerialization.h
+ * @brief Text serialization of the math types, based on std::to_chars and std::from_chars.
+ *
+ * The text is JSON, matching the number arrays of the .rfxscene format:
+ *
+ * | Type                     | Text                                                       |
+ * |--------------------------|------------------------------------------------------------|
+ * | Vector2, Vector3, Vector | `[x, y, z]`                                                |
+ * | Quaternion               | `[w, x, y, z]`                                             |
+ * | Rect                     | `[x, y, width, height]`                                    |
+ * | Matrix4x4, Matrix        | `[m00, m01, ...]`, row by row                              |
+ * | Ray                      | `{"origin": [...], "direction": [...]}`                    |
+ * | AABB                     | `{"min": [...], "max": [...]}`                             |
+ * | Plane                    | `{"normal": [...], "distance": d}`                         |
+ * | Sphere                   | `{"center": [...], "radius": r}`                           |
+ * | Transform                | `{"position": [...], "rotation": [...], "scale": [...]}`   |
+ *
+ * Numbers are written in the shortest form that reads back to the same
+ * value, independent of the locale. JSON has no NaN or infinity, so
+ * non-finite values are written as null, as JSON.stringify does, and null
+ * reads back as NaN; the sign and infinities do not round-trip. The nan and
+ * inf spellings of std::from_chars are rejected. Parsers skip whitespace, accept object
+ * keys in any order and leave missing keys at their defaults. A Transform
+ * rotation with three numbers is read as Euler angles in radians, in the
+ * order returned by Quaternion::toEulerAngles().
+ *
+ * The toChars and fromChars overloads follow the std conventions: they
+ * never allocate or throw, and report errors through the returned ec. The
+ * toString and parse helpers allocate and throw std::invalid_argument.
+ */
+
+namespace math {
+
+/// @name Single Values
+/// @{
+
+template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+std::to_chars_result toChars(char* first, char* last, T value);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Vector2<T>& v);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Vector3<T>& v);
+
+template<typename T, std::size_t N>
+std::to_chars_result toChars(char* first, char* last, const Vector<T, N>& v);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Quaternion<T>& q);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Rect<T>& r);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Matrix4x4<T>& m);
+
+template<typename T, std::size_t R, std::size_t C>
+std::to_chars_result toChars(char* first, char* last, const Matrix<T, R, C>& m);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Ray<T>& ray);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const AABB<T>& box);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Plane<T>& plane);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Sphere<T>& sphere);
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Transform<T>& transform);
+
+template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+std::from_chars_result fromChars(const char* first, const char* last, T& value);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Vector2<T>& v);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Vector3<T>& v);
+
+template<typename T, std::size_t N>
+std::from_chars_result fromChars(const char* first, const char* last, Vector<T, N>& v);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Quaternion<T>& q);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Rect<T>& r);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Matrix4x4<T>& m);
+
+template<typename T, std::size_t R, std::size_t C>
+std::from_chars_result fromChars(const char* first, const char* last, Matrix<T, R, C>& m);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Ray<T>& ray);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, AABB<T>& box);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Plane<T>& plane);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Sphere<T>& sphere);
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Transform<T>& transform);
+
+/// @}
+
+/// @name Arrays
+/// @{
+
+/**
+ * @brief Writes an array of values as a JSON array.
+ *
+ * @param first Start of the output range.
+ * @param last End of the output range.
+ * @param values The values.
+ * @param count Number of values.
+ * @return End of the written text, or ec = std::errc::value_too_large.
+ */
+template<typename V>
+std::to_chars_result toChars(char* first, char* last, const V* values, std::size_t count);
+
+/**
+ * @brief Reads a JSON array of values and appends them to a vector.
+ *
+ * On error, the values read before the error remain appended.
+ *
+ * @param first Start of the text.
+ * @param last End of the text.
+ * @param values Receives the values.
+ * @return End of the array, or the position and kind of the error.
+ */
+template<typename V>
+std::from_chars_result fromChars(const char* first, const char* last, std::vector<V>& values);
+
+/// @}
+
+/// @name Convenience Functions
+/// @{
+
+/**
+ * @brief Formats a value.
+ *
+ * @param value The value.
+ * @return The text.
+ */
+template<typename V>
+std::string toString(const V& value);
+
+/**
+ * @brief Formats an array of values into one string with amortized growth.
+ *
+ * @param values The values.
+ * @param count Number of values.
+ * @return The JSON array.
+ */
+template<typename V>
+std::string toString(const V* values, std::size_t count);
+
+/**
+ * @brief Parses a value; the text must contain nothing else but whitespace.
+ *
+ * @param text The text.
+ * @return The value.
+ * @throws std::invalid_argument If the text is not a valid value.
+ */
+template<typename V>
+V parse(std::string_view text);
+
+/**
+ * @brief Parses a JSON array of values.
+ *
+ * @param text The text.
+ * @return The values.
+ * @throws std::invalid_argument If the text is not a valid array.
+ */
+template<typename V>
+std::vector<V> parseArray(std::string_view text);
+
+/// @}
+
+} // namespace math
+
+#include "MathSerialization.inl"
+
+#endif // MATHSERIALIZATION_H
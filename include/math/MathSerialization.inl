@@ -0,0 +1,517 @@
+#ifndef MATHSERIALIZATION_INL
+#define MATHSERIALIZATION_INL
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace detail {
+
+inline std::to_chars_result textOverflow(char* last) {
+    return { last, std::errc::value_too_large };
+}
+
+inline std::from_chars_result textError(const char* position) {
+    return { position, std::errc::invalid_argument };
+}
+
+inline const char* skipTextSpace(const char* p, const char* last) {
+    while (p != last && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    return p;
+}
+
+inline bool expectText(const char*& p, const char* last, char c) {
+    p = skipTextSpace(p, last);
+    if (p == last || *p != c) return false;
+    ++p;
+    return true;
+}
+
+// Writers return nullptr when the output range is too small.
+inline char* writeText(char* p, char* last, std::string_view text) {
+    if (p == nullptr || static_cast<std::size_t>(last - p) < text.size()) return nullptr;
+    std::memcpy(p, text.data(), text.size());
+    return p + text.size();
+}
+
+template<typename T>
+char* writeNumber(char* p, char* last, T value) {
+    if (p == nullptr) return nullptr;
+    // JSON has no NaN or infinity; write them as null.
+    if constexpr (std::is_floating_point_v<T>) {
+        if (!std::isfinite(value)) return writeText(p, last, "null");
+    }
+    std::to_chars_result result = std::to_chars(p, last, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+template<typename T>
+char* writeNumbers(char* p, char* last, const T* values, std::size_t count) {
+    p = writeText(p, last, "[");
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i > 0) p = writeText(p, last, ", ");
+        p = writeNumber(p, last, values[i]);
+    }
+    return writeText(p, last, "]");
+}
+
+inline char* writeKey(char* p, char* last, std::string_view key, bool first) {
+    p = writeText(p, last, first ? "{\"" : ", \"");
+    p = writeText(p, last, key);
+    return writeText(p, last, "\": ");
+}
+
+template<typename V>
+char* writeValue(char* p, char* last, const V& value) {
+    if (p == nullptr) return nullptr;
+    std::to_chars_result result = math::toChars(p, last, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+inline std::to_chars_result finishText(char* p, char* last) {
+    return p == nullptr ? textOverflow(last) : std::to_chars_result{ p, std::errc() };
+}
+
+// Reads a JSON number, or null as NaN. The nan and inf spellings that
+// std::from_chars also accepts are rejected.
+template<typename T>
+std::from_chars_result readNumber(const char* p, const char* last, T& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (last - p >= 4 && std::memcmp(p, "null", 4) == 0) {
+            value = std::numeric_limits<T>::quiet_NaN();
+            return { p + 4, std::errc() };
+        }
+        T number{};
+        std::from_chars_result result = std::from_chars(p, last, number);
+        if (result.ec != std::errc()) return result;
+        if (!std::isfinite(number)) return textError(p);
+        value = number;
+        return result;
+    } else {
+        return std::from_chars(p, last, value);
+    }
+}
+
+// Reads "[a, b, ...]" with at most maxCount numbers.
+template<typename T>
+std::from_chars_result readNumberList(const char* p, const char* last, T* values, std::size_t maxCount, std::size_t& count) {
+    count = 0;
+    if (!expectText(p, last, '[')) return textError(p);
+    if (expectText(p, last, ']')) return { p, std::errc() };
+    for (;;) {
+        if (count == maxCount) return textError(p);
+        p = skipTextSpace(p, last);
+        std::from_chars_result result = readNumber(p, last, values[count]);
+        if (result.ec != std::errc()) return result;
+        p = result.ptr;
+        ++count;
+        if (expectText(p, last, ']')) return { p, std::errc() };
+        if (!expectText(p, last, ',')) return textError(p);
+    }
+}
+
+template<typename T>
+std::from_chars_result readNumbers(const char* p, const char* last, T* values, std::size_t count) {
+    std::size_t read = 0;
+    std::from_chars_result result = readNumberList(p, last, values, count, read);
+    if (result.ec == std::errc() && read != count) return textError(result.ptr - 1);
+    return result;
+}
+
+// Skips a JSON string, number, literal, array or object.
+inline const char* skipTextValue(const char* p, const char* last, int depth = 0) {
+    p = skipTextSpace(p, last);
+    if (p == last || depth > 64) return nullptr;
+    if (*p == '"') {
+        for (++p; p != last; ++p) {
+            if (*p == '\\') {
+                if (++p == last) return nullptr;
+            } else if (*p == '"') {
+                return p + 1;
+            }
+        }
+        return nullptr;
+    }
+    if (*p == '[' || *p == '{') {
+        char close = *p == '[' ? ']' : '}';
+        ++p;
+        if (expectText(p, last, close)) return p;
+        for (;;) {
+            if (close == '}') {
+                p = skipTextValue(p, last, depth + 1);
+                if (p == nullptr || !expectText(p, last, ':')) return nullptr;
+            }
+            p = skipTextValue(p, last, depth + 1);
+            if (p == nullptr) return nullptr;
+            if (expectText(p, last, close)) return p;
+            if (!expectText(p, last, ',')) return nullptr;
+        }
+    }
+    const char* start = p;
+    while (p != last && *p != ',' && *p != ']' && *p != '}' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') ++p;
+    return p == start ? nullptr : p;
+}
+
+// Reads an object; field(key, p, known) parses the value of a known key.
+// For other keys it sets known to false and the value is skipped.
+template<typename Field>
+std::from_chars_result readObject(const char* p, const char* last, Field&& field) {
+    if (!expectText(p, last, '{')) return textError(p);
+    if (expectText(p, last, '}')) return { p, std::errc() };
+    for (;;) {
+        if (!expectText(p, last, '"')) return textError(p);
+        const char* keyStart = p;
+        while (p != last && *p != '"' && *p != '\\') ++p;
+        if (p == last || *p != '"') return textError(p);
+        std::string_view key(keyStart, static_cast<std::size_t>(p - keyStart));
+        ++p;
+        if (!expectText(p, last, ':')) return textError(p);
+
+        bool known = false;
+        std::from_chars_result result = field(key, p, known);
+        if (known) {
+            if (result.ec != std::errc()) return result;
+            p = result.ptr;
+        } else {
+            const char* end = skipTextValue(p, last);
+            if (end == nullptr) return textError(p);
+            p = end;
+        }
+
+        if (expectText(p, last, '}')) return { p, std::errc() };
+        if (!expectText(p, last, ',')) return textError(p);
+    }
+}
+
+} // namespace detail
+
+namespace math {
+
+template<typename T, typename>
+std::to_chars_result toChars(char* first, char* last, T value) {
+    return detail::finishText(detail::writeNumber(first, last, value), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Vector2<T>& v) {
+    const T values[] = { v.x, v.y };
+    return detail::finishText(detail::writeNumbers(first, last, values, 2), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Vector3<T>& v) {
+    const T values[] = { v.x, v.y, v.z };
+    return detail::finishText(detail::writeNumbers(first, last, values, 3), last);
+}
+
+template<typename T, std::size_t N>
+std::to_chars_result toChars(char* first, char* last, const Vector<T, N>& v) {
+    T values[N];
+    for (std::size_t i = 0; i < N; ++i) values[i] = v.at(i);
+    return detail::finishText(detail::writeNumbers(first, last, values, N), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Quaternion<T>& q) {
+    const T values[] = { q.w, q.x, q.y, q.z };
+    return detail::finishText(detail::writeNumbers(first, last, values, 4), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Rect<T>& r) {
+    const T values[] = { r.x, r.y, r.width, r.height };
+    return detail::finishText(detail::writeNumbers(first, last, values, 4), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Matrix4x4<T>& m) {
+    T values[16];
+    for (int i = 0; i < 16; ++i) values[i] = m.data[i / 4][i % 4];
+    return detail::finishText(detail::writeNumbers(first, last, values, 16), last);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+std::to_chars_result toChars(char* first, char* last, const Matrix<T, R, C>& m) {
+    T values[R * C];
+    for (std::size_t i = 0; i < R * C; ++i) values[i] = m.data[i / C][i % C];
+    return detail::finishText(detail::writeNumbers(first, last, values, R * C), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Ray<T>& ray) {
+    char* p = detail::writeKey(first, last, "origin", true);
+    p = detail::writeValue(p, last, ray.origin);
+    p = detail::writeKey(p, last, "direction", false);
+    p = detail::writeValue(p, last, ray.direction);
+    return detail::finishText(detail::writeText(p, last, "}"), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const AABB<T>& box) {
+    char* p = detail::writeKey(first, last, "min", true);
+    p = detail::writeValue(p, last, box.min);
+    p = detail::writeKey(p, last, "max", false);
+    p = detail::writeValue(p, last, box.max);
+    return detail::finishText(detail::writeText(p, last, "}"), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Plane<T>& plane) {
+    char* p = detail::writeKey(first, last, "normal", true);
+    p = detail::writeValue(p, last, plane.normal);
+    p = detail::writeKey(p, last, "distance", false);
+    p = detail::writeNumber(p, last, plane.distance);
+    return detail::finishText(detail::writeText(p, last, "}"), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Sphere<T>& sphere) {
+    char* p = detail::writeKey(first, last, "center", true);
+    p = detail::writeValue(p, last, sphere.center);
+    p = detail::writeKey(p, last, "radius", false);
+    p = detail::writeNumber(p, last, sphere.radius);
+    return detail::finishText(detail::writeText(p, last, "}"), last);
+}
+
+template<typename T>
+std::to_chars_result toChars(char* first, char* last, const Transform<T>& transform) {
+    char* p = detail::writeKey(first, last, "position", true);
+    p = detail::writeValue(p, last, transform.position);
+    p = detail::writeKey(p, last, "rotation", false);
+    p = detail::writeValue(p, last, transform.rotation);
+    p = detail::writeKey(p, last, "scale", false);
+    p = detail::writeValue(p, last, transform.scale);
+    return detail::finishText(detail::writeText(p, last, "}"), last);
+}
+
+template<typename T, typename>
+std::from_chars_result fromChars(const char* first, const char* last, T& value) {
+    return detail::readNumber(detail::skipTextSpace(first, last), last, value);
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Vector2<T>& v) {
+    T values[2];
+    std::from_chars_result result = detail::readNumbers(first, last, values, 2);
+    if (result.ec == std::errc()) v = Vector2<T>(values[0], values[1]);
+    return result;
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Vector3<T>& v) {
+    T values[3];
+    std::from_chars_result result = detail::readNumbers(first, last, values, 3);
+    if (result.ec == std::errc()) v = Vector3<T>(values[0], values[1], values[2]);
+    return result;
+}
+
+template<typename T, std::size_t N>
+std::from_chars_result fromChars(const char* first, const char* last, Vector<T, N>& v) {
+    T values[N];
+    std::from_chars_result result = detail::readNumbers(first, last, values, N);
+    if (result.ec == std::errc()) {
+        for (std::size_t i = 0; i < N; ++i) v.at(i) = values[i];
+    }
+    return result;
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Quaternion<T>& q) {
+    T values[4];
+    std::from_chars_result result = detail::readNumbers(first, last, values, 4);
+    if (result.ec == std::errc()) q = Quaternion<T>(values[0], values[1], values[2], values[3]);
+    return result;
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Rect<T>& r) {
+    T values[4];
+    std::from_chars_result result = detail::readNumbers(first, last, values, 4);
+    if (result.ec == std::errc()) r = Rect<T>(values[0], values[1], values[2], values[3]);
+    return result;
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Matrix4x4<T>& m) {
+    T values[16];
+    std::from_chars_result result = detail::readNumbers(first, last, values, 16);
+    if (result.ec == std::errc()) {
+        for (int i = 0; i < 16; ++i) m.data[i / 4][i % 4] = values[i];
+    }
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+std::from_chars_result fromChars(const char* first, const char* last, Matrix<T, R, C>& m) {
+    T values[R * C];
+    std::from_chars_result result = detail::readNumbers(first, last, values, R * C);
+    if (result.ec == std::errc()) {
+        for (std::size_t i = 0; i < R * C; ++i) m.data[i / C][i % C] = values[i];
+    }
+    return result;
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Ray<T>& ray) {
+    return detail::readObject(first, last, [&](std::string_view key, const char* p, bool& known) {
+        known = true;
+        if (key == "origin") return fromChars(p, last, ray.origin);
+        if (key == "direction") return fromChars(p, last, ray.direction);
+        known = false;
+        return std::from_chars_result{ p, std::errc() };
+    });
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, AABB<T>& box) {
+    return detail::readObject(first, last, [&](std::string_view key, const char* p, bool& known) {
+        known = true;
+        if (key == "min") return fromChars(p, last, box.min);
+        if (key == "max") return fromChars(p, last, box.max);
+        known = false;
+        return std::from_chars_result{ p, std::errc() };
+    });
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Plane<T>& plane) {
+    return detail::readObject(first, last, [&](std::string_view key, const char* p, bool& known) {
+        known = true;
+        if (key == "normal") return fromChars(p, last, plane.normal);
+        if (key == "distance") return fromChars(p, last, plane.distance);
+        known = false;
+        return std::from_chars_result{ p, std::errc() };
+    });
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Sphere<T>& sphere) {
+    return detail::readObject(first, last, [&](std::string_view key, const char* p, bool& known) {
+        known = true;
+        if (key == "center") return fromChars(p, last, sphere.center);
+        if (key == "radius") return fromChars(p, last, sphere.radius);
+        known = false;
+        return std::from_chars_result{ p, std::errc() };
+    });
+}
+
+template<typename T>
+std::from_chars_result fromChars(const char* first, const char* last, Transform<T>& transform) {
+    return detail::readObject(first, last, [&](std::string_view key, const char* p, bool& known) {
+        known = true;
+        if (key == "position") return fromChars(p, last, transform.position);
+        if (key == "scale") return fromChars(p, last, transform.scale);
+        if (key == "rotation") {
+            T values[4];
+            std::size_t count = 0;
+            std::from_chars_result result = detail::readNumberList(p, last, values, 4, count);
+            if (result.ec != std::errc()) return result;
+            if (count == 4) {
+                transform.rotation = Quaternion<T>(values[0], values[1], values[2], values[3]);
+            } else if (count == 3) {
+                // (roll, pitch, yaw), as returned by toEulerAngles().
+                transform.rotation = Quaternion<T>::fromEulerAngles(values[1], values[2], values[0]);
+            } else {
+                return detail::textError(p);
+            }
+            return result;
+        }
+        known = false;
+        return std::from_chars_result{ p, std::errc() };
+    });
+}
+
+template<typename V>
+std::to_chars_result toChars(char* first, char* last, const V* values, std::size_t count) {
+    char* p = detail::writeText(first, last, "[");
+    for (std::size_t i = 0; i < count && p != nullptr; ++i) {
+        if (i > 0) p = detail::writeText(p, last, ", ");
+        if (p == nullptr) break;
+        std::to_chars_result result = toChars(p, last, values[i]);
+        p = result.ec == std::errc() ? result.ptr : nullptr;
+    }
+    return detail::finishText(detail::writeText(p, last, "]"), last);
+}
+
+template<typename V>
+std::from_chars_result fromChars(const char* first, const char* last, std::vector<V>& values) {
+    const char* p = first;
+    if (!detail::expectText(p, last, '[')) return detail::textError(p);
+    if (detail::expectText(p, last, ']')) return { p, std::errc() };
+    for (;;) {
+        V value{};
+        std::from_chars_result result = fromChars(p, last, value);
+        if (result.ec != std::errc()) return result;
+        values.push_back(value);
+        p = result.ptr;
+        if (detail::expectText(p, last, ']')) return { p, std::errc() };
+        if (!detail::expectText(p, last, ',')) return detail::textError(p);
+    }
+}
+
+template<typename V>
+std::string toString(const V& value) {
+    std::string text(64, '\0');
+    for (;;) {
+        std::to_chars_result result = toChars(text.data(), text.data() + text.size(), value);
+        if (result.ec == std::errc()) {
+            text.resize(static_cast<std::size_t>(result.ptr - text.data()));
+            return text;
+        }
+        text.resize(text.size() * 2);
+    }
+}
+
+template<typename V>
+std::string toString(const V* values, std::size_t count) {
+    std::string text(count * 32 + 64, '\0');
+    std::size_t length = 0;
+    auto append = [&](auto&& write) {
+        for (;;) {
+            std::to_chars_result result = write(text.data() + length, text.data() + text.size());
+            if (result.ec == std::errc()) {
+                length = static_cast<std::size_t>(result.ptr - text.data());
+                return;
+            }
+            text.resize(text.size() * 2);
+        }
+    };
+
+    append([](char* p, char* last) { return detail::finishText(detail::writeText(p, last, "["), last); });
+    for (std::size_t i = 0; i < count; ++i) {
+        append([&](char* p, char* last) {
+            if (i > 0) p = detail::writeText(p, last, ", ");
+            return p ? toChars(p, last, values[i]) : detail::textOverflow(last);
+        });
+    }
+    append([](char* p, char* last) { return detail::finishText(detail::writeText(p, last, "]"), last); });
+    text.resize(length);
+    return text;
+}
+
+template<typename V>
+V parse(std::string_view text) {
+    V value{};
+    const char* last = text.data() + text.size();
+    std::from_chars_result result = fromChars(text.data(), last, value);
+    if (result.ec != std::errc() || detail::skipTextSpace(result.ptr, last) != last) {
+        throw std::invalid_argument("Invalid value at offset " + std::to_string(result.ptr - text.data()));
+    }
+    return value;
+}
+
+template<typename V>
+std::vector<V> parseArray(std::string_view text) {
+    std::vector<V> values;
+    const char* last = text.data() + text.size();
+    std::from_chars_result result = fromChars(text.data(), last, values);
+    if (result.ec != std::errc() || detail::skipTextSpace(result.ptr, last) != last) {
+        throw std::invalid_argument("Invalid array at offset " + std::to_string(result.ptr - text.data()));
+    }
+    return values;
+}
+
+} // namespace math
+
+#endif // MATHSERIALIZATION_INL
@@ -2,8 +2,11 @@
 #define MATRIX4X4_H
 
 #include <array>
+#include "MathFunctions.h"
 #include "Vector3.h"
 
+RENDERFX_STRICT_FP_BEGIN
+
 /**
  * @brief A 4x4 matrix class template.
  * 
@@ -27,7 +30,7 @@ public:
      * 
      * @param values An array containing 16 elements to initialize the matrix.
      */
-    Matrix4x4(const std::array<T, 16>& values);
+    constexpr Matrix4x4(const std::array<T, 16>& values);
 
     /**
      * @brief Accesses an element of the matrix.
@@ -36,7 +39,7 @@ public:
      * @param col The column index.
      * @return Reference to the element at the specified position.
      */
-    T& operator()(int row, int col);
+    constexpr T& operator()(int row, int col);
 
     /**
      * @brief Accesses an element of the matrix (const version).
@@ -45,7 +48,7 @@ public:
      * @param col The column index.
      * @return Constant reference to the element at the specified position.
      */
-    const T& operator()(int row, int col) const;
+    constexpr const T& operator()(int row, int col) const;
 
     /**
      * @brief Multiplies this matrix by another matrix.
@@ -53,7 +56,7 @@ public:
      * @param other The matrix to multiply by.
      * @return The result of the matrix multiplication.
      */
-    Matrix4x4 operator*(const Matrix4x4& other) const;
+    constexpr Matrix4x4 operator*(const Matrix4x4& other) const;
 
     /**
      * @brief Multiplies this matrix by a vector.
@@ -61,26 +64,26 @@ public:
      * @param vec The vector to multiply by.
      * @return The transformed vector.
      */
-    Vector3<T> operator*(const Vector3<T>& vec) const;
+    constexpr Vector3<T> operator*(const Vector3<T>& vec) const;
 
     /**
      * @brief Sets this matrix to the identity matrix.
      */
-    void setIdentity();
+    constexpr void setIdentity();
 
     /**
      * @brief Returns the transpose of this matrix.
      * 
      * @return The transposed matrix.
      */
-    Matrix4x4 transposed() const;
+    constexpr Matrix4x4 transposed() const;
 
     /**
      * @brief Creates an identity matrix.
      * 
      * @return The identity matrix.
      */
-    static Matrix4x4 identity();
+    static constexpr Matrix4x4 identity();
 
     /**
      * @brief Creates a translation matrix.
@@ -88,7 +91,7 @@ public:
      * @param translation The translation vector.
      * @return The translation matrix.
      */
-    static Matrix4x4 translation(const Vector3<T>& translation);
+    static constexpr Matrix4x4 translation(const Vector3<T>& translation);
 
     /**
      * @brief Creates a scaling matrix.
@@ -96,7 +99,7 @@ public:
      * @param scale The scaling vector.
      * @return The scaling matrix.
      */
-    static Matrix4x4 scaling(const Vector3<T>& scale);
+    static constexpr Matrix4x4 scaling(const Vector3<T>& scale);
 
     /**
      * @brief Creates a rotation matrix around the X-axis.
@@ -104,7 +107,7 @@ public:
      * @param angle The rotation angle in radians.
      * @return The rotation matrix.
      */
-    static Matrix4x4 rotationX(T angle);
+    static constexpr Matrix4x4 rotationX(T angle);
 
     /**
      * @brief Creates a rotation matrix around the Y-axis.
@@ -112,7 +115,7 @@ public:
      * @param angle The rotation angle in radians.
      * @return The rotation matrix.
      */
-    static Matrix4x4 rotationY(T angle);
+    static constexpr Matrix4x4 rotationY(T angle);
 
     /**
      * @brief Creates a rotation matrix around the Z-axis.
@@ -120,7 +123,7 @@ public:
      * @param angle The rotation angle in radians.
      * @return The rotation matrix.
      */
-    static Matrix4x4 rotationZ(T angle);
+    static constexpr Matrix4x4 rotationZ(T angle);
 
     /**
      * @brief Creates a look-at matrix.
@@ -130,7 +133,7 @@ public:
      * @param up The up direction.
      * @return The look-at matrix.
      */
-    static Matrix4x4 lookAt(const Vector3<T>& eye, const Vector3<T>& center, const Vector3<T>& up);
+    static constexpr Matrix4x4 lookAt(const Vector3<T>& eye, const Vector3<T>& center, const Vector3<T>& up);
 
     /**
      * @brief Creates an orthographic projection matrix.
@@ -143,7 +146,7 @@ public:
      * @param farVal The far plane.
      * @return The orthographic projection matrix.
      */
-    static Matrix4x4 orthographic(T left, T right, T bottom, T top, T nearVal, T farVal);
+    static constexpr Matrix4x4 orthographic(T left, T right, T bottom, T top, T nearVal, T farVal);
 
     /**
      * @brief Creates a perspective projection matrix.
@@ -154,21 +157,38 @@ public:
      * @param far The far plane.
      * @return The perspective projection matrix.
      */
-    static Matrix4x4 perspective(T fov, T aspectRatio, T near, T far);
+    static constexpr Matrix4x4 perspective(T fov, T aspectRatio, T near, T far);
 
     /**
      * @brief Computes the inverse of this matrix.
      * 
      * @return The inverse of this matrix.
      */
-    Matrix4x4 inverse() const;
+    constexpr Matrix4x4 inverse() const;
 
     /**
      * @brief Computes the determinant of this matrix.
      * 
      * @return The determinant of the matrix.
      */
-    T determinant() const;
+    constexpr T determinant() const;
+
+    /**
+     * @brief Checks if all elements are finite.
+     * 
+     * @return False if any element is NaN or infinite.
+     */
+    constexpr bool isFinite() const;
+
+    /**
+     * @brief Outputs the matrix to a stream, row by row.
+     * 
+     * @param os The output stream.
+     * @param m The matrix to output.
+     * @return The output stream.
+     */
+    template<typename U>
+    friend std::ostream& operator<<(std::ostream& os, const Matrix4x4<U>& m);
 };
 
 // Commonly used types
@@ -177,4 +197,6 @@ using Matrix4d = Matrix4x4<double>;
 
 #include "Matrix4x4.inl"
 
+RENDERFX_STRICT_FP_END
+
 #endif // MATRIX4X4_H
@@ -9,24 +9,25 @@ template<typename T>
 constexpr Matrix4x4<T>::Matrix4x4() : data{ {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}} } {}
 
 template<typename T>
-Matrix4x4<T>::Matrix4x4(const std::array<T, 16>& values) {
+constexpr Matrix4x4<T>::Matrix4x4(const std::array<T, 16>& values) : data{} {
     for (int i = 0; i < 16; ++i) {
         data[i / 4][i % 4] = values[i];
     }
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Matrix4x4::Matrix4x4", *this);
 }
 
 template<typename T>
-T& Matrix4x4<T>::operator()(int row, int col) {
+constexpr T& Matrix4x4<T>::operator()(int row, int col) {
     return data[row][col];
 }
 
 template<typename T>
-const T& Matrix4x4<T>::operator()(int row, int col) const {
+constexpr const T& Matrix4x4<T>::operator()(int row, int col) const {
     return data[row][col];
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4<T>& other) const {
+constexpr Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4<T>& other) const {
     Matrix4x4<T> result;
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
@@ -36,30 +37,30 @@ Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4<T>& other) const {
             }
         }
     }
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::operator*", result, *this, other);
 }
 
 template<typename T>
-Vector3<T> Matrix4x4<T>::operator*(const Vector3<T>& vec) const {
+constexpr Vector3<T> Matrix4x4<T>::operator*(const Vector3<T>& vec) const {
     T x = vec.x * (*this)(0, 0) + vec.y * (*this)(0, 1) + vec.z * (*this)(0, 2) + (*this)(0, 3);
     T y = vec.x * (*this)(1, 0) + vec.y * (*this)(1, 1) + vec.z * (*this)(1, 2) + (*this)(1, 3);
     T z = vec.x * (*this)(2, 0) + vec.y * (*this)(2, 1) + vec.z * (*this)(2, 2) + (*this)(2, 3);
     T w = vec.x * (*this)(3, 0) + vec.y * (*this)(3, 1) + vec.z * (*this)(3, 2) + (*this)(3, 3);
 
-    if (std::abs(w) > std::numeric_limits<T>::epsilon()) {
+    if (math::abs(w) > std::numeric_limits<T>::epsilon()) {
         x /= w; y /= w; z /= w;
     }
 
-    return Vector3<T>(x, y, z);
+    return RENDERFX_CHECK_FINITE("Matrix4x4::operator*", Vector3<T>(x, y, z), *this, vec);
 }
 
 template<typename T>
-void Matrix4x4<T>::setIdentity() {
+constexpr void Matrix4x4<T>::setIdentity() {
     data = { {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}} };
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::transposed() const {
+constexpr Matrix4x4<T> Matrix4x4<T>::transposed() const {
     Matrix4x4<T> result;
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
@@ -70,12 +71,12 @@ Matrix4x4<T> Matrix4x4<T>::transposed() const {
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::identity() {
+constexpr Matrix4x4<T> Matrix4x4<T>::identity() {
     return Matrix4x4<T>();
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::translation(const Vector3<T>& translation) {
+constexpr Matrix4x4<T> Matrix4x4<T>::translation(const Vector3<T>& translation) {
     Matrix4x4<T> result;
     result.setIdentity();
     result(0, 3) = translation.x;
@@ -85,7 +86,7 @@ Matrix4x4<T> Matrix4x4<T>::translation(const Vector3<T>& translation) {
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::scaling(const Vector3<T>& scale) {
+constexpr Matrix4x4<T> Matrix4x4<T>::scaling(const Vector3<T>& scale) {
     Matrix4x4<T> result;
     result.setIdentity();
     result(0, 0) = scale.x;
@@ -95,46 +96,46 @@ Matrix4x4<T> Matrix4x4<T>::scaling(const Vector3<T>& scale) {
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::rotationX(T angle) {
+constexpr Matrix4x4<T> Matrix4x4<T>::rotationX(T angle) {
     Matrix4x4<T> result;
     result.setIdentity();
-    T c = std::cos(angle);
-    T s = std::sin(angle);
+    T c = math::cos(angle);
+    T s = math::sin(angle);
     result(1, 1) = c;
     result(1, 2) = -s;
     result(2, 1) = s;
     result(2, 2) = c;
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::rotationX", result, angle);
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::rotationY(T angle) {
+constexpr Matrix4x4<T> Matrix4x4<T>::rotationY(T angle) {
     Matrix4x4<T> result;
     result.setIdentity();
-    T c = std::cos(angle);
-    T s = std::sin(angle);
+    T c = math::cos(angle);
+    T s = math::sin(angle);
     result(0, 0) = c;
     result(0, 2) = s;
     result(2, 0) = -s;
     result(2, 2) = c;
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::rotationY", result, angle);
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::rotationZ(T angle) {
+constexpr Matrix4x4<T> Matrix4x4<T>::rotationZ(T angle) {
     Matrix4x4<T> result;
     result.setIdentity();
-    T c = std::cos(angle);
-    T s = std::sin(angle);
+    T c = math::cos(angle);
+    T s = math::sin(angle);
     result(0, 0) = c;
     result(0, 1) = -s;
     result(1, 0) = s;
     result(1, 1) = c;
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::rotationZ", result, angle);
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::lookAt(const Vector3<T>& eye, const Vector3<T>& center, const Vector3<T>& up) {
+constexpr Matrix4x4<T> Matrix4x4<T>::lookAt(const Vector3<T>& eye, const Vector3<T>& center, const Vector3<T>& up) {
     Vector3<T> f = (center - eye).normalized();
     Vector3<T> s = f.cross(up).normalized();
     Vector3<T> u = s.cross(f);
@@ -153,11 +154,11 @@ Matrix4x4<T> Matrix4x4<T>::lookAt(const Vector3<T>& eye, const Vector3<T>& cente
     result(1, 3) = -u.dot(eye);
     result(2, 3) = f.dot(eye);
     result(3, 3) = 1;
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::lookAt", result, eye, center, up);
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::orthographic(T left, T right, T bottom, T top, T nearVal, T farVal) {
+constexpr Matrix4x4<T> Matrix4x4<T>::orthographic(T left, T right, T bottom, T top, T nearVal, T farVal) {
     Matrix4x4<T> result;
     result(0, 0) = 2 / (right - left);
     result(1, 1) = 2 / (top - bottom);
@@ -166,26 +167,25 @@ Matrix4x4<T> Matrix4x4<T>::orthographic(T left, T right, T bottom, T top, T near
     result(1, 3) = -(top + bottom) / (top - bottom);
     result(2, 3) = -(farVal + nearVal) / (farVal - nearVal);
     result(3, 3) = 1;
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::orthographic", result, left, right, bottom, top, nearVal, farVal);
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::perspective(T fov, T aspectRatio, T near, T far) {
+constexpr Matrix4x4<T> Matrix4x4<T>::perspective(T fov, T aspectRatio, T near, T far) {
     Matrix4x4<T> result;
-    T tanHalfFov = std::tan(fov / 2);
+    T tanHalfFov = math::tan(fov / 2);
     result(0, 0) = 1 / (aspectRatio * tanHalfFov);
     result(1, 1) = 1 / tanHalfFov;
     result(2, 2) = -(far + near) / (far - near);
     result(2, 3) = -(2 * far * near) / (far - near);
     result(3, 2) = -1;
     result(3, 3) = 0;
-    return result;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::perspective", result, fov, aspectRatio, near, far);
 }
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::inverse() const {
+constexpr Matrix4x4<T> Matrix4x4<T>::inverse() const {
     Matrix4x4<T> inv;
-    T det;
 
     inv(0, 0) = data[1][1] * data[2][2] * data[3][3] -
         data[1][1] * data[2][3] * data[3][2] -
@@ -215,9 +215,93 @@ Matrix4x4<T> Matrix4x4<T>::inverse() const {
         data[3][0] * data[1][1] * data[2][2] +
         data[3][0] * data[1][2] * data[2][1];
 
-    det = data[0][0] * inv(0, 0) + data[0][1] * inv(1, 0) + data[0][2] * inv(2, 0) + data[0][3] * inv(3, 0);
-
-    if (std::abs(det) < std::numeric_limits<T>::epsilon()) {
+    inv(0, 1) = -data[0][1] * data[2][2] * data[3][3] +
+        data[0][1] * data[2][3] * data[3][2] +
+        data[2][1] * data[0][2] * data[3][3] -
+        data[2][1] * data[0][3] * data[3][2] -
+        data[3][1] * data[0][2] * data[2][3] +
+        data[3][1] * data[0][3] * data[2][2];
+
+    inv(1, 1) = data[0][0] * data[2][2] * data[3][3] -
+        data[0][0] * data[2][3] * data[3][2] -
+        data[2][0] * data[0][2] * data[3][3] +
+        data[2][0] * data[0][3] * data[3][2] +
+        data[3][0] * data[0][2] * data[2][3] -
+        data[3][0] * data[0][3] * data[2][2];
+
+    inv(2, 1) = -data[0][0] * data[2][1] * data[3][3] +
+        data[0][0] * data[2][3] * data[3][1] +
+        data[2][0] * data[0][1] * data[3][3] -
+        data[2][0] * data[0][3] * data[3][1] -
+        data[3][0] * data[0][1] * data[2][3] +
+        data[3][0] * data[0][3] * data[2][1];
+
+    inv(3, 1) = data[0][0] * data[2][1] * data[3][2] -
+        data[0][0] * data[2][2] * data[3][1] -
+        data[2][0] * data[0][1] * data[3][2] +
+        data[2][0] * data[0][2] * data[3][1] +
+        data[3][0] * data[0][1] * data[2][2] -
+        data[3][0] * data[0][2] * data[2][1];
+
+    inv(0, 2) = data[0][1] * data[1][2] * data[3][3] -
+        data[0][1] * data[1][3] * data[3][2] -
+        data[1][1] * data[0][2] * data[3][3] +
+        data[1][1] * data[0][3] * data[3][2] +
+        data[3][1] * data[0][2] * data[1][3] -
+        data[3][1] * data[0][3] * data[1][2];
+
+    inv(1, 2) = -data[0][0] * data[1][2] * data[3][3] +
+        data[0][0] * data[1][3] * data[3][2] +
+        data[1][0] * data[0][2] * data[3][3] -
+        data[1][0] * data[0][3] * data[3][2] -
+        data[3][0] * data[0][2] * data[1][3] +
+        data[3][0] * data[0][3] * data[1][2];
+
+    inv(2, 2) = data[0][0] * data[1][1] * data[3][3] -
+        data[0][0] * data[1][3] * data[3][1] -
+        data[1][0] * data[0][1] * data[3][3] +
+        data[1][0] * data[0][3] * data[3][1] +
+        data[3][0] * data[0][1] * data[1][3] -
+        data[3][0] * data[0][3] * data[1][1];
+
+    inv(3, 2) = -data[0][0] * data[1][1] * data[3][2] +
+        data[0][0] * data[1][2] * data[3][1] +
+        data[1][0] * data[0][1] * data[3][2] -
+        data[1][0] * data[0][2] * data[3][1] -
+        data[3][0] * data[0][1] * data[1][2] +
+        data[3][0] * data[0][2] * data[1][1];
+
+    inv(0, 3) = -data[0][1] * data[1][2] * data[2][3] +
+        data[0][1] * data[1][3] * data[2][2] +
+        data[1][1] * data[0][2] * data[2][3] -
+        data[1][1] * data[0][3] * data[2][2] -
+        data[2][1] * data[0][2] * data[1][3] +
+        data[2][1] * data[0][3] * data[1][2];
+
+    inv(1, 3) = data[0][0] * data[1][2] * data[2][3] -
+        data[0][0] * data[1][3] * data[2][2] -
+        data[1][0] * data[0][2] * data[2][3] +
+        data[1][0] * data[0][3] * data[2][2] +
+        data[2][0] * data[0][2] * data[1][3] -
+        data[2][0] * data[0][3] * data[1][2];
+
+    inv(2, 3) = -data[0][0] * data[1][1] * data[2][3] +
+        data[0][0] * data[1][3] * data[2][1] +
+        data[1][0] * data[0][1] * data[2][3] -
+        data[1][0] * data[0][3] * data[2][1] -
+        data[2][0] * data[0][1] * data[1][3] +
+        data[2][0] * data[0][3] * data[1][1];
+
+    inv(3, 3) = data[0][0] * data[1][1] * data[2][2] -
+        data[0][0] * data[1][2] * data[2][1] -
+        data[1][0] * data[0][1] * data[2][2] +
+        data[1][0] * data[0][2] * data[2][1] +
+        data[2][0] * data[0][1] * data[1][2] -
+        data[2][0] * data[0][2] * data[1][1];
+
+    T det = data[0][0] * inv(0, 0) + data[0][1] * inv(1, 0) + data[0][2] * inv(2, 0) + data[0][3] * inv(3, 0);
+
+    if (math::abs(det) < std::numeric_limits<T>::epsilon()) {
         throw std::runtime_error("Matrix is singular and cannot be inverted.");
     }
 
@@ -229,11 +313,11 @@ Matrix4x4<T> Matrix4x4<T>::inverse() const {
         }
     }
 
-    return inv;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::inverse", inv, *this);
 }
 
 template<typename T>
-T Matrix4x4<T>::determinant() const {
+constexpr T Matrix4x4<T>::determinant() const {
     T det = data[0][0] * (data[1][1] * data[2][2] * data[3][3] + data[1][2] * data[2][3] * data[3][1] + data[1][3] * data[2][1] * data[3][2]
         - data[1][3] * data[2][2] * data[3][1] - data[1][1] * data[2][3] * data[3][2] - data[1][2] * data[2][1] * data[3][3])
         - data[0][1] * (data[1][0] * data[2][2] * data[3][3] + data[1][2] * data[2][3] * data[3][0] + data[1][3] * data[2][0] * data[3][2]
@@ -243,7 +327,26 @@ T Matrix4x4<T>::determinant() const {
         - data[0][3] * (data[1][0] * data[2][1] * data[3][2] + data[1][1] * data[2][2] * data[3][0] + data[1][2] * data[2][0] * data[3][1]
             - data[1][2] * data[2][1] * data[3][0] - data[1][0] * data[2][2] * data[3][1] - data[1][1] * data[2][0] * data[3][2]);
 
-    return det;
+    return RENDERFX_CHECK_FINITE("Matrix4x4::determinant", det, *this);
+}
+
+template<typename T>
+constexpr bool Matrix4x4<T>::isFinite() const {
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            if (!detail::isFiniteValue(data[i][j])) return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const Matrix4x4<T>& m) {
+    os << "Matrix4x4(";
+    for (int i = 0; i < 4; ++i) {
+        os << (i == 0 ? "[" : ", [") << m(i, 0) << ", " << m(i, 1) << ", " << m(i, 2) << ", " << m(i, 3) << "]";
+    }
+    return os << ")";
 }
 
 #endif // MATRIX4X4_INL
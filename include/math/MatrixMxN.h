@@ -0,0 +1,309 @@
+#ifndef MATRIXMXN_H
+#define MATRIXMXN_H
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+#include "MathDebug.h"
+#include "MathFunctions.h"
+#include "Matrix4x4.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+#include "VectorN.h"
+
+RENDERFX_STRICT_FP_BEGIN
+
+/**
+ * @brief An R x C matrix class template.
+ *
+ * The generic counterpart of Matrix4x4, with the same conventions: the data
+ * is stored row by row and vectors are column vectors, so M * v transforms v
+ * and an affine matrix keeps its translation in the last column. A 3x4
+ * matrix is an affine transform with an implied last row of (0, 0, 0, 1).
+ * Matrix4x4 stays a separate class rather than an alias of Matrix<T, 4, 4>;
+ * the two convert with Matrix(const Matrix4x4&) and toMatrix4x4().
+ *
+ * @tparam T Type of the elements in the matrix.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ */
+template<typename T, std::size_t R, std::size_t C>
+class Matrix {
+    static_assert(R > 0 && C > 0, "Matrix must have at least one row and one column");
+
+public:
+    /// The matrix data stored as a 2D array.
+    std::array<std::array<T, C>, R> data;
+
+    /**
+     * @brief Default constructor. Initializes the matrix with ones on the
+     * diagonal and zeroes elsewhere, i.e. the identity for square and 3x4 matrices.
+     */
+    constexpr Matrix();
+
+    /**
+     * @brief Constructor that initializes the matrix with R * C values in row order.
+     *
+     * @param values The elements, row by row.
+     */
+    constexpr explicit Matrix(const std::array<T, R * C>& values);
+
+    /**
+     * @brief Takes the upper-left block of a Matrix4x4.
+     *
+     * For a 3x4 matrix this is the affine part of the transform, for a 3x3
+     * matrix its linear part.
+     *
+     * @param m The matrix.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<(RR <= 4 && CC <= 4)>>
+    constexpr explicit Matrix(const Matrix4x4<T>& m);
+
+    /**
+     * @brief Accesses an element of the matrix.
+     *
+     * @param row The row index.
+     * @param col The column index.
+     * @return Reference to the element at the specified position.
+     */
+    constexpr T& operator()(std::size_t row, std::size_t col);
+
+    /**
+     * @brief Accesses an element of the matrix (const version).
+     *
+     * @param row The row index.
+     * @param col The column index.
+     * @return Constant reference to the element at the specified position.
+     */
+    constexpr const T& operator()(std::size_t row, std::size_t col) const;
+
+    /**
+     * @brief Multiplies this matrix by another matrix.
+     *
+     * @param other A C x K matrix.
+     * @return The R x K product.
+     */
+    template<std::size_t K>
+    constexpr Matrix<T, R, K> operator*(const Matrix<T, C, K>& other) const;
+
+    /**
+     * @brief Multiplies this matrix by a column vector.
+     *
+     * @param vec The vector to multiply by.
+     * @return The transformed vector.
+     */
+    constexpr Vector<T, R> operator*(const Vector<T, C>& vec) const;
+
+    constexpr Matrix operator+(const Matrix& other) const;
+
+    constexpr Matrix operator-(const Matrix& other) const;
+
+    constexpr Matrix operator*(T s) const;
+
+    /**
+     * @brief Returns the transpose of this matrix.
+     *
+     * @return The C x R transposed matrix.
+     */
+    constexpr Matrix<T, C, R> transposed() const;
+
+    /**
+     * @brief Gets a row.
+     *
+     * @param row The row index.
+     * @return The row as a vector.
+     */
+    constexpr Vector<T, C> row(std::size_t row) const;
+
+    /**
+     * @brief Gets a column.
+     *
+     * @param col The column index.
+     * @return The column as a vector.
+     */
+    constexpr Vector<T, R> column(std::size_t col) const;
+
+    constexpr void setRow(std::size_t row, const Vector<T, C>& values);
+
+    constexpr void setColumn(std::size_t col, const Vector<T, R>& values);
+
+    /**
+     * @brief Composes two affine 3x4 transforms as if both had a last row of (0, 0, 0, 1).
+     *
+     * @param other The transform applied first.
+     * @return The combined transform.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 4>>
+    constexpr Matrix multiplyAffine(const Matrix& other) const;
+
+    /**
+     * @brief Transforms a point by a 3x4 or 3x3 matrix.
+     *
+     * @param point The point.
+     * @return The transformed point; the translation column is applied if present.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && (CC == 3 || CC == 4)>>
+    constexpr Vector3<T> transformPoint(const Vector3<T>& point) const;
+
+    /**
+     * @brief Transforms a direction by the linear part of a 3x4 or 3x3 matrix.
+     *
+     * @param direction The direction.
+     * @return The transformed direction.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && (CC == 3 || CC == 4)>>
+    constexpr Vector3<T> transformDirection(const Vector3<T>& direction) const;
+
+    /**
+     * @brief Embeds the matrix in the upper-left block of an identity Matrix4x4.
+     *
+     * @return The 4x4 matrix.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<(RR <= 4 && CC <= 4)>>
+    constexpr Matrix4x4<T> toMatrix4x4() const;
+
+    /// @name 3x3 Operations
+    /// @{
+
+    /**
+     * @brief Calculates the determinant of a 3x3 matrix.
+     *
+     * @return The determinant.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    constexpr T determinant() const;
+
+    /**
+     * @brief Calculates the cofactor matrix of a 3x3 matrix.
+     *
+     * The cofactor matrix is the inverse transposed, scaled by the
+     * determinant; its rows are cross products of the rows of this matrix.
+     *
+     * @return The cofactor matrix.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    constexpr Matrix cofactor() const;
+
+    /**
+     * @brief Calculates the adjugate (transposed cofactor matrix) of a 3x3 matrix.
+     *
+     * @return The adjugate matrix.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    constexpr Matrix adjugate() const;
+
+    /**
+     * @brief Calculates the inverse of a 3x3 matrix.
+     *
+     * @return The inverse matrix.
+     * @throws std::runtime_error If the matrix is singular.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    constexpr Matrix inverse() const;
+
+    /**
+     * @brief Calculates the matrix that transforms normals for this 3x3 linear transform.
+     *
+     * Returns the cofactor matrix with the sign of the determinant, i.e. the
+     * inverse transpose scaled by |det|. Normals must be renormalized after
+     * the transform, which makes the division by the determinant unnecessary;
+     * the sign keeps normals facing outwards under mirroring transforms.
+     *
+     * @return The unnormalized normal matrix.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    constexpr Matrix normalMatrix() const;
+
+    /**
+     * @brief Creates the rotation matrix of a unit quaternion.
+     *
+     * @param q The quaternion.
+     * @return The rotation matrix.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    static constexpr Matrix fromQuaternion(const Quaternion<T>& q);
+
+    /**
+     * @brief Converts a 3x3 rotation matrix to a unit quaternion.
+     *
+     * The matrix must be orthonormal with determinant 1.
+     *
+     * @return The quaternion, with a non-negative real part.
+     */
+    template<std::size_t RR = R, std::size_t CC = C, typename = std::enable_if_t<RR == 3 && CC == 3>>
+    constexpr Quaternion<T> toQuaternion() const;
+
+    /// @}
+
+    /**
+     * @brief Compares two matrices element-wise within machine epsilon, like Vector.
+     * @param other The other matrix.
+     * @return True if every element differs by less than epsilon.
+     */
+    constexpr bool operator==(const Matrix& other) const;
+
+    constexpr bool operator!=(const Matrix& other) const;
+
+    /**
+     * @brief Checks if all elements are finite.
+     *
+     * @return False if any element is NaN or infinite.
+     */
+    constexpr bool isFinite() const;
+
+    /**
+     * @brief Creates an identity matrix.
+     *
+     * @return The identity matrix.
+     */
+    static constexpr Matrix identity();
+
+    /**
+     * @brief Creates a matrix with all elements zero.
+     *
+     * @return The zero matrix.
+     */
+    static constexpr Matrix zero();
+
+    /**
+     * @brief Overload of the stream insertion operator for Matrix.
+     *
+     * @param os The output stream.
+     * @param m The matrix to output.
+     * @return The output stream.
+     */
+    template<typename U, std::size_t RR, std::size_t CC>
+    friend std::ostream& operator<<(std::ostream& os, const Matrix<U, RR, CC>& m);
+};
+
+/**
+ * @brief Computes the normal matrices of an array of world matrices.
+ *
+ * Each output is the normalMatrix() of the upper-left 3x3 block, computed
+ * from the cofactors without a division or a full 4x4 inverse.
+ *
+ * @param worldMatrices The world matrices.
+ * @param normalMatrices Receives count normal matrices.
+ * @param count Number of matrices.
+ */
+template<typename T>
+void computeNormalMatrices(const Matrix4x4<T>* worldMatrices, Matrix<T, 3, 3>* normalMatrices, std::size_t count);
+
+// Commonly used types
+template<typename T>
+using Matrix3x3 = Matrix<T, 3, 3>;
+
+template<typename T>
+using Matrix3x4 = Matrix<T, 3, 4>;
+
+using Matrix3f = Matrix3x3<float>;
+using Matrix3d = Matrix3x3<double>;
+using Matrix3x4f = Matrix3x4<float>;
+using Matrix3x4d = Matrix3x4<double>;
+
+#include "MatrixMxN.inl"
+
+RENDERFX_STRICT_FP_END
+
+#endif // MATRIXMXN_H
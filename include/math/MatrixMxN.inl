@@ -0,0 +1,320 @@
+#ifndef MATRIXMXN_INL
+#define MATRIXMXN_INL
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C>::Matrix() : data{} {
+    for (std::size_t i = 0; i < R && i < C; ++i) data[i][i] = T(1);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C>::Matrix(const std::array<T, R * C>& values) : data{} {
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            data[i][j] = values[i * C + j];
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Matrix::Matrix", *this);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C>::Matrix(const Matrix4x4<T>& m) : data{} {
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            data[i][j] = m.data[i][j];
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr T& Matrix<T, R, C>::operator()(std::size_t row, std::size_t col) {
+    return data[row][col];
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr const T& Matrix<T, R, C>::operator()(std::size_t row, std::size_t col) const {
+    return data[row][col];
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t K>
+constexpr Matrix<T, R, K> Matrix<T, R, C>::operator*(const Matrix<T, C, K>& other) const {
+    Matrix<T, R, K> result = Matrix<T, R, K>::zero();
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t k = 0; k < C; ++k)
+            for (std::size_t j = 0; j < K; ++j)
+                result.data[i][j] += data[i][k] * other.data[k][j];
+    return RENDERFX_CHECK_FINITE("Matrix::operator*", result, *this, other);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Vector<T, R> Matrix<T, R, C>::operator*(const Vector<T, C>& vec) const {
+    Vector<T, R> result;
+    for (std::size_t i = 0; i < R; ++i) {
+        T sum = data[i][0] * vec.at(0);
+        for (std::size_t j = 1; j < C; ++j) sum += data[i][j] * vec.at(j);
+        result.at(i) = sum;
+    }
+    return RENDERFX_CHECK_FINITE("Matrix::operator*", result, *this, vec);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::operator+(const Matrix& other) const {
+    Matrix result;
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            result.data[i][j] = data[i][j] + other.data[i][j];
+    return RENDERFX_CHECK_FINITE("Matrix::operator+", result, *this, other);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::operator-(const Matrix& other) const {
+    Matrix result;
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            result.data[i][j] = data[i][j] - other.data[i][j];
+    return RENDERFX_CHECK_FINITE("Matrix::operator-", result, *this, other);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::operator*(T s) const {
+    Matrix result;
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            result.data[i][j] = data[i][j] * s;
+    return RENDERFX_CHECK_FINITE("Matrix::operator*", result, *this, s);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, C, R> Matrix<T, R, C>::transposed() const {
+    Matrix<T, C, R> result;
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            result.data[j][i] = data[i][j];
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Vector<T, C> Matrix<T, R, C>::row(std::size_t row) const {
+    Vector<T, C> result;
+    for (std::size_t j = 0; j < C; ++j) result.at(j) = data[row][j];
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Vector<T, R> Matrix<T, R, C>::column(std::size_t col) const {
+    Vector<T, R> result;
+    for (std::size_t i = 0; i < R; ++i) result.at(i) = data[i][col];
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr void Matrix<T, R, C>::setRow(std::size_t row, const Vector<T, C>& values) {
+    for (std::size_t j = 0; j < C; ++j) data[row][j] = values.at(j);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr void Matrix<T, R, C>::setColumn(std::size_t col, const Vector<T, R>& values) {
+    for (std::size_t i = 0; i < R; ++i) data[i][col] = values.at(i);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::multiplyAffine(const Matrix& other) const {
+    Matrix result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            T sum = data[i][0] * other.data[0][j] + data[i][1] * other.data[1][j] + data[i][2] * other.data[2][j];
+            result.data[i][j] = j == 3 ? sum + data[i][3] : sum;
+        }
+    }
+    return RENDERFX_CHECK_FINITE("Matrix::multiplyAffine", result, *this, other);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Vector3<T> Matrix<T, R, C>::transformPoint(const Vector3<T>& point) const {
+    Vector3<T> result = transformDirection(point);
+    if constexpr (C == 4) {
+        result.x += data[0][3];
+        result.y += data[1][3];
+        result.z += data[2][3];
+    }
+    return RENDERFX_CHECK_FINITE("Matrix::transformPoint", result, *this, point);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Vector3<T> Matrix<T, R, C>::transformDirection(const Vector3<T>& direction) const {
+    return RENDERFX_CHECK_FINITE("Matrix::transformDirection", Vector3<T>(
+        data[0][0] * direction.x + data[0][1] * direction.y + data[0][2] * direction.z,
+        data[1][0] * direction.x + data[1][1] * direction.y + data[1][2] * direction.z,
+        data[2][0] * direction.x + data[2][1] * direction.y + data[2][2] * direction.z), *this, direction);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix4x4<T> Matrix<T, R, C>::toMatrix4x4() const {
+    Matrix4x4<T> result = Matrix4x4<T>::identity();
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            result.data[i][j] = data[i][j];
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr T Matrix<T, R, C>::determinant() const {
+    return data[0][0] * (data[1][1] * data[2][2] - data[1][2] * data[2][1])
+         + data[0][1] * (data[1][2] * data[2][0] - data[1][0] * data[2][2])
+         + data[0][2] * (data[1][0] * data[2][1] - data[1][1] * data[2][0]);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::cofactor() const {
+    Matrix result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        // Row i is the cross product of the other two rows, in cyclic order.
+        const auto& a = data[(i + 1) % 3];
+        const auto& b = data[(i + 2) % 3];
+        result.data[i][0] = a[1] * b[2] - a[2] * b[1];
+        result.data[i][1] = a[2] * b[0] - a[0] * b[2];
+        result.data[i][2] = a[0] * b[1] - a[1] * b[0];
+    }
+    return RENDERFX_CHECK_FINITE("Matrix::cofactor", result, *this);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::adjugate() const {
+    return cofactor().transposed();
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::inverse() const {
+    Matrix adj = adjugate();
+    T det = data[0][0] * adj.data[0][0] + data[0][1] * adj.data[1][0] + data[0][2] * adj.data[2][0];
+
+    if (math::abs(det) < std::numeric_limits<T>::epsilon()) {
+        throw std::runtime_error("Matrix is singular and cannot be inverted.");
+    }
+
+    return RENDERFX_CHECK_FINITE("Matrix::inverse", adj * (T(1) / det), *this);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::normalMatrix() const {
+    Matrix cof = cofactor();
+    T det = data[0][0] * cof.data[0][0] + data[0][1] * cof.data[0][1] + data[0][2] * cof.data[0][2];
+    if (det < T(0)) {
+        for (auto& row : cof.data)
+            for (T& value : row) value = -value;
+    }
+    return cof;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::fromQuaternion(const Quaternion<T>& q) {
+    T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return RENDERFX_CHECK_FINITE("Matrix::fromQuaternion", Matrix(std::array<T, 9>{
+        1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+        2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+        2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy) }), q);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t RR, std::size_t CC, typename>
+constexpr Quaternion<T> Matrix<T, R, C>::toQuaternion() const {
+    // Shepperd's method: take the square root of the largest of 4w^2, 4x^2,
+    // 4y^2 and 4z^2 so the division below is well conditioned.
+    T trace = data[0][0] + data[1][1] + data[2][2];
+    Quaternion<T> q;
+    if (trace > data[0][0] && trace > data[1][1] && trace > data[2][2]) {
+        T s = static_cast<T>(math::sqrt(trace + 1)) * 2;
+        q = Quaternion<T>(s / 4, (data[2][1] - data[1][2]) / s, (data[0][2] - data[2][0]) / s, (data[1][0] - data[0][1]) / s);
+    } else if (data[0][0] >= data[1][1] && data[0][0] >= data[2][2]) {
+        T s = static_cast<T>(math::sqrt(1 + data[0][0] - data[1][1] - data[2][2])) * 2;
+        q = Quaternion<T>((data[2][1] - data[1][2]) / s, s / 4, (data[0][1] + data[1][0]) / s, (data[0][2] + data[2][0]) / s);
+    } else if (data[1][1] >= data[2][2]) {
+        T s = static_cast<T>(math::sqrt(1 + data[1][1] - data[0][0] - data[2][2])) * 2;
+        q = Quaternion<T>((data[0][2] - data[2][0]) / s, (data[0][1] + data[1][0]) / s, s / 4, (data[1][2] + data[2][1]) / s);
+    } else {
+        T s = static_cast<T>(math::sqrt(1 + data[2][2] - data[0][0] - data[1][1])) * 2;
+        q = Quaternion<T>((data[1][0] - data[0][1]) / s, (data[0][2] + data[2][0]) / s, (data[1][2] + data[2][1]) / s, s / 4);
+    }
+    if (q.w < T(0)) q = Quaternion<T>(-q.w, -q.x, -q.y, -q.z);
+    return RENDERFX_CHECK_FINITE("Matrix::toQuaternion", q, *this);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr bool Matrix<T, R, C>::operator==(const Matrix& other) const {
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+            if (!(math::abs(data[i][j] - other.data[i][j]) < std::numeric_limits<T>::epsilon())) return false;
+    return true;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr bool Matrix<T, R, C>::operator!=(const Matrix& other) const {
+    return !(*this == other);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr bool Matrix<T, R, C>::isFinite() const {
+    for (const auto& row : data)
+        for (const T& value : row)
+            if (!detail::isFiniteValue(value)) return false;
+    return true;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::identity() {
+    return Matrix();
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::zero() {
+    Matrix result;
+    for (std::size_t i = 0; i < R && i < C; ++i) result.data[i][i] = T(0);
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+std::ostream& operator<<(std::ostream& os, const Matrix<T, R, C>& m) {
+    os << "Matrix" << R << "x" << C << "(";
+    for (std::size_t i = 0; i < R; ++i) {
+        os << (i ? ", [" : "[");
+        for (std::size_t j = 0; j < C; ++j) os << (j ? ", " : "") << m.data[i][j];
+        os << "]";
+    }
+    return os << ")";
+}
+
+template<typename T>
+void computeNormalMatrices(const Matrix4x4<T>* worldMatrices, Matrix<T, 3, 3>* normalMatrices, std::size_t count) {
+    for (std::size_t n = 0; n < count; ++n) {
+        const auto& m = worldMatrices[n].data;
+        Matrix<T, 3, 3>& out = normalMatrices[n];
+        out.data[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+        out.data[0][1] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+        out.data[0][2] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+        out.data[1][0] = m[2][1] * m[0][2] - m[2][2] * m[0][1];
+        out.data[1][1] = m[2][2] * m[0][0] - m[2][0] * m[0][2];
+        out.data[1][2] = m[2][0] * m[0][1] - m[2][1] * m[0][0];
+        out.data[2][0] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+        out.data[2][1] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+        out.data[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+        // Keep normals facing outwards under mirroring transforms.
+        T det = m[0][0] * out.data[0][0] + m[0][1] * out.data[0][1] + m[0][2] * out.data[0][2];
+        T sign = det < T(0) ? T(-1) : T(1);
+        for (auto& row : out.data)
+            for (T& value : row) value *= sign;
+    }
+    RENDERFX_CHECK_FINITE_BATCH("computeNormalMatrices", normalMatrices, normalMatrices + count);
+}
+
+#endif // MATRIXMXN_INL
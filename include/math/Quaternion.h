@@ -1,10 +1,13 @@
 #ifndef QUATERNION_H
 #define QUATERNION_H
 
+#include <cstddef>
 #include <stdexcept>
 #include "Vector3.h"
 #include "Matrix4x4.h"
 
+RENDERFX_STRICT_FP_BEGIN
+
 /**
  * @brief A quaternion class template.
  * 
@@ -38,7 +41,7 @@ public:
      * @param axis The axis of rotation.
      * @param angle The angle of rotation in radians.
      */
-    Quaternion(const Vector3<T>& axis, T angle);
+    constexpr Quaternion(const Vector3<T>& axis, T angle);
 
     /**
      * @brief Multiplies this quaternion by another quaternion.
@@ -54,42 +57,58 @@ public:
      * @param v The vector to rotate.
      * @return The rotated vector.
      */
-    Vector3<T> operator*(const Vector3<T>& v) const;
+    constexpr Vector3<T> operator*(const Vector3<T>& v) const;
 
     /**
      * @brief Calculates the magnitude (norm) of the quaternion.
      * 
      * @return The magnitude of the quaternion.
      */
-    T magnitude() const;
+    constexpr T magnitude() const;
 
     /**
      * @brief Returns the normalized quaternion.
      * 
      * @return The normalized quaternion.
      */
-    Quaternion normalized() const;
+    constexpr Quaternion normalized() const;
 
     /**
      * @brief Returns the conjugate of the quaternion.
      * 
      * @return The conjugate of the quaternion.
      */
-    Quaternion conjugate() const;
+    constexpr Quaternion conjugate() const;
 
     /**
      * @brief Returns the inverse of the quaternion.
      * 
      * @return The inverse of the quaternion.
      */
-    Quaternion inverse() const;
+    constexpr Quaternion inverse() const;
+
+    /**
+     * @brief Returns the logarithm of a unit quaternion.
+     * 
+     * @return (0, axis * angle / 2) for the rotation by angle about axis.
+     */
+    Quaternion log() const;
+
+    /**
+     * @brief Returns the exponential of a pure quaternion.
+     * 
+     * The inverse of log(): the real part is ignored.
+     * 
+     * @return The unit quaternion (cos |v|, v sin |v| / |v|) of the vector part v.
+     */
+    Quaternion exp() const;
 
     /**
      * @brief Converts the quaternion to a rotation matrix.
      * 
      * @return The rotation matrix corresponding to this quaternion.
      */
-    Matrix4x4<T> toRotationMatrix() const;
+    constexpr Matrix4x4<T> toRotationMatrix() const;
 
     /**
      * @brief Converts the quaternion to Euler angles.
@@ -105,7 +124,7 @@ public:
      * @param angle The angle of rotation in radians.
      * @return The resulting quaternion.
      */
-    static Quaternion fromAxisAngle(const Vector3<T>& axis, T angle);
+    static constexpr Quaternion fromAxisAngle(const Vector3<T>& axis, T angle);
 
     /**
      * @brief Creates a quaternion from Euler angles.
@@ -115,7 +134,25 @@ public:
      * @param roll The roll angle in radians.
      * @return The resulting quaternion.
      */
-    static Quaternion fromEulerAngles(T pitch, T yaw, T roll);
+    static constexpr Quaternion fromEulerAngles(T pitch, T yaw, T roll);
+
+    /**
+     * @brief Creates quaternions from arrays of Euler angles.
+     * 
+     * The batch form of fromEulerAngles() for structure-of-arrays data; the
+     * loop has no branches or calls besides sin and cos, so it vectorizes
+     * where the standard library provides vector versions of them.
+     * 
+     * @param pitch The pitch angles in radians.
+     * @param yaw The yaw angles in radians.
+     * @param roll The roll angles in radians.
+     * @param w Receives the real parts.
+     * @param x Receives the i components.
+     * @param y Receives the j components.
+     * @param z Receives the k components.
+     * @param count Number of rotations.
+     */
+    static void fromEulerAngles(const T* pitch, const T* yaw, const T* roll, T* w, T* x, T* y, T* z, std::size_t count);
 
     /**
      * @brief Spherical linear interpolation between two quaternions.
@@ -126,6 +163,52 @@ public:
      * @return The interpolated quaternion.
      */
     static Quaternion slerp(const Quaternion& q1, const Quaternion& q2, T t);
+
+    /**
+     * @brief Spherical quadrangle interpolation between two keys of a rotation spline.
+     * 
+     * Interpolates smoothly through a sequence of keys when s1 and s2 are
+     * the control points squadControlPoint() computes for q1 and q2.
+     * 
+     * @param q1 The first key.
+     * @param q2 The second key.
+     * @param s1 The control point of q1.
+     * @param s2 The control point of q2.
+     * @param t The interpolation parameter, between 0 and 1.
+     * @return The interpolated quaternion.
+     */
+    static Quaternion squad(const Quaternion& q1, const Quaternion& q2, const Quaternion& s1, const Quaternion& s2, T t);
+
+    /**
+     * @brief Computes the squad control point of a key from its neighbours.
+     * 
+     * The keys should be unit quaternions in the same hemisphere as their
+     * neighbours; at the ends of a spline pass the key itself as the
+     * missing neighbour.
+     * 
+     * @param previous The key before.
+     * @param current The key.
+     * @param next The key after.
+     * @return The control point of current.
+     */
+    static Quaternion squadControlPoint(const Quaternion& previous, const Quaternion& current, const Quaternion& next);
+
+    /**
+     * @brief Checks if all components are finite.
+     * 
+     * @return False if any component is NaN or infinite.
+     */
+    constexpr bool isFinite() const;
+
+    /**
+     * @brief Outputs the quaternion to a stream.
+     * 
+     * @param os The output stream.
+     * @param q The quaternion to output.
+     * @return The output stream.
+     */
+    template<typename U>
+    friend std::ostream& operator<<(std::ostream& os, const Quaternion<U>& q);
 };
 
 // Commonly used types
@@ -134,4 +217,6 @@ using Quaterniond = Quaternion<double>;
 
 #include "Quaternion.inl"
 
+RENDERFX_STRICT_FP_END
+
 #endif // QUATERNION_H
@@ -9,66 +9,77 @@ template<typename T>
 constexpr Quaternion<T>::Quaternion() : w(1), x(0), y(0), z(0) {}
 
 template<typename T>
-constexpr Quaternion<T>::Quaternion(T w, T x, T y, T z) : w(w), x(x), y(y), z(z) {}
+constexpr Quaternion<T>::Quaternion(T w, T x, T y, T z) : w(w), x(x), y(y), z(z) {
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Quaternion::Quaternion", *this);
+}
 
 template<typename T>
-Quaternion<T>::Quaternion(const Vector3<T>& axis, T angle) {
-    T halfAngle = angle * T(0.5);
-    T sinHalfAngle = std::sin(halfAngle);
-    w = std::cos(halfAngle);
-    x = axis.x * sinHalfAngle;
-    y = axis.y * sinHalfAngle;
-    z = axis.z * sinHalfAngle;
-}
+constexpr Quaternion<T>::Quaternion(const Vector3<T>& axis, T angle) : Quaternion(fromAxisAngle(axis, angle)) {}
 
 template<typename T>
 constexpr Quaternion<T> Quaternion<T>::operator*(const Quaternion& q) const {
-    return Quaternion(
+    return RENDERFX_CHECK_FINITE("Quaternion::operator*", Quaternion(
         w * q.w - x * q.x - y * q.y - z * q.z,
         w * q.x + x * q.w + y * q.z - z * q.y,
         w * q.y - x * q.z + y * q.w + z * q.x,
         w * q.z + x * q.y - y * q.x + z * q.w
-    );
+    ), *this, q);
 }
 
 template<typename T>
-Vector3<T> Quaternion<T>::operator*(const Vector3<T>& v) const {
+constexpr Vector3<T> Quaternion<T>::operator*(const Vector3<T>& v) const {
     Quaternion p(0, v.x, v.y, v.z);
     Quaternion q = (*this) * p * conjugate();
-    return Vector3<T>(q.x, q.y, q.z);
+    return RENDERFX_CHECK_FINITE("Quaternion::operator*", Vector3<T>(q.x, q.y, q.z), *this, v);
 }
 
 template<typename T>
-T Quaternion<T>::magnitude() const {
-    return std::sqrt(w * w + x * x + y * y + z * z);
+constexpr T Quaternion<T>::magnitude() const {
+    return RENDERFX_CHECK_FINITE("Quaternion::magnitude", math::sqrt(w * w + x * x + y * y + z * z), *this);
 }
 
 template<typename T>
-Quaternion<T> Quaternion<T>::normalized() const {
+constexpr Quaternion<T> Quaternion<T>::normalized() const {
     T mag = magnitude();
     if (mag < std::numeric_limits<T>::epsilon()) {
         throw std::runtime_error("Cannot normalize zero quaternion");
     }
-    return Quaternion(w / mag, x / mag, y / mag, z / mag);
+    return RENDERFX_CHECK_FINITE("Quaternion::normalized", Quaternion(w / mag, x / mag, y / mag, z / mag), *this);
 }
 
 template<typename T>
-Quaternion<T> Quaternion<T>::conjugate() const {
+constexpr Quaternion<T> Quaternion<T>::conjugate() const {
     return Quaternion(w, -x, -y, -z);
 }
 
 template<typename T>
-Quaternion<T> Quaternion<T>::inverse() const {
+constexpr Quaternion<T> Quaternion<T>::inverse() const {
     T magSquared = w * w + x * x + y * y + z * z;
     if (magSquared < std::numeric_limits<T>::epsilon()) {
         throw std::runtime_error("Cannot invert zero quaternion");
     }
     T invMagSquared = T(1) / magSquared;
-    return Quaternion(w * invMagSquared, -x * invMagSquared, -y * invMagSquared, -z * invMagSquared);
+    return RENDERFX_CHECK_FINITE("Quaternion::inverse", Quaternion(w * invMagSquared, -x * invMagSquared, -y * invMagSquared, -z * invMagSquared), *this);
 }
 
 template<typename T>
-Matrix4x4<T> Quaternion<T>::toRotationMatrix() const {
+Quaternion<T> Quaternion<T>::log() const {
+    T length = math::sqrt(x * x + y * y + z * z);
+    if (length < std::numeric_limits<T>::epsilon()) return Quaternion(0, x, y, z);
+    T scale = math::atan2(length, w) / length;
+    return RENDERFX_CHECK_FINITE("Quaternion::log", Quaternion(0, x * scale, y * scale, z * scale), *this);
+}
+
+template<typename T>
+Quaternion<T> Quaternion<T>::exp() const {
+    T angle = math::sqrt(x * x + y * y + z * z);
+    if (angle < std::numeric_limits<T>::epsilon()) return Quaternion(1, x, y, z).normalized();
+    T scale = math::sin(angle) / angle;
+    return RENDERFX_CHECK_FINITE("Quaternion::exp", Quaternion(math::cos(angle), x * scale, y * scale, z * scale), *this);
+}
+
+template<typename T>
+constexpr Matrix4x4<T> Quaternion<T>::toRotationMatrix() const {
     T xx = x * x, yy = y * y, zz = z * z;
     T xy = x * y, xz = x * z, yz = y * z;
     T wx = w * x, wy = w * y, wz = w * z;
@@ -85,7 +96,7 @@ Matrix4x4<T> Quaternion<T>::toRotationMatrix() const {
     m(2, 2) = 1 - 2 * (xx + yy);
     m(3, 3) = 1;
 
-    return m;
+    return RENDERFX_CHECK_FINITE("Quaternion::toRotationMatrix", m, *this);
 }
 
 template<typename T>
@@ -95,45 +106,63 @@ Vector3<T> Quaternion<T>::toEulerAngles() const {
     // Roll (x-axis rotation)
     T sinr_cosp = 2 * (w * x + y * z);
     T cosr_cosp = 1 - 2 * (x * x + y * y);
-    angles.x = std::atan2(sinr_cosp, cosr_cosp);
+    angles.x = math::atan2(sinr_cosp, cosr_cosp);
 
     // Pitch (y-axis rotation)
     T sinp = 2 * (w * y - z * x);
-    if (std::abs(sinp) >= 1)
-        angles.y = std::copysign(M_PI / 2, sinp); // Use 90 degrees if out of range
+    if (math::abs(sinp) >= 1)
+        angles.y = sinp < 0 ? -T(M_PI / 2) : T(M_PI / 2); // Use 90 degrees if out of range
     else
-        angles.y = std::asin(sinp);
+        angles.y = math::asin(sinp);
 
     // Yaw (z-axis rotation)
     T siny_cosp = 2 * (w * z + x * y);
     T cosy_cosp = 1 - 2 * (y * y + z * z);
-    angles.z = std::atan2(siny_cosp, cosy_cosp);
+    angles.z = math::atan2(siny_cosp, cosy_cosp);
 
-    return angles;
+    return RENDERFX_CHECK_FINITE("Quaternion::toEulerAngles", angles, *this);
 }
 
 template<typename T>
-Quaternion<T> Quaternion<T>::fromAxisAngle(const Vector3<T>& axis, T angle) {
+constexpr Quaternion<T> Quaternion<T>::fromAxisAngle(const Vector3<T>& axis, T angle) {
     T halfAngle = angle * static_cast<T>(0.5);
-    T sinHalfAngle = std::sin(halfAngle);
-    return Quaternion(std::cos(halfAngle), axis.x * sinHalfAngle, axis.y * sinHalfAngle, axis.z * sinHalfAngle);
+    T sinHalfAngle = math::sin(halfAngle);
+    return RENDERFX_CHECK_FINITE("Quaternion::fromAxisAngle", Quaternion(math::cos(halfAngle), axis.x * sinHalfAngle, axis.y * sinHalfAngle, axis.z * sinHalfAngle), axis, angle);
 }
 
 template<typename T>
-Quaternion<T> Quaternion<T>::fromEulerAngles(T pitch, T yaw, T roll) {
-    T cy = std::cos(yaw * 0.5);
-    T sy = std::sin(yaw * 0.5);
-    T cp = std::cos(pitch * 0.5);
-    T sp = std::sin(pitch * 0.5);
-    T cr = std::cos(roll * 0.5);
-    T sr = std::sin(roll * 0.5);
-
-    return Quaternion(
+constexpr Quaternion<T> Quaternion<T>::fromEulerAngles(T pitch, T yaw, T roll) {
+    T cy = math::cos(yaw * 0.5);
+    T sy = math::sin(yaw * 0.5);
+    T cp = math::cos(pitch * 0.5);
+    T sp = math::sin(pitch * 0.5);
+    T cr = math::cos(roll * 0.5);
+    T sr = math::sin(roll * 0.5);
+
+    return RENDERFX_CHECK_FINITE("Quaternion::fromEulerAngles", Quaternion(
         cr * cp * cy + sr * sp * sy,
         sr * cp * cy - cr * sp * sy,
         cr * sp * cy + sr * cp * sy,
         cr * cp * sy - sr * sp * cy
-    );
+    ), pitch, yaw, roll);
+}
+
+template<typename T>
+void Quaternion<T>::fromEulerAngles(const T* pitch, const T* yaw, const T* roll, T* w, T* x, T* y, T* z, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        T cy = math::cos(yaw[i] * T(0.5));
+        T sy = math::sin(yaw[i] * T(0.5));
+        T cp = math::cos(pitch[i] * T(0.5));
+        T sp = math::sin(pitch[i] * T(0.5));
+        T cr = math::cos(roll[i] * T(0.5));
+        T sr = math::sin(roll[i] * T(0.5));
+
+        w[i] = cr * cp * cy + sr * sp * sy;
+        x[i] = sr * cp * cy - cr * sp * sy;
+        y[i] = cr * sp * cy + sr * cp * sy;
+        z[i] = cr * cp * sy - sr * sp * cy;
+    }
+    RENDERFX_CHECK_FINITE_BATCH("Quaternion::fromEulerAngles", w, w + count);
 }
 
 template<typename T>
@@ -155,20 +184,60 @@ Quaternion<T> Quaternion<T>::slerp(const Quaternion& q1, const Quaternion& q2, T
         ).normalized();
     }
 
-    T theta_0 = std::acos(dot);
+    T theta_0 = math::acos(dot);
     T theta = theta_0 * t;
-    T sin_theta = std::sin(theta);
-    T sin_theta_0 = std::sin(theta_0);
+    T sin_theta = math::sin(theta);
+    T sin_theta_0 = math::sin(theta_0);
 
-    T s0 = std::cos(theta) - dot * sin_theta / sin_theta_0;
+    T s0 = math::cos(theta) - dot * sin_theta / sin_theta_0;
     T s1 = sin_theta / sin_theta_0;
 
-    return Quaternion(
+    return RENDERFX_CHECK_FINITE("Quaternion::slerp", Quaternion(
         s0 * q1.w + s1 * q2_adj.w,
         s0 * q1.x + s1 * q2_adj.x,
         s0 * q1.y + s1 * q2_adj.y,
         s0 * q1.z + s1 * q2_adj.z
-    );
+    ), q1, q2, t);
+}
+
+template<typename T>
+Quaternion<T> Quaternion<T>::squad(const Quaternion& q1, const Quaternion& q2, const Quaternion& s1, const Quaternion& s2, T t) {
+    // Unlike slerp(), the inner interpolations must not switch to the
+    // shorter arc, or the curve jumps where a dot product changes sign.
+    auto interpolate = [](const Quaternion& a, const Quaternion& b, T u) {
+        T dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+        T s0 = T(1) - u;
+        T s1 = u;
+        if (math::abs(dot) < T(0.9995)) {
+            T angle = math::acos(dot);
+            T inverseSin = T(1) / math::sin(angle);
+            s0 = math::sin(s0 * angle) * inverseSin;
+            s1 = math::sin(s1 * angle) * inverseSin;
+        }
+        return Quaternion(s0 * a.w + s1 * b.w, s0 * a.x + s1 * b.x, s0 * a.y + s1 * b.y, s0 * a.z + s1 * b.z).normalized();
+    };
+    return RENDERFX_CHECK_FINITE("Quaternion::squad",
+        interpolate(interpolate(q1, q2, t), interpolate(s1, s2, t), T(2) * t * (T(1) - t)), q1, q2, s1, s2, t);
+}
+
+template<typename T>
+Quaternion<T> Quaternion<T>::squadControlPoint(const Quaternion& previous, const Quaternion& current, const Quaternion& next) {
+    Quaternion inverse = current.conjugate();
+    Quaternion toNext = (inverse * next).log();
+    Quaternion toPrevious = (inverse * previous).log();
+    Quaternion sum(0, (toNext.x + toPrevious.x) * T(-0.25), (toNext.y + toPrevious.y) * T(-0.25),
+                   (toNext.z + toPrevious.z) * T(-0.25));
+    return (current * sum.exp()).normalized();
+}
+
+template<typename T>
+constexpr bool Quaternion<T>::isFinite() const {
+    return detail::isFiniteValue(w) && detail::isFiniteValue(x) && detail::isFiniteValue(y) && detail::isFiniteValue(z);
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const Quaternion<T>& q) {
+    return os << "Quaternion(" << q.w << ", " << q.x << ", " << q.y << ", " << q.z << ")";
 }
 
 #endif // QUATERNION_INL
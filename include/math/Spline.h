@@ -0,0 +1,212 @@
+#ifndef SPLINE_H
+#define SPLINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "Quaternion.h"
+#include "Vector3.h"
+#include "VectorArray.h"
+
+RENDERFX_STRICT_FP_BEGIN
+
+/**
+ * @brief How the control points of a Spline define its curve.
+ */
+enum class SplineType {
+    CatmullRom, ///< Passes through every point; the ends continue in a straight line.
+    Bezier,     ///< Piecewise cubic Bezier: end, control, control, end, control, control, end, ...
+    Hermite,    ///< Alternating points and tangents: point, tangent, point, tangent, ...
+    BSpline     ///< Uniform cubic B-spline; C2 continuous, approximates its points.
+};
+
+/**
+ * @brief A piecewise cubic curve over Vector3 with an arc-length lookup table.
+ *
+ * Whatever the type, every segment is converted to its power-basis
+ * coefficients once, so evaluating a point is a segment lookup and three
+ * Horner polynomials. The parameter t runs from 0 to segmentCount(); its
+ * integer part selects the segment.
+ *
+ * The constructor also integrates the arc length of every segment and
+ * inverts it into a table of parameters at evenly spaced distances, which
+ * is interpolated with monotonic cubics, so moving along the curve at
+ * constant speed costs a table lookup instead of a root search. The batch functions evaluate many parameters, or many
+ * curves, into component streams in one call.
+ *
+ * @tparam T Type of the coordinates.
+ */
+template<typename T>
+class Spline {
+public:
+    static_assert(std::is_floating_point<T>::value, "Spline requires a floating-point type");
+
+    /**
+     * @brief Creates a spline.
+     *
+     * @param type How the points define the curve.
+     * @param points The control points: at least 2 for CatmullRom, 3k + 1 with k >= 1 for Bezier,
+     *        an even number of at least 4 for Hermite, at least 4 for BSpline.
+     * @param arcLengthSamples Arc-length table entries per segment; more entries follow the
+     *        speed changes within a segment more closely.
+     * @throws std::invalid_argument If the number of points does not fit the type or arcLengthSamples is zero.
+     */
+    Spline(SplineType type, const std::vector<Vector3<T>>& points, std::size_t arcLengthSamples = 16);
+
+    SplineType type() const noexcept { return curveType; }
+    std::size_t segmentCount() const noexcept { return segments; }
+
+    /**
+     * @brief Gets the length of the whole curve.
+     *
+     * @return The arc length.
+     */
+    T length() const noexcept { return totalLength; }
+
+    /**
+     * @brief Evaluates the curve.
+     *
+     * @param t The parameter, clamped to [0, segmentCount()].
+     * @return The point at t.
+     */
+    Vector3<T> evaluate(T t) const noexcept;
+
+    /**
+     * @brief Evaluates the derivative of the curve with respect to its parameter.
+     *
+     * @param t The parameter, clamped to [0, segmentCount()].
+     * @return The tangent at t; its length is the speed along the curve.
+     */
+    Vector3<T> derivative(T t) const noexcept;
+
+    /**
+     * @brief Converts a distance along the curve to a parameter.
+     *
+     * @param distance The arc length from the start, clamped to [0, length()].
+     * @return The parameter of the point at that distance.
+     */
+    T parameterAtDistance(T distance) const noexcept;
+
+    /**
+     * @brief Evaluates the curve at a distance along it.
+     *
+     * @param distance The arc length from the start, clamped to [0, length()].
+     * @return The point at that distance.
+     */
+    Vector3<T> evaluateAtDistance(T distance) const noexcept { return evaluate(parameterAtDistance(distance)); }
+
+    /**
+     * @brief Evaluates the curve at many parameters.
+     *
+     * @param parameters The parameters.
+     * @param count The number of parameters.
+     * @param out Receives the points; resized to count.
+     */
+    void evaluate(const T* parameters, std::size_t count, VectorArray<T, 3>& out) const;
+
+    /**
+     * @brief Evaluates the curve at many distances along it.
+     *
+     * @param distances The arc lengths from the start.
+     * @param count The number of distances.
+     * @param out Receives the points; resized to count.
+     */
+    void evaluateAtDistance(const T* distances, std::size_t count, VectorArray<T, 3>& out) const;
+
+    /**
+     * @brief Evaluates many curves, one parameter each.
+     *
+     * @param splines The curves.
+     * @param indices The curve of every element, an index into splines.
+     * @param parameters The parameter of every element.
+     * @param count The number of elements.
+     * @param out Receives the points; resized to count.
+     */
+    static void evaluate(const Spline* splines, const std::uint32_t* indices, const T* parameters, std::size_t count,
+                         VectorArray<T, 3>& out);
+
+    /**
+     * @brief Evaluates many curves at one distance each, e.g. agents moving along paths.
+     *
+     * @param splines The curves.
+     * @param indices The curve of every element, an index into splines.
+     * @param distances The arc length of every element from the start of its curve.
+     * @param count The number of elements.
+     * @param out Receives the points; resized to count.
+     */
+    static void evaluateAtDistance(const Spline* splines, const std::uint32_t* indices, const T* distances,
+                                   std::size_t count, VectorArray<T, 3>& out);
+
+private:
+    SplineType curveType;
+    std::size_t segments = 0;
+    std::vector<T> coefficients;  // Per segment x, y, z, each as c0, c1, c2, c3 of c0 + u (c1 + u (c2 + u c3)).
+    std::vector<T> distanceTable; // Parameter and its slope at evenly spaced distances from 0 to totalLength.
+    T totalLength = 0;
+    T distanceScale = 0;          // Table entries per unit of distance.
+
+    const T* locate(T t, T& u) const noexcept;
+    T speed(std::size_t segment, T u) const noexcept;
+    T segmentLength(std::size_t segment, T from, T to) const noexcept;
+    void buildDistanceTable(std::size_t samples);
+};
+
+/**
+ * @brief A smooth rotation curve through a sequence of keys, interpolated with squad.
+ *
+ * Keys are normalized and flipped into the hemisphere of their predecessor,
+ * and the squad control point of every key is precomputed. The parameter
+ * runs from 0 to segmentCount() like Spline. Squad needs slerp, whose
+ * trigonometry does not map to SIMD lanes, so the batch form is a loop.
+ *
+ * @tparam T Type of the quaternion components.
+ */
+template<typename T>
+class RotationSpline {
+public:
+    static_assert(std::is_floating_point<T>::value, "RotationSpline requires a floating-point type");
+
+    /**
+     * @brief Creates a rotation spline.
+     *
+     * @param keys The rotations to pass through.
+     * @throws std::invalid_argument If keys is empty.
+     */
+    explicit RotationSpline(std::vector<Quaternion<T>> keys);
+
+    std::size_t segmentCount() const noexcept { return rotations.size() - 1; }
+    const std::vector<Quaternion<T>>& keys() const noexcept { return rotations; }
+
+    /**
+     * @brief Evaluates the rotation.
+     *
+     * @param t The parameter, clamped to [0, segmentCount()].
+     * @return The rotation at t.
+     */
+    Quaternion<T> evaluate(T t) const;
+
+    /**
+     * @brief Evaluates the rotation at many parameters.
+     *
+     * @param parameters The parameters.
+     * @param count The number of parameters.
+     * @param out Receives count rotations.
+     */
+    void evaluate(const T* parameters, std::size_t count, Quaternion<T>* out) const;
+
+private:
+    std::vector<Quaternion<T>> rotations;
+    std::vector<Quaternion<T>> controls;
+};
+
+// Commonly used types
+using Splinef = Spline<float>;
+using Splined = Spline<double>;
+using RotationSplinef = RotationSpline<float>;
+
+#include "Spline.inl"
+
+RENDERFX_STRICT_FP_END
+
+#endif // SPLINE_H
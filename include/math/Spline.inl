@@ -0,0 +1,288 @@
+#ifndef SPLINE_INL
+#define SPLINE_INL
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace detail {
+
+// Rows give the power-basis coefficients c0 to c3 of a segment as weights
+// of its four control values.
+template<typename T>
+constexpr T splineBasis[4][4][4] = {
+    // CatmullRom: p[i - 1], p[i], p[i + 1], p[i + 2].
+    { { 0, 1, 0, 0 }, { T(-0.5), 0, T(0.5), 0 }, { 1, T(-2.5), 2, T(-0.5) }, { T(-0.5), T(1.5), T(-1.5), T(0.5) } },
+    // Bezier: end, control, control, end.
+    { { 1, 0, 0, 0 }, { -3, 3, 0, 0 }, { 3, -6, 3, 0 }, { -1, 3, -3, 1 } },
+    // Hermite: point, tangent, point, tangent.
+    { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { -3, -2, 3, -1 }, { 2, 1, -2, 1 } },
+    // BSpline: p[i], p[i + 1], p[i + 2], p[i + 3].
+    { { T(1) / 6, T(4) / 6, T(1) / 6, 0 }, { T(-0.5), 0, T(0.5), 0 }, { T(0.5), -1, T(0.5), 0 },
+      { T(-1) / 6, T(0.5), T(-0.5), T(1) / 6 } }
+};
+
+// Five-point Gauss-Legendre quadrature on [-1, 1]; exact for the speed of a
+// cubic up to its square root, which is smooth between samples.
+constexpr double splineQuadratureNodes[5] = { -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831,
+                                              0.9061798459386640 };
+constexpr double splineQuadratureWeights[5] = { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+                                                0.4786286704993665, 0.2369268850561891 };
+
+// Evaluates many elements into component streams: locate(element, u)
+// returns the coefficients of the element's segment and stores its local
+// parameter. Every element costs a segment lookup whose loads dominate, so
+// this stays a scalar loop; gathering coefficients into SIMD lanes measured
+// no faster.
+template<typename T, typename Locate>
+inline void evaluateSplines(std::size_t count, VectorArray<T, 3>& out, Locate&& locate) {
+    out.resize(count);
+    T* x = out.component(0);
+    T* y = out.component(1);
+    T* z = out.component(2);
+    for (std::size_t i = 0; i < count; ++i) {
+        T u;
+        const T* c = locate(i, u);
+        x[i] = c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+        y[i] = c[4] + u * (c[5] + u * (c[6] + u * c[7]));
+        z[i] = c[8] + u * (c[9] + u * (c[10] + u * c[11]));
+    }
+    RENDERFX_CHECK_FINITE_BATCH("Spline::evaluate", x, x + count);
+}
+
+} // namespace detail
+
+template<typename T>
+Spline<T>::Spline(SplineType type, const std::vector<Vector3<T>>& points, std::size_t arcLengthSamples) : curveType(type) {
+    const std::size_t n = points.size();
+    bool valid = false;
+    switch (type) {
+    case SplineType::CatmullRom:
+        valid = n >= 2;
+        segments = n - 1;
+        break;
+    case SplineType::Bezier:
+        valid = n >= 4 && (n - 1) % 3 == 0;
+        segments = (n - 1) / 3;
+        break;
+    case SplineType::Hermite:
+        valid = n >= 4 && n % 2 == 0;
+        segments = n / 2 - 1;
+        break;
+    case SplineType::BSpline:
+        valid = n >= 4;
+        segments = n - 3;
+        break;
+    }
+    if (!valid) throw std::invalid_argument("Spline has the wrong number of points for its type");
+    if (arcLengthSamples == 0) throw std::invalid_argument("Spline needs at least one arc-length sample per segment");
+
+    // Catmull-Rom extends its ends by mirroring the neighbouring point.
+    auto point = [&](std::ptrdiff_t i) {
+        if (i < 0) return points[0] * T(2) - points[1];
+        if (i >= static_cast<std::ptrdiff_t>(n)) return points[n - 1] * T(2) - points[n - 2];
+        return points[static_cast<std::size_t>(i)];
+    };
+    const T (&basis)[4][4] = detail::splineBasis<T>[static_cast<int>(type)];
+    coefficients.resize(12 * segments);
+    for (std::size_t s = 0; s < segments; ++s) {
+        std::ptrdiff_t first = 0;
+        switch (type) {
+        case SplineType::CatmullRom: first = static_cast<std::ptrdiff_t>(s) - 1; break;
+        case SplineType::Bezier: first = static_cast<std::ptrdiff_t>(3 * s); break;
+        case SplineType::Hermite: first = static_cast<std::ptrdiff_t>(2 * s); break;
+        case SplineType::BSpline: first = static_cast<std::ptrdiff_t>(s); break;
+        }
+        Vector3<T> control[4] = { point(first), point(first + 1), point(first + 2), point(first + 3) };
+        for (std::size_t power = 0; power < 4; ++power) {
+            Vector3<T> sum = control[0] * basis[power][0] + control[1] * basis[power][1] + control[2] * basis[power][2] +
+                             control[3] * basis[power][3];
+            coefficients[12 * s + power] = sum.x;
+            coefficients[12 * s + 4 + power] = sum.y;
+            coefficients[12 * s + 8 + power] = sum.z;
+        }
+    }
+    buildDistanceTable(arcLengthSamples);
+}
+
+template<typename T>
+const T* Spline<T>::locate(T t, T& u) const noexcept {
+    if (!(t > T(0))) t = T(0);
+    if (t >= static_cast<T>(segments)) {
+        u = T(1);
+        return coefficients.data() + 12 * (segments - 1);
+    }
+    std::size_t segment = static_cast<std::size_t>(t);
+    u = t - static_cast<T>(segment);
+    return coefficients.data() + 12 * segment;
+}
+
+template<typename T>
+Vector3<T> Spline<T>::evaluate(T t) const noexcept {
+    T u;
+    const T* c = locate(t, u);
+    return Vector3<T>(c[0] + u * (c[1] + u * (c[2] + u * c[3])), c[4] + u * (c[5] + u * (c[6] + u * c[7])),
+                      c[8] + u * (c[9] + u * (c[10] + u * c[11])));
+}
+
+template<typename T>
+Vector3<T> Spline<T>::derivative(T t) const noexcept {
+    T u;
+    const T* c = locate(t, u);
+    return Vector3<T>(c[1] + u * (T(2) * c[2] + u * T(3) * c[3]), c[5] + u * (T(2) * c[6] + u * T(3) * c[7]),
+                      c[9] + u * (T(2) * c[10] + u * T(3) * c[11]));
+}
+
+template<typename T>
+T Spline<T>::speed(std::size_t segment, T u) const noexcept {
+    const T* c = coefficients.data() + 12 * segment;
+    T dx = c[1] + u * (T(2) * c[2] + u * T(3) * c[3]);
+    T dy = c[5] + u * (T(2) * c[6] + u * T(3) * c[7]);
+    T dz = c[9] + u * (T(2) * c[10] + u * T(3) * c[11]);
+    return math::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+template<typename T>
+T Spline<T>::segmentLength(std::size_t segment, T from, T to) const noexcept {
+    T half = (to - from) * T(0.5);
+    T middle = (to + from) * T(0.5);
+    T sum = 0;
+    for (std::size_t i = 0; i < 5; ++i) {
+        sum += static_cast<T>(detail::splineQuadratureWeights[i]) *
+               speed(segment, middle + half * static_cast<T>(detail::splineQuadratureNodes[i]));
+    }
+    return sum * half;
+}
+
+template<typename T>
+void Spline<T>::buildDistanceTable(std::size_t samples) {
+    // Arc length at evenly spaced parameters.
+    const std::size_t entries = segments * samples;
+    const T step = T(1) / static_cast<T>(samples);
+    std::vector<T> lengths(entries + 1);
+    lengths[0] = 0;
+    for (std::size_t k = 0; k < entries; ++k) {
+        std::size_t segment = k / samples;
+        T from = static_cast<T>(k % samples) * step;
+        lengths[k + 1] = lengths[k] + segmentLength(segment, from, from + step);
+    }
+    totalLength = lengths[entries];
+
+    // Invert it at evenly spaced distances, refining each parameter with
+    // Newton steps on the integrated length. Entries are pairs of the
+    // parameter and its slope per entry.
+    distanceTable.assign(2 * (entries + 1), T(0));
+    distanceTable[2 * entries] = static_cast<T>(segments);
+    distanceScale = totalLength > T(0) ? static_cast<T>(entries) / totalLength : T(0);
+    if (!(totalLength > T(0))) return;
+    std::size_t k = 0;
+    for (std::size_t j = 1; j < entries; ++j) {
+        T distance = totalLength * static_cast<T>(j) / static_cast<T>(entries);
+        while (k + 1 < entries && lengths[k + 1] < distance) ++k;
+        std::size_t segment = k / samples;
+        T from = static_cast<T>(k % samples) * step;
+        T to = from + step;
+        T remaining = distance - lengths[k];
+        T span = lengths[k + 1] - lengths[k];
+        T u = span > T(0) ? from + step * std::min(T(1), remaining / span) : from;
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            T rate = speed(segment, u);
+            if (!(rate > T(0))) break;
+            u = std::min(to, std::max(from, u - (segmentLength(segment, from, u) - remaining) / rate));
+        }
+        distanceTable[2 * j] = static_cast<T>(segment) + u;
+    }
+
+    // The slope of the parameter is one over the speed, limited as in
+    // Fritsch-Carlson so the interpolation stays monotonic near cusps.
+    const T entryLength = totalLength / static_cast<T>(entries);
+    for (std::size_t j = 0; j <= entries; ++j) {
+        T u;
+        const T* c = locate(distanceTable[2 * j], u);
+        T rate = speed(static_cast<std::size_t>(c - coefficients.data()) / 12, u);
+        T limit = std::numeric_limits<T>::max();
+        if (j > 0) limit = std::min(limit, T(3) * (distanceTable[2 * j] - distanceTable[2 * j - 2]));
+        if (j < entries) limit = std::min(limit, T(3) * (distanceTable[2 * j + 2] - distanceTable[2 * j]));
+        distanceTable[2 * j + 1] = rate > T(0) ? std::min(limit, entryLength / rate) : limit;
+    }
+}
+
+template<typename T>
+T Spline<T>::parameterAtDistance(T distance) const noexcept {
+    const std::size_t last = distanceTable.size() / 2 - 1;
+    T x = distance * distanceScale;
+    if (!(x > T(0))) x = T(0);
+    if (x >= static_cast<T>(last)) return distanceTable[2 * last];
+    std::size_t k = static_cast<std::size_t>(x);
+    T f = x - static_cast<T>(k);
+    const T* entry = distanceTable.data() + 2 * k;
+    T g = T(1) - f;
+    return (T(1) + T(2) * f) * g * g * entry[0] + f * g * g * entry[1] + f * f * (T(3) - T(2) * f) * entry[2] -
+           f * f * g * entry[3];
+}
+
+template<typename T>
+void Spline<T>::evaluate(const T* parameters, std::size_t count, VectorArray<T, 3>& out) const {
+    detail::evaluateSplines(count, out, [&](std::size_t i, T& u) { return locate(parameters[i], u); });
+}
+
+template<typename T>
+void Spline<T>::evaluateAtDistance(const T* distances, std::size_t count, VectorArray<T, 3>& out) const {
+    detail::evaluateSplines(count, out, [&](std::size_t i, T& u) { return locate(parameterAtDistance(distances[i]), u); });
+}
+
+template<typename T>
+void Spline<T>::evaluate(const Spline* splines, const std::uint32_t* indices, const T* parameters, std::size_t count,
+                         VectorArray<T, 3>& out) {
+    detail::evaluateSplines(count, out, [&](std::size_t i, T& u) {
+        return splines[indices[i]].locate(parameters[i], u);
+    });
+}
+
+template<typename T>
+void Spline<T>::evaluateAtDistance(const Spline* splines, const std::uint32_t* indices, const T* distances,
+                                   std::size_t count, VectorArray<T, 3>& out) {
+    detail::evaluateSplines(count, out, [&](std::size_t i, T& u) {
+        const Spline& spline = splines[indices[i]];
+        return spline.locate(spline.parameterAtDistance(distances[i]), u);
+    });
+}
+
+template<typename T>
+RotationSpline<T>::RotationSpline(std::vector<Quaternion<T>> keys) : rotations(std::move(keys)) {
+    if (rotations.empty()) throw std::invalid_argument("RotationSpline requires at least one key");
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        Quaternion<T>& key = rotations[i];
+        key = key.normalized();
+        if (i > 0) {
+            const Quaternion<T>& previous = rotations[i - 1];
+            if (previous.w * key.w + previous.x * key.x + previous.y * key.y + previous.z * key.z < 0) {
+                key = Quaternion<T>(-key.w, -key.x, -key.y, -key.z);
+            }
+        }
+    }
+    controls.resize(rotations.size());
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        const Quaternion<T>& previous = rotations[i > 0 ? i - 1 : i];
+        const Quaternion<T>& next = rotations[i + 1 < rotations.size() ? i + 1 : i];
+        controls[i] = Quaternion<T>::squadControlPoint(previous, rotations[i], next);
+    }
+}
+
+template<typename T>
+Quaternion<T> RotationSpline<T>::evaluate(T t) const {
+    const std::size_t segments = segmentCount();
+    if (segments == 0 || !(t > T(0))) return rotations.front();
+    if (t >= static_cast<T>(segments)) return rotations.back();
+    std::size_t segment = static_cast<std::size_t>(t);
+    T u = t - static_cast<T>(segment);
+    return Quaternion<T>::squad(rotations[segment], rotations[segment + 1], controls[segment], controls[segment + 1], u);
+}
+
+template<typename T>
+void RotationSpline<T>::evaluate(const T* parameters, std::size_t count, Quaternion<T>* out) const {
+    for (std::size_t i = 0; i < count; ++i) out[i] = evaluate(parameters[i]);
+}
+
+#endif // SPLINE_INL
@@ -0,0 +1,378 @@
+#ifndef STRICTMATH_H
+#define STRICTMATH_H
+
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @file StrictMath.h
+ * @brief Reproducible double-precision functions and the strict float mode.
+ *
+ * The functions in math::strict are fdlibm-style polynomial approximations
+ * evaluated with plain double operations in a fixed order, so they give
+ * the same bits on every IEEE 754 platform, unlike the C library, whose
+ * implementations differ between vendors and versions. Their error is
+ * at most 3 ULP of double, 4 ULP for tan(). With GCC the same bits also
+ * require -ffp-contract=off, which strict mode enforces.
+ *
+ * Define RENDERFX_MATH_STRICT to make the math:: functions, and through
+ * them Vector3, Quaternion and Matrix4x4, use these implementations at run
+ * time and compile time, and to turn off FMA contraction in the math
+ * headers (RENDERFX_STRICT_FP_BEGIN / RENDERFX_STRICT_FP_END), so that
+ * a * b + c rounds twice on every target. Strict mode requires SSE2 or
+ * another platform without excess precision, and must not be combined
+ * with -ffast-math or /fp:fast.
+ */
+
+#if defined(__cpp_lib_is_constant_evaluated)
+#define RENDERFX_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#define RENDERFX_HAS_CONSTEXPR_MATH 1
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#define RENDERFX_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define RENDERFX_HAS_CONSTEXPR_MATH 1
+#elif defined(__clang__) && defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define RENDERFX_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define RENDERFX_HAS_CONSTEXPR_MATH 1
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+#define RENDERFX_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define RENDERFX_HAS_CONSTEXPR_MATH 1
+#endif
+
+#if !defined(RENDERFX_IS_CONSTANT_EVALUATED)
+// Without compiler support everything calls the standard library, which is
+// correct at run time but cannot be evaluated at compile time.
+#define RENDERFX_IS_CONSTANT_EVALUATED() false
+#define RENDERFX_HAS_CONSTEXPR_MATH 0
+#endif
+
+/**
+ * @brief Brackets code in which floating-point expressions are evaluated
+ * as written, without contracting a * b + c into a fused multiply-add.
+ */
+#if defined(__clang__)
+#define RENDERFX_FP_EXACT_BEGIN _Pragma("float_control(precise, on, push)") _Pragma("clang fp contract(off)")
+#define RENDERFX_FP_EXACT_END _Pragma("float_control(pop)")
+#elif defined(__GNUC__)
+#define RENDERFX_FP_EXACT_BEGIN _Pragma("GCC push_options") _Pragma("GCC optimize(\"fp-contract=off\")")
+#define RENDERFX_FP_EXACT_END _Pragma("GCC pop_options")
+#elif defined(_MSC_VER)
+#define RENDERFX_FP_EXACT_BEGIN __pragma(float_control(precise, on, push)) __pragma(fp_contract(off))
+#define RENDERFX_FP_EXACT_END __pragma(float_control(pop))
+#else
+#define RENDERFX_FP_EXACT_BEGIN
+#define RENDERFX_FP_EXACT_END
+#endif
+
+/**
+ * @brief Bracket the math headers; exact evaluation in strict mode only.
+ *
+ * GCC does not inline functions compiled with other optimization options,
+ * so for GCC these are empty and strict mode instead requires the whole
+ * program to be compiled with -ffp-contract=off, acknowledged by defining
+ * RENDERFX_FP_CONTRACT_OFF; GCC contracts by default, even in ISO mode.
+ */
+#if defined(RENDERFX_MATH_STRICT)
+static_assert(FLT_EVAL_METHOD == 0, "RENDERFX_MATH_STRICT requires evaluation in the precision of each type (e.g. SSE2)");
+#if defined(__GNUC__) && !defined(__clang__)
+#if !defined(RENDERFX_FP_CONTRACT_OFF)
+#error "RENDERFX_MATH_STRICT with GCC requires -ffp-contract=off and RENDERFX_FP_CONTRACT_OFF defined"
+#endif
+#define RENDERFX_STRICT_FP_BEGIN
+#define RENDERFX_STRICT_FP_END
+#else
+#define RENDERFX_STRICT_FP_BEGIN RENDERFX_FP_EXACT_BEGIN
+#define RENDERFX_STRICT_FP_END RENDERFX_FP_EXACT_END
+#endif
+#else
+#define RENDERFX_STRICT_FP_BEGIN
+#define RENDERFX_STRICT_FP_END
+#endif
+
+// The functions below are reproducible only if evaluated exactly as written.
+// For GCC, as above, that takes -ffp-contract=off rather than the pragma,
+// which would keep them from being inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#define RENDERFX_STRICT_FUNCTIONS_BEGIN
+#define RENDERFX_STRICT_FUNCTIONS_END
+#else
+#define RENDERFX_STRICT_FUNCTIONS_BEGIN RENDERFX_FP_EXACT_BEGIN
+#define RENDERFX_STRICT_FUNCTIONS_END RENDERFX_FP_EXACT_END
+#endif
+
+RENDERFX_STRICT_FUNCTIONS_BEGIN
+
+namespace math {
+
+/**
+ * @brief Reproducible implementations of the transcendental functions.
+ *
+ * Arguments of sin(), cos() and tan() are reduced with a four-part pi/2,
+ * which is exact for |x| up to 1e8; larger arguments give NaN rather than
+ * a result with no correct digits. Negative zero is treated as positive
+ * zero.
+ */
+namespace strict {
+
+namespace detail {
+
+// pi/2 in four parts; the first three have 26 bits, so their products with
+// quadrants below 2^26 are exact.
+constexpr double halfPi1 = 1.57079631090164184570e+00;
+constexpr double halfPi2 = 1.58932547122958567343e-08;
+constexpr double halfPi3 = 6.12323393205359425102e-17;
+constexpr double halfPi4 = 6.36831716351094990796e-25;
+constexpr double twoOverPi = 6.36619772367581382433e-01;
+// Largest |x| reduce() accepts: below 2^26 quadrants.
+constexpr double maxReducible = 1.0e8;
+
+constexpr double sinKernel(double r) {
+    constexpr double s1 = -1.66666666666666324348e-01;
+    constexpr double s2 = 8.33333333332248946124e-03;
+    constexpr double s3 = -1.98412698298579493134e-04;
+    constexpr double s4 = 2.75573137070700676789e-06;
+    constexpr double s5 = -2.50507602534068634195e-08;
+    constexpr double s6 = 1.58969099521155010221e-10;
+    double z = r * r;
+    double p = s2 + z * (s3 + z * (s4 + z * (s5 + z * s6)));
+    return r + r * z * (s1 + z * p);
+}
+
+constexpr double cosKernel(double r) {
+    constexpr double c1 = 4.16666666666666019037e-02;
+    constexpr double c2 = -1.38888888888741095749e-03;
+    constexpr double c3 = 2.48015872894767294178e-05;
+    constexpr double c4 = -2.75573143513906633035e-07;
+    constexpr double c5 = 2.08757232129817482790e-09;
+    constexpr double c6 = -1.13596475577881948265e-11;
+    double z = r * r;
+    double p = z * (c1 + z * (c2 + z * (c3 + z * (c4 + z * (c5 + z * c6)))));
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + z * p);
+}
+
+// Reduces x to r in about [-pi/4, pi/4] with x = r + quadrant * pi/2;
+// |x| must not exceed maxReducible.
+constexpr double reduce(double x, long long& quadrant) {
+    double k = x * twoOverPi;
+    quadrant = static_cast<long long>(k < 0 ? k - 0.5 : k + 0.5);
+    double q = static_cast<double>(quadrant);
+    return (((x - q * halfPi1) - q * halfPi2) - q * halfPi3) - q * halfPi4;
+}
+
+// Whether sin(), cos() and tan() can reduce x; false for NaN and infinities.
+constexpr bool isReducible(double x) {
+    return x >= -maxReducible && x <= maxReducible;
+}
+
+constexpr bool isFinite(double x) {
+    return x - x == x - x;
+}
+
+// Computes x - r * r exactly for r close to sqrt(x), with Dekker's product.
+constexpr double squareResidual(double x, double r) {
+    double c = 134217729.0 * r; // 2^27 + 1
+    double high = c - (c - r);
+    double low = r - high;
+    double product = r * r;
+    double error = ((high * high - product) + 2 * high * low) + low * low;
+    return (x - product) - error;
+}
+
+} // namespace detail
+
+/**
+ * @brief Computes the sine.
+ *
+ * @param x The angle in radians.
+ * @return The sine of x; NaN for non-finite x or |x| above 1e8.
+ */
+constexpr double sin(double x) {
+    if (!detail::isReducible(x)) return std::numeric_limits<double>::quiet_NaN();
+    long long quadrant = 0;
+    double r = detail::reduce(x, quadrant);
+    switch (quadrant & 3) {
+    case 0: return detail::sinKernel(r);
+    case 1: return detail::cosKernel(r);
+    case 2: return -detail::sinKernel(r);
+    default: return -detail::cosKernel(r);
+    }
+}
+
+/**
+ * @brief Computes the cosine.
+ *
+ * @param x The angle in radians.
+ * @return The cosine of x; NaN for non-finite x or |x| above 1e8.
+ */
+constexpr double cos(double x) {
+    if (!detail::isReducible(x)) return std::numeric_limits<double>::quiet_NaN();
+    long long quadrant = 0;
+    double r = detail::reduce(x, quadrant);
+    switch (quadrant & 3) {
+    case 0: return detail::cosKernel(r);
+    case 1: return -detail::sinKernel(r);
+    case 2: return -detail::cosKernel(r);
+    default: return detail::sinKernel(r);
+    }
+}
+
+/**
+ * @brief Computes the tangent.
+ *
+ * @param x The angle in radians.
+ * @return The tangent of x; NaN for non-finite x or |x| above 1e8.
+ */
+constexpr double tan(double x) {
+    if (!detail::isReducible(x)) return std::numeric_limits<double>::quiet_NaN();
+    long long quadrant = 0;
+    double r = detail::reduce(x, quadrant);
+    double s = detail::sinKernel(r);
+    double c = detail::cosKernel(r);
+    return (quadrant & 1) ? -c / s : s / c;
+}
+
+/**
+ * @brief Computes the square root, correctly rounded.
+ *
+ * IEEE 754 requires the square root to be correctly rounded, so this
+ * calls std::sqrt() at run time and computes the same result with Newton
+ * steps at compile time.
+ *
+ * @param x The value.
+ * @return The square root; NaN for negative x.
+ */
+constexpr double sqrt(double x) {
+    if (!RENDERFX_IS_CONSTANT_EVALUATED()) return std::sqrt(x);
+    if (x != x || x < 0) return std::numeric_limits<double>::quiet_NaN();
+    if (x == 0 || !detail::isFinite(x)) return x;
+
+    // Scale by an even power of two into [1, 4).
+    double scale = 1;
+    while (x >= 4) { x *= 0.25; scale *= 2; }
+    while (x < 1) { x *= 4; scale *= 0.5; }
+    double root = x < 2 ? 1.25 : 1.75;
+    for (int i = 0; i < 6; ++i) root = 0.5 * (root + x / root);
+
+    // Newton leaves root within a step of the result; it is correctly
+    // rounded when x lies strictly between the squares of the midpoints
+    // to its neighbors, i.e. -root * step < x - root^2 <= root * step.
+    constexpr double step = std::numeric_limits<double>::epsilon();
+    for (int i = 0; i < 4; ++i) {
+        double residual = detail::squareResidual(x, root);
+        if (residual > root * step) {
+            root += step;
+        } else if (residual <= -root * step) {
+            root -= step;
+        } else {
+            break;
+        }
+    }
+    return root * scale;
+}
+
+/**
+ * @brief Computes the arc tangent.
+ *
+ * @param x The value.
+ * @return The arc tangent of x in [-pi/2, pi/2].
+ */
+constexpr double atan(double x) {
+    constexpr double atanHigh[4] = { 4.63647609000806093515e-01, 7.85398163397448278999e-01,
+                                     9.82793723247329054082e-01, 1.57079632679489655800e+00 };
+    constexpr double atanLow[4] = { 2.26987774529616870924e-17, 3.06161699786838301793e-17,
+                                    1.39033110312309984516e-17, 6.12323399573676603587e-17 };
+    constexpr double a[11] = { 3.33333333333329318027e-01, -1.99999999998764832476e-01, 1.42857142725034663711e-01,
+                               -1.11111104054623557880e-01, 9.09088713343650656196e-02, -7.69187620504482999495e-02,
+                               6.66107313738753120669e-02, -5.83357013379057348645e-02, 4.97687799461593236017e-02,
+                               -3.65315727442169155270e-02, 1.62858201153657823623e-02 };
+    if (x != x) return x;
+    bool negative = x < 0;
+    double t = negative ? -x : x;
+    if (t >= 7.378697629483821e19) return negative ? -atanHigh[3] : atanHigh[3];  // 2^66
+    if (t < 7.450580596923828e-09) return x;                                      // 2^-27
+
+    int id = -1;
+    if (t >= 0.4375) {
+        if (t < 1.1875) {
+            if (t < 0.6875) {
+                id = 0;
+                t = (2.0 * t - 1.0) / (2.0 + t);
+            } else {
+                id = 1;
+                t = (t - 1.0) / (t + 1.0);
+            }
+        } else if (t < 2.4375) {
+            id = 2;
+            t = (t - 1.5) / (1.0 + 1.5 * t);
+        } else {
+            id = 3;
+            t = -1.0 / t;
+        }
+    }
+    double z = t * t;
+    double w = z * z;
+    double s1 = z * (a[0] + w * (a[2] + w * (a[4] + w * (a[6] + w * (a[8] + w * a[10])))));
+    double s2 = w * (a[1] + w * (a[3] + w * (a[5] + w * (a[7] + w * a[9]))));
+    double result = id < 0 ? t - t * (s1 + s2) : atanHigh[id] - ((t * (s1 + s2) - atanLow[id]) - t);
+    return negative ? -result : result;
+}
+
+/**
+ * @brief Computes the angle of a vector.
+ *
+ * @param y The y component.
+ * @param x The x component.
+ * @return The angle in [-pi, pi]; zero for the zero vector.
+ */
+constexpr double atan2(double y, double x) {
+    constexpr double pi = 3.1415926535897931160e+00;
+    constexpr double piLow = 1.2246467991473531772e-16;
+    constexpr double halfPi = 1.57079632679489655800e+00;
+    if (x != x || y != y) return x + y;
+    if (y == 0) return x < 0 ? pi : 0.0;
+    if (x == 0) return y < 0 ? -halfPi : halfPi;
+    if (!detail::isFinite(x) || !detail::isFinite(y)) {
+        double angle = !detail::isFinite(x) && !detail::isFinite(y) ? (x > 0 ? pi / 4 : 3 * pi / 4)
+                     : !detail::isFinite(y) ? halfPi : (x > 0 ? 0.0 : pi);
+        return y < 0 ? -angle : angle;
+    }
+    double ratio = y / x;
+    double z = atan(ratio < 0 ? -ratio : ratio);
+    if (x < 0) z = pi - (z - piLow);
+    return y < 0 ? -z : z;
+}
+
+/**
+ * @brief Computes the arc sine.
+ *
+ * @param x The value in [-1, 1].
+ * @return The arc sine of x; NaN outside [-1, 1].
+ */
+constexpr double asin(double x) {
+    if (!(x >= -1 && x <= 1)) return std::numeric_limits<double>::quiet_NaN();
+    return atan2(x, sqrt((1.0 - x) * (1.0 + x)));
+}
+
+/**
+ * @brief Computes the arc cosine.
+ *
+ * @param x The value in [-1, 1].
+ * @return The arc cosine of x; NaN outside [-1, 1].
+ */
+constexpr double acos(double x) {
+    if (!(x >= -1 && x <= 1)) return std::numeric_limits<double>::quiet_NaN();
+    return atan2(sqrt((1.0 - x) * (1.0 + x)), x);
+}
+
+} // namespace strict
+
+} // namespace math
+
+RENDERFX_STRICT_FUNCTIONS_END
+
+#endif // STRICTMATH_H
@@ -6,6 +6,10 @@
 #include <stdexcept>
 #include <limits>
 #include <algorithm>
+#include "MathDebug.h"
+#include "MathFunctions.h"
+
+RENDERFX_STRICT_FP_BEGIN
 
 /**
  * @class Vector2
@@ -71,14 +75,14 @@ public:
      * @param i Index (0 for x, 1 for y).
      * @return Reference to the component.
      */
-    T& operator[](int i);
+    constexpr T& operator[](int i);
 
     /**
      * @brief Accesses a component of the vector (const version).
      * @param i Index (0 for x, 1 for y).
      * @return Const reference to the component.
      */
-    const T& operator[](int i) const;
+    constexpr const T& operator[](int i) const;
 
     /// @}
 
@@ -90,28 +94,28 @@ public:
      * @param v The vector to add.
      * @return The resulting vector.
      */
-    Vector2 operator+(const Vector2& v) const;
+    constexpr Vector2 operator+(const Vector2& v) const;
 
     /**
      * @brief Subtracts a vector from this vector.
      * @param v The vector to subtract.
      * @return The resulting vector.
      */
-    Vector2 operator-(const Vector2& v) const;
+    constexpr Vector2 operator-(const Vector2& v) const;
 
     /**
      * @brief Adds a vector to this vector.
      * @param v The vector to add.
      * @return Reference to this vector.
      */
-    Vector2& operator+=(const Vector2& v);
+    constexpr Vector2& operator+=(const Vector2& v);
 
     /**
      * @brief Subtracts a vector from this vector.
      * @param v The vector to subtract.
      * @return Reference to this vector.
      */
-    Vector2& operator-=(const Vector2& v);
+    constexpr Vector2& operator-=(const Vector2& v);
 
     /// @}
 
@@ -123,35 +127,35 @@ public:
      * @param s The scalar value.
      * @return The resulting vector.
      */
-    Vector2 operator*(T s) const;
+    constexpr Vector2 operator*(T s) const;
 
     /**
      * @brief Divides the vector by a scalar.
      * @param s The scalar value.
      * @return The resulting vector.
      */
-    Vector2 operator/(T s) const;
+    constexpr Vector2 operator/(T s) const;
 
     /**
      * @brief Multiplies this vector by a scalar.
      * @param s The scalar value.
      * @return Reference to this vector.
      */
-    Vector2& operator*=(T s);
+    constexpr Vector2& operator*=(T s);
 
     /**
      * @brief Divides this vector by a scalar.
      * @param s The scalar value.
      * @return Reference to this vector.
      */
-    Vector2& operator/=(T s);
+    constexpr Vector2& operator/=(T s);
 
     /**
      * @brief Multiplies two vectors component-wise.
      * @param other The vector to multiply with.
      * @return The resulting vector.
      */
-    Vector2 operator*(const Vector2& other) const;
+    constexpr Vector2 operator*(const Vector2& other) const;
 
     /// @}
 
@@ -163,7 +167,7 @@ public:
      * @param v The other vector.
      * @return The dot product.
      */
-    T dot(const Vector2& v) const;
+    constexpr T dot(const Vector2& v) const;
 
     /// @}
 
@@ -174,13 +178,13 @@ public:
      * @brief Computes the squared length of the vector.
      * @return The squared length.
      */
-    T lengthSquared() const;
+    constexpr T lengthSquared() const;
 
     /**
      * @brief Computes the length of the vector.
      * @return The length.
      */
-    T length() const;
+    constexpr T length() const;
 
     /// @}
 
@@ -191,12 +195,12 @@ public:
      * @brief Returns a normalized copy of the vector.
      * @return The normalized vector.
      */
-    Vector2 normalized() const;
+    constexpr Vector2 normalized() const;
 
     /**
      * @brief Normalizes the vector in place.
      */
-    void normalize();
+    constexpr void normalize();
 
     /// @}
 
@@ -208,14 +212,20 @@ public:
      * @param v The vector to compare with.
      * @return True if equal, false otherwise.
      */
-    bool operator==(const Vector2& v) const;
+    constexpr bool operator==(const Vector2& v) const;
 
     /**
      * @brief Checks if two vectors are not equal.
      * @param v The vector to compare with.
      * @return True if not equal, false otherwise.
      */
-    bool operator!=(const Vector2& v) const;
+    constexpr bool operator!=(const Vector2& v) const;
+
+    /**
+     * @brief Checks if both components are finite.
+     * @return False if any component is NaN or infinite.
+     */
+    constexpr bool isFinite() const;
 
     /// @}
 
@@ -229,7 +239,7 @@ public:
      * @param t The interpolation factor [0, 1].
      * @return The interpolated vector.
      */
-    static Vector2 lerp(const Vector2& a, const Vector2& b, T t);
+    static constexpr Vector2 lerp(const Vector2& a, const Vector2& b, T t);
 
     /**
      * @brief Returns a vector with both components set to zero.
@@ -274,7 +284,7 @@ public:
 
 // Scalar multiplication (scalar * vector)
 template<typename T>
-Vector2<T> operator*(T s, const Vector2<T>& v);
+constexpr Vector2<T> operator*(T s, const Vector2<T>& v);
 
 // Commonly used types
 using Vector2f = Vector2<float>;
@@ -283,4 +293,6 @@ using Vector2i = Vector2<int>;
 
 #include "Vector2.inl"
 
+RENDERFX_STRICT_FP_END
+
 #endif // VECTOR2_H
@@ -5,90 +5,92 @@ template<typename T>
 constexpr Vector2<T>::Vector2() : x(0), y(0) {}
 
 template<typename T>
-constexpr Vector2<T>::Vector2(T x, T y) : x(x), y(y) {}
+constexpr Vector2<T>::Vector2(T x, T y) : x(x), y(y) {
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Vector2::Vector2", *this);
+}
 
 template<typename T>
-T& Vector2<T>::operator[](int i) {
+constexpr T& Vector2<T>::operator[](int i) {
     if (i < 0 || i > 1) throw std::out_of_range("Vector2 index out of range");
     return (i == 0) ? x : y;
 }
 
 template<typename T>
-const T& Vector2<T>::operator[](int i) const {
+constexpr const T& Vector2<T>::operator[](int i) const {
     if (i < 0 || i > 1) throw std::out_of_range("Vector2 index out of range");
     return (i == 0) ? x : y;
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::operator+(const Vector2<T>& v) const {
-    return Vector2(x + v.x, y + v.y);
+constexpr Vector2<T> Vector2<T>::operator+(const Vector2<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector2::operator+", Vector2(x + v.x, y + v.y), *this, v);
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::operator-(const Vector2<T>& v) const {
-    return Vector2(x - v.x, y - v.y);
+constexpr Vector2<T> Vector2<T>::operator-(const Vector2<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector2::operator-", Vector2(x - v.x, y - v.y), *this, v);
 }
 
 template<typename T>
-Vector2<T>& Vector2<T>::operator+=(const Vector2<T>& v) {
+constexpr Vector2<T>& Vector2<T>::operator+=(const Vector2<T>& v) {
     x += v.x; y += v.y;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector2::operator+=", *this, v);
 }
 
 template<typename T>
-Vector2<T>& Vector2<T>::operator-=(const Vector2<T>& v) {
+constexpr Vector2<T>& Vector2<T>::operator-=(const Vector2<T>& v) {
     x -= v.x; y -= v.y;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector2::operator-=", *this, v);
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::operator*(T s) const {
-    return Vector2(x * s, y * s);
+constexpr Vector2<T> Vector2<T>::operator*(T s) const {
+    return RENDERFX_CHECK_FINITE("Vector2::operator*", Vector2(x * s, y * s), *this, s);
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::operator/(T s) const {
-    if (std::abs(s) < std::numeric_limits<T>::epsilon())
+constexpr Vector2<T> Vector2<T>::operator/(T s) const {
+    if (math::abs(s) < std::numeric_limits<T>::epsilon())
         throw std::invalid_argument("Division by zero in Vector2");
-    return Vector2(x / s, y / s);
+    return RENDERFX_CHECK_FINITE("Vector2::operator/", Vector2(x / s, y / s), *this, s);
 }
 
 template<typename T>
-Vector2<T>& Vector2<T>::operator*=(T s) {
+constexpr Vector2<T>& Vector2<T>::operator*=(T s) {
     x *= s; y *= s;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector2::operator*=", *this, s);
 }
 
 template<typename T>
-Vector2<T>& Vector2<T>::operator/=(T s) {
-    if (std::abs(s) < std::numeric_limits<T>::epsilon())
+constexpr Vector2<T>& Vector2<T>::operator/=(T s) {
+    if (math::abs(s) < std::numeric_limits<T>::epsilon())
         throw std::invalid_argument("Division by zero in Vector2");
     x /= s; y /= s;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector2::operator/=", *this, s);
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::operator*(const Vector2<T>& other) const {
-    return Vector2(x * other.x, y * other.y);
+constexpr Vector2<T> Vector2<T>::operator*(const Vector2<T>& other) const {
+    return RENDERFX_CHECK_FINITE("Vector2::operator*", Vector2(x * other.x, y * other.y), *this, other);
 }
 
 template<typename T>
-T Vector2<T>::dot(const Vector2<T>& v) const {
-    return x * v.x + y * v.y;
+constexpr T Vector2<T>::dot(const Vector2<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector2::dot", x * v.x + y * v.y, *this, v);
 }
 
 template<typename T>
-T Vector2<T>::lengthSquared() const {
-    return x * x + y * y;
+constexpr T Vector2<T>::lengthSquared() const {
+    return RENDERFX_CHECK_FINITE("Vector2::lengthSquared", x * x + y * y, *this);
 }
 
 template<typename T>
-T Vector2<T>::length() const {
-    return std::sqrt(lengthSquared());
+constexpr T Vector2<T>::length() const {
+    return math::sqrt(lengthSquared());
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::normalized() const {
+constexpr Vector2<T> Vector2<T>::normalized() const {
     T len = length();
     if (len < std::numeric_limits<T>::epsilon())
         throw std::domain_error("Cannot normalize zero-length Vector2");
@@ -96,7 +98,7 @@ Vector2<T> Vector2<T>::normalized() const {
 }
 
 template<typename T>
-void Vector2<T>::normalize() {
+constexpr void Vector2<T>::normalize() {
     T len = length();
     if (len < std::numeric_limits<T>::epsilon())
         throw std::domain_error("Cannot normalize zero-length Vector2");
@@ -104,19 +106,26 @@ void Vector2<T>::normalize() {
 }
 
 template<typename T>
-bool Vector2<T>::operator==(const Vector2<T>& v) const {
-    return std::abs(x - v.x) < std::numeric_limits<T>::epsilon() &&
-           std::abs(y - v.y) < std::numeric_limits<T>::epsilon();
+constexpr bool Vector2<T>::operator==(const Vector2<T>& v) const {
+    return math::abs(x - v.x) < std::numeric_limits<T>::epsilon() &&
+           math::abs(y - v.y) < std::numeric_limits<T>::epsilon();
 }
 
 template<typename T>
-bool Vector2<T>::operator!=(const Vector2<T>& v) const {
+constexpr bool Vector2<T>::operator!=(const Vector2<T>& v) const {
     return !(*this == v);
 }
 
 template<typename T>
-Vector2<T> Vector2<T>::lerp(const Vector2<T>& a, const Vector2<T>& b, T t) {
-    return a + (b - a) * t;
+constexpr Vector2<T> Vector2<T>::lerp(const Vector2<T>& a, const Vector2<T>& b, T t) {
+    // Per component, so no intermediate vectors are built.
+    return RENDERFX_CHECK_FINITE("Vector2::lerp", Vector2(
+        a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t), a, b, t);
+}
+
+template<typename T>
+constexpr bool Vector2<T>::isFinite() const {
+    return detail::isFiniteValue(x) && detail::isFiniteValue(y);
 }
 
 template<typename T>
@@ -145,7 +154,7 @@ std::ostream& operator<<(std::ostream& os, const Vector2<T>& v) {
 }
 
 template<typename T>
-Vector2<T> operator*(T s, const Vector2<T>& v) {
+constexpr Vector2<T> operator*(T s, const Vector2<T>& v) {
     return v * s;
 }
 
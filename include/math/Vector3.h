@@ -6,6 +6,10 @@
 #include <stdexcept>
 #include <limits>
 #include <algorithm>
+#include "MathDebug.h"
+#include "MathFunctions.h"
+
+RENDERFX_STRICT_FP_BEGIN
 
 /**
  * @class Vector3
@@ -72,14 +76,14 @@ public:
      * @param i Index (0 for x, 1 for y, 2 for z).
      * @return Reference to the component.
      */
-    T& operator[](int i);
+    constexpr T& operator[](int i);
 
     /**
      * @brief Accesses a component of the vector (const version).
      * @param i Index (0 for x, 1 for y, 2 for z).
      * @return Const reference to the component.
      */
-    const T& operator[](int i) const;
+    constexpr const T& operator[](int i) const;
 
     /// @}
 
@@ -91,28 +95,28 @@ public:
      * @param v The vector to add.
      * @return The resulting vector.
      */
-    Vector3 operator+(const Vector3& v) const;
+    constexpr Vector3 operator+(const Vector3& v) const;
 
     /**
      * @brief Subtracts a vector from this vector.
      * @param v The vector to subtract.
      * @return The resulting vector.
      */
-    Vector3 operator-(const Vector3& v) const;
+    constexpr Vector3 operator-(const Vector3& v) const;
 
     /**
      * @brief Adds a vector to this vector.
      * @param v The vector to add.
      * @return Reference to this vector.
      */
-    Vector3& operator+=(const Vector3& v);
+    constexpr Vector3& operator+=(const Vector3& v);
 
     /**
      * @brief Subtracts a vector from this vector.
      * @param v The vector to subtract.
      * @return Reference to this vector.
      */
-    Vector3& operator-=(const Vector3& v);
+    constexpr Vector3& operator-=(const Vector3& v);
 
     /// @}
 
@@ -124,35 +128,35 @@ public:
      * @param s The scalar value.
      * @return The resulting vector.
      */
-    Vector3 operator*(T s) const;
+    constexpr Vector3 operator*(T s) const;
 
     /**
      * @brief Divides the vector by a scalar.
      * @param s The scalar value.
      * @return The resulting vector.
      */
-    Vector3 operator/(T s) const;
+    constexpr Vector3 operator/(T s) const;
 
     /**
      * @brief Multiplies this vector by a scalar.
      * @param s The scalar value.
      * @return Reference to this vector.
      */
-    Vector3& operator*=(T s);
+    constexpr Vector3& operator*=(T s);
 
     /**
      * @brief Divides this vector by a scalar.
      * @param s The scalar value.
      * @return Reference to this vector.
      */
-    Vector3& operator/=(T s);
+    constexpr Vector3& operator/=(T s);
 
     /**
      * @brief Multiplies two vectors component-wise.
      * @param other The vector to multiply with.
      * @return The resulting vector.
      */
-    Vector3 operator*(const Vector3& other) const;
+    constexpr Vector3 operator*(const Vector3& other) const;
 
     /// @}
 
@@ -164,7 +168,7 @@ public:
      * @param v The other vector.
      * @return The dot product.
      */
-    T dot(const Vector3& v) const;
+    constexpr T dot(const Vector3& v) const;
 
     /// @}
 
@@ -176,7 +180,7 @@ public:
      * @param v The other vector.
      * @return The resulting vector.
      */
-    Vector3 cross(const Vector3& v) const;
+    constexpr Vector3 cross(const Vector3& v) const;
 
     /// @}
 
@@ -187,13 +191,13 @@ public:
      * @brief Computes the squared length of the vector.
      * @return The squared length.
      */
-    T lengthSquared() const;
+    constexpr T lengthSquared() const;
 
     /**
      * @brief Computes the length of the vector.
      * @return The length.
      */
-    T length() const;
+    constexpr T length() const;
 
     /// @}
 
@@ -204,12 +208,12 @@ public:
      * @brief Returns a normalized copy of the vector.
      * @return The normalized vector.
      */
-    Vector3 normalized() const;
+    constexpr Vector3 normalized() const;
 
     /**
      * @brief Normalizes the vector in place.
      */
-    void normalize();
+    constexpr void normalize();
 
     /// @}
 
@@ -221,14 +225,20 @@ public:
      * @param v The vector to compare with.
      * @return True if equal, false otherwise.
      */
-    bool operator==(const Vector3& v) const;
+    constexpr bool operator==(const Vector3& v) const;
 
     /**
      * @brief Checks if two vectors are not equal.
      * @param v The vector to compare with.
      * @return True if not equal, false otherwise.
      */
-    bool operator!=(const Vector3& v) const;
+    constexpr bool operator!=(const Vector3& v) const;
+
+    /**
+     * @brief Checks if all components are finite.
+     * @return False if any component is NaN or infinite.
+     */
+    constexpr bool isFinite() const;
 
     /// @}
 
@@ -240,14 +250,14 @@ public:
      * @param v The vector to project onto.
      * @return The projected vector.
      */
-    Vector3 projectOnto(const Vector3& v) const;
+    constexpr Vector3 projectOnto(const Vector3& v) const;
 
     /**
      * @brief Reflects this vector across a normal vector.
      * @param normal The normal vector to reflect across.
      * @return The reflected vector.
      */
-    Vector3 reflect(const Vector3& normal) const;
+    constexpr Vector3 reflect(const Vector3& normal) const;
 
     /**
      * @brief Linearly interpolates between two vectors.
@@ -256,7 +266,7 @@ public:
      * @param t The interpolation factor [0, 1].
      * @return The interpolated vector.
      */
-    static Vector3 lerp(const Vector3& a, const Vector3& b, T t);
+    static constexpr Vector3 lerp(const Vector3& a, const Vector3& b, T t);
 
     /**
      * @brief Spherically interpolates between two vectors.
@@ -339,7 +349,7 @@ public:
 
 // Scalar multiplication (scalar * vector)
 template<typename T>
-Vector3<T> operator*(T s, const Vector3<T>& v);
+constexpr Vector3<T> operator*(T s, const Vector3<T>& v);
 
 // Commonly used types
 using Vector3f = Vector3<float>;
@@ -348,4 +358,6 @@ using Vector3i = Vector3<int>;
 
 #include "Vector3.inl"
 
+RENDERFX_STRICT_FP_END
+
 #endif // VECTOR3_H
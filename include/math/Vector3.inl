@@ -5,95 +5,97 @@ template<typename T>
 constexpr Vector3<T>::Vector3() : x(0), y(0), z(0) {}
 
 template<typename T>
-constexpr Vector3<T>::Vector3(T x, T y, T z) : x(x), y(y), z(z) {}
+constexpr Vector3<T>::Vector3(T x, T y, T z) : x(x), y(y), z(z) {
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Vector3::Vector3", *this);
+}
 
 template<typename T>
-T& Vector3<T>::operator[](int i) {
+constexpr T& Vector3<T>::operator[](int i) {
     if (i < 0 || i > 2) throw std::out_of_range("Vector3 index out of range");
-    return (&x)[i];
+    return i == 0 ? x : (i == 1 ? y : z);
 }
 
 template<typename T>
-const T& Vector3<T>::operator[](int i) const {
+constexpr const T& Vector3<T>::operator[](int i) const {
     if (i < 0 || i > 2) throw std::out_of_range("Vector3 index out of range");
-    return (&x)[i];
+    return i == 0 ? x : (i == 1 ? y : z);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::operator+(const Vector3<T>& v) const {
-    return Vector3(x + v.x, y + v.y, z + v.z);
+constexpr Vector3<T> Vector3<T>::operator+(const Vector3<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector3::operator+", Vector3(x + v.x, y + v.y, z + v.z), *this, v);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::operator-(const Vector3<T>& v) const {
-    return Vector3(x - v.x, y - v.y, z - v.z);
+constexpr Vector3<T> Vector3<T>::operator-(const Vector3<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector3::operator-", Vector3(x - v.x, y - v.y, z - v.z), *this, v);
 }
 
 template<typename T>
-Vector3<T>& Vector3<T>::operator+=(const Vector3<T>& v) {
+constexpr Vector3<T>& Vector3<T>::operator+=(const Vector3<T>& v) {
     x += v.x; y += v.y; z += v.z;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector3::operator+=", *this, v);
 }
 
 template<typename T>
-Vector3<T>& Vector3<T>::operator-=(const Vector3<T>& v) {
+constexpr Vector3<T>& Vector3<T>::operator-=(const Vector3<T>& v) {
     x -= v.x; y -= v.y; z -= v.z;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector3::operator-=", *this, v);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::operator*(T s) const {
-    return Vector3(x * s, y * s, z * s);
+constexpr Vector3<T> Vector3<T>::operator*(T s) const {
+    return RENDERFX_CHECK_FINITE("Vector3::operator*", Vector3(x * s, y * s, z * s), *this, s);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::operator/(T s) const {
-    if (std::abs(s) < std::numeric_limits<T>::epsilon())
+constexpr Vector3<T> Vector3<T>::operator/(T s) const {
+    if (math::abs(s) < std::numeric_limits<T>::epsilon())
         throw std::invalid_argument("Division by zero in Vector3");
-    return Vector3(x / s, y / s, z / s);
+    return RENDERFX_CHECK_FINITE("Vector3::operator/", Vector3(x / s, y / s, z / s), *this, s);
 }
 
 template<typename T>
-Vector3<T>& Vector3<T>::operator*=(T s) {
+constexpr Vector3<T>& Vector3<T>::operator*=(T s) {
     x *= s; y *= s; z *= s;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector3::operator*=", *this, s);
 }
 
 template<typename T>
-Vector3<T>& Vector3<T>::operator/=(T s) {
-    if (std::abs(s) < std::numeric_limits<T>::epsilon())
+constexpr Vector3<T>& Vector3<T>::operator/=(T s) {
+    if (math::abs(s) < std::numeric_limits<T>::epsilon())
         throw std::invalid_argument("Division by zero in Vector3");
     x /= s; y /= s; z /= s;
-    return *this;
+    return RENDERFX_CHECK_FINITE("Vector3::operator/=", *this, s);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::operator*(const Vector3<T>& other) const {
-    return Vector3(x * other.x, y * other.y, z * other.z);
+constexpr Vector3<T> Vector3<T>::operator*(const Vector3<T>& other) const {
+    return RENDERFX_CHECK_FINITE("Vector3::operator*", Vector3(x * other.x, y * other.y, z * other.z), *this, other);
 }
 
 template<typename T>
-T Vector3<T>::dot(const Vector3<T>& v) const {
-    return x * v.x + y * v.y + z * v.z;
+constexpr T Vector3<T>::dot(const Vector3<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector3::dot", x * v.x + y * v.y + z * v.z, *this, v);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::cross(const Vector3<T>& v) const {
-    return Vector3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
+constexpr Vector3<T> Vector3<T>::cross(const Vector3<T>& v) const {
+    return RENDERFX_CHECK_FINITE("Vector3::cross", Vector3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x), *this, v);
 }
 
 template<typename T>
-T Vector3<T>::lengthSquared() const {
-    return x * x + y * y + z * z;
+constexpr T Vector3<T>::lengthSquared() const {
+    return RENDERFX_CHECK_FINITE("Vector3::lengthSquared", x * x + y * y + z * z, *this);
 }
 
 template<typename T>
-T Vector3<T>::length() const {
-    return std::sqrt(lengthSquared());
+constexpr T Vector3<T>::length() const {
+    return math::sqrt(lengthSquared());
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::normalized() const {
+constexpr Vector3<T> Vector3<T>::normalized() const {
     T len = length();
     if (len < std::numeric_limits<T>::epsilon())
         throw std::domain_error("Cannot normalize zero-length Vector3");
@@ -101,7 +103,7 @@ Vector3<T> Vector3<T>::normalized() const {
 }
 
 template<typename T>
-void Vector3<T>::normalize() {
+constexpr void Vector3<T>::normalize() {
     T len = length();
     if (len < std::numeric_limits<T>::epsilon())
         throw std::domain_error("Cannot normalize zero-length Vector3");
@@ -109,42 +111,49 @@ void Vector3<T>::normalize() {
 }
 
 template<typename T>
-bool Vector3<T>::operator==(const Vector3<T>& v) const {
-    return std::abs(x - v.x) < std::numeric_limits<T>::epsilon() &&
-           std::abs(y - v.y) < std::numeric_limits<T>::epsilon() &&
-           std::abs(z - v.z) < std::numeric_limits<T>::epsilon();
+constexpr bool Vector3<T>::operator==(const Vector3<T>& v) const {
+    return math::abs(x - v.x) < std::numeric_limits<T>::epsilon() &&
+           math::abs(y - v.y) < std::numeric_limits<T>::epsilon() &&
+           math::abs(z - v.z) < std::numeric_limits<T>::epsilon();
 }
 
 template<typename T>
-bool Vector3<T>::operator!=(const Vector3<T>& v) const {
+constexpr bool Vector3<T>::operator!=(const Vector3<T>& v) const {
     return !(*this == v);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::projectOnto(const Vector3<T>& v) const {
+constexpr Vector3<T> Vector3<T>::projectOnto(const Vector3<T>& v) const {
     T lenSquared = v.lengthSquared();
     if (lenSquared < std::numeric_limits<T>::epsilon())
         throw std::invalid_argument("Cannot project onto zero-length vector");
-    return v * (this->dot(v) / lenSquared);
+    return RENDERFX_CHECK_FINITE("Vector3::projectOnto", v * (this->dot(v) / lenSquared), *this, v);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::reflect(const Vector3<T>& normal) const {
-    return *this - normal * (2 * this->dot(normal));
+constexpr Vector3<T> Vector3<T>::reflect(const Vector3<T>& normal) const {
+    return RENDERFX_CHECK_FINITE("Vector3::reflect", *this - normal * (2 * this->dot(normal)), *this, normal);
 }
 
 template<typename T>
-Vector3<T> Vector3<T>::lerp(const Vector3<T>& a, const Vector3<T>& b, T t) {
-    return a + (b - a) * t;
+constexpr Vector3<T> Vector3<T>::lerp(const Vector3<T>& a, const Vector3<T>& b, T t) {
+    // Per component, so no intermediate vectors are built.
+    return RENDERFX_CHECK_FINITE("Vector3::lerp", Vector3(
+        a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t), a, b, t);
 }
 
 template<typename T>
 Vector3<T> Vector3<T>::slerp(const Vector3<T>& a, const Vector3<T>& b, T t) {
     T dot = a.dot(b);
     dot = std::clamp(dot, T(-1), T(1));
-    T theta = std::acos(dot) * t;
+    T theta = math::acos(dot) * t;
     Vector3 relativeVec = (b - a * dot).normalized();
-    return a * std::cos(theta) + relativeVec * std::sin(theta);
+    return RENDERFX_CHECK_FINITE("Vector3::slerp", a * math::cos(theta) + relativeVec * math::sin(theta), a, b, t);
+}
+
+template<typename T>
+constexpr bool Vector3<T>::isFinite() const {
+    return detail::isFiniteValue(x) && detail::isFiniteValue(y) && detail::isFiniteValue(z);
 }
 
 template<typename T>
@@ -177,7 +186,7 @@ std::ostream& operator<<(std::ostream& os, const Vector3<T>& v) {
 }
 
 template<typename T>
-Vector3<T> operator*(T s, const Vector3<T>& v) {
+constexpr Vector3<T> operator*(T s, const Vector3<T>& v) {
     return v * s;
 }
 
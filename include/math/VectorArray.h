@@ -0,0 +1,185 @@
+#ifndef VECTORARRAY_H
+#define VECTORARRAY_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "VectorExpression.h"
+#include "VectorN.h"
+
+RENDERFX_STRICT_FP_BEGIN
+
+/**
+ * @brief A structure-of-arrays container of N-dimensional vectors.
+ *
+ * Each component is stored in its own contiguous stream, so kernels over
+ * one component vectorize. Arithmetic on arrays builds expressions (see
+ * VectorExpression.h); assigning an expression evaluates it in a single
+ * loop over the elements without intermediate arrays:
+ *
+ *     positions = positions + velocities * dt;
+ *     blended = lerp(from, to, weights);   // weights: VectorArray<T, 1>
+ *
+ * Vectors and scalars in an expression are broadcast to every element.
+ * Each element is fully evaluated before it is stored, so the target may
+ * also appear in the expression.
+ *
+ * @tparam T Type of the components.
+ * @tparam N Number of components.
+ */
+template<typename T, std::size_t N>
+class VectorArray : public VectorExpression<VectorArray<T, N>> {
+public:
+    using value_type = T;
+    static constexpr std::size_t components = N;
+    static constexpr bool storedByReference = true;
+
+    /**
+     * @brief Creates an empty array.
+     */
+    VectorArray() = default;
+
+    /**
+     * @brief Creates an array of zero vectors.
+     *
+     * @param count Number of elements.
+     */
+    explicit VectorArray(std::size_t count);
+
+    /**
+     * @brief Creates an array filled with one vector.
+     *
+     * @param count Number of elements.
+     * @param value The value of every element.
+     */
+    VectorArray(std::size_t count, const Vector<T, N>& value);
+
+    /**
+     * @brief Evaluates an expression into a new array.
+     *
+     * @param expression The expression; it must involve at least one array.
+     * @throws std::invalid_argument If the expression only contains broadcast operands.
+     */
+    template<typename E>
+    VectorArray(const VectorExpression<E>& expression);
+
+    VectorArray(const VectorArray&) = default;
+    VectorArray& operator=(const VectorArray&) = default;
+    VectorArray(VectorArray&&) noexcept = default;
+    VectorArray& operator=(VectorArray&&) noexcept = default;
+
+    /**
+     * @brief Evaluates an expression into this array in one pass.
+     *
+     * The array is resized to the expression's size; a broadcast-only
+     * expression fills the current elements.
+     *
+     * @param expression The expression.
+     * @return Reference to this array.
+     * @throws std::invalid_argument If the operand sizes differ.
+     */
+    template<typename E>
+    VectorArray& operator=(const VectorExpression<E>& expression);
+
+    template<typename E>
+    VectorArray& operator+=(const VectorExpression<E>& expression);
+
+    template<typename E>
+    VectorArray& operator-=(const VectorExpression<E>& expression);
+
+    VectorArray& operator*=(T s);
+
+    /// @name Element Access
+    /// @{
+
+    /**
+     * @brief Gets the number of elements.
+     *
+     * @return The number of elements.
+     */
+    std::size_t size() const noexcept { return count; }
+
+    /**
+     * @brief Checks if the array is empty.
+     *
+     * @return True if there are no elements.
+     */
+    bool empty() const noexcept { return count == 0; }
+
+    /**
+     * @brief Gathers one element.
+     *
+     * @param index Index of the element.
+     * @return The element.
+     */
+    Vector<T, N> get(std::size_t index) const;
+
+    /**
+     * @brief Scatters one element.
+     *
+     * @param index Index of the element.
+     * @param value The new value.
+     */
+    void set(std::size_t index, const Vector<T, N>& value);
+
+    /**
+     * @brief Gets the stream of one component.
+     *
+     * @param c Index of the component.
+     * @return Pointer to size() values.
+     */
+    T* component(std::size_t c) noexcept { return streams[c].data(); }
+
+    /**
+     * @brief Gets the stream of one component (const version).
+     *
+     * @param c Index of the component.
+     * @return Pointer to size() values.
+     */
+    const T* component(std::size_t c) const noexcept { return streams[c].data(); }
+
+    /**
+     * @brief Evaluates the array as an expression; used by the expression templates.
+     */
+    T eval(std::size_t element, std::size_t c) const { return streams[c][element]; }
+
+    /// @}
+
+    /// @name Capacity
+    /// @{
+
+    void resize(std::size_t newCount);
+
+    void reserve(std::size_t capacity);
+
+    void clear() noexcept;
+
+    /**
+     * @brief Appends an element.
+     *
+     * @param value The element.
+     */
+    void push_back(const Vector<T, N>& value);
+
+    /// @}
+
+private:
+    std::array<std::vector<T>, N> streams;
+    std::size_t count = 0;
+
+    template<typename E>
+    void evaluate(const E& expression);
+};
+
+// Commonly used types
+using ScalarArrayf = VectorArray<float, 1>;
+using Vector2Arrayf = VectorArray<float, 2>;
+using Vector3Arrayf = VectorArray<float, 3>;
+using Vector4Arrayf = VectorArray<float, 4>;
+using Vector3Arrayd = VectorArray<double, 3>;
+
+#include "VectorArray.inl"
+
+RENDERFX_STRICT_FP_END
+
+#endif // VECTORARRAY_H
@@ -0,0 +1,114 @@
+#ifndef VECTORARRAY_INL
+#define VECTORARRAY_INL
+
+template<typename T, std::size_t N>
+VectorArray<T, N>::VectorArray(std::size_t count) {
+    resize(count);
+}
+
+template<typename T, std::size_t N>
+VectorArray<T, N>::VectorArray(std::size_t count, const Vector<T, N>& value) {
+    resize(count);
+    evaluate(value);
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+VectorArray<T, N>::VectorArray(const VectorExpression<E>& expression) {
+    std::size_t n = expression.derived().size();
+    if (n == 0) throw std::invalid_argument("Cannot size a VectorArray from a broadcast expression");
+    resize(n);
+    evaluate(expression.derived());
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+VectorArray<T, N>& VectorArray<T, N>::operator=(const VectorExpression<E>& expression) {
+    std::size_t n = expression.derived().size();
+    // An array in the expression keeps its size, so resizing never moves an operand.
+    if (n != 0 && n != count) resize(n);
+    evaluate(expression.derived());
+    return *this;
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+VectorArray<T, N>& VectorArray<T, N>::operator+=(const VectorExpression<E>& expression) {
+    return *this = *this + expression;
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+VectorArray<T, N>& VectorArray<T, N>::operator-=(const VectorExpression<E>& expression) {
+    return *this = *this - expression;
+}
+
+template<typename T, std::size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator*=(T s) {
+    return *this = *this * s;
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+void VectorArray<T, N>::evaluate(const E& expression) {
+    static_assert(E::components == N || E::components == 1, "Expression has the wrong number of components");
+    if (expression.size() != 0 && expression.size() != count)
+        throw std::invalid_argument("Vector expression size does not match the VectorArray");
+
+    T* out[N];
+    for (std::size_t c = 0; c < N; ++c) out[c] = streams[c].data();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        T values[N];
+        for (std::size_t c = 0; c < N; ++c) values[c] = expression.eval(i, detail::componentIndex<E>(c));
+        for (std::size_t c = 0; c < N; ++c) out[c][i] = values[c];
+    }
+#if defined(RENDERFX_MATH_SANITIZE)
+    std::size_t nonFinite = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        bool finite = true;
+        for (std::size_t c = 0; c < N; ++c) finite = finite && detail::isFiniteValue(out[c][i]);
+        if (!finite) ++nonFinite;
+    }
+    NonFiniteLog::current().recordBatch("VectorArray::operator=", count, nonFinite);
+#endif
+}
+
+template<typename T, std::size_t N>
+Vector<T, N> VectorArray<T, N>::get(std::size_t index) const {
+    if (index >= count) throw std::out_of_range("VectorArray index out of range");
+    Vector<T, N> v;
+    for (std::size_t c = 0; c < N; ++c) v.at(c) = streams[c][index];
+    return v;
+}
+
+template<typename T, std::size_t N>
+void VectorArray<T, N>::set(std::size_t index, const Vector<T, N>& value) {
+    if (index >= count) throw std::out_of_range("VectorArray index out of range");
+    for (std::size_t c = 0; c < N; ++c) streams[c][index] = value.at(c);
+}
+
+template<typename T, std::size_t N>
+void VectorArray<T, N>::resize(std::size_t newCount) {
+    for (auto& stream : streams) stream.resize(newCount, T(0));
+    count = newCount;
+}
+
+template<typename T, std::size_t N>
+void VectorArray<T, N>::reserve(std::size_t capacity) {
+    for (auto& stream : streams) stream.reserve(capacity);
+}
+
+template<typename T, std::size_t N>
+void VectorArray<T, N>::clear() noexcept {
+    for (auto& stream : streams) stream.clear();
+    count = 0;
+}
+
+template<typename T, std::size_t N>
+void VectorArray<T, N>::push_back(const Vector<T, N>& value) {
+    for (std::size_t c = 0; c < N; ++c) streams[c].push_back(value.at(c));
+    ++count;
+}
+
+#endif // VECTORARRAY_INL
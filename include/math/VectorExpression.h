@@ -0,0 +1,350 @@
+#ifndef VECTOREXPRESSION_H
+#define VECTOREXPRESSION_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "MathFunctions.h"
+
+/**
+ * @file VectorExpression.h
+ * @brief Expression templates for the generic vector types.
+ *
+ * Arithmetic on Vector and VectorArray does not compute anything; it builds
+ * a lightweight expression object that is evaluated element by element when
+ * it is assigned. A chained expression such as `a + (b - a) * t` over
+ * VectorArray operands therefore runs as a single loop without temporaries.
+ * The operators are found by argument-dependent lookup; the functions, such
+ * as math::lerp() and math::normalize(), are in namespace math.
+ *
+ * Every expression provides:
+ * - `value_type`, the scalar type;
+ * - `components`, the number of components per element (1 broadcasts);
+ * - `size()`, the number of elements, where 0 broadcasts to any size;
+ * - `eval(element, component)`, the value of one component of one element.
+ *
+ * Fixed-size vectors and scalars are captured by value, arrays by reference,
+ * so an expression must not outlive the arrays it refers to.
+ */
+
+RENDERFX_STRICT_FP_BEGIN
+
+/**
+ * @brief CRTP base of all vector expressions.
+ *
+ * @tparam E The derived expression type.
+ */
+template<typename E>
+class VectorExpression {
+public:
+    /**
+     * @brief Gets the derived expression.
+     *
+     * @return Reference to the derived expression.
+     */
+    constexpr const E& derived() const noexcept { return static_cast<const E&>(*this); }
+};
+
+namespace detail {
+
+// Arrays are held by reference, everything else by value.
+template<typename E>
+using ExpressionOperand = std::conditional_t<E::storedByReference, const E&, E>;
+
+template<typename E>
+constexpr std::size_t componentIndex(std::size_t component) {
+    return E::components == 1 ? 0 : component;
+}
+
+inline std::size_t combinedSize(std::size_t a, std::size_t b) {
+    if (a != 0 && b != 0 && a != b) throw std::invalid_argument("Vector expression operand sizes do not match");
+    return a != 0 ? a : b;
+}
+
+struct Add { template<typename T> static constexpr T apply(T a, T b) { return a + b; } };
+struct Subtract { template<typename T> static constexpr T apply(T a, T b) { return a - b; } };
+struct Multiply { template<typename T> static constexpr T apply(T a, T b) { return a * b; } };
+struct Divide { template<typename T> static constexpr T apply(T a, T b) { return a / b; } };
+struct Minimum { template<typename T> static constexpr T apply(T a, T b) { return b < a ? b : a; } };
+struct Maximum { template<typename T> static constexpr T apply(T a, T b) { return a < b ? b : a; } };
+struct Negate { template<typename T> static constexpr T apply(T a) { return -a; } };
+struct Absolute { template<typename T> static constexpr T apply(T a) { return math::abs(a); } };
+struct SquareRoot { template<typename T> static constexpr T apply(T a) { return static_cast<T>(math::sqrt(a)); } };
+
+} // namespace detail
+
+/**
+ * @brief A scalar broadcast to every component of every element.
+ *
+ * @tparam T Type of the scalar.
+ */
+template<typename T>
+class ScalarExpression : public VectorExpression<ScalarExpression<T>> {
+public:
+    using value_type = T;
+    static constexpr std::size_t components = 1;
+    static constexpr bool storedByReference = false;
+
+    constexpr explicit ScalarExpression(T value) noexcept : value(value) {}
+    constexpr std::size_t size() const noexcept { return 0; }
+    constexpr T eval(std::size_t, std::size_t) const noexcept { return value; }
+
+private:
+    T value;
+};
+
+/**
+ * @brief Component-wise binary operation.
+ *
+ * @tparam Op The operation.
+ * @tparam L The left operand expression.
+ * @tparam R The right operand expression.
+ */
+template<typename Op, typename L, typename R>
+class BinaryExpression : public VectorExpression<BinaryExpression<Op, L, R>> {
+public:
+    static_assert(L::components == R::components || L::components == 1 || R::components == 1,
+                  "Vector expression operands must have the same number of components");
+
+    using value_type = typename L::value_type;
+    static constexpr std::size_t components = L::components > R::components ? L::components : R::components;
+    static constexpr bool storedByReference = false;
+
+    constexpr BinaryExpression(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+    std::size_t size() const { return detail::combinedSize(lhs.size(), rhs.size()); }
+    constexpr value_type eval(std::size_t element, std::size_t component) const {
+        return Op::apply(lhs.eval(element, detail::componentIndex<L>(component)),
+                         rhs.eval(element, detail::componentIndex<R>(component)));
+    }
+
+private:
+    detail::ExpressionOperand<L> lhs;
+    detail::ExpressionOperand<R> rhs;
+};
+
+/**
+ * @brief Component-wise unary operation.
+ *
+ * @tparam Op The operation.
+ * @tparam E The operand expression.
+ */
+template<typename Op, typename E>
+class UnaryExpression : public VectorExpression<UnaryExpression<Op, E>> {
+public:
+    using value_type = typename E::value_type;
+    static constexpr std::size_t components = E::components;
+    static constexpr bool storedByReference = false;
+
+    constexpr explicit UnaryExpression(const E& operand) : operand(operand) {}
+    std::size_t size() const { return operand.size(); }
+    constexpr value_type eval(std::size_t element, std::size_t component) const {
+        return Op::apply(operand.eval(element, component));
+    }
+
+private:
+    detail::ExpressionOperand<E> operand;
+};
+
+/**
+ * @brief Per-element dot product; a single-component expression.
+ *
+ * @tparam L The left operand expression.
+ * @tparam R The right operand expression.
+ */
+template<typename L, typename R>
+class DotExpression : public VectorExpression<DotExpression<L, R>> {
+public:
+    static_assert(L::components == R::components, "Dot product operands must have the same number of components");
+
+    using value_type = typename L::value_type;
+    static constexpr std::size_t components = 1;
+    static constexpr bool storedByReference = false;
+
+    constexpr DotExpression(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+    std::size_t size() const { return detail::combinedSize(lhs.size(), rhs.size()); }
+    constexpr value_type eval(std::size_t element, std::size_t) const {
+        value_type sum = lhs.eval(element, 0) * rhs.eval(element, 0);
+        for (std::size_t c = 1; c < L::components; ++c) {
+            sum += lhs.eval(element, c) * rhs.eval(element, c);
+        }
+        return sum;
+    }
+
+private:
+    detail::ExpressionOperand<L> lhs;
+    detail::ExpressionOperand<R> rhs;
+};
+
+/**
+ * @brief Per-element normalization.
+ *
+ * Elements are evaluated one after another, so the reciprocal length of
+ * an element is computed for its first component and reused for the
+ * others. Zero-length elements produce non-finite values.
+ *
+ * @tparam E The operand expression.
+ */
+template<typename E>
+class NormalizeExpression : public VectorExpression<NormalizeExpression<E>> {
+public:
+    using value_type = typename E::value_type;
+    static constexpr std::size_t components = E::components;
+    static constexpr bool storedByReference = false;
+
+    constexpr explicit NormalizeExpression(const E& operand) : operand(operand) {}
+    std::size_t size() const { return operand.size(); }
+    constexpr value_type eval(std::size_t element, std::size_t component) const {
+        // The cache is mutable, which constant expressions cannot read.
+        if (RENDERFX_IS_CONSTANT_EVALUATED()) return operand.eval(element, component) * inverse(element);
+        if (element != cachedElement) {
+            inverseLength = inverse(element);
+            cachedElement = element;
+        }
+        return operand.eval(element, component) * inverseLength;
+    }
+
+private:
+    constexpr value_type inverse(std::size_t element) const {
+        value_type sum = operand.eval(element, 0) * operand.eval(element, 0);
+        for (std::size_t c = 1; c < E::components; ++c) {
+            sum += operand.eval(element, c) * operand.eval(element, c);
+        }
+        return value_type(1) / detail::SquareRoot::apply(sum);
+    }
+
+    detail::ExpressionOperand<E> operand;
+    mutable std::size_t cachedElement = static_cast<std::size_t>(-1);
+    mutable value_type inverseLength = value_type(0);
+};
+
+/// @name Expression Operators
+/// @{
+
+template<typename L, typename R>
+constexpr BinaryExpression<detail::Add, L, R> operator+(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+template<typename L, typename R>
+constexpr BinaryExpression<detail::Subtract, L, R> operator-(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+template<typename L, typename R>
+constexpr BinaryExpression<detail::Multiply, L, R> operator*(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+template<typename L, typename R>
+constexpr BinaryExpression<detail::Divide, L, R> operator/(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+template<typename E>
+constexpr BinaryExpression<detail::Multiply, E, ScalarExpression<typename E::value_type>>
+operator*(const VectorExpression<E>& a, typename E::value_type s) {
+    return { a.derived(), ScalarExpression<typename E::value_type>(s) };
+}
+
+template<typename E>
+constexpr BinaryExpression<detail::Multiply, ScalarExpression<typename E::value_type>, E>
+operator*(typename E::value_type s, const VectorExpression<E>& a) {
+    return { ScalarExpression<typename E::value_type>(s), a.derived() };
+}
+
+template<typename E>
+constexpr BinaryExpression<detail::Divide, E, ScalarExpression<typename E::value_type>>
+operator/(const VectorExpression<E>& a, typename E::value_type s) {
+    return { a.derived(), ScalarExpression<typename E::value_type>(s) };
+}
+
+template<typename E>
+constexpr UnaryExpression<detail::Negate, E> operator-(const VectorExpression<E>& a) {
+    return UnaryExpression<detail::Negate, E>(a.derived());
+}
+
+/// @}
+
+namespace math {
+
+/// @name Expression Functions
+/// @{
+
+/**
+ * @brief Per-element dot product.
+ */
+template<typename L, typename R>
+constexpr DotExpression<L, R> dot(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+/**
+ * @brief Per-element squared length.
+ */
+template<typename E>
+constexpr DotExpression<E, E> lengthSquared(const VectorExpression<E>& a) {
+    return { a.derived(), a.derived() };
+}
+
+/**
+ * @brief Per-element length.
+ */
+template<typename E>
+constexpr UnaryExpression<detail::SquareRoot, DotExpression<E, E>> length(const VectorExpression<E>& a) {
+    return UnaryExpression<detail::SquareRoot, DotExpression<E, E>>(lengthSquared(a));
+}
+
+/**
+ * @brief Per-element normalization; zero-length elements produce non-finite values.
+ */
+template<typename E>
+constexpr NormalizeExpression<E> normalize(const VectorExpression<E>& a) {
+    return NormalizeExpression<E>(a.derived());
+}
+
+/**
+ * @brief Per-element linear interpolation `a + (b - a) * t`.
+ *
+ * @param t A scalar or a single-component expression holding one factor per element.
+ */
+template<typename L, typename R, typename F>
+constexpr auto lerp(const VectorExpression<L>& a, const VectorExpression<R>& b, const VectorExpression<F>& t) {
+    return a + (b - a) * t;
+}
+
+template<typename L, typename R>
+constexpr auto lerp(const VectorExpression<L>& a, const VectorExpression<R>& b, typename L::value_type t) {
+    return a + (b - a) * t;
+}
+
+/**
+ * @brief Component-wise minimum.
+ */
+template<typename L, typename R>
+constexpr BinaryExpression<detail::Minimum, L, R> min(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+/**
+ * @brief Component-wise maximum.
+ */
+template<typename L, typename R>
+constexpr BinaryExpression<detail::Maximum, L, R> max(const VectorExpression<L>& a, const VectorExpression<R>& b) {
+    return { a.derived(), b.derived() };
+}
+
+/**
+ * @brief Component-wise absolute value.
+ */
+template<typename E>
+constexpr UnaryExpression<detail::Absolute, E> abs(const VectorExpression<E>& a) {
+    return UnaryExpression<detail::Absolute, E>(a.derived());
+}
+
+/// @}
+
+} // namespace math
+
+RENDERFX_STRICT_FP_END
+
+#endif // VECTOREXPRESSION_H
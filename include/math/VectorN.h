@@ -0,0 +1,312 @@
+#ifndef VECTORN_H
+#define VECTORN_H
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "MathDebug.h"
+#include "MathFunctions.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "VectorExpression.h"
+
+RENDERFX_STRICT_FP_BEGIN
+
+namespace detail {
+
+// Component storage; sizes 2 to 4 expose named members like Vector2 and Vector3.
+template<typename T, std::size_t N>
+struct VectorStorage {
+    T elements[N] = {};
+
+    constexpr T& at(std::size_t i) { return elements[i]; }
+    constexpr const T& at(std::size_t i) const { return elements[i]; }
+};
+
+template<typename T>
+struct VectorStorage<T, 2> {
+    T x = T(0), y = T(0);
+
+    constexpr T& at(std::size_t i) { return i == 0 ? x : y; }
+    constexpr const T& at(std::size_t i) const { return i == 0 ? x : y; }
+};
+
+template<typename T>
+struct VectorStorage<T, 3> {
+    T x = T(0), y = T(0), z = T(0);
+
+    constexpr T& at(std::size_t i) { return i == 0 ? x : i == 1 ? y : z; }
+    constexpr const T& at(std::size_t i) const { return i == 0 ? x : i == 1 ? y : z; }
+};
+
+template<typename T>
+struct VectorStorage<T, 4> {
+    T x = T(0), y = T(0), z = T(0), w = T(0);
+
+    constexpr T& at(std::size_t i) { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+    constexpr const T& at(std::size_t i) const { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+};
+
+} // namespace detail
+
+/**
+ * @class Vector
+ * @brief A template class for an N-dimensional vector.
+ *
+ * The generic counterpart of Vector2 and Vector3. Vectors of 2 to 4
+ * components have x, y, z and w members; all sizes support indexing.
+ * Arithmetic builds expressions (see VectorExpression.h) that are evaluated
+ * when converted back to a Vector, so chained operations do not create
+ * intermediate vectors. Vector<T, 2> and Vector<T, 3> convert to and from
+ * Vector2 and Vector3.
+ *
+ * Vector2 and Vector3 are not aliases of this template. They stay separate
+ * classes so that their layout, constexpr API and operators are unchanged
+ * for existing code; convert where the expression templates are wanted.
+ *
+ * @tparam T Type of the components.
+ * @tparam N Number of components.
+ */
+template<typename T, std::size_t N>
+class Vector : public detail::VectorStorage<T, N>, public VectorExpression<Vector<T, N>> {
+    static_assert(N > 0, "Vector must have at least one component");
+
+public:
+    using value_type = T;
+    static constexpr std::size_t components = N;
+    static constexpr bool storedByReference = false;
+
+    /// @name Constructors
+    /// @{
+
+    /**
+     * @brief Default constructor.
+     * Initializes all components to zero.
+     */
+    constexpr Vector() = default;
+
+    /**
+     * @brief Initializes all components to the same value.
+     * @param s The value.
+     */
+    constexpr explicit Vector(T s);
+
+    /**
+     * @brief Initializes the components in order.
+     * @param values Exactly N values convertible to T.
+     */
+    template<typename... Values,
+             typename = std::enable_if_t<sizeof...(Values) == N && (N > 1) && (std::is_convertible_v<Values, T> && ...)>>
+    constexpr Vector(Values... values);
+
+    /**
+     * @brief Evaluates an expression.
+     * @param expression An expression with N components, or one broadcast component.
+     */
+    template<typename E>
+    constexpr Vector(const VectorExpression<E>& expression);
+
+    /**
+     * @brief Converts from Vector2.
+     * @param v The vector.
+     */
+    template<std::size_t M = N, typename = std::enable_if_t<M == 2>>
+    constexpr Vector(const Vector2<T>& v);
+
+    /**
+     * @brief Converts from Vector3.
+     * @param v The vector.
+     */
+    template<std::size_t M = N, typename = std::enable_if_t<M == 3>>
+    constexpr Vector(const Vector3<T>& v);
+
+    /**
+     * @brief Extends a Vector3 with a fourth component.
+     * @param v The vector.
+     * @param w The fourth component.
+     */
+    template<std::size_t M = N, typename = std::enable_if_t<M == 4>>
+    constexpr Vector(const Vector3<T>& v, T w);
+
+    /// @}
+
+    /// @name Element Access
+    /// @{
+
+    /**
+     * @brief Accesses a component of the vector.
+     * @param i Index of the component.
+     * @return Reference to the component.
+     */
+    constexpr T& operator[](std::size_t i);
+
+    /**
+     * @brief Accesses a component of the vector (const version).
+     * @param i Index of the component.
+     * @return Const reference to the component.
+     */
+    constexpr const T& operator[](std::size_t i) const;
+
+    /**
+     * @brief Evaluates the vector as an expression; used by the expression templates.
+     * @param component Index of the component.
+     * @return The component.
+     */
+    constexpr T eval(std::size_t, std::size_t component) const { return this->at(component); }
+
+    /**
+     * @brief Gets the number of elements as an expression; a vector broadcasts.
+     * @return Zero.
+     */
+    constexpr std::size_t size() const noexcept { return 0; }
+
+    /// @}
+
+    /// @name Compound Assignment
+    /// @{
+
+    template<typename E>
+    constexpr Vector& operator+=(const VectorExpression<E>& expression);
+
+    template<typename E>
+    constexpr Vector& operator-=(const VectorExpression<E>& expression);
+
+    constexpr Vector& operator*=(T s);
+
+    constexpr Vector& operator/=(T s);
+
+    /// @}
+
+    /// @name Vector Operations
+    /// @{
+
+    /**
+     * @brief Computes the dot product with another vector.
+     * @param v The other vector.
+     * @return The dot product.
+     */
+    constexpr T dot(const Vector& v) const;
+
+    /**
+     * @brief Computes the squared length of the vector.
+     * @return The squared length.
+     */
+    constexpr T lengthSquared() const;
+
+    /**
+     * @brief Computes the length of the vector.
+     * @return The length.
+     */
+    constexpr T length() const;
+
+    /**
+     * @brief Returns a normalized copy of the vector.
+     * @return The normalized vector.
+     * @throws std::domain_error If the vector has zero length.
+     */
+    constexpr Vector normalized() const;
+
+    /**
+     * @brief Normalizes the vector in place.
+     * @throws std::domain_error If the vector has zero length.
+     */
+    constexpr void normalize();
+
+    /**
+     * @brief Linearly interpolates between two vectors.
+     * @param a The start vector.
+     * @param b The end vector.
+     * @param t The interpolation factor [0, 1].
+     * @return The interpolated vector.
+     */
+    static constexpr Vector lerp(const Vector& a, const Vector& b, T t);
+
+    /// @}
+
+    /// @name Comparison Operators
+    /// @{
+
+    /**
+     * @brief Compares two vectors component-wise within machine epsilon, like Vector3.
+     * @param v The other vector.
+     * @return True if every component differs by less than epsilon.
+     */
+    constexpr bool operator==(const Vector& v) const;
+
+    constexpr bool operator!=(const Vector& v) const;
+
+    /**
+     * @brief Checks if all components are finite.
+     * @return False if any component is NaN or infinite.
+     */
+    constexpr bool isFinite() const;
+
+    /// @}
+
+    /// @name Conversions
+    /// @{
+
+    /**
+     * @brief Converts to Vector2.
+     * @return The vector as a Vector2.
+     */
+    template<std::size_t M = N, typename = std::enable_if_t<M == 2>>
+    constexpr Vector2<T> toVector2() const;
+
+    /**
+     * @brief Converts to Vector3, dropping any fourth component.
+     * @return The first three components as a Vector3.
+     */
+    template<std::size_t M = N, typename = std::enable_if_t<M == 3 || M == 4>>
+    constexpr Vector3<T> toVector3() const;
+
+    /// @}
+
+    /// @name Utility Functions
+    /// @{
+
+    /**
+     * @brief Returns a vector with all components set to zero.
+     * @return The zero vector.
+     */
+    static constexpr Vector zero();
+
+    /**
+     * @brief Returns a vector with all components set to one.
+     * @return The one vector.
+     */
+    static constexpr Vector one();
+
+    /**
+     * @brief Returns the unit vector along an axis.
+     * @param axis Index of the axis.
+     * @return The unit vector.
+     */
+    static constexpr Vector unit(std::size_t axis);
+
+    /// @}
+
+    /**
+     * @brief Overload of the stream insertion operator for Vector.
+     * @param os The output stream.
+     * @param v The vector to output.
+     * @return The output stream.
+     */
+    template<typename U, std::size_t M>
+    friend std::ostream& operator<<(std::ostream& os, const Vector<U, M>& v);
+};
+
+// Commonly used types
+template<typename T>
+using Vector4 = Vector<T, 4>;
+
+using Vector4f = Vector4<float>;
+using Vector4d = Vector4<double>;
+using Vector4i = Vector4<int>;
+
+#include "VectorN.inl"
+
+RENDERFX_STRICT_FP_END
+
+#endif // VECTORN_H
@@ -0,0 +1,183 @@
+#ifndef VECTORN_INL
+#define VECTORN_INL
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N>::Vector(T s) {
+    for (std::size_t i = 0; i < N; ++i) this->at(i) = s;
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Vector::Vector", *this);
+}
+
+template<typename T, std::size_t N>
+template<typename... Values, typename>
+constexpr Vector<T, N>::Vector(Values... values) {
+    const T list[] = { static_cast<T>(values)... };
+    for (std::size_t i = 0; i < N; ++i) this->at(i) = list[i];
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Vector::Vector", *this);
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+constexpr Vector<T, N>::Vector(const VectorExpression<E>& expression) {
+    static_assert(E::components == N || E::components == 1, "Expression has the wrong number of components");
+    const E& e = expression.derived();
+    for (std::size_t i = 0; i < N; ++i) this->at(i) = e.eval(0, detail::componentIndex<E>(i));
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Vector::Vector", *this);
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M, typename>
+constexpr Vector<T, N>::Vector(const Vector2<T>& v) {
+    this->x = v.x;
+    this->y = v.y;
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M, typename>
+constexpr Vector<T, N>::Vector(const Vector3<T>& v) {
+    this->x = v.x;
+    this->y = v.y;
+    this->z = v.z;
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M, typename>
+constexpr Vector<T, N>::Vector(const Vector3<T>& v, T w) {
+    this->x = v.x;
+    this->y = v.y;
+    this->z = v.z;
+    this->w = w;
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("Vector::Vector", *this);
+}
+
+template<typename T, std::size_t N>
+constexpr T& Vector<T, N>::operator[](std::size_t i) {
+    if (i >= N) throw std::out_of_range("Vector index out of range");
+    return this->at(i);
+}
+
+template<typename T, std::size_t N>
+constexpr const T& Vector<T, N>::operator[](std::size_t i) const {
+    if (i >= N) throw std::out_of_range("Vector index out of range");
+    return this->at(i);
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator+=(const VectorExpression<E>& expression) {
+    // Evaluate first; the expression may refer to this vector.
+    Vector v(expression);
+    for (std::size_t i = 0; i < N; ++i) this->at(i) += v.at(i);
+    return RENDERFX_CHECK_FINITE("Vector::operator+=", *this, v);
+}
+
+template<typename T, std::size_t N>
+template<typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator-=(const VectorExpression<E>& expression) {
+    Vector v(expression);
+    for (std::size_t i = 0; i < N; ++i) this->at(i) -= v.at(i);
+    return RENDERFX_CHECK_FINITE("Vector::operator-=", *this, v);
+}
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N>& Vector<T, N>::operator*=(T s) {
+    for (std::size_t i = 0; i < N; ++i) this->at(i) *= s;
+    return RENDERFX_CHECK_FINITE("Vector::operator*=", *this, s);
+}
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N>& Vector<T, N>::operator/=(T s) {
+    if (math::abs(s) < std::numeric_limits<T>::epsilon())
+        throw std::invalid_argument("Division by zero in Vector");
+    for (std::size_t i = 0; i < N; ++i) this->at(i) /= s;
+    return RENDERFX_CHECK_FINITE("Vector::operator/=", *this, s);
+}
+
+template<typename T, std::size_t N>
+constexpr T Vector<T, N>::dot(const Vector& v) const {
+    T sum = this->at(0) * v.at(0);
+    for (std::size_t i = 1; i < N; ++i) sum += this->at(i) * v.at(i);
+    return RENDERFX_CHECK_FINITE("Vector::dot", sum, *this, v);
+}
+
+template<typename T, std::size_t N>
+constexpr T Vector<T, N>::lengthSquared() const {
+    return dot(*this);
+}
+
+template<typename T, std::size_t N>
+constexpr T Vector<T, N>::length() const {
+    return static_cast<T>(math::sqrt(lengthSquared()));
+}
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::normalized() const {
+    T len = length();
+    if (len < std::numeric_limits<T>::epsilon())
+        throw std::domain_error("Cannot normalize zero-length Vector");
+    return RENDERFX_CHECK_FINITE("Vector::normalized", Vector(*this / len), *this);
+}
+
+template<typename T, std::size_t N>
+constexpr void Vector<T, N>::normalize() {
+    *this = normalized();
+}
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::lerp(const Vector& a, const Vector& b, T t) {
+    return RENDERFX_CHECK_FINITE("Vector::lerp", Vector(math::lerp(a, b, t)), a, b, t);
+}
+
+template<typename T, std::size_t N>
+constexpr bool Vector<T, N>::operator==(const Vector& v) const {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!(math::abs(this->at(i) - v.at(i)) < std::numeric_limits<T>::epsilon())) return false;
+    }
+    return true;
+}
+
+template<typename T, std::size_t N>
+constexpr bool Vector<T, N>::operator!=(const Vector& v) const {
+    return !(*this == v);
+}
+
+template<typename T, std::size_t N>
+constexpr bool Vector<T, N>::isFinite() const {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!detail::isFiniteValue(this->at(i))) return false;
+    }
+    return true;
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M, typename>
+constexpr Vector2<T> Vector<T, N>::toVector2() const {
+    return Vector2<T>(this->x, this->y);
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M, typename>
+constexpr Vector3<T> Vector<T, N>::toVector3() const {
+    return Vector3<T>(this->x, this->y, this->z);
+}
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::zero() { return Vector(T(0)); }
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::one() { return Vector(T(1)); }
+
+template<typename T, std::size_t N>
+constexpr Vector<T, N> Vector<T, N>::unit(std::size_t axis) {
+    Vector v;
+    v[axis] = T(1);
+    return v;
+}
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& os, const Vector<T, N>& v) {
+    os << "Vector" << N << "(";
+    for (std::size_t i = 0; i < N; ++i) os << (i ? ", " : "") << v.at(i);
+    return os << ")";
+}
+
+#endif // VECTORN_INL
@@ -0,0 +1,125 @@
+#ifndef SNAPSHOTBUFFER_H
+#define SNAPSHOTBUFFER_H
+
+#include <cstddef>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../scene/TransformSoA.h"
+
+/**
+ * @brief How SnapshotBuffer::sample() produced its result.
+ */
+enum class SnapshotSample {
+    Empty,        ///< There were no snapshots; the output is unchanged.
+    Held,         ///< The render time was before the oldest snapshot, or there was only one; it was copied.
+    Interpolated, ///< The render time was between two snapshots.
+    Extrapolated, ///< The render time was after the newest snapshot; motion was continued, up to the limit.
+};
+
+/**
+ * @brief A jitter buffer of timestamped transform snapshots for client-side interpolation.
+ *
+ * Snapshots arrive at an irregular rate and possibly out of order; they
+ * are kept sorted by their time on the sender's clock. Rendering samples
+ * the buffer at a render time somewhat behind the newest snapshot, so two
+ * snapshots usually bracket it and every entity is interpolated between
+ * them with TransformSoA::interpolate(), without trigonometry. When the
+ * render time runs past the newest snapshot, the motion between the last
+ * two is continued for at most maxExtrapolation seconds and then held.
+ *
+ * Entity i is the same object in every snapshot; entities that are only in
+ * the newer of two snapshots are copied from it.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+class SnapshotBuffer {
+public:
+    /**
+     * @brief Creates an empty buffer.
+     *
+     * @param capacity The number of snapshots kept; the oldest is replaced when full.
+     * @param maxExtrapolation Longest time in seconds motion is continued past the newest snapshot.
+     * @throws std::invalid_argument If capacity is zero or maxExtrapolation is negative.
+     */
+    explicit SnapshotBuffer(std::size_t capacity = 32, double maxExtrapolation = 0.25);
+
+    std::size_t size() const noexcept { return order.size(); }
+    bool empty() const noexcept { return order.empty(); }
+    std::size_t capacity() const noexcept { return snapshots.size(); }
+    void clear() noexcept { order.clear(); }
+
+    /**
+     * @brief Gets the time of the oldest snapshot.
+     *
+     * @return The time.
+     * @throws std::out_of_range If the buffer is empty.
+     */
+    double oldestTime() const;
+
+    /**
+     * @brief Gets the time of the newest snapshot.
+     *
+     * @return The time.
+     * @throws std::out_of_range If the buffer is empty.
+     */
+    double newestTime() const;
+
+    /**
+     * @brief Adds a snapshot and returns its storage, e.g. for TransformCodec::dequantize().
+     *
+     * @param time The time of the snapshot on the sender's clock.
+     * @return The transforms to fill, or null if the snapshot is a duplicate or
+     *         older than every kept snapshot of a full buffer.
+     * @throws std::invalid_argument If time is not finite.
+     */
+    TransformSoA<T>* insert(double time);
+
+    /**
+     * @brief Adds a copy of a snapshot.
+     *
+     * @param time The time of the snapshot on the sender's clock.
+     * @param transforms The transforms.
+     * @return False if the snapshot was dropped, see insert().
+     * @throws std::invalid_argument If time is not finite.
+     */
+    bool push(double time, const TransformSoA<T>& transforms);
+
+    /**
+     * @brief Computes the transforms of every entity at a render time.
+     *
+     * @param renderTime The time on the sender's clock, typically the newest
+     *        time minus an interpolation delay of two or three send intervals.
+     * @param out Receives the transforms; resized to the newer snapshot.
+     * @param pool Threads to spread the entities over; the calling thread does all the work if null.
+     * @param blend How rotations are interpolated; extrapolation always uses RotationBlend::Nlerp.
+     * @return How the result was produced.
+     * @throws std::invalid_argument If renderTime is not finite.
+     *
+     * Not safe to call concurrently on the same buffer: when the entity
+     * count changes between two snapshots, the older one is padded in a
+     * scratch buffer that is reused from call to call.
+     */
+    SnapshotSample sample(double renderTime, TransformSoA<T>& out, ThreadPool* pool = nullptr,
+                          RotationBlend blend = RotationBlend::FastSlerp) const;
+
+private:
+    struct Snapshot {
+        double time = 0;
+        TransformSoA<T> transforms;
+    };
+
+    std::vector<Snapshot> snapshots;
+    std::vector<std::size_t> order; // Indices of the used snapshots, oldest first.
+    double maxExtrapolation;
+    mutable TransformSoA<T> matched; // The older snapshot padded to the size of the newer one.
+
+    void interpolateInto(const Snapshot& from, const Snapshot& to, T t, TransformSoA<T>& out, ThreadPool* pool, RotationBlend blend) const;
+};
+
+// Commonly used types
+using SnapshotBufferf = SnapshotBuffer<float>;
+
+#include "SnapshotBuffer.inl"
+
+#endif // SNAPSHOTBUFFER_H
@@ -0,0 +1,125 @@
+#ifndef SNAPSHOTBUFFER_INL
+#define SNAPSHOTBUFFER_INL
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+template<typename T>
+SnapshotBuffer<T>::SnapshotBuffer(std::size_t capacity, double maxExtrapolation)
+    : maxExtrapolation(maxExtrapolation) {
+    if (capacity == 0) throw std::invalid_argument("SnapshotBuffer capacity must be positive");
+    if (!(maxExtrapolation >= 0)) throw std::invalid_argument("SnapshotBuffer maxExtrapolation must not be negative");
+    snapshots.resize(capacity);
+    order.reserve(capacity);
+}
+
+template<typename T>
+double SnapshotBuffer<T>::oldestTime() const {
+    if (order.empty()) throw std::out_of_range("SnapshotBuffer is empty");
+    return snapshots[order.front()].time;
+}
+
+template<typename T>
+double SnapshotBuffer<T>::newestTime() const {
+    if (order.empty()) throw std::out_of_range("SnapshotBuffer is empty");
+    return snapshots[order.back()].time;
+}
+
+template<typename T>
+TransformSoA<T>* SnapshotBuffer<T>::insert(double time) {
+    // A NaN would compare false against everything and break the ordering.
+    if (!std::isfinite(time)) throw std::invalid_argument("SnapshotBuffer times must be finite");
+    auto position = std::lower_bound(order.begin(), order.end(), time,
+                                     [this](std::size_t index, double value) { return snapshots[index].time < value; });
+    if (position != order.end() && snapshots[*position].time == time) return nullptr;
+    std::size_t rank = static_cast<std::size_t>(position - order.begin());
+
+    std::size_t slot = 0;
+    if (order.size() < snapshots.size()) {
+        // The capacity is small, so a linear search for a free slot is cheap.
+        while (std::find(order.begin(), order.end(), slot) != order.end()) ++slot;
+    } else {
+        // Full: a snapshot older than all others would be evicted right away.
+        if (rank == 0) return nullptr;
+        slot = order.front();
+        order.erase(order.begin());
+        --rank;
+    }
+    order.insert(order.begin() + static_cast<std::ptrdiff_t>(rank), slot);
+    snapshots[slot].time = time;
+    return &snapshots[slot].transforms;
+}
+
+template<typename T>
+bool SnapshotBuffer<T>::push(double time, const TransformSoA<T>& transforms) {
+    TransformSoA<T>* target = insert(time);
+    if (!target) return false;
+    *target = transforms;
+    return true;
+}
+
+template<typename T>
+SnapshotSample SnapshotBuffer<T>::sample(double renderTime, TransformSoA<T>& out, ThreadPool* pool,
+                                         RotationBlend blend) const {
+    if (!std::isfinite(renderTime)) throw std::invalid_argument("SnapshotBuffer render time must be finite");
+    if (order.empty()) return SnapshotSample::Empty;
+
+    const Snapshot& oldest = snapshots[order.front()];
+    if (order.size() == 1 || renderTime <= oldest.time) {
+        out = oldest.transforms;
+        return SnapshotSample::Held;
+    }
+
+    const Snapshot& newest = snapshots[order.back()];
+    if (renderTime >= newest.time) {
+        const Snapshot& previous = snapshots[order[order.size() - 2]];
+        double interval = newest.time - previous.time;
+        double ahead = std::min(renderTime - newest.time, maxExtrapolation);
+        interpolateInto(previous, newest, static_cast<T>(1.0 + ahead / interval), out, pool, RotationBlend::Nlerp);
+        return ahead > 0 ? SnapshotSample::Extrapolated : SnapshotSample::Interpolated;
+    }
+
+    auto next = std::upper_bound(order.begin(), order.end(), renderTime,
+                                 [this](double value, std::size_t index) { return value < snapshots[index].time; });
+    const Snapshot& from = snapshots[*(next - 1)];
+    const Snapshot& to = snapshots[*next];
+    interpolateInto(from, to, static_cast<T>((renderTime - from.time) / (to.time - from.time)), out, pool, blend);
+    return SnapshotSample::Interpolated;
+}
+
+template<typename T>
+void SnapshotBuffer<T>::interpolateInto(const Snapshot& from, const Snapshot& to, T t, TransformSoA<T>& out,
+                                        ThreadPool* pool, RotationBlend blend) const {
+    const TransformSoA<T>& b = to.transforms;
+    std::size_t count = std::min(from.transforms.size(), b.size());
+    out.resize(b.size());
+
+    // TransformSoA::interpolate() needs arrays of the same size; entities
+    // spawn or despawn rarely, so only then is the older snapshot copied,
+    // into a member whose storage is kept for the next call.
+    if (from.transforms.size() != b.size()) {
+        matched = from.transforms;
+        matched.resize(b.size());
+    }
+    const TransformSoA<T>& a = from.transforms.size() == b.size() ? from.transforms : matched;
+
+    if (pool) {
+        pool->parallelFor(0, count, 4096, [&](std::size_t first, std::size_t last) {
+            TransformSoA<T>::interpolate(a, b, t, out, first, last, blend);
+        });
+    } else {
+        TransformSoA<T>::interpolate(a, b, t, out, 0, count, blend);
+    }
+
+    // Entities that are new in the newer snapshot have nothing to blend with.
+    for (std::size_t i = count; i < b.size(); ++i) {
+        for (std::size_t c = 0; c < 3; ++c) {
+            out.positions.component(c)[i] = b.positions.component(c)[i];
+            out.scales.component(c)[i] = b.scales.component(c)[i];
+        }
+        for (std::size_t c = 0; c < 4; ++c) out.rotations.component(c)[i] = b.rotations.component(c)[i];
+    }
+}
+
+#endif // SNAPSHOTBUFFER_INL
@@ -0,0 +1,223 @@
+#ifndef TRANSFORMCODEC_H
+#define TRANSFORMCODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "../math/Geometry.h"
+#include "../scene/TransformSoA.h"
+
+/**
+ * @file TransformCodec.h
+ * @brief Quantization and delta compression of transforms for replication.
+ *
+ * A packet holds the transforms of one tick, quantized and delta-encoded
+ * against a baseline the receiver has acknowledged:
+ *
+ * - Positions are quantized against a world AABB, scales (optional)
+ *   against a range, each axis to a configurable number of bits.
+ * - Rotations use smallest-three: the index of the largest quaternion
+ *   component in 2 bits and the other three components, which lie in
+ *   [-1/sqrt(2), 1/sqrt(2)], quantized; the sign is chosen so the largest
+ *   component is positive and it is rebuilt from the unit length.
+ * - Every quantized value is subtracted from the baseline and zigzag
+ *   encoded. A bit mask marks the entities with any nonzero delta; their
+ *   deltas are bit-packed in blocks of 32 entities, each field of a block
+ *   with the width of its largest delta.
+ *
+ * All values are stored little-endian and bit-packed LSB first, so packets
+ * are portable between machines. Encoder and decoder must use the same
+ * TransformQuantization, which packets carry a fingerprint of. A 32-bit
+ * checksum over the rest of the packet rejects truncated or corrupted
+ * packets that would otherwise decode to wrong transforms; it is not a
+ * cryptographic hash and does not protect against forged packets.
+ */
+
+/**
+ * @brief Quantization parameters; sender and receiver must agree on them.
+ */
+struct TransformQuantization {
+    AABB<float> bounds = AABB<float>(Vector3<float>(-4096, -4096, -4096), Vector3<float>(4096, 4096, 4096)); ///< Range of positions; values outside are clamped.
+    int positionBits = 18;  ///< Bits per position axis, 1 to 24.
+    int rotationBits = 11;  ///< Bits per smallest-three component, 2 to 16.
+    bool scale = false;     ///< Whether scales are sent; otherwise the receiver gets unit scales.
+    float minScale = 0.0f;  ///< Smallest scale per axis.
+    float maxScale = 8.0f;  ///< Largest scale per axis.
+    int scaleBits = 12;     ///< Bits per scale axis, 1 to 24.
+};
+
+/**
+ * @brief Quantized transforms of one tick, stored per field.
+ *
+ * Snapshots are kept as baselines by both sides; their values are exactly
+ * what the receiver reconstructs, so deltas never accumulate error.
+ */
+struct QuantizedTransforms {
+    /// Position x, y, z; rotation index; three rotation components; scale x, y, z.
+    static constexpr std::size_t fieldCount = 10;
+
+    std::array<std::vector<std::uint32_t>, fieldCount> fields; ///< One value per entity in every field.
+
+    std::size_t size() const noexcept { return fields[0].size(); }
+
+    /**
+     * @brief Resizes every field; new entities are zero.
+     *
+     * @param count The number of entities.
+     */
+    void resize(std::size_t count);
+};
+
+/**
+ * @brief Header of a transform packet.
+ */
+struct TransformPacketHeader {
+    std::uint32_t sequence = 0;         ///< Tick of the transforms.
+    std::uint32_t baselineSequence = 0; ///< Tick of the baseline, or TransformCodec::noBaseline.
+    std::uint32_t entityCount = 0;      ///< Number of transforms.
+    std::uint32_t baselineCount = 0;    ///< Number of transforms in the baseline.
+    std::uint32_t fingerprint = 0;      ///< Fingerprint of the TransformQuantization.
+    std::uint32_t changedCount = 0;     ///< Number of transforms that differ from the baseline.
+    std::uint32_t checksum = 0;         ///< Checksum of the packet without this field.
+};
+
+/**
+ * @brief Keeps recent snapshots so packets can be encoded or decoded against any of them.
+ *
+ * The sender stores every snapshot it sends and encodes against the newest
+ * one the receiver acknowledged; the receiver stores every snapshot it
+ * decodes and looks up the baseline named in the next packet header.
+ */
+class TransformSnapshotHistory {
+public:
+    /**
+     * @brief Creates a history.
+     *
+     * @param capacity The number of snapshots kept; older ones are replaced.
+     */
+    explicit TransformSnapshotHistory(std::size_t capacity = 32);
+
+    /**
+     * @brief Gets the slot for a new snapshot, replacing the oldest one.
+     *
+     * @param sequence The tick of the snapshot.
+     * @return The snapshot to fill; its storage is reused.
+     */
+    QuantizedTransforms& store(std::uint32_t sequence);
+
+    /**
+     * @brief Finds a snapshot.
+     *
+     * @param sequence The tick.
+     * @return The snapshot, or null if it was never stored or has been replaced.
+     */
+    const QuantizedTransforms* find(std::uint32_t sequence) const noexcept;
+
+private:
+    struct Entry {
+        bool valid = false;
+        std::uint32_t sequence = 0;
+        QuantizedTransforms transforms;
+    };
+
+    std::vector<Entry> entries;
+    std::size_t next = 0;
+};
+
+/**
+ * @brief Encodes and decodes transform packets.
+ *
+ * encode() and decode() reuse internal buffers, so each thread needs its
+ * own codec.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+class TransformCodec {
+public:
+    static_assert(std::is_floating_point<T>::value, "TransformCodec requires a floating-point type");
+
+    static constexpr std::uint32_t noBaseline = 0xFFFFFFFFu; ///< Baseline sequence of packets without a baseline.
+    static constexpr std::size_t headerSize = 28;            ///< Size of the packet header in bytes.
+
+    /**
+     * @brief Creates a codec.
+     *
+     * @param quantization The quantization parameters.
+     * @throws std::invalid_argument If a bit count or range is invalid.
+     */
+    explicit TransformCodec(const TransformQuantization& quantization = TransformQuantization());
+
+    const TransformQuantization& quantization() const noexcept { return settings; }
+
+    /**
+     * @brief Quantizes transforms.
+     *
+     * Rotations must be normalized.
+     *
+     * @param transforms The transforms.
+     * @param quantized Receives one quantized transform per transform.
+     */
+    void quantize(const TransformSoA<T>& transforms, QuantizedTransforms& quantized) const;
+
+    /**
+     * @brief Reconstructs transforms, writing straight into the component arrays.
+     *
+     * @param quantized The quantized transforms.
+     * @param transforms Receives the transforms; resized to match.
+     */
+    void dequantize(const QuantizedTransforms& quantized, TransformSoA<T>& transforms) const;
+
+    /**
+     * @brief Encodes a packet.
+     *
+     * @param current The quantized transforms to send.
+     * @param sequence The tick of current.
+     * @param baseline The acknowledged snapshot to encode against, or null to send everything.
+     * @param baselineSequence The tick of baseline; ignored if baseline is null.
+     * @param packet Receives the packet; it is replaced, not appended to.
+     */
+    void encode(const QuantizedTransforms& current, std::uint32_t sequence, const QuantizedTransforms* baseline,
+                std::uint32_t baselineSequence, std::vector<std::uint8_t>& packet);
+
+    /**
+     * @brief Reads the header of a packet, e.g. to look up its baseline.
+     *
+     * @param data The packet.
+     * @param size The packet size in bytes.
+     * @return The header.
+     * @throws std::runtime_error If the packet is shorter than a header.
+     */
+    static TransformPacketHeader readHeader(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Decodes a packet.
+     *
+     * @param data The packet.
+     * @param size The packet size in bytes.
+     * @param baseline The snapshot named by the header's baselineSequence, or null if it names none.
+     * @param quantized Receives the quantized transforms; store it as the next baseline.
+     * @return The header.
+     * @throws std::runtime_error If the packet is truncated, corrupted or malformed, was
+     *         encoded with other quantization parameters or does not match the baseline.
+     */
+    TransformPacketHeader decode(const std::uint8_t* data, std::size_t size, const QuantizedTransforms* baseline,
+                                 QuantizedTransforms& quantized);
+
+private:
+    TransformQuantization settings;
+    std::uint32_t fingerprint;
+    std::size_t fieldCount;
+    std::vector<std::uint32_t> deltas[QuantizedTransforms::fieldCount];
+    std::vector<std::uint32_t> changedMask;
+    std::vector<std::uint32_t> changed;
+};
+
+// Commonly used types
+using TransformCodecf = TransformCodec<float>;
+
+#include "TransformCodec.inl"
+
+#endif // TRANSFORMCODEC_H
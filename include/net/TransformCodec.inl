@@ -0,0 +1,446 @@
+#ifndef TRANSFORMCODEC_INL
+#define TRANSFORMCODEC_INL
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "../core/BinaryFile.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RENDERFX_TRANSFORM_CODEC_SIMD 2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RENDERFX_TRANSFORM_CODEC_SIMD 1
+#else
+#define RENDERFX_TRANSFORM_CODEC_SIMD 0
+#endif
+
+namespace detail {
+
+constexpr int transformWidthBits = 5;
+constexpr std::size_t transformBlockSize = 32;
+
+inline void storeLittleEndian32(std::uint8_t* out, std::uint32_t value) noexcept {
+    out[0] = static_cast<std::uint8_t>(value);
+    out[1] = static_cast<std::uint8_t>(value >> 8);
+    out[2] = static_cast<std::uint8_t>(value >> 16);
+    out[3] = static_cast<std::uint8_t>(value >> 24);
+}
+
+inline std::uint32_t loadLittleEndian32(const std::uint8_t* in) noexcept {
+    return std::uint32_t(in[0]) | (std::uint32_t(in[1]) << 8) | (std::uint32_t(in[2]) << 16) | (std::uint32_t(in[3]) << 24);
+}
+
+// Checksum of a transform packet, skipping the checksum field at the end of the header.
+inline std::uint32_t transformPacketChecksum(const std::uint8_t* data, std::size_t size, std::size_t headerSize) noexcept {
+    const std::size_t checksumOffset = headerSize - 4;
+    std::uint64_t hash = (checksum64(data, checksumOffset) * 0x9E3779B185EBCA87ull) ^ checksum64(data + headerSize, size - headerSize);
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+inline int bitWidth(std::uint32_t value) noexcept {
+    int width = 0;
+    while (value != 0) {
+        ++width;
+        value >>= 1;
+    }
+    return width;
+}
+
+// Writes values of up to 32 bits LSB first into a buffer sized in advance.
+class BitWriter {
+public:
+    explicit BitWriter(std::uint8_t* out) noexcept : out(out) {}
+
+    void write(std::uint32_t value, int width) noexcept {
+        buffer |= std::uint64_t(value) << bits;
+        bits += width;
+        if (bits >= 32) {
+            storeLittleEndian32(out, static_cast<std::uint32_t>(buffer));
+            out += 4;
+            buffer >>= 32;
+            bits -= 32;
+        }
+    }
+
+    // Writes the remaining bits and returns the end of the data.
+    std::uint8_t* finish() noexcept {
+        for (; bits > 0; bits -= 8, buffer >>= 8) *out++ = static_cast<std::uint8_t>(buffer);
+        return out;
+    }
+
+private:
+    std::uint8_t* out;
+    std::uint64_t buffer = 0;
+    int bits = 0;
+};
+
+// Reads what BitWriter wrote; reading past the end yields zeroes and sets overrun().
+class BitReader {
+public:
+    BitReader(const std::uint8_t* data, const std::uint8_t* end) noexcept : data(data), end(end) {}
+
+    std::uint32_t read(int width) noexcept {
+        while (bits < width) {
+            if (data < end) {
+                buffer |= std::uint64_t(*data++) << bits;
+            } else {
+                overrunBits += 8;
+            }
+            bits += 8;
+        }
+        std::uint32_t value = static_cast<std::uint32_t>(buffer & ((std::uint64_t(1) << width) - 1));
+        buffer >>= width;
+        bits -= width;
+        return value;
+    }
+
+    bool overrun() const noexcept { return overrunBits > bits; }
+
+private:
+    const std::uint8_t* data;
+    const std::uint8_t* end;
+    std::uint64_t buffer = 0;
+    int bits = 0;
+    int overrunBits = 0;
+};
+
+/**
+ * @brief Computes zigzag deltas against a baseline and ORs them into a change mask.
+ *
+ * Entities from baseCount on are compared with zero.
+ */
+inline void zigzagDeltas(const std::uint32_t* current, const std::uint32_t* base, std::size_t baseCount, std::size_t count,
+                         std::uint32_t* deltas, std::uint32_t* changed) noexcept {
+    auto zigzag = [](std::uint32_t difference) {
+        return (difference << 1) ^ static_cast<std::uint32_t>(static_cast<std::int32_t>(difference) >> 31);
+    };
+    std::size_t i = 0;
+#if RENDERFX_TRANSFORM_CODEC_SIMD >= 2
+    for (; i + 8 <= baseCount; i += 8) {
+        __m256i difference = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i)),
+                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + i)));
+        __m256i delta = _mm256_xor_si256(_mm256_slli_epi32(difference, 1), _mm256_srai_epi32(difference, 31));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(deltas + i), delta);
+        __m256i* mask = reinterpret_cast<__m256i*>(changed + i);
+        _mm256_storeu_si256(mask, _mm256_or_si256(_mm256_loadu_si256(mask), delta));
+    }
+#endif
+#if RENDERFX_TRANSFORM_CODEC_SIMD >= 1
+    for (; i + 4 <= baseCount; i += 4) {
+        __m128i difference = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(current + i)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + i)));
+        __m128i delta = _mm_xor_si128(_mm_slli_epi32(difference, 1), _mm_srai_epi32(difference, 31));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(deltas + i), delta);
+        __m128i* mask = reinterpret_cast<__m128i*>(changed + i);
+        _mm_storeu_si128(mask, _mm_or_si128(_mm_loadu_si128(mask), delta));
+    }
+#endif
+    for (; i < baseCount; ++i) {
+        deltas[i] = zigzag(current[i] - base[i]);
+        changed[i] |= deltas[i];
+    }
+    for (; i < count; ++i) {
+        deltas[i] = zigzag(current[i]);
+        changed[i] |= deltas[i];
+    }
+}
+
+/**
+ * @brief ORs the deltas of a block of changed entities, to find the packing width.
+ */
+inline std::uint32_t blockBits(const std::uint32_t* deltas, const std::uint32_t* indices, std::size_t count) noexcept {
+    std::uint32_t bits = 0;
+    for (std::size_t k = 0; k < count; ++k) bits |= deltas[indices[k]];
+    return bits;
+}
+
+inline float quantizationStep(float low, float high, int bits) noexcept {
+    return (high - low) / static_cast<float>((std::uint32_t(1) << bits) - 1);
+}
+
+// Quantizes to [0, 2^bits - 1]; NaN maps to zero.
+inline std::uint32_t quantizeUnit(double value, int bits) noexcept {
+    double top = static_cast<double>((std::uint32_t(1) << bits) - 1);
+    value *= top;
+    value = value > 0 ? (value < top ? value : top) : 0;
+    return static_cast<std::uint32_t>(value + 0.5);
+}
+
+} // namespace detail
+
+inline void QuantizedTransforms::resize(std::size_t count) {
+    for (auto& field : fields) field.resize(count);
+}
+
+inline TransformSnapshotHistory::TransformSnapshotHistory(std::size_t capacity) : entries(capacity) {
+    if (capacity == 0) throw std::invalid_argument("Snapshot history capacity must be positive");
+}
+
+inline QuantizedTransforms& TransformSnapshotHistory::store(std::uint32_t sequence) {
+    Entry& entry = entries[next];
+    next = (next + 1) % entries.size();
+    entry.valid = true;
+    entry.sequence = sequence;
+    return entry.transforms;
+}
+
+inline const QuantizedTransforms* TransformSnapshotHistory::find(std::uint32_t sequence) const noexcept {
+    for (const Entry& entry : entries) {
+        if (entry.valid && entry.sequence == sequence) return &entry.transforms;
+    }
+    return nullptr;
+}
+
+template<typename T>
+TransformCodec<T>::TransformCodec(const TransformQuantization& quantization)
+    : settings(quantization), fingerprint(0), fieldCount(quantization.scale ? 10 : 7) {
+    if (settings.positionBits < 1 || settings.positionBits > 24) throw std::invalid_argument("Position bits must be between 1 and 24");
+    if (settings.rotationBits < 2 || settings.rotationBits > 16) throw std::invalid_argument("Rotation bits must be between 2 and 16");
+    if (settings.scaleBits < 1 || settings.scaleBits > 24) throw std::invalid_argument("Scale bits must be between 1 and 24");
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(settings.bounds.min[axis] < settings.bounds.max[axis]) || !std::isfinite(settings.bounds.max[axis] - settings.bounds.min[axis])) {
+            throw std::invalid_argument("Position bounds must be finite and non-empty");
+        }
+    }
+    if (settings.scale && !(settings.minScale < settings.maxScale && std::isfinite(settings.maxScale - settings.minScale))) {
+        throw std::invalid_argument("Scale range must be finite and non-empty");
+    }
+
+    float ranges[8] = { settings.bounds.min.x, settings.bounds.min.y, settings.bounds.min.z,
+                        settings.bounds.max.x, settings.bounds.max.y, settings.bounds.max.z,
+                        settings.scale ? settings.minScale : 0.0f, settings.scale ? settings.maxScale : 0.0f };
+    std::int32_t bits[4] = { settings.positionBits, settings.rotationBits, settings.scale ? settings.scaleBits : 0,
+                             static_cast<std::int32_t>(fieldCount) };
+    unsigned char bytes[sizeof(ranges) + sizeof(bits)];
+    for (std::size_t i = 0; i < 8; ++i) {
+        std::uint32_t word;
+        std::memcpy(&word, &ranges[i], 4);
+        detail::storeLittleEndian32(bytes + i * 4, word);
+    }
+    for (std::size_t i = 0; i < 4; ++i) detail::storeLittleEndian32(bytes + sizeof(ranges) + i * 4, static_cast<std::uint32_t>(bits[i]));
+    fingerprint = static_cast<std::uint32_t>(detail::checksum64(bytes, sizeof(bytes)));
+}
+
+template<typename T>
+void TransformCodec<T>::quantize(const TransformSoA<T>& transforms, QuantizedTransforms& quantized) const {
+    const std::size_t count = transforms.size();
+    quantized.resize(count);
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        const T* source = transforms.positions.component(axis);
+        std::uint32_t* target = quantized.fields[axis].data();
+        double low = settings.bounds.min[static_cast<int>(axis)];
+        double scale = 1.0 / (static_cast<double>(settings.bounds.max[static_cast<int>(axis)]) - low);
+        for (std::size_t i = 0; i < count; ++i) {
+            target[i] = detail::quantizeUnit((static_cast<double>(source[i]) - low) * scale, settings.positionBits);
+        }
+    }
+
+    const T* r[4] = { transforms.rotations.component(0), transforms.rotations.component(1),
+                      transforms.rotations.component(2), transforms.rotations.component(3) };
+    std::uint32_t* largestIndex = quantized.fields[3].data();
+    std::uint32_t* smallest[3] = { quantized.fields[4].data(), quantized.fields[5].data(), quantized.fields[6].data() };
+    const double toUnit = 0.5 * std::sqrt(2.0);
+    for (std::size_t i = 0; i < count; ++i) {
+        double q[4] = { r[0][i], r[1][i], r[2][i], r[3][i] };
+        int largest = 0;
+        for (int c = 1; c < 4; ++c) {
+            if (std::fabs(q[c]) > std::fabs(q[largest])) largest = c;
+        }
+        // q and -q are the same rotation; send the one with a positive largest component.
+        double sign = q[largest] < 0 ? -1.0 : 1.0;
+        largestIndex[i] = static_cast<std::uint32_t>(largest);
+        for (int c = 0, k = 0; c < 4; ++c) {
+            if (c == largest) continue;
+            smallest[k++][i] = detail::quantizeUnit(sign * q[c] * toUnit + 0.5, settings.rotationBits);
+        }
+    }
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        std::uint32_t* target = quantized.fields[7 + axis].data();
+        if (!settings.scale) {
+            std::fill_n(target, count, 0u);
+            continue;
+        }
+        const T* source = transforms.scales.component(axis);
+        double low = settings.minScale;
+        double scale = 1.0 / (static_cast<double>(settings.maxScale) - low);
+        for (std::size_t i = 0; i < count; ++i) {
+            target[i] = detail::quantizeUnit((static_cast<double>(source[i]) - low) * scale, settings.scaleBits);
+        }
+    }
+}
+
+template<typename T>
+void TransformCodec<T>::dequantize(const QuantizedTransforms& quantized, TransformSoA<T>& transforms) const {
+    const std::size_t count = quantized.size();
+    transforms.resize(count);
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        const std::uint32_t* source = quantized.fields[axis].data();
+        T* target = transforms.positions.component(axis);
+        float low = settings.bounds.min[static_cast<int>(axis)];
+        float step = detail::quantizationStep(low, settings.bounds.max[static_cast<int>(axis)], settings.positionBits);
+        for (std::size_t i = 0; i < count; ++i) target[i] = static_cast<T>(low + static_cast<float>(source[i]) * step);
+    }
+
+    T* r[4] = { transforms.rotations.component(0), transforms.rotations.component(1),
+                transforms.rotations.component(2), transforms.rotations.component(3) };
+    const std::uint32_t* largestIndex = quantized.fields[3].data();
+    const std::uint32_t* smallest[3] = { quantized.fields[4].data(), quantized.fields[5].data(), quantized.fields[6].data() };
+    const T step = T(2) / static_cast<T>((std::uint32_t(1) << settings.rotationBits) - 1);
+    const T fromUnit = static_cast<T>(1.0 / std::sqrt(2.0));
+    for (std::size_t i = 0; i < count; ++i) {
+        int largest = static_cast<int>(largestIndex[i] & 3);
+        T sum = 0;
+        for (int c = 0, k = 0; c < 4; ++c) {
+            if (c == largest) continue;
+            T value = (static_cast<T>(smallest[k++][i]) * step - T(1)) * fromUnit;
+            r[c][i] = value;
+            sum += value * value;
+        }
+        r[largest][i] = std::sqrt(std::max(T(0), T(1) - sum));
+    }
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        T* target = transforms.scales.component(axis);
+        if (!settings.scale) {
+            std::fill_n(target, count, T(1));
+            continue;
+        }
+        const std::uint32_t* source = quantized.fields[7 + axis].data();
+        float step = detail::quantizationStep(settings.minScale, settings.maxScale, settings.scaleBits);
+        for (std::size_t i = 0; i < count; ++i) target[i] = static_cast<T>(settings.minScale + static_cast<float>(source[i]) * step);
+    }
+}
+
+template<typename T>
+void TransformCodec<T>::encode(const QuantizedTransforms& current, std::uint32_t sequence, const QuantizedTransforms* baseline,
+                               std::uint32_t baselineSequence, std::vector<std::uint8_t>& packet) {
+    const std::size_t count = current.size();
+    const std::size_t baseCount = baseline != nullptr ? baseline->size() : 0;
+    if (count > 0xFFFFFFFFu || baseCount > 0xFFFFFFFFu) throw std::length_error("Too many transforms for one packet");
+    for (std::size_t f = 0; f < fieldCount; ++f) {
+        if (current.fields[f].size() != count || (baseline != nullptr && baseline->fields[f].size() != baseCount)) {
+            throw std::invalid_argument("Quantized transform fields have different sizes");
+        }
+    }
+
+    changedMask.assign(count, 0);
+    for (std::size_t f = 0; f < fieldCount; ++f) {
+        deltas[f].resize(count);
+        const std::uint32_t* base = baseline != nullptr ? baseline->fields[f].data() : nullptr;
+        detail::zigzagDeltas(current.fields[f].data(), base, std::min(count, baseCount), count, deltas[f].data(), changedMask.data());
+    }
+    changed.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (changedMask[i] != 0) changed.push_back(static_cast<std::uint32_t>(i));
+    }
+
+    // Worst case: every field of every changed entity at 32 bits plus the block widths.
+    std::size_t maskBytes = (count + 7) / 8;
+    std::size_t blocks = (changed.size() + detail::transformBlockSize - 1) / detail::transformBlockSize;
+    std::size_t payloadBits = changed.size() * fieldCount * 32 + blocks * fieldCount * detail::transformWidthBits;
+    packet.resize(headerSize + maskBytes + (payloadBits + 7) / 8 + 8);
+
+    std::uint8_t* out = packet.data();
+    detail::storeLittleEndian32(out, sequence);
+    detail::storeLittleEndian32(out + 4, baseline != nullptr ? baselineSequence : noBaseline);
+    detail::storeLittleEndian32(out + 8, static_cast<std::uint32_t>(count));
+    detail::storeLittleEndian32(out + 12, static_cast<std::uint32_t>(baseCount));
+    detail::storeLittleEndian32(out + 16, fingerprint);
+    detail::storeLittleEndian32(out + 20, static_cast<std::uint32_t>(changed.size()));
+    out += headerSize;
+
+    std::fill_n(out, maskBytes, std::uint8_t(0));
+    for (std::uint32_t index : changed) out[index >> 3] |= static_cast<std::uint8_t>(1u << (index & 7));
+    out += maskBytes;
+
+    detail::BitWriter writer(out);
+    for (std::size_t first = 0; first < changed.size(); first += detail::transformBlockSize) {
+        const std::uint32_t* indices = changed.data() + first;
+        std::size_t blockCount = std::min(detail::transformBlockSize, changed.size() - first);
+        for (std::size_t f = 0; f < fieldCount; ++f) {
+            const std::uint32_t* fieldDeltas = deltas[f].data();
+            int width = detail::bitWidth(detail::blockBits(fieldDeltas, indices, blockCount));
+            writer.write(static_cast<std::uint32_t>(width), detail::transformWidthBits);
+            if (width == 0) continue;
+            for (std::size_t k = 0; k < blockCount; ++k) writer.write(fieldDeltas[indices[k]], width);
+        }
+    }
+    packet.resize(static_cast<std::size_t>(writer.finish() - packet.data()));
+    detail::storeLittleEndian32(packet.data() + 24, detail::transformPacketChecksum(packet.data(), packet.size(), headerSize));
+}
+
+template<typename T>
+TransformPacketHeader TransformCodec<T>::readHeader(const std::uint8_t* data, std::size_t size) {
+    if (size < headerSize) throw std::runtime_error("Transform packet is truncated");
+    TransformPacketHeader header;
+    header.sequence = detail::loadLittleEndian32(data);
+    header.baselineSequence = detail::loadLittleEndian32(data + 4);
+    header.entityCount = detail::loadLittleEndian32(data + 8);
+    header.baselineCount = detail::loadLittleEndian32(data + 12);
+    header.fingerprint = detail::loadLittleEndian32(data + 16);
+    header.changedCount = detail::loadLittleEndian32(data + 20);
+    header.checksum = detail::loadLittleEndian32(data + 24);
+    return header;
+}
+
+template<typename T>
+TransformPacketHeader TransformCodec<T>::decode(const std::uint8_t* data, std::size_t size, const QuantizedTransforms* baseline,
+                                                QuantizedTransforms& quantized) {
+    TransformPacketHeader header = readHeader(data, size);
+    if (header.checksum != detail::transformPacketChecksum(data, size, headerSize)) {
+        throw std::runtime_error("Transform packet is truncated or corrupted");
+    }
+    if (header.fingerprint != fingerprint) throw std::runtime_error("Transform packet uses other quantization parameters");
+    if (header.baselineSequence == noBaseline) {
+        baseline = nullptr;
+        if (header.baselineCount != 0) throw std::runtime_error("Transform packet is malformed");
+    } else if (baseline == nullptr || baseline->size() != header.baselineCount) {
+        throw std::runtime_error("Transform packet does not match its baseline");
+    }
+
+    const std::size_t count = header.entityCount;
+    const std::size_t maskBytes = (count + 7) / 8;
+    if (size - headerSize < maskBytes) throw std::runtime_error("Transform packet is truncated");
+    const std::size_t baseCount = std::min<std::size_t>(count, header.baselineCount);
+
+    quantized.resize(count);
+    for (std::size_t f = 0; f < QuantizedTransforms::fieldCount; ++f) {
+        std::uint32_t* target = quantized.fields[f].data();
+        if (baseline != nullptr && f < fieldCount) std::copy_n(baseline->fields[f].data(), baseCount, target);
+        std::fill(target + (baseline != nullptr && f < fieldCount ? baseCount : 0), target + count, 0u);
+    }
+
+    const std::uint8_t* mask = data + headerSize;
+    changed.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (mask[i >> 3] & (1u << (i & 7))) changed.push_back(static_cast<std::uint32_t>(i));
+    }
+    if (changed.size() != header.changedCount) throw std::runtime_error("Transform packet is malformed");
+
+    detail::BitReader reader(mask + maskBytes, data + size);
+    for (std::size_t first = 0; first < changed.size(); first += detail::transformBlockSize) {
+        const std::uint32_t* indices = changed.data() + first;
+        std::size_t blockCount = std::min(detail::transformBlockSize, changed.size() - first);
+        for (std::size_t f = 0; f < fieldCount; ++f) {
+            std::uint32_t* target = quantized.fields[f].data();
+            int width = static_cast<int>(reader.read(detail::transformWidthBits));
+            if (width == 0) continue;
+            for (std::size_t k = 0; k < blockCount; ++k) {
+                std::uint32_t delta = reader.read(width);
+                target[indices[k]] += (delta >> 1) ^ (0u - (delta & 1));
+            }
+        }
+        if (reader.overrun()) throw std::runtime_error("Transform packet is truncated");
+    }
+    return header;
+}
+
+#undef RENDERFX_TRANSFORM_CODEC_SIMD
+
+#endif // TRANSFORMCODEC_INL
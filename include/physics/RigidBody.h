@@ -0,0 +1,176 @@
+#ifndef RIGIDBODY_H
+#define RIGIDBODY_H
+
+#include <cstddef>
+#include <type_traits>
+#include "../core/ThreadPool.h"
+#include "../math/Quaternion.h"
+#include "../math/Vector3.h"
+#include "../math/VectorArray.h"
+
+/**
+ * @brief The state of one rigid body, for building and inspecting a RigidBodySoA.
+ *
+ * @tparam T Type of the components.
+ */
+template<typename T>
+struct RigidBody {
+    Vector3<T> position;
+    Quaternion<T> orientation;
+    Vector3<T> linearVelocity;
+    Vector3<T> angularVelocity;   ///< In world space, radians per second.
+    T inverseMass = T(0);         ///< Zero for static bodies.
+    Vector3<T> inverseInertia;    ///< The inverse principal moments of inertia, in body space.
+};
+
+/**
+ * @brief Structure-of-arrays storage for rigid bodies.
+ *
+ * Each quantity is kept in VectorArray component streams, so the
+ * integrator runs over SIMD lanes (see FloatLanes.h). Inertia is given as
+ * inverse principal moments in body space; the world-space inverse inertia
+ * tensor, R diag(inverseInertia) R^T, is derived from the orientation and
+ * kept up to date by set() and RigidBodyIntegrator. Forces and torques
+ * accumulate between steps and are cleared by each step.
+ *
+ * @tparam T Type of the components.
+ */
+template<typename T>
+class RigidBodySoA {
+public:
+    VectorArray<T, 3> positions;            ///< Centers of mass.
+    VectorArray<T, 4> orientations;         ///< Quaternion components in (x, y, z, w) order.
+    VectorArray<T, 3> linearVelocities;
+    VectorArray<T, 3> angularVelocities;    ///< In world space.
+    VectorArray<T, 3> forces;               ///< Accumulated forces, in world space.
+    VectorArray<T, 3> torques;              ///< Accumulated torques about the center of mass, in world space.
+    VectorArray<T, 1> inverseMasses;
+    VectorArray<T, 3> inverseInertias;      ///< Inverse principal moments of inertia, in body space.
+    VectorArray<T, 6> worldInverseInertias; ///< Symmetric tensors as (xx, yy, zz, xy, xz, yz); derived.
+
+    /**
+     * @brief Gets the number of bodies.
+     *
+     * @return The number of bodies.
+     */
+    std::size_t size() const noexcept { return positions.size(); }
+
+    bool empty() const noexcept { return positions.empty(); }
+
+    /**
+     * @brief Resizes the arrays; new bodies are static, at rest at the origin.
+     *
+     * @param count The new number of bodies.
+     */
+    void resize(std::size_t count);
+
+    void reserve(std::size_t capacity);
+
+    void clear() noexcept;
+
+    /**
+     * @brief Appends a body with no accumulated force or torque.
+     *
+     * @param body The body.
+     */
+    void push_back(const RigidBody<T>& body);
+
+    /**
+     * @brief Gathers one body.
+     *
+     * @param index Index of the body.
+     * @return The body.
+     */
+    RigidBody<T> get(std::size_t index) const;
+
+    /**
+     * @brief Scatters one body and updates its world inverse inertia.
+     *
+     * @param index Index of the body.
+     * @param body The new state; the orientation is normalized.
+     */
+    void set(std::size_t index, const RigidBody<T>& body);
+
+    /**
+     * @brief Adds a force through the center of mass of a body.
+     *
+     * @param index Index of the body.
+     * @param force The force, in world space.
+     */
+    void applyForce(std::size_t index, const Vector3<T>& force);
+
+    /**
+     * @brief Adds a force at a point, which also produces a torque.
+     *
+     * @param index Index of the body.
+     * @param force The force, in world space.
+     * @param point Where the force acts, in world space.
+     */
+    void applyForce(std::size_t index, const Vector3<T>& force, const Vector3<T>& point);
+
+    /**
+     * @brief Recomputes the world inverse inertia tensors from the orientations.
+     *
+     * Call after changing orientations or inverse inertias directly.
+     *
+     * @param first The first body.
+     * @param last One past the last body; at most size().
+     */
+    void updateWorldInertia(std::size_t first, std::size_t last);
+};
+
+/**
+ * @brief Advances rigid bodies with semi-implicit (symplectic) Euler.
+ *
+ * Each step first updates the velocities from the accumulated forces,
+ * torques and gravity, then moves the bodies with the new velocities:
+ *
+ *     v += (g + F / m) dt            w += I_world^-1 tau dt
+ *     x += v dt                      q += dt / 2 (w, 0) q, renormalized
+ *
+ * and finally rebuilds the world inverse inertia tensors from the new
+ * orientations through their 3x3 rotation matrices. Gyroscopic torque is
+ * not modeled. Bodies with zero inverse mass are static: they ignore
+ * forces, torques and gravity, their velocities are set to zero and they
+ * keep their positions and orientations.
+ *
+ * Bodies are spread over SIMD lanes and threads in fixed-size chunks, so
+ * the results do not depend on the number of threads.
+ *
+ * @tparam T Type of the components.
+ */
+template<typename T>
+class RigidBodyIntegrator {
+public:
+    static_assert(std::is_floating_point<T>::value, "RigidBodyIntegrator requires a floating-point type");
+
+    /**
+     * @brief Advances every body by one step and clears the forces and torques.
+     *
+     * @param bodies The bodies.
+     * @param dt The step, in seconds.
+     * @param gravity The acceleration of gravity.
+     * @param pool Threads to spread the bodies over; the calling thread does all the work if null.
+     */
+    static void integrate(RigidBodySoA<T>& bodies, T dt, const Vector3<T>& gravity, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Advances a range of bodies by one step, for callers that schedule their own work.
+     *
+     * @param bodies The bodies.
+     * @param dt The step, in seconds.
+     * @param gravity The acceleration of gravity.
+     * @param first The first body.
+     * @param last One past the last body; at most bodies.size().
+     */
+    static void integrate(RigidBodySoA<T>& bodies, T dt, const Vector3<T>& gravity, std::size_t first, std::size_t last);
+};
+
+// Commonly used types
+using RigidBodyf = RigidBody<float>;
+using RigidBodySoAf = RigidBodySoA<float>;
+using RigidBodyIntegratorf = RigidBodyIntegrator<float>;
+
+#include "RigidBody.inl"
+
+#endif // RIGIDBODY_H
@@ -0,0 +1,221 @@
+#ifndef RIGIDBODY_INL
+#define RIGIDBODY_INL
+
+#include "../math/FloatLanes.h"
+
+template<typename T>
+void RigidBodySoA<T>::resize(std::size_t count) {
+    std::size_t old = size();
+    positions.resize(count);
+    orientations.resize(count);
+    linearVelocities.resize(count);
+    angularVelocities.resize(count);
+    forces.resize(count);
+    torques.resize(count);
+    inverseMasses.resize(count);
+    inverseInertias.resize(count);
+    worldInverseInertias.resize(count);
+    for (std::size_t i = old; i < count; ++i) orientations.component(3)[i] = T(1);
+}
+
+template<typename T>
+void RigidBodySoA<T>::reserve(std::size_t capacity) {
+    positions.reserve(capacity);
+    orientations.reserve(capacity);
+    linearVelocities.reserve(capacity);
+    angularVelocities.reserve(capacity);
+    forces.reserve(capacity);
+    torques.reserve(capacity);
+    inverseMasses.reserve(capacity);
+    inverseInertias.reserve(capacity);
+    worldInverseInertias.reserve(capacity);
+}
+
+template<typename T>
+void RigidBodySoA<T>::clear() noexcept {
+    positions.clear();
+    orientations.clear();
+    linearVelocities.clear();
+    angularVelocities.clear();
+    forces.clear();
+    torques.clear();
+    inverseMasses.clear();
+    inverseInertias.clear();
+    worldInverseInertias.clear();
+}
+
+template<typename T>
+void RigidBodySoA<T>::push_back(const RigidBody<T>& body) {
+    resize(size() + 1);
+    set(size() - 1, body);
+}
+
+template<typename T>
+RigidBody<T> RigidBodySoA<T>::get(std::size_t index) const {
+    Vector<T, 4> q = orientations.get(index);
+    RigidBody<T> body;
+    body.position = positions.get(index).toVector3();
+    body.orientation = Quaternion<T>(q.w, q.x, q.y, q.z);
+    body.linearVelocity = linearVelocities.get(index).toVector3();
+    body.angularVelocity = angularVelocities.get(index).toVector3();
+    body.inverseMass = inverseMasses.component(0)[index];
+    body.inverseInertia = inverseInertias.get(index).toVector3();
+    return body;
+}
+
+template<typename T>
+void RigidBodySoA<T>::set(std::size_t index, const RigidBody<T>& body) {
+    Quaternion<T> q = body.orientation.normalized();
+    positions.set(index, Vector<T, 3>(body.position));
+    orientations.set(index, Vector<T, 4>(q.x, q.y, q.z, q.w));
+    linearVelocities.set(index, Vector<T, 3>(body.linearVelocity));
+    angularVelocities.set(index, Vector<T, 3>(body.angularVelocity));
+    inverseMasses.component(0)[index] = body.inverseMass;
+    inverseInertias.set(index, Vector<T, 3>(body.inverseInertia));
+    updateWorldInertia(index, index + 1);
+}
+
+template<typename T>
+void RigidBodySoA<T>::applyForce(std::size_t index, const Vector3<T>& force) {
+    for (std::size_t c = 0; c < 3; ++c) forces.component(c)[index] += force[c];
+}
+
+template<typename T>
+void RigidBodySoA<T>::applyForce(std::size_t index, const Vector3<T>& force, const Vector3<T>& point) {
+    applyForce(index, force);
+    Vector3<T> torque = (point - positions.get(index).toVector3()).cross(force);
+    for (std::size_t c = 0; c < 3; ++c) torques.component(c)[index] += torque[c];
+}
+
+namespace detail {
+
+// World inverse inertia R diag(d) R^T of unit quaternion lanes (x, y, z, w),
+// as (xx, yy, zz, xy, xz, yz).
+template<typename L, typename V, typename T>
+inline void worldInverseInertiaLanes(const V q[4], const V d[3], V out[6], T one) noexcept {
+    V x2 = L::add(q[0], q[0]), y2 = L::add(q[1], q[1]), z2 = L::add(q[2], q[2]);
+    V xx = L::mul(q[0], x2), yy = L::mul(q[1], y2), zz = L::mul(q[2], z2);
+    V xy = L::mul(q[0], y2), xz = L::mul(q[0], z2), yz = L::mul(q[1], z2);
+    V wx = L::mul(q[3], x2), wy = L::mul(q[3], y2), wz = L::mul(q[3], z2);
+    V r[3][3] = {
+        {L::sub(L::set(one), L::add(yy, zz)), L::sub(xy, wz), L::add(xz, wy)},
+        {L::add(xy, wz), L::sub(L::set(one), L::add(xx, zz)), L::sub(yz, wx)},
+        {L::sub(xz, wy), L::add(yz, wx), L::sub(L::set(one), L::add(xx, yy))}};
+    // Entry (i, j) is the sum over k of R_ik d_k R_jk.
+    V scaled[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < 3; ++k) scaled[i][k] = L::mul(r[i][k], d[k]);
+    }
+    auto entry = [&](int i, int j) {
+        return L::add(L::add(L::mul(scaled[i][0], r[j][0]), L::mul(scaled[i][1], r[j][1])), L::mul(scaled[i][2], r[j][2]));
+    };
+    out[0] = entry(0, 0);
+    out[1] = entry(1, 1);
+    out[2] = entry(2, 2);
+    out[3] = entry(0, 1);
+    out[4] = entry(0, 2);
+    out[5] = entry(1, 2);
+}
+
+template<typename L, typename T>
+inline void updateWorldInertiaLanes(RigidBodySoA<T>& bodies, std::size_t i) noexcept {
+    using V = decltype(L::set(T(0)));
+    V q[4], d[3], tensor[6];
+    for (std::size_t c = 0; c < 4; ++c) q[c] = L::load(bodies.orientations.component(c) + i);
+    for (std::size_t c = 0; c < 3; ++c) d[c] = L::load(bodies.inverseInertias.component(c) + i);
+    worldInverseInertiaLanes<L>(q, d, tensor, T(1));
+    for (std::size_t c = 0; c < 6; ++c) L::store(bodies.worldInverseInertias.component(c) + i, tensor[c]);
+}
+
+// One semi-implicit Euler step for the bodies in the lanes starting at i.
+template<typename L, typename T>
+inline void integrateBodyLanes(RigidBodySoA<T>& bodies, std::size_t i, T dt, const Vector3<T>& gravity) noexcept {
+    using V = decltype(L::set(T(0)));
+    const V step = L::set(dt);
+    const V zero = L::set(T(0));
+
+    // Velocities first, from the forces of this step. Static bodies, with
+    // zero inverse mass, keep zero velocities and so do not move.
+    V inverseMass = L::load(bodies.inverseMasses.component(0) + i);
+    auto dynamic = L::greater(inverseMass, zero);
+    V velocity[3];
+    for (std::size_t c = 0; c < 3; ++c) {
+        V acceleration = L::add(L::select(dynamic, L::set(gravity[c]), zero),
+                                L::mul(L::load(bodies.forces.component(c) + i), inverseMass));
+        velocity[c] = L::select(dynamic, L::add(L::load(bodies.linearVelocities.component(c) + i), L::mul(acceleration, step)), zero);
+    }
+    V tensor[6], torque[3], omega[3];
+    for (std::size_t c = 0; c < 6; ++c) tensor[c] = L::load(bodies.worldInverseInertias.component(c) + i);
+    for (std::size_t c = 0; c < 3; ++c) torque[c] = L::load(bodies.torques.component(c) + i);
+    const int row[3][3] = {{0, 3, 4}, {3, 1, 5}, {4, 5, 2}};
+    for (int c = 0; c < 3; ++c) {
+        V angular = L::add(L::add(L::mul(tensor[row[c][0]], torque[0]), L::mul(tensor[row[c][1]], torque[1])),
+                           L::mul(tensor[row[c][2]], torque[2]));
+        omega[c] = L::select(dynamic, L::add(L::load(bodies.angularVelocities.component(c) + i), L::mul(angular, step)), zero);
+    }
+
+    // Then positions and orientations, with the new velocities.
+    for (std::size_t c = 0; c < 3; ++c) {
+        T* position = bodies.positions.component(c) + i;
+        L::store(position, L::add(L::load(position), L::mul(velocity[c], step)));
+        L::store(bodies.linearVelocities.component(c) + i, velocity[c]);
+        L::store(bodies.angularVelocities.component(c) + i, omega[c]);
+        L::store(bodies.forces.component(c) + i, zero);
+        L::store(bodies.torques.component(c) + i, zero);
+    }
+    V q[4];
+    for (std::size_t c = 0; c < 4; ++c) q[c] = L::load(bodies.orientations.component(c) + i);
+    // dq/dt = (w, 0) q / 2, with w as a pure quaternion.
+    V half = L::mul(step, L::set(T(0.5)));
+    V dq[4] = {
+        L::add(L::mul(omega[0], q[3]), L::sub(L::mul(omega[1], q[2]), L::mul(omega[2], q[1]))),
+        L::add(L::mul(omega[1], q[3]), L::sub(L::mul(omega[2], q[0]), L::mul(omega[0], q[2]))),
+        L::add(L::mul(omega[2], q[3]), L::sub(L::mul(omega[0], q[1]), L::mul(omega[1], q[0]))),
+        L::sub(zero, L::add(L::add(L::mul(omega[0], q[0]), L::mul(omega[1], q[1])), L::mul(omega[2], q[2])))};
+    for (int c = 0; c < 4; ++c) q[c] = L::add(q[c], L::mul(dq[c], half));
+    V inverseLength = L::rsqrt(L::add(L::add(L::mul(q[0], q[0]), L::mul(q[1], q[1])), L::add(L::mul(q[2], q[2]), L::mul(q[3], q[3]))));
+    for (std::size_t c = 0; c < 4; ++c) {
+        // Renormalizing would still round the orientations of static bodies.
+        q[c] = L::select(dynamic, L::mul(q[c], inverseLength), q[c]);
+        L::store(bodies.orientations.component(c) + i, q[c]);
+    }
+
+    V d[3];
+    for (std::size_t c = 0; c < 3; ++c) d[c] = L::load(bodies.inverseInertias.component(c) + i);
+    worldInverseInertiaLanes<L>(q, d, tensor, T(1));
+    for (std::size_t c = 0; c < 6; ++c) L::store(bodies.worldInverseInertias.component(c) + i, tensor[c]);
+}
+
+} // namespace detail
+
+template<typename T>
+void RigidBodySoA<T>::updateWorldInertia(std::size_t first, std::size_t last) {
+    detail::forEachLane<T>(first, last, [&](auto lanes, std::size_t i) {
+        detail::updateWorldInertiaLanes<decltype(lanes)>(*this, i);
+    });
+}
+
+template<typename T>
+void RigidBodyIntegrator<T>::integrate(RigidBodySoA<T>& bodies, T dt, const Vector3<T>& gravity, std::size_t first,
+                                       std::size_t last) {
+    detail::forEachLane<T>(first, last, [&](auto lanes, std::size_t i) {
+        detail::integrateBodyLanes<decltype(lanes)>(bodies, i, dt, gravity);
+    });
+    RENDERFX_CHECK_FINITE_BATCH("RigidBodyIntegrator::integrate", bodies.orientations.component(3) + first,
+                                bodies.orientations.component(3) + last);
+}
+
+template<typename T>
+void RigidBodyIntegrator<T>::integrate(RigidBodySoA<T>& bodies, T dt, const Vector3<T>& gravity, ThreadPool* pool) {
+    const std::size_t count = bodies.size();
+    // Chunks are fixed-size and lane-aligned, so every body takes the same
+    // path through the lanes however many threads run them.
+    auto run = [&](std::size_t first, std::size_t last) { integrate(bodies, dt, gravity, first, last); };
+    if (pool) {
+        pool->parallelFor(0, count, 4096, run);
+    } else {
+        run(0, count);
+    }
+}
+
+#endif // RIGIDBODY_INL
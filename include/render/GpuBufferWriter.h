@@ -0,0 +1,290 @@
+#ifndef GPUBUFFERWRITER_H
+#define GPUBUFFERWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "../math/Geometry.h"
+#include "../math/Matrix4x4.h"
+#include "../math/MatrixMxN.h"
+#include "../math/Quaternion.h"
+#include "../math/Vector3.h"
+#include "../math/VectorN.h"
+
+/**
+ * @file GpuBufferWriter.h
+ * @brief Packing of math types into uniform and storage buffers.
+ *
+ * The math types store matrices row by row; shaders read them column by
+ * column with std140 or std430 padding. The types and the writer here
+ * produce the shader layout directly in mapped buffer memory:
+ *
+ * | C++ type               | GLSL type | Size | Notes                                  |
+ * |------------------------|-----------|------|----------------------------------------|
+ * | Matrix4x4              | mat4      | 64   | column-major                           |
+ * | Matrix3x3              | mat3      | 48   | three columns padded to vec4           |
+ * | Matrix3x4 / Transform  | mat3x4    | 48   | rows of the affine transform; `p * m`  |
+ * | Vector3                | vec4      | 16   | w = 0 (directions) or 1 (points)       |
+ * | Vector4, Quaternion    | vec4      | 16   | quaternions as (x, y, z, w)            |
+ * | float                  | float     | 4/16 | array stride 16 in std140, 4 in std430 |
+ *
+ * All values are converted to float. Sizes and strides of the vec4-based
+ * types are the same in both layouts.
+ */
+
+/**
+ * @brief The buffer layout rules of a GLSL block.
+ */
+enum class BufferLayout {
+    Std140, ///< Uniform buffers; array strides are rounded up to 16 bytes.
+    Std430  ///< Storage buffers; scalar and vec2 arrays are tightly packed.
+};
+
+/**
+ * @brief A GLSL vec4.
+ */
+struct alignas(16) GpuVec4 {
+    float x = 0, y = 0, z = 0, w = 0;
+
+    /**
+     * @brief Converts a Vector3.
+     *
+     * @param v The vector.
+     * @param w The fourth component; 1 for points, 0 for directions.
+     * @return The vec4.
+     */
+    template<typename T>
+    static constexpr GpuVec4 from(const Vector3<T>& v, float w) noexcept;
+
+    template<typename T>
+    static constexpr GpuVec4 from(const Vector<T, 4>& v) noexcept;
+
+    /**
+     * @brief Converts a quaternion to (x, y, z, w).
+     *
+     * @param q The quaternion.
+     * @return The vec4.
+     */
+    template<typename T>
+    static constexpr GpuVec4 from(const Quaternion<T>& q) noexcept;
+};
+
+/**
+ * @brief A GLSL mat4: four columns.
+ */
+struct alignas(16) GpuMat4 {
+    GpuVec4 columns[4];
+
+    /**
+     * @brief Converts a row-major Matrix4x4.
+     *
+     * @param m The matrix.
+     * @return The column-major matrix.
+     */
+    template<typename T>
+    static constexpr GpuMat4 from(const Matrix4x4<T>& m) noexcept;
+};
+
+/**
+ * @brief A GLSL mat3: three columns, each padded to a vec4.
+ */
+struct alignas(16) GpuMat3 {
+    GpuVec4 columns[3];
+
+    /**
+     * @brief Converts a row-major Matrix3x3.
+     *
+     * @param m The matrix.
+     * @return The column-major matrix.
+     */
+    template<typename T>
+    static constexpr GpuMat3 from(const Matrix<T, 3, 3>& m) noexcept;
+};
+
+/**
+ * @brief An affine transform read by the shader as a mat3x4.
+ *
+ * The three vec4 are the rows of the transform; as a column-major mat3x4
+ * they form its transpose, so the shader applies it as `vec4(p, 1) * m`.
+ */
+struct alignas(16) GpuAffine3x4 {
+    GpuVec4 rows[3];
+
+    /**
+     * @brief Takes the affine part of a Matrix4x4.
+     *
+     * @param m The matrix; its last row is ignored.
+     * @return The affine transform.
+     */
+    template<typename T>
+    static constexpr GpuAffine3x4 from(const Matrix4x4<T>& m) noexcept;
+
+    /**
+     * @brief Converts a Matrix3x4.
+     *
+     * @param m The matrix.
+     * @return The affine transform.
+     */
+    template<typename T>
+    static constexpr GpuAffine3x4 from(const Matrix<T, 3, 4>& m) noexcept;
+
+    /**
+     * @brief Converts a transform without building a 4x4 matrix.
+     *
+     * @param t The transform.
+     * @return The affine transform: translation * rotation * scale.
+     */
+    template<typename T>
+    static constexpr GpuAffine3x4 from(const Transform<T>& t) noexcept;
+};
+
+static_assert(sizeof(GpuVec4) == 16, "GpuVec4 must match the size of a GLSL vec4");
+static_assert(sizeof(GpuMat4) == 64, "GpuMat4 must match the size of a GLSL mat4");
+static_assert(sizeof(GpuMat3) == 48, "GpuMat3 must match the size of a GLSL mat3");
+static_assert(sizeof(GpuAffine3x4) == 48, "GpuAffine3x4 must match the size of a GLSL mat3x4");
+
+/**
+ * @brief Writes arrays of math types into mapped buffer memory in GLSL layout.
+ *
+ * The writer converts each element while storing it, with no staging copy.
+ * Each write starts at the current offset, rounded up to the array's base
+ * alignment, and returns that offset so it can be passed to the shader.
+ * Arrays of at least streamingThreshold() bytes are written with
+ * non-temporal stores where available, which bypass the cache; mapped
+ * memory is usually write-combined and the data is not read back by the CPU.
+ */
+class GpuBufferWriter {
+public:
+    /// Arrays from this size on are written with streaming stores by default.
+    static constexpr std::size_t defaultStreamingThreshold = 256 * 1024;
+
+    /**
+     * @brief Creates a writer for a memory range.
+     *
+     * @param memory Start of the mapped memory; should be 16-byte aligned.
+     * @param capacity Size of the range in bytes.
+     * @param layout The layout rules of the block being written.
+     * @param streamingThreshold Minimum array size in bytes for streaming stores.
+     * @throws std::invalid_argument If memory is null and capacity is not zero.
+     */
+    GpuBufferWriter(void* memory, std::size_t capacity, BufferLayout layout = BufferLayout::Std430,
+                    std::size_t streamingThreshold = defaultStreamingThreshold);
+
+    /// @name Position
+    /// @{
+
+    /**
+     * @brief Gets the offset of the next write.
+     *
+     * @return The offset in bytes.
+     */
+    std::size_t offset() const noexcept { return position; }
+
+    /**
+     * @brief Gets the size of the memory range.
+     *
+     * @return The capacity in bytes.
+     */
+    std::size_t capacity() const noexcept { return size; }
+
+    /**
+     * @brief Gets the layout rules.
+     *
+     * @return The layout.
+     */
+    BufferLayout layout() const noexcept { return rules; }
+
+    /**
+     * @brief Gets the streaming threshold.
+     *
+     * @return The minimum array size in bytes for streaming stores.
+     */
+    std::size_t streamingThreshold() const noexcept { return threshold; }
+
+    /**
+     * @brief Moves the write position.
+     *
+     * @param offset The new offset in bytes.
+     * @throws std::out_of_range If offset is past the end of the range.
+     */
+    void seek(std::size_t offset);
+
+    /**
+     * @brief Rounds the write position up to a multiple of an alignment.
+     *
+     * @param alignment The alignment in bytes; a power of two.
+     * @return The aligned offset.
+     */
+    std::size_t align(std::size_t alignment);
+
+    /// @}
+
+    /// @name Array Writes
+    /// Each function returns the offset of the first element.
+    /// @{
+
+    template<typename T>
+    std::size_t writeMatrices(const Matrix4x4<T>* matrices, std::size_t count);
+
+    template<typename T>
+    std::size_t writeMatrices(const Matrix<T, 3, 3>* matrices, std::size_t count);
+
+    /**
+     * @brief Writes the affine part of 4x4 matrices as GpuAffine3x4.
+     */
+    template<typename T>
+    std::size_t writeAffineTransforms(const Matrix4x4<T>* matrices, std::size_t count);
+
+    template<typename T>
+    std::size_t writeAffineTransforms(const Matrix<T, 3, 4>* matrices, std::size_t count);
+
+    /**
+     * @brief Writes transforms as GpuAffine3x4 without building 4x4 matrices.
+     */
+    template<typename T>
+    std::size_t writeAffineTransforms(const Transform<T>* transforms, std::size_t count);
+
+    /**
+     * @brief Writes vectors as vec4.
+     *
+     * @param w The fourth component; 1 for points, 0 for directions.
+     */
+    template<typename T>
+    std::size_t writeVectors(const Vector3<T>* vectors, std::size_t count, float w = 0.0f);
+
+    template<typename T>
+    std::size_t writeVectors(const Vector<T, 4>* vectors, std::size_t count);
+
+    /**
+     * @brief Writes quaternions as vec4 (x, y, z, w).
+     */
+    template<typename T>
+    std::size_t writeQuaternions(const Quaternion<T>* quaternions, std::size_t count);
+
+    /**
+     * @brief Writes a float array with a stride of 16 bytes in std140 and 4 in std430.
+     */
+    template<typename T>
+    std::size_t writeScalars(const T* values, std::size_t count);
+
+    /// @}
+
+private:
+    unsigned char* memory;
+    std::size_t size;
+    std::size_t position = 0;
+    BufferLayout rules;
+    std::size_t threshold;
+
+    // Reserves count elements of stride bytes at the given alignment.
+    unsigned char* reserve(std::size_t alignment, std::size_t stride, std::size_t count, std::size_t& start);
+
+    // Writes count elements of type Gpu, the vec4-based layout types above;
+    // convert(i) returns element i.
+    template<typename Gpu, typename Convert>
+    std::size_t writeArray(std::size_t count, Convert&& convert);
+};
+
+#include "GpuBufferWriter.inl"
+
+#endif // GPUBUFFERWRITER_H
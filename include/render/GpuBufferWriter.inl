@@ -0,0 +1,214 @@
+#ifndef GPUBUFFERWRITER_INL
+#define GPUBUFFERWRITER_INL
+
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RENDERFX_HAS_STREAMING_STORES 1
+#else
+#define RENDERFX_HAS_STREAMING_STORES 0
+#endif
+
+namespace detail {
+
+inline void storeVec4(unsigned char* destination, const GpuVec4& v, bool streaming) {
+#if RENDERFX_HAS_STREAMING_STORES
+    if (streaming) {
+        _mm_stream_ps(reinterpret_cast<float*>(destination), _mm_load_ps(&v.x));
+        return;
+    }
+#else
+    (void)streaming;
+#endif
+    std::memcpy(destination, &v, sizeof(v));
+}
+
+inline void finishStreaming(bool streaming) {
+#if RENDERFX_HAS_STREAMING_STORES
+    // Non-temporal stores are weakly ordered; fence before the buffer is handed to the GPU.
+    if (streaming) _mm_sfence();
+#else
+    (void)streaming;
+#endif
+}
+
+template<typename T>
+constexpr void setVec4(GpuVec4& out, T x, T y, T z, T w) noexcept {
+    out.x = static_cast<float>(x);
+    out.y = static_cast<float>(y);
+    out.z = static_cast<float>(z);
+    out.w = static_cast<float>(w);
+}
+
+// The vec4s of each layout type, in memory order.
+inline const GpuVec4* gpuVec4s(const GpuVec4& v) noexcept { return &v; }
+inline const GpuVec4* gpuVec4s(const GpuMat4& m) noexcept { return m.columns; }
+inline const GpuVec4* gpuVec4s(const GpuMat3& m) noexcept { return m.columns; }
+inline const GpuVec4* gpuVec4s(const GpuAffine3x4& m) noexcept { return m.rows; }
+
+} // namespace detail
+
+template<typename T>
+constexpr GpuVec4 GpuVec4::from(const Vector3<T>& v, float w) noexcept {
+    GpuVec4 result;
+    detail::setVec4(result, static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z), w);
+    return result;
+}
+
+template<typename T>
+constexpr GpuVec4 GpuVec4::from(const Vector<T, 4>& v) noexcept {
+    GpuVec4 result;
+    detail::setVec4(result, v.x, v.y, v.z, v.w);
+    return result;
+}
+
+template<typename T>
+constexpr GpuVec4 GpuVec4::from(const Quaternion<T>& q) noexcept {
+    GpuVec4 result;
+    detail::setVec4(result, q.x, q.y, q.z, q.w);
+    return result;
+}
+
+template<typename T>
+constexpr GpuMat4 GpuMat4::from(const Matrix4x4<T>& m) noexcept {
+    GpuMat4 result;
+    for (int c = 0; c < 4; ++c) detail::setVec4(result.columns[c], m.data[0][c], m.data[1][c], m.data[2][c], m.data[3][c]);
+    return result;
+}
+
+template<typename T>
+constexpr GpuMat3 GpuMat3::from(const Matrix<T, 3, 3>& m) noexcept {
+    GpuMat3 result;
+    for (int c = 0; c < 3; ++c) detail::setVec4(result.columns[c], m.data[0][c], m.data[1][c], m.data[2][c], T(0));
+    return result;
+}
+
+template<typename T>
+constexpr GpuAffine3x4 GpuAffine3x4::from(const Matrix4x4<T>& m) noexcept {
+    GpuAffine3x4 result;
+    for (int r = 0; r < 3; ++r) detail::setVec4(result.rows[r], m.data[r][0], m.data[r][1], m.data[r][2], m.data[r][3]);
+    return result;
+}
+
+template<typename T>
+constexpr GpuAffine3x4 GpuAffine3x4::from(const Matrix<T, 3, 4>& m) noexcept {
+    GpuAffine3x4 result;
+    for (int r = 0; r < 3; ++r) detail::setVec4(result.rows[r], m.data[r][0], m.data[r][1], m.data[r][2], m.data[r][3]);
+    return result;
+}
+
+template<typename T>
+constexpr GpuAffine3x4 GpuAffine3x4::from(const Transform<T>& t) noexcept {
+    // Translation * rotation * scale: the rotation columns scaled per axis.
+    Matrix<T, 3, 3> rotation = Matrix<T, 3, 3>::fromQuaternion(t.rotation);
+    GpuAffine3x4 result;
+    for (int r = 0; r < 3; ++r) {
+        detail::setVec4(result.rows[r], rotation.data[r][0] * t.scale.x, rotation.data[r][1] * t.scale.y,
+                        rotation.data[r][2] * t.scale.z, t.position[r]);
+    }
+    return result;
+}
+
+inline GpuBufferWriter::GpuBufferWriter(void* memory, std::size_t capacity, BufferLayout layout, std::size_t streamingThreshold)
+    : memory(static_cast<unsigned char*>(memory)), size(capacity), rules(layout), threshold(streamingThreshold) {
+    if (memory == nullptr && capacity != 0) {
+        throw std::invalid_argument("GpuBufferWriter needs memory for a non-empty range");
+    }
+}
+
+inline void GpuBufferWriter::seek(std::size_t offset) {
+    if (offset > size) throw std::out_of_range("GpuBufferWriter offset past the end of the buffer");
+    position = offset;
+}
+
+inline std::size_t GpuBufferWriter::align(std::size_t alignment) {
+    std::size_t aligned = (position + alignment - 1) & ~(alignment - 1);
+    seek(aligned);
+    return aligned;
+}
+
+inline unsigned char* GpuBufferWriter::reserve(std::size_t alignment, std::size_t stride, std::size_t count, std::size_t& start) {
+    start = (position + alignment - 1) & ~(alignment - 1);
+    if (start > size || count > (size - start) / stride) {
+        throw std::out_of_range("GpuBufferWriter write past the end of the buffer");
+    }
+    position = start + stride * count;
+    return memory + start;
+}
+
+template<typename Gpu, typename Convert>
+std::size_t GpuBufferWriter::writeArray(std::size_t count, Convert&& convert) {
+    constexpr std::size_t stride = sizeof(Gpu);
+    constexpr std::size_t vec4Count = sizeof(Gpu) / sizeof(GpuVec4);
+    std::size_t start = 0;
+    unsigned char* out = reserve(16, stride, count, start);
+    bool streaming = RENDERFX_HAS_STREAMING_STORES && stride * count >= threshold &&
+                     (reinterpret_cast<std::uintptr_t>(out) & 15) == 0;
+
+    for (std::size_t i = 0; i < count; ++i, out += stride) {
+        const Gpu value = convert(i);
+        const GpuVec4* v = detail::gpuVec4s(value);
+        for (std::size_t k = 0; k < vec4Count; ++k) detail::storeVec4(out + 16 * k, v[k], streaming);
+    }
+    detail::finishStreaming(streaming);
+    return start;
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeMatrices(const Matrix4x4<T>* matrices, std::size_t count) {
+    return writeArray<GpuMat4>(count, [matrices](std::size_t i) { return GpuMat4::from(matrices[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeMatrices(const Matrix<T, 3, 3>* matrices, std::size_t count) {
+    return writeArray<GpuMat3>(count, [matrices](std::size_t i) { return GpuMat3::from(matrices[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeAffineTransforms(const Matrix4x4<T>* matrices, std::size_t count) {
+    return writeArray<GpuAffine3x4>(count, [matrices](std::size_t i) { return GpuAffine3x4::from(matrices[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeAffineTransforms(const Matrix<T, 3, 4>* matrices, std::size_t count) {
+    return writeArray<GpuAffine3x4>(count, [matrices](std::size_t i) { return GpuAffine3x4::from(matrices[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeAffineTransforms(const Transform<T>* transforms, std::size_t count) {
+    return writeArray<GpuAffine3x4>(count, [transforms](std::size_t i) { return GpuAffine3x4::from(transforms[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeVectors(const Vector3<T>* vectors, std::size_t count, float w) {
+    return writeArray<GpuVec4>(count, [vectors, w](std::size_t i) { return GpuVec4::from(vectors[i], w); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeVectors(const Vector<T, 4>* vectors, std::size_t count) {
+    return writeArray<GpuVec4>(count, [vectors](std::size_t i) { return GpuVec4::from(vectors[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeQuaternions(const Quaternion<T>* quaternions, std::size_t count) {
+    return writeArray<GpuVec4>(count, [quaternions](std::size_t i) { return GpuVec4::from(quaternions[i]); });
+}
+
+template<typename T>
+std::size_t GpuBufferWriter::writeScalars(const T* values, std::size_t count) {
+    if (rules == BufferLayout::Std140) {
+        // Every array element is rounded up to a vec4.
+        return writeArray<GpuVec4>(count, [values](std::size_t i) { return GpuVec4{ static_cast<float>(values[i]), 0, 0, 0 }; });
+    }
+
+    std::size_t start = 0;
+    unsigned char* out = reserve(sizeof(float), sizeof(float), count, start);
+    for (std::size_t i = 0; i < count; ++i, out += sizeof(float)) {
+        float value = static_cast<float>(values[i]);
+        std::memcpy(out, &value, sizeof(float));
+    }
+    return start;
+}
+
+#endif // GPUBUFFERWRITER_INL
@@ -0,0 +1,155 @@
+#ifndef LARGEWORLDTRANSFORMS_H
+#define LARGEWORLDTRANSFORMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "../math/Geometry.h"
+#include "../math/Matrix4x4.h"
+#include "../math/VectorArray.h"
+
+/**
+ * @brief Transforms of a large world with double-precision positions and a floating origin.
+ *
+ * Positions are stored as doubles; rotations and scales in the render
+ * precision T. Rendering and culling work in T relative to an origin that
+ * follows the camera: localPositions() and worldMatrices() are relative to
+ * origin(), and cameras are placed with relativeToOrigin(), so values near
+ * the camera keep full precision however far they are from the world
+ * origin.
+ *
+ * The origin moves in steps of rebaseDistance when the camera is farther
+ * than that from it on any axis. Between such shifts update() rebases only
+ * the objects that were changed since the previous update. A shift moves
+ * the translation of every matrix, so it touches every object in the
+ * update that shifts: unchanged objects only get their translation
+ * rewritten, changed ones are recomposed, spread over a ThreadPool if one
+ * is given. The shift is not spread over several updates, as all matrices
+ * must be relative to the same origin when they are drawn; a large
+ * rebaseDistance keeps shifts rare.
+ *
+ * @tparam T Type of the render values.
+ */
+template<typename T>
+class LargeWorldTransforms {
+public:
+    static_assert(std::is_floating_point<T>::value, "LargeWorldTransforms requires a floating-point type");
+
+    /**
+     * @brief Creates an empty world with the origin at zero.
+     *
+     * @param rebaseDistance Distance between camera and origin that shifts the origin; also the origin grid.
+     * @throws std::invalid_argument If rebaseDistance is not positive.
+     */
+    explicit LargeWorldTransforms(double rebaseDistance = 1024.0);
+
+    std::size_t size() const noexcept { return positions.size(); }
+    bool empty() const noexcept { return positions.empty(); }
+    void reserve(std::size_t capacity);
+    void clear() noexcept;
+
+    /**
+     * @brief Appends an object; it is rebased by the next update().
+     *
+     * @param position The world position.
+     * @param rotation The rotation.
+     * @param scale The scale.
+     * @return Index of the object.
+     */
+    std::size_t add(const Vector3<double>& position, const Quaternion<T>& rotation = Quaternion<T>(),
+                    const Vector3<T>& scale = Vector3<T>(1, 1, 1));
+
+    Vector3<double> position(std::size_t index) const;
+    Quaternion<T> rotation(std::size_t index) const;
+    Vector3<T> scale(std::size_t index) const;
+
+    void setPosition(std::size_t index, const Vector3<double>& position);
+    void setRotation(std::size_t index, const Quaternion<T>& rotation);
+    void setScale(std::size_t index, const Vector3<T>& scale);
+
+    /**
+     * @brief Shifts the origin if needed and rebases the changed objects.
+     *
+     * @param cameraPosition The world position of the camera.
+     * @param pool Threads for rebasing; the calling thread does all the work if null.
+     * @return True if the origin shifted.
+     */
+    bool update(const Vector3<double>& cameraPosition, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Gets the current floating origin.
+     *
+     * @return The origin, a multiple of the rebase distance.
+     */
+    const Vector3<double>& origin() const noexcept { return currentOrigin; }
+
+    /**
+     * @brief Converts a world position to the render space.
+     *
+     * @param position The world position.
+     * @return The position relative to origin().
+     */
+    Vector3<T> relativeToOrigin(const Vector3<double>& position) const noexcept;
+
+    /**
+     * @brief Gets the positions relative to origin(), as of the last update().
+     *
+     * @return One position per object.
+     */
+    const VectorArray<T, 3>& localPositions() const noexcept { return relativePositions; }
+
+    /**
+     * @brief Gets the world matrices relative to origin(), as of the last update().
+     *
+     * @return One matrix per object.
+     */
+    const std::vector<Matrix4x4<T>>& worldMatrices() const noexcept { return matrices; }
+
+    /**
+     * @brief Gets the objects that the last update() rebased.
+     *
+     * Only their matrices have to be uploaded again.
+     *
+     * @return Indices in ascending order; every object after an origin shift.
+     */
+    const std::vector<std::uint32_t>& rebasedObjects() const noexcept { return rebased; }
+
+    /**
+     * @brief Rebases double-precision positions into the render precision.
+     *
+     * The difference is taken in double precision and rounded once. With the
+     * camera position as origin this produces camera-relative positions.
+     *
+     * @param positions The world positions.
+     * @param origin The origin to subtract.
+     * @param relative Receives the positions relative to origin; must have the same size.
+     * @param first The first element.
+     * @param last One past the last element.
+     */
+    static void rebase(const VectorArray<double, 3>& positions, const Vector3<double>& origin,
+                       VectorArray<T, 3>& relative, std::size_t first, std::size_t last);
+
+private:
+    double rebaseDistance;
+    Vector3<double> currentOrigin;
+    VectorArray<double, 3> positions;
+    VectorArray<T, 4> rotations;
+    VectorArray<T, 3> scales;
+    VectorArray<T, 3> relativePositions;
+    std::vector<Matrix4x4<T>> matrices;
+    std::vector<std::uint32_t> dirty;
+    std::vector<std::uint8_t> dirtyFlags;
+    std::vector<std::uint32_t> rebased;
+
+    void markDirty(std::size_t index);
+    void composeMatrices(const std::uint32_t* indices, std::size_t count);
+};
+
+// Commonly used types
+using LargeWorldTransformsf = LargeWorldTransforms<float>;
+
+#include "LargeWorldTransforms.inl"
+
+#endif // LARGEWORLDTRANSFORMS_H
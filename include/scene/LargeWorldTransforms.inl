@@ -0,0 +1,185 @@
+#ifndef LARGEWORLDTRANSFORMS_INL
+#define LARGEWORLDTRANSFORMS_INL
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+template<typename T>
+LargeWorldTransforms<T>::LargeWorldTransforms(double rebaseDistance)
+    : rebaseDistance(rebaseDistance), currentOrigin(0, 0, 0) {
+    if (!(rebaseDistance > 0)) throw std::invalid_argument("Rebase distance must be positive");
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::reserve(std::size_t capacity) {
+    positions.reserve(capacity);
+    rotations.reserve(capacity);
+    scales.reserve(capacity);
+    relativePositions.reserve(capacity);
+    matrices.reserve(capacity);
+    dirtyFlags.reserve(capacity);
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::clear() noexcept {
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+    relativePositions.clear();
+    matrices.clear();
+    dirty.clear();
+    dirtyFlags.clear();
+    rebased.clear();
+}
+
+template<typename T>
+std::size_t LargeWorldTransforms<T>::add(const Vector3<double>& position, const Quaternion<T>& rotation, const Vector3<T>& scale) {
+    std::size_t index = size();
+    positions.push_back(Vector<double, 3>(position));
+    rotations.push_back(Vector<T, 4>(rotation.x, rotation.y, rotation.z, rotation.w));
+    scales.push_back(Vector<T, 3>(scale));
+    relativePositions.push_back(Vector<T, 3>());
+    matrices.emplace_back();
+    dirtyFlags.push_back(0);
+    markDirty(index);
+    return index;
+}
+
+template<typename T>
+Vector3<double> LargeWorldTransforms<T>::position(std::size_t index) const {
+    return positions.get(index).toVector3();
+}
+
+template<typename T>
+Quaternion<T> LargeWorldTransforms<T>::rotation(std::size_t index) const {
+    Vector<T, 4> r = rotations.get(index);
+    return Quaternion<T>(r.w, r.x, r.y, r.z);
+}
+
+template<typename T>
+Vector3<T> LargeWorldTransforms<T>::scale(std::size_t index) const {
+    return scales.get(index).toVector3();
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::setPosition(std::size_t index, const Vector3<double>& position) {
+    positions.set(index, Vector<double, 3>(position));
+    markDirty(index);
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::setRotation(std::size_t index, const Quaternion<T>& rotation) {
+    rotations.set(index, Vector<T, 4>(rotation.x, rotation.y, rotation.z, rotation.w));
+    markDirty(index);
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::setScale(std::size_t index, const Vector3<T>& scale) {
+    scales.set(index, Vector<T, 3>(scale));
+    markDirty(index);
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::markDirty(std::size_t index) {
+    if (dirtyFlags[index] != 0) return;
+    dirtyFlags[index] = 1;
+    dirty.push_back(static_cast<std::uint32_t>(index));
+}
+
+template<typename T>
+bool LargeWorldTransforms<T>::update(const Vector3<double>& cameraPosition, ThreadPool* pool) {
+    Vector3<double> offset = cameraPosition - currentOrigin;
+    bool shift = std::fabs(offset.x) > rebaseDistance || std::fabs(offset.y) > rebaseDistance || std::fabs(offset.z) > rebaseDistance;
+    if (shift) {
+        // Snap to the grid so the origin and the rebased values do not drift.
+        currentOrigin = Vector3<double>(std::round(cameraPosition.x / rebaseDistance) * rebaseDistance,
+                                        std::round(cameraPosition.y / rebaseDistance) * rebaseDistance,
+                                        std::round(cameraPosition.z / rebaseDistance) * rebaseDistance);
+        rebased.resize(size());
+        for (std::size_t i = 0; i < rebased.size(); ++i) rebased[i] = static_cast<std::uint32_t>(i);
+    } else {
+        std::sort(dirty.begin(), dirty.end());
+        rebased.swap(dirty);
+    }
+
+    auto process = [&](std::size_t first, std::size_t last) {
+        if (shift) {
+            // Only the translation of unchanged objects moves with the origin.
+            rebase(positions, currentOrigin, relativePositions, first, last);
+            for (std::size_t i = first; i < last; ++i) {
+                if (dirtyFlags[i] != 0) {
+                    composeMatrices(rebased.data() + i, 1);
+                } else {
+                    for (int r = 0; r < 3; ++r) matrices[i](r, 3) = relativePositions.component(r)[i];
+                }
+            }
+        } else {
+            for (std::size_t i = first; i < last; ++i) rebase(positions, currentOrigin, relativePositions, rebased[i], rebased[i] + 1);
+            composeMatrices(rebased.data() + first, last - first);
+        }
+    };
+    if (pool != nullptr) {
+        pool->parallelFor(0, rebased.size(), 4096, process);
+    } else if (!rebased.empty()) {
+        process(0, rebased.size());
+    }
+
+    // The changed objects are in rebased after a plain update and still in dirty after a shift.
+    for (std::uint32_t index : shift ? dirty : rebased) dirtyFlags[index] = 0;
+    dirty.clear();
+    return shift;
+}
+
+template<typename T>
+Vector3<T> LargeWorldTransforms<T>::relativeToOrigin(const Vector3<double>& position) const noexcept {
+    return Vector3<T>(static_cast<T>(position.x - currentOrigin.x), static_cast<T>(position.y - currentOrigin.y),
+                      static_cast<T>(position.z - currentOrigin.z));
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::rebase(const VectorArray<double, 3>& positions, const Vector3<double>& origin,
+                                     VectorArray<T, 3>& relative, std::size_t first, std::size_t last) {
+    for (std::size_t c = 0; c < 3; ++c) {
+        const double* source = positions.component(c);
+        T* target = relative.component(c);
+        double o = origin[static_cast<int>(c)];
+        for (std::size_t i = first; i < last; ++i) target[i] = static_cast<T>(source[i] - o);
+    }
+}
+
+template<typename T>
+void LargeWorldTransforms<T>::composeMatrices(const std::uint32_t* indices, std::size_t count) {
+    const T* p[3] = { relativePositions.component(0), relativePositions.component(1), relativePositions.component(2) };
+    const T* r[4] = { rotations.component(0), rotations.component(1), rotations.component(2), rotations.component(3) };
+    const T* s[3] = { scales.component(0), scales.component(1), scales.component(2) };
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t i = indices[k];
+        T x = r[0][i], y = r[1][i], z = r[2][i], w = r[3][i];
+        T xx = x * x, yy = y * y, zz = z * z;
+        T xy = x * y, xz = x * z, yz = y * z;
+        T wx = w * x, wy = w * y, wz = w * z;
+        T sx = s[0][i], sy = s[1][i], sz = s[2][i];
+
+        // translation * rotation * scaling, written out.
+        Matrix4x4<T>& m = matrices[i];
+        m(0, 0) = (1 - 2 * (yy + zz)) * sx;
+        m(0, 1) = 2 * (xy - wz) * sy;
+        m(0, 2) = 2 * (xz + wy) * sz;
+        m(0, 3) = p[0][i];
+        m(1, 0) = 2 * (xy + wz) * sx;
+        m(1, 1) = (1 - 2 * (xx + zz)) * sy;
+        m(1, 2) = 2 * (yz - wx) * sz;
+        m(1, 3) = p[1][i];
+        m(2, 0) = 2 * (xz - wy) * sx;
+        m(2, 1) = 2 * (yz + wx) * sy;
+        m(2, 2) = (1 - 2 * (xx + yy)) * sz;
+        m(2, 3) = p[2][i];
+        m(3, 0) = 0;
+        m(3, 1) = 0;
+        m(3, 2) = 0;
+        m(3, 3) = 1;
+    }
+}
+
+#endif // LARGEWORLDTRANSFORMS_INL
@@ -0,0 +1,130 @@
+#ifndef OBJLOADER_H
+#define OBJLOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../core/MappedFile.h"
+#include "../core/ThreadPool.h"
+#include "../math/Geometry.h"
+#include "../math/VectorArray.h"
+
+/**
+ * @brief An indexed triangle mesh.
+ *
+ * Vertex attributes are stored as component streams. normals and texCoords
+ * are either empty or have one entry per vertex; vertices whose face
+ * corner had no normal or texture coordinate get zeros.
+ *
+ * @tparam T Type of the vertex components.
+ */
+template<typename T>
+struct Mesh {
+    VectorArray<T, 3> positions;        ///< The vertex positions.
+    VectorArray<T, 3> normals;          ///< The vertex normals, or empty.
+    VectorArray<T, 2> texCoords;        ///< The vertex texture coordinates, or empty.
+    std::vector<std::uint32_t> indices; ///< Three vertex indices per triangle.
+    AABB<T> bounds;                     ///< Bounds of all positions in the file.
+    Sphere<T> boundingSphere;           ///< A sphere enclosing all positions in the file.
+
+    std::size_t vertexCount() const noexcept { return positions.size(); }
+    std::size_t triangleCount() const noexcept { return indices.size() / 3; }
+};
+
+/**
+ * @brief Loads Wavefront OBJ meshes in parallel.
+ *
+ * The file is memory mapped and split at line boundaries into chunks that
+ * are parsed on a ThreadPool. Each chunk keeps its own attribute arrays,
+ * face corners and running bounds, so chunks share nothing until they are
+ * merged; the bounds and bounding sphere are therefore known as soon as
+ * parsing ends. Face corners that reference distinct (position, texture
+ * coordinate, normal) triples become distinct vertices; files with
+ * positions only use the positions as vertices directly.
+ *
+ * Recognized statements are v, vt, vn and f, including relative (negative)
+ * indices; polygons are triangulated as fans. Everything else (groups,
+ * materials, smoothing groups, lines) is ignored.
+ *
+ * A loader keeps its scratch buffers between calls; use one per thread.
+ *
+ * @tparam T Type of the vertex components.
+ */
+template<typename T>
+class ObjLoader {
+public:
+    /**
+     * @brief Creates a loader that parses on a thread pool.
+     *
+     * @param pool The thread pool; must outlive the loader.
+     */
+    explicit ObjLoader(ThreadPool& pool) : pool(pool) {}
+
+    /**
+     * @brief Parses OBJ text.
+     *
+     * @param text The contents of an .obj file.
+     * @return The mesh.
+     * @throws std::runtime_error If the text is malformed or an index is out of range; the message names the line.
+     */
+    Mesh<T> parse(std::string_view text);
+
+    /**
+     * @brief Loads an OBJ file.
+     *
+     * @param path Path of the file.
+     * @return The mesh.
+     * @throws std::runtime_error If the file cannot be read or is not a valid mesh.
+     */
+    Mesh<T> loadFile(const std::string& path);
+
+private:
+    static constexpr std::uint32_t missing = 0xFFFFFFFFu;
+
+    // Zero-based indices of a face corner. Relative indices are stored as
+    // signed offsets from the chunk's first element and listed in
+    // Chunk::relativeCorners until the chunk bases are known.
+    struct Corner {
+        std::uint32_t position;
+        std::uint32_t texCoord;
+        std::uint32_t normal;
+    };
+
+    struct Chunk {
+        const char* first = nullptr;
+        const char* last = nullptr;
+        std::vector<T> positions[3];
+        std::vector<T> normals[3];
+        std::vector<T> texCoords[2];
+        std::vector<Corner> corners;
+        std::vector<std::size_t> relativeCorners;
+        T boundsMin[3];
+        T boundsMax[3];
+        Vector3<T> sphereCenter;
+        T sphereRadius = T(0);
+        std::size_t positionBase = 0;
+        std::size_t normalBase = 0;
+        std::size_t texCoordBase = 0;
+        std::size_t cornerBase = 0;
+        bool hasAttributes = false;
+    };
+
+    ThreadPool& pool;
+    std::vector<Chunk> chunks;
+    std::vector<std::uint32_t> vertexKeys;
+    std::vector<std::uint32_t> table;
+
+    void split(std::string_view text);
+    void parseChunk(Chunk& chunk, const char* begin) const;
+    static const char* faceLine(const Chunk& chunk, std::size_t corner);
+};
+
+// Commonly used types
+using Meshf = Mesh<float>;
+using ObjLoaderf = ObjLoader<float>;
+
+#include "ObjLoader.inl"
+
+#endif // OBJLOADER_H
@@ -0,0 +1,412 @@
+#ifndef OBJLOADER_INL
+#define OBJLOADER_INL
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace detail {
+
+// Grows a sphere to enclose another one; a negative radius marks an empty sphere.
+template<typename T>
+void mergeBoundingSphere(Vector3<T>& center, T& radius, const Vector3<T>& otherCenter, T otherRadius) {
+    if (otherRadius < T(0)) return;
+    if (radius < T(0)) {
+        center = otherCenter;
+        radius = otherRadius;
+        return;
+    }
+    Vector3<T> offset = otherCenter - center;
+    T distance = offset.length();
+    if (distance + otherRadius <= radius) return;
+    if (distance + radius <= otherRadius) {
+        center = otherCenter;
+        radius = otherRadius;
+        return;
+    }
+    T newRadius = (distance + radius + otherRadius) * T(0.5);
+    center = center + offset * ((newRadius - radius) / distance);
+    radius = newRadius;
+}
+
+// Errors are rare, so the line number is only counted when one is thrown.
+[[noreturn]] inline void objError(const char* begin, const char* at, const char* message) {
+    std::size_t line = 1 + static_cast<std::size_t>(std::count(begin, at, '\n'));
+    throw std::runtime_error("Invalid OBJ at line " + std::to_string(line) + ": " + message);
+}
+
+inline std::uint32_t objHash(std::uint32_t position, std::uint32_t texCoord, std::uint32_t normal) noexcept {
+    std::uint64_t hash = (std::uint64_t(position) * 0x9E3779B97F4A7C15ull) ^
+                         (std::uint64_t(texCoord) * 0xC2B2AE3D27D4EB4Full) ^
+                         (std::uint64_t(normal) * 0x165667B19E3779F9ull);
+    return static_cast<std::uint32_t>(hash >> 32) ^ static_cast<std::uint32_t>(hash);
+}
+
+} // namespace detail
+
+template<typename T>
+void ObjLoader<T>::split(std::string_view text) {
+    constexpr std::size_t minChunkSize = 1 << 16;
+    std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(pool.threadCount() * 4, text.size() / minChunkSize));
+    chunks.resize(chunkCount);
+
+    const char* first = text.data();
+    const char* end = text.data() + text.size();
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        const char* last = i + 1 == chunkCount ? end : std::max(first, text.data() + text.size() * (i + 1) / chunkCount);
+        if (last != end) {
+            const void* newline = std::memchr(last, '\n', static_cast<std::size_t>(end - last));
+            last = newline != nullptr ? static_cast<const char*>(newline) + 1 : end;
+        }
+        chunks[i].first = first;
+        chunks[i].last = last;
+        first = last;
+    }
+}
+
+template<typename T>
+void ObjLoader<T>::parseChunk(Chunk& chunk, const char* begin) const {
+    for (auto& component : chunk.positions) component.clear();
+    for (auto& component : chunk.normals) component.clear();
+    for (auto& component : chunk.texCoords) component.clear();
+    chunk.corners.clear();
+    chunk.relativeCorners.clear();
+    chunk.hasAttributes = false;
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        chunk.boundsMin[axis] = std::numeric_limits<T>::max();
+        chunk.boundsMax[axis] = std::numeric_limits<T>::lowest();
+    }
+    chunk.sphereRadius = T(-1);
+
+    const char* p = chunk.first;
+    const char* last = chunk.last;
+    auto skipBlank = [&]() {
+        while (p != last && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    };
+    auto atLineEnd = [&]() {
+        skipBlank();
+        return p == last || *p == '\n' || *p == '#';
+    };
+    auto readScalar = [&](T& value) {
+        if (atLineEnd()) return false;
+        std::from_chars_result result = std::from_chars(p, last, value);
+        if (result.ec != std::errc()) detail::objError(begin, p, "invalid number");
+        p = result.ptr;
+        return true;
+    };
+    // Reads one index and reports whether it is relative to the chunk start.
+    auto readIndex = [&](std::size_t count, bool& relative) {
+        std::int64_t value = 0;
+        std::from_chars_result result = std::from_chars(p, last, value);
+        if (result.ec != std::errc() || value == 0) detail::objError(begin, p, "invalid index");
+        p = result.ptr;
+        relative = value < 0;
+        if (relative) {
+            value += static_cast<std::int64_t>(count);
+            if (value < std::numeric_limits<std::int32_t>::min()) detail::objError(begin, p, "index out of range");
+            return static_cast<std::uint32_t>(static_cast<std::int32_t>(value));
+        }
+        if (value > std::int64_t(missing)) detail::objError(begin, p, "index out of range");
+        return static_cast<std::uint32_t>(value - 1);
+    };
+    // Reads v, v/vt, v//vn or v/vt/vn; bit 0, 1 and 2 of the mask flag relative indices.
+    auto readCorner = [&](unsigned& relativeMask) {
+        Corner corner = { 0, missing, missing };
+        bool relative = false;
+        relativeMask = 0;
+        corner.position = readIndex(chunk.positions[0].size(), relative);
+        relativeMask |= relative ? 1u : 0u;
+        if (p != last && *p == '/') {
+            ++p;
+            if (p != last && *p != '/') {
+                corner.texCoord = readIndex(chunk.texCoords[0].size(), relative);
+                relativeMask |= relative ? 2u : 0u;
+            }
+            if (p != last && *p == '/') {
+                ++p;
+                corner.normal = readIndex(chunk.normals[0].size(), relative);
+                relativeMask |= relative ? 4u : 0u;
+            }
+        }
+        return corner;
+    };
+    auto pushCorner = [&](const Corner& corner, unsigned relativeMask) {
+        if (relativeMask != 0) chunk.relativeCorners.push_back(chunk.corners.size() * 8 + relativeMask);
+        chunk.corners.push_back(corner);
+    };
+
+    while (p != last) {
+        skipBlank();
+        const char* lineStart = p;
+        if (last - p >= 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            ++p;
+            Vector3<T> position;
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                if (!readScalar(position[axis])) detail::objError(begin, lineStart, "v needs 3 numbers");
+                chunk.positions[axis].push_back(position[axis]);
+                chunk.boundsMin[axis] = std::min(chunk.boundsMin[axis], position[axis]);
+                chunk.boundsMax[axis] = std::max(chunk.boundsMax[axis], position[axis]);
+            }
+            // Ritter's incremental sphere: grow just enough to reach the point.
+            if (chunk.sphereRadius < T(0)) {
+                chunk.sphereCenter = position;
+                chunk.sphereRadius = T(0);
+            } else {
+                Vector3<T> offset = position - chunk.sphereCenter;
+                T distanceSquared = offset.lengthSquared();
+                if (distanceSquared > chunk.sphereRadius * chunk.sphereRadius) {
+                    T distance = std::sqrt(distanceSquared);
+                    T newRadius = (chunk.sphereRadius + distance) * T(0.5);
+                    chunk.sphereCenter = chunk.sphereCenter + offset * ((newRadius - chunk.sphereRadius) / distance);
+                    chunk.sphereRadius = newRadius;
+                }
+            }
+        } else if (last - p >= 3 && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+            p += 2;
+            for (auto& component : chunk.normals) {
+                T value;
+                if (!readScalar(value)) detail::objError(begin, lineStart, "vn needs 3 numbers");
+                component.push_back(value);
+            }
+        } else if (last - p >= 3 && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t')) {
+            p += 2;
+            T u = T(0);
+            T v = T(0);
+            if (!readScalar(u)) detail::objError(begin, lineStart, "vt needs at least 1 number");
+            readScalar(v);
+            chunk.texCoords[0].push_back(u);
+            chunk.texCoords[1].push_back(v);
+        } else if (last - p >= 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            ++p;
+            Corner first = {};
+            Corner previous = {};
+            unsigned firstMask = 0;
+            unsigned previousMask = 0;
+            std::size_t count = 0;
+            while (!atLineEnd()) {
+                unsigned mask = 0;
+                Corner corner = readCorner(mask);
+                if (p != last && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+                    detail::objError(begin, p, "invalid face corner");
+                }
+                chunk.hasAttributes = chunk.hasAttributes || corner.texCoord != missing || corner.normal != missing;
+                if (count == 0) {
+                    first = corner;
+                    firstMask = mask;
+                } else if (count >= 2) {
+                    pushCorner(first, firstMask);
+                    pushCorner(previous, previousMask);
+                    pushCorner(corner, mask);
+                }
+                previous = corner;
+                previousMask = mask;
+                ++count;
+            }
+            if (count < 3) detail::objError(begin, lineStart, "f needs at least 3 corners");
+        }
+
+        const void* newline = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+        p = newline != nullptr ? static_cast<const char*>(newline) + 1 : last;
+    }
+}
+
+template<typename T>
+const char* ObjLoader<T>::faceLine(const Chunk& chunk, std::size_t corner) {
+    // Walks the f statements of an already parsed chunk; each polygon of n
+    // corners produced (n - 2) * 3 triangle corners.
+    std::size_t corners = 0;
+    const char* p = chunk.first;
+    const char* last = chunk.last;
+    while (p != last) {
+        while (p != last && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        const char* lineStart = p;
+        const void* newline = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+        const char* lineEnd = newline != nullptr ? static_cast<const char*>(newline) : last;
+        if (lineEnd - p >= 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            std::size_t count = 0;
+            for (p += 1; p != lineEnd && *p != '#';) {
+                if (*p == ' ' || *p == '\t' || *p == '\r') {
+                    ++p;
+                    continue;
+                }
+                ++count;
+                while (p != lineEnd && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+            }
+            corners += (count - 2) * 3;
+            if (corner < corners) return lineStart;
+        }
+        p = lineEnd != last ? lineEnd + 1 : last;
+    }
+    return last;
+}
+
+template<typename T>
+Mesh<T> ObjLoader<T>::parse(std::string_view text) {
+    const char* begin = text.data();
+    split(text);
+    pool.parallelFor(0, chunks.size(), 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) parseChunk(chunks[i], begin);
+    });
+
+    // Chunk bases and the merged bounds.
+    Mesh<T> mesh;
+    std::size_t positionCount = 0;
+    std::size_t normalCount = 0;
+    std::size_t texCoordCount = 0;
+    std::size_t cornerCount = 0;
+    bool hasAttributes = false;
+    Vector3<T> boundsMin(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max());
+    Vector3<T> boundsMax(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest());
+    Vector3<T> sphereCenter;
+    T sphereRadius = T(-1);
+    for (Chunk& chunk : chunks) {
+        chunk.positionBase = positionCount;
+        chunk.normalBase = normalCount;
+        chunk.texCoordBase = texCoordCount;
+        chunk.cornerBase = cornerCount;
+        positionCount += chunk.positions[0].size();
+        normalCount += chunk.normals[0].size();
+        texCoordCount += chunk.texCoords[0].size();
+        cornerCount += chunk.corners.size();
+        hasAttributes = hasAttributes || chunk.hasAttributes;
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            boundsMin[axis] = std::min(boundsMin[axis], chunk.boundsMin[axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], chunk.boundsMax[axis]);
+        }
+        detail::mergeBoundingSphere(sphereCenter, sphereRadius, chunk.sphereCenter, chunk.sphereRadius);
+    }
+    if (std::max({ positionCount, normalCount, texCoordCount, cornerCount }) >= missing) {
+        throw std::runtime_error("OBJ mesh exceeds 32-bit indices");
+    }
+    if (positionCount > 0) {
+        mesh.bounds = AABB<T>(boundsMin, boundsMax);
+        // The sphere around the box center is sometimes tighter than Ritter's.
+        T boxRadius = (boundsMax - boundsMin).length() * T(0.5);
+        if (boxRadius < sphereRadius) {
+            sphereCenter = (boundsMin + boundsMax) * T(0.5);
+            sphereRadius = boxRadius;
+        }
+        sphereRadius *= T(1) + T(4) * std::numeric_limits<T>::epsilon();
+        mesh.boundingSphere = Sphere<T>(sphereCenter, sphereRadius);
+    } else {
+        mesh.boundingSphere = Sphere<T>(Vector3<T>::zero(), T(0));
+    }
+
+    // Gather the attributes and resolve the corners of every chunk.
+    VectorArray<T, 3> positions(positionCount);
+    VectorArray<T, 3> normals(normalCount);
+    VectorArray<T, 2> texCoords(texCoordCount);
+    mesh.indices.resize(cornerCount);
+    pool.parallelFor(0, chunks.size(), 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            Chunk& chunk = chunks[i];
+            for (std::size_t c = 0; c < 3; ++c) {
+                std::copy(chunk.positions[c].begin(), chunk.positions[c].end(), positions.component(c) + chunk.positionBase);
+                std::copy(chunk.normals[c].begin(), chunk.normals[c].end(), normals.component(c) + chunk.normalBase);
+            }
+            for (std::size_t c = 0; c < 2; ++c) {
+                std::copy(chunk.texCoords[c].begin(), chunk.texCoords[c].end(), texCoords.component(c) + chunk.texCoordBase);
+            }
+
+            for (std::size_t entry : chunk.relativeCorners) {
+                Corner& corner = chunk.corners[entry / 8];
+                // Indices before the first element fail the range check below.
+                auto rebase = [](std::uint32_t& index, std::size_t base) {
+                    std::int64_t value = static_cast<std::int64_t>(base) + static_cast<std::int32_t>(index);
+                    index = value >= 0 ? static_cast<std::uint32_t>(value) : missing - 1;
+                };
+                if (entry & 1) rebase(corner.position, chunk.positionBase);
+                if (entry & 2) rebase(corner.texCoord, chunk.texCoordBase);
+                if (entry & 4) rebase(corner.normal, chunk.normalBase);
+            }
+            for (std::size_t c = 0; c < chunk.corners.size(); ++c) {
+                const Corner& corner = chunk.corners[c];
+                if (corner.position >= positionCount ||
+                    (corner.texCoord != missing && corner.texCoord >= texCoordCount) ||
+                    (corner.normal != missing && corner.normal >= normalCount)) {
+                    detail::objError(begin, faceLine(chunk, c), "face index out of range");
+                }
+            }
+            if (!hasAttributes) {
+                std::uint32_t* out = mesh.indices.data() + chunk.cornerBase;
+                for (const Corner& corner : chunk.corners) *out++ = corner.position;
+            }
+        }
+    });
+
+    if (!hasAttributes) {
+        // Positions only: the positions are the vertices.
+        mesh.positions = std::move(positions);
+        return mesh;
+    }
+
+    // Deduplicate (position, texCoord, normal) triples with an open
+    // addressing table of vertex ids.
+    std::size_t tableSize = 16;
+    while (tableSize < cornerCount * 2) tableSize *= 2;
+    table.assign(tableSize, missing);
+    vertexKeys.clear();
+    std::size_t mask = tableSize - 1;
+    std::uint32_t* out = mesh.indices.data();
+    for (const Chunk& chunk : chunks) {
+        for (const Corner& corner : chunk.corners) {
+            std::size_t slot = detail::objHash(corner.position, corner.texCoord, corner.normal) & mask;
+            for (;;) {
+                std::uint32_t vertex = table[slot];
+                if (vertex == missing) {
+                    vertex = static_cast<std::uint32_t>(vertexKeys.size() / 3);
+                    table[slot] = vertex;
+                    vertexKeys.insert(vertexKeys.end(), { corner.position, corner.texCoord, corner.normal });
+                    *out++ = vertex;
+                    break;
+                }
+                const std::uint32_t* key = vertexKeys.data() + std::size_t(vertex) * 3;
+                if (key[0] == corner.position && key[1] == corner.texCoord && key[2] == corner.normal) {
+                    *out++ = vertex;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+    }
+
+    std::size_t vertexCount = vertexKeys.size() / 3;
+    mesh.positions.resize(vertexCount);
+    if (normalCount > 0) mesh.normals.resize(vertexCount);
+    if (texCoordCount > 0) mesh.texCoords.resize(vertexCount);
+    pool.parallelFor(0, vertexCount, 1 << 14, [&](std::size_t first, std::size_t last) {
+        for (std::size_t v = first; v < last; ++v) {
+            const std::uint32_t* key = vertexKeys.data() + v * 3;
+            for (std::size_t c = 0; c < 3; ++c) mesh.positions.component(c)[v] = positions.component(c)[key[0]];
+            if (normalCount > 0) {
+                for (std::size_t c = 0; c < 3; ++c) {
+                    mesh.normals.component(c)[v] = key[2] != missing ? normals.component(c)[key[2]] : T(0);
+                }
+            }
+            if (texCoordCount > 0) {
+                for (std::size_t c = 0; c < 2; ++c) {
+                    mesh.texCoords.component(c)[v] = key[1] != missing ? texCoords.component(c)[key[1]] : T(0);
+                }
+            }
+        }
+    });
+    return mesh;
+}
+
+template<typename T>
+Mesh<T> ObjLoader<T>::loadFile(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) throw std::runtime_error("Cannot open OBJ file " + path);
+    file.prefetch();
+    try {
+        return parse(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()));
+    } catch (const std::runtime_error& error) {
+        throw std::runtime_error(path + ": " + error.what());
+    }
+}
+
+#endif // OBJLOADER_INL
@@ -0,0 +1,161 @@
+#ifndef POINTCLOUDOCTREE_H
+#define POINTCLOUDOCTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../core/BinaryFile.h"
+#include "../core/MappedFile.h"
+#include "../core/RandomAccessFile.h"
+#include "../core/ThreadPool.h"
+#include "../math/Geometry.h"
+
+/**
+ * @brief Header at the start of a .rfxoctree file.
+ *
+ * The header is followed by nodeCount PointCloudNode entries at nodesOffset.
+ * The points of all nodes are stored in a companion .rfxpoints file.
+ */
+struct PointCloudOctreeHeader {
+    char magic[8];              ///< "RFXOCTRE".
+    std::uint32_t version;      ///< Format version.
+    std::uint32_t byteOrder;    ///< 0x01020304 as written by the producer.
+    std::uint32_t nodeCount;    ///< Number of nodes.
+    std::uint32_t maxLevel;     ///< Deepest level of any node.
+    std::uint64_t pointCount;   ///< Number of input points.
+    std::uint64_t pointsSize;   ///< Size of the .rfxpoints file.
+    std::uint64_t nodesOffset;  ///< Offset of the node table.
+    std::uint64_t checksum;     ///< Checksum of the node table.
+    double center[3];           ///< Center of the root cube.
+    double halfSize;            ///< Half the edge length of the root cube.
+};
+
+/**
+ * @brief A node of a point cloud octree.
+ *
+ * Nodes are stored level by level, and the children of a node are stored
+ * next to each other in octant order starting at firstChild. Each node
+ * holds a spatially uniform subsample of its subtree (all of its points
+ * for leaves), stored as float offsets from the node center so that deep
+ * nodes of large scans keep their precision.
+ */
+struct PointCloudNode {
+    double center[3];          ///< Center of the node cube.
+    double halfSize;           ///< Half the edge length of the node cube.
+    std::uint64_t pointOffset; ///< Byte offset of the points in the .rfxpoints file.
+    std::uint32_t pointCount;  ///< Number of points.
+    std::uint32_t firstChild;  ///< Index of the first child.
+    std::uint32_t childMask;   ///< Bit i is set if octant i has a child.
+    std::uint32_t level;       ///< Depth of the node; the root is level 0.
+
+    /**
+     * @brief Gets the number of children.
+     *
+     * @return The number of set bits of childMask.
+     */
+    std::uint32_t childCount() const noexcept;
+};
+
+/**
+ * @brief Settings of the point cloud octree builder.
+ */
+struct PointCloudBuildSettings {
+    std::size_t nodeCapacity = 16384;             ///< Maximum points per node.
+    std::size_t memoryBudget = std::size_t(1) << 24; ///< Maximum points a thread keeps in memory at once.
+    std::string temporaryDirectory;               ///< Directory for partition files; beside the output if empty.
+};
+
+/**
+ * @brief A level-of-detail octree over a point cloud, used in place from mapped files.
+ *
+ * build() converts a file of raw Vector3<T> points into a .rfxoctree node
+ * table and a .rfxpoints file with the points of each node stored
+ * contiguously. Inputs larger than memoryBudget are partitioned out of
+ * core: a histogram pass finds subtrees that fit in memory, the points are
+ * distributed into one temporary file per subtree, the subtrees are built
+ * in parallel (partitioning again if a single cell is still too large),
+ * and the nodes above them are built from their subsamples.
+ *
+ * At runtime select() picks a cut through the tree: starting at the root,
+ * the visible node with the largest projected size is replaced by its
+ * visible children as long as the point budget allows.
+ *
+ * @tparam T Type of the input points and of the camera math.
+ */
+template<typename T>
+class PointCloudOctree {
+public:
+    static_assert(std::is_floating_point<T>::value, "PointCloudOctree requires a floating-point type");
+
+    static constexpr std::uint32_t version = 1; ///< The current format version.
+
+    /**
+     * @brief Builds an octree from a file of points.
+     *
+     * @param inputPath A file of packed Vector3<T> values.
+     * @param outputBase Path of the output without extension; .rfxoctree and .rfxpoints are appended.
+     * @param pool The threads that build subtrees.
+     * @param settings The build settings.
+     * @throws std::invalid_argument If the settings are invalid.
+     * @throws std::runtime_error If a file cannot be read or written.
+     */
+    static void build(const std::string& inputPath, const std::string& outputBase, ThreadPool& pool,
+                      const PointCloudBuildSettings& settings = PointCloudBuildSettings());
+
+    PointCloudOctree() = default;
+
+    /**
+     * @brief Maps an octree.
+     *
+     * @param base Path of the octree without extension.
+     * @throws std::runtime_error If the files cannot be mapped or are not a valid octree.
+     */
+    explicit PointCloudOctree(const std::string& base);
+
+    std::size_t nodeCount() const noexcept { return nodeTotal; }
+    std::uint64_t pointCount() const noexcept;
+    const PointCloudNode& node(std::size_t index) const;
+    AABB<T> nodeBounds(std::size_t index) const;
+
+    /**
+     * @brief Gets the points of a node.
+     *
+     * @param index Index of the node.
+     * @return node(index).pointCount points as x, y, z floats relative to the node center.
+     */
+    const float* points(std::size_t index) const;
+
+    /**
+     * @brief Selects the nodes to draw for a camera.
+     *
+     * @param cameraPosition The camera position.
+     * @param frustum The camera frustum.
+     * @param pixelsPerUnit Screen height divided by 2 tan(fovY / 2); converts size over distance to pixels.
+     * @param pointBudget Maximum number of points of the selected nodes.
+     * @param minNodePixels Nodes smaller than this on screen are not refined.
+     * @param selected Receives the indices of the selected nodes; empty if the
+     *                 root is not visible or alone exceeds pointBudget.
+     * @return The number of points of the selected nodes, never more than pointBudget.
+     */
+    std::uint64_t select(const Vector3<T>& cameraPosition, const Frustum<T>& frustum, T pixelsPerUnit,
+                         std::uint64_t pointBudget, T minNodePixels, std::vector<std::uint32_t>& selected) const;
+
+private:
+    MappedFile table;
+    MappedFile pointData;
+    const PointCloudOctreeHeader* header = nullptr;
+    const PointCloudNode* nodes = nullptr;
+    std::size_t nodeTotal = 0;
+
+    T projectedSize(const PointCloudNode& node, const Vector3<T>& cameraPosition, T pixelsPerUnit) const noexcept;
+};
+
+// Commonly used types
+using PointCloudOctreef = PointCloudOctree<float>;
+using PointCloudOctreed = PointCloudOctree<double>;
+
+#include "PointCloudOctree.inl"
+
+#endif // POINTCLOUDOCTREE_H
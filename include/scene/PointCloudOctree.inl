@@ -0,0 +1,591 @@
+#ifndef POINTCLOUDOCTREE_INL
+#define POINTCLOUDOCTREE_INL
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+static_assert(sizeof(PointCloudOctreeHeader) == 88, "PointCloudOctreeHeader must not contain padding");
+static_assert(sizeof(PointCloudNode) == 56, "PointCloudNode must not contain padding");
+
+namespace detail {
+
+constexpr char pointCloudMagic[8] = { 'R', 'F', 'X', 'O', 'C', 'T', 'R', 'E' };
+
+// Points are quantized to 21 bits per axis of the root cube; the node at
+// level l that contains a point has the coordinates q >> (21 - l).
+constexpr unsigned pointCloudBits = 21;
+constexpr unsigned pointCloudMaxLevel = 20;
+// Nodes are subsampled on a grid of 2^7 cells per axis.
+constexpr unsigned pointCloudSampleBits = 7;
+
+// Spreads the low 21 bits of a value to every third bit.
+constexpr std::uint64_t spreadBits3(std::uint64_t value) noexcept {
+    value &= 0x1FFFFF;
+    value = (value | (value << 32)) & 0x1F00000000FFFFull;
+    value = (value | (value << 16)) & 0x1F0000FF0000FFull;
+    value = (value | (value << 8)) & 0x100F00F00F00F00Full;
+    value = (value | (value << 4)) & 0x10C30C30C30C30C3ull;
+    value = (value | (value << 2)) & 0x1249249249249249ull;
+    return value;
+}
+
+// Interleaves x, y and z with x in bit 0, so octant i of a cell is child code 8 * code + i.
+constexpr std::uint64_t morton3(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept {
+    return spreadBits3(x) | (spreadBits3(y) << 1) | (spreadBits3(z) << 2);
+}
+
+constexpr std::uint32_t compactBits3(std::uint64_t value) noexcept {
+    value &= 0x1249249249249249ull;
+    value = (value | (value >> 2)) & 0x10C30C30C30C30C3ull;
+    value = (value | (value >> 4)) & 0x100F00F00F00F00Full;
+    value = (value | (value >> 8)) & 0x1F0000FF0000FFull;
+    value = (value | (value >> 16)) & 0x1F00000000FFFFull;
+    value = (value | (value >> 32)) & 0x1FFFFF;
+    return static_cast<std::uint32_t>(value);
+}
+
+// A key that is unique across levels: a marker bit above the Morton code.
+constexpr std::uint64_t pointCloudNodeKey(std::uint32_t level, std::uint64_t code) noexcept {
+    return (std::uint64_t(1) << (3 * level)) | code;
+}
+
+template<typename T>
+class PointCloudBuilder {
+public:
+    using Point = Vector3<T>;
+    using Cell = std::array<std::uint32_t, 3>;
+
+    struct Node {
+        std::uint32_t level;
+        Cell cell;
+        std::uint64_t pointOffset;
+        std::uint32_t pointCount;
+    };
+
+    PointCloudBuilder(const PointCloudBuildSettings& settings, ThreadPool& pool, const std::string& temporaryBase)
+        : settings(settings), pool(pool), temporaryBase(temporaryBase) {}
+
+    // Removes the partitions a failed build left behind; finished ones are already gone.
+    ~PointCloudBuilder() {
+        std::error_code error;
+        for (std::uint64_t i = 0; i < temporaryCount.load(); ++i) {
+            std::filesystem::remove(temporaryBase + ".part" + std::to_string(i), error);
+        }
+    }
+
+    PointCloudBuilder(const PointCloudBuilder&) = delete;
+    PointCloudBuilder& operator=(const PointCloudBuilder&) = delete;
+
+    const PointCloudBuildSettings& settings;
+    ThreadPool& pool;
+    std::string temporaryBase;
+    double rootMin[3] = { 0, 0, 0 };
+    double rootSize = 1;
+    std::FILE* pointsOut = nullptr;
+    std::uint64_t pointsSize = 0;
+    std::vector<Node> nodes;
+    std::mutex writeMutex;
+    std::atomic<std::uint64_t> temporaryCount{0};
+
+    Cell quantize(const Point& point) const noexcept {
+        constexpr double cells = double(std::uint32_t(1) << pointCloudBits);
+        Cell cell;
+        for (int axis = 0; axis < 3; ++axis) {
+            double scaled = std::floor((double(point[axis]) - rootMin[axis]) / rootSize * cells);
+            cell[axis] = static_cast<std::uint32_t>(std::min(std::max(scaled, 0.0), cells - 1));
+        }
+        return cell;
+    }
+
+    std::string temporaryPath() {
+        return temporaryBase + ".part" + std::to_string(temporaryCount.fetch_add(1));
+    }
+
+    template<typename Fn>
+    void forEachBlock(const std::string& path, std::uint64_t count, Fn&& fn) const {
+        RandomAccessFile file(path);
+        std::size_t blockSize = std::max<std::size_t>(1, std::min<std::size_t>(settings.memoryBudget, std::size_t(1) << 20));
+        std::vector<Point> block(static_cast<std::size_t>(std::min<std::uint64_t>(blockSize, count)));
+        for (std::uint64_t first = 0; first < count; first += blockSize) {
+            std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(blockSize, count - first));
+            if (!file.readAt(block.data(), size * sizeof(Point), first * sizeof(Point))) {
+                throw std::runtime_error("Cannot read point file " + path);
+            }
+            fn(block.data(), size);
+        }
+    }
+
+    std::vector<Point> readPoints(const std::string& path, std::uint64_t count) const {
+        std::vector<Point> points(static_cast<std::size_t>(count));
+        RandomAccessFile file(path);
+        if (!file.readAt(points.data(), points.size() * sizeof(Point), 0)) {
+            throw std::runtime_error("Cannot read point file " + path);
+        }
+        return points;
+    }
+
+    void writeNode(std::uint32_t level, const Cell& cell, const std::vector<Point>& points) {
+        double size = rootSize / double(std::uint64_t(1) << level);
+        double center[3];
+        for (int axis = 0; axis < 3; ++axis) center[axis] = rootMin[axis] + (double(cell[axis]) + 0.5) * size;
+        std::vector<float> offsets(points.size() * 3);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            for (int axis = 0; axis < 3; ++axis) offsets[i * 3 + axis] = static_cast<float>(double(points[i][axis]) - center[axis]);
+        }
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::uint64_t offset = alignFileOffset(pointsSize);
+        static const unsigned char padding[fileAlignment] = {};
+        bool failed = std::fwrite(padding, 1, static_cast<std::size_t>(offset - pointsSize), pointsOut) != offset - pointsSize;
+        failed = failed || std::fwrite(offsets.data(), sizeof(float), offsets.size(), pointsOut) != offsets.size();
+        if (failed) throw std::runtime_error("Cannot write point cloud points");
+        pointsSize = offset + offsets.size() * sizeof(float);
+        nodes.push_back(Node{ level, cell, offset, static_cast<std::uint32_t>(points.size()) });
+    }
+
+    // Keeps at most one candidate per grid cell of the node, then thins the
+    // survivors evenly along their Morton order down to the node capacity.
+    std::vector<Point> subsample(const std::vector<Point>& candidates, std::uint32_t level) const {
+        unsigned remaining = pointCloudBits - level;
+        unsigned shift = remaining > pointCloudSampleBits ? remaining - pointCloudSampleBits : 0;
+        std::uint32_t mask = (std::uint32_t(1) << std::min(remaining, pointCloudSampleBits)) - 1;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> keyed(candidates.size());
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            Cell cell = quantize(candidates[i]);
+            keyed[i] = { morton3((cell[0] >> shift) & mask, (cell[1] >> shift) & mask, (cell[2] >> shift) & mask),
+                         static_cast<std::uint32_t>(i) };
+        }
+        std::sort(keyed.begin(), keyed.end());
+        keyed.erase(std::unique(keyed.begin(), keyed.end(),
+                                [](const auto& a, const auto& b) { return a.first == b.first; }), keyed.end());
+
+        std::size_t count = std::min(keyed.size(), settings.nodeCapacity);
+        std::vector<Point> sample(count);
+        for (std::size_t i = 0; i < count; ++i) sample[i] = candidates[keyed[i * keyed.size() / count].second];
+        return sample;
+    }
+
+    // Builds the subtree of points[first, last) in memory and returns the sample of its root.
+    std::vector<Point> buildSubtree(std::vector<Point>& points, std::size_t first, std::size_t last,
+                                    std::uint32_t level, const Cell& cell, bool parallel) {
+        std::size_t count = last - first;
+        if (count <= settings.nodeCapacity || level >= pointCloudMaxLevel) {
+            std::vector<Point> all(points.begin() + first, points.begin() + last);
+            writeNode(level, cell, all);
+            return all;
+        }
+
+        // Partition by z, then y, then x, so octant i is [bounds[i], bounds[i + 1]).
+        unsigned bit = pointCloudBits - 1 - level;
+        auto partition = [&](std::size_t from, std::size_t to, int axis) {
+            auto middle = std::partition(points.begin() + from, points.begin() + to,
+                                         [&](const Point& p) { return ((quantize(p)[axis] >> bit) & 1) == 0; });
+            return static_cast<std::size_t>(middle - points.begin());
+        };
+        std::size_t bounds[9];
+        bounds[0] = first;
+        bounds[8] = last;
+        bounds[4] = partition(first, last, 2);
+        for (std::size_t half = 0; half < 8; half += 4) bounds[half + 2] = partition(bounds[half], bounds[half + 4], 1);
+        for (std::size_t quarter = 0; quarter < 8; quarter += 2) bounds[quarter + 1] = partition(bounds[quarter], bounds[quarter + 2], 0);
+
+        std::vector<Point> childSamples[8];
+        auto buildChild = [&](std::size_t octant) {
+            if (bounds[octant] == bounds[octant + 1]) return;
+            Cell childCell = { cell[0] * 2 + std::uint32_t(octant & 1), cell[1] * 2 + std::uint32_t((octant >> 1) & 1),
+                               cell[2] * 2 + std::uint32_t(octant >> 2) };
+            childSamples[octant] = buildSubtree(points, bounds[octant], bounds[octant + 1], level + 1, childCell,
+                                                parallel && count > (std::size_t(1) << 18));
+        };
+        if (parallel) {
+            pool.parallelFor(0, 8, 1, [&](std::size_t from, std::size_t to) {
+                for (std::size_t octant = from; octant < to; ++octant) buildChild(octant);
+            });
+        } else {
+            for (std::size_t octant = 0; octant < 8; ++octant) buildChild(octant);
+        }
+
+        std::vector<Point> candidates;
+        for (const auto& childSample : childSamples) candidates.insert(candidates.end(), childSample.begin(), childSample.end());
+        std::vector<Point> sample = subsample(candidates, level);
+        writeNode(level, cell, sample);
+        return sample;
+    }
+
+    // Builds the subtree of the points in a file and returns the sample of its root.
+    std::vector<Point> buildFile(const std::string& path, std::uint64_t count, std::uint32_t level, const Cell& cell,
+                                 bool parallel, bool temporary) {
+        if (count <= settings.memoryBudget || level >= pointCloudMaxLevel) {
+            std::vector<Point> points = readPoints(path, count);
+            if (temporary) std::filesystem::remove(path);
+            return buildSubtree(points, 0, points.size(), level, cell, parallel);
+        }
+
+        // Count the points per cell d levels below this node and sum the
+        // counts up to a pyramid.
+        std::uint32_t depth = std::min<std::uint32_t>(5, pointCloudMaxLevel - level);
+        unsigned shift = pointCloudBits - level - depth;
+        std::uint32_t mask = (std::uint32_t(1) << depth) - 1;
+        auto cellCode = [&](const Point& point) {
+            Cell q = quantize(point);
+            return morton3((q[0] >> shift) & mask, (q[1] >> shift) & mask, (q[2] >> shift) & mask);
+        };
+        std::vector<std::vector<std::uint64_t>> counts(depth + 1);
+        for (std::uint32_t k = 0; k <= depth; ++k) counts[k].assign(std::size_t(1) << (3 * k), 0);
+        forEachBlock(path, count, [&](const Point* block, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) ++counts[depth][cellCode(block[i])];
+        });
+        for (std::uint32_t k = depth; k > 0; --k) {
+            for (std::size_t i = 0; i < counts[k].size(); ++i) counts[k - 1][i >> 3] += counts[k][i];
+        }
+
+        // Subtrees that fit in memory become chunks; the cells above them are built here.
+        struct Region {
+            std::uint32_t depth;
+            std::uint64_t code;
+        };
+        std::vector<Region> chunks;
+        std::vector<Region> above;
+        auto visit = [&](auto& self, std::uint32_t k, std::uint64_t code) -> void {
+            std::uint64_t regionCount = counts[k][code];
+            if (regionCount == 0) return;
+            if (k > 0 && (regionCount <= settings.memoryBudget || k == depth)) {
+                chunks.push_back({ k, code });
+                return;
+            }
+            above.push_back({ k, code });
+            for (std::uint64_t octant = 0; octant < 8; ++octant) self(self, k + 1, code * 8 + octant);
+        };
+        visit(visit, 0, 0);
+
+        // Distribute the points into one file per chunk.
+        std::vector<std::uint32_t> chunkOfCell(counts[depth].size());
+        std::vector<std::string> chunkPaths(chunks.size());
+        for (std::size_t c = 0; c < chunks.size(); ++c) {
+            unsigned spread = 3 * (depth - chunks[c].depth);
+            std::uint64_t begin = chunks[c].code << spread;
+            std::uint64_t end = (chunks[c].code + 1) << spread;
+            for (std::uint64_t i = begin; i < end; ++i) chunkOfCell[i] = static_cast<std::uint32_t>(c);
+            chunkPaths[c] = temporaryPath();
+        }
+        {
+            constexpr std::size_t bufferSize = 1 << 14;
+            std::vector<std::vector<Point>> buffers(chunks.size());
+            std::vector<char> started(chunks.size(), 0);
+            auto flush = [&](std::size_t c) {
+                // Truncate on the first flush, so a stale file of the same name is never appended to.
+                std::FILE* out = std::fopen(chunkPaths[c].c_str(), started[c] ? "ab" : "wb");
+                started[c] = 1;
+                bool failed = out == nullptr;
+                failed = failed || std::fwrite(buffers[c].data(), sizeof(Point), buffers[c].size(), out) != buffers[c].size();
+                failed = (out != nullptr && std::fclose(out) != 0) || failed;
+                if (failed) throw std::runtime_error("Cannot write point partition " + chunkPaths[c]);
+                buffers[c].clear();
+            };
+            forEachBlock(path, count, [&](const Point* block, std::size_t size) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    std::uint32_t c = chunkOfCell[cellCode(block[i])];
+                    buffers[c].push_back(block[i]);
+                    if (buffers[c].size() == bufferSize) flush(c);
+                }
+            });
+            for (std::size_t c = 0; c < chunks.size(); ++c) {
+                if (!buffers[c].empty()) flush(c);
+            }
+        }
+        if (temporary) std::filesystem::remove(path);
+
+        auto regionCell = [&](const Region& region) {
+            std::uint32_t local[3] = { compactBits3(region.code), compactBits3(region.code >> 1), compactBits3(region.code >> 2) };
+            return Cell{ (cell[0] << region.depth) | local[0], (cell[1] << region.depth) | local[1], (cell[2] << region.depth) | local[2] };
+        };
+        std::vector<std::vector<Point>> chunkSamples(chunks.size());
+        auto buildChunk = [&](std::size_t c) {
+            chunkSamples[c] = buildFile(chunkPaths[c], counts[chunks[c].depth][chunks[c].code], level + chunks[c].depth,
+                                        regionCell(chunks[c]), false, true);
+        };
+        if (parallel) {
+            pool.parallelFor(0, chunks.size(), 1, [&](std::size_t from, std::size_t to) {
+                for (std::size_t c = from; c < to; ++c) buildChunk(c);
+            });
+        } else {
+            for (std::size_t c = 0; c < chunks.size(); ++c) buildChunk(c);
+        }
+
+        // Build the cells above the chunks bottom up from their children's samples.
+        std::map<std::pair<std::uint32_t, std::uint64_t>, std::vector<Point>> samples;
+        for (std::size_t c = 0; c < chunks.size(); ++c) samples[{ chunks[c].depth, chunks[c].code }] = std::move(chunkSamples[c]);
+        for (auto region = above.rbegin(); region != above.rend(); ++region) {
+            std::vector<Point> candidates;
+            for (std::uint64_t octant = 0; octant < 8; ++octant) {
+                auto child = samples.find({ region->depth + 1, region->code * 8 + octant });
+                if (child == samples.end()) continue;
+                candidates.insert(candidates.end(), child->second.begin(), child->second.end());
+                samples.erase(child);
+            }
+            std::vector<Point> sample = subsample(candidates, level + region->depth);
+            writeNode(level + region->depth, regionCell(*region), sample);
+            samples[{ region->depth, region->code }] = std::move(sample);
+        }
+        return std::move(samples[{ 0, 0 }]);
+    }
+};
+
+} // namespace detail
+
+inline std::uint32_t PointCloudNode::childCount() const noexcept {
+    std::uint32_t count = 0;
+    for (std::uint32_t mask = childMask; mask != 0; mask &= mask - 1) ++count;
+    return count;
+}
+
+template<typename T>
+void PointCloudOctree<T>::build(const std::string& inputPath, const std::string& outputBase, ThreadPool& pool,
+                                const PointCloudBuildSettings& settings) {
+    using Point = Vector3<T>;
+    static_assert(sizeof(Point) == 3 * sizeof(T), "Vector3 must be packed");
+    if (settings.nodeCapacity == 0 || settings.memoryBudget < settings.nodeCapacity) {
+        throw std::invalid_argument("Point cloud memory budget must hold at least one node");
+    }
+
+    std::error_code error;
+    std::uintmax_t inputSize = std::filesystem::file_size(inputPath, error);
+    if (error || inputSize % sizeof(Point) != 0) throw std::runtime_error("Invalid point file " + inputPath);
+    std::uint64_t count = inputSize / sizeof(Point);
+
+    std::string temporaryBase = settings.temporaryDirectory.empty()
+        ? outputBase
+        : (std::filesystem::path(settings.temporaryDirectory) / std::filesystem::path(outputBase).filename()).string();
+    detail::PointCloudBuilder<T> builder(settings, pool, temporaryBase);
+
+    // Bounds pass; the root is the cube around the bounds.
+    double boundsMin[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+    double boundsMax[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+    std::mutex boundsMutex;
+    builder.forEachBlock(inputPath, count, [&](const Point* block, std::size_t size) {
+        pool.parallelFor(0, size, 1 << 16, [&](std::size_t first, std::size_t last) {
+            // The shared bounds are only touched under the lock below.
+            double localMin[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+            double localMax[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+            for (std::size_t i = first; i < last; ++i) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    // std::min and std::max skip NaN, so the bounds alone do not show it.
+                    double value = double(block[i][axis]);
+                    if (!std::isfinite(value)) throw std::runtime_error("Point file contains non-finite points: " + inputPath);
+                    localMin[axis] = std::min(localMin[axis], value);
+                    localMax[axis] = std::max(localMax[axis], value);
+                }
+            }
+            std::lock_guard<std::mutex> lock(boundsMutex);
+            for (int axis = 0; axis < 3; ++axis) {
+                boundsMin[axis] = std::min(boundsMin[axis], localMin[axis]);
+                boundsMax[axis] = std::max(boundsMax[axis], localMax[axis]);
+            }
+        });
+    });
+    PointCloudOctreeHeader header = {};
+    double extent = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (count == 0) boundsMin[axis] = boundsMax[axis] = 0;
+        extent = std::max(extent, boundsMax[axis] - boundsMin[axis]);
+    }
+    if (!(extent > 0)) extent = 1;
+    if (!std::isfinite(extent)) throw std::runtime_error("Point file extent overflows: " + inputPath);
+    for (int axis = 0; axis < 3; ++axis) {
+        header.center[axis] = (boundsMin[axis] + boundsMax[axis]) * 0.5;
+        builder.rootMin[axis] = header.center[axis] - extent * 0.5;
+    }
+    header.halfSize = extent * 0.5;
+    builder.rootSize = extent;
+
+    // Points are appended to the .rfxpoints file as nodes are finished.
+    std::string pointsPath = outputBase + ".rfxpoints";
+    std::string pointsTemporary = pointsPath + ".tmp";
+    builder.pointsOut = std::fopen(pointsTemporary.c_str(), "wb");
+    if (builder.pointsOut == nullptr) throw std::runtime_error("Cannot write " + pointsPath);
+    try {
+        if (count > 0) builder.buildFile(inputPath, count, 0, { 0, 0, 0 }, true, false);
+    } catch (...) {
+        std::fclose(builder.pointsOut);
+        std::filesystem::remove(pointsTemporary, error);
+        throw;
+    }
+    bool failed = std::fclose(builder.pointsOut) != 0;
+    if (!failed) std::filesystem::rename(pointsTemporary, pointsPath, error);
+    if (failed || error) {
+        std::filesystem::remove(pointsTemporary, error);
+        throw std::runtime_error("Cannot write " + pointsPath);
+    }
+
+    // Store the nodes level by level in Morton order, so siblings are adjacent.
+    auto& built = builder.nodes;
+    auto code = [](const typename detail::PointCloudBuilder<T>::Node& node) {
+        return detail::morton3(node.cell[0], node.cell[1], node.cell[2]);
+    };
+    std::sort(built.begin(), built.end(), [&](const auto& a, const auto& b) {
+        return a.level != b.level ? a.level < b.level : code(a) < code(b);
+    });
+    std::unordered_map<std::uint64_t, std::uint32_t> indexOf;
+    indexOf.reserve(built.size());
+    for (std::size_t i = 0; i < built.size(); ++i) {
+        indexOf[detail::pointCloudNodeKey(built[i].level, code(built[i]))] = static_cast<std::uint32_t>(i);
+    }
+    std::vector<PointCloudNode> nodes(built.size());
+    for (std::size_t i = 0; i < built.size(); ++i) {
+        const auto& source = built[i];
+        PointCloudNode& node = nodes[i];
+        double size = builder.rootSize / double(std::uint64_t(1) << source.level);
+        for (int axis = 0; axis < 3; ++axis) node.center[axis] = builder.rootMin[axis] + (double(source.cell[axis]) + 0.5) * size;
+        node.halfSize = size * 0.5;
+        node.pointOffset = source.pointOffset;
+        node.pointCount = source.pointCount;
+        node.level = source.level;
+        node.firstChild = 0;
+        node.childMask = 0;
+        for (std::uint32_t octant = 0; octant < 8; ++octant) {
+            auto child = indexOf.find(detail::pointCloudNodeKey(source.level + 1, code(source) * 8 + octant));
+            if (child == indexOf.end()) continue;
+            if (node.childMask == 0) node.firstChild = child->second;
+            node.childMask |= 1u << octant;
+        }
+        header.maxLevel = std::max(header.maxLevel, source.level);
+    }
+
+    std::memcpy(header.magic, detail::pointCloudMagic, sizeof(header.magic));
+    header.version = version;
+    header.byteOrder = detail::fileByteOrder;
+    header.nodeCount = static_cast<std::uint32_t>(nodes.size());
+    header.pointCount = count;
+    header.pointsSize = builder.pointsSize;
+    header.nodesOffset = detail::alignFileOffset(sizeof(header));
+    header.checksum = detail::checksum64(reinterpret_cast<const unsigned char*>(nodes.data()), nodes.size() * sizeof(PointCloudNode));
+    std::vector<unsigned char> bytes(static_cast<std::size_t>(header.nodesOffset + nodes.size() * sizeof(PointCloudNode)));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!nodes.empty()) std::memcpy(bytes.data() + header.nodesOffset, nodes.data(), nodes.size() * sizeof(PointCloudNode));
+    if (!detail::writeFileAtomically(outputBase + ".rfxoctree", bytes.data(), bytes.size())) {
+        throw std::runtime_error("Cannot write " + outputBase + ".rfxoctree");
+    }
+}
+
+template<typename T>
+PointCloudOctree<T>::PointCloudOctree(const std::string& base) {
+    std::string path = base + ".rfxoctree";
+    auto fail = [&path](const char* problem) {
+        throw std::runtime_error("Invalid point cloud octree " + path + ": " + problem);
+    };
+    if (!table.open(path)) throw std::runtime_error("Cannot map " + path);
+    if (table.size() < sizeof(PointCloudOctreeHeader)) fail("file is too small");
+    header = reinterpret_cast<const PointCloudOctreeHeader*>(table.data());
+    if (std::memcmp(header->magic, detail::pointCloudMagic, sizeof(header->magic)) != 0) fail("not an octree");
+    if (header->version != version) fail("unsupported version");
+    if (header->byteOrder != detail::fileByteOrder) fail("different byte order");
+    std::uint64_t tableSize = std::uint64_t(header->nodeCount) * sizeof(PointCloudNode);
+    if (header->nodesOffset % detail::fileAlignment != 0 || header->nodesOffset > table.size() ||
+        tableSize > table.size() - header->nodesOffset) {
+        fail("invalid layout");
+    }
+    nodes = reinterpret_cast<const PointCloudNode*>(table.data() + header->nodesOffset);
+    if (detail::checksum64(table.data() + header->nodesOffset, static_cast<std::size_t>(tableSize)) != header->checksum) {
+        fail("checksum mismatch");
+    }
+
+    if (!pointData.open(base + ".rfxpoints")) throw std::runtime_error("Cannot map " + base + ".rfxpoints");
+    if (pointData.size() != header->pointsSize) fail("points file does not match");
+    for (std::uint32_t i = 0; i < header->nodeCount; ++i) {
+        const PointCloudNode& node = nodes[i];
+        std::uint64_t size = std::uint64_t(node.pointCount) * 3 * sizeof(float);
+        if (node.pointOffset % alignof(float) != 0 || node.pointOffset > pointData.size() || size > pointData.size() - node.pointOffset ||
+            (node.childMask != 0 && (node.firstChild <= i || std::uint64_t(node.firstChild) + node.childCount() > header->nodeCount))) {
+            fail("invalid layout");
+        }
+    }
+    nodeTotal = header->nodeCount;
+}
+
+template<typename T>
+std::uint64_t PointCloudOctree<T>::pointCount() const noexcept {
+    return header != nullptr ? header->pointCount : 0;
+}
+
+template<typename T>
+const PointCloudNode& PointCloudOctree<T>::node(std::size_t index) const {
+    if (index >= nodeTotal) throw std::out_of_range("Point cloud node index out of range");
+    return nodes[index];
+}
+
+template<typename T>
+AABB<T> PointCloudOctree<T>::nodeBounds(std::size_t index) const {
+    const PointCloudNode& n = node(index);
+    Vector3<T> center(static_cast<T>(n.center[0]), static_cast<T>(n.center[1]), static_cast<T>(n.center[2]));
+    Vector3<T> extent(static_cast<T>(n.halfSize), static_cast<T>(n.halfSize), static_cast<T>(n.halfSize));
+    return AABB<T>(center - extent, center + extent);
+}
+
+template<typename T>
+const float* PointCloudOctree<T>::points(std::size_t index) const {
+    return reinterpret_cast<const float*>(pointData.data() + node(index).pointOffset);
+}
+
+template<typename T>
+T PointCloudOctree<T>::projectedSize(const PointCloudNode& n, const Vector3<T>& cameraPosition, T pixelsPerUnit) const noexcept {
+    T dx = static_cast<T>(n.center[0] - double(cameraPosition.x));
+    T dy = static_cast<T>(n.center[1] - double(cameraPosition.y));
+    T dz = static_cast<T>(n.center[2] - double(cameraPosition.z));
+    T distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    T radius = static_cast<T>(n.halfSize * 1.7320508075688772);
+    if (distance <= radius) return std::numeric_limits<T>::max();
+    return radius / distance * pixelsPerUnit;
+}
+
+template<typename T>
+std::uint64_t PointCloudOctree<T>::select(const Vector3<T>& cameraPosition, const Frustum<T>& frustum, T pixelsPerUnit,
+                                          std::uint64_t pointBudget, T minNodePixels, std::vector<std::uint32_t>& selected) const {
+    selected.clear();
+    if (nodeTotal == 0 || nodes[0].pointCount > pointBudget || !frustum.intersects(nodeBounds(0))) return 0;
+
+    // Refine the largest node on screen first; a node is replaced by its
+    // visible children only if their points fit in the remaining budget.
+    std::priority_queue<std::pair<T, std::uint32_t>> queue;
+    queue.push({ projectedSize(nodes[0], cameraPosition, pixelsPerUnit), 0 });
+    std::uint64_t total = nodes[0].pointCount;
+    std::uint32_t visible[8];
+    while (!queue.empty()) {
+        auto [size, index] = queue.top();
+        queue.pop();
+        const PointCloudNode& n = nodes[index];
+
+        bool refined = false;
+        if (n.childMask != 0 && size >= minNodePixels) {
+            std::uint32_t visibleCount = 0;
+            std::uint64_t childPoints = 0;
+            for (std::uint32_t child = n.firstChild; child < n.firstChild + n.childCount(); ++child) {
+                if (!frustum.intersects(nodeBounds(child))) continue;
+                visible[visibleCount++] = child;
+                childPoints += nodes[child].pointCount;
+            }
+            if (total - n.pointCount + childPoints <= pointBudget) {
+                total = total - n.pointCount + childPoints;
+                for (std::uint32_t i = 0; i < visibleCount; ++i) {
+                    queue.push({ projectedSize(nodes[visible[i]], cameraPosition, pixelsPerUnit), visible[i] });
+                }
+                refined = true;
+            }
+        }
+        if (!refined) selected.push_back(index);
+    }
+    return total;
+}
+
+#endif // POINTCLOUDOCTREE_INL
@@ -0,0 +1,276 @@
+#ifndef SCENECACHE_H
+#define SCENECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "../core/BinaryFile.h"
+#include "../core/MappedFile.h"
+#include "SceneLoader.h"
+
+/**
+ * @brief Identifies the source a scene cache was built from.
+ *
+ * A cache is stale when any field differs from the stamp of the current
+ * source file.
+ */
+struct SceneCacheStamp {
+    std::uint64_t sourceSize = 0; ///< Size of the .rfxscene file in bytes.
+    std::int64_t sourceTime = 0;  ///< Last write time of the .rfxscene file.
+    std::uint64_t boundsKey = 0;  ///< Caller-defined version of the model bounds.
+
+    /**
+     * @brief Gets the stamp of a source file.
+     *
+     * @param sourcePath Path of the .rfxscene file.
+     * @param boundsKey Caller-defined version of the model bounds.
+     * @return The stamp.
+     * @throws std::runtime_error If the file does not exist.
+     */
+    static SceneCacheStamp of(const std::string& sourcePath, std::uint64_t boundsKey = 0);
+};
+
+/**
+ * @brief Header at the start of a .rfxcache file.
+ *
+ * All offsets are in bytes from the start of the file and aligned to 64
+ * bytes. Per-object arrays are stored as component streams of objectCount
+ * values, streamStride bytes apart: positions (x, y, z), rotations
+ * (x, y, z, w), scales (x, y, z), world bounds minimum and maximum (x, y, z)
+ * and bounding spheres (center x, y, z, radius). Values are stored in the
+ * byte order of the machine that wrote the file.
+ */
+struct SceneCacheHeader {
+    char magic[8];                 ///< "RFXCACHE".
+    std::uint32_t version;         ///< Format version.
+    std::uint32_t byteOrder;       ///< 0x01020304 as written by the producer.
+    std::uint32_t scalarSize;      ///< Size of one stored scalar.
+    std::uint32_t objectCount;     ///< Number of objects.
+    std::uint32_t nodeCount;       ///< Number of BVH nodes.
+    std::uint32_t nameLength;      ///< Length of the scene name.
+    SceneCacheStamp stamp;         ///< Source the cache was built from.
+    std::uint64_t fileSize;        ///< Size of the whole file.
+    std::uint64_t checksum;        ///< Checksum of everything after the header.
+    std::uint64_t streamStride;    ///< Distance between component streams.
+    std::uint64_t nameOffset;      ///< Offset of the scene name within the strings.
+    std::uint64_t stringsSize;     ///< Size of the strings section.
+    std::uint64_t positionsOffset; ///< Offset of the position streams.
+    std::uint64_t rotationsOffset; ///< Offset of the rotation streams.
+    std::uint64_t scalesOffset;    ///< Offset of the scale streams.
+    std::uint64_t boundsMinOffset; ///< Offset of the world bounds minimum streams.
+    std::uint64_t boundsMaxOffset; ///< Offset of the world bounds maximum streams.
+    std::uint64_t spheresOffset;   ///< Offset of the bounding sphere streams.
+    std::uint64_t nodesOffset;     ///< Offset of the SceneBvhNode array.
+    std::uint64_t bvhObjectsOffset; ///< Offset of the object indices referenced by BVH leaves.
+    std::uint64_t objectsOffset;   ///< Offset of the SceneObjectInfo array.
+    std::uint64_t stringsOffset;   ///< Offset of the object names and model paths.
+};
+
+/**
+ * @brief A node of the bounding volume hierarchy stored in a scene cache.
+ *
+ * Nodes are stored depth first: the left child of an inner node directly
+ * follows it, the right child is at index offset. A leaf covers the objects
+ * bvhObjects()[offset] to bvhObjects()[offset + count - 1].
+ *
+ * @tparam T Type of the bounds.
+ */
+template<typename T>
+struct SceneBvhNode {
+    T boundsMin[3];       ///< Minimum corner of the node bounds.
+    std::uint32_t offset; ///< Right child of an inner node, first object of a leaf.
+    T boundsMax[3];       ///< Maximum corner of the node bounds.
+    std::uint32_t count;  ///< Number of objects of a leaf, zero for inner nodes.
+
+    /**
+     * @brief Checks if the node is a leaf.
+     *
+     * @return True if the node references objects.
+     */
+    bool isLeaf() const noexcept { return count != 0; }
+};
+
+/**
+ * @brief A binary scene cache that is used in place through a memory mapping.
+ *
+ * The cache stores what a scene needs at startup in the layout it is used
+ * in: SoA transforms, world AABBs and bounding spheres, and a BVH over the
+ * bounds. Opening a cache maps the file and validates its header and the
+ * ranges of its BVH, so loading costs little more than the page faults of
+ * the data that is actually touched.
+ * Files are written with the producer's byte order and scalar size and
+ * are rejected elsewhere; use loadOrBuild() to rebuild such caches.
+ *
+ * @tparam T Type of the stored scalars.
+ */
+template<typename T>
+class SceneCache {
+public:
+    static_assert(std::is_floating_point<T>::value, "SceneCache requires a floating-point type");
+
+    /**
+     * @brief Returns the local bounds of a model path.
+     */
+    using ModelBounds = std::function<AABB<T>(std::string_view model)>;
+
+    static constexpr std::uint32_t version = 1; ///< The current format version.
+
+    SceneCache() = default;
+
+    /**
+     * @brief Builds a cache file from a scene.
+     *
+     * The file is written next to the target and renamed into place, so a
+     * concurrent reader never sees a partial cache.
+     *
+     * @param path Path of the cache file.
+     * @param scene The scene.
+     * @param modelBounds Local bounds per model; a unit cube around the origin if empty.
+     * @param stamp Stamp of the source the scene was loaded from.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void write(const std::string& path, const SceneData<T>& scene,
+                      const ModelBounds& modelBounds = ModelBounds(), const SceneCacheStamp& stamp = SceneCacheStamp());
+
+    /**
+     * @brief Builds the bytes of a cache file in memory.
+     *
+     * @param scene The scene.
+     * @param modelBounds Local bounds per model; a unit cube around the origin if empty.
+     * @param stamp Stamp of the source the scene was loaded from.
+     * @return The cache image, as write() stores it.
+     * @throws std::runtime_error If the scene has too many objects.
+     */
+    static std::vector<unsigned char> serialize(const SceneData<T>& scene, const ModelBounds& modelBounds = ModelBounds(),
+                                                const SceneCacheStamp& stamp = SceneCacheStamp());
+
+    /**
+     * @brief Uses a cache image that is already in memory.
+     *
+     * @param data The image; must stay valid and unchanged while the cache is used, and be aligned to 8 bytes.
+     * @param size Size of the image in bytes.
+     * @param verifyChecksum Whether to verify the checksum.
+     * @return The cache.
+     * @throws std::runtime_error If the image is misaligned or not a valid cache.
+     */
+    static SceneCache view(const void* data, std::size_t size, bool verifyChecksum = true);
+
+    /**
+     * @brief Maps a cache file.
+     *
+     * @param path Path of the cache file.
+     * @param verifyChecksum Whether to verify the checksum, which reads the whole file.
+     * @return The cache.
+     * @throws std::runtime_error If the file cannot be mapped or is not a valid cache.
+     */
+    static SceneCache open(const std::string& path, bool verifyChecksum = true);
+
+    /**
+     * @brief Maps a cache file, rebuilding it first if it is missing or stale.
+     *
+     * The cache is rebuilt when it cannot be read, has a different version,
+     * byte order or scalar type, fails its checksum, or was built from a
+     * source with a different stamp.
+     *
+     * @param sourcePath Path of the .rfxscene file.
+     * @param cachePath Path of the cache file.
+     * @param modelBounds Local bounds per model; a unit cube around the origin if empty.
+     * @param boundsKey Version of modelBounds; change it to invalidate caches built with other bounds.
+     * @return The cache.
+     * @throws std::runtime_error If the scene cannot be loaded or the cache cannot be written.
+     */
+    static SceneCache loadOrBuild(const std::string& sourcePath, const std::string& cachePath,
+                                  const ModelBounds& modelBounds = ModelBounds(), std::uint64_t boundsKey = 0);
+
+    bool isOpen() const noexcept { return info != nullptr; }
+
+    /**
+     * @brief Gets the header.
+     *
+     * @return The header; all zero while the cache is not open.
+     */
+    const SceneCacheHeader& header() const noexcept;
+
+    /**
+     * @brief Gets the number of objects.
+     *
+     * @return The number of objects.
+     */
+    std::size_t size() const noexcept { return info != nullptr ? info->objectCount : 0; }
+
+    /**
+     * @brief Gets the name of the scene.
+     *
+     * @return The name; valid while the cache is open.
+     */
+    std::string_view name() const noexcept;
+
+    std::string_view objectName(std::size_t index) const;
+    std::string_view objectModel(std::size_t index) const;
+
+    /**
+     * @brief Gets one component stream of the positions.
+     *
+     * @param component 0 for x, 1 for y, 2 for z.
+     * @return size() values, or null while the cache is not open.
+     */
+    const T* positions(std::size_t component) const noexcept { return stream(header().positionsOffset, component); }
+
+    /**
+     * @brief Gets one component stream of the rotations.
+     *
+     * @param component 0 for x, 1 for y, 2 for z, 3 for w.
+     * @return size() values, or null while the cache is not open.
+     */
+    const T* rotations(std::size_t component) const noexcept { return stream(header().rotationsOffset, component); }
+
+    const T* scales(std::size_t component) const noexcept { return stream(header().scalesOffset, component); }
+    const T* boundsMin(std::size_t component) const noexcept { return stream(header().boundsMinOffset, component); }
+    const T* boundsMax(std::size_t component) const noexcept { return stream(header().boundsMaxOffset, component); }
+
+    /**
+     * @brief Gets one component stream of the bounding spheres.
+     *
+     * @param component 0 to 2 for the center, 3 for the radius.
+     * @return size() values, or null while the cache is not open.
+     */
+    const T* spheres(std::size_t component) const noexcept { return stream(header().spheresOffset, component); }
+
+    std::size_t nodeCount() const noexcept { return info != nullptr ? info->nodeCount : 0; }
+    const SceneBvhNode<T>* nodes() const noexcept;
+    const std::uint32_t* bvhObjects() const noexcept;
+
+    Transform<T> transform(std::size_t index) const;
+    AABB<T> worldBounds(std::size_t index) const;
+    Sphere<T> boundingSphere(std::size_t index) const;
+
+    /**
+     * @brief Calls a function for every object whose world bounds intersect a frustum.
+     *
+     * @param frustum The frustum.
+     * @param fn Callable invoked as fn(std::size_t index).
+     */
+    template<typename Fn>
+    void forEachVisible(const Frustum<T>& frustum, Fn&& fn) const;
+
+private:
+    MappedFile file;
+    const unsigned char* bytes = nullptr;
+    const SceneCacheHeader* info = nullptr;
+
+    const T* stream(std::uint64_t offset, std::size_t component) const noexcept;
+    static const char* validate(const unsigned char* data, std::size_t size, bool verifyChecksum, const SceneCacheStamp* stamp);
+    static void buildBvh(const std::vector<T> (&boundsMin)[3], const std::vector<T> (&boundsMax)[3],
+                         std::vector<SceneBvhNode<T>>& nodes, std::vector<std::uint32_t>& order);
+};
+
+// Commonly used types
+using SceneCachef = SceneCache<float>;
+
+#include "SceneCache.inl"
+
+#endif // SCENECACHE_H
@@ -0,0 +1,433 @@
+#ifndef SCENECACHE_INL
+#define SCENECACHE_INL
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+static_assert(sizeof(SceneCacheHeader) == 176, "SceneCacheHeader must not contain padding");
+static_assert(std::is_trivially_copyable<SceneObjectInfo>::value, "SceneObjectInfo is stored as raw bytes");
+
+namespace detail {
+
+constexpr char sceneCacheMagic[8] = { 'R', 'F', 'X', 'C', 'A', 'C', 'H', 'E' };
+constexpr std::size_t sceneBvhLeafSize = 4;
+// Traversal stack of SceneCache::forEachVisible(); validate() rejects BVHs
+// that would overflow it. Median splits stay far below it.
+constexpr std::size_t sceneBvhStackSize = 64;
+
+} // namespace detail
+
+inline SceneCacheStamp SceneCacheStamp::of(const std::string& sourcePath, std::uint64_t boundsKey) {
+    std::error_code error;
+    std::uintmax_t size = std::filesystem::file_size(sourcePath, error);
+    if (error) throw std::runtime_error("Cannot read scene file " + sourcePath);
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(sourcePath, error);
+    if (error) throw std::runtime_error("Cannot read scene file " + sourcePath);
+
+    SceneCacheStamp stamp;
+    stamp.sourceSize = static_cast<std::uint64_t>(size);
+    stamp.sourceTime = static_cast<std::int64_t>(time.time_since_epoch().count());
+    stamp.boundsKey = boundsKey;
+    return stamp;
+}
+
+template<typename T>
+void SceneCache<T>::buildBvh(const std::vector<T> (&boundsMin)[3], const std::vector<T> (&boundsMax)[3],
+                             std::vector<SceneBvhNode<T>>& nodes, std::vector<std::uint32_t>& order) {
+    std::size_t count = boundsMin[0].size();
+    order.resize(count);
+    for (std::size_t i = 0; i < count; ++i) order[i] = static_cast<std::uint32_t>(i);
+    nodes.clear();
+    if (count == 0) return;
+    nodes.reserve(2 * ((count + detail::sceneBvhLeafSize - 1) / detail::sceneBvhLeafSize));
+
+    // Median splits along the largest centroid extent; every split halves
+    // the range, so the recursion depth is logarithmic.
+    auto centroid = [&](std::uint32_t object, std::size_t axis) {
+        return boundsMin[axis][object] + boundsMax[axis][object];
+    };
+    auto build = [&](auto& self, std::uint32_t first, std::uint32_t objectCount) -> void {
+        std::size_t index = nodes.size();
+        nodes.emplace_back();
+        SceneBvhNode<T> node;
+        T centroidMin[3];
+        T centroidMax[3];
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            node.boundsMin[axis] = std::numeric_limits<T>::max();
+            node.boundsMax[axis] = std::numeric_limits<T>::lowest();
+            centroidMin[axis] = std::numeric_limits<T>::max();
+            centroidMax[axis] = std::numeric_limits<T>::lowest();
+            for (std::uint32_t i = first; i < first + objectCount; ++i) {
+                std::uint32_t object = order[i];
+                node.boundsMin[axis] = std::min(node.boundsMin[axis], boundsMin[axis][object]);
+                node.boundsMax[axis] = std::max(node.boundsMax[axis], boundsMax[axis][object]);
+                centroidMin[axis] = std::min(centroidMin[axis], centroid(object, axis));
+                centroidMax[axis] = std::max(centroidMax[axis], centroid(object, axis));
+            }
+        }
+
+        if (objectCount <= detail::sceneBvhLeafSize) {
+            node.offset = first;
+            node.count = objectCount;
+            nodes[index] = node;
+            return;
+        }
+
+        std::size_t axis = 0;
+        for (std::size_t a = 1; a < 3; ++a) {
+            if (centroidMax[a] - centroidMin[a] > centroidMax[axis] - centroidMin[axis]) axis = a;
+        }
+        std::uint32_t half = objectCount / 2;
+        std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + objectCount,
+                         [&](std::uint32_t a, std::uint32_t b) { return centroid(a, axis) < centroid(b, axis); });
+
+        self(self, first, half);
+        node.offset = static_cast<std::uint32_t>(nodes.size());
+        node.count = 0;
+        self(self, first + half, objectCount - half);
+        nodes[index] = node;
+    };
+    build(build, 0, static_cast<std::uint32_t>(count));
+}
+
+template<typename T>
+std::vector<unsigned char> SceneCache<T>::serialize(const SceneData<T>& scene, const ModelBounds& modelBounds,
+                                                    const SceneCacheStamp& stamp) {
+    std::size_t count = scene.size();
+    if (count > std::numeric_limits<std::uint32_t>::max() / 2) {
+        throw std::runtime_error("Scene has too many objects for a cache");
+    }
+
+    // World bounds and spheres of the local model bounds.
+    std::vector<T> boundsMin[3];
+    std::vector<T> boundsMax[3];
+    std::vector<T> spheres[4];
+    for (auto& component : boundsMin) component.resize(count);
+    for (auto& component : boundsMax) component.resize(count);
+    for (auto& component : spheres) component.resize(count);
+    const AABB<T> unitBounds(Vector3<T>(T(-0.5), T(-0.5), T(-0.5)), Vector3<T>(T(0.5), T(0.5), T(0.5)));
+    for (std::size_t i = 0; i < count; ++i) {
+        Transform<T> transform = scene.transforms.get(i);
+        AABB<T> local = modelBounds ? modelBounds(scene.objectModel(i)) : unitBounds;
+        AABB<T> world = local.transformed(transform.toMatrix());
+        Vector3<T> center = transform.transformPoint((local.min + local.max) * T(0.5));
+        T scale = std::max({ std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z) });
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            boundsMin[axis][i] = world.min[axis];
+            boundsMax[axis][i] = world.max[axis];
+            spheres[axis][i] = center[axis];
+        }
+        spheres[3][i] = (local.max - local.min).length() * T(0.5) * scale;
+    }
+
+    std::vector<SceneBvhNode<T>> nodes;
+    std::vector<std::uint32_t> order;
+    buildBvh(boundsMin, boundsMax, nodes, order);
+
+    // Lay out the sections.
+    SceneCacheHeader header = {};
+    std::memcpy(header.magic, detail::sceneCacheMagic, sizeof(header.magic));
+    header.version = version;
+    header.byteOrder = detail::fileByteOrder;
+    header.scalarSize = sizeof(T);
+    header.objectCount = static_cast<std::uint32_t>(count);
+    header.nodeCount = static_cast<std::uint32_t>(nodes.size());
+    header.nameLength = static_cast<std::uint32_t>(std::min<std::size_t>(scene.name.size(), std::numeric_limits<std::uint32_t>::max()));
+    header.stamp = stamp;
+    header.streamStride = detail::alignFileOffset(count * sizeof(T));
+    header.nameOffset = scene.strings.size();
+    header.stringsSize = scene.strings.size() + header.nameLength;
+
+    std::uint64_t offset = detail::alignFileOffset(sizeof(SceneCacheHeader));
+    auto section = [&offset](std::uint64_t size) {
+        std::uint64_t start = offset;
+        offset = detail::alignFileOffset(offset + size);
+        return start;
+    };
+    header.positionsOffset = section(3 * header.streamStride);
+    header.rotationsOffset = section(4 * header.streamStride);
+    header.scalesOffset = section(3 * header.streamStride);
+    header.boundsMinOffset = section(3 * header.streamStride);
+    header.boundsMaxOffset = section(3 * header.streamStride);
+    header.spheresOffset = section(4 * header.streamStride);
+    header.nodesOffset = section(nodes.size() * sizeof(SceneBvhNode<T>));
+    header.bvhObjectsOffset = section(order.size() * sizeof(std::uint32_t));
+    header.objectsOffset = section(count * sizeof(SceneObjectInfo));
+    header.stringsOffset = section(header.stringsSize);
+    header.fileSize = offset;
+
+    std::vector<unsigned char> bytes(static_cast<std::size_t>(header.fileSize));
+    auto put = [&bytes](std::uint64_t at, const void* data, std::size_t size) {
+        if (size != 0) std::memcpy(bytes.data() + at, data, size);
+    };
+    auto putStreams = [&](std::uint64_t at, const T* const* components, std::size_t componentCount) {
+        for (std::size_t c = 0; c < componentCount; ++c) put(at + c * header.streamStride, components[c], count * sizeof(T));
+    };
+    const T* positionStreams[3];
+    const T* scaleStreams[3];
+    const T* rotationStreams[4];
+    const T* minStreams[3];
+    const T* maxStreams[3];
+    const T* sphereStreams[4];
+    for (std::size_t c = 0; c < 3; ++c) {
+        positionStreams[c] = scene.transforms.positions.component(c);
+        scaleStreams[c] = scene.transforms.scales.component(c);
+        minStreams[c] = boundsMin[c].data();
+        maxStreams[c] = boundsMax[c].data();
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+        rotationStreams[c] = scene.transforms.rotations.component(c);
+        sphereStreams[c] = spheres[c].data();
+    }
+    putStreams(header.positionsOffset, positionStreams, 3);
+    putStreams(header.rotationsOffset, rotationStreams, 4);
+    putStreams(header.scalesOffset, scaleStreams, 3);
+    putStreams(header.boundsMinOffset, minStreams, 3);
+    putStreams(header.boundsMaxOffset, maxStreams, 3);
+    putStreams(header.spheresOffset, sphereStreams, 4);
+    put(header.nodesOffset, nodes.data(), nodes.size() * sizeof(SceneBvhNode<T>));
+    put(header.bvhObjectsOffset, order.data(), order.size() * sizeof(std::uint32_t));
+    put(header.objectsOffset, scene.objects.data(), count * sizeof(SceneObjectInfo));
+    put(header.stringsOffset, scene.strings.data(), scene.strings.size());
+    put(header.stringsOffset + header.nameOffset, scene.name.data(), header.nameLength);
+
+    std::size_t headerSize = static_cast<std::size_t>(detail::alignFileOffset(sizeof(SceneCacheHeader)));
+    header.checksum = detail::checksum64(bytes.data() + headerSize, bytes.size() - headerSize);
+    put(0, &header, sizeof(header));
+    return bytes;
+}
+
+template<typename T>
+void SceneCache<T>::write(const std::string& path, const SceneData<T>& scene,
+                          const ModelBounds& modelBounds, const SceneCacheStamp& stamp) {
+    std::vector<unsigned char> bytes = serialize(scene, modelBounds, stamp);
+
+    if (!detail::writeFileAtomically(path, bytes.data(), bytes.size())) {
+        throw std::runtime_error("Cannot write scene cache " + path);
+    }
+}
+
+template<typename T>
+const char* SceneCache<T>::validate(const unsigned char* data, std::size_t size, bool verifyChecksum, const SceneCacheStamp* stamp) {
+    // The header, streams and nodes are used in place; sections are aligned
+    // within the image, so aligning the image aligns all of them.
+    constexpr std::size_t alignment = std::max({ alignof(SceneCacheHeader), alignof(SceneBvhNode<T>), alignof(T) });
+    if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0) return "misaligned image";
+    if (size < sizeof(SceneCacheHeader)) return "file is too small";
+    SceneCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, detail::sceneCacheMagic, sizeof(header.magic)) != 0) return "not a scene cache";
+    if (header.version != version) return "unsupported version";
+    if (header.byteOrder != detail::fileByteOrder) return "different byte order";
+    if (header.scalarSize != sizeof(T)) return "different scalar type";
+    if (header.fileSize != size) return "truncated file";
+    if (stamp != nullptr && (header.stamp.sourceSize != stamp->sourceSize || header.stamp.sourceTime != stamp->sourceTime ||
+                             header.stamp.boundsKey != stamp->boundsKey)) {
+        return "stale cache";
+    }
+
+    // Every section must lie inside the file.
+    std::uint64_t objects = header.objectCount;
+    std::uint64_t stride = header.streamStride;
+    if (stride < objects * sizeof(T) || stride % detail::fileAlignment != 0 || stride > header.fileSize) return "invalid layout";
+    auto inside = [&](std::uint64_t offset, std::uint64_t size) {
+        return offset % detail::fileAlignment == 0 && offset <= header.fileSize && size <= header.fileSize - offset;
+    };
+    bool valid = inside(header.positionsOffset, 3 * stride) && inside(header.rotationsOffset, 4 * stride) &&
+                 inside(header.scalesOffset, 3 * stride) && inside(header.boundsMinOffset, 3 * stride) &&
+                 inside(header.boundsMaxOffset, 3 * stride) && inside(header.spheresOffset, 4 * stride) &&
+                 inside(header.nodesOffset, header.nodeCount * std::uint64_t(sizeof(SceneBvhNode<T>))) &&
+                 inside(header.bvhObjectsOffset, objects * sizeof(std::uint32_t)) &&
+                 inside(header.objectsOffset, objects * sizeof(SceneObjectInfo)) &&
+                 inside(header.stringsOffset, header.stringsSize) &&
+                 header.nameOffset <= header.stringsSize && header.nameLength <= header.stringsSize - header.nameOffset;
+    if (!valid) return "invalid layout";
+
+    // Every BVH node and object index must stay in range whether or not the
+    // checksum is verified: forEachVisible() follows them without checks.
+    const std::uint32_t* order = reinterpret_cast<const std::uint32_t*>(data + header.bvhObjectsOffset);
+    for (std::uint64_t i = 0; i < objects; ++i) {
+        if (order[i] >= objects) return "invalid BVH";
+    }
+    if (header.nodeCount != 0) {
+        // Replays the traversal without culling: children must follow their
+        // parent, so every node is reached at most once and the loop ends.
+        const SceneBvhNode<T>* nodes = reinterpret_cast<const SceneBvhNode<T>*>(data + header.nodesOffset);
+        std::uint32_t stack[detail::sceneBvhStackSize];
+        std::size_t stackSize = 0;
+        std::uint64_t visited = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            std::uint64_t index = stack[--stackSize];
+            const SceneBvhNode<T>& node = nodes[index];
+            if (++visited > header.nodeCount) return "invalid BVH";
+            if (node.isLeaf()) {
+                if (std::uint64_t(node.offset) + node.count > objects) return "invalid BVH";
+                continue;
+            }
+            if (index + 1 >= node.offset || node.offset >= header.nodeCount) return "invalid BVH";
+            if (stackSize + 2 > detail::sceneBvhStackSize) return "BVH too deep";
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = static_cast<std::uint32_t>(index + 1);
+        }
+    }
+
+    if (verifyChecksum) {
+        std::size_t headerSize = static_cast<std::size_t>(detail::alignFileOffset(sizeof(SceneCacheHeader)));
+        if (size < headerSize) return "invalid layout";
+        if (detail::checksum64(data + headerSize, size - headerSize) != header.checksum) return "checksum mismatch";
+    }
+    return nullptr;
+}
+
+template<typename T>
+SceneCache<T> SceneCache<T>::open(const std::string& path, bool verifyChecksum) {
+    SceneCache cache;
+    if (!cache.file.open(path)) throw std::runtime_error("Cannot map scene cache " + path);
+    if (const char* problem = validate(cache.file.data(), cache.file.size(), verifyChecksum, nullptr)) {
+        throw std::runtime_error("Invalid scene cache " + path + ": " + problem);
+    }
+    cache.bytes = cache.file.data();
+    cache.info = reinterpret_cast<const SceneCacheHeader*>(cache.bytes);
+    return cache;
+}
+
+template<typename T>
+SceneCache<T> SceneCache<T>::view(const void* data, std::size_t size, bool verifyChecksum) {
+    SceneCache cache;
+    const unsigned char* image = static_cast<const unsigned char*>(data);
+    if (const char* problem = validate(image, size, verifyChecksum, nullptr)) {
+        throw std::runtime_error(std::string("Invalid scene cache image: ") + problem);
+    }
+    cache.bytes = image;
+    cache.info = reinterpret_cast<const SceneCacheHeader*>(cache.bytes);
+    return cache;
+}
+
+template<typename T>
+SceneCache<T> SceneCache<T>::loadOrBuild(const std::string& sourcePath, const std::string& cachePath,
+                                         const ModelBounds& modelBounds, std::uint64_t boundsKey) {
+    SceneCacheStamp stamp = SceneCacheStamp::of(sourcePath, boundsKey);
+    SceneCache cache;
+    if (cache.file.open(cachePath) && validate(cache.file.data(), cache.file.size(), true, &stamp) == nullptr) {
+        cache.bytes = cache.file.data();
+        cache.info = reinterpret_cast<const SceneCacheHeader*>(cache.bytes);
+        return cache;
+    }
+    cache.file.close();
+
+    SceneLoader<T> loader;
+    write(cachePath, loader.loadFile(sourcePath), modelBounds, stamp);
+    return open(cachePath, false);
+}
+
+template<typename T>
+const SceneCacheHeader& SceneCache<T>::header() const noexcept {
+    static const SceneCacheHeader closed = {};
+    return info != nullptr ? *info : closed;
+}
+
+template<typename T>
+const T* SceneCache<T>::stream(std::uint64_t offset, std::size_t component) const noexcept {
+    if (info == nullptr) return nullptr;
+    return reinterpret_cast<const T*>(bytes + offset + component * info->streamStride);
+}
+
+template<typename T>
+std::string_view SceneCache<T>::name() const noexcept {
+    if (info == nullptr) return std::string_view();
+    const char* strings = reinterpret_cast<const char*>(bytes + info->stringsOffset);
+    return std::string_view(strings + info->nameOffset, info->nameLength);
+}
+
+template<typename T>
+std::string_view SceneCache<T>::objectName(std::size_t index) const {
+    if (index >= size()) throw std::out_of_range("Scene cache object index out of range");
+    SceneObjectInfo object;
+    std::memcpy(&object, bytes + info->objectsOffset + index * sizeof(SceneObjectInfo), sizeof(object));
+    const char* strings = reinterpret_cast<const char*>(bytes + info->stringsOffset);
+    return std::string_view(strings, info->stringsSize).substr(object.nameOffset, object.nameLength);
+}
+
+template<typename T>
+std::string_view SceneCache<T>::objectModel(std::size_t index) const {
+    if (index >= size()) throw std::out_of_range("Scene cache object index out of range");
+    SceneObjectInfo object;
+    std::memcpy(&object, bytes + info->objectsOffset + index * sizeof(SceneObjectInfo), sizeof(object));
+    const char* strings = reinterpret_cast<const char*>(bytes + info->stringsOffset);
+    return std::string_view(strings, info->stringsSize).substr(object.modelOffset, object.modelLength);
+}
+
+template<typename T>
+const SceneBvhNode<T>* SceneCache<T>::nodes() const noexcept {
+    if (info == nullptr) return nullptr;
+    return reinterpret_cast<const SceneBvhNode<T>*>(bytes + info->nodesOffset);
+}
+
+template<typename T>
+const std::uint32_t* SceneCache<T>::bvhObjects() const noexcept {
+    if (info == nullptr) return nullptr;
+    return reinterpret_cast<const std::uint32_t*>(bytes + info->bvhObjectsOffset);
+}
+
+template<typename T>
+Transform<T> SceneCache<T>::transform(std::size_t index) const {
+    if (index >= size()) throw std::out_of_range("Scene cache object index out of range");
+    return Transform<T>(Vector3<T>(positions(0)[index], positions(1)[index], positions(2)[index]),
+                        Quaternion<T>(rotations(3)[index], rotations(0)[index], rotations(1)[index], rotations(2)[index]),
+                        Vector3<T>(scales(0)[index], scales(1)[index], scales(2)[index]));
+}
+
+template<typename T>
+AABB<T> SceneCache<T>::worldBounds(std::size_t index) const {
+    if (index >= size()) throw std::out_of_range("Scene cache object index out of range");
+    return AABB<T>(Vector3<T>(boundsMin(0)[index], boundsMin(1)[index], boundsMin(2)[index]),
+                   Vector3<T>(boundsMax(0)[index], boundsMax(1)[index], boundsMax(2)[index]));
+}
+
+template<typename T>
+Sphere<T> SceneCache<T>::boundingSphere(std::size_t index) const {
+    if (index >= size()) throw std::out_of_range("Scene cache object index out of range");
+    return Sphere<T>(Vector3<T>(spheres(0)[index], spheres(1)[index], spheres(2)[index]), spheres(3)[index]);
+}
+
+template<typename T>
+template<typename Fn>
+void SceneCache<T>::forEachVisible(const Frustum<T>& frustum, Fn&& fn) const {
+    if (nodeCount() == 0) return;
+    const SceneBvhNode<T>* bvh = nodes();
+    const std::uint32_t* objects = bvhObjects();
+    const T* minStreams[3] = { boundsMin(0), boundsMin(1), boundsMin(2) };
+    const T* maxStreams[3] = { boundsMax(0), boundsMax(1), boundsMax(2) };
+
+    // validate() has checked that the traversal fits the stack.
+    std::uint32_t stack[detail::sceneBvhStackSize];
+    std::size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const SceneBvhNode<T>& node = bvh[stack[--stackSize]];
+        AABB<T> bounds(Vector3<T>(node.boundsMin[0], node.boundsMin[1], node.boundsMin[2]),
+                       Vector3<T>(node.boundsMax[0], node.boundsMax[1], node.boundsMax[2]));
+        if (!frustum.intersects(bounds)) continue;
+        if (!node.isLeaf()) {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = static_cast<std::uint32_t>(&node - bvh) + 1;
+            continue;
+        }
+        for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+            std::uint32_t object = objects[i];
+            AABB<T> objectBounds(Vector3<T>(minStreams[0][object], minStreams[1][object], minStreams[2][object]),
+                                 Vector3<T>(maxStreams[0][object], maxStreams[1][object], maxStreams[2][object]));
+            if (frustum.intersects(objectBounds)) fn(static_cast<std::size_t>(object));
+        }
+    }
+}
+
+#endif // SCENECACHE_INL
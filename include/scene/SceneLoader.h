@@ -0,0 +1,168 @@
+#ifndef SCENELOADER_H
+#define SCENELOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../core/ThreadPool.h"
+#include "TransformSoA.h"
+
+/**
+ * @brief Name and model of one scene object.
+ *
+ * The strings are stored back to back in SceneData::strings.
+ */
+struct SceneObjectInfo {
+    std::uint32_t nameOffset = 0;  ///< Offset of the name.
+    std::uint32_t nameLength = 0;  ///< Length of the name.
+    std::uint32_t modelOffset = 0; ///< Offset of the model path.
+    std::uint32_t modelLength = 0; ///< Length of the model path.
+};
+
+/**
+ * @brief The objects of a .rfxscene file.
+ *
+ * Object i has the transform transforms.get(i) and the strings of objects[i].
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+struct SceneData {
+    std::string name;                    ///< Name of the scene.
+    TransformSoA<T> transforms;          ///< Transforms of the objects.
+    std::vector<SceneObjectInfo> objects; ///< Names and models of the objects.
+    std::string strings;                 ///< Storage of the object names and model paths.
+
+    /**
+     * @brief Gets the number of objects.
+     *
+     * @return The number of objects.
+     */
+    std::size_t size() const noexcept { return objects.size(); }
+
+    /**
+     * @brief Gets the name of an object.
+     *
+     * @param index Index of the object.
+     * @return The name; valid until strings is modified.
+     */
+    std::string_view objectName(std::size_t index) const;
+
+    /**
+     * @brief Gets the model path of an object.
+     *
+     * @param index Index of the object.
+     * @return The model path; valid until strings is modified.
+     */
+    std::string_view objectModel(std::size_t index) const;
+
+    /**
+     * @brief Appends the objects of another scene.
+     *
+     * @param other The scene to append; its name is ignored.
+     */
+    void append(const SceneData& other);
+
+    void clear();
+};
+
+/**
+ * @brief Loads .rfxscene files into structure-of-arrays storage.
+ *
+ * The loader reads each file in a single pass with a tokenizer that writes
+ * objects straight into SceneData; no document tree is built and objects
+ * cause no heap allocations of their own, only amortized growth of the
+ * scene arrays. Whitespace and strings are scanned 16 bytes at a time with
+ * SSE2 where available. Euler rotations are collected during the pass and
+ * converted with one batch Quaternion::fromEulerAngles() call at the end.
+ *
+ * Recognized object keys are "name", "model", "position", "rotation" and
+ * "scale"; other keys are skipped. A rotation is a quaternion [w, x, y, z]
+ * or Euler angles in radians [roll, pitch, yaw], as returned by
+ * Quaternion::toEulerAngles(). Missing values default to the identity.
+ *
+ * A loader keeps its scratch buffers between calls; use one per thread.
+ *
+ * @tparam T Type of the transform components.
+ */
+template<typename T>
+class SceneLoader {
+public:
+    /**
+     * @brief Parses scene text and appends its objects.
+     *
+     * @param text The contents of a .rfxscene file.
+     * @param scene Receives the objects; its name is set if it has none.
+     * @throws std::runtime_error If the text is not a valid scene; scene is then left unchanged.
+     */
+    void parse(std::string_view text, SceneData<T>& scene);
+
+    /**
+     * @brief Parses scene text.
+     *
+     * @param text The contents of a .rfxscene file.
+     * @return The scene.
+     * @throws std::runtime_error If the text is not a valid scene.
+     */
+    SceneData<T> parse(std::string_view text);
+
+    /**
+     * @brief Loads a scene file and appends its objects.
+     *
+     * @param path Path of the file.
+     * @param scene Receives the objects.
+     * @throws std::runtime_error If the file cannot be read or is not a valid scene.
+     */
+    void loadFile(const std::string& path, SceneData<T>& scene);
+
+    /**
+     * @brief Loads a scene file.
+     *
+     * @param path Path of the file.
+     * @return The scene.
+     * @throws std::runtime_error If the file cannot be read or is not a valid scene.
+     */
+    SceneData<T> loadFile(const std::string& path);
+
+    /**
+     * @brief Loads several scene files in parallel.
+     *
+     * @param paths Paths of the files.
+     * @param pool The thread pool.
+     * @return One scene per path, in the same order.
+     * @throws std::runtime_error If any file cannot be read or is not a valid scene.
+     */
+    static std::vector<SceneData<T>> loadFiles(const std::vector<std::string>& paths, ThreadPool& pool);
+
+private:
+    const char* begin = nullptr;
+    const char* position = nullptr;
+    const char* end = nullptr;
+
+    std::string fileBuffer;
+    std::string keyBuffer;
+    std::vector<std::uint32_t> eulerIndices;
+    std::vector<T> eulerAngles[3];
+    std::vector<T> eulerRotations[4];
+
+    [[noreturn]] void fail(const char* message) const;
+    void skipSpace();
+    bool consume(char c);
+    void expect(char c);
+    std::string_view parseKey();
+    void parseString(std::string& out, std::uint32_t& offset, std::uint32_t& length);
+    std::size_t parseNumbers(T* values, std::size_t maxCount);
+    void skipValue();
+    void parseObject(SceneData<T>& scene);
+    void convertEulerRotations(SceneData<T>& scene);
+};
+
+// Commonly used types
+using SceneDataf = SceneData<float>;
+using SceneLoaderf = SceneLoader<float>;
+
+#include "SceneLoader.inl"
+
+#endif // SCENELOADER_H
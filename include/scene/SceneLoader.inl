@@ -0,0 +1,404 @@
+#ifndef SCENELOADER_INL
+#define SCENELOADER_INL
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include "../math/MathSerialization.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RENDERFX_SCENE_SSE2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define RENDERFX_SCENE_SSE2 0
+#endif
+
+namespace detail {
+
+#if RENDERFX_SCENE_SSE2
+inline unsigned lowestSetBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// Finds the first quote or backslash in [p, last).
+inline const char* findStringSpecial(const char* p, const char* last) {
+#if RENDERFX_SCENE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))));
+        if (mask != 0) return p + lowestSetBit(mask);
+        p += 16;
+    }
+#endif
+    while (p != last && *p != '"' && *p != '\\') ++p;
+    return p;
+}
+
+// Finds the first character in [p, last) that is not JSON whitespace.
+inline const char* skipJsonSpace(const char* p, const char* last) {
+    // Most tokens are separated by a single space or none at all.
+    if (p != last && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') return p;
+#if RENDERFX_SCENE_SSE2
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i space = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(space)) & 0xFFFFu;
+        if (mask != 0) return p + lowestSetBit(mask);
+        p += 16;
+    }
+#endif
+    while (p != last && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    return p;
+}
+
+inline void appendUtf8(std::string& out, std::uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+std::string_view SceneData<T>::objectName(std::size_t index) const {
+    const SceneObjectInfo& info = objects.at(index);
+    return std::string_view(strings).substr(info.nameOffset, info.nameLength);
+}
+
+template<typename T>
+std::string_view SceneData<T>::objectModel(std::size_t index) const {
+    const SceneObjectInfo& info = objects.at(index);
+    return std::string_view(strings).substr(info.modelOffset, info.modelLength);
+}
+
+template<typename T>
+void SceneData<T>::append(const SceneData& other) {
+    if (strings.size() + other.strings.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("Scene strings exceed 4 GiB");
+    }
+    std::uint32_t shift = static_cast<std::uint32_t>(strings.size());
+    strings += other.strings;
+    objects.reserve(objects.size() + other.objects.size());
+    for (SceneObjectInfo info : other.objects) {
+        info.nameOffset += shift;
+        info.modelOffset += shift;
+        objects.push_back(info);
+    }
+    transforms.append(other.transforms);
+}
+
+template<typename T>
+void SceneData<T>::clear() {
+    name.clear();
+    transforms.clear();
+    objects.clear();
+    strings.clear();
+}
+
+template<typename T>
+void SceneLoader<T>::fail(const char* message) const {
+    throw std::runtime_error("Invalid .rfxscene at offset " + std::to_string(position - begin) + ": " + message);
+}
+
+template<typename T>
+void SceneLoader<T>::skipSpace() {
+    position = detail::skipJsonSpace(position, end);
+}
+
+template<typename T>
+bool SceneLoader<T>::consume(char c) {
+    skipSpace();
+    if (position == end || *position != c) return false;
+    ++position;
+    return true;
+}
+
+template<typename T>
+void SceneLoader<T>::expect(char c) {
+    if (!consume(c)) {
+        char message[] = "expected ' '";
+        message[10] = c;
+        fail(message);
+    }
+}
+
+template<typename T>
+std::string_view SceneLoader<T>::parseKey() {
+    expect('"');
+    const char* start = position;
+    const char* stop = detail::findStringSpecial(position, end);
+    if (stop != end && *stop == '"') {
+        position = stop + 1;
+        return std::string_view(start, static_cast<std::size_t>(stop - start));
+    }
+    // Escaped keys are rare; decode them into the scratch buffer.
+    keyBuffer.clear();
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+    position = start - 1;
+    parseString(keyBuffer, offset, length);
+    return keyBuffer;
+}
+
+template<typename T>
+void SceneLoader<T>::parseString(std::string& out, std::uint32_t& offset, std::uint32_t& length) {
+    expect('"');
+    std::size_t start = out.size();
+    for (;;) {
+        const char* stop = detail::findStringSpecial(position, end);
+        out.append(position, stop);
+        position = stop;
+        if (position == end) fail("unterminated string");
+        if (*position == '"') {
+            ++position;
+            break;
+        }
+
+        // Backslash escape.
+        if (++position == end) fail("unterminated string");
+        char c = *position++;
+        switch (c) {
+        case '"': case '\\': case '/': out += c; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            auto hex = [this]() {
+                if (end - position < 4) fail("truncated \\u escape");
+                std::uint32_t value = 0;
+                std::from_chars_result result = std::from_chars(position, position + 4, value, 16);
+                if (result.ptr != position + 4) fail("invalid \\u escape");
+                position += 4;
+                return value;
+            };
+            std::uint32_t codePoint = hex();
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - position >= 2 && position[0] == '\\' && position[1] == 'u') {
+                position += 2;
+                std::uint32_t low = hex();
+                if (low < 0xDC00 || low >= 0xE000) fail("invalid surrogate pair");
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            detail::appendUtf8(out, codePoint);
+            break;
+        }
+        default:
+            fail("invalid escape");
+        }
+    }
+    if (out.size() > std::numeric_limits<std::uint32_t>::max()) fail("scene strings exceed 4 GiB");
+    offset = static_cast<std::uint32_t>(start);
+    length = static_cast<std::uint32_t>(out.size() - start);
+}
+
+template<typename T>
+std::size_t SceneLoader<T>::parseNumbers(T* values, std::size_t maxCount) {
+    std::size_t count = 0;
+    std::from_chars_result result = detail::readNumberList(position, end, values, maxCount, count);
+    if (result.ec != std::errc()) {
+        position = result.ptr;
+        fail("expected an array of numbers");
+    }
+    // null reads as NaN, which no scene value may hold.
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) fail("expected finite numbers");
+    }
+    position = result.ptr;
+    return count;
+}
+
+template<typename T>
+void SceneLoader<T>::skipValue() {
+    const char* next = detail::skipTextValue(position, end);
+    if (next == nullptr) fail("invalid value");
+    position = next;
+}
+
+template<typename T>
+void SceneLoader<T>::parseObject(SceneData<T>& scene) {
+    T positionValues[3] = { 0, 0, 0 };
+    T rotationValues[4] = { 1, 0, 0, 0 };
+    T scaleValues[3] = { 1, 1, 1 };
+    std::size_t rotationCount = 4;
+    SceneObjectInfo info;
+
+    expect('{');
+    if (!consume('}')) {
+        do {
+            std::string_view key = parseKey();
+            expect(':');
+            if (key == "position") {
+                if (parseNumbers(positionValues, 3) != 3) fail("position needs 3 numbers");
+            } else if (key == "rotation") {
+                rotationCount = parseNumbers(rotationValues, 4);
+                if (rotationCount != 3 && rotationCount != 4) fail("rotation needs 3 or 4 numbers");
+            } else if (key == "scale") {
+                if (parseNumbers(scaleValues, 3) != 3) fail("scale needs 3 numbers");
+            } else if (key == "name") {
+                parseString(scene.strings, info.nameOffset, info.nameLength);
+            } else if (key == "model") {
+                parseString(scene.strings, info.modelOffset, info.modelLength);
+            } else {
+                skipValue();
+            }
+        } while (consume(','));
+        expect('}');
+    }
+
+    std::size_t index = scene.objects.size();
+    scene.objects.push_back(info);
+    scene.transforms.positions.push_back(Vector<T, 3>(positionValues[0], positionValues[1], positionValues[2]));
+    scene.transforms.scales.push_back(Vector<T, 3>(scaleValues[0], scaleValues[1], scaleValues[2]));
+    if (rotationCount == 4) {
+        scene.transforms.rotations.push_back(Vector<T, 4>(rotationValues[1], rotationValues[2], rotationValues[3], rotationValues[0]));
+    } else {
+        // Converted in one batch once the file is parsed.
+        scene.transforms.rotations.push_back(Vector<T, 4>(T(0), T(0), T(0), T(1)));
+        eulerIndices.push_back(static_cast<std::uint32_t>(index));
+        for (std::size_t axis = 0; axis < 3; ++axis) eulerAngles[axis].push_back(rotationValues[axis]);
+    }
+}
+
+template<typename T>
+void SceneLoader<T>::convertEulerRotations(SceneData<T>& scene) {
+    std::size_t count = eulerIndices.size();
+    if (count == 0) return;
+    for (auto& component : eulerRotations) component.resize(count);
+
+    // Angles are (roll, pitch, yaw); fromEulerAngles takes (pitch, yaw, roll).
+    Quaternion<T>::fromEulerAngles(eulerAngles[1].data(), eulerAngles[2].data(), eulerAngles[0].data(),
+                                   eulerRotations[3].data(), eulerRotations[0].data(),
+                                   eulerRotations[1].data(), eulerRotations[2].data(), count);
+
+    for (std::size_t c = 0; c < 4; ++c) {
+        T* out = scene.transforms.rotations.component(c);
+        const T* in = eulerRotations[c].data();
+        for (std::size_t i = 0; i < count; ++i) out[eulerIndices[i]] = in[i];
+    }
+}
+
+template<typename T>
+void SceneLoader<T>::parse(std::string_view text, SceneData<T>& scene) {
+    begin = position = text.data();
+    end = text.data() + text.size();
+    eulerIndices.clear();
+    for (auto& axis : eulerAngles) axis.clear();
+
+    // Objects and the name of a failed parse are removed again.
+    std::size_t firstObject = scene.objects.size();
+    std::size_t firstString = scene.strings.size();
+    std::size_t nameLength = scene.name.size();
+    try {
+        expect('{');
+        if (!consume('}')) {
+            do {
+                std::string_view key = parseKey();
+                expect(':');
+                if (key == "objects") {
+                    expect('[');
+                    if (!consume(']')) {
+                        do {
+                            parseObject(scene);
+                        } while (consume(','));
+                        expect(']');
+                    }
+                } else if (key == "name" && scene.name.empty()) {
+                    std::uint32_t offset = 0;
+                    std::uint32_t length = 0;
+                    parseString(scene.name, offset, length);
+                } else {
+                    skipValue();
+                }
+            } while (consume(','));
+            expect('}');
+        }
+        skipSpace();
+        if (position != end) fail("unexpected text after the scene");
+    } catch (...) {
+        scene.objects.resize(firstObject);
+        scene.strings.resize(firstString);
+        scene.transforms.resize(firstObject);
+        scene.name.resize(nameLength);
+        throw;
+    }
+
+    convertEulerRotations(scene);
+}
+
+template<typename T>
+SceneData<T> SceneLoader<T>::parse(std::string_view text) {
+    SceneData<T> scene;
+    parse(text, scene);
+    return scene;
+}
+
+template<typename T>
+void SceneLoader<T>::loadFile(const std::string& path, SceneData<T>& scene) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) throw std::runtime_error("Cannot open scene file " + path);
+
+    // Read the whole file with one call into a buffer reused between files.
+    bool failed = std::fseek(file, 0, SEEK_END) != 0;
+    long size = failed ? -1 : std::ftell(file);
+    failed = failed || size < 0 || std::fseek(file, 0, SEEK_SET) != 0;
+    if (!failed) {
+        fileBuffer.resize(static_cast<std::size_t>(size));
+        failed = std::fread(fileBuffer.data(), 1, fileBuffer.size(), file) != fileBuffer.size();
+    }
+    std::fclose(file);
+    if (failed) throw std::runtime_error("Cannot read scene file " + path);
+
+    try {
+        parse(fileBuffer, scene);
+    } catch (const std::runtime_error& error) {
+        throw std::runtime_error(path + ": " + error.what());
+    }
+}
+
+template<typename T>
+SceneData<T> SceneLoader<T>::loadFile(const std::string& path) {
+    SceneData<T> scene;
+    loadFile(path, scene);
+    return scene;
+}
+
+template<typename T>
+std::vector<SceneData<T>> SceneLoader<T>::loadFiles(const std::vector<std::string>& paths, ThreadPool& pool) {
+    std::vector<SceneData<T>> scenes(paths.size());
+    pool.parallelFor(0, paths.size(), 1, [&](std::size_t first, std::size_t last) {
+        SceneLoader loader;
+        for (std::size_t i = first; i < last; ++i) loader.loadFile(paths[i], scenes[i]);
+    });
+    return scenes;
+}
+
+#endif // SCENELOADER_INL
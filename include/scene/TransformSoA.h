@@ -0,0 +1,114 @@
+#ifndef TRANSFORMSOA_H
+#define TRANSFORMSOA_H
+
+#include <cstddef>
+#include "../math/Geometry.h"
+#include "../math/VectorArray.h"
+
+/**
+ * @brief How interpolate() blends rotations.
+ */
+enum class RotationBlend {
+    Nlerp,    ///< Normalized linear interpolation: constant path, speed varies up to ~40% over 180 degrees.
+    FastSlerp ///< Nlerp with t corrected by a polynomial in the angle; within 2e-3 radians of slerp.
+};
+
+/**
+ * @brief Structure-of-arrays storage for transforms.
+ *
+ * Positions, rotations and scales are kept in separate VectorArray
+ * component streams, so batch kernels and expressions (see
+ * VectorExpression.h) run over whole scenes at once.
+ *
+ * @tparam T Type of the components.
+ */
+template<typename T>
+class TransformSoA {
+public:
+    VectorArray<T, 3> positions; ///< The positions.
+    VectorArray<T, 4> rotations; ///< The rotations as quaternion components in (x, y, z, w) order.
+    VectorArray<T, 3> scales;    ///< The scales.
+
+    /**
+     * @brief Gets the number of transforms.
+     *
+     * @return The number of transforms.
+     */
+    std::size_t size() const noexcept { return positions.size(); }
+
+    /**
+     * @brief Checks if there are no transforms.
+     *
+     * @return True if empty.
+     */
+    bool empty() const noexcept { return positions.empty(); }
+
+    /**
+     * @brief Resizes the arrays; new transforms are identities.
+     *
+     * @param count The new number of transforms.
+     */
+    void resize(std::size_t count);
+
+    void reserve(std::size_t capacity);
+
+    void clear() noexcept;
+
+    /**
+     * @brief Appends a transform.
+     *
+     * @param transform The transform.
+     */
+    void push_back(const Transform<T>& transform);
+
+    /**
+     * @brief Appends all transforms of another array.
+     *
+     * @param other The transforms to append.
+     */
+    void append(const TransformSoA& other);
+
+    /**
+     * @brief Gathers one transform.
+     *
+     * @param index Index of the transform.
+     * @return The transform.
+     */
+    Transform<T> get(std::size_t index) const;
+
+    /**
+     * @brief Scatters one transform.
+     *
+     * @param index Index of the transform.
+     * @param transform The new value.
+     */
+    void set(std::size_t index, const Transform<T>& transform);
+
+    /**
+     * @brief Interpolates whole arrays of transforms, like Transform::interpolate().
+     *
+     * Positions and scales are lerped, rotations blended along the shorter
+     * arc without trigonometry or branches, so the loops vectorize. Factors
+     * above 1 extrapolate; use RotationBlend::Nlerp for them.
+     *
+     * @param from The transforms at t = 0.
+     * @param to The transforms at t = 1.
+     * @param t The interpolation factor.
+     * @param out Receives the transforms; must hold at least last elements and may alias from or to.
+     * @param first The first transform.
+     * @param last One past the last transform; at most the size of from and to.
+     * @param blend How rotations are blended.
+     * @throws std::invalid_argument If from and to hold different numbers of transforms.
+     * @throws std::out_of_range If last exceeds the size of from or out.
+     */
+    static void interpolate(const TransformSoA& from, const TransformSoA& to, T t, TransformSoA& out,
+                            std::size_t first, std::size_t last, RotationBlend blend = RotationBlend::FastSlerp);
+};
+
+// Commonly used types
+using TransformSoAf = TransformSoA<float>;
+using TransformSoAd = TransformSoA<double>;
+
+#include "TransformSoA.inl"
+
+#endif // TRANSFORMSOA_H
@@ -0,0 +1,147 @@
+#ifndef TRANSFORMSOA_INL
+#define TRANSFORMSOA_INL
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "../math/FloatLanes.h"
+
+template<typename T>
+void TransformSoA<T>::resize(std::size_t count) {
+    std::size_t old = size();
+    positions.resize(count);
+    rotations.resize(count);
+    scales.resize(count);
+    for (std::size_t i = old; i < count; ++i) {
+        rotations.component(3)[i] = T(1);
+        for (std::size_t c = 0; c < 3; ++c) scales.component(c)[i] = T(1);
+    }
+}
+
+template<typename T>
+void TransformSoA<T>::reserve(std::size_t capacity) {
+    positions.reserve(capacity);
+    rotations.reserve(capacity);
+    scales.reserve(capacity);
+}
+
+template<typename T>
+void TransformSoA<T>::clear() noexcept {
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+}
+
+template<typename T>
+void TransformSoA<T>::push_back(const Transform<T>& transform) {
+    positions.push_back(Vector<T, 3>(transform.position));
+    rotations.push_back(Vector<T, 4>(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w));
+    scales.push_back(Vector<T, 3>(transform.scale));
+}
+
+template<typename T>
+void TransformSoA<T>::append(const TransformSoA& other) {
+    std::size_t offset = size();
+    std::size_t count = other.size();
+    positions.resize(offset + count);
+    rotations.resize(offset + count);
+    scales.resize(offset + count);
+    for (std::size_t c = 0; c < 3; ++c) {
+        std::copy_n(other.positions.component(c), count, positions.component(c) + offset);
+        std::copy_n(other.scales.component(c), count, scales.component(c) + offset);
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+        std::copy_n(other.rotations.component(c), count, rotations.component(c) + offset);
+    }
+}
+
+template<typename T>
+Transform<T> TransformSoA<T>::get(std::size_t index) const {
+    Vector<T, 4> r = rotations.get(index);
+    return Transform<T>(positions.get(index).toVector3(), Quaternion<T>(r.w, r.x, r.y, r.z), scales.get(index).toVector3());
+}
+
+template<typename T>
+void TransformSoA<T>::set(std::size_t index, const Transform<T>& transform) {
+    positions.set(index, Vector<T, 3>(transform.position));
+    rotations.set(index, Vector<T, 4>(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w));
+    scales.set(index, Vector<T, 3>(transform.scale));
+}
+
+namespace detail {
+
+// Blends the rotations of TransformSoA::interpolate() for the lanes starting at i.
+template<typename L, typename T>
+inline void blendRotations(const T* const from[4], const T* const to[4], T* const out[4], std::size_t i,
+                           T t, bool correct) noexcept {
+    using V = decltype(L::set(t));
+    V a[4], b[4];
+    for (int c = 0; c < 4; ++c) {
+        a[c] = L::load(from[c] + i);
+        b[c] = L::load(to[c] + i);
+    }
+    V dot = L::add(L::add(L::mul(a[0], b[0]), L::mul(a[1], b[1])), L::add(L::mul(a[2], b[2]), L::mul(a[3], b[3])));
+    V s = L::set(t);
+    if (correct) {
+        // Moves t along the nlerp path so the angle advances like slerp; the
+        // coefficients are a least-squares fit over the cosine of the angle.
+        V d = L::abs(dot);
+        V centered = L::set(t - T(0.5));
+        V ka = L::sub(L::set(T(3.55645)), L::mul(d, L::set(T(1.43519))));
+        ka = L::add(L::set(T(1.0904)), L::mul(d, L::add(L::set(T(-3.2452)), L::mul(d, ka))));
+        V kb = L::add(L::set(T(0.848013)), L::mul(d, L::add(L::set(T(-1.06021)), L::mul(d, L::set(T(0.215638))))));
+        V k = L::add(L::mul(L::mul(ka, centered), centered), kb);
+        s = L::add(s, L::mul(L::set(t * (t - T(0.5)) * (t - T(1))), k));
+    }
+    V wa = L::sub(L::set(T(1)), s);
+    V wb = L::signOf(dot, s);
+    V r[4];
+    for (int c = 0; c < 4; ++c) r[c] = L::add(L::mul(a[c], wa), L::mul(b[c], wb));
+    V inverseLength = L::rsqrt(L::add(L::add(L::mul(r[0], r[0]), L::mul(r[1], r[1])), L::add(L::mul(r[2], r[2]), L::mul(r[3], r[3]))));
+    for (int c = 0; c < 4; ++c) L::store(out[c] + i, L::mul(r[c], inverseLength));
+}
+
+template<typename T>
+inline void lerpComponents(const T* a, const T* b, T t, T* out, std::size_t first, std::size_t last) noexcept {
+    forEachLane<T>(first, last, [&](auto lanes, std::size_t i) {
+        using L = decltype(lanes);
+        auto x = L::load(a + i);
+        L::store(out + i, L::add(x, L::mul(L::sub(L::load(b + i), x), L::set(t))));
+    });
+}
+
+} // namespace detail
+
+template<typename T>
+void TransformSoA<T>::interpolate(const TransformSoA& from, const TransformSoA& to, T t, TransformSoA& out,
+                                  std::size_t first, std::size_t last, RotationBlend blend) {
+    if (from.size() != to.size()) throw std::invalid_argument("TransformSoA::interpolate arrays have different sizes");
+    if (last > from.size() || last > out.size()) throw std::out_of_range("TransformSoA::interpolate range out of bounds");
+
+    for (std::size_t c = 0; c < 3; ++c) {
+        detail::lerpComponents(from.positions.component(c), to.positions.component(c), t, out.positions.component(c), first, last);
+        detail::lerpComponents(from.scales.component(c), to.scales.component(c), t, out.scales.component(c), first, last);
+    }
+
+    const T* const a[4] = { from.rotations.component(0), from.rotations.component(1),
+                            from.rotations.component(2), from.rotations.component(3) };
+    const T* const b[4] = { to.rotations.component(0), to.rotations.component(1),
+                            to.rotations.component(2), to.rotations.component(3) };
+    T* const r[4] = { out.rotations.component(0), out.rotations.component(1),
+                      out.rotations.component(2), out.rotations.component(3) };
+    const bool correct = blend == RotationBlend::FastSlerp;
+    detail::forEachLane<T>(first, last, [&](auto lanes, std::size_t i) {
+        detail::blendRotations<decltype(lanes)>(a, b, r, i, t, correct);
+    });
+    for (std::size_t c = 0; c < 3; ++c) {
+        RENDERFX_CHECK_FINITE_BATCH("TransformSoA::interpolate positions", out.positions.component(c) + first,
+                                    out.positions.component(c) + last);
+        RENDERFX_CHECK_FINITE_BATCH("TransformSoA::interpolate scales", out.scales.component(c) + first,
+                                    out.scales.component(c) + last);
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+        RENDERFX_CHECK_FINITE_BATCH("TransformSoA::interpolate rotations", r[c] + first, r[c] + last);
+    }
+}
+
+#endif // TRANSFORMSOA_INL
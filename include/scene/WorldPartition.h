@@ -0,0 +1,299 @@
+#ifndef WORLDPARTITION_H
+#define WORLDPARTITION_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../core/MappedFile.h"
+#include "../core/RandomAccessFile.h"
+#include "../core/ThreadPool.h"
+#include "SceneCache.h"
+
+/**
+ * @brief Header at the start of a .rfxworld file.
+ *
+ * The header is followed by cellCount WorldCellRecord entries at
+ * cellsOffset; cell payloads follow the table, each aligned to 64 bytes.
+ */
+struct WorldPartitionHeader {
+    char magic[8];             ///< "RFXWORLD".
+    std::uint32_t version;     ///< Format version.
+    std::uint32_t byteOrder;   ///< 0x01020304 as written by the producer.
+    std::uint32_t scalarSize;  ///< Size of one stored scalar.
+    std::uint32_t cellCount;   ///< Number of cells.
+    std::uint64_t fileSize;    ///< Size of the whole file.
+    std::uint64_t cellsOffset; ///< Offset of the cell table.
+    std::uint64_t checksum;    ///< Checksum of the cell table.
+};
+
+/**
+ * @brief Entry of the cell table of a .rfxworld file.
+ *
+ * @tparam T Type of the bounds.
+ */
+template<typename T>
+struct WorldCellRecord {
+    T boundsMin[3];         ///< Minimum corner of the cell bounds.
+    T boundsMax[3];         ///< Maximum corner of the cell bounds.
+    std::uint64_t offset;   ///< Offset of the payload in the file.
+    std::uint64_t size;     ///< Size of the payload.
+    std::uint64_t checksum; ///< Checksum of the payload.
+};
+
+/**
+ * @brief A cell to store in a world file.
+ *
+ * @tparam T Type of the bounds.
+ */
+template<typename T>
+struct WorldCellSource {
+    AABB<T> bounds;                  ///< Bounds of everything in the cell.
+    std::vector<unsigned char> data; ///< The payload.
+};
+
+/**
+ * @brief Tuning of WorldPartition streaming.
+ *
+ * @tparam T Type of the distances.
+ */
+template<typename T>
+struct WorldStreamingSettings {
+    std::size_t memoryBudget = std::size_t(256) << 20; ///< Maximum bytes of resident and loading cells.
+    std::size_t maxInFlight = 8;  ///< Maximum number of concurrent loads.
+    T prefetchMargin = T(32);     ///< Distance by which the camera frustum is expanded.
+    T predictionTime = T(1);      ///< Seconds of camera movement to prefetch for.
+    std::size_t predictionSteps = 2; ///< Number of predicted camera positions.
+    std::size_t retryDelay = 8;   ///< Updates before a failed cell is retried; doubles with each further failure.
+    std::size_t maxLoadAttempts = 4; ///< Failed loads after which a cell is given up; 0 retries forever.
+};
+
+/**
+ * @brief Counters of WorldPartition streaming.
+ *
+ * A hit is a cell that is resident while it intersects the camera frustum;
+ * a miss is a visible cell that is still loading or unloaded, i.e. a
+ * streaming stall.
+ */
+struct WorldStreamingStats {
+    static constexpr std::size_t latencyBuckets = 16;
+
+    std::uint64_t hits = 0;           ///< Visible cells that were resident.
+    std::uint64_t misses = 0;         ///< Visible cells that were not resident.
+    std::uint64_t loadsStarted = 0;   ///< Loads handed to the I/O threads.
+    std::uint64_t loadsCompleted = 0; ///< Loads that became resident.
+    std::uint64_t loadsFailed = 0;    ///< Loads that could not be read or failed their checksum.
+    std::size_t cellsFailed = 0;      ///< Cells currently given up after maxLoadAttempts failed loads.
+    std::uint64_t evictions = 0;      ///< Resident cells that were dropped.
+    std::uint64_t budgetStalls = 0;   ///< Updates that left wanted cells unloaded for lack of memory.
+    std::uint64_t bytesLoaded = 0;    ///< Total payload bytes read.
+    std::size_t bytesResident = 0;    ///< Payload bytes currently resident.
+    std::size_t bytesInFlight = 0;    ///< Payload bytes currently loading.
+    double totalLatencyMs = 0.0;      ///< Sum of the request-to-ready latencies.
+    double maxLatencyMs = 0.0;        ///< Largest request-to-ready latency.
+    /// Latencies below 1 ms in bucket 0, in [2^(k-1), 2^k) ms in bucket k; the last bucket is open.
+    std::array<std::uint64_t, latencyBuckets> latencyHistogram = {};
+
+    /**
+     * @brief Gets the share of visible cells that were resident.
+     *
+     * @return Hits over hits plus misses, or 1 if nothing was visible.
+     */
+    double hitRate() const noexcept;
+
+    /**
+     * @brief Gets the mean request-to-ready latency of completed loads.
+     *
+     * @return The mean in milliseconds.
+     */
+    double averageLatencyMs() const noexcept;
+
+    /**
+     * @brief Estimates a latency percentile from the histogram.
+     *
+     * @param fraction The percentile as a fraction, e.g. 0.95.
+     * @return The upper bound of the bucket that contains it, in milliseconds.
+     */
+    double latencyPercentileMs(double fraction) const noexcept;
+
+    /**
+     * @brief Records the latency of a completed load.
+     *
+     * @param milliseconds The latency.
+     */
+    void recordLatency(double milliseconds) noexcept;
+};
+
+/**
+ * @brief Streams the cells of a world file around a moving camera.
+ *
+ * The cell table of a .rfxworld file is memory mapped, so the bounds of all
+ * cells are available without loading any payload. Every update() finds
+ * the cells that intersect the camera frustum, the frustum expanded by
+ * prefetchMargin and the expanded frustum moved along the camera velocity,
+ * and starts loads for them in that order, nearest first. Loads read the
+ * payload with positional reads on a ThreadPool and verify its checksum.
+ * When the memory budget would be exceeded, resident cells are evicted by
+ * distance, starting with cells that are no longer wanted; a wanted cell
+ * is never evicted for a farther one.
+ *
+ * A cell whose load fails is retried after retryDelay updates, and the
+ * delay doubles with each further failure. After maxLoadAttempts failures
+ * in a row the cell is given up until retryFailedCells() is called, so a
+ * bad sector or payload does not keep the I/O threads busy.
+ *
+ * All member functions must be called from one thread; only the reads run
+ * on the pool.
+ *
+ * @tparam T Type of the bounds.
+ */
+template<typename T>
+class WorldPartition {
+public:
+    static constexpr std::uint32_t version = 1; ///< The current format version.
+
+    /**
+     * @brief Writes a world file.
+     *
+     * @param path Path of the world file.
+     * @param cells The cells.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void write(const std::string& path, const std::vector<WorldCellSource<T>>& cells);
+
+    /**
+     * @brief Splits a scene into a grid of cells and writes a world file.
+     *
+     * Objects are assigned to the cell that contains their position; each
+     * cell payload is a SceneCache image of its objects (see
+     * SceneCache::view()) and the cell bounds enclose their world bounds.
+     *
+     * @param path Path of the world file.
+     * @param scene The scene.
+     * @param cellSize Edge length of the grid cells.
+     * @param modelBounds Local bounds per model, as for SceneCache.
+     * @throws std::invalid_argument If cellSize is not positive.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void build(const std::string& path, const SceneData<T>& scene, T cellSize,
+                      const typename SceneCache<T>::ModelBounds& modelBounds = typename SceneCache<T>::ModelBounds());
+
+    /**
+     * @brief Opens a world file.
+     *
+     * @param path Path of the world file.
+     * @param ioPool The threads that read cell payloads; must outlive the partition.
+     * @param settings The streaming settings.
+     * @throws std::runtime_error If the file cannot be opened or is not a valid world.
+     */
+    WorldPartition(const std::string& path, ThreadPool& ioPool,
+                   const WorldStreamingSettings<T>& settings = WorldStreamingSettings<T>());
+
+    /**
+     * @brief Waits for loads that are still running.
+     */
+    ~WorldPartition();
+
+    WorldPartition(const WorldPartition&) = delete;
+    WorldPartition& operator=(const WorldPartition&) = delete;
+
+    std::size_t cellCount() const noexcept { return cells.size(); }
+    AABB<T> cellBounds(std::size_t cell) const;
+    std::size_t cellSize(std::size_t cell) const;
+
+    /**
+     * @brief Collects finished loads, schedules new ones and evicts cells.
+     *
+     * @param cameraPosition The camera position.
+     * @param cameraVelocity The camera velocity in units per second.
+     * @param frustum The camera frustum.
+     */
+    void update(const Vector3<T>& cameraPosition, const Vector3<T>& cameraVelocity, const Frustum<T>& frustum);
+
+    /**
+     * @brief Blocks until every running load has finished and collects them.
+     */
+    void waitForLoads();
+
+    bool isResident(std::size_t cell) const;
+
+    /**
+     * @brief Gets the number of failed loads of a cell since it was last loaded.
+     *
+     * @param cell Index of the cell.
+     * @return The failures in a row; maxLoadAttempts or more once the cell is given up.
+     */
+    std::size_t loadFailures(std::size_t cell) const;
+
+    /**
+     * @brief Lets later updates load the cells that were given up, e.g. after the file was repaired.
+     */
+    void retryFailedCells();
+
+    /**
+     * @brief Gets the payload of a resident cell.
+     *
+     * @param cell Index of the cell.
+     * @return The payload, valid until the cell is evicted, or nullptr if it is not resident.
+     */
+    const unsigned char* cellData(std::size_t cell) const;
+
+    const WorldStreamingSettings<T>& settings() const noexcept { return streamingSettings; }
+    void setSettings(const WorldStreamingSettings<T>& settings) { streamingSettings = settings; }
+    const WorldStreamingStats& stats() const noexcept { return streamingStats; }
+    void resetStats() noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class CellState { Unloaded, Loading, Resident, Failed };
+
+    struct Cell {
+        CellState state = CellState::Unloaded;
+        std::unique_ptr<unsigned char[]> data;
+        unsigned priority = 0;
+        T distance = T(0);
+        std::size_t failures = 0;     // Failed loads in a row.
+        std::uint64_t retryUpdate = 0; // First update that may load the cell again.
+    };
+
+    struct Completion {
+        std::size_t cell;
+        std::unique_ptr<unsigned char[]> data;
+        bool succeeded;
+        double latencyMs;
+    };
+
+    MappedFile table;
+    RandomAccessFile file;
+    const WorldCellRecord<T>* records = nullptr;
+    ThreadPool& ioPool;
+    WorldStreamingSettings<T> streamingSettings;
+    WorldStreamingStats streamingStats;
+    std::vector<Cell> cells;
+    std::vector<std::size_t> wanted;
+    std::vector<std::size_t> resident;
+    std::size_t inFlight = 0;
+    std::uint64_t updates = 0;
+
+    std::mutex completionMutex;
+    std::condition_variable completionReady;
+    std::vector<Completion> completions;
+    std::size_t running = 0;
+
+    void collectCompletions();
+    void startLoad(std::size_t cell);
+    void evict(std::size_t cell);
+};
+
+// Commonly used types
+using WorldPartitionf = WorldPartition<float>;
+
+#include "WorldPartition.inl"
+
+#endif // WORLDPARTITION_H
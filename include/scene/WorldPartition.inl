@@ -0,0 +1,404 @@
+#ifndef WORLDPARTITION_INL
+#define WORLDPARTITION_INL
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace detail {
+
+constexpr char worldPartitionMagic[8] = { 'R', 'F', 'X', 'W', 'O', 'R', 'L', 'D' };
+
+} // namespace detail
+
+inline double WorldStreamingStats::hitRate() const noexcept {
+    std::uint64_t total = hits + misses;
+    return total == 0 ? 1.0 : static_cast<double>(hits) / static_cast<double>(total);
+}
+
+inline double WorldStreamingStats::averageLatencyMs() const noexcept {
+    return loadsCompleted == 0 ? 0.0 : totalLatencyMs / static_cast<double>(loadsCompleted);
+}
+
+inline double WorldStreamingStats::latencyPercentileMs(double fraction) const noexcept {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : latencyHistogram) total += count;
+    if (total == 0) return 0.0;
+    double target = fraction * static_cast<double>(total);
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket + 1 < latencyBuckets; ++bucket) {
+        seen += latencyHistogram[bucket];
+        if (static_cast<double>(seen) >= target) return std::ldexp(1.0, static_cast<int>(bucket));
+    }
+    return maxLatencyMs;
+}
+
+inline void WorldStreamingStats::recordLatency(double milliseconds) noexcept {
+    totalLatencyMs += milliseconds;
+    maxLatencyMs = std::max(maxLatencyMs, milliseconds);
+    std::size_t bucket = 0;
+    while (bucket + 1 < latencyBuckets && milliseconds >= std::ldexp(1.0, static_cast<int>(bucket))) ++bucket;
+    ++latencyHistogram[bucket];
+}
+
+template<typename T>
+void WorldPartition<T>::write(const std::string& path, const std::vector<WorldCellSource<T>>& sources) {
+    if (sources.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Too many cells for a world file: " + path);
+    }
+
+    WorldPartitionHeader header = {};
+    std::memcpy(header.magic, detail::worldPartitionMagic, sizeof(header.magic));
+    header.version = version;
+    header.byteOrder = detail::fileByteOrder;
+    header.scalarSize = sizeof(T);
+    header.cellCount = static_cast<std::uint32_t>(sources.size());
+    header.cellsOffset = detail::alignFileOffset(sizeof(WorldPartitionHeader));
+
+    std::vector<WorldCellRecord<T>> records(sources.size());
+    std::uint64_t offset = detail::alignFileOffset(header.cellsOffset + records.size() * sizeof(WorldCellRecord<T>));
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const WorldCellSource<T>& source = sources[i];
+        WorldCellRecord<T>& record = records[i];
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            record.boundsMin[axis] = source.bounds.min[axis];
+            record.boundsMax[axis] = source.bounds.max[axis];
+        }
+        record.offset = offset;
+        record.size = source.data.size();
+        record.checksum = detail::checksum64(source.data.data(), source.data.size());
+        offset = detail::alignFileOffset(offset + record.size);
+    }
+    header.fileSize = offset;
+    header.checksum = detail::checksum64(reinterpret_cast<const unsigned char*>(records.data()),
+                                         records.size() * sizeof(WorldCellRecord<T>));
+
+    std::vector<unsigned char> bytes(static_cast<std::size_t>(header.fileSize));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(bytes.data() + header.cellsOffset, records.data(), records.size() * sizeof(WorldCellRecord<T>));
+    }
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (!sources[i].data.empty()) std::memcpy(bytes.data() + records[i].offset, sources[i].data.data(), sources[i].data.size());
+    }
+    if (!detail::writeFileAtomically(path, bytes.data(), bytes.size())) {
+        throw std::runtime_error("Cannot write world file " + path);
+    }
+}
+
+template<typename T>
+void WorldPartition<T>::build(const std::string& path, const SceneData<T>& scene, T cellSize,
+                              const typename SceneCache<T>::ModelBounds& modelBounds) {
+    if (!(cellSize > T(0))) throw std::invalid_argument("Cell size must be positive");
+
+    // Group the objects by grid cell; the map keeps the cells in a stable order.
+    std::map<std::array<std::int64_t, 3>, std::vector<std::size_t>> grid;
+    for (std::size_t i = 0; i < scene.size(); ++i) {
+        std::array<std::int64_t, 3> key;
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            key[axis] = static_cast<std::int64_t>(std::floor(scene.transforms.positions.component(axis)[i] / cellSize));
+        }
+        grid[key].push_back(i);
+    }
+
+    std::vector<WorldCellSource<T>> sources;
+    sources.reserve(grid.size());
+    for (const auto& entry : grid) {
+        SceneData<T> cellScene;
+        cellScene.name = scene.name;
+        cellScene.transforms.reserve(entry.second.size());
+        cellScene.objects.reserve(entry.second.size());
+        for (std::size_t object : entry.second) {
+            SceneObjectInfo info;
+            std::string_view name = scene.objectName(object);
+            std::string_view model = scene.objectModel(object);
+            info.nameOffset = static_cast<std::uint32_t>(cellScene.strings.size());
+            info.nameLength = static_cast<std::uint32_t>(name.size());
+            cellScene.strings += name;
+            info.modelOffset = static_cast<std::uint32_t>(cellScene.strings.size());
+            info.modelLength = static_cast<std::uint32_t>(model.size());
+            cellScene.strings += model;
+            cellScene.objects.push_back(info);
+            cellScene.transforms.push_back(scene.transforms.get(object));
+        }
+
+        WorldCellSource<T> source;
+        source.data = SceneCache<T>::serialize(cellScene, modelBounds);
+        // The BVH root encloses the world bounds of every object in the cell.
+        const SceneBvhNode<T>& root = SceneCache<T>::view(source.data.data(), source.data.size(), false).nodes()[0];
+        source.bounds = AABB<T>(Vector3<T>(root.boundsMin[0], root.boundsMin[1], root.boundsMin[2]),
+                                Vector3<T>(root.boundsMax[0], root.boundsMax[1], root.boundsMax[2]));
+        sources.push_back(std::move(source));
+    }
+    write(path, sources);
+}
+
+template<typename T>
+WorldPartition<T>::WorldPartition(const std::string& path, ThreadPool& ioPool, const WorldStreamingSettings<T>& settings)
+    : ioPool(ioPool), streamingSettings(settings) {
+    if (!table.open(path)) throw std::runtime_error("Cannot map world file " + path);
+    auto fail = [&path](const char* problem) {
+        throw std::runtime_error("Invalid world file " + path + ": " + problem);
+    };
+    if (table.size() < sizeof(WorldPartitionHeader)) fail("file is too small");
+    WorldPartitionHeader header;
+    std::memcpy(&header, table.data(), sizeof(header));
+    if (std::memcmp(header.magic, detail::worldPartitionMagic, sizeof(header.magic)) != 0) fail("not a world file");
+    if (header.version != version) fail("unsupported version");
+    if (header.byteOrder != detail::fileByteOrder) fail("different byte order");
+    if (header.scalarSize != sizeof(T)) fail("different scalar type");
+    if (header.fileSize != table.size()) fail("truncated file");
+    std::uint64_t tableSize = std::uint64_t(header.cellCount) * sizeof(WorldCellRecord<T>);
+    if (header.cellsOffset % detail::fileAlignment != 0 || header.cellsOffset > header.fileSize ||
+        tableSize > header.fileSize - header.cellsOffset) {
+        fail("invalid layout");
+    }
+    records = reinterpret_cast<const WorldCellRecord<T>*>(table.data() + header.cellsOffset);
+    if (detail::checksum64(table.data() + header.cellsOffset, static_cast<std::size_t>(tableSize)) != header.checksum) {
+        fail("checksum mismatch");
+    }
+    for (std::uint32_t i = 0; i < header.cellCount; ++i) {
+        if (records[i].offset > header.fileSize || records[i].size > header.fileSize - records[i].offset) fail("invalid layout");
+    }
+
+    if (!file.open(path)) throw std::runtime_error("Cannot open world file " + path);
+    cells.resize(header.cellCount);
+}
+
+template<typename T>
+WorldPartition<T>::~WorldPartition() {
+    std::unique_lock<std::mutex> lock(completionMutex);
+    completionReady.wait(lock, [this] { return running == 0; });
+}
+
+template<typename T>
+AABB<T> WorldPartition<T>::cellBounds(std::size_t cell) const {
+    if (cell >= cells.size()) throw std::out_of_range("World cell index out of range");
+    const WorldCellRecord<T>& record = records[cell];
+    return AABB<T>(Vector3<T>(record.boundsMin[0], record.boundsMin[1], record.boundsMin[2]),
+                   Vector3<T>(record.boundsMax[0], record.boundsMax[1], record.boundsMax[2]));
+}
+
+template<typename T>
+std::size_t WorldPartition<T>::cellSize(std::size_t cell) const {
+    if (cell >= cells.size()) throw std::out_of_range("World cell index out of range");
+    return static_cast<std::size_t>(records[cell].size);
+}
+
+template<typename T>
+bool WorldPartition<T>::isResident(std::size_t cell) const {
+    if (cell >= cells.size()) throw std::out_of_range("World cell index out of range");
+    return cells[cell].state == CellState::Resident;
+}
+
+template<typename T>
+std::size_t WorldPartition<T>::loadFailures(std::size_t cell) const {
+    if (cell >= cells.size()) throw std::out_of_range("World cell index out of range");
+    return cells[cell].failures;
+}
+
+template<typename T>
+void WorldPartition<T>::retryFailedCells() {
+    for (Cell& cell : cells) {
+        if (cell.state != CellState::Failed) continue;
+        cell.state = CellState::Unloaded;
+        cell.failures = 0;
+        cell.retryUpdate = 0;
+    }
+    streamingStats.cellsFailed = 0;
+}
+
+template<typename T>
+const unsigned char* WorldPartition<T>::cellData(std::size_t cell) const {
+    return isResident(cell) ? cells[cell].data.get() : nullptr;
+}
+
+template<typename T>
+void WorldPartition<T>::resetStats() noexcept {
+    std::size_t bytesResident = streamingStats.bytesResident;
+    std::size_t bytesInFlight = streamingStats.bytesInFlight;
+    std::size_t cellsFailed = streamingStats.cellsFailed;
+    streamingStats = WorldStreamingStats();
+    streamingStats.bytesResident = bytesResident;
+    streamingStats.bytesInFlight = bytesInFlight;
+    streamingStats.cellsFailed = cellsFailed;
+}
+
+template<typename T>
+void WorldPartition<T>::collectCompletions() {
+    std::vector<Completion> finished;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        finished.swap(completions);
+    }
+    for (Completion& completion : finished) {
+        Cell& cell = cells[completion.cell];
+        std::size_t size = cellSize(completion.cell);
+        --inFlight;
+        streamingStats.bytesInFlight -= size;
+        if (completion.succeeded) {
+            cell.state = CellState::Resident;
+            cell.data = std::move(completion.data);
+            cell.failures = 0;
+            streamingStats.bytesResident += size;
+            streamingStats.bytesLoaded += size;
+            ++streamingStats.loadsCompleted;
+            streamingStats.recordLatency(completion.latencyMs);
+        } else {
+            // Retried after a delay that doubles with each failure, or given up.
+            ++streamingStats.loadsFailed;
+            ++cell.failures;
+            if (streamingSettings.maxLoadAttempts != 0 && cell.failures >= streamingSettings.maxLoadAttempts) {
+                cell.state = CellState::Failed;
+                ++streamingStats.cellsFailed;
+            } else {
+                cell.state = CellState::Unloaded;
+                std::size_t shift = std::min<std::size_t>(cell.failures - 1, 32);
+                cell.retryUpdate = updates + (std::uint64_t(streamingSettings.retryDelay) << shift);
+            }
+        }
+    }
+}
+
+template<typename T>
+void WorldPartition<T>::startLoad(std::size_t cell) {
+    const WorldCellRecord<T>& record = records[cell];
+    cells[cell].state = CellState::Loading;
+    ++inFlight;
+    ++streamingStats.loadsStarted;
+    streamingStats.bytesInFlight += static_cast<std::size_t>(record.size);
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ++running;
+    }
+
+    Clock::time_point requested = Clock::now();
+    ioPool.submit([this, cell, offset = record.offset, size = static_cast<std::size_t>(record.size),
+                   checksum = record.checksum, requested]() {
+        Completion completion{ cell, nullptr, false, 0.0 };
+        try {
+            completion.data.reset(new unsigned char[size != 0 ? size : 1]);
+            completion.succeeded = file.readAt(completion.data.get(), size, offset) &&
+                                   detail::checksum64(completion.data.get(), size) == checksum;
+        } catch (...) {
+            completion.data.reset();
+            completion.succeeded = false;
+        }
+        completion.latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - requested).count();
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            completions.push_back(std::move(completion));
+            --running;
+            // Notified under the lock: once running reaches zero the destructor
+            // may return and destroy the condition variable.
+            completionReady.notify_all();
+        }
+    });
+}
+
+template<typename T>
+void WorldPartition<T>::evict(std::size_t cell) {
+    cells[cell].state = CellState::Unloaded;
+    cells[cell].data.reset();
+    streamingStats.bytesResident -= cellSize(cell);
+    ++streamingStats.evictions;
+}
+
+template<typename T>
+void WorldPartition<T>::waitForLoads() {
+    {
+        std::unique_lock<std::mutex> lock(completionMutex);
+        completionReady.wait(lock, [this] { return running == 0; });
+    }
+    collectCompletions();
+}
+
+template<typename T>
+void WorldPartition<T>::update(const Vector3<T>& cameraPosition, const Vector3<T>& cameraVelocity, const Frustum<T>& frustum) {
+    ++updates;
+    collectCompletions();
+
+    // Priority 0: visible, 1: in the expanded frustum, 2: in an expanded
+    // frustum at a predicted camera position, 3: not wanted.
+    Frustum<T> expanded = frustum;
+    for (Plane<T>& plane : expanded.planes) plane.distance += streamingSettings.prefetchMargin;
+    std::vector<Frustum<T>> predicted(streamingSettings.predictionSteps, expanded);
+    for (std::size_t step = 0; step < predicted.size(); ++step) {
+        T time = streamingSettings.predictionTime * T(step + 1) / T(predicted.size());
+        Vector3<T> offset = cameraVelocity * time;
+        for (Plane<T>& plane : predicted[step].planes) plane.distance -= plane.normal.dot(offset);
+    }
+
+    wanted.clear();
+    resident.clear();
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        Cell& cell = cells[i];
+        AABB<T> bounds = cellBounds(i);
+        T distanceSquared = T(0);
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            T outside = std::max({ bounds.min[axis] - cameraPosition[axis], cameraPosition[axis] - bounds.max[axis], T(0) });
+            distanceSquared += outside * outside;
+        }
+        cell.distance = std::sqrt(distanceSquared);
+
+        cell.priority = 3;
+        if (frustum.intersects(bounds)) {
+            cell.priority = 0;
+            if (cell.state == CellState::Resident) {
+                ++streamingStats.hits;
+            } else {
+                ++streamingStats.misses;
+            }
+        } else if (expanded.intersects(bounds)) {
+            cell.priority = 1;
+        } else {
+            for (const Frustum<T>& future : predicted) {
+                if (future.intersects(bounds)) {
+                    cell.priority = 2;
+                    break;
+                }
+            }
+        }
+        if (cell.priority < 3) wanted.push_back(i);
+        if (cell.state == CellState::Resident) resident.push_back(i);
+    }
+
+    auto before = [this](std::size_t a, std::size_t b) {
+        const Cell& first = cells[a];
+        const Cell& second = cells[b];
+        return first.priority != second.priority ? first.priority < second.priority : first.distance < second.distance;
+    };
+    std::sort(wanted.begin(), wanted.end(), before);
+    // Eviction candidates, least important first.
+    std::sort(resident.begin(), resident.end(), [&before](std::size_t a, std::size_t b) { return before(b, a); });
+
+    std::size_t used = streamingStats.bytesResident + streamingStats.bytesInFlight;
+    std::size_t victim = 0;
+    for (std::size_t cell : wanted) {
+        if (cells[cell].state != CellState::Unloaded || cells[cell].retryUpdate > updates) continue;
+        if (inFlight >= streamingSettings.maxInFlight) break;
+        std::size_t size = cellSize(cell);
+        while (used + size > streamingSettings.memoryBudget && victim < resident.size() && before(cell, resident[victim])) {
+            used -= cellSize(resident[victim]);
+            evict(resident[victim++]);
+        }
+        if (used + size > streamingSettings.memoryBudget) {
+            ++streamingStats.budgetStalls;
+            break;
+        }
+        startLoad(cell);
+        used += size;
+    }
+
+    // Shrink to a lowered budget with cells nobody wants.
+    while (used > streamingSettings.memoryBudget && victim < resident.size() && cells[resident[victim]].priority == 3) {
+        used -= cellSize(resident[victim]);
+        evict(resident[victim++]);
+    }
+}
+
+#endif // WORLDPARTITION_INL
@@ -0,0 +1,40 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <iostream>
+
+/**
+ * @file TestCheck.h
+ * @brief The check helper shared by the test programs in tests/.
+ *
+ * Each test prints one line per check and exits with exitCode(), so
+ * tests/run_tests.sh can run them all and report the failing programs.
+ */
+
+namespace test {
+
+/// Number of failed checks so far.
+inline int failures = 0;
+
+/**
+ * @brief Prints the outcome of a check and counts failures.
+ *
+ * @param condition Whether the check passed.
+ * @param what What was checked; indented under the section heading.
+ * @param value A measured value printed for context, e.g. an error.
+ */
+inline void check(bool condition, const char* what, double value) {
+    std::cout << (condition ? "ok     " : "FAILED ") << what << " (" << value << ")\n";
+    if (!condition) ++failures;
+}
+
+/**
+ * @brief Gets the exit status of the test program.
+ *
+ * @return 0 if every check passed, 1 otherwise.
+ */
+inline int exitCode() { return failures == 0 ? 0 : 1; }
+
+} // namespace test
+
+#endif // TESTCHECK_H
@@ -0,0 +1,241 @@
+// Checks for compressed animation clips: the error against the source
+// frames, forward playback and seeks through a cursor, single-frame clips,
+// and writing, opening and rejecting clip files.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/animation_clip_test.cpp -o animation_clip_test
+// Usage: animation_clip_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "anim/AnimationClip.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+const std::size_t joints = 7;
+const float rate = 30.0f;
+
+// Smooth motion with a different phase per joint; joint 3 holds still, so
+// its tracks reduce to a single key each.
+TransformSoAf sourceFrames(std::size_t frameCount) {
+    TransformSoAf frames;
+    frames.resize(frameCount * joints);
+    for (std::size_t f = 0; f < frameCount; ++f) {
+        for (std::size_t j = 0; j < joints; ++j) {
+            float t = j == 3 ? 0.0f : float(f) / rate;
+            float phase = 0.7f * float(j);
+            Vector3f position(std::sin(2.1f * t + phase), 0.5f * std::cos(1.3f * t), 0.25f * t + float(j));
+            Vector3f axis = Vector3f(std::cos(phase), 1.0f, std::sin(0.4f * t + phase)).normalized();
+            Quaternionf rotation = Quaternionf::fromAxisAngle(axis, 2.5f * std::sin(0.9f * t + phase));
+            Vector3f scale(1.0f + 0.2f * std::sin(t), 1.0f, 1.0f - 0.1f * std::cos(3.0f * t));
+            frames.set(f * joints + j, Transform<float>(position, rotation, scale));
+        }
+    }
+    return frames;
+}
+
+// The angle between two rotations from the chord between their quaternions,
+// which unlike acos of the dot product stays accurate for small angles.
+double rotationError(const TransformSoAf& a, std::size_t i, const TransformSoAf& b, std::size_t k) {
+    double minus = 0, plus = 0;
+    for (std::size_t c = 0; c < 4; ++c) {
+        double p = a.rotations.component(c)[i], q = b.rotations.component(c)[k];
+        minus += (p - q) * (p - q);
+        plus += (p + q) * (p + q);
+    }
+    return 4.0 * std::asin(std::min(1.0, std::sqrt(std::min(minus, plus)) / 2.0));
+}
+
+double vectorError(const VectorArray<float, 3>& a, std::size_t i, const VectorArray<float, 3>& b, std::size_t k) {
+    double error = 0;
+    for (std::size_t c = 0; c < 3; ++c) error = std::max(error, std::fabs(double(a.component(c)[i]) - double(b.component(c)[k])));
+    return error;
+}
+
+double poseDifference(const TransformSoAf& a, const TransformSoAf& b) {
+    double difference = 0;
+    for (std::size_t j = 0; j < a.size(); ++j) {
+        difference = std::max({ difference, vectorError(a.positions, j, b.positions, j), vectorError(a.scales, j, b.scales, j) });
+        for (std::size_t c = 0; c < 4; ++c) {
+            difference = std::max(difference, std::fabs(double(a.rotations.component(c)[j]) - double(b.rotations.component(c)[j])));
+        }
+    }
+    return difference;
+}
+
+TransformSoAf sampleFresh(const AnimationClip& clip, float time) {
+    AnimationClipCursorf cursor;
+    TransformSoAf pose;
+    pose.resize(clip.jointCount());
+    clip.sample(cursor, time, pose);
+    return pose;
+}
+
+bool opens(const std::string& path) {
+    try {
+        AnimationClip::open(path);
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+void writeBytes(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), out);
+    std::fclose(out);
+}
+
+void compression() {
+    std::cout << "compression:\n";
+    const std::size_t frameCount = 241;
+    TransformSoAf frames = sourceFrames(frameCount);
+    AnimationClipSettings settings;
+    AnimationClip clip = AnimationClip::build(frames, joints, rate, settings);
+    check(clip.keyCount() < frameCount * joints * 3, "  keys are removed", double(clip.keyCount()));
+
+    // Every frame is within the tolerance plus the quantization step of its
+    // track, with some room for sampling in float.
+    double position = 0, rotation = 0, scale = 0;
+    const AnimationClipRange* ranges = clip.ranges();
+    AnimationClipCursorf cursor;
+    TransformSoAf pose;
+    pose.resize(joints);
+    for (std::size_t f = 0; f < frameCount; ++f) {
+        clip.sample(cursor, float(f) / rate, pose);
+        for (std::size_t j = 0; j < joints; ++j) {
+            std::size_t i = f * joints + j;
+            double step = 0;
+            for (std::size_t c = 0; c < 3; ++c) step = std::max(step, double(ranges[j * 3].extent[c]) / 65535.0);
+            position = std::max(position, vectorError(pose.positions, j, frames.positions, i) - step);
+            step = 0;
+            for (std::size_t c = 0; c < 3; ++c) step = std::max(step, double(ranges[j * 3 + 2].extent[c]) / 65535.0);
+            scale = std::max(scale, vectorError(pose.scales, j, frames.scales, i) - step);
+            rotation = std::max(rotation, rotationError(pose, j, frames, i) - 3e-5);
+        }
+    }
+    check(position <= settings.translationTolerance + 1e-5, "  translation error", position);
+    check(rotation <= settings.rotationTolerance + 1e-4, "  rotation error", rotation);
+    check(scale <= settings.scaleTolerance + 1e-5, "  scale error", scale);
+}
+
+void playback() {
+    std::cout << "playback:\n";
+    TransformSoAf frames = sourceFrames(121);
+    AnimationClip clip = AnimationClip::build(frames, joints, rate);
+
+    // Forward playback at another rate decodes every key once and matches a
+    // cursor that starts over for every sample.
+    AnimationClipCursorf cursor;
+    TransformSoAf pose;
+    pose.resize(joints);
+    double difference = 0;
+    bool monotonic = true;
+    std::size_t position = 0;
+    for (float time = 0.0f; time <= clip.duration() + 0.1f; time += 1.0f / 47.0f) {
+        clip.sample(cursor, time, pose);
+        monotonic = monotonic && cursor.position() >= position;
+        position = cursor.position();
+        difference = std::max(difference, poseDifference(pose, sampleFresh(clip, time)));
+    }
+    check(difference == 0, "  forward playback matches fresh cursors", difference);
+    check(monotonic && position == clip.keyCount(), "  forward playback decodes every key once", double(position));
+
+    // Random seeks, backward and forward, through one cursor.
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> time(-0.5f, clip.duration() + 0.5f);
+    difference = 0;
+    for (int i = 0; i < 500; ++i) {
+        float t = time(rng);
+        clip.sample(cursor, t, pose);
+        difference = std::max(difference, poseDifference(pose, sampleFresh(clip, t)));
+    }
+    check(difference == 0, "  random seeks match fresh cursors", difference);
+
+    // A cursor moved to another clip starts over.
+    AnimationClip other = AnimationClip::build(sourceFrames(31), joints, rate);
+    other.sample(cursor, 0.5f, pose);
+    difference = poseDifference(pose, sampleFresh(other, 0.5f));
+    check(difference == 0, "  a cursor moved to another clip starts over", difference);
+}
+
+void singleFrame() {
+    std::cout << "single frame:\n";
+    TransformSoAf frames = sourceFrames(1);
+    AnimationClip clip = AnimationClip::build(frames, joints, rate);
+    check(clip.duration() == 0.0f && clip.keyCount() == joints * 3, "  one key per track", double(clip.keyCount()));
+    double error = 0;
+    AnimationClipCursorf cursor;
+    TransformSoAf pose;
+    pose.resize(joints);
+    for (float time : { 0.0f, 1.0f, -1.0f }) {
+        clip.sample(cursor, time, pose);
+        for (std::size_t j = 0; j < joints; ++j) {
+            error = std::max({ error, vectorError(pose.positions, j, frames.positions, j), vectorError(pose.scales, j, frames.scales, j),
+                               rotationError(pose, j, frames, j) });
+        }
+    }
+    check(error <= 1e-4, "  every time samples the frame", error);
+}
+
+void files() {
+    std::cout << "files:\n";
+    const std::string path = (std::filesystem::temp_directory_path() / "animation_clip_test.rfxclip").string();
+    TransformSoAf frames = sourceFrames(61);
+    std::vector<unsigned char> bytes = AnimationClip::serialize(frames, joints, rate);
+    AnimationClip::write(path, frames, joints, rate);
+
+    AnimationClip opened = AnimationClip::open(path);
+    AnimationClip built = AnimationClip::build(frames, joints, rate);
+    bool same = opened.keyCount() == built.keyCount() && opened.frameCount() == 61 && opened.sampleRate() == rate &&
+                std::memcmp(opened.keys(), built.keys(), built.keyCount() * sizeof(AnimationClipKey)) == 0;
+    check(same, "  an opened clip has the written keys", double(opened.keyCount()));
+    double difference = poseDifference(sampleFresh(opened, 1.3f), sampleFresh(built, 1.3f));
+    check(difference == 0, "  an opened clip samples like the built one", difference);
+
+    std::vector<unsigned char> truncated(bytes.begin(), bytes.end() - 64);
+    writeBytes(path, truncated);
+    check(!opens(path), "  a truncated file is rejected", double(truncated.size()));
+    std::vector<unsigned char> corrupt = bytes;
+    corrupt[corrupt.size() / 2] ^= 0x10;
+    writeBytes(path, corrupt);
+    check(!opens(path), "  a corrupt key is rejected", double(corrupt.size() / 2));
+    corrupt = bytes;
+    corrupt[0] = 'X';
+    writeBytes(path, corrupt);
+    check(!opens(path), "  a wrong magic is rejected", 0);
+    writeBytes(path, std::vector<unsigned char>(bytes.begin(), bytes.begin() + 16));
+    check(!opens(path), "  a file shorter than the header is rejected", 16);
+    std::filesystem::remove(path);
+
+    std::vector<std::uint64_t> storage(bytes.size() / 8 + 1);
+    unsigned char* misaligned = reinterpret_cast<unsigned char*>(storage.data()) + 1;
+    std::memcpy(misaligned, bytes.data(), bytes.size());
+    bool rejected = false;
+    try {
+        AnimationClip::view(misaligned, bytes.size());
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    check(rejected, "  a misaligned image is rejected", 1);
+}
+
+} // namespace
+
+int main() {
+    compression();
+    playback();
+    singleFrame();
+    files();
+    return test::exitCode();
+}
@@ -0,0 +1,87 @@
+// Checks that the math types stay usable in constant expressions, and that
+// the compile-time and run-time paths of the math:: functions agree where
+// their documentation says they do.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/constexpr_math_test.cpp -o constexpr_math_test
+// Usage: constexpr_math_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include "math/Geometry.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+#if RENDERFX_HAS_CONSTEXPR_MATH
+// AABB::transformed indexes vector components, which must not use pointer
+// arithmetic in constant expressions.
+static_assert(AABB<float>(Vector3<float>(-1, -2, -3), Vector3<float>(1, 2, 3))
+                  .transformed(Matrix4x4<float>::translation(Vector3<float>(10, 20, 30))).max.z == 33,
+              "AABB::transformed must be constant-evaluable");
+
+constexpr double angles[] = { -1e6, -12345.678, -3.0, -0.5, 0.0, 1e-9, 0.7853981633974483, 1.0, 2.5, 100.0, 99999.9, 1e6 };
+constexpr double values[] = { -1.0, -0.999, -0.5, -1e-12, 0.0, 0.25, 0.70710678118654757, 0.9999, 1.0 };
+
+template<std::size_t... I>
+constexpr auto constantSines(std::index_sequence<I...>) {
+    struct { double sin[sizeof...(I)], cos[sizeof...(I)], tan[sizeof...(I)]; } r = {
+        { math::sin(angles[I])... }, { math::cos(angles[I])... }, { math::tan(angles[I])... } };
+    return r;
+}
+
+template<std::size_t... I>
+constexpr auto constantInverses(std::index_sequence<I...>) {
+    struct { double asin[sizeof...(I)], acos[sizeof...(I)], atan2[sizeof...(I)]; } r = {
+        { math::asin(values[I])... }, { math::acos(values[I])... }, { math::atan2(values[I], 1.0 - values[I])... } };
+    return r;
+}
+
+// Error in ULPs of double at the magnitude of the reference, at least one.
+double ulps(double value, double reference) {
+    double magnitude = std::max(std::abs(reference), std::numeric_limits<double>::min());
+    return std::abs(value - reference) / (std::nextafter(magnitude, 2 * magnitude) - magnitude);
+}
+
+void trigonometry() {
+    std::cout << "compile-time and run-time trigonometry:\n";
+    constexpr std::size_t angleCount = sizeof(angles) / sizeof(angles[0]);
+    constexpr std::size_t valueCount = sizeof(values) / sizeof(values[0]);
+    constexpr auto sines = constantSines(std::make_index_sequence<angleCount>());
+    constexpr auto inverses = constantInverses(std::make_index_sequence<valueCount>());
+
+    // Up to 1e6 both paths are accurate, so they agree to a few ULPs.
+    double worst = 0;
+    for (std::size_t i = 0; i < angleCount; ++i) {
+        worst = std::max({ worst, ulps(sines.sin[i], std::sin(angles[i])), ulps(sines.cos[i], std::cos(angles[i])),
+                           ulps(sines.tan[i], std::tan(angles[i])) });
+    }
+    check(worst <= 4, "  sin, cos and tan agree up to 1e6", worst);
+
+    worst = 0;
+    for (std::size_t i = 0; i < valueCount; ++i) {
+        worst = std::max({ worst, ulps(inverses.asin[i], std::asin(values[i])), ulps(inverses.acos[i], std::acos(values[i])),
+                           ulps(inverses.atan2[i], std::atan2(values[i], 1.0 - values[i])) });
+    }
+    check(worst <= 4, "  asin, acos and atan2 agree", worst);
+
+    // Beyond 1e6 only the run-time path reduces the argument, as documented.
+    constexpr double far = math::sin(1e7);
+    check(std::isnan(far) == !math::strictMode && std::isfinite(math::sin(1e7)), "  sin(1e7) is NaN only in constant expressions", far);
+}
+#endif
+
+} // namespace
+
+int main() {
+#if RENDERFX_HAS_CONSTEXPR_MATH
+    trigonometry();
+#else
+    std::cout << "constant-evaluated math is not supported by this compiler\n";
+#endif
+    return test::exitCode();
+}
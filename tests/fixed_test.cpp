@@ -0,0 +1,56 @@
+// Checks the conversion of floating-point values to the fixed-point types:
+// rounding to nearest, saturation at and beyond the limits, and NaN.
+// Build with -fsanitize=undefined to also catch undefined casts.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/fixed_test.cpp -o fixed_test
+// Usage: fixed_test; exits with 1 if a check fails.
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include "math/Fixed.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+template<typename F, typename Storage>
+void conversions(const char* type) {
+    std::cout << type << " conversions:\n";
+    constexpr double step = 1.0 / double(std::uint64_t(1) << F::fractionBits);
+    constexpr Storage max = std::numeric_limits<Storage>::max();
+    constexpr Storage min = std::numeric_limits<Storage>::min();
+    const double limit = std::ldexp(1.0, int(sizeof(Storage) * 8 - 1)) * step;
+
+    check(F(2.5 * step).raw() == 3 && F(-2.5 * step).raw() == -3 && F(2.4 * step).raw() == 2, "  halves round away from zero",
+          double(F(2.5 * step).raw()));
+    check(F(0.49999999999999994 * step).raw() == 0 && F(-0.49999999999999994 * step).raw() == 0,
+          "  the largest value below one half rounds to zero", double(F(0.49999999999999994 * step).raw()));
+    check(F(std::numeric_limits<double>::quiet_NaN()).raw() == 0 && F(-std::numeric_limits<float>::quiet_NaN()).raw() == 0,
+          "  NaN becomes zero", 0);
+    check(F(std::numeric_limits<double>::infinity()).raw() == max && F(-std::numeric_limits<double>::infinity()).raw() == min,
+          "  infinities saturate", 0);
+    check(F(limit).raw() == max && F(limit * 4).raw() == max && F(-limit).raw() == min && F(-limit * 4).raw() == min,
+          "  values at and beyond the limits saturate", limit);
+    check(F(std::numeric_limits<double>::max()).raw() == max && F(std::numeric_limits<long double>::lowest()).raw() == min,
+          "  the largest doubles saturate", 0);
+
+    // The largest raw values that a double holds exactly convert exactly;
+    // half a step below the limit rounds up and saturates.
+    double inside = std::ldexp(1.0, int(sizeof(Storage) * 8 - 1)) - (sizeof(Storage) == 4 ? 1 : 1024);
+    check(F(inside * step).raw() == Storage(inside) && F(-inside * step).raw() == -Storage(inside), "  values just inside the limits", inside);
+    check(F(limit - 0.5 * step).raw() == max, "  half a step below the limit rounds to the maximum", double(F(limit - 0.5 * step).raw()));
+
+    constexpr F constant(-1.5);
+    static_assert(constant.raw() == -(Storage(3) << (F::fractionBits - 1)), "conversion must be constant-evaluable");
+}
+
+} // namespace
+
+int main() {
+    conversions<Fixed16, std::int32_t>("Fixed16");
+    conversions<Fixed32, std::int64_t>("Fixed32");
+    return test::exitCode();
+}
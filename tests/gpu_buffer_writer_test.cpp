@@ -0,0 +1,153 @@
+// Checks for the GPU buffer writer: std140 and std430 offsets and strides,
+// column-major matrices, transforms packed as mat3x4 rows, streaming
+// stores, and writes past the end of the buffer.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/gpu_buffer_writer_test.cpp -o gpu_buffer_writer_test
+// Usage: gpu_buffer_writer_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "render/GpuBufferWriter.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+// 16-byte aligned buffer memory, read back as floats.
+struct Buffer {
+    std::vector<GpuVec4> storage;
+    explicit Buffer(std::size_t bytes) : storage((bytes + 15) / 16) {}
+    void* data() { return storage.data(); }
+    float at(std::size_t offset) const {
+        float value;
+        std::memcpy(&value, reinterpret_cast<const unsigned char*>(storage.data()) + offset, sizeof(float));
+        return value;
+    }
+};
+
+void layouts() {
+    std::cout << "layouts:\n";
+    const float values[3] = { 1, 2, 3 };
+    Matrix4f matrix;
+
+    Buffer uniforms(256);
+    GpuBufferWriter std140(uniforms.data(), 256, BufferLayout::Std140);
+    std::size_t scalars = std140.writeScalars(values, 3);
+    bool padded = uniforms.at(0) == 1 && uniforms.at(16) == 2 && uniforms.at(32) == 3 && uniforms.at(4) == 0;
+    check(scalars == 0 && std140.offset() == 48 && padded, "  std140 scalar arrays have a stride of 16", double(std140.offset()));
+    std::size_t matrices = std140.writeMatrices(&matrix, 1);
+    check(matrices == 48 && std140.offset() == 112, "  and a mat4 follows directly", double(matrices));
+
+    Buffer storage(256);
+    GpuBufferWriter std430(storage.data(), 256, BufferLayout::Std430);
+    scalars = std430.writeScalars(values, 3);
+    bool packed = storage.at(0) == 1 && storage.at(4) == 2 && storage.at(8) == 3;
+    check(scalars == 0 && std430.offset() == 12 && packed, "  std430 scalar arrays are tightly packed", double(std430.offset()));
+    matrices = std430.writeMatrices(&matrix, 1);
+    check(matrices == 16 && std430.offset() == 80, "  and a mat4 is aligned to 16 after them", double(matrices));
+    Vector3f point(4, 5, 6);
+    std::size_t vectors = std430.writeVectors(&point, 1, 1.0f);
+    check(vectors == 80 && storage.at(80) == 4 && storage.at(88) == 6 && storage.at(92) == 1, "  Vector3 is written as a vec4 with w", double(vectors));
+}
+
+void matrices() {
+    std::cout << "matrices:\n";
+    Matrix4f m4;
+    Matrix3f m3;
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c) m4.data[r][c] = float(10 * r + c);
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c) m3.data[r][c] = float(10 * r + c);
+
+    Buffer buffer(256);
+    GpuBufferWriter writer(buffer.data(), 256);
+    std::size_t at4 = writer.writeMatrices(&m4, 1);
+    std::size_t at3 = writer.writeMatrices(&m3, 1);
+
+    bool columnMajor4 = true;
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c) columnMajor4 = columnMajor4 && buffer.at(at4 + 4 * (4 * c + r)) == m4.data[r][c];
+    check(columnMajor4, "  Matrix4x4 is stored column by column", buffer.at(at4 + 4));
+
+    bool columnMajor3 = at3 == 64 && writer.offset() == 112;
+    for (int c = 0; c < 3; ++c) {
+        for (int r = 0; r < 3; ++r) columnMajor3 = columnMajor3 && buffer.at(at3 + 4 * (4 * c + r)) == m3.data[r][c];
+        columnMajor3 = columnMajor3 && buffer.at(at3 + 4 * (4 * c + 3)) == 0;
+    }
+    check(columnMajor3, "  Matrix3x3 columns are padded to vec4", buffer.at(at3 + 4));
+}
+
+void transforms() {
+    std::cout << "transforms:\n";
+    Transformf transform(Vector3f(1, -2, 3), Quaternionf::fromAxisAngle(Vector3f(1, 2, 2).normalized(), 0.7f), Vector3f(2, 0.5f, 3));
+    Matrix4f matrix = transform.toMatrix();
+
+    Buffer buffer(96);
+    GpuBufferWriter writer(buffer.data(), 96);
+    std::size_t fromTransform = writer.writeAffineTransforms(&transform, 1);
+    std::size_t fromMatrix = writer.writeAffineTransforms(&matrix, 1);
+
+    double worst = 0;
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            worst = std::max(worst, double(std::fabs(buffer.at(fromTransform + 4 * (4 * r + c)) - matrix.data[r][c])));
+            worst = std::max(worst, double(std::fabs(buffer.at(fromMatrix + 4 * (4 * r + c)) - matrix.data[r][c])));
+        }
+    }
+    check(fromMatrix == 48 && worst < 1e-5, "  a transform gives the rows of its matrix", worst);
+}
+
+void streaming() {
+    std::cout << "streaming:\n";
+    std::vector<Quaternionf> rotations;
+    for (int i = 0; i < 64; ++i) rotations.push_back(Quaternionf::fromAxisAngle(Vector3f(0, 0, 1), 0.1f * float(i)));
+
+    Buffer cached(64 * 16), streamed(64 * 16);
+    GpuBufferWriter(cached.data(), 64 * 16).writeQuaternions(rotations.data(), rotations.size());
+    GpuBufferWriter(streamed.data(), 64 * 16, BufferLayout::Std430, 0).writeQuaternions(rotations.data(), rotations.size());
+    bool same = std::memcmp(cached.data(), streamed.data(), 64 * 16) == 0 && cached.at(12) == rotations[0].w;
+    check(same, "  streaming stores write the same bytes", cached.at(12));
+}
+
+void bounds() {
+    std::cout << "bounds:\n";
+    Matrix4f matrices[2];
+    Buffer buffer(112);
+    GpuBufferWriter writer(buffer.data(), 112);
+    writer.seek(8);
+
+    bool thrown = false;
+    try {
+        writer.writeMatrices(matrices, 2);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    check(thrown && writer.offset() == 8, "  a write past the end throws and moves nothing", double(writer.offset()));
+
+    std::size_t at = writer.writeMatrices(matrices, 1);
+    check(at == 16 && writer.offset() == 80, "  a write that fits after alignment succeeds", double(at));
+
+    thrown = false;
+    try {
+        writer.seek(113);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    check(thrown, "  seeking past the end throws", 0);
+}
+
+} // namespace
+
+int main() {
+    layouts();
+    matrices();
+    transforms();
+    streaming();
+    bounds();
+    return test::exitCode();
+}
@@ -0,0 +1,181 @@
+// Regression checks for degenerate inverse-kinematics inputs: opposite
+// bones, chains lying straight along the line to their targets, and
+// chains with cone limits.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/inverse_kinematics_test.cpp -pthread -o inverse_kinematics_test
+// Usage: inverse_kinematics_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include "anim/InverseKinematics.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+template<typename T>
+Vector3<T> element(const VectorArray<T, 3>& array, std::size_t i) {
+    return Vector3<T>(array.component(0)[i], array.component(1)[i], array.component(2)[i]);
+}
+
+template<typename T>
+Vector3<T> rotate(const VectorArray<T, 4>& rotations, std::size_t i, const Vector3<T>& v) {
+    Quaternion<T> q(rotations.component(3)[i], rotations.component(0)[i], rotations.component(1)[i], rotations.component(2)[i]);
+    return q * v;
+}
+
+template<typename T>
+void set(VectorArray<T, 3>& array, std::size_t i, const Vector3<T>& v) {
+    for (std::size_t c = 0; c < 3; ++c) array.component(c)[i] = v[static_cast<int>(c)];
+}
+
+// A straight six-joint chain along +y with targets on the same line behind
+// the root; the count is odd so both SIMD and scalar lanes run.
+template<typename T>
+void straightChain(IkChainMethod method, std::size_t iterations, T tolerance) {
+    const std::size_t joints = 6, chains = 11;
+    const T bone = T(0.5), reach = bone * T(joints - 1);
+    IkChainSettings<T> settings;
+    settings.method = method;
+    settings.maxIterations = iterations;
+    IkChainSolver<T> solver(joints, settings);
+
+    VectorArray<T, 3> positions(joints * chains), targets(chains);
+    for (std::size_t c = 0; c < chains; ++c) {
+        for (std::size_t j = 0; j < joints; ++j) set(positions, j * chains + c, Vector3<T>(0, bone * T(j), 0));
+        set(targets, c, Vector3<T>(0, T(-0.25) * T(c + 1), 0));
+    }
+    VectorArray<T, 3> before = positions;
+    solver.solve(positions, targets);
+
+    double endError = 0, lengthError = 0, rotationError = 0;
+    VectorArray<T, 4> rotations;
+    solver.boneRotations(before, positions, rotations);
+    for (std::size_t c = 0; c < chains; ++c) {
+        Vector3<T> target = element(targets, c);
+        double gap = std::max(0.0, double(target.length()) - double(reach));
+        endError = std::max(endError, double((element(positions, (joints - 1) * chains + c) - target).length()) - gap);
+        for (std::size_t j = 0; j + 1 < joints; ++j) {
+            Vector3<T> from = element(before, (j + 1) * chains + c) - element(before, j * chains + c);
+            Vector3<T> to = element(positions, (j + 1) * chains + c) - element(positions, j * chains + c);
+            lengthError = std::max(lengthError, std::abs(double(to.length()) - double(bone)));
+            rotationError = std::max(rotationError, double((rotate(rotations, j * chains + c, from) - to).length()));
+        }
+    }
+    const char* name = method == IkChainMethod::Fabrik ? "FABRIK" : "CCD";
+    std::cout << name << ", " << (sizeof(T) == 4 ? "float" : "double") << ":\n";
+    check(endError <= double(tolerance), "  straight chain reaches targets behind its root", endError);
+    check(lengthError <= 1e-4, "  bone lengths are kept", lengthError);
+    check(rotationError <= 1e-3, "  bone rotations turn the old bones onto the new ones", rotationError);
+}
+
+// Six-joint chains with a 1.2 radian cone on every inner joint, reaching for
+// the end effectors of random poses that bend at most 1.1 radians per joint.
+template<typename T>
+void coneLimitedChains(IkChainMethod method, std::size_t iterations) {
+    const std::size_t joints = 6, chains = 101;
+    const T cone = T(1.2), tolerance = T(1e-3);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<T> unit(T(-1), T(1));
+    auto direction = [&] {
+        for (;;) {
+            Vector3<T> v(unit(rng), unit(rng), unit(rng));
+            if (v.lengthSquared() > T(0.01) && v.lengthSquared() <= T(1)) return v.normalized();
+        }
+    };
+    auto pose = [&](std::vector<Vector3<T>>& points) {
+        points.assign(joints, Vector3<T>());
+        Vector3<T> d = direction();
+        for (std::size_t j = 1; j < joints; ++j) {
+            if (j > 1) {
+                Vector3<T> next;
+                do next = direction(); while (next.dot(d) < std::cos(T(1.1)));
+                d = next;
+            }
+            points[j] = points[j - 1] + d;
+        }
+    };
+
+    IkChainSettings<T> settings;
+    settings.method = method;
+    settings.maxIterations = iterations;
+    settings.tolerance = tolerance;
+    IkChainSolver<T> solver(joints, settings);
+    for (std::size_t j = 1; j + 1 < joints; ++j) solver.setConeLimit(j, cone);
+
+    VectorArray<T, 3> positions(joints * chains), targets(chains);
+    std::vector<Vector3<T>> start, goal;
+    for (std::size_t c = 0; c < chains; ++c) {
+        pose(start);
+        pose(goal);
+        for (std::size_t j = 0; j < joints; ++j) set(positions, j * chains + c, start[j]);
+        set(targets, c, goal[joints - 1]);
+    }
+    solver.solve(positions, targets);
+
+    double endError = 0, coneError = 0;
+    for (std::size_t c = 0; c < chains; ++c) {
+        endError = std::max(endError, double((element(positions, (joints - 1) * chains + c) - element(targets, c)).length()));
+        for (std::size_t j = 1; j + 1 < joints; ++j) {
+            Vector3<T> parent = element(positions, j * chains + c) - element(positions, (j - 1) * chains + c);
+            Vector3<T> bone = element(positions, (j + 1) * chains + c) - element(positions, j * chains + c);
+            double angle = std::acos(std::min(1.0, double(parent.normalized().dot(bone.normalized()))));
+            coneError = std::max(coneError, angle - double(cone));
+        }
+    }
+    std::cout << (method == IkChainMethod::Fabrik ? "FABRIK" : "CCD") << " with cone limits, "
+              << (sizeof(T) == 4 ? "float" : "double") << ":\n";
+    check(endError <= 1.5 * double(tolerance), "  reachable targets are reached", endError);
+    check(coneError <= 1e-3, "  bends stay within the cones", coneError);
+}
+
+template<typename T>
+void oppositeBones() {
+    std::cout << (sizeof(T) == 4 ? "float" : "double") << ":\n";
+
+    IkChainSolver<T> solver(2);
+    VectorArray<T, 3> before(2), after(2);
+    set(before, 1, Vector3<T>(0, 1, 0));
+    set(after, 1, Vector3<T>(0, -1, 0));
+    VectorArray<T, 4> rotations;
+    solver.boneRotations(before, after, rotations);
+    double reversed = (rotate(rotations, 0, Vector3<T>(0, 1, 0)) - Vector3<T>(0, -1, 0)).length();
+    check(reversed <= 1e-5, "  bone rotation of a reversed bone", reversed);
+
+    // A straight limb whose target is at full reach behind the root: the upper
+    // bone must turn half way round.
+    const std::size_t limbs = 9;
+    TwoBoneIkBatch<T> batch;
+    batch.resize(limbs);
+    for (std::size_t i = 0; i < limbs; ++i) {
+        set(batch.mid, i, Vector3<T>(0, 1, 0));
+        set(batch.end, i, Vector3<T>(0, 2, 0));
+        set(batch.target, i, Vector3<T>(0, -2, 0));
+    }
+    VectorArray<T, 4> roots, mids;
+    TwoBoneIk<T>::solve(batch, roots, mids);
+    double error = 0;
+    for (std::size_t i = 0; i < limbs; ++i) {
+        Vector3<T> end = rotate(roots, i, Vector3<T>(0, 1, 0)) + rotate(mids, i, Vector3<T>(0, 1, 0));
+        error = std::max(error, double((end - Vector3<T>(0, -2, 0)).length()));
+    }
+    check(error <= 1e-5, "  two-bone limb reaching straight behind its root", error);
+}
+
+} // namespace
+
+int main() {
+    for (IkChainMethod method : { IkChainMethod::Fabrik, IkChainMethod::Ccd }) {
+        std::size_t iterations = method == IkChainMethod::Fabrik ? 100 : 500;
+        straightChain<float>(method, iterations, method == IkChainMethod::Fabrik ? 2e-3f : 2e-2f);
+        straightChain<double>(method, iterations, method == IkChainMethod::Fabrik ? 2e-3 : 2e-2);
+        coneLimitedChains<float>(method, iterations);
+        coneLimitedChains<double>(method, iterations);
+    }
+    oppositeBones<float>();
+    oppositeBones<double>();
+    return test::exitCode();
+}
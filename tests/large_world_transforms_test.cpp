@@ -0,0 +1,121 @@
+// Checks for floating-origin transforms: precision far from the world
+// origin, updates that rebase only the changed objects, and origin shifts.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/large_world_transforms_test.cpp -pthread -o large_world_transforms_test
+// Usage: large_world_transforms_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "scene/LargeWorldTransforms.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+// Largest difference between the matrices and Transform::toMatrix() of the
+// objects relative to the origin, computed in double precision.
+double matrixError(const LargeWorldTransformsf& world) {
+    double worst = 0;
+    for (std::size_t i = 0; i < world.size(); ++i) {
+        Quaternionf r = world.rotation(i);
+        Vector3f s = world.scale(i);
+        Vector3<double> p = world.position(i) - world.origin();
+        Matrix4x4<double> expected = Transform<double>(p, Quaterniond(r.w, r.x, r.y, r.z), Vector3<double>(s.x, s.y, s.z)).toMatrix();
+        const Matrix4x4<float>& m = world.worldMatrices()[i];
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                double scale = std::max(1.0, std::abs(expected(row, column)));
+                worst = std::max(worst, std::abs(double(m(row, column)) - expected(row, column)) / scale);
+            }
+        }
+    }
+    return worst;
+}
+
+void precision() {
+    std::cout << "precision far from the origin:\n";
+    LargeWorldTransformsf world(1000.0);
+    const Vector3<double> base(1e7 + 0.125, -3e6, 5e6 + 0.5);
+    for (int i = 0; i < 8; ++i) world.add(base + Vector3<double>(0.001 * i, 0.25, -0.0625 * i));
+    world.update(base);
+
+    // A float holds 1e7 only to a unit; relative to the origin the millimetres remain.
+    double worst = 0, naive = 0;
+    for (std::size_t i = 0; i < world.size(); ++i) {
+        Vector3<double> exact = world.position(i) - world.origin();
+        Vector<float, 3> local = world.localPositions().get(i);
+        worst = std::max(worst, (Vector3<double>(local[0], local[1], local[2]) - exact).length());
+        float x = float(world.position(i).x) - float(base.x);
+        naive = std::max(naive, std::abs(double(x) - exact.x));
+    }
+    check(worst < 1e-4, "  positions near the camera keep sub-millimetre precision", worst);
+    check(naive > 1e-4, "  plain float positions would not", naive);
+    check(std::fmod(world.origin().x, 1000.0) == 0 && std::abs(world.origin().x - base.x) <= 500, "  the origin snaps to the grid",
+          world.origin().x);
+    check(matrixError(world) < 1e-6, "  matrices match Transform::toMatrix", matrixError(world));
+}
+
+void dirtyOnly() {
+    std::cout << "rebasing changed objects:\n";
+    LargeWorldTransformsf world(1000.0);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> offset(-400.0, 400.0);
+    for (int i = 0; i < 500; ++i) world.add(Vector3<double>(offset(rng), offset(rng), offset(rng)));
+    bool shifted = world.update(Vector3<double>(0, 0, 0));
+    check(!shifted && world.rebasedObjects().size() == 500, "  new objects are rebased", double(world.rebasedObjects().size()));
+    world.update(Vector3<double>(0, 0, 0));
+    check(world.rebasedObjects().empty(), "  nothing changed, nothing rebased", double(world.rebasedObjects().size()));
+
+    world.setPosition(420, Vector3<double>(10, 20, 30));
+    world.setRotation(17, Quaternionf::fromAxisAngle(Vector3f(0, 1, 0), 0.5f));
+    world.setScale(420, Vector3f(2, 2, 2));
+    world.setScale(3, Vector3f(1, 3, 1));
+    shifted = world.update(Vector3<double>(500, 0, 0));
+    check(!shifted && world.rebasedObjects() == std::vector<std::uint32_t>{ 3, 17, 420 }, "  only changed objects, once each, in order",
+          double(world.rebasedObjects().size()));
+    check(matrixError(world) < 1e-6, "  their matrices are recomposed", matrixError(world));
+    world.update(Vector3<double>(500, 0, 0));
+    check(world.rebasedObjects().empty(), "  their flags are cleared", double(world.rebasedObjects().size()));
+}
+
+void shift() {
+    std::cout << "origin shifts:\n";
+    for (int threads : { 0, 3 }) {
+        ThreadPool pool(threads == 0 ? 1 : threads);
+        LargeWorldTransformsf world(1000.0);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> offset(-3000.0, 3000.0), unit(-1.0, 1.0);
+        for (int i = 0; i < 20000; ++i) {
+            Quaternionf rotation = Quaternionf(float(unit(rng)), float(unit(rng)), float(unit(rng)), float(unit(rng))).normalized();
+            world.add(Vector3<double>(offset(rng), offset(rng), offset(rng)), rotation, Vector3f(1, 2, 0.5f));
+        }
+        ThreadPool* threadPool = threads == 0 ? nullptr : &pool;
+        world.update(Vector3<double>(0, 0, 0), threadPool);
+
+        // Objects changed in the shifting update are recomposed, not only moved.
+        world.setRotation(7, Quaternionf::fromAxisAngle(Vector3f(1, 0, 0), 1.0f));
+        world.setPosition(9000, Vector3<double>(2500, 2500, 2500));
+        bool shifted = world.update(Vector3<double>(2600, -10, 1200), threadPool);
+        check(shifted && world.origin() == Vector3<double>(3000, 0, 1000), "  the camera moved past the rebase distance",
+              world.origin().x);
+        check(world.rebasedObjects().size() == world.size(), "  every object is rebased", double(world.rebasedObjects().size()));
+        check(matrixError(world) < 1e-6, threads == 0 ? "  matrices relative to the new origin" : "  matrices relative to the new origin, threaded",
+              matrixError(world));
+        world.update(Vector3<double>(2600, -10, 1200), threadPool);
+        check(world.rebasedObjects().empty(), "  the next update rebases nothing", double(world.rebasedObjects().size()));
+    }
+}
+
+} // namespace
+
+int main() {
+    precision();
+    dirtyOnly();
+    shift();
+    return test::exitCode();
+}
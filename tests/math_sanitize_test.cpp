@@ -0,0 +1,105 @@
+// Checks for the non-finite tracking of RENDERFX_MATH_SANITIZE: the origin
+// of the first NaN or infinity, the per-batch counts, and clearing the log.
+// Built without the define, it checks that the macros compile away: they
+// are constant expressions and never evaluate their operands.
+//
+// Build: c++ -O2 -std=c++17 -DRENDERFX_MATH_SANITIZE -Iinclude tests/math_sanitize_test.cpp -o math_sanitize_test
+// Build: c++ -O2 -std=c++17 -Iinclude tests/math_sanitize_test.cpp -o math_sanitize_off_test
+// Usage: math_sanitize_test, math_sanitize_off_test; exit with 1 if a check fails.
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "math/MatrixMxN.h"
+#include "math/Vector3.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+const float nan = std::numeric_limits<float>::quiet_NaN();
+
+#if defined(RENDERFX_MATH_SANITIZE)
+
+void origins() {
+    std::cout << "origins:\n";
+    NonFiniteLog& log = NonFiniteLog::current();
+    log.clear();
+
+    Vector3f big(3e38f, 0, 0);
+    Vector3f sum = big + big;
+    Vector3f scaled = sum * 2.0f;
+    Vector3f moved = scaled - big;
+    (void)moved;
+    const NonFiniteOrigin& origin = log.origin();
+    check(log.hasOrigin() && std::strcmp(origin.operation, "Vector3::operator+") == 0, "  the overflowing operation is the origin", origin.line);
+    check(origin.operandsFinite && !origin.construction, "  made from finite operands", origin.operandsFinite);
+    check(std::strstr(origin.file, "Vector3.inl") != nullptr && origin.operands.find("Vector3(3.00000001e+38") != std::string::npos, "  with its location and operands", double(origin.operands.size()));
+    check(log.eventCount() >= 3, "  later propagation is only counted", double(log.eventCount()));
+
+    log.clear();
+    check(!log.hasOrigin() && log.eventCount() == 0, "  clear() forgets it", double(log.eventCount()));
+
+    Vector3f direct(nan, 0, 0);
+    (void)direct;
+    check(log.hasOrigin() && log.origin().construction && std::strcmp(log.origin().operation, "Vector3::Vector3") == 0, "  a constructor can be the origin", log.origin().line);
+    log.clear();
+}
+
+void batches() {
+    std::cout << "batches:\n";
+    NonFiniteLog& log = NonFiniteLog::current();
+    log.clear();
+
+    std::vector<Matrix4f> world(4, Matrix4f::identity());
+    std::vector<Matrix3f> normals(world.size());
+    computeNormalMatrices(world.data(), normals.data(), world.size());
+    check(log.batchReports().empty(), "  finite batches are not reported", double(log.batchReports().size()));
+
+    world[2].data[1][1] = nan;
+    computeNormalMatrices(world.data(), normals.data(), world.size());
+    computeNormalMatrices(world.data(), normals.data(), 2);
+    world[0].data[0][0] = nan;
+    computeNormalMatrices(world.data(), normals.data(), world.size());
+    const std::vector<NonFiniteBatchReport>& reports = log.batchReports();
+    bool counted = reports.size() == 2 && std::strcmp(reports[0].kernel, "computeNormalMatrices") == 0 &&
+                   reports[0].elements == 4 && reports[0].nonFinite == 1 && reports[1].elements == 4 && reports[1].nonFinite == 2;
+    check(counted, "  each call reports its element and non-finite counts", double(reports.size()));
+    log.clear();
+    check(log.batchReports().empty(), "  clear() drops the reports", double(log.batchReports().size()));
+}
+
+#else
+
+void compiledAway() {
+    std::cout << "compiled away:\n";
+    static_assert(RENDERFX_CHECK_FINITE("constant", 2 + 2, 0) == 4, "RENDERFX_CHECK_FINITE must be the bare expression");
+
+    int evaluations = 0;
+    // Only named inside the macros, which drop it.
+    [[maybe_unused]] auto touch = [&] { ++evaluations; return nan; };
+    RENDERFX_VERIFY_FINITE("verify", touch(), touch());
+    RENDERFX_CHECK_FINITE_CONSTRUCTION("construction", touch());
+    RENDERFX_CHECK_FINITE_BATCH("batch", (touch(), static_cast<float*>(nullptr)), static_cast<float*>(nullptr));
+    float value = RENDERFX_CHECK_FINITE("check", 1.0f, touch());
+    check(evaluations == 0 && value == 1.0f, "  the checks do not evaluate their operands", evaluations);
+
+    Vector3f sum = Vector3f(nan, 0, 0) + Vector3f(1, 2, 3);
+    check(sum.x != sum.x && sum.y == 2, "  non-finite values pass through unchecked", sum.y);
+}
+
+#endif
+
+} // namespace
+
+int main() {
+#if defined(RENDERFX_MATH_SANITIZE)
+    origins();
+    batches();
+#else
+    compiledAway();
+#endif
+    return test::exitCode();
+}
@@ -0,0 +1,147 @@
+// Round-trip and malformed-input checks for the text serialization of the
+// math types.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/math_serialization_test.cpp -o math_serialization_test
+// Usage: math_serialization_test; exits with 1 if a check fails.
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "math/MathSerialization.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+std::mt19937 rng(9);
+
+// Values over many magnitudes, including subnormals and the extremes.
+template<typename T>
+T randomValue() {
+    std::uniform_int_distribution<int> exponent(std::numeric_limits<T>::min_exponent - 5, std::numeric_limits<T>::max_exponent - 1);
+    std::uniform_real_distribution<T> mantissa(T(-1), T(1));
+    return std::ldexp(mantissa(rng), exponent(rng));
+}
+
+template<typename T>
+bool sameBits(T a, T b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<typename V>
+bool parseFails(const std::string& text) {
+    try {
+        math::parse<V>(text);
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+// Shortest round-trip text is unique per value, so a value survives when
+// its text reads back and formats to the same text again.
+template<typename V>
+bool survives(const V& value) {
+    std::string text = math::toString(value);
+    return math::toString(math::parse<V>(text)) == text;
+}
+
+template<typename T>
+void roundTrip(const char* type) {
+    std::cout << type << " round trip:\n";
+    std::size_t lost = 0;
+    for (int i = 0; i < 2000; ++i) {
+        Vector3<T> v(randomValue<T>(), randomValue<T>(), randomValue<T>());
+        Vector3<T> read = math::parse<Vector3<T>>(math::toString(v));
+        if (!sameBits(v.x, read.x) || !sameBits(v.y, read.y) || !sameBits(v.z, read.z)) ++lost;
+    }
+    check(lost == 0, "  Vector3 components read back bit for bit", double(lost));
+
+    lost = 0;
+    for (int i = 0; i < 500; ++i) {
+        Quaternion<T> q(randomValue<T>(), randomValue<T>(), randomValue<T>(), randomValue<T>());
+        Matrix4x4<T> m;
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) m(r, c) = randomValue<T>();
+        }
+        Transform<T> transform(Vector3<T>(randomValue<T>(), T(0), T(-1)), q, Vector3<T>(T(1), T(2), randomValue<T>()));
+        AABB<T> box(Vector3<T>(randomValue<T>(), T(1), T(2)), Vector3<T>(T(3), randomValue<T>(), T(5)));
+        Vector<T, 5> vector;
+        for (std::size_t k = 0; k < 5; ++k) vector[k] = randomValue<T>();
+        if (!survives(q) || !survives(m) || !survives(transform) || !survives(box) || !survives(vector)) ++lost;
+    }
+    check(lost == 0, "  quaternions, matrices, transforms, boxes and vectors", double(lost));
+
+    std::vector<Vector3<T>> values;
+    for (int i = 0; i < 300; ++i) values.emplace_back(randomValue<T>(), randomValue<T>(), randomValue<T>());
+    std::vector<Vector3<T>> read = math::parseArray<Vector3<T>>(math::toString(values.data(), values.size()));
+    lost = read.size() == values.size() ? 0 : values.size();
+    for (std::size_t i = 0; lost == 0 && i < values.size(); ++i) {
+        if (!sameBits(values[i].x, read[i].x) || !sameBits(values[i].y, read[i].y) || !sameBits(values[i].z, read[i].z)) ++lost;
+    }
+    check(lost == 0, "  arrays of vectors", double(read.size()));
+
+    // Non-finite values are written as null and read back as NaN.
+    Vector3<T> special(std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::infinity(), T(-0.0));
+    std::string text = math::toString(special);
+    Vector3<T> back = math::parse<Vector3<T>>(text);
+    check(text == "[null, null, -0]" && std::isnan(back.x) && std::isnan(back.y) && std::signbit(back.z),
+          "  non-finite values become null", 0);
+
+    // Keys in any order, extra whitespace, Euler rotations and missing keys.
+    Transform<T> parsed = math::parse<Transform<T>>(" {\n\"scale\" : [2, 2, 2],\t\"position\": [1, 2, 3] } ");
+    check(parsed.position == Vector3<T>(1, 2, 3) && parsed.scale == Vector3<T>(2, 2, 2) && parsed.rotation.w == T(1),
+          "  keys in any order, missing keys keep their defaults", 0);
+}
+
+template<typename T>
+void malformed(const char* type) {
+    std::cout << type << " malformed input:\n";
+    const char* vectors[] = { "", "[", "[1, 2", "[1, 2,]", "[1,, 2, 3]", "[1, 2, 3, 4]", "[1, 2]", "(1, 2, 3)", "[1 2 3]",
+                              "[nan, 0, 0]", "[inf, 0, 0]", "[1e999, 0, 0]", "[0x1p3, 0, 0]", "[1, 2, 3] x", "[\"1\", 2, 3]" };
+    std::size_t accepted = 0;
+    for (const char* text : vectors) {
+        if (!parseFails<Vector3<T>>(text)) {
+            std::cout << "        accepted " << text << "\n";
+            ++accepted;
+        }
+    }
+    check(accepted == 0, "  malformed vectors are rejected", double(accepted));
+
+    const char* objects[] = { "{", "{\"position\": [1, 2, 3]", "{\"position\" [1, 2, 3]}", "{position: [1, 2, 3]}",
+                              "{\"position\": [1, 2, 3],}", "{\"rotation\": [1, 2]}", "{\"scale\": null}" };
+    accepted = 0;
+    for (const char* text : objects) {
+        if (!parseFails<Transform<T>>(text)) {
+            std::cout << "        accepted " << text << "\n";
+            ++accepted;
+        }
+    }
+    check(accepted == 0, "  malformed transforms are rejected", double(accepted));
+
+    // The std-style overloads report errors instead of throwing, and
+    // report output ranges that are too small.
+    Vector3<T> v(T(1), T(2), T(3));
+    const char text[] = "[1, 2";
+    std::from_chars_result read = math::fromChars(text, text + 5, v);
+    check(read.ec == std::errc::invalid_argument && v == Vector3<T>(1, 2, 3), "  fromChars reports errors", 0);
+    char small[4];
+    std::to_chars_result written = math::toChars(small, small + sizeof(small), v);
+    check(written.ec == std::errc::value_too_large, "  toChars reports short output", 0);
+}
+
+} // namespace
+
+int main() {
+    roundTrip<float>("float");
+    roundTrip<double>("double");
+    malformed<float>("float");
+    malformed<double>("double");
+    return test::exitCode();
+}
@@ -0,0 +1,122 @@
+// Checks for the generic matrices: 3x3 inverses against known values, the
+// singular-matrix error, normal matrices under mirroring, the quaternion
+// round trip, and the batch normal matrices.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/matrix_mxn_test.cpp -o matrix_mxn_test
+// Usage: matrix_mxn_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "math/Geometry.h"
+#include "math/MatrixMxN.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+template<std::size_t R, std::size_t C>
+double difference(const Matrix<double, R, C>& a, const Matrix<double, R, C>& b) {
+    double worst = 0;
+    for (std::size_t r = 0; r < R; ++r)
+        for (std::size_t c = 0; c < C; ++c) worst = std::max(worst, std::fabs(a(r, c) - b(r, c)));
+    return worst;
+}
+
+void inverses() {
+    std::cout << "inverse:\n";
+    // A textbook matrix with determinant 1 and an integer inverse.
+    Matrix3d a(std::array<double, 9>{ 1, 2, 3, 0, 1, 4, 5, 6, 0 });
+    Matrix3d expected(std::array<double, 9>{ -24, 18, 5, 20, -15, -4, -5, 4, 1 });
+    check(a.determinant() == 1, "  determinant", a.determinant());
+    check(difference(a.inverse(), expected) < 1e-12, "  inverse of a known matrix", difference(a.inverse(), expected));
+
+    Matrix3d scaled(std::array<double, 9>{ 2, 0, 0, 0, 4, 0, 0, 0, -8 });
+    Matrix3d product = scaled * scaled.inverse();
+    check(difference(product, Matrix3d::identity()) < 1e-15, "  M * inverse(M) is the identity", difference(product, Matrix3d::identity()));
+
+    bool thrown = false;
+    try {
+        Matrix3d(std::array<double, 9>{ 1, 2, 3, 2, 4, 6, 1, 1, 1 }).inverse();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    check(thrown, "  a singular matrix throws", 0);
+}
+
+void normals() {
+    std::cout << "normal matrices:\n";
+    // A mirror in x with a non-uniform scale: the normal matrix must match
+    // the inverse transpose up to a positive factor.
+    Matrix3d mirror(std::array<double, 9>{ -2, 0, 0, 0, 1, 0, 0, 0, 3 });
+    Matrix3d reference = mirror.inverse().transposed() * std::fabs(mirror.determinant());
+    check(difference(mirror.normalMatrix(), reference) < 1e-12, "  mirrored normal matrix keeps the sign", difference(mirror.normalMatrix(), reference));
+
+    // The +x face of a unit cube ends up at x = -2 and must face -x.
+    Vector3d normal = mirror.normalMatrix().transformDirection(Vector3d(1, 0, 0));
+    check(normal.x < 0 && normal.y == 0 && normal.z == 0, "  the mirrored face normal points outwards", normal.x);
+
+    Matrix3d rotation = Matrix3d::fromQuaternion(Quaterniond::fromAxisAngle(Vector3d(0, 1, 0), 0.8));
+    check(difference(rotation.normalMatrix(), rotation) < 1e-12, "  a rotation is its own normal matrix", difference(rotation.normalMatrix(), rotation));
+}
+
+void quaternions() {
+    std::cout << "quaternions:\n";
+    // Includes half turns, where the real part is zero and another branch is taken.
+    const double angles[] = { 0.0, 0.3, 1.5, 3.0, 3.14159265358979 };
+    const Vector3d axes[] = { Vector3d(1, 0, 0), Vector3d(0, 1, 0), Vector3d(0, 0, 1), Vector3d(1, -2, 2).normalized() };
+    double worst = 0;
+    for (double angle : angles) {
+        for (const Vector3d& axis : axes) {
+            Quaterniond q = Quaterniond::fromAxisAngle(axis, angle);
+            if (q.w < 0) q = Quaterniond(-q.w, -q.x, -q.y, -q.z);
+            Quaterniond back = Matrix3d::fromQuaternion(q).toQuaternion();
+            double error = std::max({ std::fabs(back.w - q.w), std::fabs(back.x - q.x), std::fabs(back.y - q.y), std::fabs(back.z - q.z) });
+            // At a half turn q and -q have the same real part of zero.
+            if (std::fabs(q.w) < 1e-9) {
+                double flipped = std::max({ std::fabs(back.x + q.x), std::fabs(back.y + q.y), std::fabs(back.z + q.z) });
+                error = std::min(error, flipped);
+            }
+            worst = std::max(worst, error);
+        }
+    }
+    check(worst < 1e-12, "  fromQuaternion / toQuaternion round trip", worst);
+
+    Quaterniond q = Quaterniond::fromAxisAngle(Vector3d(0, 0, 1), 1.0);
+    Vector3d v(1, 2, 3);
+    Vector3d rotated = Matrix3d::fromQuaternion(q).transformDirection(v), expected = q * v;
+    check((rotated - expected).length() < 1e-12, "  the matrix rotates like the quaternion", (rotated - expected).length());
+}
+
+void batch() {
+    std::cout << "batch normal matrices:\n";
+    std::vector<Matrix4d> world;
+    for (int i = 0; i < 8; ++i) {
+        double sx = i % 2 ? -1.5 : 2.0, sz = i % 3 ? 0.5 : -1.0;
+        Transform<double> transform(Vector3d(i, -i, 2 * i), Quaterniond::fromAxisAngle(Vector3d(1, 1, 0).normalized(), 0.4 * i), Vector3d(sx, 1, sz));
+        world.push_back(transform.toMatrix());
+    }
+    std::vector<Matrix3d> normalMatrices(world.size());
+    computeNormalMatrices(world.data(), normalMatrices.data(), world.size());
+
+    double worst = 0;
+    for (std::size_t i = 0; i < world.size(); ++i) {
+        Matrix3d linear(world[i]);
+        worst = std::max(worst, difference(normalMatrices[i], linear.normalMatrix()));
+    }
+    check(worst < 1e-12, "  match normalMatrix() of each upper-left block", worst);
+}
+
+} // namespace
+
+int main() {
+    inverses();
+    normals();
+    quaternions();
+    batch();
+    return test::exitCode();
+}
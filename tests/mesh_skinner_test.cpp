@@ -0,0 +1,153 @@
+// Checks for the CPU mesh skinner: normals under non-uniform scale and
+// mirroring, blended influences, joint-index validation, and a dual
+// quaternion skinner kept across palette rebuilds.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/mesh_skinner_test.cpp -pthread -o mesh_skinner_test
+// Usage: mesh_skinner_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include "anim/MeshSkinner.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+GpuAffine3x4 affine(const float m[3][4]) {
+    GpuAffine3x4 a;
+    for (int r = 0; r < 3; ++r) a.rows[r] = GpuVec4{ m[r][0], m[r][1], m[r][2], m[r][3] };
+    return a;
+}
+
+Vector3<float> apply(const GpuAffine3x4& a, const Vector3<float>& v, float w) {
+    return Vector3<float>(a.rows[0].x * v.x + a.rows[0].y * v.y + a.rows[0].z * v.z + a.rows[0].w * w,
+                          a.rows[1].x * v.x + a.rows[1].y * v.y + a.rows[1].z * v.z + a.rows[1].w * w,
+                          a.rows[2].x * v.x + a.rows[2].y * v.y + a.rows[2].z * v.z + a.rows[2].w * w);
+}
+
+void normals() {
+    std::cout << "linear blend normals:\n";
+    // A non-uniform scale with shear, a mirror and a rotation with translation.
+    const float sheared[3][4] = { { 3, 1, 0, 1 }, { 0, 1, 0, 2 }, { 0, 0.5f, 0.25f, 3 } };
+    const float mirrored[3][4] = { { -1, 0, 0, 0 }, { 0, 2, 0, 0 }, { 0, 0, 1, 0 } };
+    const float rotated[3][4] = { { 0, -1, 0, 4 }, { 1, 0, 0, 0 }, { 0, 0, 1, 0 } };
+    const GpuAffine3x4 palette[3] = { affine(sheared), affine(mirrored), affine(rotated) };
+    MeshSkinner skinner(palette, 3);
+
+    // Each vertex lies on a plane spanned by two tangents, with the plane's
+    // normal; the skinned normal must stay perpendicular to the skinned
+    // tangents and keep facing the same side.
+    const std::size_t count = 64;
+    std::vector<Vector3<float>> positions(count), vertexNormals(count), tangents(count), bitangents(count);
+    std::vector<std::uint16_t> joints(count * 2);
+    std::vector<float> weights(count * 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        float a = 0.1f * float(i), b = 0.37f * float(i);
+        tangents[i] = Vector3<float>(std::cos(a), std::sin(a), 0.3f);
+        bitangents[i] = Vector3<float>(-std::sin(b), 0.2f, std::cos(b));
+        vertexNormals[i] = tangents[i].cross(bitangents[i]).normalized();
+        positions[i] = Vector3<float>(float(i), -1.0f, 0.5f);
+        joints[i * 2] = std::uint16_t(i % 3);
+        joints[i * 2 + 1] = std::uint16_t((i + 1) % 3);
+        weights[i * 2] = i % 4 == 0 ? 1.0f : 0.75f;
+        weights[i * 2 + 1] = 1.0f - weights[i * 2];
+    }
+    SkinWeights skin{ joints.data(), weights.data(), 2 };
+    std::vector<Vector3<float>> outPositions(count), outNormals(count);
+    skinner.skin(skin, positions.data(), vertexNormals.data(), count, outPositions.data(), outNormals.data());
+
+    double worstDot = 0, worstLength = 0, worstPosition = 0;
+    std::size_t flipped = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        GpuAffine3x4 blend;
+        for (int r = 0; r < 3; ++r) {
+            const GpuVec4& p = palette[joints[i * 2]].rows[r];
+            const GpuVec4& q = palette[joints[i * 2 + 1]].rows[r];
+            float wa = weights[i * 2], wb = weights[i * 2 + 1];
+            blend.rows[r] = GpuVec4{ wa * p.x + wb * q.x, wa * p.y + wb * q.y, wa * p.z + wb * q.z, wa * p.w + wb * q.w };
+        }
+        Vector3<float> t = apply(blend, tangents[i], 0), u = apply(blend, bitangents[i], 0);
+        Vector3<float> n = outNormals[i];
+        worstDot = std::max({ worstDot, double(std::abs(n.dot(t)) / t.length()), double(std::abs(n.dot(u)) / u.length()) });
+        worstLength = std::max(worstLength, double(std::abs(n.length() - 1)));
+        worstPosition = std::max(worstPosition, double((outPositions[i] - apply(blend, positions[i], 1)).length()));
+        // A mirroring transform turns surfaces inside out, so the normal
+        // must then point against the cross product of the tangents.
+        Vector3<float> c0 = apply(blend, Vector3<float>(1, 0, 0), 0), c1 = apply(blend, Vector3<float>(0, 1, 0), 0),
+                       c2 = apply(blend, Vector3<float>(0, 0, 1), 0);
+        float determinant = c0.dot(c1.cross(c2));
+        if (n.dot(t.cross(u)) * determinant <= 0) ++flipped;
+    }
+    check(worstDot < 1e-5, "  normals stay perpendicular to skinned tangents", worstDot);
+    check(worstLength < 1e-5, "  normals have unit length", worstLength);
+    check(flipped == 0, "  normals keep facing outside, also when mirrored", double(flipped));
+    check(worstPosition < 1e-4, "  positions match the blended matrices", worstPosition);
+}
+
+void jointIndices() {
+    std::cout << "joint indices:\n";
+    const float identity[3][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } };
+    const GpuAffine3x4 palette[1] = { affine(identity) };
+    MeshSkinner skinner(palette, 1);
+    const std::uint16_t joints[4] = { 0, 0, 0, 1 };
+    const float weights[4] = { 1.0f, 0.0f, 1.0f, 0.0f };
+    auto rejects = [&](std::size_t count) {
+        try {
+            skinner.validate(SkinWeights{ joints, weights, 2 }, count);
+            return false;
+        } catch (const std::out_of_range&) {
+            return true;
+        }
+    };
+    check(!rejects(1) && rejects(2), "  validate() finds an index past the palette", 0);
+
+#if defined(RENDERFX_MATH_SANITIZE)
+    Vector3<float> positions[2] = { Vector3<float>(1, 2, 3), Vector3<float>(4, 5, 6) }, out[2];
+    bool thrown = false;
+    try {
+        skinner.skin(SkinWeights{ joints, weights, 2 }, positions, nullptr, 2, out, nullptr);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    check(thrown, "  skin() checks indices in sanitized builds", 0);
+#endif
+}
+
+void paletteUpdates() {
+    std::cout << "palette updates:\n";
+    // One dual quaternion skinner kept while the palette is rebuilt.
+    GpuAffine3x4 palette[2];
+    const std::uint16_t joints[4] = { 0, 1, 1, 0 };
+    const float weights[4] = { 0.7f, 0.3f, 0.6f, 0.4f };
+    const Vector3<float> positions[2] = { Vector3<float>(1, 0, 0), Vector3<float>(0, 2, 1) };
+    MeshSkinner kept(palette, 2, SkinningMethod::DualQuaternion);
+    double worst = 0;
+    for (int frame = 0; frame < 3; ++frame) {
+        for (int j = 0; j < 2; ++j) {
+            Matrix4x4<float> m = Transform<float>(Vector3<float>(float(frame), 0, float(j)),
+                                                  Quaternionf::fromAxisAngle(Vector3<float>(0, 0, 1), 0.4f * float(frame + j)),
+                                                  Vector3<float>(1, 1, 1)).toMatrix();
+            palette[j] = GpuAffine3x4::from(m);
+        }
+        kept.setPalette(palette, 2);
+        MeshSkinner fresh(palette, 2, SkinningMethod::DualQuaternion);
+        Vector3<float> a[2], b[2];
+        kept.skin(SkinWeights{ joints, weights, 2 }, positions, nullptr, 2, a, nullptr);
+        fresh.skin(SkinWeights{ joints, weights, 2 }, positions, nullptr, 2, b, nullptr);
+        for (int i = 0; i < 2; ++i) worst = std::max(worst, double((a[i] - b[i]).length()));
+    }
+    check(worst == 0, "  setPalette() matches a new skinner every frame", worst);
+}
+
+} // namespace
+
+int main() {
+    normals();
+    jointIndices();
+    paletteUpdates();
+    return test::exitCode();
+}
@@ -0,0 +1,150 @@
+// Checks for the parallel OBJ loader: relative face indices resolve like
+// absolute ones, also across chunk boundaries, and out-of-range indices,
+// including relative ones that reach before the first element, are
+// rejected with the line they are on.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/obj_loader_test.cpp -pthread -o obj_loader_test
+// Usage: obj_loader_test; exits with 1 if a check fails.
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "scene/ObjLoader.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+// A grid of quads with all attributes listed before the faces, so relative
+// indices reach back across many chunks. Index i of n is written as i + 1
+// or as i - n.
+std::string gridText(std::size_t size, bool relative, bool attributes) {
+    std::string text = "# grid\n";
+    const std::size_t count = (size + 1) * (size + 1);
+    for (std::size_t y = 0; y <= size; ++y) {
+        for (std::size_t x = 0; x <= size; ++x) {
+            text += "v " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string((x * y) % 7) + "\n";
+            if (attributes) text += "vt " + std::to_string(x) + " " + std::to_string(y) + "\n";
+        }
+    }
+    if (attributes) text += "vn 0 0 1\nvn 0 1 0\n";
+    auto index = [&](std::size_t i, std::size_t n) {
+        return relative ? std::to_string(static_cast<long long>(i) - static_cast<long long>(n)) : std::to_string(i + 1);
+    };
+    for (std::size_t y = 0; y < size; ++y) {
+        text += "g row" + std::to_string(y) + "\n";
+        for (std::size_t x = 0; x < size; ++x) {
+            std::size_t corners[4] = { y * (size + 1) + x, y * (size + 1) + x + 1, (y + 1) * (size + 1) + x + 1, (y + 1) * (size + 1) + x };
+            text += "f";
+            for (std::size_t corner : corners) {
+                text += " " + index(corner, count);
+                if (attributes) text += "/" + index(corner, count) + "/" + index((x + y) % 2, 2);
+            }
+            text += "\n";
+        }
+    }
+    return text;
+}
+
+bool sameMesh(const Meshf& a, const Meshf& b) {
+    auto same = [](const float* x, const float* y, std::size_t n) { return n == 0 || std::memcmp(x, y, n * sizeof(float)) == 0; };
+    bool equal = a.vertexCount() == b.vertexCount() && a.indices == b.indices && a.normals.size() == b.normals.size() &&
+                 a.texCoords.size() == b.texCoords.size();
+    for (std::size_t c = 0; equal && c < 3; ++c) {
+        equal = same(a.positions.component(c), b.positions.component(c), a.positions.size()) &&
+                same(a.normals.component(c), b.normals.component(c), a.normals.size());
+    }
+    for (std::size_t c = 0; equal && c < 2; ++c) equal = same(a.texCoords.component(c), b.texCoords.component(c), a.texCoords.size());
+    return equal;
+}
+
+// Parses text and returns the error message, or an empty string.
+std::string parseError(ObjLoaderf& loader, const std::string& text) {
+    try {
+        loader.parse(text);
+        return std::string();
+    } catch (const std::runtime_error& error) {
+        return error.what();
+    }
+}
+
+void relativeIndices(ThreadPool& pool) {
+    std::cout << "relative indices:\n";
+    ObjLoaderf loader(pool);
+    for (bool attributes : { false, true }) {
+        Meshf absolute = loader.parse(gridText(160, false, attributes));
+        Meshf relative = loader.parse(gridText(160, true, attributes));
+        check(absolute.triangleCount() == 160 * 160 * 2 && sameMesh(absolute, relative),
+              attributes ? "  with attributes, relative and absolute indices give the same mesh"
+                         : "  positions only, relative and absolute indices give the same mesh",
+              double(relative.triangleCount()));
+    }
+
+    // Relative indices count from the statement, not the end of the file.
+    Meshf mesh = loader.parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nf -3//-1 -2//-1 -1//-1\nv 5 5 5\nf 1//1 -2//1 4//-1\n");
+    bool resolved = mesh.triangleCount() == 2 && mesh.vertexCount() == 4 && mesh.positions.component(0)[mesh.indices[3]] == 0.0f &&
+                    mesh.positions.component(0)[mesh.indices[4]] == 0.0f && mesh.positions.component(0)[mesh.indices[5]] == 5.0f;
+    check(resolved, "  relative indices count back from their statement", double(mesh.vertexCount()));
+}
+
+void outOfRange(ThreadPool& pool) {
+    std::cout << "out-of-range indices:\n";
+    ObjLoaderf loader(pool);
+    const std::string triangle = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\n";
+    struct Case {
+        std::string text;
+        const char* line;
+    };
+    const Case cases[] = {
+        { triangle + "f -4 -2 -1\n", "line 6:" },
+        { triangle + "f 1/-2 2/1 3/1\n", "line 6:" },
+        { triangle + "f 1/1/1 2/1/-2 3/1/1\n", "line 6:" },
+        { "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/-1 2/-1 3/-1\nvt 0 0\n", "line 4:" },
+        { "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1//-1 2//-1 3//-1\n", "line 4:" },
+        { triangle + "# comment\nf 1 2 3 4\n", "line 7:" },
+        { triangle + "f 1/2 2/1 3/1\n", "line 6:" },
+        { triangle + "f 1//1 2//1 3//2\n", "line 6:" },
+        { triangle + "f 1 2 3\nf 1 2 3 -1 -5\n", "line 7:" },
+    };
+    std::size_t wrong = 0;
+    for (const Case& test : cases) {
+        std::string message = parseError(loader, test.text);
+        if (message.find(test.line) == std::string::npos) {
+            std::cout << "        " << (message.empty() ? "accepted" : message) << "\n";
+            ++wrong;
+        }
+    }
+    check(wrong == 0, "  out-of-range indices are rejected with their line", double(wrong));
+
+    // A relative index before the start in the last chunk of a large file.
+    std::string text = gridText(160, true, true);
+    std::size_t lines = 0;
+    for (char c : text) lines += c == '\n' ? 1 : 0;
+    text += "f -1/-1/-1 -2/-2/-1 -3/-3/-3\n";
+    std::string message = parseError(loader, text);
+    check(message.find("line " + std::to_string(lines + 1) + ":") != std::string::npos,
+          "  the line is found in a later chunk", double(lines + 1));
+
+    const char* malformed[] = { "v 1 2\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 0 2\n",
+                                "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/x 2 3\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3x\n" };
+    std::size_t accepted = 0;
+    for (const char* test : malformed) {
+        if (parseError(loader, test).empty()) {
+            std::cout << "        accepted " << test;
+            ++accepted;
+        }
+    }
+    check(accepted == 0, "  malformed statements are rejected", double(accepted));
+}
+
+} // namespace
+
+int main() {
+    ThreadPool pool(4);
+    relativeIndices(pool);
+    outOfRange(pool);
+    return test::exitCode();
+}
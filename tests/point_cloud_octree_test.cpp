@@ -0,0 +1,225 @@
+// Round-trip and malformed-file checks for the out-of-core point cloud
+// octree: every input point must come back from the leaves, nodes must
+// nest and respect their capacity, select() must keep its budget, and
+// damaged files must be rejected when the octree is opened.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/point_cloud_octree_test.cpp -pthread -o point_cloud_octree_test
+// Usage: point_cloud_octree_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "scene/PointCloudOctree.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+std::string temporary(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<unsigned char> readBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+}
+
+// Clustered points far from the origin, so partitions are uneven and the
+// float offsets from node centers matter.
+std::vector<std::array<double, 3>> writePoints(const std::string& path, std::size_t count) {
+    std::mt19937 rng(17);
+    std::normal_distribution<double> spread(0.0, 20.0);
+    std::uniform_int_distribution<int> cluster(0, 4);
+    const double centers[5][3] = { { 1e5, 0, 0 }, { 1e5 + 300, 50, -80 }, { 1e5 - 200, -100, 40 }, { 1e5, 400, 400 }, { 1e5 + 5, 2, 1 } };
+    std::vector<std::array<double, 3>> points(count);
+    std::vector<double> packed;
+    for (auto& point : points) {
+        int c = cluster(rng);
+        for (int axis = 0; axis < 3; ++axis) {
+            point[axis] = centers[c][axis] + spread(rng) * (c == 4 ? 0.01 : 1.0);
+            packed.push_back(point[axis]);
+        }
+    }
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(packed.data()), std::streamsize(packed.size() * sizeof(double)));
+    return points;
+}
+
+void roundTrip(const std::string& base, const std::vector<std::array<double, 3>>& input, std::size_t capacity) {
+    std::cout << "round trip:\n";
+    PointCloudOctreed octree(base);
+    check(octree.pointCount() == input.size(), "  point count", double(octree.pointCount()));
+
+    // Leaves hold every input point once; points lie inside their node and
+    // children inside their parent.
+    std::vector<std::array<double, 3>> leafPoints;
+    std::size_t outside = 0, overfull = 0, misnested = 0;
+    for (std::size_t i = 0; i < octree.nodeCount(); ++i) {
+        const PointCloudNode& node = octree.node(i);
+        if (node.pointCount > capacity) ++overfull;
+        const float* points = octree.points(i);
+        for (std::uint32_t p = 0; p < node.pointCount; ++p) {
+            std::array<double, 3> point;
+            for (int axis = 0; axis < 3; ++axis) {
+                point[axis] = node.center[axis] + double(points[3 * p + axis]);
+                if (std::abs(point[axis] - node.center[axis]) > node.halfSize * (1 + 1e-6) + 1e-3) ++outside;
+            }
+            if (node.childMask == 0) leafPoints.push_back(point);
+        }
+        for (std::uint32_t c = 0; c < node.childCount(); ++c) {
+            const PointCloudNode& child = octree.node(node.firstChild + c);
+            // Centers are computed from cell coordinates, so allow rounding.
+            bool nested = child.level == node.level + 1 && child.halfSize * 2 == node.halfSize;
+            for (int axis = 0; axis < 3; ++axis) {
+                nested = nested && std::abs(std::abs(child.center[axis] - node.center[axis]) - child.halfSize) <= 1e-9 * node.halfSize;
+            }
+            if (!nested) ++misnested;
+        }
+    }
+    check(outside == 0, "  points lie inside their nodes", double(outside));
+    check(overfull == 0, "  nodes respect their capacity", double(overfull));
+    check(misnested == 0, "  children nest in their parents", double(misnested));
+
+    // Leaf points are rounded to float offsets, so each input point is
+    // matched to an unused leaf point within a small distance, found through
+    // a hash of unit cells.
+    std::map<std::array<long long, 3>, std::vector<std::size_t>> cells;
+    auto cellOf = [](const std::array<double, 3>& point) {
+        return std::array<long long, 3>{ std::llround(point[0]), std::llround(point[1]), std::llround(point[2]) };
+    };
+    for (std::size_t i = 0; i < leafPoints.size(); ++i) cells[cellOf(leafPoints[i])].push_back(i);
+    std::vector<bool> used(leafPoints.size(), false);
+    std::size_t unmatched = leafPoints.size() == input.size() ? 0 : input.size();
+    for (std::size_t i = 0; unmatched == 0 && i < input.size(); ++i) {
+        std::array<long long, 3> cell = cellOf(input[i]);
+        bool found = false;
+        for (int n = 0; n < 27 && !found; ++n) {
+            auto candidates = cells.find({ cell[0] + n % 3 - 1, cell[1] + n / 3 % 3 - 1, cell[2] + n / 9 - 1 });
+            if (candidates == cells.end()) continue;
+            for (std::size_t k : candidates->second) {
+                double distance = 0;
+                for (int axis = 0; axis < 3; ++axis) distance = std::max(distance, std::abs(leafPoints[k][axis] - input[i][axis]));
+                if (!used[k] && distance <= 1e-3) {
+                    used[k] = found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) ++unmatched;
+    }
+    check(unmatched == 0, "  leaves return every input point", double(unmatched));
+
+    // Selection keeps to the budget and refines towards the camera.
+    Vector3<double> camera(1e5, 0, -600);
+    Frustum<double> frustum(Matrix4x4<double>::perspective(1.0, 1.0, 1.0, 1e4) *
+                            Matrix4x4<double>::lookAt(camera, Vector3<double>(1e5, 0, 0), Vector3<double>(0, 1, 0)));
+    std::vector<std::uint32_t> selected;
+    std::uint64_t budget = input.size() / 3;
+    std::uint64_t total = octree.select(camera, frustum, 500.0, budget, 1.0, selected);
+    std::uint64_t sum = 0;
+    for (std::uint32_t index : selected) sum += octree.node(index).pointCount;
+    check(total <= budget && total == sum && selected.size() > 1, "  selection keeps to the point budget", double(total));
+    octree.select(camera, frustum, 500.0, 0, 1.0, selected);
+    check(selected.empty(), "  a zero budget selects nothing", double(selected.size()));
+}
+
+void damagedFiles(const std::string& base) {
+    std::cout << "damaged files:\n";
+    const std::string copy = temporary("point_cloud_octree_test_damaged");
+    const std::vector<unsigned char> table = readBytes(base + ".rfxoctree");
+    const std::vector<unsigned char> points = readBytes(base + ".rfxpoints");
+    auto opens = [&](const std::vector<unsigned char>& tableBytes, const std::vector<unsigned char>* pointBytes) {
+        writeBytes(copy + ".rfxoctree", tableBytes);
+        std::filesystem::remove(copy + ".rfxpoints");
+        if (pointBytes != nullptr) writeBytes(copy + ".rfxpoints", *pointBytes);
+        try {
+            PointCloudOctreed octree(copy);
+            return true;
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+    };
+
+    check(opens(table, &points), "  intact files open", double(table.size()));
+    check(!opens(std::vector<unsigned char>(table.begin(), table.end() - 8), &points), "  a truncated node table is rejected", 8);
+    check(!opens(std::vector<unsigned char>(table.begin(), table.begin() + 40), &points), "  a file shorter than the header is rejected", 40);
+    std::vector<unsigned char> corrupt = table;
+    corrupt[corrupt.size() - 20] ^= 0x40;
+    check(!opens(corrupt, &points), "  a corrupt node is rejected", 1);
+    corrupt = table;
+    corrupt[1] = 'X';
+    check(!opens(corrupt, &points), "  a wrong magic is rejected", 0);
+    check(!opens(table, nullptr), "  a missing points file is rejected", 0);
+    std::vector<unsigned char> fewer(points.begin(), points.end() - 12);
+    check(!opens(table, &fewer), "  a truncated points file is rejected", 12);
+    std::filesystem::remove(copy + ".rfxoctree");
+    std::filesystem::remove(copy + ".rfxpoints");
+
+    // An input that is not a whole number of points.
+    const std::string input = temporary("point_cloud_octree_test_odd.bin");
+    writeBytes(input, std::vector<unsigned char>(3 * sizeof(double) * 10 + 5, 0));
+    ThreadPool pool(2);
+    bool rejected = false;
+    try {
+        PointCloudOctreed::build(input, copy, pool);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    check(rejected, "  a partial point in the input is rejected", 0);
+
+    // Non-finite coordinates, which the bounds alone would not reveal for NaN.
+    const double nonFinite[] = { std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity() };
+    for (double value : nonFinite) {
+        std::vector<double> coordinates(3 * 10, 1.0);
+        coordinates[3 * 7 + 1] = value;
+        std::ofstream(input, std::ios::binary)
+            .write(reinterpret_cast<const char*>(coordinates.data()), std::streamsize(coordinates.size() * sizeof(double)));
+        rejected = false;
+        try {
+            PointCloudOctreed::build(input, copy, pool);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        check(rejected, std::isnan(value) ? "  a NaN point is rejected" : "  an infinite point is rejected", value);
+    }
+    std::filesystem::remove(input);
+    std::filesystem::remove(copy + ".rfxoctree");
+    std::filesystem::remove(copy + ".rfxpoints");
+}
+
+} // namespace
+
+int main() {
+    const std::string input = temporary("point_cloud_octree_test.bin");
+    const std::string base = temporary("point_cloud_octree_test");
+    std::vector<std::array<double, 3>> points = writePoints(input, 60000);
+
+    // A small memory budget forces the out-of-core partitioning.
+    PointCloudBuildSettings settings;
+    settings.nodeCapacity = 512;
+    settings.memoryBudget = 8000;
+    settings.temporaryDirectory = std::filesystem::temp_directory_path().string();
+    ThreadPool pool(4);
+    PointCloudOctreed::build(input, base, pool, settings);
+
+    roundTrip(base, points, settings.nodeCapacity);
+    damagedFiles(base);
+    std::filesystem::remove(input);
+    std::filesystem::remove(base + ".rfxoctree");
+    std::filesystem::remove(base + ".rfxpoints");
+    return test::exitCode();
+}
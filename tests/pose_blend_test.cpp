@@ -0,0 +1,198 @@
+// Checks for the pose blender: weighted, override, additive and masked
+// layers against Quaternion::slerp references, the hemisphere of weighted
+// rotations, and the sign handling of the scalar lanes.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/pose_blend_test.cpp -pthread -o pose_blend_test
+// Usage: pose_blend_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "anim/PoseBlend.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+// Not a multiple of the lane width, so the scalar tail runs as well.
+constexpr std::size_t jointCount = 11;
+
+// A pose whose joints turn by angle about their own axis, with some offset and scale.
+TransformSoAf makePose(float angle, float offset) {
+    TransformSoAf pose;
+    for (std::size_t j = 0; j < jointCount; ++j) {
+        Vector3f axis = Vector3f(1.0f, float(j % 3), float(j % 5) - 2.0f).normalized();
+        pose.push_back(Transformf(Vector3f(float(j) + offset, offset, -offset),
+                                  Quaternionf::fromAxisAngle(axis, angle * (1.0f + 0.1f * float(j))),
+                                  Vector3f(1.0f + offset, 1.0f, 1.0f - 0.5f * offset)));
+    }
+    return pose;
+}
+
+// Angle in radians between two rotations; atan2 stays accurate for small angles, unlike acos.
+float angleBetween(const Quaternionf& a, const Quaternionf& b) {
+    Quaternionf r = a.conjugate() * b;
+    double sine = std::sqrt(double(r.x) * r.x + double(r.y) * r.y + double(r.z) * r.z);
+    return float(2.0 * std::atan2(sine, std::fabs(double(r.w))));
+}
+
+// Largest rotation error against slerp(from, to, t[j]) and position error against the lerp.
+// The blender uses nlerp; for the angles between these poses, up to 0.6
+// radians, it stays within 1e-3 radians of slerp.
+float blendError(const TransformSoAf& out, const TransformSoAf& from, const TransformSoAf& to, const std::vector<float>& t) {
+    float worst = 0;
+    for (std::size_t j = 0; j < jointCount; ++j) {
+        Transformf a = from.get(j), b = to.get(j), result = out.get(j);
+        worst = std::max(worst, angleBetween(result.rotation, Quaternionf::slerp(a.rotation, b.rotation, t[j])));
+        worst = std::max(worst, (result.position - (a.position + (b.position - a.position) * t[j])).length());
+    }
+    return worst;
+}
+
+void weighted() {
+    std::cout << "weighted layers:\n";
+    TransformSoAf walk = makePose(0.2f, 0.0f), run = makePose(0.5f, 1.0f), out(walk);
+    PoseBlenderf blender(jointCount);
+
+    PoseLayerf layers[2];
+    layers[0].pose = &walk;
+    layers[0].weight = 1.0f;
+    layers[1].pose = &run;
+    layers[1].weight = 3.0f;
+    blender.blend(layers, 2, out);
+    float error = blendError(out, walk, run, std::vector<float>(jointCount, 0.75f));
+    check(error < 1e-3f, "  weights are normalized like slerp at 3/4", error);
+
+    // The same rotations with flipped signs must blend to the same pose.
+    TransformSoAf flipped(run);
+    for (std::size_t c = 0; c < 4; ++c)
+        for (std::size_t j = 0; j < jointCount; ++j) flipped.rotations.component(c)[j] = -flipped.rotations.component(c)[j];
+    TransformSoAf again(walk);
+    layers[1].pose = &flipped;
+    blender.blend(layers, 2, again);
+    float worst = 0;
+    for (std::size_t j = 0; j < jointCount; ++j) worst = std::max(worst, angleBetween(again.get(j).rotation, out.get(j).rotation));
+    check(worst < 1e-5f, "  rotations of the other hemisphere are flipped", worst);
+
+    layers[0].weight = 0.0f;
+    layers[1].weight = 0.0f;
+    blender.blend(layers, 2, again);
+    Transformf identity = again.get(jointCount - 1);
+    check(identity.rotation.w == 1 && identity.position.length() == 0 && identity.scale.x == 1, "  no weight at all gives the identity", identity.rotation.w);
+}
+
+void overrideAndMask() {
+    std::cout << "override and masked layers:\n";
+    TransformSoAf base = makePose(0.1f, 0.0f), aim = makePose(0.35f, 2.0f), out(base);
+    PoseBlenderf blender(jointCount);
+
+    PoseLayerf layers[2];
+    layers[0].pose = &base;
+    layers[1].pose = &aim;
+    layers[1].weight = 0.25f;
+    layers[1].mode = PoseLayerMode::Override;
+    blender.blend(layers, 2, out);
+    float error = blendError(out, base, aim, std::vector<float>(jointCount, 0.25f));
+    check(error < 1e-3f, "  an override layer is slerp by its weight", error);
+
+    // Upper body only: joints below 4 are left alone, joint 4 gets half.
+    std::vector<float> mask(jointCount, 1.0f), t(jointCount);
+    for (std::size_t j = 0; j < 4; ++j) mask[j] = 0.0f;
+    mask[4] = 0.5f;
+    for (std::size_t j = 0; j < jointCount; ++j) t[j] = 0.8f * mask[j];
+    layers[1].weight = 0.8f;
+    layers[1].mask = mask.data();
+    blender.blend(layers, 2, out);
+    error = blendError(out, base, aim, t);
+    check(error < 1e-3f, "  masks scale the weight per joint", error);
+    check(angleBetween(out.get(0).rotation, base.get(0).rotation) < 1e-5f, "  masked-out joints keep the base pose", angleBetween(out.get(0).rotation, base.get(0).rotation));
+}
+
+void additive() {
+    std::cout << "additive layers:\n";
+    TransformSoAf reference = makePose(0.3f, 0.0f), lean = makePose(0.7f, 0.5f), difference(lean), out(reference);
+    PoseBlenderf::makeAdditive(lean, reference, difference, 0, jointCount);
+
+    float worst = 0;
+    for (std::size_t j = 0; j < jointCount; ++j) {
+        Quaternionf expected = reference.get(j).rotation.conjugate() * lean.get(j).rotation;
+        worst = std::max(worst, angleBetween(difference.get(j).rotation, expected));
+    }
+    check(worst < 1e-5f, "  makeAdditive gives conjugate(reference) * pose", worst);
+
+    PoseBlenderf blender(jointCount);
+    PoseLayerf layers[2];
+    layers[0].pose = &reference;
+    layers[1].pose = &difference;
+    layers[1].mode = PoseLayerMode::Additive;
+    blender.blend(layers, 2, out);
+    float error = blendError(out, reference, lean, std::vector<float>(jointCount, 1.0f));
+    float scaleError = 0;
+    for (std::size_t j = 0; j < jointCount; ++j) scaleError = std::max(scaleError, (out.get(j).scale - lean.get(j).scale).length());
+    check(error < 1e-4f && scaleError < 1e-5f, "  weight 1 on the reference gives the pose back", std::max(error, scaleError));
+
+    // Half the difference rotation, applied in the joint frame.
+    layers[1].weight = 0.5f;
+    blender.blend(layers, 2, out);
+    worst = 0;
+    for (std::size_t j = 0; j < jointCount; ++j) {
+        Quaternionf delta = difference.get(j).rotation;
+        Quaternionf expected = reference.get(j).rotation * Quaternionf::slerp(Quaternionf(), delta, 0.5f);
+        worst = std::max(worst, angleBetween(out.get(j).rotation, expected));
+    }
+    check(worst < 1e-3f, "  half weight applies half the rotation", worst);
+}
+
+void crowd() {
+    std::cout << "crowds:\n";
+    TransformSoAf a = makePose(0.2f, 0.0f), b = makePose(0.9f, 1.0f);
+    const std::size_t characters = 40;
+    TransformSoAf serial, parallel;
+    serial.resize(characters * jointCount);
+    parallel.resize(characters * jointCount);
+
+    std::vector<PoseLayerf> layers(2 * characters);
+    std::vector<PoseBlendJobf> serialJobs(characters), parallelJobs(characters);
+    for (std::size_t i = 0; i < characters; ++i) {
+        layers[2 * i].pose = &a;
+        layers[2 * i + 1].pose = &b;
+        layers[2 * i + 1].weight = float(i) / float(characters);
+        serialJobs[i] = PoseBlendJobf{ &layers[2 * i], 2, &serial, i * jointCount };
+        parallelJobs[i] = PoseBlendJobf{ &layers[2 * i], 2, &parallel, i * jointCount };
+    }
+    PoseBlenderf blender(jointCount);
+    ThreadPool pool(3);
+    blender.blend(serialJobs.data(), characters, nullptr);
+    blender.blend(parallelJobs.data(), characters, &pool);
+
+    bool same = true;
+    for (std::size_t c = 0; c < 4; ++c)
+        same = same && std::equal(serial.rotations.component(c), serial.rotations.component(c) + serial.size(), parallel.rotations.component(c));
+    check(same, "  the thread count does not change the result", 0);
+}
+
+void lanes() {
+    std::cout << "lanes:\n";
+    using detail::ScalarLanes;
+    check(ScalarLanes::signOf(-0.0f, 2.0f) == -2.0f && ScalarLanes::signOf(0.0f, 2.0f) == 2.0f, "  scalar signOf follows the sign bit", ScalarLanes::signOf(-0.0f, 2.0f));
+#if RENDERFX_FLOAT_LANES >= 1
+    float simd[4], scalar[4];
+    const float signs[4] = { -0.0f, 0.0f, -3.0f, 5.0f };
+    detail::Sse2Lanes::store(simd, detail::Sse2Lanes::signOf(detail::Sse2Lanes::load(signs), detail::Sse2Lanes::set(1.5f)));
+    for (int i = 0; i < 4; ++i) scalar[i] = ScalarLanes::signOf(signs[i], 1.5f);
+    check(std::equal(simd, simd + 4, scalar), "  and matches the SSE lanes", scalar[0]);
+#endif
+}
+
+} // namespace
+
+int main() {
+    weighted();
+    overrideAndMask();
+    additive();
+    crowd();
+    lanes();
+    return test::exitCode();
+}
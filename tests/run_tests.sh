@@ -0,0 +1,41 @@
+#!/bin/sh
+# Builds and runs every test program in tests/ with the commands from its
+# "Build:" comments, then lists the programs that failed to build or run.
+# A source with several Build: comments is built and run once per comment,
+# e.g. with and without a configuration define.
+#
+# Usage: tests/run_tests.sh [output directory]; run from the repository
+# root. CXX overrides the compiler and CXXFLAGS adds flags, e.g.
+# CXXFLAGS="-DRENDERFX_MATH_SANITIZE -fsanitize=address,undefined".
+# Exits with 1 if a test fails.
+
+out=${1:-build/tests}
+mkdir -p "$out" || exit 1
+failed=""
+for source in tests/*.cpp; do
+    builds=$(sed -n 's|^// Build: c++ ||p' "$source")
+    if [ -z "$builds" ]; then
+        name=$(basename "$source" .cpp)
+        echo "$name: no Build: comment"
+        failed="$failed $name"
+        continue
+    fi
+    while IFS= read -r build; do
+        # The command ends with "-o <name>"; the binary goes to the output directory.
+        name=${build##* -o }
+        echo "== $name"
+        if ! ${CXX:-c++} $CXXFLAGS ${build% -o *} -o "$out/$name"; then
+            failed="$failed $name(build)"
+            continue
+        fi
+        "$out/$name" || failed="$failed $name"
+    done <<LIST
+$builds
+LIST
+done
+
+if [ -n "$failed" ]; then
+    echo "failed:$failed"
+    exit 1
+fi
+echo "all tests passed"
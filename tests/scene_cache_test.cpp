@@ -0,0 +1,171 @@
+// Checks for binary scene caches: the serialize/view and write/open round
+// trips, BVH culling against brute force, rejection of truncated, corrupt
+// and misaligned images, and a cache that was never opened.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/scene_cache_test.cpp -pthread -o scene_cache_test
+// Usage: scene_cache_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "scene/SceneCache.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+std::string sceneText(std::size_t count) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), unit(-1.0f, 1.0f), scale(0.5f, 2.0f);
+    std::ostringstream text;
+    text << std::setprecision(9) << "{ \"name\": \"Cache test\", \"objects\": [\n";
+    for (std::size_t i = 0; i < count; ++i) {
+        Quaternionf rotation = Quaternionf(unit(rng), unit(rng), unit(rng), unit(rng)).normalized();
+        text << (i != 0 ? ",\n" : "") << "{ \"name\": \"object " << i << "\", \"model\": \"models/m" << i % 7 << ".obj\", "
+             << "\"position\": [" << position(rng) << ", " << position(rng) << ", " << position(rng) << "], "
+             << "\"rotation\": [" << rotation.w << ", " << rotation.x << ", " << rotation.y << ", " << rotation.z << "], "
+             << "\"scale\": [" << scale(rng) << ", " << scale(rng) << ", " << scale(rng) << "] }";
+    }
+    text << "\n] }\n";
+    return text.str();
+}
+
+// Copies an image to storage aligned to 8 bytes, plus an offset.
+const unsigned char* place(const std::vector<unsigned char>& bytes, std::vector<std::uint64_t>& storage, std::size_t offset = 0) {
+    storage.assign(bytes.size() / 8 + 2, 0);
+    unsigned char* at = reinterpret_cast<unsigned char*>(storage.data()) + offset;
+    std::memcpy(at, bytes.data(), bytes.size());
+    return at;
+}
+
+bool sameAsScene(const SceneCachef& cache, const SceneDataf& scene) {
+    if (cache.size() != scene.size() || cache.name() != scene.name) return false;
+    for (std::size_t i = 0; i < scene.size(); ++i) {
+        Transform<float> a = cache.transform(i), b = scene.transforms.get(i);
+        bool sameRotation = a.rotation.w == b.rotation.w && a.rotation.x == b.rotation.x && a.rotation.y == b.rotation.y &&
+                            a.rotation.z == b.rotation.z;
+        if (a.position != b.position || !sameRotation || a.scale != b.scale) return false;
+        if (cache.objectName(i) != scene.objectName(i) || cache.objectModel(i) != scene.objectModel(i)) return false;
+    }
+    return true;
+}
+
+template<typename Function>
+bool throws(Function function) {
+    try {
+        function();
+        return false;
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+}
+
+void roundTrip(const SceneDataf& scene) {
+    std::cout << "round trip:\n";
+    std::vector<unsigned char> bytes = SceneCachef::serialize(scene);
+    std::vector<std::uint64_t> storage;
+    SceneCachef cache = SceneCachef::view(place(bytes, storage), bytes.size());
+    check(sameAsScene(cache, scene), "  view() returns the serialized scene", double(cache.size()));
+
+    const std::string path = (std::filesystem::temp_directory_path() / "scene_cache_test.rfxcache").string();
+    SceneCachef::write(path, scene);
+    SceneCachef opened = SceneCachef::open(path);
+    check(sameAsScene(opened, scene), "  open() returns the written scene", double(opened.size()));
+
+    // Culling through the BVH finds exactly the objects whose bounds intersect.
+    Frustum<float> frustum(Matrix4x4<float>::perspective(1.0f, 1.5f, 0.1f, 120.0f) *
+                           Matrix4x4<float>::lookAt(Vector3f(-20, 10, -30), Vector3f(10, 0, 20), Vector3f(0, 1, 0)));
+    std::vector<std::size_t> visible, expected;
+    opened.forEachVisible(frustum, [&](std::size_t index) { visible.push_back(index); });
+    for (std::size_t i = 0; i < opened.size(); ++i) {
+        if (frustum.intersects(opened.worldBounds(i))) expected.push_back(i);
+    }
+    std::sort(visible.begin(), visible.end());
+    check(visible == expected && !expected.empty() && expected.size() < opened.size(), "  BVH culling matches brute force",
+          double(visible.size()));
+
+    // Writers racing on one path each use their own temporary file, and none is left behind.
+    // Nor does a fixed temporary name in the way stop them.
+    std::filesystem::create_directory(path + ".tmp");
+    std::atomic<int> failures(0);
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([&] {
+            for (int k = 0; k < 5; ++k) failures += throws([&] { SceneCachef::write(path, scene); }) ? 1 : 0;
+        });
+    }
+    for (std::thread& writer : writers) writer.join();
+    std::size_t leftovers = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path())) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("scene_cache_test.rfxcache.", 0) == 0 && name != "scene_cache_test.rfxcache.tmp") ++leftovers;
+    }
+    SceneCachef rewritten = SceneCachef::open(path);
+    check(failures == 0 && leftovers == 0 && sameAsScene(rewritten, scene), "  concurrent writes", double(failures + leftovers));
+    std::filesystem::remove(path + ".tmp");
+    std::filesystem::remove(path);
+}
+
+void damagedFiles(const SceneDataf& scene) {
+    std::cout << "damaged files:\n";
+    std::vector<unsigned char> bytes = SceneCachef::serialize(scene);
+    const std::string path = (std::filesystem::temp_directory_path() / "scene_cache_test.rfxcache").string();
+    auto opens = [&](const std::vector<unsigned char>& file) {
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+        return !throws([&] { SceneCachef::open(path); });
+    };
+
+    check(opens(bytes), "  an intact file opens", double(bytes.size()));
+    check(!opens(std::vector<unsigned char>(bytes.begin(), bytes.end() - 64)), "  a truncated file is rejected", 64);
+    check(!opens(std::vector<unsigned char>(bytes.begin(), bytes.begin() + 100)), "  a file shorter than the header is rejected", 100);
+    std::vector<unsigned char> corrupt = bytes;
+    corrupt[corrupt.size() - 1] ^= 1;
+    check(!opens(corrupt), "  a corrupt file is rejected", 1);
+    std::filesystem::remove(path);
+
+    std::vector<std::uint64_t> storage;
+    check(throws([&] { SceneCachef::view(place(bytes, storage, 4), bytes.size()); }), "  a misaligned image is rejected", 4);
+    check(throws([&] { SceneCache<double>::view(place(bytes, storage), bytes.size()); }), "  another scalar type is rejected", 8);
+}
+
+void closedCache() {
+    std::cout << "closed cache:\n";
+    SceneCachef cache;
+    std::size_t visits = 0;
+    Frustum<float> frustum(Matrix4x4<float>::perspective(1.0f, 1.0f, 0.1f, 100.0f));
+    cache.forEachVisible(frustum, [&](std::size_t) { ++visits; });
+    bool empty = !cache.isOpen() && cache.size() == 0 && cache.nodeCount() == 0 && cache.name().empty() &&
+                 cache.positions(0) == nullptr && cache.nodes() == nullptr && cache.bvhObjects() == nullptr &&
+                 cache.header().objectCount == 0 && visits == 0;
+    check(empty, "  a default-constructed cache is empty", double(visits));
+    bool outOfRange = false;
+    try {
+        cache.transform(0);
+    } catch (const std::out_of_range&) {
+        outOfRange = true;
+    }
+    check(outOfRange, "  transform() of a closed cache is out of range", 0);
+}
+
+} // namespace
+
+int main() {
+    SceneLoaderf loader;
+    SceneDataf scene = loader.parse(sceneText(500));
+    roundTrip(scene);
+    damagedFiles(scene);
+    closedCache();
+    return test::exitCode();
+}
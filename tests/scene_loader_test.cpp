@@ -0,0 +1,166 @@
+// Round-trip and malformed-input checks for the .rfxscene loader.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/scene_loader_test.cpp -pthread -o scene_loader_test
+// Usage: scene_loader_test; exits with 1 if a check fails.
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "scene/SceneLoader.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+template<typename T>
+bool sameBits(const VectorArray<T, 3>& a, std::size_t i, const Vector3<T>& v) {
+    T values[3] = { a.component(0)[i], a.component(1)[i], a.component(2)[i] };
+    T expected[3] = { v.x, v.y, v.z };
+    return std::memcmp(values, expected, sizeof(values)) == 0;
+}
+
+// A scene of random transforms written with the math serialization, so
+// every number reads back exactly. Names need escapes and are long enough
+// for the 16-byte string scans.
+template<typename T>
+std::string sceneText(std::size_t count, std::vector<Transform<T>>& transforms, std::vector<std::string>& names) {
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<T> position(T(-1e4), T(1e4)), unit(T(-1), T(1)), scale(T(0.01), T(100));
+    std::string text = "{\n  \"name\": \"Loader \\\"test\\\"\",\n  \"version\": [1, { \"nested\": null }],\n  \"objects\": [";
+    for (std::size_t i = 0; i < count; ++i) {
+        Transform<T> transform(Vector3<T>(position(rng), position(rng), position(rng)),
+                               Quaternion<T>(unit(rng), unit(rng), unit(rng), unit(rng)).normalized(),
+                               Vector3<T>(scale(rng), scale(rng), scale(rng)));
+        transforms.push_back(transform);
+        names.push_back("object number " + std::to_string(i) + " with a \"quoted\" part, a \\ and caf\xC3\xA9 \xF0\x9F\x98\x80");
+        text += i != 0 ? ",\n    " : "\n    ";
+        text += "{ \"name\": \"object number " + std::to_string(i) + " with a \\\"quoted\\\" part, a \\\\ and caf\\u00e9 \\ud83d\\ude00\", ";
+        text += "\"model\": \"models/crate" + std::to_string(i % 5) + ".obj\", \"extra\": { \"tags\": [\"a\", \"b\"] }, ";
+        text += "\"position\": " + math::toString(transform.position) + ", \"rotation\": " + math::toString(transform.rotation) +
+                ", \"scale\": " + math::toString(transform.scale) + " }";
+    }
+    return text + "\n  ]\n}\n";
+}
+
+template<typename T>
+void roundTrip(const char* type) {
+    std::cout << type << " round trip:\n";
+    std::vector<Transform<T>> transforms;
+    std::vector<std::string> names;
+    std::string text = sceneText<T>(1000, transforms, names);
+    SceneLoader<T> loader;
+    SceneData<T> scene = loader.parse(text);
+
+    std::size_t wrong = scene.size() == transforms.size() ? 0 : transforms.size();
+    for (std::size_t i = 0; wrong == 0 && i < transforms.size(); ++i) {
+        const Quaternion<T>& q = transforms[i].rotation;
+        T rotation[4] = { scene.transforms.rotations.component(0)[i], scene.transforms.rotations.component(1)[i],
+                          scene.transforms.rotations.component(2)[i], scene.transforms.rotations.component(3)[i] };
+        T expected[4] = { q.x, q.y, q.z, q.w };
+        if (!sameBits(scene.transforms.positions, i, transforms[i].position) || !sameBits(scene.transforms.scales, i, transforms[i].scale) ||
+            std::memcmp(rotation, expected, sizeof(rotation)) != 0) {
+            ++wrong;
+        }
+        if (scene.objectName(i) != names[i] || scene.objectModel(i) != "models/crate" + std::to_string(i % 5) + ".obj") ++wrong;
+    }
+    check(wrong == 0, "  transforms, names and models read back exactly", double(wrong));
+    check(scene.name == "Loader \"test\"", "  scene name", double(scene.name.size()));
+
+    // Euler rotations go through the batch conversion; missing values are identities.
+    SceneData<T> euler = loader.parse("{\"objects\": [{\"rotation\": [0.25, -0.5, 1.5]}, {}, {\"rotation\": [1, 0, 0, 0]}]}");
+    Quaternion<T> expected = Quaternion<T>::fromEulerAngles(T(-0.5), T(1.5), T(0.25));
+    Transform<T> first = euler.transforms.get(0), second = euler.transforms.get(1);
+    double error = std::abs(double(first.rotation.w - expected.w)) + std::abs(double(first.rotation.x - expected.x)) +
+                   std::abs(double(first.rotation.y - expected.y)) + std::abs(double(first.rotation.z - expected.z));
+    check(euler.size() == 3 && error < 1e-5, "  Euler rotations", error);
+    check(second.position == Vector3<T>(0, 0, 0) && second.scale == Vector3<T>(1, 1, 1) && second.rotation.w == T(1),
+          "  missing values are identities", 0);
+
+    // Files, alone and in parallel.
+    std::vector<std::string> paths;
+    for (int i = 0; i < 3; ++i) {
+        paths.push_back((std::filesystem::temp_directory_path() / ("scene_loader_test" + std::to_string(i) + ".rfxscene")).string());
+        std::ofstream(paths.back(), std::ios::binary) << text;
+    }
+    ThreadPool pool(2);
+    std::vector<SceneData<T>> scenes = SceneLoader<T>::loadFiles(paths, pool);
+    bool same = scenes.size() == 3;
+    for (const SceneData<T>& loaded : scenes) {
+        same = same && loaded.size() == scene.size() && loaded.strings == scene.strings &&
+               std::memcmp(loaded.transforms.positions.component(0), scene.transforms.positions.component(0), scene.size() * sizeof(T)) == 0;
+    }
+    check(same, "  files loaded in parallel match the text", double(scenes.size()));
+    for (const std::string& path : paths) std::filesystem::remove(path);
+}
+
+template<typename T>
+void malformed(const char* type) {
+    std::cout << type << " malformed input:\n";
+    const char* texts[] = {
+        "",
+        "{",
+        "[]",
+        "{\"objects\": [",
+        "{\"objects\": [{\"position\": [1, 2, 3]}",
+        "{\"objects\": [{\"position\": [1, 2]}]}",
+        "{\"objects\": [{\"position\": [1, 2, 3, 4]}]}",
+        "{\"objects\": [{\"position\": [1, null, 3]}]}",
+        "{\"objects\": [{\"position\": [1, nan, 3]}]}",
+        "{\"objects\": [{\"position\": [1, 1e999, 3]}]}",
+        "{\"objects\": [{\"rotation\": [1, 0]}]}",
+        "{\"objects\": [{\"scale\": \"big\"}]}",
+        "{\"objects\": [{\"name\": \"unterminated}]}",
+        "{\"objects\": [{\"name\": \"bad \\q escape\"}]}",
+        "{\"objects\": [{\"name\": \"bad \\u12\"}]}",
+        "{\"objects\": [{\"name\": \"\\ud83d\\u0041\"}]}",
+        "{\"objects\": [{\"name\" \"missing colon\"}]}",
+        "{\"objects\": [{}],}",
+        "{\"objects\": [{}]} trailing",
+        "{\"other\": [1, 2, }",
+    };
+    SceneLoader<T> loader;
+    std::size_t accepted = 0, changed = 0;
+    for (const char* text : texts) {
+        // A failed parse leaves the scene it appends to as it was.
+        SceneData<T> scene = loader.parse("{\"name\": \"kept\", \"objects\": [{\"name\": \"first\", \"position\": [1, 2, 3]}]}");
+        SceneData<T> before = scene;
+        scene.name.clear();
+        try {
+            loader.parse(text, scene);
+            std::cout << "        accepted " << text << "\n";
+            ++accepted;
+        } catch (const std::runtime_error&) {
+        }
+        if (scene.size() != before.size() || scene.strings != before.strings || scene.transforms.size() != before.transforms.size() ||
+            !scene.name.empty()) {
+            ++changed;
+        }
+    }
+    check(accepted == 0, "  malformed scenes are rejected", double(accepted));
+    check(changed == 0, "  a failed parse leaves the scene unchanged", double(changed));
+
+    bool missing = false;
+    try {
+        loader.loadFile((std::filesystem::temp_directory_path() / "scene_loader_test_missing.rfxscene").string());
+    } catch (const std::runtime_error&) {
+        missing = true;
+    }
+    check(missing, "  a missing file is reported", 0);
+}
+
+} // namespace
+
+int main() {
+    roundTrip<float>("float");
+    roundTrip<double>("double");
+    malformed<float>("float");
+    malformed<double>("double");
+    return test::exitCode();
+}
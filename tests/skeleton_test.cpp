@@ -0,0 +1,161 @@
+// Checks for skeleton composition: the SSE float path and the scalar double
+// path against chained Transform::toMatrix() products, the identity palette
+// of the bind pose, and threaded palette builds.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/skeleton_test.cpp -pthread -o skeleton_test
+// Usage: skeleton_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "anim/Skeleton.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+// Two branches off the root, with a deeper chain on the first.
+const std::vector<std::int32_t> parents = { -1, 0, 1, 2, 1, 4, 0, 6, 7 };
+
+// Local transforms with rotated parents and non-uniform scales; phase varies the pose.
+template<typename T>
+TransformSoA<T> makePose(double phase) {
+    TransformSoA<T> pose;
+    for (std::size_t j = 0; j < parents.size(); ++j) {
+        double angle = 0.3 + phase * double(j + 1);
+        Vector3<T> axis = Vector3<T>(T(1), T(j % 3), T(2) - T(j % 4)).normalized();
+        pose.push_back(Transform<T>(Vector3<T>(T(0.5 * j), T(1), T(-0.25 * j)),
+                                    Quaternion<T>::fromAxisAngle(axis, T(angle)),
+                                    Vector3<T>(T(1 + 0.1 * j), T(0.8), T(1.2 - 0.05 * j))));
+    }
+    return pose;
+}
+
+// Model-space transforms as products of 4x4 matrices from the root down.
+std::vector<Matrix4d> referenceModel(const TransformSoA<double>& pose) {
+    std::vector<Matrix4d> model(parents.size());
+    for (std::size_t j = 0; j < parents.size(); ++j) {
+        Matrix4d local = pose.get(j).toMatrix();
+        model[j] = parents[j] < 0 ? local : model[std::size_t(parents[j])] * local;
+    }
+    return model;
+}
+
+// Largest difference of the 3x4 part, relative to the size of the reference.
+template<typename T>
+double modelError(const std::vector<Matrix3x4<T>>& model, const std::vector<Matrix4d>& reference) {
+    double worst = 0;
+    for (std::size_t j = 0; j < model.size(); ++j) {
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                double expected = reference[j].data[r][c];
+                worst = std::max(worst, std::fabs(double(model[j](r, c)) - expected) / std::max(1.0, std::fabs(expected)));
+            }
+        }
+    }
+    return worst;
+}
+
+void composition() {
+    std::cout << "composition:\n";
+    TransformSoA<double> pose = makePose<double>(0.4);
+    std::vector<Matrix4d> reference = referenceModel(pose);
+    std::vector<Matrix3x4d> identities(parents.size(), Matrix3x4d::identity());
+
+    Skeleton<double> scalar(parents, identities);
+    std::vector<Matrix3x4d> modelDouble(parents.size());
+    scalar.localToModel(pose, 0, modelDouble.data());
+    check(modelError(modelDouble, reference) < 1e-12, "  double matches the chained 4x4 products", modelError(modelDouble, reference));
+
+    Skeletonf simd(parents, std::vector<Matrix3x4f>(parents.size(), Matrix3x4f::identity()));
+    std::vector<Matrix3x4f> modelFloat(parents.size());
+    simd.localToModel(makePose<float>(0.4), 0, modelFloat.data());
+    check(modelError(modelFloat, reference) < 1e-5, "  float matches the chained 4x4 products", modelError(modelFloat, reference));
+
+    // An offset into a crowd array reads the right joints.
+    TransformSoAf crowd = makePose<float>(0.1);
+    crowd.append(makePose<float>(0.4));
+    std::vector<Matrix3x4f> second(parents.size());
+    simd.localToModel(crowd, parents.size(), second.data());
+    check(modelError(second, reference) < 1e-5, "  poses at an offset", modelError(second, reference));
+}
+
+// Largest difference of a palette from the identity transform.
+double identityError(const std::vector<GpuAffine3x4>& palette) {
+    double worst = 0;
+    for (const GpuAffine3x4& m : palette) {
+        for (int r = 0; r < 3; ++r) {
+            const float row[4] = { m.rows[r].x, m.rows[r].y, m.rows[r].z, m.rows[r].w };
+            for (int c = 0; c < 4; ++c) worst = std::max(worst, std::fabs(double(row[c]) - (r == c ? 1.0 : 0.0)));
+        }
+    }
+    return worst;
+}
+
+void bindPose() {
+    std::cout << "bind pose:\n";
+    TransformSoAf bind = makePose<float>(0.2);
+    Skeletonf skeleton = Skeletonf::fromBindPose(parents, bind);
+    std::vector<Matrix3x4f> model(parents.size());
+    std::vector<GpuAffine3x4> palette(parents.size());
+    skeleton.buildPalette(bind, 0, model.data(), palette.data());
+    check(identityError(palette) < 1e-5, "  the bind pose gives an identity palette", identityError(palette));
+
+    TransformSoA<double> bindDouble = makePose<double>(0.2);
+    Skeleton<double> precise = Skeleton<double>::fromBindPose(parents, bindDouble);
+    std::vector<Matrix3x4d> modelDouble(parents.size());
+    precise.buildPalette(bindDouble, 0, modelDouble.data(), palette.data());
+    check(identityError(palette) < 1e-6, "  also with double", identityError(palette));
+
+    // Away from the bind pose, the palette takes bind space to the posed model space.
+    std::vector<Matrix4d> bindModel = referenceModel(bindDouble), posedModel = referenceModel(makePose<double>(0.5));
+    skeleton.buildPalette(makePose<float>(0.5), 0, model.data(), palette.data());
+    double worst = 0;
+    for (std::size_t j = 0; j < parents.size(); ++j) {
+        Matrix4d expected = posedModel[j] * bindModel[j].inverse();
+        for (int r = 0; r < 3; ++r) {
+            const float row[4] = { palette[j].rows[r].x, palette[j].rows[r].y, palette[j].rows[r].z, palette[j].rows[r].w };
+            for (int c = 0; c < 4; ++c) worst = std::max(worst, std::fabs(double(row[c]) - expected.data[r][c]));
+        }
+    }
+    check(worst < 1e-4, "  posed palettes are model times inverse bind", worst);
+}
+
+void crowds() {
+    std::cout << "crowds:\n";
+    const std::size_t characters = 32, joints = parents.size();
+    Skeletonf skeleton = Skeletonf::fromBindPose(parents, makePose<float>(0.2));
+    TransformSoAf locals;
+    for (std::size_t i = 0; i < characters; ++i) locals.append(makePose<float>(0.01 * double(i)));
+
+    std::vector<GpuAffine3x4> serial(characters * joints), parallel(characters * joints);
+    std::vector<Matrix3x4f> model(characters * joints);
+    std::vector<SkinningPaletteJobf> serialJobs(characters), parallelJobs(characters);
+    for (std::size_t i = 0; i < characters; ++i) {
+        serialJobs[i] = SkinningPaletteJobf{ &locals, i * joints, &serial[i * joints], nullptr };
+        parallelJobs[i] = SkinningPaletteJobf{ &locals, i * joints, &parallel[i * joints], &model[i * joints] };
+    }
+    ThreadPool pool(3);
+    skeleton.buildPalettes(serialJobs.data(), characters);
+    skeleton.buildPalettes(parallelJobs.data(), characters, &pool, true);
+    bool same = std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(GpuAffine3x4)) == 0;
+    check(same, "  threads and streaming stores give the same palettes", 0);
+
+    std::vector<Matrix3x4f> direct(joints);
+    skeleton.localToModel(locals, 5 * joints, direct.data());
+    same = std::equal(direct.begin(), direct.end(), model.begin() + std::ptrdiff_t(5 * joints));
+    check(same, "  and the requested model transforms", 0);
+}
+
+} // namespace
+
+int main() {
+    composition();
+    bindPose();
+    crowds();
+    return test::exitCode();
+}
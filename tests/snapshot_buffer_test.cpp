@@ -0,0 +1,160 @@
+// Checks for the snapshot jitter buffer: holding, interpolation, clamped
+// extrapolation, eviction when full, entity counts that change between
+// snapshots, and the rejection of non-finite times.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/snapshot_buffer_test.cpp -pthread -o snapshot_buffer_test
+// Usage: snapshot_buffer_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "net/SnapshotBuffer.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+constexpr float speed = 10.0f; // Units per second along +x.
+constexpr float spin = 2.0f;   // Radians per second about +z.
+
+// Entity i starts at x = i and moves and turns at a constant rate.
+TransformSoAf snapshotAt(double time, std::size_t count) {
+    TransformSoAf transforms;
+    for (std::size_t i = 0; i < count; ++i) {
+        float angle = spin * float(time);
+        transforms.push_back(Transformf(Vector3f(float(i) + speed * float(time), 0, 0),
+                                        Quaternionf::fromAxisAngle(Vector3f(0, 0, 1), angle), Vector3f(1, 1, 1)));
+    }
+    return transforms;
+}
+
+// Largest position and rotation error of every entity against its motion at a time.
+double error(const TransformSoAf& out, double time) {
+    TransformSoAf expected = snapshotAt(time, out.size());
+    double worst = 0;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        Transformf a = out.get(i), b = expected.get(i);
+        worst = std::max(worst, double((a.position - b.position).length()));
+        float dot = std::fabs(a.rotation.w * b.rotation.w + a.rotation.x * b.rotation.x +
+                              a.rotation.y * b.rotation.y + a.rotation.z * b.rotation.z);
+        worst = std::max(worst, double(1.0f - std::min(dot, 1.0f)));
+    }
+    return worst;
+}
+
+void holdAndInterpolate() {
+    std::cout << "hold and interpolate:\n";
+    SnapshotBufferf buffer;
+    TransformSoAf out;
+    SnapshotSample result = buffer.sample(0.0, out);
+    check(result == SnapshotSample::Empty && out.empty(), "  an empty buffer leaves the output alone", double(out.size()));
+
+    buffer.push(0.1, snapshotAt(0.1, 4));
+    result = buffer.sample(0.5, out);
+    check(result == SnapshotSample::Held && error(out, 0.1) < 1e-6, "  a single snapshot is held", error(out, 0.1));
+
+    buffer.push(0.2, snapshotAt(0.2, 4));
+    buffer.push(0.0, snapshotAt(0.0, 4));
+    check(buffer.size() == 3 && buffer.oldestTime() == 0.0 && buffer.newestTime() == 0.2, "  late snapshots are sorted in", buffer.oldestTime());
+    result = buffer.sample(-1.0, out);
+    check(result == SnapshotSample::Held && error(out, 0.0) < 1e-6, "  times before the oldest hold it", error(out, 0.0));
+
+    for (double time : {0.05, 0.1, 0.125, 0.175}) {
+        result = buffer.sample(time, out);
+        check(result == SnapshotSample::Interpolated && error(out, time) < 1e-4, "  interpolates between the bracketing snapshots", error(out, time));
+    }
+
+    ThreadPool pool(2);
+    TransformSoAf many = snapshotAt(0.0, 20000), later = snapshotAt(0.1, 20000), serial, parallel;
+    SnapshotBufferf large;
+    large.push(0.0, many);
+    large.push(0.1, later);
+    large.sample(0.03, serial);
+    large.sample(0.03, parallel, &pool);
+    check(error(parallel, 0.03) < 1e-4 && error(serial, 0.03) < 1e-4, "  a pool gives the same result", error(parallel, 0.03));
+}
+
+void extrapolate() {
+    std::cout << "extrapolation:\n";
+    SnapshotBufferf buffer(8, 0.05);
+    buffer.push(0.0, snapshotAt(0.0, 3));
+    buffer.push(0.1, snapshotAt(0.1, 3));
+    TransformSoAf out;
+
+    SnapshotSample result = buffer.sample(0.1, out);
+    check(result == SnapshotSample::Interpolated && error(out, 0.1) < 1e-5, "  the newest time is interpolated", error(out, 0.1));
+    result = buffer.sample(0.13, out);
+    check(result == SnapshotSample::Extrapolated && error(out, 0.13) < 1e-4, "  motion continues past the newest", error(out, 0.13));
+    result = buffer.sample(1.0, out);
+    check(result == SnapshotSample::Extrapolated && error(out, 0.15) < 1e-4, "  and stops at maxExtrapolation", error(out, 0.15));
+}
+
+void eviction() {
+    std::cout << "eviction:\n";
+    SnapshotBufferf buffer(3);
+    TransformSoAf transforms = snapshotAt(0.0, 1);
+    for (double time : {0.0, 0.1, 0.2, 0.3}) buffer.push(time, transforms);
+    check(buffer.size() == 3 && buffer.oldestTime() == 0.1 && buffer.newestTime() == 0.3, "  the oldest is replaced when full", buffer.oldestTime());
+    bool pushed = buffer.push(0.05, transforms);
+    check(!pushed && buffer.oldestTime() == 0.1, "  snapshots older than all kept are dropped", buffer.oldestTime());
+    pushed = buffer.push(0.2, transforms);
+    check(!pushed && buffer.size() == 3, "  duplicates are dropped", double(buffer.size()));
+    pushed = buffer.push(0.25, transforms);
+    check(pushed && buffer.oldestTime() == 0.2 && buffer.newestTime() == 0.3, "  a late snapshot evicts the oldest", buffer.oldestTime());
+
+    bool rejected = false;
+    for (double time : {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity()}) {
+        try {
+            buffer.insert(time);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+            continue;
+        }
+        rejected = false;
+        break;
+    }
+    check(rejected && buffer.size() == 3, "  non-finite times are rejected", double(buffer.size()));
+
+    bool renderRejected = false;
+    TransformSoAf out;
+    try {
+        buffer.sample(std::numeric_limits<double>::quiet_NaN(), out);
+    } catch (const std::invalid_argument&) {
+        renderRejected = true;
+    }
+    check(renderRejected, "  and so are non-finite render times", 0);
+}
+
+void entityCounts() {
+    std::cout << "entity counts:\n";
+    SnapshotBufferf growing;
+    growing.push(0.0, snapshotAt(0.0, 2));
+    growing.push(0.1, snapshotAt(0.1, 5));
+    TransformSoAf out;
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        growing.sample(0.05, out);
+        bool spawned = out.size() == 5;
+        for (std::size_t i = 2; spawned && i < 5; ++i) spawned = out.get(i).position.x == float(i) + speed * 0.1f;
+        Transformf kept = out.get(1);
+        check(spawned && std::fabs(kept.position.x - (1.0f + speed * 0.05f)) < 1e-4f, "  new entities are copied from the newer snapshot", double(out.size()));
+    }
+
+    SnapshotBufferf shrinking;
+    shrinking.push(0.0, snapshotAt(0.0, 5));
+    shrinking.push(0.1, snapshotAt(0.1, 2));
+    shrinking.sample(0.05, out);
+    check(out.size() == 2 && error(out, 0.05) < 1e-4, "  despawned entities are dropped", double(out.size()));
+}
+
+} // namespace
+
+int main() {
+    holdAndInterpolate();
+    extrapolate();
+    eviction();
+    entityCounts();
+    return test::exitCode();
+}
@@ -0,0 +1,144 @@
+// Checks for splines: end points and tangents of every curve type, the
+// arc-length lookup against a brute-force integration, and the quaternion
+// log, exp and squad continuity of rotation splines.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/spline_test.cpp -o spline_test
+// Usage: spline_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "math/Spline.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+const std::vector<Vector3d> points = { Vector3d(0, 0, 0), Vector3d(1, 2, 0), Vector3d(3, 3, 1),
+                                       Vector3d(4, 0, 2), Vector3d(6, -1, 2), Vector3d(7, 1, 0),
+                                       Vector3d(9, 2, -1) };
+
+double distance(const Vector3d& a, const Vector3d& b) { return (a - b).length(); }
+
+void curveTypes() {
+    std::cout << "curve types:\n";
+    Splined catmullRom(SplineType::CatmullRom, points);
+    double worst = 0;
+    for (std::size_t i = 0; i < points.size(); ++i) worst = std::max(worst, distance(catmullRom.evaluate(double(i)), points[i]));
+    check(worst < 1e-12, "  Catmull-Rom passes through its points", worst);
+    worst = distance(catmullRom.derivative(2.0), (points[3] - points[1]) * 0.5);
+    worst = std::max(worst, distance(catmullRom.derivative(0.0), points[1] - points[0]));
+    check(worst < 1e-12, "  with central tangents and straight ends", worst);
+
+    Splined bezier(SplineType::Bezier, points);
+    worst = std::max({ distance(bezier.evaluate(0.0), points[0]), distance(bezier.evaluate(1.0), points[3]),
+                       distance(bezier.evaluate(2.0), points[6]) });
+    check(bezier.segmentCount() == 2 && worst < 1e-12, "  Bezier passes through its end points", worst);
+    worst = std::max({ distance(bezier.derivative(0.0), (points[1] - points[0]) * 3.0),
+                       distance(bezier.derivative(2.0), (points[6] - points[5]) * 3.0) });
+    check(worst < 1e-12, "  with tangents toward the controls", worst);
+
+    std::vector<Vector3d> hermitePoints(points.begin(), points.begin() + 6);
+    Splined hermite(SplineType::Hermite, hermitePoints);
+    worst = 0;
+    for (std::size_t k = 0; k < 3; ++k) {
+        worst = std::max(worst, distance(hermite.evaluate(double(k)), hermitePoints[2 * k]));
+        worst = std::max(worst, distance(hermite.derivative(double(k)), hermitePoints[2 * k + 1]));
+    }
+    check(hermite.segmentCount() == 2 && worst < 1e-12, "  Hermite matches its points and tangents", worst);
+
+    Splined bspline(SplineType::BSpline, points);
+    Vector3d start = (points[0] + points[1] * 4.0 + points[2]) * (1.0 / 6.0);
+    worst = std::max(distance(bspline.evaluate(0.0), start), distance(bspline.derivative(0.0), (points[2] - points[0]) * 0.5));
+    check(bspline.segmentCount() == 4 && worst < 1e-12, "  B-spline starts at its weighted average", worst);
+
+    // C2 continuity: the second derivative matches across a joint.
+    const double h = 1e-4;
+    Vector3d left = (bspline.derivative(2.0) - bspline.derivative(2.0 - h)) * (1.0 / h);
+    Vector3d right = (bspline.derivative(2.0 + h) - bspline.derivative(2.0)) * (1.0 / h);
+    check(distance(left, right) < 1e-3, "  and is C2 across segments", distance(left, right));
+}
+
+// Arc length from 0 to t by summing many short chords.
+double bruteForceLength(const Splined& spline, double t) {
+    const int steps = 20000;
+    double length = 0;
+    Vector3d previous = spline.evaluate(0.0);
+    for (int i = 1; i <= steps; ++i) {
+        Vector3d point = spline.evaluate(t * double(i) / steps);
+        length += distance(point, previous);
+        previous = point;
+    }
+    return length;
+}
+
+void arcLength() {
+    std::cout << "arc length:\n";
+    for (SplineType type : { SplineType::CatmullRom, SplineType::Bezier, SplineType::BSpline }) {
+        Splined spline(type, points);
+        double total = bruteForceLength(spline, double(spline.segmentCount()));
+        check(std::fabs(spline.length() - total) < 1e-6 * total, "  length matches the chord sum", spline.length() - total);
+
+        bool monotonic = true;
+        double previous = -1, worst = 0;
+        for (int i = 0; i <= 400; ++i) {
+            double d = spline.length() * i / 400.0;
+            double t = spline.parameterAtDistance(d);
+            monotonic = monotonic && t >= previous;
+            previous = t;
+            if (i % 40 == 0) worst = std::max(worst, std::fabs(bruteForceLength(spline, t) - d));
+        }
+        check(monotonic && previous == double(spline.segmentCount()), "  parameterAtDistance is monotonic", previous);
+        check(worst < 1e-4 * total, "  and lands at the requested distance", worst / total);
+    }
+}
+
+double angleBetween(const Quaterniond& a, const Quaterniond& b) {
+    Quaterniond r = a.conjugate() * b;
+    return 2.0 * std::atan2(std::sqrt(r.x * r.x + r.y * r.y + r.z * r.z), std::fabs(r.w));
+}
+
+void rotations() {
+    std::cout << "rotations:\n";
+    Quaterniond q = Quaterniond::fromAxisAngle(Vector3d(1, 2, -2).normalized(), 1.2);
+    Quaterniond log = q.log();
+    Vector3d half = Vector3d(1, 2, -2).normalized() * 0.6;
+    check(log.w == 0 && distance(Vector3d(log.x, log.y, log.z), half) < 1e-12, "  log is half the rotation vector", log.x);
+    check(angleBetween(log.exp(), q) < 1e-12, "  exp inverts log", angleBetween(log.exp(), q));
+    check(angleBetween(Quaterniond().log().exp(), Quaterniond()) == 0, "  and the identity maps to zero and back", 0);
+
+    std::vector<Quaterniond> keys;
+    for (int i = 0; i < 5; ++i) {
+        Vector3d axis = Vector3d(std::sin(i), 1, std::cos(i)).normalized();
+        Quaterniond key = Quaterniond::fromAxisAngle(axis, 0.5 + 0.4 * i);
+        keys.push_back(i == 2 ? Quaterniond(-key.w, -key.x, -key.y, -key.z) : key);
+    }
+    RotationSpline<double> spline(keys);
+    double worst = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) worst = std::max(worst, angleBetween(spline.evaluate(double(i)), keys[i]));
+    check(worst < 1e-12, "  squad passes through its keys", worst);
+
+    // C1 continuity: the angular velocity on both sides of an interior key agrees.
+    const double h = 1e-5;
+    worst = 0;
+    for (int k = 1; k < 4; ++k) {
+        Quaterniond before = spline.evaluate(k - h), at = spline.evaluate(k), after = spline.evaluate(k + h);
+        Quaterniond left = (before.conjugate() * at).log(), right = (at.conjugate() * after).log();
+        Vector3d velocityLeft = Vector3d(left.x, left.y, left.z) * (2.0 / h);
+        Vector3d velocityRight = Vector3d(right.x, right.y, right.z) * (2.0 / h);
+        worst = std::max(worst, distance(velocityLeft, velocityRight) / velocityLeft.length());
+        worst = std::max(worst, angleBetween(spline.evaluate(k - 1e-9), spline.evaluate(k + 1e-9)));
+    }
+    check(worst < 1e-3, "  squad is smooth across its keys", worst);
+}
+
+} // namespace
+
+int main() {
+    curveTypes();
+    arcLength();
+    rotations();
+    return test::exitCode();
+}
@@ -0,0 +1,121 @@
+// Checks that the strict functions are reproducible: math::strict::sin, cos
+// and atan2 give pinned bit patterns at fixed inputs, at compile time and
+// at run time, and in strict mode math:: uses them for double and float.
+//
+// Build: c++ -O2 -std=c++17 -DRENDERFX_MATH_STRICT -DRENDERFX_FP_CONTRACT_OFF -ffp-contract=off -Iinclude tests/strict_math_test.cpp -o strict_math_test
+// Usage: strict_math_test; exits with 1 if a check fails.
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "math/MathFunctions.h"
+#include "math/StrictMath.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+struct SineCase {
+    double x;
+    std::uint64_t sin, cos;
+};
+
+struct ArcTangentCase {
+    double y, x;
+    std::uint64_t atan2;
+};
+
+// Results of this implementation; each is within 1 ULP of a correctly
+// rounding C library. A change here means the results changed on every platform.
+constexpr SineCase sines[] = {
+    { 0.5, 0x3fdeaee8744b05f0ULL, 0x3fec1528065b7d50ULL },
+    { 1.0, 0x3feaed548f090ceeULL, 0x3fe14a280fb5068cULL },
+    { -2.5, 0xbfe326af0dcfcab0ULL, 0xbfe9a2f7ef858b7dULL },
+    { 3.141592653589793, 0x3ca1a62633145c07ULL, 0xbff0000000000000ULL },
+    { 100.0, 0xbfe03425b78c4db8ULL, 0x3feb981dbf665fdfULL },
+    { 12345.678, 0xbfe687d5890974a5ULL, 0x3fe6b94c3bbe24b8ULL },
+    { 1e-9, 0x3e112e0be826d695ULL, 0x3ff0000000000000ULL },
+};
+
+constexpr ArcTangentCase arcTangents[] = {
+    { 1.0, 1.0, 0x3fe921fb54442d18ULL },
+    { 1.0, -2.0, 0x40056c6e7397f5aeULL },
+    { -3.0, -0.5, 0xbffbc66e44cbc074ULL },
+    { 0.25, 4.0, 0x3faff55bb72cfdeaULL },
+    { -1e-3, -7.0, 0xc00921b06e4e282fULL },
+};
+
+constexpr std::size_t sineCount = sizeof(sines) / sizeof(sines[0]);
+constexpr std::size_t arcTangentCount = sizeof(arcTangents) / sizeof(arcTangents[0]);
+
+std::uint64_t bits(double value) {
+    std::uint64_t result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+// Evaluated by the compiler; compared bit for bit with the run-time results.
+struct ConstantResults {
+    double sin[sineCount], cos[sineCount], atan2[arcTangentCount];
+};
+
+constexpr ConstantResults constantResults() {
+    ConstantResults r = {};
+    for (std::size_t i = 0; i < sineCount; ++i) {
+        r.sin[i] = math::strict::sin(sines[i].x);
+        r.cos[i] = math::strict::cos(sines[i].x);
+    }
+    for (std::size_t i = 0; i < arcTangentCount; ++i) r.atan2[i] = math::strict::atan2(arcTangents[i].y, arcTangents[i].x);
+    return r;
+}
+
+void pinned() {
+    std::cout << "pinned results:\n";
+    constexpr ConstantResults constant = constantResults();
+    bool runTime = true, compileTime = true, dispatched = true;
+    for (std::size_t i = 0; i < sineCount; ++i) {
+        // Read through volatile so the compiler cannot fold the run-time calls.
+        volatile double input = sines[i].x;
+        double x = input;
+        runTime = runTime && bits(math::strict::sin(x)) == sines[i].sin && bits(math::strict::cos(x)) == sines[i].cos;
+        compileTime = compileTime && bits(constant.sin[i]) == sines[i].sin && bits(constant.cos[i]) == sines[i].cos;
+        dispatched = dispatched && bits(math::sin(x)) == sines[i].sin && bits(math::cos(x)) == sines[i].cos;
+    }
+    check(runTime, "  sin and cos at run time", 0);
+    check(compileTime, "  sin and cos at compile time", 0);
+    check(dispatched, "  math::sin and math::cos use them", 0);
+
+    runTime = compileTime = dispatched = true;
+    for (std::size_t i = 0; i < arcTangentCount; ++i) {
+        volatile double inputY = arcTangents[i].y, inputX = arcTangents[i].x;
+        double y = inputY, x = inputX;
+        runTime = runTime && bits(math::strict::atan2(y, x)) == arcTangents[i].atan2;
+        compileTime = compileTime && bits(constant.atan2[i]) == arcTangents[i].atan2;
+        dispatched = dispatched && bits(math::atan2(y, x)) == arcTangents[i].atan2;
+    }
+    check(runTime, "  atan2 at run time", 0);
+    check(compileTime, "  atan2 at compile time", 0);
+    check(dispatched, "  math::atan2 uses it", 0);
+}
+
+void floats() {
+    std::cout << "float:\n";
+    // Float results are the double results rounded once.
+    bool rounded = true;
+    for (std::size_t i = 0; i < sineCount; ++i) {
+        volatile float input = static_cast<float>(sines[i].x);
+        float x = input;
+        rounded = rounded && math::sin(x) == static_cast<float>(math::strict::sin(double(x))) &&
+                  math::cos(x) == static_cast<float>(math::strict::cos(double(x)));
+    }
+    check(math::strictMode && rounded, "  math::sin and math::cos round the strict double result", 0);
+}
+
+} // namespace
+
+int main() {
+    pinned();
+    floats();
+    return test::exitCode();
+}
@@ -0,0 +1,243 @@
+// Round-trip checks for the transform replication codec: full snapshots,
+// deltas against a baseline, baselines with fewer or more entities, and
+// rejection of truncated or corrupted packets.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/transform_codec_test.cpp -o transform_codec_test
+// Usage: transform_codec_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "net/TransformCodec.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+std::mt19937 rng(5);
+
+TransformSoAf randomTransforms(std::size_t count) {
+    std::uniform_real_distribution<float> position(-4000.0f, 4000.0f), unit(-1.0f, 1.0f), scale(0.5f, 4.0f);
+    TransformSoAf transforms;
+    transforms.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Quaternionf rotation(unit(rng), unit(rng), unit(rng), unit(rng));
+        transforms.set(i, Transform<float>(Vector3f(position(rng), position(rng), position(rng)), rotation.normalized(),
+                                           Vector3f(scale(rng), scale(rng), scale(rng))));
+    }
+    return transforms;
+}
+
+// Moves every fifth entity a little.
+void move(TransformSoAf& transforms) {
+    for (std::size_t i = 0; i < transforms.size(); i += 5) {
+        Transform<float> transform = transforms.get(i);
+        transform.position += Vector3f(0.5f, -0.25f, 0.125f);
+        transform.rotation = (transform.rotation * Quaternionf::fromAxisAngle(Vector3f(0, 1, 0), 0.05f)).normalized();
+        transforms.set(i, transform);
+    }
+}
+
+// Bytes of the transforms as floats: position, rotation and scale.
+std::size_t rawSize(const TransformSoAf& transforms) {
+    return transforms.size() * 10 * sizeof(float);
+}
+
+bool same(const QuantizedTransforms& a, const QuantizedTransforms& b) {
+    return a.fields == b.fields;
+}
+
+// Largest position error and rotation error, as the distance between unit quaternions.
+void reconstructionError(const TransformSoAf& a, const TransformSoAf& b, double& position, double& rotation, double& scale) {
+    position = rotation = scale = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        double minus = 0, plus = 0;
+        for (std::size_t c = 0; c < 4; ++c) {
+            double p = a.rotations.component(c)[i], q = b.rotations.component(c)[i];
+            minus += (p - q) * (p - q);
+            plus += (p + q) * (p + q);
+        }
+        rotation = std::max(rotation, std::sqrt(std::min(minus, plus)));
+        for (std::size_t c = 0; c < 3; ++c) {
+            position = std::max(position, double(std::fabs(a.positions.component(c)[i] - b.positions.component(c)[i])));
+            scale = std::max(scale, double(std::fabs(a.scales.component(c)[i] - b.scales.component(c)[i])));
+        }
+    }
+}
+
+template<typename Function>
+bool throws(Function function) {
+    try {
+        function();
+        return false;
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+}
+
+void fullSnapshot(bool scale) {
+    std::cout << "full snapshot" << (scale ? " with scales" : "") << ":\n";
+    TransformQuantization settings;
+    settings.scale = scale;
+    TransformCodecf codec(settings);
+    TransformSoAf transforms = randomTransforms(1001);
+    QuantizedTransforms sent, received;
+    codec.quantize(transforms, sent);
+    std::vector<std::uint8_t> packet;
+    codec.encode(sent, 7, nullptr, 0, packet);
+
+    TransformCodecf receiver(settings);
+    TransformPacketHeader header = receiver.decode(packet.data(), packet.size(), nullptr, received);
+    check(header.sequence == 7 && header.baselineSequence == TransformCodecf::noBaseline && header.entityCount == 1001,
+          "  header", double(header.entityCount));
+    check(same(sent, received), "  quantized transforms survive the packet", double(packet.size()));
+
+    TransformSoAf decoded;
+    receiver.dequantize(received, decoded);
+    double position, rotation, scaleError;
+    reconstructionError(transforms, decoded, position, rotation, scaleError);
+    double positionStep = 8192.0 / ((1 << settings.positionBits) - 1);
+    double rotationStep = 2.0 / ((1 << settings.rotationBits) - 1) / std::sqrt(2.0);
+    double scaleStep = scale ? (settings.maxScale - settings.minScale) / ((1 << settings.scaleBits) - 1) : 0;
+    check(position <= positionStep, "  position error within a step", position);
+    check(rotation <= 2 * rotationStep, "  rotation error within the step", rotation);
+    if (scale) check(scaleError <= scaleStep, "  scale error within a step", scaleError);
+}
+
+void deltas() {
+    std::cout << "deltas:\n";
+    TransformCodecf sender, receiver;
+    TransformSnapshotHistory sent, received;
+    TransformSoAf transforms = randomTransforms(1000);
+    std::vector<std::uint8_t> packet;
+
+    sender.quantize(transforms, sent.store(1));
+    sender.encode(*sent.find(1), 1, nullptr, 0, packet);
+    std::size_t fullSize = packet.size();
+    receiver.decode(packet.data(), packet.size(), nullptr, received.store(1));
+
+    move(transforms);
+    QuantizedTransforms& current = sent.store(2);
+    sender.quantize(transforms, current);
+    sender.encode(current, 2, sent.find(1), 1, packet);
+    TransformPacketHeader header = TransformCodecf::readHeader(packet.data(), packet.size());
+    check(header.baselineSequence == 1 && header.changedCount == 200, "  only moved entities are sent", double(header.changedCount));
+    check(packet.size() * 4 < fullSize, "  deltas are smaller than a full snapshot", double(packet.size()));
+    double ratio = double(rawSize(transforms)) / double(packet.size());
+    check(ratio >= 5, "  at least 5:1 against raw transforms", ratio);
+    QuantizedTransforms& decoded = received.store(header.sequence);
+    receiver.decode(packet.data(), packet.size(), received.find(header.baselineSequence), decoded);
+    check(same(current, decoded), "  delta against a baseline", double(packet.size()));
+
+    // An unchanged tick is only a header and the change mask.
+    sender.encode(current, 3, sent.find(2), 2, packet);
+    QuantizedTransforms unchanged;
+    receiver.decode(packet.data(), packet.size(), received.find(2), unchanged);
+    check(same(current, unchanged) && packet.size() == TransformCodecf::headerSize + 125, "  unchanged tick", double(packet.size()));
+
+    // Every entity drifting a little still compresses well.
+    TransformSoAf drifted(transforms);
+    for (std::size_t i = 0; i < drifted.size(); ++i) drifted.positions.component(i % 3)[i] += 0.1f;
+    QuantizedTransforms& everyone = sent.store(4);
+    sender.quantize(drifted, everyone);
+    sender.encode(everyone, 4, sent.find(2), 2, packet);
+    QuantizedTransforms& decodedEveryone = received.store(4);
+    receiver.decode(packet.data(), packet.size(), received.find(2), decodedEveryone);
+    ratio = double(rawSize(drifted)) / double(packet.size());
+    check(same(everyone, decodedEveryone) && ratio >= 5, "  every entity moving, at least 5:1", ratio);
+
+    check(throws([&] { receiver.decode(packet.data(), packet.size(), nullptr, unchanged); }), "  a missing baseline is rejected", 0);
+    TransformSoAf other = randomTransforms(10);
+    QuantizedTransforms wrongBaseline;
+    sender.quantize(other, wrongBaseline);
+    check(throws([&] { receiver.decode(packet.data(), packet.size(), &wrongBaseline, unchanged); }),
+          "  a baseline of another size is rejected", 0);
+}
+
+void entityCountChanges() {
+    std::cout << "entity count changes:\n";
+    TransformCodecf codec;
+    TransformSoAf transforms = randomTransforms(300);
+    QuantizedTransforms baseline, current, decoded;
+    codec.quantize(transforms, baseline);
+    std::vector<std::uint8_t> packet;
+
+    // Growth: new entities are encoded against zero.
+    transforms.append(randomTransforms(77));
+    move(transforms);
+    codec.quantize(transforms, current);
+    codec.encode(current, 2, &baseline, 1, packet);
+    codec.decode(packet.data(), packet.size(), &baseline, decoded);
+    check(same(current, decoded) && decoded.size() == 377, "  growth", double(decoded.size()));
+
+    // Shrink: entities past the new count are dropped.
+    TransformSoAf fewer;
+    for (std::size_t i = 0; i < 120; ++i) fewer.push_back(transforms.get(i));
+    codec.quantize(fewer, current);
+    codec.encode(current, 3, &decoded, 2, packet);
+    QuantizedTransforms shrunk;
+    codec.decode(packet.data(), packet.size(), &decoded, shrunk);
+    check(same(current, shrunk) && shrunk.size() == 120, "  shrink", double(shrunk.size()));
+
+    // Down to no entities and back.
+    QuantizedTransforms empty;
+    codec.encode(empty, 4, &shrunk, 3, packet);
+    QuantizedTransforms none;
+    codec.decode(packet.data(), packet.size(), &shrunk, none);
+    check(none.size() == 0, "  shrink to nothing", double(packet.size()));
+    codec.encode(current, 5, &none, 4, packet);
+    codec.decode(packet.data(), packet.size(), &none, decoded);
+    check(same(current, decoded), "  growth from nothing", double(decoded.size()));
+}
+
+void damagedPackets() {
+    std::cout << "damaged packets:\n";
+    TransformCodecf codec;
+    TransformSoAf transforms = randomTransforms(200);
+    QuantizedTransforms baseline, current, decoded;
+    codec.quantize(transforms, baseline);
+    move(transforms);
+    codec.quantize(transforms, current);
+    std::vector<std::uint8_t> packet;
+    codec.encode(current, 2, &baseline, 1, packet);
+
+    std::size_t accepted = 0;
+    for (std::size_t size = 0; size < packet.size(); ++size) {
+        if (!throws([&] { codec.decode(packet.data(), size, &baseline, decoded); })) ++accepted;
+    }
+    check(accepted == 0, "  every truncation is rejected", double(accepted));
+
+    accepted = 0;
+    for (std::size_t bit = 0; bit < packet.size() * 8; ++bit) {
+        std::vector<std::uint8_t> corrupt = packet;
+        corrupt[bit / 8] ^= static_cast<std::uint8_t>(1u << (bit % 8));
+        if (!throws([&] { codec.decode(corrupt.data(), corrupt.size(), &baseline, decoded); })) ++accepted;
+    }
+    check(accepted == 0, "  every flipped bit is rejected", double(accepted));
+
+    std::vector<std::uint8_t> longer = packet;
+    longer.push_back(0);
+    check(throws([&] { codec.decode(longer.data(), longer.size(), &baseline, decoded); }), "  trailing bytes are rejected", 1);
+
+    TransformQuantization other;
+    other.positionBits = 16;
+    TransformCodecf mismatched(other);
+    check(throws([&] { mismatched.decode(packet.data(), packet.size(), &baseline, decoded); }),
+          "  other quantization parameters are rejected", 0);
+}
+
+} // namespace
+
+int main() {
+    fullSnapshot(false);
+    fullSnapshot(true);
+    deltas();
+    entityCountChanges();
+    damagedPackets();
+    return test::exitCode();
+}
@@ -0,0 +1,95 @@
+// Checks for the expression templates of the generic vector types: the
+// math:: expression functions against per-element Vector code, and vectors
+// of fixed-point components.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/vector_expression_test.cpp -o vector_expression_test
+// Usage: vector_expression_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include "math/Fixed.h"
+#include "math/VectorArray.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+VectorArray<double, 3> randomArray(std::size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<double> value(-100.0, 100.0);
+    VectorArray<double, 3> array(count);
+    for (std::size_t c = 0; c < 3; ++c) {
+        for (std::size_t i = 0; i < count; ++i) array.component(c)[i] = value(rng);
+    }
+    return array;
+}
+
+void arrays() {
+    std::cout << "arrays:\n";
+    std::mt19937 rng(5);
+    const std::size_t count = 1000;
+    VectorArray<double, 3> a = randomArray(count, rng), b = randomArray(count, rng);
+    VectorArray<double, 1> t(count);
+    std::uniform_real_distribution<double> factor(0.0, 1.0);
+    for (std::size_t i = 0; i < count; ++i) t.component(0)[i] = factor(rng);
+
+    VectorArray<double, 3> normalized(count), interpolated(count), lowest(count), absolute(count);
+    normalized = math::normalize(a - b);
+    interpolated = math::lerp(a, b, t);
+    lowest = math::min(a, b);
+    absolute = math::abs(a);
+    VectorArray<double, 1> dots(count);
+    dots = math::dot(normalized, normalized);
+
+    double normalizeError = 0, lerpError = 0, dotError = 0;
+    std::size_t wrong = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        Vector<double, 3> va = a.get(i), vb = b.get(i);
+        Vector<double, 3> expected = Vector<double, 3>(va - vb).normalized();
+        Vector<double, 3> mixed = va + (vb - va) * t.component(0)[i];
+        for (std::size_t c = 0; c < 3; ++c) {
+            normalizeError = std::max(normalizeError, std::abs(normalized.component(c)[i] - expected[c]));
+            lerpError = std::max(lerpError, std::abs(interpolated.component(c)[i] - mixed[c]));
+            if (lowest.component(c)[i] != std::min(va[c], vb[c]) || absolute.component(c)[i] != std::abs(va[c])) ++wrong;
+        }
+        dotError = std::max(dotError, std::abs(dots.component(0)[i] - 1));
+    }
+    check(normalizeError < 1e-15, "  normalize matches Vector::normalized", normalizeError);
+    check(dotError < 1e-15, "  normalized elements have unit length", dotError);
+    check(lerpError == 0, "  lerp with per-element factors", lerpError);
+    check(wrong == 0, "  min and abs", double(wrong));
+
+    // A zero-length element is not finite and does not affect its neighbours.
+    VectorArray<double, 3> withZero(3);
+    withZero.set(0, Vector<double, 3>(3.0, 0.0, 4.0));
+    withZero.set(2, Vector<double, 3>(0.0, -2.0, 0.0));
+    VectorArray<double, 3> unit(3);
+    unit = math::normalize(withZero);
+    check(unit.get(0) == Vector<double, 3>(0.6, 0.0, 0.8) && std::isnan(unit.component(0)[1]) && unit.get(2) == Vector<double, 3>(0.0, -1.0, 0.0),
+          "  a zero-length element stays local", unit.component(0)[1]);
+}
+
+void fixedVectors() {
+    std::cout << "fixed-point vectors:\n";
+    Vector<Fixed32, 3> v(Fixed32(3), Fixed32(0), 4.0);
+    Vector<Fixed32, 3> unit = math::normalize(v);
+    double error = std::abs(double(unit[0]) - 0.6) + std::abs(double(unit[2]) - 0.8);
+    check(error < 1e-6, "  Vector<Fixed32, 3> from mixed values, normalized", error);
+    Vector<Fixed32, 3> mid = math::lerp(v, Vector<Fixed32, 3>(Fixed32(1), Fixed32(2), Fixed32(0)), Fixed32(0.5));
+    check(double(mid[0]) == 2 && double(mid[1]) == 1 && double(mid[2]) == 2, "  lerp", double(mid[1]));
+}
+
+#if RENDERFX_HAS_CONSTEXPR_MATH
+constexpr Vector<double, 3> constantUnit = math::normalize(Vector<double, 3>(0.0, 3.0, 4.0));
+static_assert(math::abs(constantUnit[1] - 0.6) < 1e-15 && math::abs(constantUnit[2] - 0.8) < 1e-15, "normalize must be constant-evaluable");
+#endif
+
+} // namespace
+
+int main() {
+    arrays();
+    fixedVectors();
+    return test::exitCode();
+}
@@ -0,0 +1,153 @@
+// Checks for world streaming: loading the visible cells, eviction under the
+// memory budget, the hit rate, and the backoff and give-up of cells whose
+// loads fail.
+//
+// Build: c++ -O2 -std=c++17 -Iinclude tests/world_partition_test.cpp -pthread -o world_partition_test
+// Usage: world_partition_test; exits with 1 if a check fails.
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "scene/WorldPartition.h"
+#include "TestCheck.h"
+
+namespace {
+
+using test::check;
+
+constexpr std::size_t cellCount = 10;
+constexpr std::size_t payloadSize = 1000;
+
+std::string temporary(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Cells 10 units apart along +x, each filled with its own byte value.
+void writeWorld(const std::string& path) {
+    std::vector<WorldCellSource<float>> sources(cellCount);
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        float x = 10.0f * float(i);
+        sources[i].bounds = AABB<float>(Vector3f(x, -4, -4), Vector3f(x + 8, 4, 4));
+        sources[i].data.assign(payloadSize, static_cast<unsigned char>(0xA0 + i));
+    }
+    WorldPartitionf::write(path, sources);
+}
+
+// A camera at x looking along +x that sees 30 units ahead.
+Frustum<float> cameraAt(float x) {
+    return Frustum<float>(Matrix4x4<float>::perspective(1.0f, 1.0f, 0.1f, 30.0f) *
+                          Matrix4x4<float>::lookAt(Vector3f(x, 0, 0), Vector3f(x + 1, 0, 0), Vector3f(0, 1, 0)));
+}
+
+WorldStreamingSettings<float> visibleOnly(std::size_t budget) {
+    WorldStreamingSettings<float> settings;
+    settings.memoryBudget = budget;
+    settings.prefetchMargin = 0.0f;
+    settings.predictionSteps = 0;
+    return settings;
+}
+
+void step(WorldPartitionf& world, float x) {
+    world.update(Vector3f(x, 0, 0), Vector3f(0, 0, 0), cameraAt(x));
+    world.waitForLoads();
+}
+
+std::vector<std::size_t> residentCells(const WorldPartitionf& world) {
+    std::vector<std::size_t> cells;
+    for (std::size_t i = 0; i < world.cellCount(); ++i) {
+        if (world.isResident(i)) cells.push_back(i);
+    }
+    return cells;
+}
+
+void streaming(const std::string& path) {
+    std::cout << "streaming:\n";
+    ThreadPool pool(2);
+    WorldPartitionf world(path, pool, visibleOnly(3 * payloadSize));
+
+    // From x = -5 the camera sees cells 0 to 2; the first update misses them.
+    step(world, -5.0f);
+    step(world, -5.0f);
+    bool contents = true;
+    for (std::size_t cell : residentCells(world)) {
+        const unsigned char* data = world.cellData(cell);
+        contents = contents && std::all_of(data, data + payloadSize, [cell](unsigned char b) { return b == 0xA0 + cell; });
+    }
+    check(residentCells(world) == std::vector<std::size_t>{ 0, 1, 2 } && contents, "  the visible cells are loaded",
+          double(residentCells(world).size()));
+    const WorldStreamingStats& stats = world.stats();
+    check(stats.hits == 3 && stats.misses == 3 && stats.hitRate() == 0.5, "  hit rate of the first two updates", stats.hitRate());
+    check(world.cellData(5) == nullptr, "  cells out of view have no data", 0);
+
+    // From x = 29 the camera sees cells 3 to 5; the budget holds only three.
+    world.resetStats();
+    step(world, 29.0f);
+    step(world, 29.0f);
+    check(residentCells(world) == std::vector<std::size_t>{ 3, 4, 5 }, "  cells out of view are evicted for visible ones",
+          double(stats.evictions));
+    check(stats.evictions == 3 && stats.bytesResident == 3 * payloadSize && stats.bytesInFlight == 0,
+          "  resident bytes stay within the budget", double(stats.bytesResident));
+    check(stats.loadsCompleted == 3 && stats.hits == 3 && stats.misses == 3, "  the hit rate recovers once loaded", stats.hitRate());
+}
+
+void failures(const std::string& path) {
+    std::cout << "failed loads:\n";
+    // Corrupts the payload of cell 0 in place; the cell table stays valid.
+    std::vector<unsigned char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::vector<unsigned char> pattern(payloadSize, 0xA0);
+    std::size_t offset = std::size_t(std::search(bytes.begin(), bytes.end(), pattern.begin(), pattern.end()) - bytes.begin());
+    auto patch = [&](char value) {
+        std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(std::streamoff(offset + 10));
+        out.put(value);
+    };
+    patch(char(0x55));
+
+    ThreadPool pool(2);
+    WorldStreamingSettings<float> settings = visibleOnly(3 * payloadSize);
+    settings.retryDelay = 2;
+    settings.maxLoadAttempts = 3;
+    WorldPartitionf world(path, pool, settings);
+
+    // Loads of cell 0 start at updates 1, 3 and 7; then it is given up.
+    std::vector<std::size_t> startedAt;
+    for (std::size_t update = 1; update <= 20; ++update) {
+        std::uint64_t before = world.stats().loadsStarted;
+        step(world, -5.0f);
+        if (world.stats().loadsStarted - before == (update == 1 ? 3u : 1u)) startedAt.push_back(update);
+    }
+    const WorldStreamingStats& stats = world.stats();
+    check(startedAt == std::vector<std::size_t>{ 1, 3, 7 }, "  retries back off", double(startedAt.size()));
+    check(stats.loadsFailed == 3 && stats.cellsFailed == 1 && world.loadFailures(0) == 3 && stats.loadsStarted == 5,
+          "  the cell is given up after maxLoadAttempts", double(stats.loadsStarted));
+    check(!world.isResident(0) && world.isResident(1) && world.isResident(2), "  other cells are unaffected", 0);
+
+    // Repaired, the cell loads again once it is released.
+    patch(char(0xA0));
+    step(world, -5.0f);
+    check(!world.isResident(0), "  given-up cells stay unloaded", 0);
+    world.retryFailedCells();
+    step(world, -5.0f);
+    check(world.isResident(0) && world.loadFailures(0) == 0 && stats.cellsFailed == 0, "  retryFailedCells loads the cell",
+          double(world.loadFailures(0)));
+}
+
+} // namespace
+
+int main() {
+    const std::string path = temporary("world_partition_test.rfxworld");
+    writeWorld(path);
+    streaming(path);
+    failures(path);
+    std::filesystem::remove(path);
+    return test::exitCode();
+}